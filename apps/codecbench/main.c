@@ -0,0 +1,528 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Benchmark of the BACnet primitive value encoders and decoders
+ *
+ * @section DESCRIPTION
+ *
+ * Encodes and decodes arrays of REAL, Unsigned, and Enumerated values
+ * many times over, one value at a time and with the array encoders and
+ * decoders, and encodes a Priority_Array one element at a time and with
+ * the priority-array encoder, and converts seconds since epoch into
+ * BACnet date and time one value at a time and in an array, and reports
+ * the nanoseconds per value of each.  Then encodes and restores a warm
+ * start snapshot of Count address cache records, and reports the
+ * milliseconds and records per second of each.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/bacaddr.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacint.h"
+#include "bacnet/bacreal.h"
+#include "bacnet/datetime.h"
+#include "bacnet/version.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/sys/priority_array.h"
+#include "bacnet/basic/sys/snapshot.h"
+#include "bacnet/basic/binding/address.h"
+
+static unsigned Iterations = 1000;
+static unsigned Count = 1000;
+/* keeps the compiler from removing the encoding and decoding */
+static volatile unsigned long Checksum;
+
+static float *Real_Values;
+static BACNET_UNSIGNED_INTEGER *Unsigned_Values;
+static uint32_t *Enumerated_Values;
+static uint8_t *Buffer;
+static size_t Buffer_Size;
+
+/* the priority-array that is encoded one element at a time */
+static BACNET_PRIORITY_ARRAY Priority_Active;
+static float Priority_Array[BACNET_MAX_PRIORITY];
+
+static double clock_seconds(clock_t start)
+{
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    return (seconds > 0.0) ? seconds : 1e-9;
+}
+
+/* the remaining size of the buffer, for the decoders with a 16-bit size */
+static uint16_t buffer_remaining(int len)
+{
+    size_t remaining = Buffer_Size - (size_t)len;
+
+    return (remaining > UINT16_MAX) ? UINT16_MAX : (uint16_t)remaining;
+}
+
+static void print_result(const char *name, double single, double bulk)
+{
+    printf("%-28s %12.2f %12.2f %8.1fx\n", name, single, bulk, single / bulk);
+}
+
+/**
+ * @brief Compare encoding and decoding tagged values one at a time
+ *  with the array encoders and decoders
+ */
+static void codecbench_arrays(void)
+{
+    double single, bulk, values;
+    unsigned i, n;
+    int len = 0;
+    uint8_t tag_number = 0;
+    uint32_t len_value = 0;
+    float real_value = 0.0f;
+    uint32_t enumerated_value = 0;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    clock_t start;
+
+    values = (double)Iterations * Count;
+    /* REAL */
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = 0;
+        for (n = 0; n < Count; n++) {
+            len += encode_application_real(&Buffer[len], Real_Values[n]);
+        }
+        Checksum += len;
+    }
+    single = 1e9 * clock_seconds(start) / values;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = encode_application_real_array(Buffer, Real_Values, Count);
+        Checksum += len;
+    }
+    bulk = 1e9 * clock_seconds(start) / values;
+    print_result("REAL array encode", single, bulk);
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = 0;
+        for (n = 0; n < Count; n++) {
+            len += bacnet_tag_number_and_value_decode(&Buffer[len],
+                (uint32_t)(Buffer_Size - len), &tag_number, &len_value);
+            len += decode_real(&Buffer[len], &real_value);
+            Checksum += (unsigned long)real_value;
+        }
+    }
+    single = 1e9 * clock_seconds(start) / values;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = bacnet_real_application_array_decode(
+            Buffer, (uint32_t)Buffer_Size, Real_Values, Count);
+        Checksum += len;
+    }
+    bulk = 1e9 * clock_seconds(start) / values;
+    print_result("REAL array decode", single, bulk);
+    /* Unsigned */
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = 0;
+        for (n = 0; n < Count; n++) {
+            len +=
+                encode_application_unsigned(&Buffer[len], Unsigned_Values[n]);
+        }
+        Checksum += len;
+    }
+    single = 1e9 * clock_seconds(start) / values;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = encode_application_unsigned_array(
+            Buffer, Unsigned_Values, Count);
+        Checksum += len;
+    }
+    bulk = 1e9 * clock_seconds(start) / values;
+    print_result("Unsigned array encode", single, bulk);
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = 0;
+        for (n = 0; n < Count; n++) {
+            len += bacnet_unsigned_application_decode(
+                &Buffer[len], buffer_remaining(len), &unsigned_value);
+            Checksum += (unsigned long)unsigned_value;
+        }
+    }
+    single = 1e9 * clock_seconds(start) / values;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = bacnet_unsigned_application_array_decode(
+            Buffer, (uint32_t)Buffer_Size, Unsigned_Values, Count);
+        Checksum += len;
+    }
+    bulk = 1e9 * clock_seconds(start) / values;
+    print_result("Unsigned array decode", single, bulk);
+    /* Enumerated */
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = 0;
+        for (n = 0; n < Count; n++) {
+            len += encode_application_enumerated(
+                &Buffer[len], Enumerated_Values[n]);
+        }
+        Checksum += len;
+    }
+    single = 1e9 * clock_seconds(start) / values;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = encode_application_enumerated_array(
+            Buffer, Enumerated_Values, Count);
+        Checksum += len;
+    }
+    bulk = 1e9 * clock_seconds(start) / values;
+    print_result("Enumerated array encode", single, bulk);
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = 0;
+        for (n = 0; n < Count; n++) {
+            len += bacnet_tag_number_and_value_decode(&Buffer[len],
+                (uint32_t)(Buffer_Size - len), &tag_number, &len_value);
+            len += bacnet_enumerated_decode(&Buffer[len],
+                buffer_remaining(len), len_value, &enumerated_value);
+            Checksum += enumerated_value;
+        }
+    }
+    single = 1e9 * clock_seconds(start) / values;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = bacnet_enumerated_application_array_decode(
+            Buffer, (uint32_t)Buffer_Size, Enumerated_Values, Count);
+        Checksum += len;
+    }
+    bulk = 1e9 * clock_seconds(start) / values;
+    print_result("Enumerated array decode", single, bulk);
+}
+
+/**
+ * @brief Encode one element of the benchmark priority-array
+ */
+static int priority_array_element_encode(
+    uint32_t object_instance, BACNET_ARRAY_INDEX index, uint8_t *apdu)
+{
+    int apdu_len = BACNET_STATUS_ERROR;
+
+    (void)object_instance;
+    if (index < BACNET_MAX_PRIORITY) {
+        if (priority_array_commanded(&Priority_Active, index + 1)) {
+            apdu_len = encode_application_real(apdu, Priority_Array[index]);
+        } else {
+            apdu_len = encode_application_null(apdu);
+        }
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Compare the Priority_Array encoding one element at a time
+ *  with the priority-array encoder
+ */
+static void codecbench_priority_array(void)
+{
+    double single, bulk, values;
+    unsigned i, p;
+    int len = 0;
+    clock_t start;
+
+    priority_array_init(&Priority_Active);
+    for (p = 1; p <= BACNET_MAX_PRIORITY; p++) {
+        Priority_Array[p - 1] = (float)p;
+        if (p % 3) {
+            priority_array_command(&Priority_Active, p);
+        }
+    }
+    values = (double)Iterations * Count;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        for (p = 0; p < Count; p++) {
+            len = bacnet_array_encode(0, BACNET_ARRAY_ALL,
+                priority_array_element_encode, BACNET_MAX_PRIORITY, Buffer,
+                MAX_APDU);
+            Checksum += len;
+        }
+    }
+    single = 1e9 * clock_seconds(start) / values;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        for (p = 0; p < Count; p++) {
+            len = priority_array_real_encode(&Priority_Active, Priority_Array,
+                BACNET_ARRAY_ALL, Buffer, MAX_APDU);
+            Checksum += len;
+        }
+    }
+    bulk = 1e9 * clock_seconds(start) / values;
+    print_result("Priority_Array encode", single, bulk);
+}
+
+/**
+ * @brief Compare converting trend log timestamps one at a time with
+ *  the array conversion, and comparing dates and times with comparing
+ *  packed timestamps
+ */
+static void codecbench_datetime(void)
+{
+    double single, bulk, values;
+    unsigned i, n;
+    bacnet_time_t *seconds;
+    BACNET_DATE_TIME *bdatetime;
+    bacnet_datetime_packed_t *packed;
+    BACNET_DATE_TIME start_time = { 0 };
+    clock_t start;
+
+    seconds = calloc(Count, sizeof(bacnet_time_t));
+    bdatetime = calloc(Count, sizeof(BACNET_DATE_TIME));
+    packed = calloc(Count, sizeof(bacnet_datetime_packed_t));
+    if (!seconds || !bdatetime || !packed) {
+        free(seconds);
+        free(bdatetime);
+        free(packed);
+        return;
+    }
+    /* a trend log with a 5 minute log interval */
+    datetime_set_values(&start_time, 2023, 1, 1, 0, 0, 0, 0);
+    seconds[0] = datetime_seconds_since_epoch(&start_time);
+    for (n = 1; n < Count; n++) {
+        seconds[n] = seconds[n - 1] + (5 * 60);
+    }
+    values = (double)Iterations * Count;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        for (n = 0; n < Count; n++) {
+            datetime_since_epoch_seconds(&bdatetime[n], seconds[n]);
+        }
+        Checksum += bdatetime[Count - 1].date.day;
+    }
+    single = 1e9 * clock_seconds(start) / values;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        datetime_since_epoch_seconds_array(bdatetime, seconds, Count);
+        Checksum += bdatetime[Count - 1].date.day;
+    }
+    bulk = 1e9 * clock_seconds(start) / values;
+    print_result("DateTime from seconds", single, bulk);
+    for (n = 0; n < Count; n++) {
+        packed[n] = datetime_pack(&bdatetime[n]);
+    }
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        for (n = 1; n < Count; n++) {
+            Checksum += datetime_compare(&bdatetime[n], &bdatetime[n - 1]);
+        }
+    }
+    single = 1e9 * clock_seconds(start) / values;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        for (n = 1; n < Count; n++) {
+            Checksum += datetime_packed_compare(packed[n], packed[n - 1]);
+        }
+    }
+    bulk = 1e9 * clock_seconds(start) / values;
+    print_result("DateTime compare", single, bulk);
+    free(seconds);
+    free(bdatetime);
+    free(packed);
+}
+
+/* the address cache of the snapshot benchmark */
+static uint32_t *Snapshot_Device_ID;
+static BACNET_ADDRESS *Snapshot_Address;
+
+static uint32_t snapshot_benchmark_count(void)
+{
+    return Count;
+}
+
+/**
+ * @brief Encode a record like the address cache records
+ */
+static bool snapshot_benchmark_encode(uint32_t index, uint8_t *record)
+{
+    encode_unsigned32(&record[0], Snapshot_Device_ID[index]);
+    encode_unsigned16(&record[4], MAX_APDU);
+    record[6] = 0;
+    record[7] = 0;
+    encode_unsigned32(&record[8], 3600);
+    bacnet_address_record_encode(&record[12], &Snapshot_Address[index]);
+
+    return true;
+}
+
+static bool snapshot_benchmark_restore(uint32_t index, uint8_t *record)
+{
+    decode_unsigned32(&record[0], &Snapshot_Device_ID[index]);
+
+    return bacnet_address_record_decode(
+               &record[12], &Snapshot_Address[index]) > 0;
+}
+
+/**
+ * @brief Time the encoding and the restoring of a warm start snapshot
+ */
+static void codecbench_snapshot(void)
+{
+    double encode_ms, restore_ms, records;
+    unsigned i, n;
+    uint8_t *snapshot;
+    size_t size, len = 0;
+    uint32_t restored = 0;
+    clock_t start;
+
+    Snapshot_Device_ID = calloc(Count, sizeof(uint32_t));
+    Snapshot_Address = calloc(Count, sizeof(BACNET_ADDRESS));
+    snapshot_init();
+    snapshot_section_register(SNAPSHOT_SECTION_ADDRESS_CACHE,
+        ADDRESS_SNAPSHOT_VERSION, ADDRESS_SNAPSHOT_RECORD_SIZE,
+        snapshot_benchmark_count, snapshot_benchmark_encode,
+        snapshot_benchmark_restore);
+    size = snapshot_size();
+    snapshot = malloc(size);
+    if (!Snapshot_Device_ID || !Snapshot_Address || !snapshot) {
+        free(Snapshot_Device_ID);
+        free(Snapshot_Address);
+        free(snapshot);
+        return;
+    }
+    /* BACnet/IP devices on a few remote networks */
+    for (n = 0; n < Count; n++) {
+        Snapshot_Device_ID[n] = n % (BACNET_MAX_INSTANCE + 1);
+        Snapshot_Address[n].mac_len = 6;
+        Snapshot_Address[n].mac[0] = 192;
+        Snapshot_Address[n].mac[1] = 168;
+        Snapshot_Address[n].mac[2] = (uint8_t)(n >> 8);
+        Snapshot_Address[n].mac[3] = (uint8_t)n;
+        Snapshot_Address[n].mac[4] = 0xBA;
+        Snapshot_Address[n].mac[5] = 0xC0;
+        Snapshot_Address[n].net = (uint16_t)(1 + (n % 16));
+    }
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        len = snapshot_encode(snapshot, size);
+        Checksum += len;
+    }
+    encode_ms = 1e3 * clock_seconds(start) / Iterations;
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        restored = snapshot_restore(snapshot, len);
+        Checksum += restored;
+    }
+    restore_ms = 1e3 * clock_seconds(start) / Iterations;
+    records = (double)restored;
+    printf("\nSnapshot of %lu records, %lu bytes\n", (unsigned long)restored,
+        (unsigned long)len);
+    printf("%-28s %12.3f ms %12.0f records/s\n", "Snapshot encode",
+        encode_ms, 1e3 * records / encode_ms);
+    printf("%-28s %12.3f ms %12.0f records/s\n", "Snapshot restore",
+        restore_ms, 1e3 * records / restore_ms);
+    free(Snapshot_Device_ID);
+    free(Snapshot_Address);
+    free(snapshot);
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--iterations N][--count N]\n", filename);
+    printf("       [--version][--help]\n");
+}
+
+static void print_help(const char *filename)
+{
+    (void)filename;
+    printf("Benchmark of the BACnet REAL, Unsigned, and Enumerated value\n"
+           "encoders and decoders, of the Priority_Array encoder, and\n"
+           "of the date and time conversions.\n"
+           "Reports the nanoseconds per value one at a time and in bulk.\n"
+           "Then reports the time to encode and to restore a warm start\n"
+           "snapshot of an address cache with Count devices.\n");
+    printf("\n");
+    printf("--iterations N\n"
+           "Number of times every array is encoded and decoded.\n"
+           "1000 is default.\n");
+    printf("--count N\n"
+           "Number of values in each array, and the number of\n"
+           "Priority_Array encodings per iteration, and the number of\n"
+           "snapshot records. 1000 is default.\n");
+}
+
+int main(int argc, char *argv[])
+{
+    char *filename = NULL;
+    unsigned n;
+    int argi = 0;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2023 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if ((strcmp(argv[argi], "--iterations") == 0) && (++argi < argc)) {
+            Iterations = strtoul(argv[argi], NULL, 0);
+        } else if ((strcmp(argv[argi], "--count") == 0) && (++argi < argc)) {
+            Count = strtoul(argv[argi], NULL, 0);
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if (Iterations < 1) {
+        Iterations = 1;
+    }
+    if (Count < 1) {
+        Count = 1;
+    }
+    /* the largest encoding is an 8 octet Unsigned with a 2 octet tag */
+    Buffer_Size = (size_t)Count * 10;
+    if (Buffer_Size < MAX_APDU) {
+        Buffer_Size = MAX_APDU;
+    }
+    Buffer = calloc(Buffer_Size, 1);
+    Real_Values = calloc(Count, sizeof(float));
+    Unsigned_Values = calloc(Count, sizeof(BACNET_UNSIGNED_INTEGER));
+    Enumerated_Values = calloc(Count, sizeof(uint32_t));
+    if (!Buffer || !Real_Values || !Unsigned_Values || !Enumerated_Values) {
+        fprintf(stderr, "%s: out of memory\n", filename);
+        return 1;
+    }
+    srand(1);
+    for (n = 0; n < Count; n++) {
+        Real_Values[n] = (float)rand() / 100.0f;
+        /* a mix of 1 to 4 octet values */
+        Unsigned_Values[n] = (BACNET_UNSIGNED_INTEGER)rand() >> ((n % 4) * 8);
+        Enumerated_Values[n] = (uint32_t)(rand() & 0xFFFF) >> ((n % 2) * 8);
+    }
+    printf("%-28s %12s %12s %9s\n", "codec", "single ns", "bulk ns",
+        "speedup");
+    codecbench_arrays();
+    codecbench_priority_array();
+    codecbench_datetime();
+    codecbench_snapshot();
+    free(Buffer);
+    free(Real_Values);
+    free(Unsigned_Values);
+    free(Enumerated_Values);
+
+    return 0;
+}
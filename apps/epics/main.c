@@ -30,12 +30,22 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h> /* for time */
 #if (__STDC_VERSION__ >= 199901L) && defined (__STDC_ISO_10646__)
 #include <locale.h>
 #endif
 #include <errno.h>
 #include <assert.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+/* generate the EPICS of many devices at once, one process per device */
+#define BACEPICS_BATCH 1
+#endif
 #include "bacnet/config.h"
 #include "bacnet/bactext.h"
 #include "bacnet/iam.h"
@@ -57,6 +67,7 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/filename.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/datalink/dlenv.h"
@@ -175,6 +186,42 @@ static bool ShowValues = false;
 static bool ShowDeviceObjectOnly = false;
 /* read required and optional properties when RPM ALL does not work */
 static bool Optional_Properties = false;
+/* When a long array has to be walked, read this many elements in each
+ * ReadPropertyMultiple rather than one element per ReadProperty. */
+#define ARRAY_CHUNK_MAX 64
+static unsigned Array_Chunk = 16;
+
+#if defined(BACEPICS_BATCH)
+/* exit status of a batch worker, and how each device of a batch went */
+#define EPICS_EXIT_OK 0
+#define EPICS_EXIT_INCOMPLETE 1
+#define EPICS_EXIT_ERRORS 2
+#define EPICS_EXIT_FILE 3
+#define EPICS_EXIT_UNBOUND 4
+#define EPICS_EXIT_FAILED 5
+/* one device of a batch, given as instances or ranges on the command line */
+struct epics_batch_device {
+    uint32_t device_id;
+    BACNET_ADDRESS address;
+    unsigned max_apdu;
+    bool bound;
+    pid_t pid;
+    unsigned slot;
+    unsigned long start;
+    unsigned long elapsed;
+    int status;
+};
+static struct epics_batch_device *Batch_Device;
+static unsigned Batch_Device_Count;
+static unsigned Batch_Device_Size;
+static unsigned Batch_Bound_Count;
+/* number of devices that are worked on at the same time */
+static unsigned Batch_Jobs = 8;
+/* where the EPICS file of each device is written */
+static const char *Batch_Output_Dir;
+/* set in the worker process that generates the EPICS of one device */
+static bool Batch_Worker;
+#endif
 
 #if !defined(PRINT_ERRORS)
 #define PRINT_ERRORS 1
@@ -823,6 +870,62 @@ static void BuildPropRequest(BACNET_READ_ACCESS_DATA *rpm_object)
     }
 }
 
+/** Send an RPM request to read the next elements of a long array that
+ * is being walked, one property reference per array index.  The number
+ * of elements is limited so that the answer fits in the device APDU.
+ *
+ * @param device_instance [in] Our target device's instance.
+ * @param pMyObject [in] The current Object's type and instance numbers.
+ * @param prop [in] The array property being walked.
+ * @return The invokeID of the message sent, or 0 if it was not sent.
+ */
+static uint8_t Read_Array_Chunk(
+    uint32_t device_instance, BACNET_OBJECT_ID *pMyObject, int prop)
+{
+    static BACNET_PROPERTY_REFERENCE rpm_property[ARRAY_CHUNK_MAX];
+    BACNET_READ_ACCESS_DATA rpm_object = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    uint8_t buffer[MAX_PDU] = { 0 };
+    uint32_t array_index = Walked_List_Index;
+    unsigned max_apdu = 0;
+    unsigned count = 0;
+    unsigned limit = Array_Chunk;
+
+    /* each element costs about 12 octets in the ack, which has to fit
+       in the APDU of the device and in our own */
+    if (!address_get_by_device(device_instance, &max_apdu, &dest) ||
+        (max_apdu > MAX_APDU)) {
+        max_apdu = MAX_APDU;
+    }
+    if (max_apdu > 24) {
+        if (limit > ((max_apdu - 12) / 12)) {
+            limit = (max_apdu - 12) / 12;
+        }
+    } else {
+        limit = 1;
+    }
+    if (limit > ARRAY_CHUNK_MAX) {
+        limit = ARRAY_CHUNK_MAX;
+    }
+    while ((count < limit) && (array_index <= Walked_List_Length)) {
+        rpm_property[count].propertyIdentifier = prop;
+        rpm_property[count].propertyArrayIndex = array_index;
+        rpm_property[count].value = NULL;
+        rpm_property[count].next = NULL;
+        if (count > 0) {
+            rpm_property[count - 1].next = &rpm_property[count];
+        }
+        array_index++;
+        count++;
+    }
+    rpm_object.object_type = pMyObject->type;
+    rpm_object.object_instance = pMyObject->instance;
+    rpm_object.listOfProperties = &rpm_property[0];
+
+    return Send_Read_Property_Multiple_Request(
+        buffer, sizeof(buffer), device_instance, &rpm_object);
+}
+
 /** Send an RP request to read one property from the current Object.
  * Singly process large arrays too, like the Device Object's Object_List.
  * If GET_LIST_OF_ALL_RESPONSE failed, we will fall back to using just
@@ -876,6 +979,8 @@ static uint8_t Read_Properties(
         if (Using_Walked_List) {
             if (Walked_List_Length == 0) {
                 array_index = 0;
+            } else if (Has_RPM && (Array_Chunk > 1)) {
+                return Read_Array_Chunk(device_instance, pMyObject, prop);
             } else {
                 array_index = Walked_List_Index;
             }
@@ -1008,11 +1113,335 @@ static EPICS_STATES ProcessRPMData(
     return nextState;
 }
 
+#if defined(BACEPICS_BATCH)
+/** Add a range of device instances to the batch.
+ * @param first - first device instance of the range
+ * @param last - last device instance of the range
+ * @return true if the devices were added
+ */
+static bool epics_batch_add(uint32_t first, uint32_t last)
+{
+    struct epics_batch_device *device;
+    unsigned size;
+    uint32_t device_id;
+
+    for (device_id = first; device_id <= last; device_id++) {
+        if (Batch_Device_Count >= Batch_Device_Size) {
+            size = Batch_Device_Size ? (Batch_Device_Size * 2) : 64;
+            device = realloc(Batch_Device, size * sizeof(*device));
+            if (!device) {
+                return false;
+            }
+            Batch_Device = device;
+            Batch_Device_Size = size;
+        }
+        device = &Batch_Device[Batch_Device_Count];
+        memset(device, 0, sizeof(*device));
+        device->device_id = device_id;
+        device->status = EPICS_EXIT_UNBOUND;
+        Batch_Device_Count++;
+    }
+
+    return true;
+}
+
+/** Handler for I-Am while the devices of the batch are being bound.
+ * The addresses are kept with the batch, since the address cache
+ * may be smaller than the batch.
+ * @param service_request - the I-Am service request
+ * @param service_len - length of the service request
+ * @param src - BACnet address of the device
+ */
+static void epics_batch_i_am_handler(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    uint32_t device_id = 0;
+    unsigned max_apdu = 0;
+    int segmentation = 0;
+    uint16_t vendor_id = 0;
+    unsigned i;
+
+    (void)service_len;
+    if (iam_decode_service_request(service_request, &device_id, &max_apdu,
+            &segmentation, &vendor_id) <= 0) {
+        return;
+    }
+    for (i = 0; i < Batch_Device_Count; i++) {
+        if (Batch_Device[i].device_id == device_id) {
+            if (!Batch_Device[i].bound) {
+                bacnet_address_copy(&Batch_Device[i].address, src);
+                Batch_Device[i].max_apdu = max_apdu;
+                Batch_Device[i].bound = true;
+                Batch_Bound_Count++;
+            }
+            break;
+        }
+    }
+}
+
+/** Send a Who-Is for each run of consecutive devices not yet bound */
+static void epics_batch_who_is(void)
+{
+    unsigned i = 0, j;
+
+    while (i < Batch_Device_Count) {
+        if (Batch_Device[i].bound) {
+            i++;
+            continue;
+        }
+        j = i;
+        while (((j + 1) < Batch_Device_Count) && !Batch_Device[j + 1].bound &&
+            (Batch_Device[j + 1].device_id ==
+                (Batch_Device[j].device_id + 1))) {
+            j++;
+        }
+        Send_WhoIs(Batch_Device[i].device_id, Batch_Device[j].device_id);
+        i = j + 1;
+    }
+}
+
+/** Bind with the devices of the batch, repeating the Who-Is for the
+ * devices that have not answered every APDU timeout.
+ * @param timeout_ms - time allowed to bind with all of the devices
+ */
+static void epics_batch_bind(unsigned long timeout_ms)
+{
+    BACNET_ADDRESS src = { 0 };
+    struct mstimer timeout = { 0 };
+    struct mstimer resend = { 0 };
+    uint16_t pdu_len;
+
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_I_AM, epics_batch_i_am_handler);
+    mstimer_set(&timeout, timeout_ms);
+    mstimer_set(&resend, apdu_timeout());
+    epics_batch_who_is();
+    while ((Batch_Bound_Count < Batch_Device_Count) &&
+        !mstimer_expired(&timeout)) {
+        pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, 100);
+        if (pdu_len) {
+            npdu_handler(&src, &Rx_Buf[0], pdu_len);
+        }
+        if (mstimer_expired(&resend)) {
+            mstimer_reset(&resend);
+            epics_batch_who_is();
+        }
+    }
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, handler_i_am_bind);
+}
+
+static const char *epics_batch_status_text(int status)
+{
+    switch (status) {
+        case EPICS_EXIT_OK:
+            return "ok";
+        case EPICS_EXIT_INCOMPLETE:
+            return "incomplete";
+        case EPICS_EXIT_ERRORS:
+            return "errors";
+        case EPICS_EXIT_FILE:
+            return "file-error";
+        case EPICS_EXIT_UNBOUND:
+            return "unbound";
+        default:
+            break;
+    }
+
+    return "failed";
+}
+
+/** Start the worker process for one device of the batch.  The worker
+ * has its own UDP port and invoke IDs, and walks its device with one
+ * outstanding request at a time, like the single device EPICS.  It
+ * writes the EPICS of its device to its own file as it goes.
+ * @param device - the device of the batch
+ * @param network_port - the UDP port of the BACnet/IP network
+ * @param worker_port - the UDP port of this worker
+ * @return the process ID in the parent, 0 in the worker, or -1 on error
+ */
+static pid_t epics_batch_worker(struct epics_batch_device *device,
+    uint16_t network_port,
+    uint16_t worker_port)
+{
+    char path[PATH_MAX] = { 0 };
+    char port_text[8] = { 0 };
+    pid_t pid;
+
+    fflush(stdout);
+    fflush(stderr);
+    pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+    snprintf(path, sizeof(path), "%s/epics-%lu.tpi", Batch_Output_Dir,
+        (unsigned long)device->device_id);
+    if (!freopen(path, "w", stdout)) {
+        fprintf(stderr, "Error: unable to write %s: %s\n", path,
+            strerror(errno));
+        exit(EPICS_EXIT_FILE);
+    }
+#if defined(BACDL_BIP)
+    snprintf(port_text, sizeof(port_text), "%u", (unsigned)worker_port);
+    setenv("BACNET_IP_PORT", port_text, 1);
+#else
+    (void)port_text;
+    (void)worker_port;
+#endif
+    dlenv_init();
+#if defined(BACDL_BIP)
+    /* send to the devices on the port of the network */
+    bip_set_port(network_port);
+#else
+    (void)network_port;
+#endif
+    Target_Device_Object_Instance = device->device_id;
+    address_add(device->device_id, device->max_apdu, &device->address);
+    Batch_Worker = true;
+
+    return 0;
+}
+
+/** Generate the EPICS of every device of the batch, with up to
+ * Batch_Jobs devices worked on at the same time, and print the time
+ * used by each device as it completes, and a summary.
+ * @param timeout_ms - time allowed to bind with all of the devices
+ * @note Only returns in a worker process, which then generates the
+ *  EPICS of its one device.
+ */
+static void epics_batch(unsigned long timeout_ms)
+{
+    struct epics_batch_device *device;
+    unsigned long start, elapsed, slowest = 0, total = 0;
+    uint32_t slowest_id = 0;
+    uint16_t network_port = 0, base_port = 0;
+    unsigned next = 0, running = 0, completed = 0, i;
+    unsigned count[EPICS_EXIT_FAILED + 1] = { 0 };
+    bool *slot_busy;
+    int status;
+    pid_t pid;
+
+    if ((mkdir(Batch_Output_Dir, 0777) != 0) && (errno != EEXIST)) {
+        fprintf(stderr, "Error: unable to create %s: %s\n", Batch_Output_Dir,
+            strerror(errno));
+        exit(1);
+    }
+    start = mstimer_now();
+    epics_batch_bind(timeout_ms);
+    fprintf(stderr, "Bound %u of %u devices in %lums\n", Batch_Bound_Count,
+        Batch_Device_Count, mstimer_now() - start);
+#if defined(BACDL_BIP)
+    network_port = bip_get_port();
+    base_port = My_BIP_Port ? My_BIP_Port : network_port;
+#else
+    /* only BACnet/IP can give each worker its own port */
+    Batch_Jobs = 1;
+#endif
+    /* the workers open their own datalink */
+    datalink_cleanup();
+    slot_busy = calloc(Batch_Jobs, sizeof(bool));
+    if (!slot_busy) {
+        exit(1);
+    }
+    printf("Device   Status      Seconds\n");
+    while ((next < Batch_Device_Count) || (running > 0)) {
+        if ((next < Batch_Device_Count) && (running < Batch_Jobs)) {
+            device = &Batch_Device[next];
+            next++;
+            if (!device->bound) {
+                printf("%-8lu %-10s %8s\n", (unsigned long)device->device_id,
+                    epics_batch_status_text(device->status), "-");
+                count[EPICS_EXIT_UNBOUND]++;
+                continue;
+            }
+            for (i = 0; i < Batch_Jobs; i++) {
+                if (!slot_busy[i]) {
+                    break;
+                }
+            }
+            device->slot = i;
+            device->start = mstimer_now();
+            pid = epics_batch_worker(
+                device, network_port, (uint16_t)(base_port + 1 + i));
+            if (pid == 0) {
+                free(slot_busy);
+                return;
+            }
+            if (pid < 0) {
+                device->status = EPICS_EXIT_FAILED;
+                count[EPICS_EXIT_FAILED]++;
+                continue;
+            }
+            device->pid = pid;
+            slot_busy[i] = true;
+            running++;
+            continue;
+        }
+        pid = wait(&status);
+        if (pid < 0) {
+            break;
+        }
+        for (i = 0; i < Batch_Device_Count; i++) {
+            device = &Batch_Device[i];
+            if (device->bound && (device->pid == pid)) {
+                break;
+            }
+        }
+        if (i >= Batch_Device_Count) {
+            continue;
+        }
+        device->elapsed = mstimer_now() - device->start;
+        if (WIFEXITED(status) && (WEXITSTATUS(status) < EPICS_EXIT_FAILED)) {
+            device->status = WEXITSTATUS(status);
+        } else {
+            device->status = EPICS_EXIT_FAILED;
+        }
+        device->pid = 0;
+        slot_busy[device->slot] = false;
+        running--;
+        completed++;
+        count[device->status]++;
+        total += device->elapsed;
+        if (device->elapsed >= slowest) {
+            slowest = device->elapsed;
+            slowest_id = device->device_id;
+        }
+        /* stream the time of each device as it completes */
+        printf("%-8lu %-10s %8.1f\n", (unsigned long)device->device_id,
+            epics_batch_status_text(device->status),
+            (double)device->elapsed / 1000.0);
+        fflush(stdout);
+    }
+    free(slot_busy);
+    elapsed = mstimer_now() - start;
+    printf("-- %u devices in %.1f seconds: %u ok, %u with errors, "
+           "%u incomplete, %u unbound, %u failed\n",
+        Batch_Device_Count, (double)elapsed / 1000.0, count[EPICS_EXIT_OK],
+        count[EPICS_EXIT_ERRORS], count[EPICS_EXIT_INCOMPLETE],
+        count[EPICS_EXIT_UNBOUND],
+        count[EPICS_EXIT_FILE] + count[EPICS_EXIT_FAILED]);
+    if (completed > 0) {
+        printf("-- %.1f seconds per device, slowest was %lu at %.1f seconds\n",
+            (double)total / 1000.0 / completed, (unsigned long)slowest_id,
+            (double)slowest / 1000.0);
+    }
+    if (count[EPICS_EXIT_OK] != Batch_Device_Count) {
+        exit(1);
+    }
+    exit(0);
+}
+#endif
+
 static void print_usage(char *filename)
 {
     printf("Usage: %s [-v] [-d] [-p sport] [-t target_mac [-n dnet]]"
            " device-instance\n",
         filename);
+#if defined(BACEPICS_BATCH)
+    printf("       [--jobs N][--output dir][--chunk N]"
+           " device-instance[-last] ...\n");
+#else
+    printf("       [--chunk N]\n");
+#endif
     printf("       [--version][--help]\n");
 }
 
@@ -1035,6 +1464,20 @@ static void print_help(char *filename)
     printf("    Use \"7F:00:00:01:BA:C0\" for loopback testing \n");
     printf("-n: specify target's DNET if not local BACnet network  \n");
     printf("    or on routed Virtual Network \n");
+    printf("--chunk: number of array elements read in each request\n");
+    printf("    when a long array like the Object_List has to be walked.\n");
+    printf("    Use 1 to read one element at a time.  16 is default.\n");
+#if defined(BACEPICS_BATCH)
+    printf("\n");
+    printf("Batch mode is used when more than one device-instance, a range\n"
+           "of them like 1000-1799, or --output is given.  Each device is\n"
+           "worked on by its own process with its own port, one past\n"
+           "sport, and is written to dir/epics-<device-instance>.tpi\n"
+           "while the time used by each device is printed.\n");
+    printf("--jobs: number of devices worked on at the same time.\n");
+    printf("    8 is default.\n");
+    printf("--output: directory for the EPICS files. . is default.\n");
+#endif
     printf("\n");
     printf("You can redirect the output to a .tpi file for VTS use,\n");
     printf("e.g., bacepics 2701876 > epics-2701876.tpi \n");
@@ -1070,7 +1513,29 @@ static int CheckCommandLineArgs(int argc, char *argv[])
     }
     for (i = 1; i < argc; i++) {
         char *anArg = argv[i];
-        if (anArg[0] == '-') {
+        if (strcmp(anArg, "--chunk") == 0) {
+            if (++i < argc) {
+                Array_Chunk = (unsigned)strtoul(argv[i], NULL, 0);
+                if (Array_Chunk < 1) {
+                    Array_Chunk = 1;
+                } else if (Array_Chunk > ARRAY_CHUNK_MAX) {
+                    Array_Chunk = ARRAY_CHUNK_MAX;
+                }
+            }
+#if defined(BACEPICS_BATCH)
+        } else if (strcmp(anArg, "--jobs") == 0) {
+            if (++i < argc) {
+                Batch_Jobs = (unsigned)strtoul(argv[i], NULL, 0);
+                if (Batch_Jobs < 1) {
+                    Batch_Jobs = 1;
+                }
+            }
+        } else if (strcmp(anArg, "--output") == 0) {
+            if (++i < argc) {
+                Batch_Output_Dir = argv[i];
+            }
+#endif
+        } else if (anArg[0] == '-') {
             switch (anArg[1]) {
                 case 'o':
                     Optional_Properties = true;
@@ -1132,15 +1597,31 @@ static int CheckCommandLineArgs(int argc, char *argv[])
                     break;
             }
         } else {
-            /* decode the Target Device Instance parameter */
-            Target_Device_Object_Instance = strtol(anArg, NULL, 0);
-            if (Target_Device_Object_Instance > BACNET_MAX_INSTANCE) {
+            /* decode the Target Device Instance parameter, or a range */
+            char *pEnd = NULL;
+            uint32_t last_instance;
+            Target_Device_Object_Instance = strtol(anArg, &pEnd, 0);
+            last_instance = Target_Device_Object_Instance;
+            if (pEnd && (*pEnd == '-')) {
+                last_instance = strtol(pEnd + 1, NULL, 0);
+            }
+            if ((Target_Device_Object_Instance > BACNET_MAX_INSTANCE) ||
+                (last_instance > BACNET_MAX_INSTANCE)) {
                 fprintf(stdout,
                     "Error: device-instance=%u - it must be less than %u\n",
                     Target_Device_Object_Instance, BACNET_MAX_INSTANCE + 1);
                 print_usage(filename);
                 exit(0);
             }
+#if defined(BACEPICS_BATCH)
+            if ((last_instance < Target_Device_Object_Instance) ||
+                !epics_batch_add(
+                    Target_Device_Object_Instance, last_instance)) {
+                fprintf(stdout, "Error: invalid device-instance %s\n", anArg);
+                print_usage(filename);
+                exit(0);
+            }
+#endif
             bFoundTarget = true;
         }
     }
@@ -1149,6 +1630,18 @@ static int CheckCommandLineArgs(int argc, char *argv[])
         print_usage(filename);
         exit(0);
     }
+#if defined(BACEPICS_BATCH)
+    if ((Batch_Device_Count > 1) || Batch_Output_Dir) {
+        if (Provided_Targ_MAC) {
+            fprintf(stdout, "Error: -t is only for a single device \n\n");
+            print_usage(filename);
+            exit(0);
+        }
+        if (!Batch_Output_Dir) {
+            Batch_Output_Dir = ".";
+        }
+    }
+#endif
 
     return 0; /* All OK if we reach here */
 }
@@ -1444,6 +1937,9 @@ int main(int argc, char *argv[])
     BACNET_OBJECT_ID myObject;
     uint8_t buffer[MAX_PDU] = { 0 };
     BACNET_READ_ACCESS_DATA *rpm_object = NULL;
+    BACNET_READ_ACCESS_DATA *rpm_data = NULL;
+    BACNET_PROPERTY_REFERENCE *rpm_property = NULL;
+    BACNET_PROPERTY_REFERENCE *old_rpm_property = NULL;
     KEY nextKey;
 
     CheckCommandLineArgs(argc, argv); /* Won't return if there is an issue. */
@@ -1486,6 +1982,12 @@ int main(int argc, char *argv[])
         /* Set back to std BACnet/IP port */
         bip_set_port(0xBAC0);
     }
+#endif
+#if defined(BACEPICS_BATCH)
+    if (Batch_Output_Dir) {
+        /* only returns in the worker process of one device */
+        epics_batch((unsigned long)timeout_seconds * 1000UL);
+    }
 #endif
     /* try to bind with the target device */
     found = address_bind_request(
@@ -1713,10 +2215,33 @@ int main(int argc, char *argv[])
                     (Request_Invoke_ID ==
                         Read_Property_Multiple_Data.service_data.invoke_id)) {
                     Read_Property_Multiple_Data.new_data = false;
-                    PrintReadPropertyData(
-                        Read_Property_Multiple_Data.rpm_data->object_type,
-                        Read_Property_Multiple_Data.rpm_data->object_instance,
-                        Read_Property_Multiple_Data.rpm_data->listOfProperties);
+                    rpm_data = Read_Property_Multiple_Data.rpm_data;
+                    /* one property, or a chunk of array elements */
+                    rpm_property = rpm_data->listOfProperties;
+                    while (rpm_property) {
+                        PrintReadPropertyData(rpm_data->object_type,
+                            rpm_data->object_instance, rpm_property);
+                        /* Advance the property (or Array List) index */
+                        if (Using_Walked_List) {
+                            Walked_List_Index++;
+                            if (Walked_List_Index > Walked_List_Length) {
+                                /* go on to next property */
+                                Property_List_Index++;
+                                Using_Walked_List = false;
+                            }
+                        } else {
+                            Property_List_Index++;
+                        }
+                        old_rpm_property = rpm_property;
+                        rpm_property = rpm_property->next;
+                        free(old_rpm_property);
+                        if (!Using_Walked_List) {
+                            break;
+                        }
+                    }
+                    rpm_data->listOfProperties = rpm_property;
+                    rpm_data = rpm_data_free(rpm_data);
+                    free(rpm_data);
                     if (tsm_invoke_id_free(Request_Invoke_ID)) {
                         Request_Invoke_ID = 0;
                     } else {
@@ -1724,23 +2249,18 @@ int main(int argc, char *argv[])
                         Request_Invoke_ID = 0;
                     }
                     elapsed_seconds = 0;
-                    /* Advance the property (or Array List) index */
-                    if (Using_Walked_List) {
-                        Walked_List_Index++;
-                        if (Walked_List_Index > Walked_List_Length) {
-                            /* go on to next property */
-                            Property_List_Index++;
-                            Using_Walked_List = false;
-                        }
-                    } else {
-                        Property_List_Index++;
-                    }
                     myState = GET_PROPERTY_REQUEST; /* Go fetch next Property */
                 } else if (tsm_invoke_id_free(Request_Invoke_ID)) {
                     Request_Invoke_ID = 0;
                     elapsed_seconds = 0;
                     myState = GET_PROPERTY_REQUEST;
-                    if (Error_Detected) {
+                    if (Using_Walked_List && Has_RPM && (Array_Chunk > 1) &&
+                        (Walked_List_Length > 0)) {
+                        /* the device would not answer a chunk of the
+                           array, so walk it one element at a time */
+                        Array_Chunk = 1;
+                        Error_Detected = false;
+                    } else if (Error_Detected) {
                         if ((Last_Error_Class != ERROR_CLASS_PROPERTY) &&
                             (Last_Error_Code != ERROR_CODE_UNKNOWN_PROPERTY)) {
                             if (IsLongArray) {
@@ -1871,6 +2391,18 @@ int main(int argc, char *argv[])
         printf("End of BACnet Protocol Implementation Conformance Statement\n");
         printf("\n");
     }
+#if defined(BACEPICS_BATCH)
+    if (Batch_Worker) {
+        /* tell the batch how far this device got */
+        if ((myState == INITIAL_BINDING) ||
+            (myObject.type < MAX_BACNET_OBJECT_TYPE)) {
+            return EPICS_EXIT_INCOMPLETE;
+        }
+        if (Error_Count > 0) {
+            return EPICS_EXIT_ERRORS;
+        }
+    }
+#endif
 
     return 0;
 }
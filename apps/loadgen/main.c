@@ -0,0 +1,724 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Load generator that benchmarks a BACnet server device and client
+ *  in one process over a loopback datalink
+ *
+ * @section DESCRIPTION
+ *
+ * A server device with the objects of the server app, and a client with
+ * its own stack context, are connected by loopback datalink ports.  The
+ * client sends a mix of ReadProperty, ReadPropertyMultiple, WriteProperty,
+ * SubscribeCOV, and ReadRange requests at a target rate with a window of
+ * outstanding requests, and the throughput, the 50th and 99th percentile
+ * latency of each service, and the heap allocations per request are
+ * reported.  The app is built with BACDL_CUSTOM, and provides the
+ * datalink functions for the port of the selected device.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
+#include "bacnet/readrange.h"
+#include "bacnet/rpm.h"
+#include "bacnet/version.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/stack_context.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/datalink/datalink.h"
+#include "bacnet/datalink/dlloop.h"
+
+#if !defined(BACDL_CUSTOM)
+#error The load generator provides the datalink, and needs BACDL_CUSTOM
+#endif
+
+#define LOADGEN_SERVER_MAC 1
+#define LOADGEN_CLIENT_MAC 2
+#define LOADGEN_SERVER_INSTANCE 1234
+#define LOADGEN_CLIENT_INSTANCE 4321
+/* first instance of the objects created with --objects */
+#define LOADGEN_OBJECTS_INSTANCE 1000
+
+enum loadgen_service {
+    LOADGEN_RP,
+    LOADGEN_RPM,
+    LOADGEN_WP,
+    LOADGEN_COV,
+    LOADGEN_RR,
+    LOADGEN_SERVICE_MAX
+};
+
+struct loadgen_service_stats {
+    const char *name;
+    unsigned weight;
+    unsigned long requests;
+    unsigned long responses;
+    unsigned long errors;
+    unsigned long samples;
+    uint32_t *latency_ns;
+};
+
+struct loadgen_request {
+    bool pending;
+    enum loadgen_service service;
+    uint64_t start_ns;
+};
+
+static struct loadgen_service_stats Service_Stats[LOADGEN_SERVICE_MAX] = {
+    { "ReadProperty", 50, 0, 0, 0, 0, NULL },
+    { "ReadPropertyMultiple", 20, 0, 0, 0, 0, NULL },
+    { "WriteProperty", 10, 0, 0, 0, 0, NULL },
+    { "SubscribeCOV", 10, 0, 0, 0, 0, NULL },
+    { "ReadRange", 10, 0, 0, 0, 0, NULL }
+};
+static struct loadgen_request Requests[256];
+static unsigned Outstanding;
+static unsigned Duration = 10;
+static unsigned Rate;
+static unsigned Window = 4;
+static bool RPM_All;
+static unsigned Objects;
+static unsigned long Max_Samples = 1000000UL;
+static uint32_t Random_State = 0x2545F491UL;
+
+/* loopback datalink ports of the server and the client */
+static DLLOOP_PORT Server_Port;
+static DLLOOP_PORT Client_Port;
+static DLLOOP_PORT *Datalink_Port;
+static BACNET_STACK_CONTEXT *Client_Context;
+static uint8_t Rx_Buf[MAX_MPDU];
+
+/* heap allocations, counted when the C library lets us interpose */
+static unsigned long Allocations;
+#if defined(__GLIBC__)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    Allocations++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    Allocations++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    Allocations++;
+    return __libc_realloc(ptr, size);
+}
+#define LOADGEN_ALLOCATIONS_COUNTED 1
+#endif
+
+bool datalink_init(char *ifname)
+{
+    return dlloop_init(Datalink_Port, ifname);
+}
+
+int datalink_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    return dlloop_send_pdu(Datalink_Port, dest, npdu_data, pdu, pdu_len);
+}
+
+uint16_t datalink_receive(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
+{
+    return dlloop_receive(Datalink_Port, src, pdu, max_pdu, timeout);
+}
+
+void datalink_cleanup(void)
+{
+    dlloop_cleanup(Datalink_Port);
+}
+
+void datalink_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    dlloop_get_broadcast_address(Datalink_Port, dest);
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    dlloop_get_my_address(Datalink_Port, my_address);
+}
+
+void datalink_set_interface(char *ifname)
+{
+    (void)ifname;
+}
+
+void datalink_set(char *datalink_string)
+{
+    (void)datalink_string;
+}
+
+void datalink_maintenance_timer(uint16_t seconds)
+{
+    (void)seconds;
+}
+
+static uint64_t loadgen_time_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static uint32_t loadgen_random(void)
+{
+    /* xorshift32, so that runs with the same seed send the same mix */
+    Random_State ^= Random_State << 13;
+    Random_State ^= Random_State >> 17;
+    Random_State ^= Random_State << 5;
+
+    return Random_State;
+}
+
+static void loadgen_select_server(void)
+{
+    (void)stack_context_select(NULL);
+    Datalink_Port = &Server_Port;
+}
+
+static void loadgen_select_client(void)
+{
+    (void)stack_context_select(Client_Context);
+    Datalink_Port = &Client_Port;
+}
+
+/**
+ * @brief Record the response to a request of the client
+ * @param invoke_id - invoke ID of the request
+ * @param error - true if the response was an error, reject, or abort
+ */
+static void loadgen_response(uint8_t invoke_id, bool error)
+{
+    struct loadgen_request *request = &Requests[invoke_id];
+    struct loadgen_service_stats *stats;
+    uint64_t latency;
+
+    if (!request->pending) {
+        return;
+    }
+    latency = loadgen_time_ns() - request->start_ns;
+    stats = &Service_Stats[request->service];
+    stats->responses++;
+    if (error) {
+        stats->errors++;
+    }
+    if (stats->samples < Max_Samples) {
+        if (latency > UINT32_MAX) {
+            latency = UINT32_MAX;
+        }
+        stats->latency_ns[stats->samples++] = (uint32_t)latency;
+    }
+    request->pending = false;
+    Outstanding--;
+    tsm_free_invoke_id(invoke_id);
+}
+
+static void loadgen_complex_ack(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    loadgen_response(service_data->invoke_id, false);
+}
+
+static void loadgen_simple_ack(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    (void)src;
+    loadgen_response(invoke_id, false);
+}
+
+static void loadgen_error(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    (void)src;
+    (void)error_class;
+    (void)error_code;
+    loadgen_response(invoke_id, true);
+}
+
+static void loadgen_abort(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
+{
+    (void)src;
+    (void)abort_reason;
+    (void)server;
+    loadgen_response(invoke_id, true);
+}
+
+static void loadgen_reject(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
+{
+    (void)src;
+    (void)reject_reason;
+    loadgen_response(invoke_id, true);
+}
+
+/**
+ * @brief Set the handlers of the server services, and of the client
+ *  responses.  Both devices share the APDU handlers.
+ */
+static void Init_Service_Handlers(void)
+{
+    static const BACNET_CONFIRMED_SERVICE Complex_Services[] = {
+        SERVICE_CONFIRMED_READ_PROPERTY, SERVICE_CONFIRMED_READ_PROP_MULTIPLE,
+        SERVICE_CONFIRMED_READ_RANGE
+    };
+    static const BACNET_CONFIRMED_SERVICE Simple_Services[] = {
+        SERVICE_CONFIRMED_WRITE_PROPERTY, SERVICE_CONFIRMED_SUBSCRIBE_COV
+    };
+    unsigned i;
+
+    Device_Init(NULL);
+    apdu_set_unrecognized_service_handler_handler(handler_unrecognized_service);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, handler_read_property_multiple);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_WRITE_PROPERTY, handler_write_property);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_RANGE, handler_read_range);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV, handler_cov_subscribe);
+    for (i = 0; i < sizeof(Complex_Services) / sizeof(Complex_Services[0]);
+         i++) {
+        apdu_set_confirmed_ack_handler(
+            Complex_Services[i], loadgen_complex_ack);
+        apdu_set_error_handler(Complex_Services[i], loadgen_error);
+    }
+    for (i = 0; i < sizeof(Simple_Services) / sizeof(Simple_Services[0]);
+         i++) {
+        apdu_set_confirmed_simple_ack_handler(
+            Simple_Services[i], loadgen_simple_ack);
+        apdu_set_error_handler(Simple_Services[i], loadgen_error);
+    }
+    apdu_set_abort_handler(loadgen_abort);
+    apdu_set_reject_handler(loadgen_reject);
+}
+
+static enum loadgen_service loadgen_service_next(void)
+{
+    unsigned total = 0;
+    unsigned pick;
+    unsigned i;
+
+    for (i = 0; i < LOADGEN_SERVICE_MAX; i++) {
+        total += Service_Stats[i].weight;
+    }
+    pick = loadgen_random() % total;
+    for (i = 0; i < LOADGEN_SERVICE_MAX; i++) {
+        if (pick < Service_Stats[i].weight) {
+            break;
+        }
+        pick -= Service_Stats[i].weight;
+    }
+
+    return (enum loadgen_service)i;
+}
+
+/**
+ * @brief Send the next request of the mix from the client
+ * @return true if the request was sent
+ */
+static bool loadgen_request_send(void)
+{
+    static uint8_t RPM_Buffer[MAX_PDU];
+    BACNET_PROPERTY_REFERENCE properties[3] = { { 0 } };
+    BACNET_READ_ACCESS_DATA read_access = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_READ_RANGE_DATA range = { 0 };
+    enum loadgen_service service;
+    uint32_t instance;
+    uint8_t invoke_id = 0;
+    uint64_t start_ns;
+
+    service = loadgen_service_next();
+    instance = loadgen_random() % 4;
+    start_ns = loadgen_time_ns();
+    switch (service) {
+        case LOADGEN_RP:
+            invoke_id = Send_Read_Property_Request(LOADGEN_SERVER_INSTANCE,
+                OBJECT_ANALOG_INPUT, instance, PROP_PRESENT_VALUE,
+                BACNET_ARRAY_ALL);
+            break;
+        case LOADGEN_RPM:
+            if (RPM_All) {
+                properties[0].propertyIdentifier = PROP_ALL;
+                properties[0].propertyArrayIndex = BACNET_ARRAY_ALL;
+                read_access.object_type = OBJECT_ANALOG_VALUE;
+                read_access.object_instance = instance;
+                read_access.listOfProperties = &properties[0];
+                invoke_id = Send_Read_Property_Multiple_Request(RPM_Buffer,
+                    sizeof(RPM_Buffer), LOADGEN_SERVER_INSTANCE,
+                    &read_access);
+                break;
+            }
+            properties[0].propertyIdentifier = PROP_OBJECT_NAME;
+            properties[0].propertyArrayIndex = BACNET_ARRAY_ALL;
+            properties[0].next = &properties[1];
+            properties[1].propertyIdentifier = PROP_PRESENT_VALUE;
+            properties[1].propertyArrayIndex = BACNET_ARRAY_ALL;
+            properties[1].next = &properties[2];
+            properties[2].propertyIdentifier = PROP_STATUS_FLAGS;
+            properties[2].propertyArrayIndex = BACNET_ARRAY_ALL;
+            read_access.object_type = OBJECT_ANALOG_VALUE;
+            read_access.object_instance = instance;
+            read_access.listOfProperties = &properties[0];
+            invoke_id = Send_Read_Property_Multiple_Request(RPM_Buffer,
+                sizeof(RPM_Buffer), LOADGEN_SERVER_INSTANCE, &read_access);
+            break;
+        case LOADGEN_WP:
+            value.tag = BACNET_APPLICATION_TAG_REAL;
+            value.type.Real = (float)(loadgen_random() % 1000) / 10.0f;
+            invoke_id = Send_Write_Property_Request(LOADGEN_SERVER_INSTANCE,
+                OBJECT_ANALOG_VALUE, instance, PROP_PRESENT_VALUE, &value,
+                BACNET_MAX_PRIORITY, BACNET_ARRAY_ALL);
+            break;
+        case LOADGEN_COV:
+            cov_data.subscriberProcessIdentifier = 1 + instance;
+            cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+            cov_data.monitoredObjectIdentifier.instance = instance;
+            cov_data.issueConfirmedNotifications = false;
+            cov_data.lifetime = 300;
+            invoke_id =
+                Send_COV_Subscribe(LOADGEN_SERVER_INSTANCE, &cov_data);
+            break;
+        case LOADGEN_RR:
+            range.object_type = OBJECT_TRENDLOG;
+            range.object_instance = instance;
+            range.object_property = PROP_LOG_BUFFER;
+            range.array_index = BACNET_ARRAY_ALL;
+            range.RequestType = RR_BY_POSITION;
+            range.Range.RefIndex = 1;
+            range.Count = 10;
+            invoke_id =
+                Send_ReadRange_Request(LOADGEN_SERVER_INSTANCE, &range);
+            break;
+        default:
+            break;
+    }
+    if (invoke_id == 0) {
+        return false;
+    }
+    Requests[invoke_id].pending = true;
+    Requests[invoke_id].service = service;
+    Requests[invoke_id].start_ns = start_ns;
+    Service_Stats[service].requests++;
+    Outstanding++;
+
+    return true;
+}
+
+/**
+ * @brief Handle the NPDUs that were sent to the selected device
+ */
+static void loadgen_receive(void)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint16_t pdu_len;
+
+    for (;;) {
+        pdu_len = datalink_receive(&src, Rx_Buf, sizeof(Rx_Buf), 0);
+        if (pdu_len == 0) {
+            break;
+        }
+        npdu_handler(&src, Rx_Buf, pdu_len);
+    }
+}
+
+static int latency_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static double latency_percentile(
+    struct loadgen_service_stats *stats, unsigned percent)
+{
+    unsigned long index;
+
+    if (stats->samples == 0) {
+        return 0.0;
+    }
+    index = ((stats->samples - 1) * percent) / 100;
+
+    return (double)stats->latency_ns[index] / 1000.0;
+}
+
+static void loadgen_report(double seconds, unsigned long allocations)
+{
+    struct loadgen_service_stats *stats;
+    unsigned long requests = 0;
+    unsigned long responses = 0;
+    unsigned i;
+
+    printf("%-22s %10s %8s %10s %10s\n", "service", "requests", "errors",
+        "p50 us", "p99 us");
+    for (i = 0; i < LOADGEN_SERVICE_MAX; i++) {
+        stats = &Service_Stats[i];
+        if (stats->requests == 0) {
+            continue;
+        }
+        qsort(stats->latency_ns, stats->samples, sizeof(uint32_t),
+            latency_compare);
+        printf("%-22s %10lu %8lu %10.1f %10.1f\n", stats->name,
+            stats->requests, stats->errors, latency_percentile(stats, 50),
+            latency_percentile(stats, 99));
+        requests += stats->requests;
+        responses += stats->responses;
+    }
+    printf("%lu requests, %lu responses in %.2f s: %.0f requests/s\n",
+        requests, responses, seconds, (double)responses / seconds);
+#if defined(LOADGEN_ALLOCATIONS_COUNTED)
+    printf("%lu heap allocations: %.3f per request\n", allocations,
+        requests ? (double)allocations / (double)requests : 0.0);
+#else
+    (void)allocations;
+    printf("heap allocations are not counted with this C library\n");
+#endif
+}
+
+static bool loadgen_mix_parse(char *mix)
+{
+    unsigned long weight;
+    unsigned total = 0;
+    char *end = mix;
+    unsigned i;
+
+    for (i = 0; i < LOADGEN_SERVICE_MAX; i++) {
+        weight = strtoul(end, &end, 10);
+        Service_Stats[i].weight = (unsigned)weight;
+        total += Service_Stats[i].weight;
+        if (*end == ',') {
+            end++;
+        } else if (*end == 0) {
+            i++;
+            break;
+        } else {
+            return false;
+        }
+    }
+    for (; i < LOADGEN_SERVICE_MAX; i++) {
+        Service_Stats[i].weight = 0;
+    }
+
+    return (total > 0);
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--duration S][--rate N][--window N]\n"
+           "  [--mix RP,RPM,WP,COV,RR][--rpm-all][--seed N][--samples N]\n"
+           "  [--objects N]\n",
+        filename);
+    printf("       %s [--version][--help]\n", filename);
+}
+
+static void print_help(const char *filename)
+{
+    printf("Benchmark a BACnet server device with a client in the same\n"
+           "process, connected by a loopback datalink.\n");
+    printf("--duration S - seconds to run. Defaults to 10.\n");
+    printf("--rate N - requests per second, or 0 for as fast as\n"
+           "    possible. Defaults to 0.\n");
+    printf("--window N - outstanding requests, 1..%u. Defaults to 4.\n",
+        (unsigned)DLLOOP_QUEUE_COUNT);
+    printf("--mix RP,RPM,WP,COV,RR - relative weights of ReadProperty,\n"
+           "    ReadPropertyMultiple, WriteProperty, SubscribeCOV, and\n"
+           "    ReadRange requests. Defaults to 50,20,10,10,10.\n");
+    printf("--rpm-all - ReadPropertyMultiple requests read ALL of the\n"
+           "    properties of the object, instead of three properties.\n");
+    printf("--seed N - seed of the request mix.\n");
+    printf("--samples N - latency samples kept per service.\n"
+           "    Defaults to 1000000.\n");
+    printf("--objects N - create N Binary Input objects in the server\n"
+           "    at startup, and report the time it takes.\n");
+    printf("\n");
+    printf("Example:\n"
+           "%s --duration 5 --mix 100,0,0,0,0\n",
+        filename);
+}
+
+int main(int argc, char *argv[])
+{
+    char *filename = NULL;
+    uint64_t start_ns, end_ns, now_ns, last_ns;
+    unsigned long allocations;
+    unsigned long sent = 0;
+    unsigned i;
+    int argi = 0;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2023 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if (strcmp(argv[argi], "--rpm-all") == 0) {
+            RPM_All = true;
+            continue;
+        }
+        if (++argi >= argc) {
+            print_usage(filename);
+            return 1;
+        }
+        if (strcmp(argv[argi - 1], "--duration") == 0) {
+            Duration = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--rate") == 0) {
+            Rate = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--window") == 0) {
+            Window = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--seed") == 0) {
+            Random_State = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--samples") == 0) {
+            Max_Samples = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--objects") == 0) {
+            Objects = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--mix") == 0) {
+            if (!loadgen_mix_parse(argv[argi])) {
+                fprintf(stderr, "Invalid request mix.\n");
+                return 1;
+            }
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if ((Window < 1) || (Window > DLLOOP_QUEUE_COUNT) ||
+        (Window > MAX_TSM_TRANSACTIONS)) {
+        fprintf(stderr, "Invalid window.\n");
+        return 1;
+    }
+    if (Random_State == 0) {
+        Random_State = 1;
+    }
+    for (i = 0; i < LOADGEN_SERVICE_MAX; i++) {
+        Service_Stats[i].latency_ns = calloc(Max_Samples, sizeof(uint32_t));
+        if (!Service_Stats[i].latency_ns) {
+            fprintf(stderr, "Unable to allocate the latency samples.\n");
+            return 1;
+        }
+    }
+    /* server: the default stack context, with the server app objects */
+    Init_Service_Handlers();
+    Device_Set_Object_Instance_Number(LOADGEN_SERVER_INSTANCE);
+    address_own_device_id_set(LOADGEN_SERVER_INSTANCE);
+    if (Objects) {
+        unsigned created;
+
+        allocations = Allocations;
+        start_ns = loadgen_time_ns();
+        created = Device_Create_Objects(
+            OBJECT_BINARY_INPUT, LOADGEN_OBJECTS_INSTANCE, Objects);
+        end_ns = loadgen_time_ns();
+        printf("Created %u objects in %.3f ms, %lu allocations, "
+               "%u objects in the device\n",
+            created, (double)(end_ns - start_ns) / 1000000.0,
+            Allocations - allocations, Device_Object_List_Count());
+    }
+    dlloop_port_setup(&Server_Port, 1, LOADGEN_SERVER_MAC);
+    dlloop_port_setup(&Client_Port, 1, LOADGEN_CLIENT_MAC);
+    loadgen_select_server();
+    (void)datalink_init(NULL);
+    /* client: its own stack context, bound to the server */
+    Client_Context = stack_context_create(LOADGEN_CLIENT_INSTANCE);
+    if (!Client_Context) {
+        fprintf(stderr, "Unable to create the client stack context.\n");
+        return 1;
+    }
+    loadgen_select_client();
+    (void)datalink_init(NULL);
+    {
+        BACNET_ADDRESS server_address = { 0 };
+
+        dlloop_get_my_address(&Server_Port, &server_address);
+        address_add(LOADGEN_SERVER_INSTANCE, MAX_APDU, &server_address);
+    }
+    start_ns = loadgen_time_ns();
+    last_ns = start_ns;
+    end_ns = start_ns + ((uint64_t)Duration * 1000000000ULL);
+    allocations = Allocations;
+    for (now_ns = start_ns; now_ns < end_ns; now_ns = loadgen_time_ns()) {
+        loadgen_select_client();
+        while (Outstanding < Window) {
+            if (Rate && ((sent * 1000000000ULL) >=
+                            ((now_ns - start_ns) * (uint64_t)Rate))) {
+                break;
+            }
+            if (!loadgen_request_send()) {
+                break;
+            }
+            sent++;
+        }
+        if ((now_ns - last_ns) >= 1000000ULL) {
+            tsm_timer_milliseconds((uint16_t)((now_ns - last_ns) / 1000000ULL));
+            last_ns = now_ns;
+        }
+        loadgen_select_server();
+        loadgen_receive();
+        loadgen_select_client();
+        loadgen_receive();
+    }
+    allocations = Allocations - allocations;
+    now_ns = loadgen_time_ns();
+    loadgen_report((double)(now_ns - start_ns) / 1000000000.0, allocations);
+    if (Server_Port.receive_pdu_dropped || Client_Port.receive_pdu_dropped) {
+        printf("loopback dropped %lu server and %lu client PDUs\n",
+            (unsigned long)Server_Port.receive_pdu_dropped,
+            (unsigned long)Client_Port.receive_pdu_dropped);
+    }
+    loadgen_select_server();
+    datalink_cleanup();
+    loadgen_select_client();
+    datalink_cleanup();
+    (void)stack_context_select(NULL);
+    stack_context_delete(Client_Context);
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Command line tool that prints the performance counters that a
+ *  running BACnet application shares in memory
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bacnet/bacenum.h"
+#include "bacnet/bactext.h"
+#include "bacnet/version.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/sys/metrics.h"
+
+static void print_service(const char *name, const METRICS_SERVICE_DATA *data)
+{
+    unsigned i;
+
+    if (data->requests == 0) {
+        return;
+    }
+    printf("%-32s %10lu %10lu", name, (unsigned long)data->requests,
+        (unsigned long)data->latency_max);
+    for (i = 0; i < METRICS_HISTOGRAM_SIZE; i++) {
+        printf(" %lu", (unsigned long)data->latency_histogram[i]);
+    }
+    printf("\n");
+}
+
+static void print_metrics(const METRICS_DATA *metrics)
+{
+    unsigned i;
+
+    for (i = 0; i < METRICS_COUNTER_MAX; i++) {
+        printf("%-32s %10lu\n", metrics_counter_name(i),
+            (unsigned long)metrics->counter[i]);
+    }
+    for (i = 0; i < METRICS_GAUGE_MAX; i++) {
+        printf("%-32s %10lu %10lu\n", metrics_gauge_name(i),
+            (unsigned long)metrics->gauge[i].value,
+            (unsigned long)metrics->gauge[i].peak);
+    }
+    printf("%-32s %10s %10s %s\n", "service", "requests", "max-us",
+        "latency-histogram");
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        print_service(
+            bactext_confirmed_service_name(i), &metrics->confirmed[i]);
+    }
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        print_service(
+            bactext_unconfirmed_service_name(i), &metrics->unconfirmed[i]);
+    }
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--repeat seconds] pathname\n", filename);
+    printf("       [--version][--help]\n");
+}
+
+static void print_help(const char *filename)
+{
+    printf("Print the performance counters that a running BACnet\n"
+           "application shares in a memory mapped file, without\n"
+           "stopping the application.\n");
+    printf("\n");
+    printf("pathname:\n"
+           "The file of the shared counters, such as the file set by\n"
+           "BACNET_METRICS_FILE for the server built with BACNET_METRICS.\n");
+    printf("--repeat seconds\n"
+           "Print the counters again every number of seconds.\n");
+    printf("\nExample:\n"
+           "%s --repeat 5 /dev/shm/bacserv.metrics\n",
+        filename);
+}
+
+int main(int argc, char *argv[])
+{
+    char *filename = NULL;
+    const char *pathname = NULL;
+    METRICS_SHARED_DATA *shared;
+    METRICS_DATA metrics;
+    unsigned repeat = 0;
+    int argi = 0;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2023 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if ((strcmp(argv[argi], "--repeat") == 0) && (++argi < argc)) {
+            repeat = strtoul(argv[argi], NULL, 0);
+        } else if (!pathname) {
+            pathname = argv[argi];
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if (!pathname) {
+        print_usage(filename);
+        return 1;
+    }
+    shared = metrics_shared_map(pathname, false);
+    if (!shared) {
+        fprintf(stderr, "%s: unable to map %s\n", filename, pathname);
+        return 1;
+    }
+    for (;;) {
+        if (metrics_shared_read(shared, &metrics)) {
+            print_metrics(&metrics);
+        } else {
+            fprintf(stderr, "%s: no metrics in %s\n", filename, pathname);
+        }
+        if (repeat == 0) {
+            break;
+        }
+        sleep(repeat);
+        printf("\n");
+    }
+    metrics_shared_unmap(shared);
+
+    return 0;
+}
@@ -39,6 +39,7 @@
 #include <string.h>
 #include <errno.h>
 #include <time.h>
+#include <signal.h>
 #include "bacnet/bytes.h"
 #include "bacnet/iam.h"
 #include "bacnet/version.h"
@@ -46,6 +47,7 @@
 /* basic datalink, timer, and filename */
 #include "bacnet/datalink/dlmstp.h"
 #include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/ringbuf.h"
 #include "bacnet/datalink/crc.h"
 #include "bacnet/datalink/mstptext.h"
 #include "bacnet/basic/sys/filename.h"
@@ -75,7 +77,7 @@ static MSTP_RECEIVE_STATE MSTP_Receive_State = MSTP_RECEIVE_STATE_IDLE;
 static uint8_t RxBuffer[DLMSTP_MPDU_MAX];
 static uint8_t TxBuffer[DLMSTP_MPDU_MAX];
 /* method to tell main loop to exit from CTRL-C or other signals */
-static volatile bool Exit_Requested;
+static volatile sig_atomic_t Exit_Requested;
 /* flag to indicate Wireshark is running the show - no stdout or stderr */
 static bool Wireshark_Capture;
 /* placed to track silence on the wire */
@@ -533,19 +535,136 @@ static size_t data_write_header(
 }
 #endif
 
+/* capture files are rotated after this many packets, octets, or seconds */
+static uint32_t Rotate_Packets = 65535;
+static uint32_t Rotate_Octets;
+static uint32_t Rotate_Seconds;
+/* save in pcapng format with nanosecond timestamps and packet comments */
+static bool Capture_PCAPNG;
+/* packets are queued by the receive loop, and saved by the writer
+   using large writes, so that a slow disk doesn't stall the receiver */
+#ifndef MSTP_CAPTURE_PACKET_COUNT
+#define MSTP_CAPTURE_PACKET_COUNT 1024
+#endif
+#define MSTP_CAPTURE_WRITE_MAX 65536
+/* largest pcap record or pcapng block around the packet data */
+#define MSTP_CAPTURE_RECORD_OVERHEAD 128
+struct mstp_capture_packet {
+    uint32_t ts_sec;
+    uint32_t ts_nsec;
+    /* number of packets dropped just before this packet */
+    uint32_t dropped;
+    bool invalid;
+    uint16_t length;
+    uint8_t data[MSTP_HEADER_MAX + DLMSTP_MPDU_MAX + 2];
+};
+static struct mstp_capture_packet Capture_Buffer[MSTP_CAPTURE_PACKET_COUNT];
+static RING_BUFFER Capture_Queue;
+static bool Capture_Started;
+static bool Capture_Threaded;
+static uint32_t Capture_Dropped;
+static uint32_t Capture_Dropped_Pending;
+static uint8_t Write_Buffer[MSTP_CAPTURE_WRITE_MAX];
+static size_t Write_Length;
+static uint32_t File_Packets;
+static uint32_t File_Octets;
+static time_t File_Start;
+#if !defined(_WIN32)
+static pthread_t Capture_Thread;
+static volatile bool Capture_Thread_Running;
+/* orders the packet contents against the ring buffer head and tail */
+static pthread_mutex_t Capture_Mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void capture_queue_lock(void)
+{
+#if !defined(_WIN32)
+    pthread_mutex_lock(&Capture_Mutex);
+#endif
+}
+
+static void capture_queue_unlock(void)
+{
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&Capture_Mutex);
+#endif
+}
+
 static void filename_create(char *filename)
 {
+    static char last_name[32];
+    static unsigned sequence;
+    const char *extension = Capture_PCAPNG ? "pcapng" : "cap";
+    char name[32];
     BACNET_DATE bdate;
     BACNET_TIME btime;
 
     if (filename) {
         datetime_local(&bdate, &btime, NULL, NULL);
-        sprintf(filename, "mstp_%04d%02d%02d%02d%02d%02d.cap", (int)bdate.year,
+        sprintf(name, "mstp_%04d%02d%02d%02d%02d%02d", (int)bdate.year,
             (int)bdate.month, (int)bdate.day, (int)btime.hour, (int)btime.min,
             (int)btime.sec);
+        if (strcmp(name, last_name) == 0) {
+            /* rotated more than once in the same second */
+            sequence++;
+            sprintf(filename, "%s_%u.%s", name, sequence, extension);
+        } else {
+            sequence = 0;
+            strcpy(last_name, name);
+            sprintf(filename, "%s.%s", name, extension);
+        }
     }
 }
 
+static size_t encode_u16(uint8_t *buffer, uint16_t value)
+{
+    memcpy(buffer, &value, sizeof(value));
+
+    return sizeof(value);
+}
+
+static size_t encode_u32(uint8_t *buffer, uint32_t value)
+{
+    memcpy(buffer, &value, sizeof(value));
+
+    return sizeof(value);
+}
+
+/* pcapng section header and interface description blocks */
+static size_t pcapng_header_encode(uint8_t *buffer)
+{
+    size_t len = 0;
+
+    /* section header block */
+    len += encode_u32(&buffer[len], 0x0A0D0D0A);
+    len += encode_u32(&buffer[len], 28);
+    len += encode_u32(&buffer[len], 0x1A2B3C4D);
+    len += encode_u16(&buffer[len], 1);
+    len += encode_u16(&buffer[len], 0);
+    /* section length is not specified */
+    len += encode_u32(&buffer[len], 0xFFFFFFFF);
+    len += encode_u32(&buffer[len], 0xFFFFFFFF);
+    len += encode_u32(&buffer[len], 28);
+    /* interface description block */
+    len += encode_u32(&buffer[len], 1);
+    len += encode_u32(&buffer[len], 32);
+    len += encode_u16(&buffer[len], DLT_BACNET_MS_TP);
+    len += encode_u16(&buffer[len], 0);
+    len += encode_u32(&buffer[len], 65535);
+    /* if_tsresol: nanoseconds */
+    len += encode_u16(&buffer[len], 9);
+    len += encode_u16(&buffer[len], 1);
+    buffer[len++] = 9;
+    buffer[len++] = 0;
+    buffer[len++] = 0;
+    buffer[len++] = 0;
+    /* opt_endofopt */
+    len += encode_u32(&buffer[len], 0);
+    len += encode_u32(&buffer[len], 32);
+
+    return len;
+}
+
 /* write packet to file in libpcap format */
 static void write_global_header(const char *filename)
 {
@@ -557,20 +676,28 @@ static void write_global_header(const char *filename)
     uint32_t sigfigs = 0; /* accuracy of timestamps */
     uint32_t snaplen = 65535; /* max length of captured packets, in octets */
     uint32_t network = DLT_BACNET_MS_TP; /* data link type - BACNET_MS_TP */
+    uint8_t header[64];
+    size_t header_len;
 
     /* create a new file. */
     pFile = fopen(filename, "wb");
     if (pFile) {
-        (void)data_write_header(
-            &magic_number, sizeof(magic_number), 1, pipe_enable);
-        (void)data_write_header(
-            &version_major, sizeof(version_major), 1, pipe_enable);
-        (void)data_write_header(
-            &version_minor, sizeof(version_minor), 1, pipe_enable);
-        (void)data_write_header(&thiszone, sizeof(thiszone), 1, pipe_enable);
-        (void)data_write_header(&sigfigs, sizeof(sigfigs), 1, pipe_enable);
-        (void)data_write_header(&snaplen, sizeof(snaplen), 1, pipe_enable);
-        (void)data_write_header(&network, sizeof(network), 1, pipe_enable);
+        if (Capture_PCAPNG) {
+            header_len = pcapng_header_encode(header);
+            (void)data_write_header(header, header_len, 1, pipe_enable);
+        } else {
+            (void)data_write_header(
+                &magic_number, sizeof(magic_number), 1, pipe_enable);
+            (void)data_write_header(
+                &version_major, sizeof(version_major), 1, pipe_enable);
+            (void)data_write_header(
+                &version_minor, sizeof(version_minor), 1, pipe_enable);
+            (void)data_write_header(
+                &thiszone, sizeof(thiszone), 1, pipe_enable);
+            (void)data_write_header(&sigfigs, sizeof(sigfigs), 1, pipe_enable);
+            (void)data_write_header(&snaplen, sizeof(snaplen), 1, pipe_enable);
+            (void)data_write_header(&network, sizeof(network), 1, pipe_enable);
+        }
         fflush(pFile);
         if (!Wireshark_Capture) {
             fprintf(stdout, "mstpcap: saving capture to %s\n", filename);
@@ -584,78 +711,302 @@ static void write_global_header(const char *filename)
     }
 }
 
+/**
+ * @brief Encode a queued packet as a pcap record, or as a pcapng enhanced
+ *  packet block with a comment for invalid frames and dropped packets.
+ * @param pkt - queued packet
+ * @param buffer - where the record is encoded
+ * @return number of octets encoded
+ */
+static size_t capture_packet_encode(
+    struct mstp_capture_packet *pkt, uint8_t *buffer)
+{
+    char comment[80] = "";
+    uint64_t timestamp;
+    size_t comment_len = 0;
+    size_t options_len = 0;
+    size_t data_len;
+    size_t block_len;
+    size_t len = 0;
+
+    if (!Capture_PCAPNG) {
+        len += encode_u32(&buffer[len], pkt->ts_sec);
+        len += encode_u32(&buffer[len], pkt->ts_nsec / 1000);
+        len += encode_u32(&buffer[len], pkt->length);
+        len += encode_u32(&buffer[len], pkt->length);
+        memcpy(&buffer[len], pkt->data, pkt->length);
+        len += pkt->length;
+
+        return len;
+    }
+    if (pkt->invalid && pkt->dropped) {
+        sprintf(comment, "invalid frame, %lu packets dropped before it",
+            (unsigned long)pkt->dropped);
+    } else if (pkt->invalid) {
+        sprintf(comment, "invalid frame");
+    } else if (pkt->dropped) {
+        sprintf(comment, "%lu packets dropped before this packet",
+            (unsigned long)pkt->dropped);
+    }
+    comment_len = strlen(comment);
+    if (comment_len) {
+        /* opt_comment, and opt_endofopt */
+        options_len = 4 + ((comment_len + 3) & ~3U) + 4;
+    }
+    data_len = (pkt->length + 3) & ~3U;
+    block_len = 32 + data_len + options_len;
+    timestamp = ((uint64_t)pkt->ts_sec * 1000000000ULL) + pkt->ts_nsec;
+    len += encode_u32(&buffer[len], 6);
+    len += encode_u32(&buffer[len], (uint32_t)block_len);
+    len += encode_u32(&buffer[len], 0);
+    len += encode_u32(&buffer[len], (uint32_t)(timestamp >> 32));
+    len += encode_u32(&buffer[len], (uint32_t)timestamp);
+    len += encode_u32(&buffer[len], pkt->length);
+    len += encode_u32(&buffer[len], pkt->length);
+    memset(&buffer[len], 0, data_len);
+    memcpy(&buffer[len], pkt->data, pkt->length);
+    len += data_len;
+    if (comment_len) {
+        len += encode_u16(&buffer[len], 1);
+        len += encode_u16(&buffer[len], (uint16_t)comment_len);
+        memset(&buffer[len], 0, (comment_len + 3) & ~3U);
+        memcpy(&buffer[len], comment, comment_len);
+        len += (comment_len + 3) & ~3U;
+        len += encode_u32(&buffer[len], 0);
+    }
+    len += encode_u32(&buffer[len], (uint32_t)block_len);
+
+    return len;
+}
+
+static void capture_flush(void)
+{
+    if (Write_Length && pFile) {
+        (void)data_write(Write_Buffer, Write_Length, 1);
+        fflush(pFile);
+    }
+    Write_Length = 0;
+}
+
+static void filename_create_new(void)
+{
+    capture_flush();
+    if (pFile) {
+        fclose(pFile);
+    }
+    pFile = NULL;
+    filename_create(&Capture_Filename[0]);
+    write_global_header(&Capture_Filename[0]);
+    File_Packets = 0;
+    File_Octets = 0;
+    File_Start = time(NULL);
+}
+
+static bool capture_rotate_needed(void)
+{
+    if (Wireshark_Capture) {
+        /* the pipe only has one global header */
+        return false;
+    }
+    if (Rotate_Packets && (File_Packets >= Rotate_Packets)) {
+        return true;
+    }
+    if (Rotate_Octets && (File_Octets >= Rotate_Octets)) {
+        return true;
+    }
+    if (Rotate_Seconds &&
+        ((uint32_t)(time(NULL) - File_Start) >= Rotate_Seconds)) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Save the queued packets using large writes.  A new capture file
+ *  is started between two packets, so no packets are lost on rotation.
+ * @return number of packets saved
+ */
+static unsigned capture_write_task(void)
+{
+    struct mstp_capture_packet *pkt;
+    unsigned count = 0;
+    size_t len;
+
+    for (;;) {
+        capture_queue_lock();
+        pkt = (struct mstp_capture_packet *)Ringbuf_Peek(&Capture_Queue);
+        capture_queue_unlock();
+        if (!pkt) {
+            break;
+        }
+        if (capture_rotate_needed()) {
+            filename_create_new();
+        }
+        if ((Write_Length + sizeof(pkt->data) + MSTP_CAPTURE_RECORD_OVERHEAD) >
+            sizeof(Write_Buffer)) {
+            capture_flush();
+        }
+        len = capture_packet_encode(pkt, &Write_Buffer[Write_Length]);
+        Write_Length += len;
+        File_Packets++;
+        File_Octets += len;
+        capture_queue_lock();
+        (void)Ringbuf_Pop(&Capture_Queue, NULL);
+        capture_queue_unlock();
+        count++;
+    }
+    capture_flush();
+
+    return count;
+}
+
+#if !defined(_WIN32)
+static void *capture_write_thread(void *pArg)
+{
+    (void)pArg;
+    while (Capture_Thread_Running) {
+        if (capture_write_task() == 0) {
+            usleep(10000);
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+static void capture_start(void)
+{
+    Ringbuf_Init(&Capture_Queue, (volatile uint8_t *)&Capture_Buffer[0],
+        sizeof(Capture_Buffer[0]), MSTP_CAPTURE_PACKET_COUNT);
+    filename_create_new();
+    Capture_Started = true;
+#if !defined(_WIN32)
+    Capture_Thread_Running = true;
+    if (pthread_create(&Capture_Thread, NULL, capture_write_thread, NULL) ==
+        0) {
+        Capture_Threaded = true;
+    } else {
+        Capture_Thread_Running = false;
+    }
+#endif
+}
+
+static void capture_stop(void)
+{
+    if (!Capture_Started) {
+        return;
+    }
+#if !defined(_WIN32)
+    if (Capture_Threaded) {
+        Capture_Thread_Running = false;
+        if (!pthread_equal(pthread_self(), Capture_Thread)) {
+            pthread_join(Capture_Thread, NULL);
+        }
+        Capture_Threaded = false;
+    }
+#endif
+    (void)capture_write_task();
+}
+
 static void write_received_packet(
     volatile struct mstp_port_struct_t *mstp_port, size_t header_len)
 {
-    uint32_t ts_sec = 0; /* timestamp seconds */
-    uint32_t ts_usec = 0; /* timestamp microseconds */
     uint32_t incl_len = 0; /* number of octets of packet saved in file */
-    uint32_t orig_len = 0; /* actual length of packet */
     uint32_t data_crc_len = 2;
-    uint8_t header[MSTP_HEADER_MAX] = { 0 }; /* MS/TP header */
+    uint8_t *header; /* MS/TP header */
+    struct mstp_capture_packet *pkt;
     struct timeval tv;
     size_t max_data = 0;
+#if !defined(_WIN32)
+    struct timespec ts;
 
-    if (pFile) {
-        gettimeofday(&tv, NULL);
-        ts_sec = tv.tv_sec;
-        ts_usec = tv.tv_usec;
-        if ((mstp_port->ReceivedValidFrame) ||
-            (mstp_port->ReceivedValidFrameNotForUs)) {
-            packet_statistics(&tv, mstp_port);
-        }
-        (void)data_write(&ts_sec, sizeof(ts_sec), 1);
-        (void)data_write(&ts_usec, sizeof(ts_usec), 1);
-        if (mstp_port->ReceivedInvalidFrame) {
-            if (mstp_port->Index) {
-                max_data = min(mstp_port->InputBufferSize, mstp_port->Index);
-                if ((mstp_port->DataLength > 0) &&
-                    (mstp_port->Index == (mstp_port->DataLength + 1))) {
-                    /* case where index is not incremented for CRC2,
-                        so only 1 for checksum */
-                    data_crc_len = 1;
-                }
-                incl_len = orig_len = header_len + max_data + data_crc_len;
-            } else {
-                /* header only */
-                incl_len = orig_len = header_len;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    tv.tv_sec = ts.tv_sec;
+    tv.tv_usec = ts.tv_nsec / 1000;
+#else
+    gettimeofday(&tv, NULL);
+#endif
+    if ((mstp_port->ReceivedValidFrame) ||
+        (mstp_port->ReceivedValidFrameNotForUs)) {
+        packet_statistics(&tv, mstp_port);
+    }
+    capture_queue_lock();
+    pkt = (struct mstp_capture_packet *)Ringbuf_Data_Peek(&Capture_Queue);
+    capture_queue_unlock();
+    if (!pkt) {
+        /* the writer is not keeping up */
+        Capture_Dropped++;
+        Capture_Dropped_Pending++;
+        return;
+    }
+    pkt->ts_sec = tv.tv_sec;
+#if !defined(_WIN32)
+    pkt->ts_nsec = ts.tv_nsec;
+#else
+    pkt->ts_nsec = tv.tv_usec * 1000;
+#endif
+    if (mstp_port->ReceivedInvalidFrame) {
+        if (mstp_port->Index) {
+            max_data = min(mstp_port->InputBufferSize, mstp_port->Index);
+            if ((mstp_port->DataLength > 0) &&
+                (mstp_port->Index == (mstp_port->DataLength + 1))) {
+                /* case where index is not incremented for CRC2,
+                    so only 1 for checksum */
+                data_crc_len = 1;
             }
+            incl_len = header_len + max_data + data_crc_len;
         } else {
-            if (mstp_port->DataLength) {
-                max_data =
-                    min(mstp_port->InputBufferSize, mstp_port->DataLength);
-                incl_len = orig_len = header_len + max_data + data_crc_len;
-            } else {
-                /* header only - or at least some bytes of the header */
-                incl_len = orig_len = header_len;
-            }
+            /* header only */
+            incl_len = header_len;
         }
-        (void)data_write(&incl_len, sizeof(incl_len), 1);
-        (void)data_write(&orig_len, sizeof(orig_len), 1);
-        if (header_len == 1) {
-            header[0] = mstp_port->DataRegister;
-        } else if (header_len == 2) {
-            header[0] = 0x55;
-            header[1] = mstp_port->DataRegister;
+    } else {
+        if (mstp_port->DataLength) {
+            max_data = min(mstp_port->InputBufferSize, mstp_port->DataLength);
+            incl_len = header_len + max_data + data_crc_len;
         } else {
-            header[0] = 0x55;
-            header[1] = 0xFF;
-            header[2] = mstp_port->FrameType;
-            header[3] = mstp_port->DestinationAddress;
-            header[4] = mstp_port->SourceAddress;
-            header[5] = HI_BYTE(mstp_port->DataLength);
-            header[6] = LO_BYTE(mstp_port->DataLength);
-            header[7] = mstp_port->HeaderCRCActual;
-        }
-        (void)data_write(header, header_len, 1);
-        if (max_data) {
-            (void)data_write(mstp_port->InputBuffer, max_data, 1);
-            (void)data_write((char *)&mstp_port->DataCRCActualMSB, 1, 1);
-            (void)data_write((char *)&mstp_port->DataCRCActualLSB, 1, 1);
+            /* header only - or at least some bytes of the header */
+            incl_len = header_len;
         }
+    }
+    header = &pkt->data[0];
+    memset(header, 0, MSTP_HEADER_MAX);
+    if (header_len == 1) {
+        header[0] = mstp_port->DataRegister;
+    } else if (header_len == 2) {
+        header[0] = 0x55;
+        header[1] = mstp_port->DataRegister;
     } else {
-        fprintf(stderr, "mstpcap[packet]: failed to open %s: %s\n",
-            Capture_Filename, strerror(errno));
+        header[0] = 0x55;
+        header[1] = 0xFF;
+        header[2] = mstp_port->FrameType;
+        header[3] = mstp_port->DestinationAddress;
+        header[4] = mstp_port->SourceAddress;
+        header[5] = HI_BYTE(mstp_port->DataLength);
+        header[6] = LO_BYTE(mstp_port->DataLength);
+        header[7] = mstp_port->HeaderCRCActual;
+    }
+    if (max_data) {
+        memcpy(&pkt->data[header_len], (void *)mstp_port->InputBuffer,
+            max_data);
+        pkt->data[header_len + max_data] = mstp_port->DataCRCActualMSB;
+        if (data_crc_len > 1) {
+            pkt->data[header_len + max_data + 1] =
+                mstp_port->DataCRCActualLSB;
+        }
+    }
+    pkt->length = (uint16_t)incl_len;
+    pkt->invalid = mstp_port->ReceivedInvalidFrame ||
+        (header_len < MSTP_HEADER_MAX);
+    pkt->dropped = Capture_Dropped_Pending;
+    /* the packet is complete before the writer can see it */
+    capture_queue_lock();
+    if (Ringbuf_Data_Put(&Capture_Queue, (volatile uint8_t *)pkt)) {
+        Capture_Dropped_Pending = 0;
+    }
+    capture_queue_unlock();
+    if (!Capture_Threaded) {
+        (void)capture_write_task();
     }
 }
 
@@ -855,14 +1206,25 @@ static bool read_received_packet(volatile struct mstp_port_struct_t *mstp_port)
 
 static void cleanup(void)
 {
+    capture_stop();
     if (!Wireshark_Capture) {
         packet_statistics_print();
+        if (Capture_Dropped) {
+            fprintf(stdout, "mstpcap: %lu packets dropped\n",
+                (unsigned long)Capture_Dropped);
+        }
     }
     if (pFile) {
         fflush(pFile); /* stream pointer */
         fclose(pFile); /* stream pointer */
     }
     pFile = NULL;
+#if !defined(_WIN32)
+    if (FD_Pipe != -1) {
+        close(FD_Pipe);
+        FD_Pipe = -1;
+    }
+#endif
 }
 
 #if defined(_WIN32)
@@ -889,11 +1251,9 @@ static BOOL WINAPI CtrlCHandler(DWORD dwCtrlType)
 static void sig_int(int signo)
 {
     (void)signo;
-    if (FD_Pipe != -1) {
-        close(FD_Pipe);
-    }
+    /* only async-signal-safe work here: the main loop exits,
+       and cleanup() runs from atexit() */
     Exit_Requested = true;
-    exit(0);
 }
 
 static void signal_init(void)
@@ -904,16 +1264,6 @@ static void signal_init(void)
 }
 #endif
 
-static void filename_create_new(void)
-{
-    if (pFile) {
-        fclose(pFile);
-    }
-    pFile = NULL;
-    filename_create(&Capture_Filename[0]);
-    write_global_header(&Capture_Filename[0]);
-}
-
 static void print_usage(char *filename)
 {
     printf("Usage: %s", filename);
@@ -921,6 +1271,8 @@ static void print_usage(char *filename)
     printf(" [--extcap-interface port]\n");
     printf(" [--extcap-interfaces][--extcap-dlts][--extcap-config]\n");
     printf(" [--capture][--baud baud][--fifo pipe]\n");
+    printf(" [--pcapng][--rotate-packets count]\n");
+    printf(" [--rotate-size kilobytes][--rotate-time seconds]\n");
     printf(" [--version][--help]\n");
 }
 
@@ -933,7 +1285,9 @@ static void print_help(char *filename)
     printf("Captures MS/TP packets from a serial interface\n"
            "and saves them to a file. Saves packets in a\n"
            "filename mstp_20090123091200.cap that has data and time.\n"
-           "After receiving 65535 packets, a new file is created.\n");
+           "After receiving 65535 packets, a new file is created.\n"
+           "Packets are queued and saved by a writer thread, and\n"
+           "packets dropped when the queue is full are counted.\n");
     printf("\n");
     printf("Command line options:\n"
            "[--extcap-interface port] - serial interface.\n"
@@ -952,6 +1306,15 @@ static void print_help(char *filename)
            "    Supported values: any file name\n"
 #endif
            "    Use that name as the interface name in Wireshark.\n");
+    printf("[--pcapng] - save in pcapng format with nanosecond\n"
+           "    timestamps, and comments on invalid frames and\n"
+           "    dropped packets.\n"
+           "[--rotate-packets count] - start a new file after this\n"
+           "    many packets. Defaults to 65535. 0 disables.\n"
+           "[--rotate-size kilobytes] - start a new file after this\n"
+           "    many kilobytes. Defaults to 0, disabled.\n"
+           "[--rotate-time seconds] - start a new file after this\n"
+           "    many seconds. Defaults to 0, disabled.\n");
     printf("\n");
     printf("%s [--extcap-interfaces][--extcap-dlts][--extcap-config]\n"
            "[--capture][--baud baud][--fifo pipe]\n"
@@ -1122,6 +1485,33 @@ int main(int argc, char *argv[])
             }
             named_pipe_create(argv[argi]);
         }
+        if (strcmp(argv[argi], "--pcapng") == 0) {
+            Capture_PCAPNG = true;
+        }
+        if (strcmp(argv[argi], "--rotate-packets") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A packet count must be provided.\n");
+                return 0;
+            }
+            Rotate_Packets = strtoul(argv[argi], NULL, 0);
+        }
+        if (strcmp(argv[argi], "--rotate-size") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A size in kilobytes must be provided.\n");
+                return 0;
+            }
+            Rotate_Octets = strtoul(argv[argi], NULL, 0) * 1024UL;
+        }
+        if (strcmp(argv[argi], "--rotate-time") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A time in seconds must be provided.\n");
+                return 0;
+            }
+            Rotate_Seconds = strtoul(argv[argi], NULL, 0);
+        }
     }
     if (Exit_Requested) {
         return 0;
@@ -1143,7 +1533,7 @@ int main(int argc, char *argv[])
 #else
     signal_init();
 #endif
-    filename_create_new();
+    capture_start();
     /* run forever */
     for (;;) {
         RS485_Check_UART_Data(mstp_port);
@@ -1194,13 +1584,14 @@ int main(int argc, char *argv[])
         }
         if (!Wireshark_Capture) {
             if (!(packet_count % 100)) {
-                fprintf(stdout, "\r%u packets, %u invalid frames",
-                    (unsigned)packet_count, (unsigned)Invalid_Frame_Count);
+                fprintf(stdout, "\r%u packets, %u invalid frames, %u dropped",
+                    (unsigned)packet_count, (unsigned)Invalid_Frame_Count,
+                    (unsigned)Capture_Dropped);
             }
             if (packet_count >= 65535) {
+                /* the writer starts a new file between packets */
                 packet_statistics_print();
                 packet_statistics_clear();
-                filename_create_new();
                 packet_count = 0;
             }
         }
@@ -0,0 +1,666 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Deterministic MS/TP network simulator and benchmark
+ *
+ * @section DESCRIPTION
+ *
+ * Runs the MS/TP receive and master node state machines of up to 127
+ * nodes against a virtual RS-485 bus using simulated time, so that
+ * token rotation time, poll-for-master overhead, throughput, and frame
+ * errors can be measured for a given baud rate, Max_Master, and
+ * Max_Info_Frames without any hardware.  The same seed always gives
+ * the same results.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/version.h"
+#include "bacnet/datalink/mstp.h"
+#include "bacnet/datalink/dlmstp.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "bacnet/basic/sys/filename.h"
+#include "rs485.h"
+
+/* number of simulated master nodes, MAC 0..N-1 */
+#ifndef MSTPSIM_NODES_MAX
+#define MSTPSIM_NODES_MAX 127
+#endif
+/* octets on the wire not yet read by every node - power of 2 */
+#define MSTPSIM_BUS_SIZE 8192
+/* PDUs waiting in each node for the token */
+#define MSTPSIM_QUEUE_MAX 16
+/* size of the reply to a data-expecting-reply frame */
+#define MSTPSIM_REPLY_SIZE 16
+
+struct mstpsim_octet {
+    uint64_t time_ns;
+    uint8_t data;
+    uint8_t sender;
+    bool error;
+};
+
+struct mstpsim_node {
+    volatile struct mstp_port_struct_t port;
+    uint8_t rx_buffer[DLMSTP_MPDU_MAX];
+    uint8_t tx_buffer[DLMSTP_MPDU_MAX];
+    uint8_t index;
+    /* silence is measured from here, which may be in the future
+       while this node is still transmitting */
+    uint64_t silence_start_ns;
+    /* next octet on the bus to be read by this node */
+    uint32_t bus_index;
+    /* offered load */
+    uint64_t next_pdu_ns;
+    unsigned pdu_queue;
+    bool reply_pending;
+    uint8_t reply_destination;
+    /* token rotation */
+    bool token_seen;
+    uint64_t token_time_ns;
+    uint64_t token_rotation_total_ns;
+    uint64_t token_rotation_max_ns;
+    uint32_t token_count;
+    /* statistics */
+    uint32_t pdu_offered;
+    uint32_t pdu_dropped;
+    uint32_t pdu_sent;
+    uint32_t pdu_received;
+    uint32_t octets_received;
+    uint32_t invalid_frames;
+    uint32_t lost_tokens;
+    MSTP_MASTER_STATE last_state;
+};
+
+struct mstpsim_config {
+    unsigned nodes;
+    uint32_t baud;
+    uint8_t max_master;
+    uint8_t max_info_frames;
+    unsigned turnaround_bits;
+    double bit_error_rate;
+    double load;
+    unsigned pdu_size;
+    bool confirmed;
+    unsigned duration;
+    unsigned warmup;
+    uint32_t seed;
+};
+
+static struct mstpsim_config Config = { 32, 38400, 127, 1, 40, 0.0, 0.0,
+    128, false, 60, 10, 1 };
+static struct mstpsim_node Nodes[MSTPSIM_NODES_MAX];
+static struct mstpsim_octet Bus[MSTPSIM_BUS_SIZE];
+static uint32_t Bus_Head;
+static uint64_t Bus_Free_Time_ns;
+static uint8_t Bus_Last_Sender = MSTP_BROADCAST_ADDRESS;
+static uint64_t Sim_Time_ns;
+static uint64_t Octet_Time_ns;
+static uint32_t Random_State;
+
+/* bus statistics */
+static uint32_t Frame_Count[256];
+static uint64_t Frame_Octets[256];
+static uint64_t Bus_Busy_ns;
+static uint32_t Collisions;
+static uint32_t Octet_Errors;
+
+/**
+ * @brief Deterministic pseudo random number (xorshift32)
+ * @return next number in the sequence
+ */
+static uint32_t mstpsim_random(void)
+{
+    uint32_t x = Random_State;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    Random_State = x;
+
+    return x;
+}
+
+/**
+ * @brief Determine if an octet is corrupted by the configured bit errors
+ * @return true if the octet is received with an error
+ */
+static bool mstpsim_octet_error(void)
+{
+    double octet_error_rate;
+
+    if (Config.bit_error_rate <= 0.0) {
+        return false;
+    }
+    /* start, 8 data, and stop bits */
+    octet_error_rate = 10.0 * Config.bit_error_rate;
+
+    return ((double)mstpsim_random() / (double)UINT32_MAX) < octet_error_rate;
+}
+
+static uint32_t Timer_Silence(void *pArg)
+{
+    struct mstp_port_struct_t *mstp_port = pArg;
+    struct mstpsim_node *node;
+
+    if (!mstp_port) {
+        return 0;
+    }
+    node = mstp_port->UserData;
+    if (Sim_Time_ns <= node->silence_start_ns) {
+        return 0;
+    }
+
+    return (uint32_t)((Sim_Time_ns - node->silence_start_ns) / 1000000UL);
+}
+
+static void Timer_Silence_Reset(void *pArg)
+{
+    struct mstp_port_struct_t *mstp_port = pArg;
+    struct mstpsim_node *node;
+
+    if (!mstp_port) {
+        return;
+    }
+    node = mstp_port->UserData;
+    if (Sim_Time_ns > node->silence_start_ns) {
+        node->silence_start_ns = Sim_Time_ns;
+    }
+}
+
+/**
+ * @brief Put a frame onto the virtual bus.  A node that starts to send
+ *  while another node is still sending causes a collision, which is
+ *  seen by the receivers as errors in both frames.
+ */
+void RS485_Send_Frame(volatile struct mstp_port_struct_t *mstp_port,
+    uint8_t *buffer,
+    uint16_t nbytes)
+{
+    struct mstpsim_node *node = mstp_port->UserData;
+    uint64_t start_ns = Sim_Time_ns;
+    uint64_t turnaround_ns = Config.turnaround_bits * Octet_Time_ns / 10;
+    bool collision = false;
+    uint32_t i;
+
+    if (!buffer || (nbytes == 0)) {
+        return;
+    }
+    if (Bus_Last_Sender != node->index) {
+        if (Bus_Free_Time_ns > Sim_Time_ns) {
+            collision = true;
+            Collisions++;
+            for (i = Bus_Head - 1; (i != Bus_Head - MSTPSIM_BUS_SIZE) &&
+                 (Bus[i % MSTPSIM_BUS_SIZE].time_ns > Sim_Time_ns);
+                 i--) {
+                Bus[i % MSTPSIM_BUS_SIZE].error = true;
+            }
+            start_ns = Bus_Free_Time_ns;
+        } else if ((Bus_Free_Time_ns + turnaround_ns) > start_ns) {
+            /* Tturnaround after the last octet from another node */
+            start_ns = Bus_Free_Time_ns + turnaround_ns;
+        }
+    } else if (Bus_Free_Time_ns > start_ns) {
+        /* this node is still sending a previous frame */
+        start_ns = Bus_Free_Time_ns;
+    }
+    for (i = 0; i < nbytes; i++) {
+        struct mstpsim_octet *octet = &Bus[Bus_Head % MSTPSIM_BUS_SIZE];
+
+        octet->time_ns = start_ns + ((i + 1) * Octet_Time_ns);
+        octet->data = buffer[i];
+        octet->sender = node->index;
+        octet->error = collision || mstpsim_octet_error();
+        if (octet->error) {
+            Octet_Errors++;
+        }
+        Bus_Head++;
+    }
+    Bus_Free_Time_ns = start_ns + (nbytes * Octet_Time_ns);
+    Bus_Last_Sender = node->index;
+    Bus_Busy_ns += nbytes * Octet_Time_ns;
+    node->silence_start_ns = Bus_Free_Time_ns;
+    if (nbytes > 2) {
+        Frame_Count[buffer[2]]++;
+        Frame_Octets[buffer[2]] += nbytes;
+    }
+}
+
+/* for the MS/TP state machine to use for putting received data */
+uint16_t MSTP_Put_Receive(volatile struct mstp_port_struct_t *mstp_port)
+{
+    struct mstpsim_node *node = mstp_port->UserData;
+
+    node->pdu_received++;
+    node->octets_received += mstp_port->DataLength;
+    if (mstp_port->FrameType == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) {
+        node->reply_pending = true;
+        node->reply_destination = mstp_port->SourceAddress;
+    }
+
+    return mstp_port->DataLength;
+}
+
+/**
+ * @brief Build an information frame with a minimal NPDU header
+ * @return number of octets in the frame
+ */
+static uint16_t mstpsim_frame(volatile struct mstp_port_struct_t *mstp_port,
+    uint8_t frame_type,
+    uint8_t destination,
+    uint16_t pdu_len)
+{
+    uint8_t pdu[DLMSTP_MPDU_MAX] = { 0 };
+
+    if (pdu_len > MAX_PDU) {
+        pdu_len = MAX_PDU;
+    }
+    if (pdu_len < 2) {
+        pdu_len = 2;
+    }
+    pdu[0] = BACNET_PROTOCOL_VERSION;
+    if (frame_type == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) {
+        pdu[1] = 0x04;
+    }
+
+    return MSTP_Create_Frame(&mstp_port->OutputBuffer[0],
+        mstp_port->OutputBufferSize, frame_type, destination,
+        mstp_port->This_Station, pdu, pdu_len);
+}
+
+/* for the MS/TP state machine to use for getting data to send */
+uint16_t MSTP_Get_Send(
+    volatile struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    struct mstpsim_node *node = mstp_port->UserData;
+    uint64_t rotation_ns;
+    uint8_t destination;
+    uint8_t frame_type;
+
+    (void)timeout;
+    if (mstp_port->FrameCount == 0) {
+        /* USE_TOKEN is entered with FrameCount of zero on each token */
+        if (node->token_seen) {
+            rotation_ns = Sim_Time_ns - node->token_time_ns;
+            node->token_rotation_total_ns += rotation_ns;
+            if (rotation_ns > node->token_rotation_max_ns) {
+                node->token_rotation_max_ns = rotation_ns;
+            }
+            node->token_count++;
+        }
+        node->token_seen = true;
+        node->token_time_ns = Sim_Time_ns;
+    }
+    if ((node->pdu_queue == 0) || (Config.nodes < 2)) {
+        return 0;
+    }
+    node->pdu_queue--;
+    node->pdu_sent++;
+    destination = mstpsim_random() % (Config.nodes - 1);
+    if (destination >= node->index) {
+        destination++;
+    }
+    if (Config.confirmed) {
+        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
+    } else {
+        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
+    }
+
+    return mstpsim_frame(mstp_port, frame_type, destination, Config.pdu_size);
+}
+
+/* for the MS/TP state machine to use for getting the reply for
+   Data-Expecting-Reply Frame */
+uint16_t MSTP_Get_Reply(
+    volatile struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    struct mstpsim_node *node = mstp_port->UserData;
+
+    (void)timeout;
+    if (!node->reply_pending) {
+        return 0;
+    }
+    node->reply_pending = false;
+
+    return mstpsim_frame(mstp_port, FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        node->reply_destination, MSTPSIM_REPLY_SIZE);
+}
+
+static void mstpsim_master(struct mstpsim_node *node)
+{
+    volatile struct mstp_port_struct_t *mstp_port = &node->port;
+
+    if (mstp_port->ReceivedInvalidFrame) {
+        node->invalid_frames++;
+    }
+    while (MSTP_Master_Node_FSM(mstp_port)) {
+        /* do nothing while immediate transitioning */
+    }
+    if ((mstp_port->master_state == MSTP_MASTER_STATE_NO_TOKEN) &&
+        (node->last_state != MSTP_MASTER_STATE_NO_TOKEN)) {
+        node->lost_tokens++;
+    }
+    node->last_state = mstp_port->master_state;
+}
+
+/**
+ * @brief Run one node for the current simulated time: deliver the
+ *  octets that arrived, and run the state machines.
+ */
+static void mstpsim_node_task(struct mstpsim_node *node)
+{
+    volatile struct mstp_port_struct_t *mstp_port = &node->port;
+    struct mstpsim_octet *octet;
+    bool received = false;
+
+    while (node->bus_index != Bus_Head) {
+        octet = &Bus[node->bus_index % MSTPSIM_BUS_SIZE];
+        if (octet->time_ns > Sim_Time_ns) {
+            break;
+        }
+        node->bus_index++;
+        if (octet->sender == node->index) {
+            continue;
+        }
+        if (mstp_port->ReceivedValidFrame || mstp_port->ReceivedInvalidFrame) {
+            mstpsim_master(node);
+        }
+        if (octet->error) {
+            mstp_port->ReceiveError = true;
+        } else {
+            mstp_port->DataRegister = octet->data;
+            mstp_port->DataAvailable = true;
+        }
+        MSTP_Receive_Frame_FSM(mstp_port);
+        received = true;
+    }
+    if (!received && !mstp_port->ReceivedValidFrame &&
+        !mstp_port->ReceivedInvalidFrame) {
+        /* frame abort timeouts */
+        MSTP_Receive_Frame_FSM(mstp_port);
+    }
+    mstpsim_master(node);
+}
+
+static void mstpsim_offered_load(struct mstpsim_node *node)
+{
+    uint64_t interval_ns;
+
+    if (Config.load <= 0.0) {
+        return;
+    }
+    interval_ns = (uint64_t)(1000000000.0 / Config.load);
+    while (Sim_Time_ns >= node->next_pdu_ns) {
+        node->pdu_offered++;
+        if (node->pdu_queue < MSTPSIM_QUEUE_MAX) {
+            node->pdu_queue++;
+        } else {
+            node->pdu_dropped++;
+        }
+        node->next_pdu_ns += interval_ns;
+    }
+}
+
+static void mstpsim_init(void)
+{
+    struct mstpsim_node *node;
+    unsigned i;
+
+    Random_State = Config.seed ? Config.seed : 1;
+    /* start, 8 data, and stop bits */
+    Octet_Time_ns = (10ULL * 1000000000ULL) / Config.baud;
+    for (i = 0; i < Config.nodes; i++) {
+        node = &Nodes[i];
+        memset(node, 0, sizeof(*node));
+        node->index = (uint8_t)i;
+        node->port.InputBuffer = &node->rx_buffer[0];
+        node->port.InputBufferSize = sizeof(node->rx_buffer);
+        node->port.OutputBuffer = &node->tx_buffer[0];
+        node->port.OutputBufferSize = sizeof(node->tx_buffer);
+        node->port.This_Station = (uint8_t)i;
+        node->port.Nmax_info_frames = Config.max_info_frames;
+        node->port.Nmax_master = Config.max_master;
+        node->port.SilenceTimer = Timer_Silence;
+        node->port.SilenceTimerReset = Timer_Silence_Reset;
+        node->port.UserData = node;
+        MSTP_Init(&node->port);
+        /* spread the offered load of the nodes */
+        if (Config.load > 0.0) {
+            node->next_pdu_ns = (uint64_t)(1000000000.0 / Config.load) *
+                i / Config.nodes;
+        }
+        node->last_state = node->port.master_state;
+    }
+}
+
+static void mstpsim_statistics_clear(void)
+{
+    struct mstpsim_node *node;
+    unsigned i;
+
+    for (i = 0; i < Config.nodes; i++) {
+        node = &Nodes[i];
+        node->token_rotation_total_ns = 0;
+        node->token_rotation_max_ns = 0;
+        node->token_count = 0;
+        node->pdu_offered = 0;
+        node->pdu_dropped = 0;
+        node->pdu_sent = 0;
+        node->pdu_received = 0;
+        node->octets_received = 0;
+        node->invalid_frames = 0;
+        node->lost_tokens = 0;
+    }
+    memset(Frame_Count, 0, sizeof(Frame_Count));
+    memset(Frame_Octets, 0, sizeof(Frame_Octets));
+    Bus_Busy_ns = 0;
+    Collisions = 0;
+    Octet_Errors = 0;
+}
+
+static void mstpsim_report(double seconds)
+{
+    struct mstpsim_node *node;
+    uint64_t rotation_total_ns = 0;
+    uint64_t rotation_max_ns = 0;
+    uint64_t total_frame_octets = 0;
+    uint64_t pfm_octets;
+    uint32_t rotations = 0;
+    uint32_t offered = 0, dropped = 0, sent = 0, received = 0;
+    uint32_t octets = 0, invalid = 0, lost = 0;
+    unsigned i;
+
+    for (i = 0; i < Config.nodes; i++) {
+        node = &Nodes[i];
+        rotation_total_ns += node->token_rotation_total_ns;
+        rotations += node->token_count;
+        if (node->token_rotation_max_ns > rotation_max_ns) {
+            rotation_max_ns = node->token_rotation_max_ns;
+        }
+        offered += node->pdu_offered;
+        dropped += node->pdu_dropped;
+        sent += node->pdu_sent;
+        received += node->pdu_received;
+        octets += node->octets_received;
+        invalid += node->invalid_frames;
+        lost += node->lost_tokens;
+    }
+    for (i = 0; i < 256; i++) {
+        total_frame_octets += Frame_Octets[i];
+    }
+    pfm_octets = Frame_Octets[FRAME_TYPE_POLL_FOR_MASTER] +
+        Frame_Octets[FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER];
+    printf("MS/TP nodes=%u baud=%lu max-master=%u max-info-frames=%u "
+           "seed=%lu\n",
+        Config.nodes, (unsigned long)Config.baud, (unsigned)Config.max_master,
+        (unsigned)Config.max_info_frames, (unsigned long)Config.seed);
+    printf("Measured %.1f seconds after %u seconds warm-up\n", seconds,
+        Config.warmup);
+    if (rotations) {
+        printf("Token rotation: average %.2fms, maximum %.2fms\n",
+            (double)rotation_total_ns / rotations / 1000000.0,
+            (double)rotation_max_ns / 1000000.0);
+    } else {
+        printf("Token rotation: no token passing\n");
+    }
+    printf("Bus utilization: %.1f%%\n",
+        100.0 * (double)Bus_Busy_ns / (seconds * 1000000000.0));
+    printf("Frames: Token=%lu PFM=%lu Reply-to-PFM=%lu DER=%lu DNER=%lu "
+           "Reply-Postponed=%lu\n",
+        (unsigned long)Frame_Count[FRAME_TYPE_TOKEN],
+        (unsigned long)Frame_Count[FRAME_TYPE_POLL_FOR_MASTER],
+        (unsigned long)Frame_Count[FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER],
+        (unsigned long)Frame_Count[FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY],
+        (unsigned long)Frame_Count[FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY],
+        (unsigned long)Frame_Count[FRAME_TYPE_REPLY_POSTPONED]);
+    if (total_frame_octets) {
+        printf("Poll-for-master overhead: %.1f%% of octets sent\n",
+            100.0 * (double)pfm_octets / (double)total_frame_octets);
+    }
+    printf("Throughput: %.1f PDU/s, %.1f octets/s received\n",
+        (double)received / seconds, (double)octets / seconds);
+    printf("PDUs: offered=%lu sent=%lu received=%lu dropped=%lu\n",
+        (unsigned long)offered, (unsigned long)sent, (unsigned long)received,
+        (unsigned long)dropped);
+    printf("Errors: collisions=%lu octet-errors=%lu "
+           "invalid-frames-received=%lu lost-tokens=%lu\n",
+        (unsigned long)Collisions, (unsigned long)Octet_Errors,
+        (unsigned long)invalid, (unsigned long)lost);
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--nodes N][--baud baud][--max-master M]\n"
+           "  [--max-info-frames F][--turnaround bits][--ber rate]\n"
+           "  [--load pdu/s][--pdu-size octets][--confirmed]\n"
+           "  [--duration seconds][--warmup seconds][--seed N]\n",
+        filename);
+    printf("       %s [--version][--help]\n", filename);
+}
+
+static void print_help(const char *filename)
+{
+    printf("Simulate an MS/TP network of master nodes on a virtual\n"
+           "RS-485 bus, and report the token rotation time, poll-for-master\n"
+           "overhead, throughput, and errors.\n");
+    printf("--nodes N - number of master nodes, MAC 0..N-1 (1..%u)\n"
+           "    Defaults to 32.\n",
+        MSTPSIM_NODES_MAX);
+    printf("--baud baud - 9600, 19200, 38400, 57600, 76800, 115200.\n"
+           "    Defaults to 38400.\n");
+    printf("--max-master M - Max_Master of every node. Defaults to 127.\n");
+    printf("--max-info-frames F - Max_Info_Frames of every node.\n"
+           "    Defaults to 1.\n");
+    printf("--turnaround bits - Tturnaround in bit times. Defaults to 40.\n");
+    printf("--ber rate - bit error rate, for example 0.00001.\n"
+           "    Defaults to 0.\n");
+    printf("--load pdu/s - PDUs offered per second by each node.\n"
+           "    Defaults to 0 (token passing only).\n");
+    printf("--pdu-size octets - size of each offered PDU. Defaults to 128.\n");
+    printf("--confirmed - send data-expecting-reply frames, which are\n"
+           "    answered by the destination.\n");
+    printf("--duration seconds - simulated time measured. Defaults to 60.\n");
+    printf("--warmup seconds - simulated time before measuring.\n"
+           "    Defaults to 10.\n");
+    printf("--seed N - seed of the pseudo random numbers. Defaults to 1.\n");
+    printf("\n");
+    printf("Example:\n"
+           "%s --nodes 64 --max-master 63 --max-info-frames 4 --load 2\n",
+        filename);
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t warmup_ns, end_ns;
+    char *filename = NULL;
+    int argi = 0;
+    unsigned i;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2023 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if (strcmp(argv[argi], "--confirmed") == 0) {
+            Config.confirmed = true;
+            continue;
+        }
+        if (++argi >= argc) {
+            print_usage(filename);
+            return 1;
+        }
+        if (strcmp(argv[argi - 1], "--nodes") == 0) {
+            Config.nodes = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--baud") == 0) {
+            Config.baud = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--max-master") == 0) {
+            Config.max_master = (uint8_t)strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--max-info-frames") == 0) {
+            Config.max_info_frames = (uint8_t)strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--turnaround") == 0) {
+            Config.turnaround_bits = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--ber") == 0) {
+            Config.bit_error_rate = strtod(argv[argi], NULL);
+        } else if (strcmp(argv[argi - 1], "--load") == 0) {
+            Config.load = strtod(argv[argi], NULL);
+        } else if (strcmp(argv[argi - 1], "--pdu-size") == 0) {
+            Config.pdu_size = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--duration") == 0) {
+            Config.duration = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--warmup") == 0) {
+            Config.warmup = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--seed") == 0) {
+            Config.seed = strtoul(argv[argi], NULL, 0);
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if ((Config.nodes < 1) || (Config.nodes > MSTPSIM_NODES_MAX) ||
+        (Config.max_master > DEFAULT_MAX_MASTER) ||
+        (Config.max_master < (Config.nodes - 1)) ||
+        (Config.max_info_frames < 1) || (Config.baud < 1200) ||
+        (Config.duration < 1)) {
+        fprintf(stderr, "Invalid configuration.\n");
+        print_usage(filename);
+        return 1;
+    }
+    mstpsim_init();
+    warmup_ns = Config.warmup * 1000000000ULL;
+    end_ns = warmup_ns + (Config.duration * 1000000000ULL);
+    for (Sim_Time_ns = 0; Sim_Time_ns < end_ns; Sim_Time_ns += Octet_Time_ns) {
+        if ((Sim_Time_ns < warmup_ns) &&
+            ((Sim_Time_ns + Octet_Time_ns) >= warmup_ns)) {
+            mstpsim_statistics_clear();
+        }
+        for (i = 0; i < Config.nodes; i++) {
+            mstpsim_offered_load(&Nodes[i]);
+            mstpsim_node_task(&Nodes[i]);
+        }
+    }
+    mstpsim_report((double)Config.duration);
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Host many BACnet device stacks in one process, and compare
+ *  the memory and CPU used with one process per device
+ *
+ * @section DESCRIPTION
+ *
+ * Creates a stack context for each device from one memory pool, and
+ * runs the address cache, TSM, and COV timers and tasks of every device
+ * from one loop using simulated seconds.  The same work is then done by
+ * one forked process per device, and the resident set size and CPU time
+ * of both approaches are reported.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/version.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/service/h_cov.h"
+#include "bacnet/basic/stack_context.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/tsm/tsm.h"
+
+struct multistack_usage {
+    unsigned long rss_kb;
+    unsigned long cpu_ms;
+};
+
+static unsigned Devices = 100;
+static unsigned Seconds = 3600;
+static unsigned Peers = 16;
+static bool Process_Per_Device = true;
+
+static unsigned long rusage_cpu_ms(const struct rusage *usage)
+{
+    return (unsigned long)((usage->ru_utime.tv_sec * 1000L) +
+        (usage->ru_utime.tv_usec / 1000L) + (usage->ru_stime.tv_sec * 1000L) +
+        (usage->ru_stime.tv_usec / 1000L));
+}
+
+/**
+ * @brief Bind some peer devices, as a device would after Who-Is
+ * @param device_instance - our device instance
+ */
+static void multistack_device_bind(uint32_t device_instance)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint32_t peer;
+    unsigned i;
+
+    for (i = 0; i < Peers; i++) {
+        peer = (device_instance + 1 + i) % BACNET_MAX_INSTANCE;
+        src.mac_len = 6;
+        src.mac[0] = 192;
+        src.mac[1] = 168;
+        src.mac[2] = (uint8_t)(peer >> 8);
+        src.mac[3] = (uint8_t)peer;
+        src.mac[4] = 0xBA;
+        src.mac[5] = 0xC0;
+        address_add(peer, MAX_APDU, &src);
+    }
+}
+
+/**
+ * @brief Run the periodic work of the selected device for one second
+ */
+static void multistack_device_second(void)
+{
+    tsm_timer_milliseconds(1000);
+    address_cache_timer(1);
+    handler_cov_timer_seconds(1);
+    while (!handler_cov_fsm()) {
+        /* run the COV task until it has checked every subscription */
+    }
+}
+
+/**
+ * @brief Host every device in this process using stack contexts
+ * @param usage - [out] RSS and CPU time used by the devices
+ * @return true if all of the stack contexts were created
+ */
+static bool multistack_contexts(struct multistack_usage *usage)
+{
+    BACNET_STACK_CONTEXT **context;
+    struct rusage before, after;
+    uint8_t *pool;
+    size_t size;
+    unsigned i, s;
+
+    getrusage(RUSAGE_SELF, &before);
+    Device_Init(NULL);
+    size = stack_context_size();
+    pool = malloc(size * Devices);
+    context = calloc(Devices, sizeof(BACNET_STACK_CONTEXT *));
+    if (!pool || !context) {
+        free(pool);
+        free(context);
+        return false;
+    }
+    for (i = 0; i < Devices; i++) {
+        context[i] = stack_context_init(&pool[i * size], size, i + 1);
+        (void)stack_context_select(context[i]);
+        multistack_device_bind(i + 1);
+    }
+    for (s = 0; s < Seconds; s++) {
+        for (i = 0; i < Devices; i++) {
+            (void)stack_context_select(context[i]);
+            multistack_device_second();
+        }
+    }
+    (void)stack_context_select(NULL);
+    getrusage(RUSAGE_SELF, &after);
+    usage->rss_kb = after.ru_maxrss;
+    usage->cpu_ms = rusage_cpu_ms(&after) - rusage_cpu_ms(&before);
+    for (i = 0; i < Devices; i++) {
+        stack_context_delete(context[i]);
+    }
+    free(context);
+    free(pool);
+
+    return true;
+}
+
+/**
+ * @brief Run every device in its own process, one after another
+ * @param usage - [out] sum of the RSS and CPU time of the processes
+ * @return true if all of the processes were run
+ */
+static bool multistack_processes(struct multistack_usage *usage)
+{
+    struct rusage child;
+    pid_t pid;
+    int status;
+    unsigned i, s;
+
+    usage->rss_kb = 0;
+    usage->cpu_ms = 0;
+    for (i = 0; i < Devices; i++) {
+        pid = fork();
+        if (pid < 0) {
+            return false;
+        }
+        if (pid == 0) {
+            Device_Init(NULL);
+            Device_Set_Object_Instance_Number(i + 1);
+            address_own_device_id_set(i + 1);
+            multistack_device_bind(i + 1);
+            for (s = 0; s < Seconds; s++) {
+                multistack_device_second();
+            }
+            _exit(0);
+        }
+        if (wait4(pid, &status, 0, &child) != pid) {
+            return false;
+        }
+        usage->rss_kb += child.ru_maxrss;
+        usage->cpu_ms += rusage_cpu_ms(&child);
+    }
+
+    return true;
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--devices N][--seconds S][--peers P]\n"
+           "  [--no-process]\n",
+        filename);
+    printf("       %s [--version][--help]\n", filename);
+}
+
+static void print_help(const char *filename)
+{
+    printf("Host many BACnet device stacks in one process using a stack\n"
+           "context per device, and compare the RSS and CPU time with\n"
+           "one process per device doing the same work.\n");
+    printf("--devices N - number of devices. Defaults to 100.\n");
+    printf("--seconds S - simulated seconds of timers and COV tasks.\n"
+           "    Defaults to 3600.\n");
+    printf("--peers P - peer devices bound by each device.\n"
+           "    Defaults to 16.\n");
+    printf("--no-process - skip the process per device measurement.\n");
+    printf("\n");
+    printf("Example:\n"
+           "%s --devices 500 --seconds 600\n",
+        filename);
+}
+
+int main(int argc, char *argv[])
+{
+    struct multistack_usage contexts = { 0 };
+    struct multistack_usage processes = { 0 };
+    char *filename = NULL;
+    int argi = 0;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2023 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if (strcmp(argv[argi], "--no-process") == 0) {
+            Process_Per_Device = false;
+            continue;
+        }
+        if (++argi >= argc) {
+            print_usage(filename);
+            return 1;
+        }
+        if (strcmp(argv[argi - 1], "--devices") == 0) {
+            Devices = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--seconds") == 0) {
+            Seconds = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi - 1], "--peers") == 0) {
+            Peers = strtoul(argv[argi], NULL, 0);
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if ((Devices < 1) || (Devices > BACNET_MAX_INSTANCE)) {
+        fprintf(stderr, "Invalid number of devices.\n");
+        print_usage(filename);
+        return 1;
+    }
+    printf("%u devices, %u simulated seconds, %u peers per device\n",
+        Devices, Seconds, Peers);
+    printf("stack context: %lu bytes per device\n",
+        (unsigned long)stack_context_size());
+    /* processes are forked first, so they don't inherit the pool */
+    if (Process_Per_Device && !multistack_processes(&processes)) {
+        fprintf(stderr, "Unable to run a process per device.\n");
+        return 1;
+    }
+    if (!multistack_contexts(&contexts)) {
+        fprintf(stderr, "Unable to create the stack contexts.\n");
+        return 1;
+    }
+    printf("%-20s %12s %12s\n", "", "RSS KiB", "CPU ms");
+    printf("%-20s %12lu %12lu\n", "stack contexts", contexts.rss_kb,
+        contexts.cpu_ms);
+    if (Process_Per_Device) {
+        printf("%-20s %12lu %12lu\n", "process per device", processes.rss_kb,
+            processes.cpu_ms);
+    }
+
+    return 0;
+}
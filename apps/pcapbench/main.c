@@ -0,0 +1,1418 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Benchmark of the BACnet codecs that replays captured packets
+ *
+ * @section DESCRIPTION
+ *
+ * Loads the packets of capture files in libpcap or pcapng format, such
+ * as the MS/TP captures saved by mstpcap or the BACnet/IP captures saved
+ * by Wireshark, and replays them many times over through the BVLC, NPDU,
+ * and APDU decoders and the decoders of the services.  Then replays them
+ * again while encoding every decoded packet with the service encoders.
+ * Reports the nanoseconds per packet and the megabytes per second of
+ * each service, in the same order every time, so that the results of two
+ * builds can be compared line by line.  Without a capture file, a
+ * built-in corpus of common services is replayed.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacint.h"
+#include "bacnet/bacerror.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/bactext.h"
+#include "bacnet/abort.h"
+#include "bacnet/reject.h"
+#include "bacnet/npdu.h"
+#include "bacnet/rp.h"
+#include "bacnet/rpm.h"
+#include "bacnet/wp.h"
+#include "bacnet/iam.h"
+#include "bacnet/whois.h"
+#include "bacnet/cov.h"
+#include "bacnet/version.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "bacnet/basic/service/h_apdu.h"
+#include "bacnet/basic/sys/filename.h"
+
+/* link-layer header types of the capture files */
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW 101
+#define LINKTYPE_LINUX_SLL 113
+#define LINKTYPE_BACNET_MS_TP 165
+#define LINKTYPE_IPV4 228
+/* interfaces in one section of a pcapng file */
+#define PCAPNG_INTERFACES_MAX 8
+/* BACnet/IP UDP port of the packets that are saved */
+#define PCAPBENCH_UDP_PORT 0xBAC0
+/* values of a COV notification that can be decoded */
+#define PCAPBENCH_COV_VALUES_MAX 8
+/* BVLC header, and the address of a Forwarded-NPDU */
+#define PCAPBENCH_MPDU_MAX (MAX_PDU + 4 + 6)
+
+struct pcapbench_packet {
+    /* BVLC message, or NPDU of the MS/TP and Ethernet captures */
+    uint8_t *pdu;
+    uint16_t pdu_len;
+    bool bvlc;
+    /* group of the packet, and the order in which it was loaded */
+    unsigned key;
+    unsigned order;
+};
+
+struct pcapbench_group {
+    unsigned key;
+    /* packets of the group, which are sorted by group */
+    unsigned index;
+    unsigned count;
+    unsigned long octets;
+    double decode_seconds;
+    double codec_seconds;
+};
+
+static unsigned Iterations = 1000;
+static unsigned Repeat = 3;
+static bool CSV_Output;
+/* keeps the compiler from removing the encoding and decoding */
+static volatile unsigned long Checksum;
+
+static struct pcapbench_packet *Packets;
+static unsigned Packet_Count;
+static unsigned Packet_Size;
+static unsigned Packets_Skipped;
+static struct pcapbench_group *Groups;
+static unsigned Group_Count;
+
+/* the packets are encoded again into these */
+static uint8_t Tx_Buffer[MAX_PDU];
+static uint8_t Mtu_Buffer[PCAPBENCH_MPDU_MAX];
+/* the services are decoded into these */
+static BACNET_READ_PROPERTY_DATA RP_Data;
+static BACNET_WRITE_PROPERTY_DATA WP_Data;
+static BACNET_SUBSCRIBE_COV_DATA COV_Subscribe_Data;
+static BACNET_COV_DATA COV_Data;
+static BACNET_PROPERTY_VALUE COV_Values[PCAPBENCH_COV_VALUES_MAX];
+static BACNET_APPLICATION_DATA_VALUE Value;
+
+static double clock_seconds(clock_t start)
+{
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    return (seconds > 0.0) ? seconds : 1e-9;
+}
+
+static uint16_t pcap_u16(const uint8_t *data, bool big_endian)
+{
+    if (big_endian) {
+        return (uint16_t)(((uint16_t)data[0] << 8) | data[1]);
+    }
+
+    return (uint16_t)(((uint16_t)data[1] << 8) | data[0]);
+}
+
+static uint32_t pcap_u32(const uint8_t *data, bool big_endian)
+{
+    if (big_endian) {
+        return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+            ((uint32_t)data[2] << 8) | data[3];
+    }
+
+    return ((uint32_t)data[3] << 24) | ((uint32_t)data[2] << 16) |
+        ((uint32_t)data[1] << 8) | data[0];
+}
+
+/**
+ * @brief Decode the application tagged values, and skip over the context
+ *  tagged values, of a service that is not decoded by its own decoder
+ * @param apdu - service data
+ * @param apdu_len - number of octets of service data
+ * @return number of octets decoded
+ */
+static int pcapbench_tags_decode(uint8_t *apdu, unsigned apdu_len)
+{
+    uint8_t tag_number = 0;
+    uint32_t len_value = 0;
+    unsigned len = 0;
+    int tag_len;
+
+    while (len < apdu_len) {
+        if (IS_CONTEXT_SPECIFIC(apdu[len])) {
+            tag_len = bacnet_tag_number_and_value_decode(
+                &apdu[len], apdu_len - len, &tag_number, &len_value);
+            if (tag_len <= 0) {
+                break;
+            }
+            if (IS_OPENING_TAG(apdu[len]) || IS_CLOSING_TAG(apdu[len])) {
+                len_value = 0;
+            }
+            len += (unsigned)tag_len + len_value;
+        } else {
+            tag_len =
+                bacapp_decode_application_data(&apdu[len], apdu_len - len,
+                    &Value);
+            if (tag_len <= 0) {
+                break;
+            }
+            len += (unsigned)tag_len;
+        }
+    }
+
+    return (int)len;
+}
+
+/**
+ * @brief Copy the APDU of a service that has no encoder here
+ */
+static int pcapbench_apdu_copy(
+    uint8_t *apdu, unsigned apdu_len, uint8_t *tx_apdu, bool encode)
+{
+    if (encode) {
+        memcpy(tx_apdu, apdu, apdu_len);
+    }
+
+    return (int)apdu_len;
+}
+
+/**
+ * @brief Decode a ReadPropertyMultiple request, and encode it again one
+ *  object and property at a time while it is decoded
+ * @return number of octets encoded, or decoded, or -1 on error
+ */
+static int pcapbench_rpm_codec(uint8_t *service_request,
+    unsigned service_len,
+    uint8_t invoke_id,
+    uint8_t *tx_apdu,
+    bool encode)
+{
+    BACNET_RPM_DATA rpmdata;
+    unsigned decode_len = 0;
+    int apdu_len = 0;
+    int len;
+
+    if (encode) {
+        apdu_len = rpm_encode_apdu_init(tx_apdu, invoke_id);
+    }
+    while (decode_len < service_len) {
+        len = rpm_decode_object_id(
+            &service_request[decode_len], service_len - decode_len, &rpmdata);
+        if (len <= 0) {
+            return -1;
+        }
+        decode_len += (unsigned)len;
+        if (encode) {
+            apdu_len += rpm_encode_apdu_object_begin(&tx_apdu[apdu_len],
+                rpmdata.object_type, rpmdata.object_instance);
+        }
+        for (;;) {
+            len = rpm_decode_object_property(&service_request[decode_len],
+                service_len - decode_len, &rpmdata);
+            if (len <= 0) {
+                return -1;
+            }
+            decode_len += (unsigned)len;
+            if (encode) {
+                apdu_len += rpm_encode_apdu_object_property(
+                    &tx_apdu[apdu_len], rpmdata.object_property,
+                    rpmdata.array_index);
+            }
+            if (rpm_decode_object_end(&service_request[decode_len],
+                    service_len - decode_len)) {
+                decode_len++;
+                if (encode) {
+                    apdu_len += rpm_encode_apdu_object_end(&tx_apdu[apdu_len]);
+                }
+                break;
+            }
+        }
+    }
+
+    return encode ? apdu_len : (int)decode_len;
+}
+
+/**
+ * @brief Decode a confirmed service request, and encode it again
+ * @return number of octets encoded, or decoded, or -1 on error
+ */
+static int pcapbench_confirmed_codec(
+    uint8_t *apdu, unsigned apdu_len, uint8_t *tx_apdu, bool encode)
+{
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    uint8_t service_choice = 0;
+    uint8_t *service_request = NULL;
+    uint16_t service_len = 0;
+    int len;
+
+    if (apdu_decode_confirmed_service_request(apdu, (uint16_t)apdu_len,
+            &service_data, &service_choice, &service_request,
+            &service_len) == 0) {
+        return -1;
+    }
+    if (service_data.segmented_message) {
+        /* a segment is not decoded on its own */
+        return pcapbench_apdu_copy(apdu, apdu_len, tx_apdu, encode);
+    }
+    switch (service_choice) {
+        case SERVICE_CONFIRMED_READ_PROPERTY:
+            len =
+                rp_decode_service_request(service_request, service_len,
+                    &RP_Data);
+            if ((len > 0) && encode) {
+                len = rp_encode_apdu(tx_apdu, service_data.invoke_id, &RP_Data);
+            }
+            break;
+        case SERVICE_CONFIRMED_WRITE_PROPERTY:
+            len =
+                wp_decode_service_request(service_request, service_len,
+                    &WP_Data);
+            if (len > 0) {
+                /* the value is decoded by the object that is written */
+                Checksum += (unsigned long)bacapp_decode_application_data(
+                    WP_Data.application_data,
+                    (unsigned)WP_Data.application_data_len, &Value);
+            }
+            if ((len > 0) && encode) {
+                len = wp_encode_apdu(tx_apdu, service_data.invoke_id, &WP_Data);
+            }
+            break;
+        case SERVICE_CONFIRMED_READ_PROP_MULTIPLE:
+            len = pcapbench_rpm_codec(service_request, service_len,
+                service_data.invoke_id, tx_apdu, encode);
+            break;
+        case SERVICE_CONFIRMED_SUBSCRIBE_COV:
+            len = cov_subscribe_decode_service_request(
+                service_request, service_len, &COV_Subscribe_Data);
+            if ((len > 0) && encode) {
+                len = cov_subscribe_encode_apdu(tx_apdu, MAX_APDU,
+                    service_data.invoke_id, &COV_Subscribe_Data);
+            }
+            break;
+        case SERVICE_CONFIRMED_COV_NOTIFICATION:
+            cov_data_value_list_link(
+                &COV_Data, COV_Values, PCAPBENCH_COV_VALUES_MAX);
+            len = cov_notify_decode_service_request(
+                service_request, service_len, &COV_Data);
+            if ((len > 0) && encode) {
+                len = ccov_notify_encode_apdu(
+                    tx_apdu, MAX_APDU, service_data.invoke_id, &COV_Data);
+            }
+            break;
+        default:
+            Checksum += (unsigned long)pcapbench_tags_decode(
+                service_request, service_len);
+            len = pcapbench_apdu_copy(apdu, apdu_len, tx_apdu, encode);
+            break;
+    }
+
+    return (len > 0) ? len : -1;
+}
+
+/**
+ * @brief Decode an unconfirmed service request, and encode it again
+ * @return number of octets encoded, or decoded, or -1 on error
+ */
+static int pcapbench_unconfirmed_codec(
+    uint8_t *apdu, unsigned apdu_len, uint8_t *tx_apdu, bool encode)
+{
+    uint8_t *service_request;
+    unsigned service_len;
+    uint32_t device_id = 0;
+    unsigned max_apdu = 0;
+    int segmentation = 0;
+    uint16_t vendor_id = 0;
+    int32_t low_limit = -1;
+    int32_t high_limit = -1;
+    int len;
+
+    if (apdu_len < 2) {
+        return -1;
+    }
+    service_request = &apdu[2];
+    service_len = apdu_len - 2;
+    switch (apdu[1]) {
+        case SERVICE_UNCONFIRMED_I_AM:
+            len = iam_decode_service_request(service_request, &device_id,
+                &max_apdu, &segmentation, &vendor_id);
+            if ((len > 0) && encode) {
+                len = iam_encode_apdu(
+                    tx_apdu, device_id, max_apdu, segmentation, vendor_id);
+            }
+            break;
+        case SERVICE_UNCONFIRMED_WHO_IS:
+            len = whois_decode_service_request(
+                service_request, service_len, &low_limit, &high_limit);
+            if (len < 0) {
+                break;
+            }
+            if (encode) {
+                len = whois_encode_apdu(tx_apdu, low_limit, high_limit);
+            } else {
+                /* a Who-Is without limits has no service data */
+                len = (int)apdu_len;
+            }
+            break;
+        case SERVICE_UNCONFIRMED_COV_NOTIFICATION:
+            cov_data_value_list_link(
+                &COV_Data, COV_Values, PCAPBENCH_COV_VALUES_MAX);
+            len = cov_notify_decode_service_request(
+                service_request, service_len, &COV_Data);
+            if ((len > 0) && encode) {
+                len = ucov_notify_encode_apdu(tx_apdu, MAX_APDU, &COV_Data);
+            }
+            break;
+        default:
+            Checksum += (unsigned long)pcapbench_tags_decode(
+                service_request, service_len);
+            len = pcapbench_apdu_copy(apdu, apdu_len, tx_apdu, encode);
+            break;
+    }
+
+    return (len > 0) ? len : -1;
+}
+
+/**
+ * @brief Decode a ComplexACK, and encode it again
+ * @return number of octets encoded, or decoded, or -1 on error
+ */
+static int pcapbench_complex_ack_codec(
+    uint8_t *apdu, unsigned apdu_len, uint8_t *tx_apdu, bool encode)
+{
+    unsigned offset = 3;
+    int len;
+
+    if (apdu[0] & BIT(3)) {
+        /* a segment is not decoded on its own */
+        return pcapbench_apdu_copy(apdu, apdu_len, tx_apdu, encode);
+    }
+    if (apdu_len < offset) {
+        return -1;
+    }
+    if (apdu[2] == SERVICE_CONFIRMED_READ_PROPERTY) {
+        len = rp_ack_decode_service_request(
+            &apdu[offset], (int)(apdu_len - offset), &RP_Data);
+        if (len > 0) {
+            Checksum += (unsigned long)pcapbench_tags_decode(
+                RP_Data.application_data,
+                (unsigned)RP_Data.application_data_len);
+        }
+        if ((len > 0) && encode) {
+            len = rp_ack_encode_apdu(tx_apdu, apdu[1], &RP_Data);
+        }
+    } else {
+        Checksum += (unsigned long)pcapbench_tags_decode(
+            &apdu[offset], apdu_len - offset);
+        len = pcapbench_apdu_copy(apdu, apdu_len, tx_apdu, encode);
+    }
+
+    return (len > 0) ? len : -1;
+}
+
+/**
+ * @brief Decode an APDU, and encode it again
+ * @return number of octets encoded, or decoded, or -1 on error
+ */
+static int pcapbench_apdu_codec(
+    uint8_t *apdu, unsigned apdu_len, uint8_t *tx_apdu, bool encode)
+{
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_DEVICE;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_OTHER;
+    int len = -1;
+
+    switch (apdu[0] & 0xF0) {
+        case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
+            len = pcapbench_confirmed_codec(apdu, apdu_len, tx_apdu, encode);
+            break;
+        case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
+            len = pcapbench_unconfirmed_codec(apdu, apdu_len, tx_apdu, encode);
+            break;
+        case PDU_TYPE_SIMPLE_ACK:
+            if (apdu_len >= 3) {
+                len = encode ? encode_simple_ack(tx_apdu, apdu[1], apdu[2])
+                             : 3;
+            }
+            break;
+        case PDU_TYPE_COMPLEX_ACK:
+            len = pcapbench_complex_ack_codec(apdu, apdu_len, tx_apdu, encode);
+            break;
+        case PDU_TYPE_ERROR:
+            if (apdu_len < 3) {
+                break;
+            }
+            len = bacerror_decode_error_class_and_code(
+                &apdu[3], apdu_len - 3, &error_class, &error_code);
+            if ((len > 0) && encode) {
+                len = bacerror_encode_apdu(tx_apdu, apdu[1],
+                    (BACNET_CONFIRMED_SERVICE)apdu[2], error_class,
+                    error_code);
+            }
+            break;
+        case PDU_TYPE_REJECT:
+            if (apdu_len >= 3) {
+                len = encode ? reject_encode_apdu(tx_apdu, apdu[1], apdu[2])
+                             : 3;
+            }
+            break;
+        case PDU_TYPE_ABORT:
+            if (apdu_len >= 3) {
+                len = encode ? abort_encode_apdu(tx_apdu, apdu[1], apdu[2],
+                                   (apdu[0] & BIT(0)) ? true : false)
+                             : 3;
+            }
+            break;
+        default:
+            len = pcapbench_apdu_copy(apdu, apdu_len, tx_apdu, encode);
+            break;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Get the group of a packet, which sorts the groups by PDU type,
+ *  and then by service
+ */
+static unsigned pcapbench_key(
+    BACNET_NPDU_DATA *npdu_data, uint8_t *apdu, unsigned apdu_len)
+{
+    unsigned pdu_type;
+    unsigned offset = 0;
+    unsigned service = 0;
+
+    if (npdu_data->network_layer_message) {
+        return npdu_data->network_message_type;
+    }
+    pdu_type = apdu[0] & 0xF0;
+    switch (pdu_type) {
+        case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
+            offset = (apdu[0] & BIT(3)) ? 5 : 3;
+            break;
+        case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
+            offset = 1;
+            break;
+        case PDU_TYPE_SIMPLE_ACK:
+        case PDU_TYPE_ERROR:
+            offset = 2;
+            break;
+        case PDU_TYPE_COMPLEX_ACK:
+            offset = (apdu[0] & BIT(3)) ? 4 : 2;
+            break;
+        default:
+            break;
+    }
+    if (offset && (offset < apdu_len)) {
+        service = apdu[offset];
+    }
+
+    return (((pdu_type >> 4) + 1) * 256) + service;
+}
+
+static void pcapbench_key_name(unsigned key, char *name)
+{
+    unsigned service = key % 256;
+
+    switch (key / 256) {
+        case 0:
+            sprintf(name, "%s", bactext_network_layer_msg_name(service));
+            break;
+        case 1:
+            sprintf(name, "%s", bactext_confirmed_service_name(service));
+            break;
+        case 2:
+            sprintf(name, "%s", bactext_unconfirmed_service_name(service));
+            break;
+        case 3:
+            sprintf(
+                name, "%s-SimpleACK", bactext_confirmed_service_name(service));
+            break;
+        case 4:
+            sprintf(
+                name, "%s-ComplexACK", bactext_confirmed_service_name(service));
+            break;
+        case 5:
+            sprintf(name, "SegmentACK");
+            break;
+        case 6:
+            sprintf(name, "%s-Error", bactext_confirmed_service_name(service));
+            break;
+        case 7:
+            sprintf(name, "Reject");
+            break;
+        case 8:
+            sprintf(name, "Abort");
+            break;
+        default:
+            sprintf(name, "PDU-Type-%u", (key / 256) - 1);
+            break;
+    }
+}
+
+/**
+ * @brief Replay a packet through the BVLC, NPDU, and APDU decoders, and
+ *  optionally encode it again
+ * @param packet - the packet
+ * @param encode - true to encode the decoded packet again
+ * @param key - [out] the group of the packet, or NULL
+ * @return true if the packet was decoded
+ */
+static bool pcapbench_replay(
+    struct pcapbench_packet *packet, bool encode, unsigned *key)
+{
+    BACNET_ADDRESS dest;
+    BACNET_ADDRESS src;
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_IP_ADDRESS fwd_address;
+    uint8_t message_type = 0;
+    uint16_t message_length = 0;
+    uint16_t npdu_len = 0;
+    uint16_t pdu_len;
+    uint8_t *pdu;
+    uint8_t *npdu;
+    int function_len = 0;
+    int len;
+    int tx_len = 0;
+    int apdu_len;
+
+    if (packet->bvlc) {
+        len = bvlc_decode_header(
+            packet->pdu, packet->pdu_len, &message_type, &message_length);
+        if (len != 4) {
+            return false;
+        }
+        pdu = &packet->pdu[len];
+        pdu_len = (uint16_t)(packet->pdu_len - len);
+        switch (message_type) {
+            case BVLC_ORIGINAL_UNICAST_NPDU:
+                function_len = bvlc_decode_original_unicast(
+                    pdu, pdu_len, NULL, 0, &npdu_len);
+                break;
+            case BVLC_ORIGINAL_BROADCAST_NPDU:
+                function_len = bvlc_decode_original_broadcast(
+                    pdu, pdu_len, NULL, 0, &npdu_len);
+                break;
+            case BVLC_FORWARDED_NPDU:
+                function_len = bvlc_decode_forwarded_npdu(
+                    pdu, pdu_len, &fwd_address, NULL, 0, &npdu_len);
+                break;
+            default:
+                break;
+        }
+        if (function_len <= 0) {
+            return false;
+        }
+        npdu = &pdu[function_len - npdu_len];
+    } else {
+        npdu = packet->pdu;
+        npdu_len = packet->pdu_len;
+    }
+    len = bacnet_npdu_decode(npdu, npdu_len, &dest, &src, &npdu_data);
+    if ((len <= 0) || (len > npdu_len) ||
+        ((len == npdu_len) && !npdu_data.network_layer_message)) {
+        return false;
+    }
+    apdu_len = npdu_len - len;
+    if (encode) {
+        tx_len = npdu_encode_pdu(Tx_Buffer, &dest, &src, &npdu_data);
+    }
+    if (npdu_data.network_layer_message) {
+        len = pcapbench_apdu_copy(
+            &npdu[len], (unsigned)apdu_len, &Tx_Buffer[tx_len], encode);
+    } else {
+        len = pcapbench_apdu_codec(
+            &npdu[len], (unsigned)apdu_len, &Tx_Buffer[tx_len], encode);
+        if (len < 0) {
+            return false;
+        }
+    }
+    if (encode) {
+        tx_len += len;
+        if (packet->bvlc) {
+            if (message_type == BVLC_FORWARDED_NPDU) {
+                len = bvlc_encode_forwarded_npdu(Mtu_Buffer,
+                    sizeof(Mtu_Buffer), &fwd_address, Tx_Buffer,
+                    (uint16_t)tx_len);
+            } else if (message_type == BVLC_ORIGINAL_BROADCAST_NPDU) {
+                len = bvlc_encode_original_broadcast(Mtu_Buffer,
+                    sizeof(Mtu_Buffer), Tx_Buffer, (uint16_t)tx_len);
+            } else {
+                len = bvlc_encode_original_unicast(Mtu_Buffer,
+                    sizeof(Mtu_Buffer), Tx_Buffer, (uint16_t)tx_len);
+            }
+        }
+    }
+    Checksum += (unsigned long)len;
+    if (key) {
+        *key = pcapbench_key(
+            &npdu_data, &npdu[npdu_len - apdu_len], (unsigned)apdu_len);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Add a copy of a BVLC message, or of an NPDU, to the corpus
+ * @return true if the packet was decoded and encoded, and was added
+ */
+static bool pcapbench_packet_add(uint8_t *pdu, uint32_t pdu_len, bool bvlc)
+{
+    struct pcapbench_packet *packet;
+    void *packets;
+    unsigned key = 0;
+
+    if ((pdu_len == 0) || (pdu_len > (bvlc ? PCAPBENCH_MPDU_MAX : MAX_PDU))) {
+        return false;
+    }
+    if (Packet_Count >= Packet_Size) {
+        Packet_Size = Packet_Size ? (Packet_Size * 2) : 1024;
+        packets =
+            realloc(Packets, Packet_Size * sizeof(struct pcapbench_packet));
+        if (!packets) {
+            return false;
+        }
+        Packets = packets;
+    }
+    packet = &Packets[Packet_Count];
+    packet->pdu = malloc(pdu_len);
+    if (!packet->pdu) {
+        return false;
+    }
+    memcpy(packet->pdu, pdu, pdu_len);
+    packet->pdu_len = (uint16_t)pdu_len;
+    packet->bvlc = bvlc;
+    if (!pcapbench_replay(packet, true, &key)) {
+        free(packet->pdu);
+        return false;
+    }
+    packet->key = key;
+    packet->order = Packet_Count;
+    Packet_Count++;
+
+    return true;
+}
+
+/**
+ * @brief Add the BVLC message of an IPv4 UDP datagram to the corpus
+ */
+static bool pcapbench_ipv4_add(uint8_t *ip, uint32_t length)
+{
+    uint32_t header_len;
+    uint32_t udp_len;
+    uint8_t *udp;
+
+    if ((length < 20) || ((ip[0] >> 4) != 4)) {
+        return false;
+    }
+    header_len = (ip[0] & 0x0F) * 4;
+    /* UDP, and not a fragment */
+    if ((header_len < 20) || (length < (header_len + 8)) || (ip[9] != 17) ||
+        (pcap_u16(&ip[6], true) & 0x3FFF)) {
+        return false;
+    }
+    udp = &ip[header_len];
+    udp_len = pcap_u16(&udp[4], true);
+    if ((udp_len < 12) || ((header_len + udp_len) > length) ||
+        (udp[8] != BVLL_TYPE_BACNET_IP)) {
+        return false;
+    }
+
+    return pcapbench_packet_add(&udp[8], udp_len - 8, true);
+}
+
+/**
+ * @brief Add the BACnet packet of a captured frame to the corpus
+ * @param linktype - link-layer header type of the frame
+ * @param frame - captured frame
+ * @param length - number of captured octets
+ * @return true if the frame was a BACnet packet that was added
+ */
+static bool pcapbench_frame_add(
+    uint32_t linktype, uint8_t *frame, uint32_t length)
+{
+    uint32_t offset = 12;
+    uint16_t type;
+
+    switch (linktype) {
+        case LINKTYPE_BACNET_MS_TP:
+            if ((length < 8) || (frame[0] != 0x55) || (frame[1] != 0xFF) ||
+                ((frame[2] != FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) &&
+                    (frame[2] != FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY))) {
+                return false;
+            }
+            type = pcap_u16(&frame[5], true);
+            if ((8U + type) > length) {
+                return false;
+            }
+            return pcapbench_packet_add(&frame[8], type, false);
+        case LINKTYPE_ETHERNET:
+            if (length < 14) {
+                return false;
+            }
+            type = pcap_u16(&frame[offset], true);
+            if ((type == 0x8100) && (length >= 18)) {
+                /* VLAN tag */
+                offset += 4;
+                type = pcap_u16(&frame[offset], true);
+            }
+            offset += 2;
+            if (type == 0x0800) {
+                return pcapbench_ipv4_add(&frame[offset], length - offset);
+            }
+            /* BACnet/Ethernet uses an 802.2 LLC header */
+            if ((type > 3) && (type <= 1500) && ((offset + type) <= length) &&
+                (frame[offset] == 0x82) && (frame[offset + 1] == 0x82) &&
+                (frame[offset + 2] == 0x03)) {
+                return pcapbench_packet_add(
+                    &frame[offset + 3], type - 3U, false);
+            }
+            return false;
+        case LINKTYPE_LINUX_SLL:
+            if ((length < 16) || (pcap_u16(&frame[14], true) != 0x0800)) {
+                return false;
+            }
+            return pcapbench_ipv4_add(&frame[16], length - 16);
+        case LINKTYPE_RAW:
+        case LINKTYPE_IPV4:
+            return pcapbench_ipv4_add(frame, length);
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Load the frames of a libpcap file, in either byte order, with
+ *  microsecond or nanosecond timestamps
+ */
+static bool pcap_load(uint8_t *data, size_t size)
+{
+    uint32_t linktype;
+    uint32_t incl_len;
+    size_t offset = 24;
+    bool big_endian = true;
+
+    if (size < 24) {
+        return false;
+    }
+    if ((pcap_u32(data, true) != 0xa1b2c3d4) &&
+        (pcap_u32(data, true) != 0xa1b23c4d)) {
+        big_endian = false;
+        if ((pcap_u32(data, false) != 0xa1b2c3d4) &&
+            (pcap_u32(data, false) != 0xa1b23c4d)) {
+            return false;
+        }
+    }
+    linktype = pcap_u32(&data[20], big_endian) & 0xFFFF;
+    while ((offset + 16) <= size) {
+        incl_len = pcap_u32(&data[offset + 8], big_endian);
+        offset += 16;
+        if (incl_len > (size - offset)) {
+            break;
+        }
+        if (!pcapbench_frame_add(linktype, &data[offset], incl_len)) {
+            Packets_Skipped++;
+        }
+        offset += incl_len;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Load the Enhanced and Simple Packet Blocks of a pcapng file
+ */
+static bool pcapng_load(uint8_t *data, size_t size)
+{
+    uint32_t linktype[PCAPNG_INTERFACES_MAX];
+    unsigned interfaces = 0;
+    uint32_t block_type;
+    uint32_t block_len;
+    uint32_t interface_id;
+    uint32_t captured;
+    size_t offset = 0;
+    bool big_endian = false;
+
+    while ((offset + 12) <= size) {
+        block_type = pcap_u32(&data[offset], big_endian);
+        if (block_type == 0x0A0D0D0A) {
+            /* a new section, with its own byte order and interfaces */
+            big_endian = (pcap_u32(&data[offset + 8], true) == 0x1A2B3C4D);
+            interfaces = 0;
+        }
+        block_len = pcap_u32(&data[offset + 4], big_endian);
+        if ((block_len < 12) || (block_len > (size - offset))) {
+            break;
+        }
+        if ((block_type == 1) && (block_len >= 20)) {
+            if (interfaces < PCAPNG_INTERFACES_MAX) {
+                linktype[interfaces] = pcap_u16(&data[offset + 8], big_endian);
+                interfaces++;
+            }
+        } else if ((block_type == 6) && (block_len >= 32)) {
+            interface_id = pcap_u32(&data[offset + 8], big_endian);
+            captured = pcap_u32(&data[offset + 20], big_endian);
+            if ((interface_id >= interfaces) || (captured > (block_len - 32)) ||
+                !pcapbench_frame_add(
+                    linktype[interface_id], &data[offset + 28], captured)) {
+                Packets_Skipped++;
+            }
+        } else if ((block_type == 3) && (block_len >= 16)) {
+            captured = pcap_u32(&data[offset + 8], big_endian);
+            if (captured > (block_len - 16)) {
+                captured = block_len - 16;
+            }
+            if ((interfaces == 0) ||
+                !pcapbench_frame_add(
+                    linktype[0], &data[offset + 12], captured)) {
+                Packets_Skipped++;
+            }
+        }
+        offset += block_len;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Load the BACnet packets of a capture file into the corpus
+ * @param pathname - name of the libpcap or pcapng file
+ * @return true if the file was loaded
+ */
+static bool pcapbench_file_load(const char *pathname)
+{
+    FILE *pFile;
+    uint8_t *data = NULL;
+    long size = 0;
+    bool status = false;
+
+    pFile = fopen(pathname, "rb");
+    if (!pFile) {
+        return false;
+    }
+    if (fseek(pFile, 0, SEEK_END) == 0) {
+        size = ftell(pFile);
+    }
+    if ((size > 0) && (fseek(pFile, 0, SEEK_SET) == 0)) {
+        data = malloc((size_t)size);
+    }
+    if (data && (fread(data, (size_t)size, 1, pFile) == 1)) {
+        if ((size >= 12) && (pcap_u32(data, true) == 0x0A0D0D0A)) {
+            status = pcapng_load(data, (size_t)size);
+        } else {
+            status = pcap_load(data, (size_t)size);
+        }
+    }
+    free(data);
+    fclose(pFile);
+
+    return status;
+}
+
+/**
+ * @brief Add a sample packet to the built-in corpus as a BACnet/IP
+ *  Original-Unicast-NPDU
+ */
+static void pcapbench_sample_add(
+    uint8_t *apdu, int apdu_len, bool data_expecting_reply)
+{
+    BACNET_NPDU_DATA npdu_data;
+    uint8_t npdu[MAX_PDU];
+    uint8_t mtu[PCAPBENCH_MPDU_MAX];
+    int len;
+
+    npdu_encode_npdu_data(
+        &npdu_data, data_expecting_reply, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(npdu, NULL, NULL, &npdu_data);
+    memcpy(&npdu[len], apdu, (size_t)apdu_len);
+    len += apdu_len;
+    len = bvlc_encode_original_unicast(
+        mtu, sizeof(mtu), npdu, (uint16_t)len);
+    (void)pcapbench_packet_add(mtu, (uint32_t)len, true);
+}
+
+/**
+ * @brief Create the built-in corpus of the common services of a building
+ *  automation network: reading and writing present values, polling a few
+ *  objects with ReadPropertyMultiple, device discovery, and COV
+ */
+static void pcapbench_corpus_create(void)
+{
+    BACNET_READ_PROPERTY_DATA rpdata;
+    BACNET_WRITE_PROPERTY_DATA wpdata;
+    BACNET_RPM_DATA rpmdata;
+    BACNET_COV_DATA cov_data;
+    BACNET_PROPERTY_VALUE value_list[2];
+    BACNET_CHARACTER_STRING char_string;
+    BACNET_BIT_STRING bit_string;
+    uint8_t apdu[MAX_APDU];
+    uint8_t value[MAX_APDU];
+    unsigned i;
+    int len;
+
+    memset(&rpdata, 0, sizeof(rpdata));
+    memset(&wpdata, 0, sizeof(wpdata));
+    memset(&cov_data, 0, sizeof(cov_data));
+    memset(value_list, 0, sizeof(value_list));
+    bitstring_init(&bit_string);
+    for (i = 0; i < 4; i++) {
+        bitstring_set_bit(&bit_string, (uint8_t)i, false);
+    }
+    /* ReadProperty of a present value, and of an object name */
+    rpdata.object_type = OBJECT_ANALOG_INPUT;
+    rpdata.object_instance = 1;
+    rpdata.object_property = PROP_PRESENT_VALUE;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    len = rp_encode_apdu(apdu, 1, &rpdata);
+    pcapbench_sample_add(apdu, len, true);
+    rpdata.application_data = value;
+    rpdata.application_data_len = encode_application_real(value, 21.5f);
+    len = rp_ack_encode_apdu(apdu, 1, &rpdata);
+    pcapbench_sample_add(apdu, len, false);
+    rpdata.object_type = OBJECT_DEVICE;
+    rpdata.object_instance = 260001;
+    rpdata.object_property = PROP_OBJECT_NAME;
+    len = rp_encode_apdu(apdu, 2, &rpdata);
+    pcapbench_sample_add(apdu, len, true);
+    characterstring_init_ansi(&char_string, "Air Handling Unit 1");
+    rpdata.application_data_len =
+        encode_application_character_string(value, &char_string);
+    len = rp_ack_encode_apdu(apdu, 2, &rpdata);
+    pcapbench_sample_add(apdu, len, false);
+    /* WriteProperty of a commanded value, and its result */
+    wpdata.object_type = OBJECT_ANALOG_VALUE;
+    wpdata.object_instance = 1;
+    wpdata.object_property = PROP_PRESENT_VALUE;
+    wpdata.array_index = BACNET_ARRAY_ALL;
+    wpdata.priority = 8;
+    wpdata.application_data_len =
+        encode_application_real(wpdata.application_data, 50.0f);
+    len = wp_encode_apdu(apdu, 3, &wpdata);
+    pcapbench_sample_add(apdu, len, true);
+    len = encode_simple_ack(apdu, 3, SERVICE_CONFIRMED_WRITE_PROPERTY);
+    pcapbench_sample_add(apdu, len, false);
+    len = bacerror_encode_apdu(apdu, 4, SERVICE_CONFIRMED_WRITE_PROPERTY,
+        ERROR_CLASS_PROPERTY, ERROR_CODE_WRITE_ACCESS_DENIED);
+    pcapbench_sample_add(apdu, len, false);
+    /* ReadPropertyMultiple of the present value, status, and units of a
+       few objects, and its result */
+    len = rpm_encode_apdu_init(apdu, 5);
+    for (i = 0; i < 4; i++) {
+        len += rpm_encode_apdu_object_begin(&apdu[len], OBJECT_ANALOG_INPUT, i);
+        len += rpm_encode_apdu_object_property(
+            &apdu[len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+        len += rpm_encode_apdu_object_property(
+            &apdu[len], PROP_STATUS_FLAGS, BACNET_ARRAY_ALL);
+        len += rpm_encode_apdu_object_property(
+            &apdu[len], PROP_UNITS, BACNET_ARRAY_ALL);
+        len += rpm_encode_apdu_object_end(&apdu[len]);
+    }
+    pcapbench_sample_add(apdu, len, true);
+    len = rpm_ack_encode_apdu_init(apdu, 5);
+    rpmdata.object_type = OBJECT_ANALOG_INPUT;
+    for (i = 0; i < 4; i++) {
+        rpmdata.object_instance = i;
+        len += rpm_ack_encode_apdu_object_begin(&apdu[len], &rpmdata);
+        len += rpm_ack_encode_apdu_object_property(
+            &apdu[len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+        len += rpm_ack_encode_apdu_object_property_value(&apdu[len], value,
+            (unsigned)encode_application_real(value, 20.0f + (float)i));
+        len += rpm_ack_encode_apdu_object_property(
+            &apdu[len], PROP_STATUS_FLAGS, BACNET_ARRAY_ALL);
+        len += rpm_ack_encode_apdu_object_property_value(&apdu[len], value,
+            (unsigned)encode_application_bitstring(value, &bit_string));
+        len += rpm_ack_encode_apdu_object_property(
+            &apdu[len], PROP_UNITS, BACNET_ARRAY_ALL);
+        len += rpm_ack_encode_apdu_object_property_value(&apdu[len], value,
+            (unsigned)encode_application_enumerated(
+                value, UNITS_DEGREES_CELSIUS));
+        len += rpm_ack_encode_apdu_object_end(&apdu[len]);
+    }
+    pcapbench_sample_add(apdu, len, false);
+    /* device discovery */
+    len = whois_encode_apdu(apdu, -1, -1);
+    pcapbench_sample_add(apdu, len, false);
+    len = whois_encode_apdu(apdu, 260000, 260099);
+    pcapbench_sample_add(apdu, len, false);
+    len = iam_encode_apdu(apdu, 260001, MAX_APDU, SEGMENTATION_NONE, 260);
+    pcapbench_sample_add(apdu, len, false);
+    /* change of value of a present value */
+    cov_data.subscriberProcessIdentifier = 1;
+    cov_data.initiatingDeviceIdentifier = 260001;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    cov_data.monitoredObjectIdentifier.instance = 1;
+    cov_data.timeRemaining = 300;
+    cov_data_value_list_link(&cov_data, value_list, 2);
+    (void)cov_value_list_encode_real(
+        value_list, 21.5f, false, false, false, false);
+    len = ucov_notify_encode_apdu(apdu, sizeof(apdu), &cov_data);
+    pcapbench_sample_add(apdu, len, false);
+}
+
+static size_t pcap_u16_encode(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+
+    return 2;
+}
+
+static size_t pcap_u32_encode(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+
+    return 4;
+}
+
+static uint16_t ipv4_checksum(const uint8_t *header, unsigned length)
+{
+    uint32_t sum = 0;
+    unsigned i;
+
+    for (i = 0; i < length; i += 2) {
+        sum += ((uint32_t)header[i] << 8) | header[i + 1];
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+
+    return (uint16_t)~sum;
+}
+
+/**
+ * @brief Save the BACnet/IP packets of the corpus as a libpcap file of
+ *  Ethernet frames, one packet per millisecond
+ * @param pathname - name of the file
+ * @return true if the file was saved
+ */
+static bool pcapbench_file_write(const char *pathname)
+{
+    static const uint8_t mac[12] = { 0x02, 0, 0, 0, 0, 0x02, 0x02, 0, 0, 0,
+        0, 0x01 };
+    uint8_t frame[16 + 14 + 20 + 8 + PCAPBENCH_MPDU_MAX];
+    uint8_t *ip;
+    FILE *pFile;
+    size_t len;
+    unsigned i;
+    bool status = true;
+
+    pFile = fopen(pathname, "wb");
+    if (!pFile) {
+        return false;
+    }
+    len = pcap_u32_encode(&frame[0], 0xa1b2c3d4);
+    len += pcap_u16_encode(&frame[len], 2);
+    len += pcap_u16_encode(&frame[len], 4);
+    len += pcap_u32_encode(&frame[len], 0);
+    len += pcap_u32_encode(&frame[len], 0);
+    len += pcap_u32_encode(&frame[len], 65535);
+    len += pcap_u32_encode(&frame[len], LINKTYPE_ETHERNET);
+    if (fwrite(frame, len, 1, pFile) != 1) {
+        status = false;
+    }
+    for (i = 0; status && (i < Packet_Count); i++) {
+        if (!Packets[i].bvlc) {
+            continue;
+        }
+        /* record header */
+        len = pcap_u32_encode(&frame[0], i / 1000);
+        len += pcap_u32_encode(&frame[len], (i % 1000) * 1000);
+        len += pcap_u32_encode(&frame[len], 14 + 20 + 8 + Packets[i].pdu_len);
+        len += pcap_u32_encode(&frame[len], 14 + 20 + 8 + Packets[i].pdu_len);
+        /* Ethernet */
+        memcpy(&frame[len], mac, sizeof(mac));
+        len += sizeof(mac);
+        len += encode_unsigned16(&frame[len], 0x0800);
+        /* IPv4 */
+        ip = &frame[len];
+        ip[0] = 0x45;
+        ip[1] = 0;
+        (void)encode_unsigned16(
+            &ip[2], (uint16_t)(20 + 8 + Packets[i].pdu_len));
+        (void)encode_unsigned16(&ip[4], (uint16_t)i);
+        (void)encode_unsigned16(&ip[6], 0);
+        ip[8] = 64;
+        ip[9] = 17;
+        (void)encode_unsigned16(&ip[10], 0);
+        ip[12] = 192;
+        ip[13] = 168;
+        ip[14] = 0;
+        ip[15] = 1;
+        ip[16] = 192;
+        ip[17] = 168;
+        ip[18] = 0;
+        ip[19] = 2;
+        (void)encode_unsigned16(&ip[10], ipv4_checksum(ip, 20));
+        len += 20;
+        /* UDP without a checksum */
+        len += encode_unsigned16(&frame[len], PCAPBENCH_UDP_PORT);
+        len += encode_unsigned16(&frame[len], PCAPBENCH_UDP_PORT);
+        len += encode_unsigned16(
+            &frame[len], (uint16_t)(8 + Packets[i].pdu_len));
+        len += encode_unsigned16(&frame[len], 0);
+        memcpy(&frame[len], Packets[i].pdu, Packets[i].pdu_len);
+        len += Packets[i].pdu_len;
+        if (fwrite(frame, len, 1, pFile) != 1) {
+            status = false;
+        }
+    }
+    fclose(pFile);
+
+    return status;
+}
+
+static int pcapbench_packet_compare(const void *a, const void *b)
+{
+    const struct pcapbench_packet *packet_a = a;
+    const struct pcapbench_packet *packet_b = b;
+
+    if (packet_a->key != packet_b->key) {
+        return (packet_a->key < packet_b->key) ? -1 : 1;
+    }
+    if (packet_a->order != packet_b->order) {
+        return (packet_a->order < packet_b->order) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Sort the packets of the corpus into groups of the same service
+ * @return true if the groups were created
+ */
+static bool pcapbench_groups_create(void)
+{
+    struct pcapbench_group *group = NULL;
+    unsigned i;
+
+    qsort(Packets, Packet_Count, sizeof(struct pcapbench_packet),
+        pcapbench_packet_compare);
+    Groups = calloc(Packet_Count, sizeof(struct pcapbench_group));
+    if (!Groups) {
+        return false;
+    }
+    for (i = 0; i < Packet_Count; i++) {
+        if (!group || (group->key != Packets[i].key)) {
+            group = &Groups[Group_Count];
+            Group_Count++;
+            group->key = Packets[i].key;
+            group->index = i;
+        }
+        group->count++;
+        group->octets += Packets[i].pdu_len;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Replay the packets of a group for the number of iterations,
+ *  and keep the fastest of the repeated runs
+ * @return seconds of the fastest run
+ */
+static double pcapbench_group_time(struct pcapbench_group *group, bool encode)
+{
+    double best = 0.0;
+    double seconds;
+    unsigned r, i, n;
+    clock_t start;
+
+    for (r = 0; r < Repeat; r++) {
+        start = clock();
+        for (i = 0; i < Iterations; i++) {
+            for (n = 0; n < group->count; n++) {
+                (void)pcapbench_replay(
+                    &Packets[group->index + n], encode, NULL);
+            }
+        }
+        seconds = clock_seconds(start);
+        if ((r == 0) || (seconds < best)) {
+            best = seconds;
+        }
+    }
+
+    return best;
+}
+
+static void print_result(const char *name,
+    unsigned long packets,
+    unsigned long octets,
+    double decode_seconds,
+    double codec_seconds)
+{
+    double replays = (double)packets * Iterations;
+    double decode_ns = 1e9 * decode_seconds / replays;
+    double codec_ns = 1e9 * codec_seconds / replays;
+    double megabytes = (double)octets * Iterations / decode_seconds / 1e6;
+
+    if (CSV_Output) {
+        printf("%s,%lu,%lu,%.2f,%.2f,%.2f\n", name, packets, octets,
+            decode_ns, codec_ns, megabytes);
+    } else {
+        printf("%-36s %8lu %10lu %10.2f %10.2f %8.2f\n", name, packets,
+            octets, decode_ns, codec_ns, megabytes);
+    }
+}
+
+static void pcapbench_report(void)
+{
+    struct pcapbench_group *group;
+    char name[80];
+    unsigned long packets = 0;
+    unsigned long octets = 0;
+    double decode_seconds = 0.0;
+    double codec_seconds = 0.0;
+    unsigned i;
+
+    if (CSV_Output) {
+        printf("service,packets,octets,decode_ns,codec_ns,mb_per_s\n");
+    } else {
+        printf("%-36s %8s %10s %10s %10s %8s\n", "service", "packets",
+            "octets", "decode ns", "codec ns", "MB/s");
+    }
+    for (i = 0; i < Group_Count; i++) {
+        group = &Groups[i];
+        group->decode_seconds = pcapbench_group_time(group, false);
+        group->codec_seconds = pcapbench_group_time(group, true);
+        pcapbench_key_name(group->key, name);
+        print_result(name, group->count, group->octets, group->decode_seconds,
+            group->codec_seconds);
+        packets += group->count;
+        octets += group->octets;
+        decode_seconds += group->decode_seconds;
+        codec_seconds += group->codec_seconds;
+    }
+    if (packets) {
+        print_result("total", packets, octets, decode_seconds, codec_seconds);
+    }
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--iterations N][--repeat N][--csv]\n", filename);
+    printf("       [--write pathname][pathname ...]\n");
+    printf("       [--version][--help]\n");
+}
+
+static void print_help(const char *filename)
+{
+    printf("Benchmark of the BACnet BVLC, NPDU, and APDU decoders, and of\n"
+           "the service decoders and encoders, that replays the packets\n"
+           "of capture files. Reports the nanoseconds per packet to decode\n"
+           "each service, and to decode and encode it again (codec), and\n"
+           "the megabytes per second that are decoded.\n");
+    printf("\n");
+    printf("pathname:\n"
+           "libpcap or pcapng file of MS/TP frames, such as from mstpcap,\n"
+           "or of BACnet/IP or BACnet/Ethernet frames. Without a file,\n"
+           "a built-in corpus of common services is replayed.\n");
+    printf("--iterations N\n"
+           "Number of times every packet is replayed. 1000 is default.\n");
+    printf("--repeat N\n"
+           "Number of runs of every service, of which the fastest is\n"
+           "reported. 3 is default.\n");
+    printf("--csv\n"
+           "Report in comma separated values.\n");
+    printf("--write pathname\n"
+           "Save the BACnet/IP packets of the corpus as a libpcap file.\n");
+    printf("\nExample:\n"
+           "%s --iterations 10000 mstp_20230101120000.cap\n",
+        filename);
+}
+
+int main(int argc, char *argv[])
+{
+    char *filename = NULL;
+    const char *write_pathname = NULL;
+    unsigned files = 0;
+    unsigned i;
+    int argi = 0;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2023 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+    }
+    for (argi = 1; argi < argc; argi++) {
+        if ((strcmp(argv[argi], "--iterations") == 0) && (++argi < argc)) {
+            Iterations = strtoul(argv[argi], NULL, 0);
+        } else if ((strcmp(argv[argi], "--repeat") == 0) && (++argi < argc)) {
+            Repeat = strtoul(argv[argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--csv") == 0) {
+            CSV_Output = true;
+        } else if ((strcmp(argv[argi], "--write") == 0) && (++argi < argc)) {
+            write_pathname = argv[argi];
+        } else if (argv[argi][0] == '-') {
+            print_usage(filename);
+            return 1;
+        } else {
+            if (!pcapbench_file_load(argv[argi])) {
+                fprintf(stderr, "%s: unable to load %s\n", filename,
+                    argv[argi]);
+                return 1;
+            }
+            files++;
+        }
+    }
+    if (Iterations < 1) {
+        Iterations = 1;
+    }
+    if (Repeat < 1) {
+        Repeat = 1;
+    }
+    if (files == 0) {
+        pcapbench_corpus_create();
+    }
+    if (write_pathname && !pcapbench_file_write(write_pathname)) {
+        fprintf(stderr, "%s: unable to write %s\n", filename, write_pathname);
+        return 1;
+    }
+    if (Packet_Count == 0) {
+        fprintf(stderr, "%s: no BACnet packets to replay\n", filename);
+        return 1;
+    }
+    if (!pcapbench_groups_create()) {
+        fprintf(stderr, "%s: out of memory\n", filename);
+        return 1;
+    }
+    if (!CSV_Output) {
+        printf("corpus: %u packets in %u services, %u frames skipped\n",
+            Packet_Count, Group_Count, Packets_Skipped);
+    }
+    pcapbench_report();
+    for (i = 0; i < Packet_Count; i++) {
+        free(Packets[i].pdu);
+    }
+    free(Packets);
+    free(Groups);
+
+    return 0;
+}
@@ -101,8 +101,8 @@ uint8_t Send_Private_Transfer_Request(uint32_t device_id,
             if ((unsigned)pdu_len < max_apdu) {
                 tsm_set_confirmed_unsegmented_transaction(invoke_id, &dest,
                     &npdu_data, &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
-                bytes_sent = datalink_send_pdu(
-                    &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+                bytes_sent = tsm_send_pdu(invoke_id, &dest, &npdu_data,
+                    &Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
                 if (bytes_sent <= 0)
                     fprintf(stderr,
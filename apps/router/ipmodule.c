@@ -47,6 +47,7 @@ void *dl_ip_thread(void *pArgs)
     MSG_DATA *msg_data;
     ROUTER_PORT *port = (ROUTER_PORT *)pArgs;
     IP_DATA ip_data; /* port specific parameters */
+    PORT_QUEUE queue; /* messages waiting to be sent */
     BACNET_ADDRESS address = { 0 };
     int status;
     uint8_t shutdown = 0;
@@ -74,6 +75,7 @@ void *dl_ip_thread(void *pArgs)
     }
 
     port->port_id = msgboxid;
+    port_queue_init(&queue);
     port->state = RUNNING;
 
     while (!shutdown) {
@@ -83,17 +85,9 @@ void *dl_ip_thread(void *pArgs)
         if (bacmsg) {
             switch (bacmsg->type) {
                 case DATA: {
-                    msg_data = (MSG_DATA *)bacmsg->data;
-                    memmove(&address.net, &msg_data->dest.net, 2);
-                    memmove(&address.mac_len, &msg_data->dest.len, 1);
-                    memmove(
-                        &address.mac[0], &msg_data->dest.adr[0], MAX_MAC_LEN);
-
-                    dl_ip_send(
-                        &ip_data, &address, msg_data->pdu, msg_data->pdu_len);
-
-                    check_data(msg_data);
-
+                    /* sent when the message box is empty, highest
+                       priority first */
+                    (void)port_queue_put(&queue, (MSG_DATA *)bacmsg->data);
                     break;
                 }
 
@@ -113,6 +107,17 @@ void *dl_ip_thread(void *pArgs)
                     break;
             }
         } else {
+            while ((msg_data = port_queue_peek(&queue))) {
+                memmove(&address.net, &msg_data->dest.net, 2);
+                memmove(&address.mac_len, &msg_data->dest.len, 1);
+                memmove(&address.mac[0], &msg_data->dest.adr[0], MAX_MAC_LEN);
+
+                dl_ip_send(
+                    &ip_data, &address, msg_data->pdu, msg_data->pdu_len);
+
+                port_queue_pop(&queue);
+                check_data(msg_data);
+            }
             status = dl_ip_recv(&ip_data, &msg_data, &address, 5);
             if (status > 0) {
                 memmove(&msg_data->src.len, &address.mac_len, 1);
@@ -129,6 +134,7 @@ void *dl_ip_thread(void *pArgs)
     }
 
     /* cleanup procedure */
+    port_queue_cleanup(&queue);
     dl_ip_cleanup(&ip_data);
     port->state = FINISHED;
     return NULL;
@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include "msgqueue.h"
+#include "bacnet/basic/sys/mstimer.h"
 
 pthread_mutex_t msg_lock = PTHREAD_MUTEX_INITIALIZER;
 
@@ -100,3 +101,59 @@ void check_data(MSG_DATA *data)
     }
     pthread_mutex_unlock(&msg_lock);
 }
+
+void port_queue_init(PORT_QUEUE *pq)
+{
+    priority_queue_init(&pq->queue, pq->elements, sizeof(PORT_QUEUE_ELEMENT),
+        PORT_QUEUE_COUNT);
+}
+
+bool port_queue_put(PORT_QUEUE *pq, MSG_DATA *data)
+{
+    PORT_QUEUE_ELEMENT *element;
+    unsigned priority = MESSAGE_PRIORITY_NORMAL;
+
+    /* the priority is in the NPDU control octet */
+    if ((data->pdu_len >= 2) && (data->pdu[0] == BACNET_PROTOCOL_VERSION)) {
+        priority = data->pdu[1] & 0x03;
+    }
+    element = priority_queue_data_peek(&pq->queue, priority);
+    if (element) {
+        element->data = data;
+        if (priority_queue_data_put(
+                &pq->queue, priority, element, mstimer_now())) {
+            return true;
+        }
+    }
+    /* the level is full */
+    check_data(data);
+
+    return false;
+}
+
+MSG_DATA *port_queue_peek(PORT_QUEUE *pq)
+{
+    PORT_QUEUE_ELEMENT *element;
+
+    element = priority_queue_peek(&pq->queue, NULL);
+    if (element) {
+        return element->data;
+    }
+
+    return NULL;
+}
+
+void port_queue_pop(PORT_QUEUE *pq)
+{
+    (void)priority_queue_pop(&pq->queue, mstimer_now());
+}
+
+void port_queue_cleanup(PORT_QUEUE *pq)
+{
+    MSG_DATA *data;
+
+    while ((data = port_queue_peek(pq))) {
+        port_queue_pop(pq);
+        check_data(data);
+    }
+}
@@ -36,6 +36,7 @@
 #include <sys/msg.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/npdu.h"
+#include "bacnet/basic/sys/priority_queue.h"
 
 extern pthread_mutex_t msg_lock;
 
@@ -71,6 +72,20 @@ typedef struct _msg_data {
     uint8_t ref_count;
 } MSG_DATA;
 
+/* messages waiting in a router port for their datalink, in each level
+   of the network message priority */
+#define PORT_QUEUE_COUNT 16
+
+typedef struct _port_queue_element {
+    PRIORITY_QUEUE_ELEMENT header;
+    MSG_DATA *data;
+} PORT_QUEUE_ELEMENT;
+
+typedef struct _port_queue {
+    PRIORITY_QUEUE queue;
+    PORT_QUEUE_ELEMENT elements[PRIORITY_QUEUE_LEVELS * PORT_QUEUE_COUNT];
+} PORT_QUEUE;
+
 MSGBOX_ID create_msgbox(
     );
 
@@ -96,4 +111,23 @@ void free_data(
 void check_data(
     MSG_DATA * data);
 
+void port_queue_init(
+    PORT_QUEUE * pq);
+
+/* returns false if the message was dropped */
+bool port_queue_put(
+    PORT_QUEUE * pq,
+    MSG_DATA * data);
+
+/* returns the message that is sent next, highest priority first */
+MSG_DATA *port_queue_peek(
+    PORT_QUEUE * pq);
+
+void port_queue_pop(
+    PORT_QUEUE * pq);
+
+/* drop the messages that were not sent */
+void port_queue_cleanup(
+    PORT_QUEUE * pq);
+
 #endif /* end of MSGQUEUE_H */
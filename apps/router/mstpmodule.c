@@ -47,8 +47,11 @@ void *dl_mstp_thread(void *pArgs)
     ROUTER_PORT *port = (ROUTER_PORT *)pArgs;
     struct mstp_port_struct_t mstp_port = { (MSTP_RECEIVE_STATE)0 };
     volatile SHARED_MSTP_DATA shared_port_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[DLMSTP_MPDU_MAX] = { 0 };
     uint16_t pdu_len;
     uint8_t shutdown = 0;
+    PORT_QUEUE queue; /* messages waiting to be sent */
 
     shared_port_data.Treply_timeout = 260;
     shared_port_data.MSTP_Packets = 0;
@@ -102,6 +105,7 @@ void *dl_mstp_thread(void *pArgs)
         return NULL;
     }
 
+    port_queue_init(&queue);
     port->state = RUNNING;
 
     while (!shutdown) {
@@ -114,20 +118,9 @@ void *dl_mstp_thread(void *pArgs)
         if (bacmsg) {
             switch (bacmsg->type) {
                 case DATA:
-                    msg_data = (MSG_DATA *)bacmsg->data;
-
-                    if (msg_data->dest.net == BACNET_BROADCAST_NETWORK) {
-                        dlmstp_get_broadcast_address(&(msg_data->dest));
-                    } else {
-                        msg_data->dest.mac[0] = msg_data->dest.adr[0];
-                        msg_data->dest.mac_len = 1;
-                    }
-
-                    dlmstp_send_pdu(&mstp_port, &(msg_data->dest),
-                        msg_data->pdu, msg_data->pdu_len);
-
-                    check_data(msg_data);
-
+                    /* sent as the token comes around, highest
+                       priority first */
+                    (void)port_queue_put(&queue, (MSG_DATA *)bacmsg->data);
                     break;
                 case SERVICE:
                     switch (bacmsg->subtype) {
@@ -143,19 +136,35 @@ void *dl_mstp_thread(void *pArgs)
                     break;
             }
         } else {
-            pdu_len = dlmstp_receive(&mstp_port, NULL, NULL, 0, 5);
+            /* only the frames of the next token are given to the
+               datalink, so that the rest may still be passed by a
+               higher priority message */
+            while ((dlmstp_send_pdu_queue_count(&mstp_port) <
+                       dlmstp_max_info_frames(&mstp_port)) &&
+                (msg_data = port_queue_peek(&queue))) {
+                if (msg_data->dest.net == BACNET_BROADCAST_NETWORK) {
+                    dlmstp_get_broadcast_address(&(msg_data->dest));
+                } else {
+                    msg_data->dest.mac[0] = msg_data->dest.adr[0];
+                    msg_data->dest.mac_len = 1;
+                }
+
+                dlmstp_send_pdu(&mstp_port, &(msg_data->dest), msg_data->pdu,
+                    msg_data->pdu_len);
+
+                port_queue_pop(&queue);
+                check_data(msg_data);
+            }
+            pdu_len = dlmstp_receive(
+                &mstp_port, &src, &pdu[0], sizeof(pdu), 5);
 
             if (pdu_len > 0) {
                 msg_data = (MSG_DATA *)malloc(sizeof(MSG_DATA));
-                memmove(&(msg_data->src),
-                    (const void *)&(shared_port_data.Receive_Packet.address),
-                    sizeof(shared_port_data.Receive_Packet.address));
+                memmove(&(msg_data->src), &src, sizeof(src));
                 msg_data->src.adr[0] = msg_data->src.mac[0];
                 msg_data->src.len = 1;
                 msg_data->pdu = (uint8_t *)malloc(pdu_len);
-                memmove(msg_data->pdu,
-                    (const void *)&(shared_port_data.Receive_Packet.pdu),
-                    pdu_len);
+                memmove(msg_data->pdu, &pdu[0], pdu_len);
                 msg_data->pdu_len = pdu_len;
 
                 msg_storage.type = DATA;
@@ -170,6 +179,7 @@ void *dl_mstp_thread(void *pArgs)
         }
     }
 
+    port_queue_cleanup(&queue);
     dlmstp_cleanup(&mstp_port);
     port->state = FINISHED;
 
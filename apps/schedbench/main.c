@@ -0,0 +1,263 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Benchmark of the Schedule object evaluation
+ *
+ * @section DESCRIPTION
+ *
+ * Runs many Schedule objects with weekly and exception schedules over
+ * a number of simulated days.  Compares polling every schedule with
+ * Schedule_Recalculate_PV() at an interval with evaluating each schedule
+ * from its compiled timeline only at its next transition, and reports
+ * the wakeups, evaluations, and CPU time of each.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/datetime.h"
+#include "bacnet/version.h"
+#include "bacnet/basic/object/schedule.h"
+#include "bacnet/basic/sys/filename.h"
+
+static unsigned Schedule_Total = 10000;
+static unsigned Poll_Interval = 60;
+static unsigned Days = 1;
+static SCHEDULE_DESCR *Schedules;
+
+static double clock_seconds(clock_t start)
+{
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    return (seconds > 0.0) ? seconds : 1e-9;
+}
+
+static void print_result(const char *name,
+    unsigned long wakeups,
+    unsigned long evaluations,
+    double cpu)
+{
+    printf("%-10s %10lu %12lu %12.1f %16.2f\n", name, wakeups, evaluations,
+        1e3 * cpu, 1e6 * cpu / ((double)Schedule_Total * Days));
+}
+
+static void time_value_set(BACNET_OBJ_DAILY_SCHEDULE *day,
+    uint8_t hour,
+    uint8_t minute,
+    float value)
+{
+    BACNET_TIME_VALUE *time_value = &day->Time_Values[day->TV_Count];
+
+    datetime_set_time(&time_value->Time, hour, minute, 0, 0);
+    time_value->Value.tag = BACNET_APPLICATION_TAG_REAL;
+    time_value->Value.type.Real = value;
+    day->TV_Count++;
+}
+
+/**
+ * @brief Configure the schedules as an office building, with the
+ *  occupied times staggered, and a holiday in every fourth schedule
+ */
+static void schedules_init(void)
+{
+    SCHEDULE_DESCR *desc;
+    BACNET_OBJ_SPECIAL_EVENT *event;
+    unsigned i, d;
+    uint8_t minute;
+
+    for (i = 0; i < Schedule_Total; i++) {
+        desc = &Schedules[i];
+        datetime_set_date(&desc->Start_Date, BACNET_DATE_YEAR_EPOCH + 0xFF,
+            1, 1);
+        datetime_set_date(&desc->End_Date, BACNET_DATE_YEAR_EPOCH + 0xFF,
+            12, 31);
+        desc->Schedule_Default.tag = BACNET_APPLICATION_TAG_REAL;
+        desc->Schedule_Default.type.Real = 16.0f;
+        memcpy(&desc->Present_Value, &desc->Schedule_Default,
+            sizeof(desc->Present_Value));
+        desc->Priority_For_Writing = 16;
+        minute = (uint8_t)(i % 60);
+        for (d = 0; d < 5; d++) {
+            time_value_set(&desc->Weekly_Schedule[d], 6, minute, 21.0f);
+            time_value_set(&desc->Weekly_Schedule[d], 12, minute, 20.0f);
+            time_value_set(&desc->Weekly_Schedule[d], 13, minute, 21.0f);
+            time_value_set(&desc->Weekly_Schedule[d], 18, minute, 16.0f);
+        }
+        time_value_set(&desc->Weekly_Schedule[5], 8, minute, 19.0f);
+        time_value_set(&desc->Weekly_Schedule[5], 12, minute, 16.0f);
+        if ((i % 4) == 0) {
+            /* a holiday on the first Monday of the simulation */
+            event = &desc->Exception_Schedule[0];
+            event->Calendar_Entry_Tag = BACNET_CALENDAR_DATE;
+            datetime_set_date(&event->Calendar_Entry.Date, 2023, 1, 2);
+            event->Event_Priority = 8;
+            time_value_set(&event->Day_Schedule, 0, 0, 14.0f);
+            desc->Exception_Count = 1;
+        }
+        Schedule_Timeline_Invalidate(desc);
+    }
+}
+
+/**
+ * @brief Poll every schedule at the interval, rescanning the time values
+ */
+static void schedbench_polled(bacnet_time_t start_seconds)
+{
+    BACNET_DATE_TIME bdatetime;
+    bacnet_time_t seconds, end_seconds;
+    unsigned long wakeups = 0, evaluations = 0;
+    unsigned i;
+    double cpu;
+    clock_t start;
+
+    end_seconds = start_seconds + ((bacnet_time_t)Days * 24UL * 3600UL);
+    start = clock();
+    for (seconds = start_seconds; seconds < end_seconds;
+         seconds += Poll_Interval) {
+        datetime_since_epoch_seconds(&bdatetime, seconds);
+        wakeups++;
+        for (i = 0; i < Schedule_Total; i++) {
+            if (Schedule_In_Effective_Period(&Schedules[i], &bdatetime.date)) {
+                Schedule_Recalculate_PV(&Schedules[i],
+                    (BACNET_WEEKDAY)bdatetime.date.wday, &bdatetime.time);
+                evaluations++;
+            }
+        }
+    }
+    cpu = clock_seconds(start);
+    print_result("polled", wakeups, evaluations, cpu);
+}
+
+/**
+ * @brief Sleep until the next transition of any schedule, and evaluate
+ *  only the schedules at their next transition from their timeline
+ */
+static void schedbench_timeline(bacnet_time_t start_seconds)
+{
+    BACNET_DATE_TIME bdatetime;
+    bacnet_time_t seconds, end_seconds, next_seconds;
+    unsigned long wakeups = 0, evaluations = 0, changes = 0;
+    unsigned i;
+    double cpu;
+    clock_t start;
+
+    end_seconds = start_seconds + ((bacnet_time_t)Days * 24UL * 3600UL);
+    start = clock();
+    seconds = start_seconds;
+    while (seconds < end_seconds) {
+        datetime_since_epoch_seconds(&bdatetime, seconds);
+        wakeups++;
+        next_seconds = end_seconds;
+        for (i = 0; i < Schedule_Total; i++) {
+            if (seconds >= Schedules[i].Next_Transition) {
+                if (Schedule_Timeline_Evaluate(&Schedules[i], &bdatetime)) {
+                    changes++;
+                }
+                evaluations++;
+            }
+            if (Schedules[i].Next_Transition < next_seconds) {
+                next_seconds = Schedules[i].Next_Transition;
+            }
+        }
+        seconds = next_seconds;
+    }
+    cpu = clock_seconds(start);
+    print_result("timeline", wakeups, evaluations, cpu);
+    printf("%lu changes of Present_Value\n", changes);
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--schedules N][--interval seconds][--days N]\n",
+        filename);
+    printf("       [--version][--help]\n");
+}
+
+static void print_help(const char *filename)
+{
+    (void)filename;
+    printf("Benchmark of the Schedule object evaluation, polled at an\n"
+           "interval versus at the next transition of a compiled timeline.\n");
+    printf("\n");
+    printf("--schedules N\n"
+           "Number of Schedule objects. 10000 is default.\n");
+    printf("--interval seconds\n"
+           "Interval of the polled evaluation. 60 is default.\n");
+    printf("--days N\n"
+           "Number of simulated days. 1 is default.\n");
+}
+
+int main(int argc, char *argv[])
+{
+    char *filename = NULL;
+    BACNET_DATE_TIME bdatetime;
+    bacnet_time_t start_seconds;
+    int argi = 0;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2023 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if ((strcmp(argv[argi], "--schedules") == 0) && (++argi < argc)) {
+            Schedule_Total = strtoul(argv[argi], NULL, 0);
+        } else if ((strcmp(argv[argi], "--interval") == 0) &&
+            (++argi < argc)) {
+            Poll_Interval = strtoul(argv[argi], NULL, 0);
+        } else if ((strcmp(argv[argi], "--days") == 0) && (++argi < argc)) {
+            Days = strtoul(argv[argi], NULL, 0);
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if (Schedule_Total < 1) {
+        Schedule_Total = 1;
+    }
+    if (Poll_Interval < 1) {
+        Poll_Interval = 1;
+    }
+    if (Days < 1) {
+        Days = 1;
+    }
+    Schedules = calloc(Schedule_Total, sizeof(SCHEDULE_DESCR));
+    if (!Schedules) {
+        fprintf(stderr, "%s: out of memory\n", filename);
+        return 1;
+    }
+    /* Monday, January 2, 2023 */
+    datetime_set_values(&bdatetime, 2023, 1, 2, 0, 0, 0, 0);
+    start_seconds = datetime_seconds_since_epoch(&bdatetime);
+    printf("%u schedules for %u days\n", Schedule_Total, Days);
+    printf("%-10s %10s %12s %12s %16s\n", "method", "wakeups",
+        "evaluations", "cpu ms", "us/schedule/day");
+    schedules_init();
+    schedbench_polled(start_seconds);
+    schedules_init();
+    schedbench_timeline(start_seconds);
+    free(Schedules);
+
+    return 0;
+}
@@ -41,13 +41,19 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/datalink/dlenv.h"
 #include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/sys/metrics.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/snapshot.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/binding/address.h"
 /* include the device object */
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/ao.h"
+#include "bacnet/basic/object/bo.h"
 #include "bacnet/basic/object/lc.h"
+#include "bacnet/basic/object/schedule.h"
 #include "bacnet/basic/object/trendlog.h"
 #if defined(INTRINSIC_REPORTING)
 #include "bacnet/basic/object/nc.h"
@@ -58,6 +64,11 @@
 #if defined(BAC_UCI)
 #include "bacnet/basic/ucix/ucix.h"
 #endif /* defined(BAC_UCI) */
+#if defined(BACDL_BIP)
+#ifndef BBMD_ENABLED
+#define BBMD_ENABLED 1
+#endif
+#endif
 
 /** @file server/main.c  Example server application using the BACnet Stack. */
 
@@ -71,6 +82,61 @@ static const char *BACnet_Version = BACNET_VERSION_TEXT;
 
 /** Buffer used for receiving */
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+/** optional file for the warm start snapshot */
+static const char *Snapshot_Filename;
+#if defined(BACNET_METRICS) && defined(__linux__)
+/** optional shared memory snapshot of the performance counters */
+static METRICS_SHARED_DATA *Metrics_Shared;
+#endif
+
+/** Save the warm start snapshot when exiting */
+static void Snapshot_Cleanup(void)
+{
+    if (Snapshot_Filename) {
+        (void)snapshot_file_save(Snapshot_Filename);
+    }
+}
+
+/** Register the sections of the warm start snapshot, and restore them
+ * from the snapshot file, if any.
+ * @param filename - name of the snapshot file
+ */
+static void Snapshot_Init(const char *filename)
+{
+    uint32_t count;
+
+    snapshot_init();
+    snapshot_section_register(SNAPSHOT_SECTION_ADDRESS_CACHE,
+        ADDRESS_SNAPSHOT_VERSION, ADDRESS_SNAPSHOT_RECORD_SIZE,
+        address_snapshot_count, address_snapshot_encode,
+        address_snapshot_restore);
+    snapshot_section_register(SNAPSHOT_SECTION_COV_SUBSCRIPTIONS,
+        HANDLER_COV_SNAPSHOT_VERSION, HANDLER_COV_SNAPSHOT_RECORD_SIZE,
+        handler_cov_snapshot_count, handler_cov_snapshot_encode,
+        handler_cov_snapshot_restore);
+#if defined(BACDL_BIP) && BBMD_ENABLED
+    snapshot_section_register(SNAPSHOT_SECTION_BDT,
+        BVLC_BDT_SNAPSHOT_VERSION, BACNET_IP_BDT_ENTRY_SIZE,
+        bvlc_bdt_snapshot_count, bvlc_bdt_snapshot_encode,
+        bvlc_bdt_snapshot_restore);
+    snapshot_section_register(SNAPSHOT_SECTION_FDT,
+        BVLC_FDT_SNAPSHOT_VERSION, BACNET_IP_FDT_ENTRY_SIZE,
+        bvlc_fdt_snapshot_count, bvlc_fdt_snapshot_encode,
+        bvlc_fdt_snapshot_restore);
+#endif
+    snapshot_section_register(SNAPSHOT_SECTION_ANALOG_OUTPUT,
+        ANALOG_OUTPUT_SNAPSHOT_VERSION, ANALOG_OUTPUT_SNAPSHOT_RECORD_SIZE,
+        Analog_Output_Snapshot_Count, Analog_Output_Snapshot_Encode,
+        Analog_Output_Snapshot_Restore);
+    snapshot_section_register(SNAPSHOT_SECTION_BINARY_OUTPUT,
+        BINARY_OUTPUT_SNAPSHOT_VERSION, BINARY_OUTPUT_SNAPSHOT_RECORD_SIZE,
+        Binary_Output_Snapshot_Count, Binary_Output_Snapshot_Encode,
+        Binary_Output_Snapshot_Restore);
+    count = snapshot_file_load(filename);
+    printf("Restored %lu records from %s\n", (unsigned long)count, filename);
+    Snapshot_Filename = filename;
+    atexit(Snapshot_Cleanup);
+}
 
 /** Initialize the handlers we will utilize.
  * @see Device_Init, apdu_set_unconfirmed_handler, apdu_set_confirmed_handler
@@ -111,6 +177,10 @@ static void Init_Service_Handlers(void)
         SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, handler_write_property_multiple);
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_READ_RANGE, handler_read_range);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_CREATE_OBJECT, handler_create_object);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_DELETE_OBJECT, handler_delete_object);
 #if defined(BACFILE)
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_ATOMIC_READ_FILE, handler_atomic_read_file);
@@ -140,6 +210,13 @@ static void Init_Service_Handlers(void)
         SERVICE_CONFIRMED_GET_EVENT_INFORMATION, handler_get_event_information);
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_GET_ALARM_SUMMARY, handler_get_alarm_summary);
+    /* the answers to our confirmed event notifications */
+    apdu_set_confirmed_simple_ack_handler(SERVICE_CONFIRMED_EVENT_NOTIFICATION,
+        Notification_Class_Event_Ack_Handler);
+    apdu_set_error_handler(SERVICE_CONFIRMED_EVENT_NOTIFICATION,
+        Notification_Class_Event_Error_Handler);
+    apdu_set_reject_handler(Notification_Class_Event_Reject_Handler);
+    apdu_set_abort_handler(Notification_Class_Event_Abort_Handler);
 #endif /* defined(INTRINSIC_REPORTING) */
 #if defined(BACNET_TIME_MASTER)
     handler_timesync_init();
@@ -167,6 +244,22 @@ static void print_help(const char *filename)
     printf("To simulate Device 123 named Fred, use following command:\n"
            "%s 123 Fred\n",
         filename);
+    printf("\nTo spread the I-Am responses to Who-Is over a random\n"
+           "delay of up to 500ms, and answer each source at most once\n"
+           "every 2 seconds, set the following environment variables:\n"
+           "BACNET_IAM_WINDOW=500 BACNET_IAM_SOURCE_INTERVAL=2000 %s\n",
+        filename);
+    printf("\nTo restore the address cache, COV subscriptions, BDT, FDT,\n"
+           "and priority arrays at startup, and save them periodically,\n"
+           "set the following environment variable:\n"
+           "BACNET_SNAPSHOT_FILE=server.snapshot %s\n",
+        filename);
+#if defined(BACNET_METRICS) && defined(__linux__)
+    printf("\nTo share the performance counters each second with bacmetrics,\n"
+           "set the following environment variable:\n"
+           "BACNET_METRICS_FILE=/dev/shm/bacserv.metrics %s\n",
+        filename);
+#endif
 }
 
 /** Main function of server demo.
@@ -191,6 +284,8 @@ int main(int argc, char *argv[])
     uint32_t elapsed_seconds = 0;
     uint32_t elapsed_milliseconds = 0;
     uint32_t address_binding_tmr = 0;
+    uint32_t schedule_seconds = 0;
+    BACNET_DATE_TIME schedule_datetime;
     BACNET_CHARACTER_STRING DeviceName;
 #if defined(INTRINSIC_REPORTING)
     uint32_t recipient_scan_tmr = 0;
@@ -204,6 +299,11 @@ int main(int argc, char *argv[])
 #endif
     int argi = 0;
     const char *filename = NULL;
+    char *pEnv = NULL;
+    uint16_t who_is_window = 0;
+    uint16_t who_is_source_interval = 0;
+    unsigned long last_milliseconds = 0;
+    unsigned long current_milliseconds = 0;
 
     filename = filename_remove_path(argv[0]);
     for (argi = 1; argi < argc; argi++) {
@@ -273,8 +373,34 @@ int main(int argc, char *argv[])
 
     dlenv_init();
     atexit(datalink_cleanup);
+    /* optionally spread the I-Am responses to Who-Is storms */
+    pEnv = getenv("BACNET_IAM_WINDOW");
+    if (pEnv) {
+        who_is_window = (uint16_t)strtol(pEnv, NULL, 0);
+    }
+    pEnv = getenv("BACNET_IAM_SOURCE_INTERVAL");
+    if (pEnv) {
+        who_is_source_interval = (uint16_t)strtol(pEnv, NULL, 0);
+    }
+    handler_who_is_scheduler_init(who_is_window, who_is_source_interval);
+    /* optionally warm start from a snapshot file */
+    pEnv = getenv("BACNET_SNAPSHOT_FILE");
+    if (pEnv) {
+        Snapshot_Init(pEnv);
+    }
+#if defined(BACNET_METRICS) && defined(__linux__)
+    metrics_timer_set(metrics_microseconds);
+    pEnv = getenv("BACNET_METRICS_FILE");
+    if (pEnv) {
+        Metrics_Shared = metrics_shared_map(pEnv, true);
+        if (!Metrics_Shared) {
+            fprintf(stderr, "Unable to share the metrics in %s\n", pEnv);
+        }
+    }
+#endif
     /* configure the timeout values */
     last_seconds = time(NULL);
+    last_milliseconds = mstimer_now();
     /* broadcast an I-Am on startup */
     Send_I_Am(&Handler_Transmit_Buffer[0]);
     /* loop forever */
@@ -299,8 +425,23 @@ int main(int argc, char *argv[])
             Load_Control_State_Machine_Handler();
             elapsed_milliseconds = elapsed_seconds * 1000;
             handler_cov_timer_seconds(elapsed_seconds);
+            snapshot_file_timer(Snapshot_Filename, (uint16_t)elapsed_seconds);
+#if defined(BACNET_METRICS) && defined(__linux__)
+            metrics_shared_update(Metrics_Shared);
+#endif
             tsm_timer_milliseconds(elapsed_milliseconds);
             trend_log_timer(elapsed_seconds);
+            /* evaluate the schedules at their next transition, and at
+               least every minute to notice a change of the clock */
+            if (elapsed_seconds >= schedule_seconds) {
+                Device_getCurrentDateTime(&schedule_datetime);
+                schedule_seconds = Schedule_Task(&schedule_datetime);
+                if (schedule_seconds > 60) {
+                    schedule_seconds = 60;
+                }
+            } else {
+                schedule_seconds -= elapsed_seconds;
+            }
 #if defined(INTRINSIC_REPORTING)
             Device_local_reporting();
 #endif
@@ -310,6 +451,12 @@ int main(int argc, char *argv[])
 #endif
         }
         handler_cov_task();
+        current_milliseconds = mstimer_now();
+        if (current_milliseconds != last_milliseconds) {
+            handler_who_is_timer(
+                (uint16_t)(current_milliseconds - last_milliseconds));
+            last_milliseconds = current_milliseconds;
+        }
         /* scan cache address */
         address_binding_tmr += elapsed_seconds;
         if (address_binding_tmr >= 60) {
@@ -323,6 +470,8 @@ int main(int argc, char *argv[])
             Notification_Class_find_recipient();
             recipient_scan_tmr = 0;
         }
+        /* deliver queued confirmed event notifications */
+        Notification_Class_Event_Queue_Task();
 #endif
         /* output */
 
@@ -0,0 +1,183 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Benchmark of the BACnet text name and value lookups
+ *
+ * @section DESCRIPTION
+ *
+ * Converts every name of the object type, property, and engineering
+ * unit lists to its value, and every value to its name, many times over,
+ * with the linear search of the list and with the sorted index that the
+ * bactext lookups use, and reports the lookups per second of each.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/bactext.h"
+#include "bacnet/indtext.h"
+#include "bacnet/version.h"
+#include "bacnet/basic/sys/filename.h"
+
+/* the lists are not in the header */
+extern INDTEXT_DATA bacnet_object_type_names[];
+extern INDTEXT_DATA bacnet_property_names[];
+extern INDTEXT_DATA bacnet_engineering_unit_names[];
+
+/* one list, and the bactext lookups that use its sorted index */
+struct textbench_list {
+    const char *name;
+    INDTEXT_DATA *data_list;
+    bool (*by_name)(const char *search_name, unsigned *found_index);
+    const char *(*by_value)(unsigned index);
+};
+
+static const char *property_name(unsigned index)
+{
+    return bactext_property_name_default(index, NULL);
+}
+
+static struct textbench_list Lists[] = {
+    { "object-type", bacnet_object_type_names, bactext_object_type_index,
+        bactext_object_type_name },
+    { "property", bacnet_property_names, bactext_property_index,
+        property_name },
+    { "engineering-unit", bacnet_engineering_unit_names,
+        bactext_engineering_unit_index, bactext_engineering_unit_name }
+};
+
+static unsigned Iterations = 1000;
+/* keeps the compiler from removing the lookups */
+static volatile unsigned long Checksum;
+
+static double clock_seconds(clock_t start)
+{
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    return (seconds > 0.0) ? seconds : 1e-9;
+}
+
+/**
+ * @brief Look up every name, and every value, of a list many times
+ * @param list - the list to benchmark
+ */
+static void textbench_list(struct textbench_list *list)
+{
+    INDTEXT_DATA *entry;
+    unsigned long lookups = 0;
+    unsigned i, value = 0;
+    double linear, sorted;
+    clock_t start;
+
+    for (entry = list->data_list; entry->pString; entry++) {
+        lookups++;
+    }
+    lookups *= Iterations;
+    /* name to value */
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        for (entry = list->data_list; entry->pString; entry++) {
+            indtext_by_istring(list->data_list, entry->pString, &value);
+            Checksum += value;
+        }
+    }
+    linear = lookups / clock_seconds(start);
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        for (entry = list->data_list; entry->pString; entry++) {
+            list->by_name(entry->pString, &value);
+            Checksum += value;
+        }
+    }
+    sorted = lookups / clock_seconds(start);
+    printf("%-16s name to value %12.0f %12.0f %8.1fx\n", list->name, linear,
+        sorted, sorted / linear);
+    /* value to name */
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        for (entry = list->data_list; entry->pString; entry++) {
+            Checksum += (unsigned long)(uintptr_t)indtext_by_index(
+                list->data_list, entry->index);
+        }
+    }
+    linear = lookups / clock_seconds(start);
+    start = clock();
+    for (i = 0; i < Iterations; i++) {
+        for (entry = list->data_list; entry->pString; entry++) {
+            Checksum += (unsigned long)(uintptr_t)list->by_value(entry->index);
+        }
+    }
+    sorted = lookups / clock_seconds(start);
+    printf("%-16s value to name %12.0f %12.0f %8.1fx\n", list->name, linear,
+        sorted, sorted / linear);
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--iterations N]\n", filename);
+    printf("       [--version][--help]\n");
+}
+
+static void print_help(const char *filename)
+{
+    (void)filename;
+    printf("Benchmark of the BACnet text lookups of the object type,\n"
+           "property, and engineering unit lists.  Reports the lookups\n"
+           "per second of the linear search and of the sorted index.\n");
+    printf("\n");
+    printf("--iterations N\n"
+           "Number of times every name and value is looked up.\n"
+           "1000 is default.\n");
+}
+
+int main(int argc, char *argv[])
+{
+    char *filename = NULL;
+    unsigned i;
+    int argi = 0;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2023 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if ((strcmp(argv[argi], "--iterations") == 0) && (++argi < argc)) {
+            Iterations = strtoul(argv[argi], NULL, 0);
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if (Iterations < 1) {
+        Iterations = 1;
+    }
+    printf("%-16s %-13s %12s %12s %9s\n", "list", "lookup", "linear/s",
+        "sorted/s", "speedup");
+    for (i = 0; i < sizeof(Lists) / sizeof(Lists[0]); i++) {
+        textbench_list(&Lists[i]);
+    }
+
+    return 0;
+}
@@ -30,6 +30,7 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <errno.h>
+#include <string.h>
 #include "bacnet/bactext.h"
 #include "bacnet/iam.h"
 #include "bacnet/basic/binding/address.h"
@@ -65,58 +66,189 @@ static bool BACnet_Debug_Enabled;
 
 #define BAC_ADDRESS_MULT 1
 
+/* size of the device information strings read in discovery mode */
+#define DISCOVER_TEXT_SIZE 64
+/* Who-Is-Router-To-Network wait time before the sweep starts */
+#define DISCOVER_ROUTER_MILLISECONDS 1000
+/* remote networks that are swept separately */
+#define DISCOVER_NETWORK_MAX 255
+
+/* states of the device information read in discovery mode */
+#define DISCOVER_READ_IDLE 0
+#define DISCOVER_READ_PENDING 1
+#define DISCOVER_READ_DONE 2
+#define DISCOVER_READ_FAILED 3
+
 struct address_entry {
-    struct address_entry *next;
     uint8_t Flags;
     uint32_t device_id;
     unsigned max_apdu;
     BACNET_ADDRESS address;
+    /* next entry in the same hash bucket, or -1 */
+    int32_t hash_next;
+    uint8_t read_state;
+    char name[DISCOVER_TEXT_SIZE];
+    char model[DISCOVER_TEXT_SIZE];
+    char vendor[DISCOVER_TEXT_SIZE];
 };
 
+/* devices in the order that they answered, and a hash set that
+   finds them by device instance */
 static struct address_table {
-    struct address_entry *first;
-    struct address_entry *last;
+    struct address_entry *entry;
+    unsigned count;
+    unsigned size;
+    int32_t *bucket;
 } Address_Table = { 0 };
 
-static struct address_entry *alloc_address_entry(void)
+/* discovery mode */
+typedef enum {
+    DISCOVER_STATE_ROUTERS,
+    DISCOVER_STATE_SWEEP,
+    DISCOVER_STATE_WAIT,
+    DISCOVER_STATE_READ,
+    DISCOVER_STATE_DONE
+} DISCOVER_STATE;
+
+static bool Discover_Enabled;
+static bool Discover_Read_Enabled;
+static uint32_t Discover_Slice_Size = 4096;
+static unsigned Discover_Pace_Milliseconds = 10;
+static unsigned Discover_Window = 16;
+static DISCOVER_STATE Discover_State;
+static struct mstimer Discover_Timer;
+static uint16_t Discover_Network[DISCOVER_NETWORK_MAX];
+static unsigned Discover_Network_Count;
+/* new devices found in each slice of the swept range */
+static uint32_t *Discover_Slice_Devices;
+static uint32_t Discover_Slice_Count;
+static unsigned Discover_Pass;
+static uint32_t Discover_Recovered;
+static unsigned long Discover_Start_Milliseconds;
+static unsigned long Discover_Last_Milliseconds;
+/* address table entry of each outstanding ReadPropertyMultiple */
+static int32_t Discover_Invoke_Entry[256];
+static unsigned Discover_Reads_Outstanding;
+
+/**
+ * @brief Hash a device instance to a bucket
+ * @param device_id - device instance
+ * @return bucket index
+ */
+static unsigned address_hash(uint32_t device_id)
 {
-    struct address_entry *rval;
-    rval = (struct address_entry *)calloc(1, sizeof(struct address_entry));
-    if (Address_Table.first == 0) {
-        Address_Table.first = Address_Table.last = rval;
-    } else {
-        Address_Table.last->next = rval;
-        Address_Table.last = rval;
+    /* multiplicative hashing spreads sequential instances */
+    return (unsigned)((device_id * 2654435761UL) & (Address_Table.size - 1));
+}
+
+/**
+ * @brief Double the size of the address table and re-hash it
+ * @return true if the table was enlarged
+ */
+static bool address_table_grow(void)
+{
+    struct address_entry *entry;
+    int32_t *bucket;
+    unsigned size;
+    unsigned i;
+    unsigned hash;
+
+    size = Address_Table.size ? Address_Table.size * 2 : 256;
+    entry = realloc(Address_Table.entry, size * sizeof(*entry));
+    if (!entry) {
+        return false;
+    }
+    Address_Table.entry = entry;
+    bucket = malloc(size * sizeof(*bucket));
+    if (!bucket) {
+        return false;
+    }
+    free(Address_Table.bucket);
+    Address_Table.bucket = bucket;
+    Address_Table.size = size;
+    for (i = 0; i < size; i++) {
+        bucket[i] = -1;
+    }
+    for (i = 0; i < Address_Table.count; i++) {
+        hash = address_hash(entry[i].device_id);
+        entry[i].hash_next = bucket[hash];
+        bucket[hash] = (int32_t)i;
     }
-    return rval;
+
+    return true;
 }
 
-static void address_table_add(
+/**
+ * @brief Add a device to the address table
+ * @param device_id - device instance from the I-Am
+ * @param max_apdu - maximum APDU from the I-Am
+ * @param src - address of the device
+ * @return true if the device or its address was not known before
+ */
+static bool address_table_add(
     uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
 {
     struct address_entry *pMatch;
     uint8_t flags = 0;
+    int32_t index = -1;
+    unsigned hash;
 
-    pMatch = Address_Table.first;
-    while (pMatch) {
+    if (Address_Table.size) {
+        index = Address_Table.bucket[address_hash(device_id)];
+    }
+    while (index >= 0) {
+        pMatch = &Address_Table.entry[index];
         if (pMatch->device_id == device_id) {
             if (bacnet_address_same(&pMatch->address, src)) {
-                return;
+                return false;
             }
             flags |= BAC_ADDRESS_MULT;
             pMatch->Flags |= BAC_ADDRESS_MULT;
         }
-        pMatch = pMatch->next;
+        index = pMatch->hash_next;
     }
-
-    pMatch = alloc_address_entry();
-
+    if ((Address_Table.count == Address_Table.size) &&
+        (!address_table_grow())) {
+        return false;
+    }
+    pMatch = &Address_Table.entry[Address_Table.count];
+    memset(pMatch, 0, sizeof(*pMatch));
     pMatch->Flags = flags;
     pMatch->device_id = device_id;
     pMatch->max_apdu = max_apdu;
     pMatch->address = *src;
+    hash = address_hash(device_id);
+    pMatch->hash_next = Address_Table.bucket[hash];
+    Address_Table.bucket[hash] = (int32_t)Address_Table.count;
+    Address_Table.count++;
 
-    return;
+    return true;
+}
+
+/**
+ * @brief Count a newly found device in its slice of the swept range
+ * @param device_id - device instance from the I-Am
+ */
+static void discover_device_found(uint32_t device_id)
+{
+    uint32_t slice;
+
+    Discover_Last_Milliseconds = mstimer_now();
+    if (Discover_Pass > 0) {
+        Discover_Recovered++;
+    }
+    if ((device_id >= (uint32_t)Target_Object_Instance_Min) &&
+        (device_id <= (uint32_t)Target_Object_Instance_Max)) {
+        slice = (device_id - Target_Object_Instance_Min) / Discover_Slice_Size;
+        if (slice < Discover_Slice_Count) {
+            Discover_Slice_Devices[slice]++;
+        }
+    }
+    if (Discover_State == DISCOVER_STATE_SWEEP) {
+        /* pace the next slice from the last answer, so that the
+           routers and the devices have drained their queues */
+        mstimer_restart(&Discover_Timer);
+    }
 }
 
 static void my_i_am_handler(
@@ -153,7 +285,10 @@ static void my_i_am_handler(
                 fprintf(stderr, "\n");
             }
         }
-        address_table_add(device_id, max_apdu, src);
+        if (address_table_add(device_id, max_apdu, src) &&
+            Discover_Enabled) {
+            discover_device_found(device_id);
+        }
     } else {
         if (BACnet_Debug_Enabled) {
             fprintf(stderr, ", but unable to decode it.\n");
@@ -163,13 +298,108 @@ static void my_i_am_handler(
     return;
 }
 
+/**
+ * @brief Finish the device information read of an outstanding request
+ * @param src - address the response came from
+ * @param invoke_id - invoke ID of the response
+ * @param read_state - DISCOVER_READ_DONE or DISCOVER_READ_FAILED
+ * @return the address table entry, or NULL if the invoke ID is not ours
+ */
+static struct address_entry *discover_read_complete(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t read_state)
+{
+    struct address_entry *entry;
+    int32_t index;
+
+    index = Discover_Invoke_Entry[invoke_id];
+    if (index < 0) {
+        return NULL;
+    }
+    entry = &Address_Table.entry[index];
+    if (src && !bacnet_address_same(&entry->address, src)) {
+        return NULL;
+    }
+    Discover_Invoke_Entry[invoke_id] = -1;
+    Discover_Reads_Outstanding--;
+    entry->read_state = read_state;
+
+    return entry;
+}
+
+static void My_Read_Property_Multiple_Ack_Handler(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
+{
+    struct address_entry *entry;
+    BACNET_READ_ACCESS_DATA *rpm_data;
+    BACNET_PROPERTY_REFERENCE *rpm_property;
+    BACNET_APPLICATION_DATA_VALUE *value;
+    char *text;
+    int len;
+
+    entry = discover_read_complete(
+        src, service_data->invoke_id, DISCOVER_READ_DONE);
+    if (!entry) {
+        return;
+    }
+    rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+    if (!rpm_data) {
+        return;
+    }
+    len =
+        rpm_ack_decode_service_request(service_request, service_len, rpm_data);
+    if (len <= 0) {
+        entry->read_state = DISCOVER_READ_FAILED;
+    }
+    while (rpm_data) {
+        rpm_property = rpm_data->listOfProperties;
+        while ((len > 0) && rpm_property) {
+            switch (rpm_property->propertyIdentifier) {
+                case PROP_OBJECT_NAME:
+                    text = entry->name;
+                    break;
+                case PROP_MODEL_NAME:
+                    text = entry->model;
+                    break;
+                case PROP_VENDOR_NAME:
+                    text = entry->vendor;
+                    break;
+                default:
+                    text = NULL;
+                    break;
+            }
+            value = rpm_property->value;
+            if (text && value &&
+                (value->tag == BACNET_APPLICATION_TAG_CHARACTER_STRING)) {
+                characterstring_ansi_copy(text, DISCOVER_TEXT_SIZE,
+                    &value->type.Character_String);
+            }
+            rpm_property = rpm_property->next;
+        }
+        rpm_data = rpm_data_free(rpm_data);
+    }
+}
+
+static void My_Error_Handler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    (void)error_class;
+    (void)error_code;
+    (void)discover_read_complete(src, invoke_id, DISCOVER_READ_FAILED);
+}
+
 static void MyAbortHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
 {
-    /* FIXME: verify src and invoke id */
-    (void)src;
-    (void)invoke_id;
     (void)server;
+    if (Discover_Enabled &&
+        discover_read_complete(src, invoke_id, DISCOVER_READ_FAILED)) {
+        /* the device does not support ReadPropertyMultiple */
+        return;
+    }
     fprintf(
         stderr, "BACnet Abort: %s\n", bactext_abort_reason_name(abort_reason));
     Error_Detected = true;
@@ -178,9 +408,11 @@ static void MyAbortHandler(
 static void MyRejectHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
 {
-    /* FIXME: verify src and invoke id */
-    (void)src;
-    (void)invoke_id;
+    if (Discover_Enabled &&
+        discover_read_complete(src, invoke_id, DISCOVER_READ_FAILED)) {
+        /* the device does not support ReadPropertyMultiple */
+        return;
+    }
     fprintf(stderr, "BACnet Reject: %s\n",
         bactext_reject_reason_name(reject_reason));
     Error_Detected = true;
@@ -199,11 +431,394 @@ static void init_service_handlers(void)
         SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property);
     /* handle the reply (request) coming back */
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, my_i_am_handler);
+    /* handle the device information coming back in discovery mode */
+    apdu_set_confirmed_ack_handler(SERVICE_CONFIRMED_READ_PROP_MULTIPLE,
+        My_Read_Property_Multiple_Ack_Handler);
     /* handle any errors coming back */
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, My_Error_Handler);
     apdu_set_abort_handler(MyAbortHandler);
     apdu_set_reject_handler(MyRejectHandler);
 }
 
+/**
+ * @brief Remember the networks from an I-Am-Router-To-Network
+ * @param npdu - network message data following the NPCI
+ * @param npdu_len - length of the network message data
+ */
+static void discover_networks(uint8_t *npdu, uint16_t npdu_len)
+{
+    uint16_t dnet = 0;
+    unsigned i;
+
+    while (npdu_len >= 2) {
+        decode_unsigned16(npdu, &dnet);
+        npdu += 2;
+        npdu_len -= 2;
+        for (i = 0; i < Discover_Network_Count; i++) {
+            if (Discover_Network[i] == dnet) {
+                break;
+            }
+        }
+        if ((i == Discover_Network_Count) &&
+            (Discover_Network_Count < DISCOVER_NETWORK_MAX)) {
+            Discover_Network[Discover_Network_Count++] = dnet;
+        }
+    }
+}
+
+static void My_NPDU_Handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
+{
+    int apdu_offset = 0;
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS npdu_src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+
+    if (Discover_Enabled && (pdu_len > 0) &&
+        (pdu[0] == BACNET_PROTOCOL_VERSION)) {
+        npdu_src = *src;
+        apdu_offset =
+            bacnet_npdu_decode(pdu, pdu_len, &dest, &npdu_src, &npdu_data);
+        if ((apdu_offset > 0) && (apdu_offset <= pdu_len) &&
+            npdu_data.network_layer_message &&
+            (npdu_data.network_message_type ==
+                NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK)) {
+            discover_networks(
+                &pdu[apdu_offset], (uint16_t)(pdu_len - apdu_offset));
+            return;
+        }
+    }
+    npdu_handler(src, pdu, pdu_len);
+}
+
+/**
+ * @brief Get the destination of a discovery Who-Is
+ * @param index - 0 for the configured destination or the local network,
+ *  or 1 and above for the remote networks from I-Am-Router-To-Network
+ * @param target - configured destination of the Who-Is
+ * @param dest - destination of this Who-Is
+ */
+static void discover_target(
+    unsigned index, BACNET_ADDRESS *target, BACNET_ADDRESS *dest)
+{
+    *dest = *target;
+    if (Discover_Network_Count == 0) {
+        return;
+    }
+    /* each network is swept with a directed broadcast, so that the
+       routers to the busy networks are paced individually */
+    datalink_get_broadcast_address(dest);
+    if (index == 0) {
+        dest->net = 0;
+    } else {
+        dest->net = Discover_Network[index - 1];
+    }
+    dest->len = 0;
+}
+
+/**
+ * @brief Send a ReadPropertyMultiple for the name, model, and vendor
+ *  of a discovered device, directly to its address
+ * @param index - address table entry of the device
+ * @return true if the request was sent
+ */
+static bool discover_read_send(unsigned index)
+{
+    struct address_entry *entry = &Address_Table.entry[index];
+    BACNET_READ_ACCESS_DATA read_access_data = { 0 };
+    BACNET_PROPERTY_REFERENCE property[3] = { { 0 } };
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+    uint8_t invoke_id;
+    int pdu_len;
+    int len;
+
+    invoke_id = tsm_next_free_invokeID();
+    if (!invoke_id) {
+        return false;
+    }
+    property[0].propertyIdentifier = PROP_OBJECT_NAME;
+    property[0].propertyArrayIndex = BACNET_ARRAY_ALL;
+    property[0].next = &property[1];
+    property[1].propertyIdentifier = PROP_MODEL_NAME;
+    property[1].propertyArrayIndex = BACNET_ARRAY_ALL;
+    property[1].next = &property[2];
+    property[2].propertyIdentifier = PROP_VENDOR_NAME;
+    property[2].propertyArrayIndex = BACNET_ARRAY_ALL;
+    read_access_data.object_type = OBJECT_DEVICE;
+    read_access_data.object_instance = entry->device_id;
+    read_access_data.listOfProperties = &property[0];
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(&Handler_Transmit_Buffer[0], &entry->address,
+        &my_address, &npdu_data);
+    len = rpm_encode_apdu(&Handler_Transmit_Buffer[pdu_len],
+        sizeof(Handler_Transmit_Buffer) - pdu_len, invoke_id,
+        &read_access_data);
+    if ((len <= 0) || ((unsigned)(pdu_len + len) > entry->max_apdu)) {
+        tsm_free_invoke_id(invoke_id);
+        entry->read_state = DISCOVER_READ_FAILED;
+        return true;
+    }
+    pdu_len += len;
+    tsm_set_confirmed_unsegmented_transaction(invoke_id, &entry->address,
+        &npdu_data, &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
+    tsm_send_pdu(invoke_id, &entry->address, &npdu_data,
+        &Handler_Transmit_Buffer[0], pdu_len);
+    entry->read_state = DISCOVER_READ_PENDING;
+    Discover_Invoke_Entry[invoke_id] = (int32_t)index;
+    Discover_Reads_Outstanding++;
+
+    return true;
+}
+
+/**
+ * @brief Keep the window of device information reads full, and expire
+ *  the reads that failed
+ * @return true when every discovered device has been read
+ */
+static bool discover_read_task(void)
+{
+    static unsigned next_index;
+    unsigned i;
+
+    for (i = 0; i < 256; i++) {
+        if ((Discover_Invoke_Entry[i] >= 0) &&
+            tsm_invoke_id_failed((uint8_t)i)) {
+            tsm_free_invoke_id((uint8_t)i);
+            (void)discover_read_complete(NULL, (uint8_t)i,
+                DISCOVER_READ_FAILED);
+        }
+    }
+    while ((next_index < Address_Table.count) &&
+        (Discover_Reads_Outstanding < Discover_Window)) {
+        if (!discover_read_send(next_index)) {
+            break;
+        }
+        next_index++;
+    }
+
+    return (next_index >= Address_Table.count) &&
+        (Discover_Reads_Outstanding == 0);
+}
+
+/**
+ * @brief Send the Who-Is for the next slice of the range that is due
+ * @param target - configured destination of the Who-Is
+ * @return true if a slice was sent, false when the pass is complete
+ */
+static bool discover_sweep_next(BACNET_ADDRESS *target)
+{
+    static uint32_t slice;
+    static uint32_t part;
+    BACNET_ADDRESS dest;
+    uint32_t parts = 1;
+    uint32_t part_size = Discover_Slice_Size;
+    int32_t low_limit;
+    int32_t high_limit;
+    unsigned i;
+
+    /* after the first pass, only the slices that answered are swept
+       again, in smaller parts each pass, to recover the I-Am that were
+       dropped by a busy network */
+    while ((slice < Discover_Slice_Count) && (Discover_Pass > 0) &&
+        (Discover_Slice_Devices[slice] == 0)) {
+        slice++;
+    }
+    if (slice >= Discover_Slice_Count) {
+        slice = 0;
+        return false;
+    }
+    if ((Discover_Pass > 0) && (Discover_Pass < 32)) {
+        parts = 1UL << Discover_Pass;
+        part_size = (Discover_Slice_Size + parts - 1) / parts;
+        parts = (Discover_Slice_Size + part_size - 1) / part_size;
+    }
+    low_limit = Target_Object_Instance_Min + (slice * Discover_Slice_Size) +
+        (part * part_size);
+    high_limit = low_limit + part_size - 1;
+    if (high_limit > Target_Object_Instance_Max) {
+        high_limit = Target_Object_Instance_Max;
+    }
+    if (low_limit <= high_limit) {
+        for (i = 0; i <= Discover_Network_Count; i++) {
+            discover_target(i, target, &dest);
+            Send_WhoIs_To_Network(&dest, low_limit, high_limit);
+        }
+    }
+    part++;
+    if (part >= parts) {
+        part = 0;
+        slice++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Run the discovery state machine
+ * @param target - configured destination of the Who-Is
+ * @param retry_count - number of passes that repeat the answered slices
+ * @param timeout_milliseconds - quiet time that ends the sweep
+ * @return true when the discovery is complete
+ */
+static bool discover_task(BACNET_ADDRESS *target,
+    long retry_count,
+    unsigned timeout_milliseconds)
+{
+    switch (Discover_State) {
+        case DISCOVER_STATE_ROUTERS:
+            if (mstimer_expired(&Discover_Timer)) {
+                Discover_State = DISCOVER_STATE_SWEEP;
+                mstimer_set(&Discover_Timer, Discover_Pace_Milliseconds);
+                Discover_Start_Milliseconds = mstimer_now();
+                Discover_Last_Milliseconds = Discover_Start_Milliseconds;
+            }
+            break;
+        case DISCOVER_STATE_SWEEP:
+            if (mstimer_expired(&Discover_Timer)) {
+                if (discover_sweep_next(target)) {
+                    mstimer_restart(&Discover_Timer);
+                } else if ((long)Discover_Pass < retry_count) {
+                    Discover_Pass++;
+                } else {
+                    Discover_State = DISCOVER_STATE_WAIT;
+                    mstimer_set(&Discover_Timer, timeout_milliseconds);
+                }
+            }
+            break;
+        case DISCOVER_STATE_WAIT:
+            if (mstimer_expired(&Discover_Timer)) {
+                if (Discover_Read_Enabled) {
+                    Discover_State = DISCOVER_STATE_READ;
+                } else {
+                    Discover_State = DISCOVER_STATE_DONE;
+                }
+            }
+            break;
+        case DISCOVER_STATE_READ:
+            if (discover_read_task()) {
+                Discover_State = DISCOVER_STATE_DONE;
+            }
+            break;
+        case DISCOVER_STATE_DONE:
+        default:
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Start the discovery
+ * @param target - configured destination of the Who-Is
+ * @param global_broadcast - true if the remote networks are to be found
+ * @return true if the discovery was started
+ */
+static bool discover_init(BACNET_ADDRESS *target, bool global_broadcast)
+{
+    uint32_t range;
+    unsigned i;
+
+    if (Target_Object_Instance_Min < 0) {
+        Target_Object_Instance_Min = 0;
+    }
+    if ((Target_Object_Instance_Max < 0) ||
+        (Target_Object_Instance_Max < Target_Object_Instance_Min)) {
+        Target_Object_Instance_Max = BACNET_MAX_INSTANCE;
+    }
+    if (Discover_Slice_Size == 0) {
+        Discover_Slice_Size = 1;
+    }
+    range = Target_Object_Instance_Max - Target_Object_Instance_Min + 1;
+    Discover_Slice_Count = (range + Discover_Slice_Size - 1) /
+        Discover_Slice_Size;
+    Discover_Slice_Devices =
+        calloc(Discover_Slice_Count, sizeof(*Discover_Slice_Devices));
+    if (!Discover_Slice_Devices) {
+        return false;
+    }
+    for (i = 0; i < 256; i++) {
+        Discover_Invoke_Entry[i] = -1;
+    }
+    Discover_State = DISCOVER_STATE_ROUTERS;
+    if (global_broadcast) {
+        /* find the networks first, so that each is swept on its own */
+        Send_Who_Is_Router_To_Network(target, -1);
+        mstimer_set(&Discover_Timer, DISCOVER_ROUTER_MILLISECONDS);
+    } else {
+        mstimer_set(&Discover_Timer, 0);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Print the discovery rate, the networks, the ranges without
+ *  any device, and the device information that was read
+ */
+static void print_discovery(void)
+{
+    unsigned long milliseconds;
+    uint32_t slice;
+    uint32_t first = 0;
+    bool missing = false;
+    unsigned i;
+    struct address_entry *entry;
+
+    milliseconds = Discover_Last_Milliseconds - Discover_Start_Milliseconds;
+    printf("; Discovered: %u devices in %lu.%03lus", Address_Table.count,
+        milliseconds / 1000, milliseconds % 1000);
+    if (milliseconds) {
+        printf(" (%lu devices/s)",
+            (unsigned long)((Address_Table.count * 1000UL) / milliseconds));
+    }
+    printf("\n");
+    if (Discover_Pass > 0) {
+        printf("; Recovered by repeated slices: %lu\n",
+            (unsigned long)Discover_Recovered);
+    }
+    if (Discover_Network_Count) {
+        printf("; Networks:");
+        for (i = 0; i < Discover_Network_Count; i++) {
+            printf(" %u", (unsigned)Discover_Network[i]);
+        }
+        printf("\n");
+    }
+    for (slice = 0; slice <= Discover_Slice_Count; slice++) {
+        if ((slice < Discover_Slice_Count) &&
+            (Discover_Slice_Devices[slice] == 0)) {
+            if (!missing) {
+                first = slice;
+                missing = true;
+            }
+        } else if (missing) {
+            printf("; Missing: %lu-%lu\n",
+                (unsigned long)(Target_Object_Instance_Min +
+                    (first * Discover_Slice_Size)),
+                (unsigned long)((slice == Discover_Slice_Count)
+                        ? (uint32_t)Target_Object_Instance_Max
+                        : Target_Object_Instance_Min +
+                            (slice * Discover_Slice_Size) - 1));
+            missing = false;
+        }
+    }
+    if (!Discover_Read_Enabled) {
+        return;
+    }
+    printf(";\n;%-7s  %-24s %-24s %s\n", "Device", "Name", "Model",
+        "Vendor");
+    for (i = 0; i < Address_Table.count; i++) {
+        entry = &Address_Table.entry[i];
+        if (entry->read_state == DISCOVER_READ_DONE) {
+            printf("; %-7u \"%s\" \"%s\" \"%s\"\n", entry->device_id,
+                entry->name, entry->model, entry->vendor);
+        } else {
+            printf("; %-7u (not read)\n", entry->device_id);
+        }
+    }
+}
+
 static void print_macaddr(uint8_t *addr, int len)
 {
     int j = 0;
@@ -227,6 +842,7 @@ static void print_address_cache(void)
     unsigned total_addresses = 0;
     unsigned dup_addresses = 0;
     struct address_entry *addr;
+    unsigned i;
     uint8_t local_sadr = 0;
 
     /*  NOTE: this string format is parsed by src/address.c,
@@ -236,8 +852,8 @@ static void print_address_cache(void)
         "SADR (hex)", "APDU");
     printf(";-------- -------------------- ----- -------------------- ----\n");
 
-    addr = Address_Table.first;
-    while (addr) {
+    for (i = 0; i < Address_Table.count; i++) {
+        addr = &Address_Table.entry[i];
         bacnet_address_copy(&address, &addr->address);
         total_addresses++;
         if (addr->Flags & BAC_ADDRESS_MULT) {
@@ -256,8 +872,6 @@ static void print_address_cache(void)
         }
         printf(" %-4u ", (unsigned)addr->max_apdu);
         printf("\n");
-
-        addr = addr->next;
     }
     printf(";\n; Total Devices: %u\n", total_addresses);
     if (dup_addresses) {
@@ -270,6 +884,7 @@ static void print_usage(char *filename)
     printf("Usage: %s", filename);
     printf(" [device-instance-min [device-instance-max]]\n");
     printf("       [--dnet][--dadr][--mac]\n");
+    printf("       [--discover][--slice N][--pace M][--read][--window W]\n");
     printf("       [--version][--help]\n");
 }
 
@@ -318,6 +933,32 @@ static void print_help(char *filename)
         "Wait M milliseconds for responses after sending\n"
         "Default delay is 100ms.\n");
     printf("\n");
+    printf("--discover\n"
+        "Discover the devices by sweeping the device instance range in\n"
+        "slices, one Who-Is per slice and network. The networks are\n"
+        "found first with Who-Is-Router-To-Network, and each network is\n"
+        "swept with a directed broadcast. With --retry C, the slices\n"
+        "that answered are swept C more times, in halves, quarters, and\n"
+        "so on, to recover the I-Am that were dropped.\n"
+        "The discovery rate and the ranges without any device are\n"
+        "printed after the devices.\n");
+    printf("\n");
+    printf("--slice N\n"
+        "Sweep N device instances with each discovery Who-Is.\n"
+        "Default is 4096.\n");
+    printf("\n");
+    printf("--pace M\n"
+        "Send the next discovery Who-Is when no new device has answered\n"
+        "for M milliseconds. Default is 10ms.\n");
+    printf("\n");
+    printf("--read\n"
+        "After the discovery, read the name, model, and vendor of each\n"
+        "device with ReadPropertyMultiple.\n");
+    printf("\n");
+    printf("--window W\n"
+        "Keep up to W ReadPropertyMultiple requests outstanding.\n"
+        "Default is 16.\n");
+    printf("\n");
     printf("Example:\n");
     printf("Send a WhoIs request to DNET 123:\n"
         "%s --dnet 123\n",
@@ -340,6 +981,64 @@ static void print_help(char *filename)
     printf("Send a WhoIs request to all devices:\n"
         "%s\n",
         filename);
+    printf("Discover all devices, and read their names:\n"
+        "%s --discover --read\n",
+        filename);
+}
+
+/**
+ * @brief Discover the devices, then print them
+ * @param target - configured destination of the Who-Is
+ * @param global_broadcast - true if the remote networks are to be found
+ * @param retry_count - number of passes that repeat the answered slices
+ * @param timeout_milliseconds - quiet time that ends the sweep
+ * @return 0 on success
+ */
+static int discover_main(BACNET_ADDRESS *target,
+    bool global_broadcast,
+    long retry_count,
+    unsigned timeout_milliseconds)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint16_t pdu_len = 0;
+    struct mstimer datalink_timer = { 0 };
+    unsigned long last_milliseconds;
+    unsigned long current_milliseconds;
+
+    if (!discover_init(target, global_broadcast)) {
+        fprintf(stderr, "Unable to allocate the discovery slices!\n");
+        return 1;
+    }
+    mstimer_set(&datalink_timer, 1000);
+    last_milliseconds = mstimer_now();
+    for (;;) {
+        pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, 1);
+        if (pdu_len) {
+            My_NPDU_Handler(&src, &Rx_Buf[0], pdu_len);
+        }
+        if (Error_Detected) {
+            break;
+        }
+        current_milliseconds = mstimer_now();
+        if (current_milliseconds != last_milliseconds) {
+            tsm_timer_milliseconds(
+                (uint16_t)(current_milliseconds - last_milliseconds));
+            last_milliseconds = current_milliseconds;
+        }
+        if (mstimer_expired(&datalink_timer)) {
+            datalink_maintenance_timer(
+                mstimer_interval(&datalink_timer) / 1000);
+            mstimer_reset(&datalink_timer);
+        }
+        if (discover_task(target, retry_count, timeout_milliseconds)) {
+            break;
+        }
+    }
+    print_address_cache();
+    print_discovery();
+    free(Discover_Slice_Devices);
+
+    return 0;
 }
 
 int main(int argc, char *argv[])
@@ -418,6 +1117,25 @@ int main(int argc, char *argv[])
             if (++argi < argc) {
                 delay_milliseconds = strtol(argv[argi], NULL, 0);
             }
+        } else if (strcmp(argv[argi], "--discover") == 0) {
+            Discover_Enabled = true;
+        } else if (strcmp(argv[argi], "--slice") == 0) {
+            if (++argi < argc) {
+                Discover_Slice_Size = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--pace") == 0) {
+            if (++argi < argc) {
+                Discover_Pace_Milliseconds = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--read") == 0) {
+            Discover_Read_Enabled = true;
+        } else if (strcmp(argv[argi], "--window") == 0) {
+            if (++argi < argc) {
+                Discover_Window = strtoul(argv[argi], NULL, 0);
+                if (Discover_Window < 1) {
+                    Discover_Window = 1;
+                }
+            }
         } else {
             if (target_args == 0) {
                 Target_Object_Instance_Min = Target_Object_Instance_Max =
@@ -480,6 +1198,10 @@ int main(int argc, char *argv[])
     address_init();
     dlenv_init();
     atexit(datalink_cleanup);
+    if (Discover_Enabled) {
+        return discover_main(&dest, global_broadcast, retry_count,
+            timeout_milliseconds ? timeout_milliseconds : apdu_timeout());
+    }
     if (timeout_milliseconds == 0) {
         timeout_milliseconds = apdu_timeout() * apdu_retries();
     }
@@ -498,7 +1220,7 @@ int main(int argc, char *argv[])
             datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, delay_milliseconds);
         /* process */
         if (pdu_len) {
-            npdu_handler(&src, &Rx_Buf[0], pdu_len);
+            My_NPDU_Handler(&src, &Rx_Buf[0], pdu_len);
         }
         if (Error_Detected) {
             break;
@@ -37,7 +37,8 @@
 #include "rs485.h"
 #include "bacnet/npdu.h"
 #include "bacnet/bits.h"
-#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/priority_queue.h"
 #include "bacnet/basic/sys/debug.h"
 /* OS Specific include */
 #include "bacport.h"
@@ -81,17 +82,20 @@ static uint8_t TxBuffer[DLMSTP_MPDU_MAX];
 static uint8_t RxBuffer[DLMSTP_MPDU_MAX];
 /* data structure for MS/TP PDU Queue */
 struct mstp_pdu_packet {
+    PRIORITY_QUEUE_ELEMENT header;
     bool data_expecting_reply;
     uint8_t destination_mac;
     uint16_t length;
     uint8_t buffer[DLMSTP_MPDU_MAX];
 };
-/* count must be a power of 2 for ringbuf library */
+/* count for each message priority must be a power of 2 for ringbuf library */
 #ifndef MSTP_PDU_PACKET_COUNT
 #define MSTP_PDU_PACKET_COUNT 8
 #endif
-static struct mstp_pdu_packet PDU_Buffer[MSTP_PDU_PACKET_COUNT];
-static RING_BUFFER PDU_Queue;
+static struct mstp_pdu_packet
+    PDU_Buffer[PRIORITY_QUEUE_LEVELS * MSTP_PDU_PACKET_COUNT];
+/* sent highest network message priority first */
+static PRIORITY_QUEUE PDU_Queue;
 /* The minimum time without a DataAvailable or ReceiveError event */
 /* that a node must wait for a station to begin replying to a */
 /* confirmed request: 255 milliseconds. (Implementations may use */
@@ -212,7 +216,7 @@ int dlmstp_send_pdu(BACNET_ADDRESS *dest, /* destination address */
     struct mstp_pdu_packet *pkt;
     unsigned i = 0;
     pthread_mutex_lock(&Ring_Buffer_Mutex);
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Data_Peek(&PDU_Queue);
+    pkt = priority_queue_data_peek(&PDU_Queue, npdu_data->priority);
     if (pkt) {
         pkt->data_expecting_reply = npdu_data->data_expecting_reply;
         for (i = 0; i < pdu_len; i++) {
@@ -225,7 +229,8 @@ int dlmstp_send_pdu(BACNET_ADDRESS *dest, /* destination address */
             /* mac_len = 0 is a broadcast address */
             pkt->destination_mac = MSTP_BROADCAST_ADDRESS;
         }
-        if (Ringbuf_Data_Put(&PDU_Queue, (uint8_t *)pkt)) {
+        if (priority_queue_data_put(&PDU_Queue, npdu_data->priority, pkt,
+                mstimer_now())) {
             bytes_sent = pdu_len;
         }
     }
@@ -391,11 +396,11 @@ uint16_t MSTP_Get_Send(
 
     (void)timeout;
     pthread_mutex_lock(&Ring_Buffer_Mutex);
-    if (Ringbuf_Empty(&PDU_Queue)) {
+    pkt = priority_queue_peek(&PDU_Queue, NULL);
+    if (!pkt) {
         pthread_mutex_unlock(&Ring_Buffer_Mutex);
         return 0;
     }
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&PDU_Queue);
     if (pkt->data_expecting_reply) {
         frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
     } else {
@@ -406,7 +411,7 @@ uint16_t MSTP_Get_Send(
         MSTP_Create_Frame(&mstp_port->OutputBuffer[0], /* <-- loading this */
             mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
             mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    (void)Ringbuf_Pop(&PDU_Queue, NULL);
+    (void)priority_queue_pop(&PDU_Queue, mstimer_now());
     pthread_mutex_unlock(&Ring_Buffer_Mutex);
 
     return pdu_len;
@@ -577,10 +582,10 @@ uint16_t MSTP_Get_Reply(
     struct mstp_pdu_packet *pkt;
 
     (void)timeout;
-    if (Ringbuf_Empty(&PDU_Queue)) {
+    pkt = priority_queue_peek(&PDU_Queue, NULL);
+    if (!pkt) {
         return 0;
     }
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&PDU_Queue);
     /* is this the reply to the DER? */
     matched = dlmstp_compare_data_expecting_reply(&mstp_port->InputBuffer[0],
         mstp_port->DataLength, mstp_port->SourceAddress,
@@ -598,7 +603,7 @@ uint16_t MSTP_Get_Reply(
         MSTP_Create_Frame(&mstp_port->OutputBuffer[0], /* <-- loading this */
             mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
             mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    (void)Ringbuf_Pop(&PDU_Queue, NULL);
+    (void)priority_queue_pop(&PDU_Queue, mstimer_now());
 
     return pdu_len;
 }
@@ -720,6 +725,24 @@ void dlmstp_get_broadcast_address(BACNET_ADDRESS *dest)
     return;
 }
 
+/**
+ * @brief Get the counters of the PDU queue for a message priority
+ * @param priority - BACNET_MESSAGE_PRIORITY
+ * @param stats - [out] queue depth, wait time, and counters
+ * @return true if the priority exists
+ */
+bool dlmstp_send_pdu_queue_statistics(
+    unsigned priority, PRIORITY_QUEUE_STATISTICS *stats)
+{
+    bool status;
+
+    pthread_mutex_lock(&Ring_Buffer_Mutex);
+    status = priority_queue_statistics(&PDU_Queue, priority, stats);
+    pthread_mutex_unlock(&Ring_Buffer_Mutex);
+
+    return status;
+}
+
 bool dlmstp_init(char *ifname)
 {
     pthread_condattr_t attr;
@@ -736,7 +759,7 @@ bool dlmstp_init(char *ifname)
     pthread_mutex_init(&Thread_Mutex, NULL);
 
     /* initialize PDU queue */
-    Ringbuf_Init(&PDU_Queue, (uint8_t *)&PDU_Buffer,
+    priority_queue_init(&PDU_Queue, PDU_Buffer,
         sizeof(struct mstp_pdu_packet), MSTP_PDU_PACKET_COUNT);
     /* initialize packet queue */
     Receive_Packet.ready = false;
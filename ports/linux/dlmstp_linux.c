@@ -158,6 +158,11 @@ int dlmstp_send_pdu(void *poPort,
             bytes_sent = pdu_len;
         }
     }
+    if (bytes_sent) {
+        poSharedData->Statistics.transmit_pdu_counter++;
+    } else {
+        poSharedData->Statistics.transmit_pdu_dropped++;
+    }
 
     return bytes_sent;
 }
@@ -170,6 +175,7 @@ uint16_t dlmstp_receive(void *poPort,
 { /* milliseconds to wait for a packet */
     uint16_t pdu_len = 0;
     struct timespec abstime;
+    DLMSTP_PACKET *pkt;
     int rv = 0;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
@@ -180,27 +186,26 @@ uint16_t dlmstp_receive(void *poPort,
     if (!poSharedData) {
         return 0;
     }
-    (void)max_pdu;
     /* see if there is a packet available, and a place
        to put the reply (if necessary) and process it */
     get_abstime(&abstime, timeout);
     rv = sem_timedwait(&poSharedData->Receive_Packet_Flag, &abstime);
     if (rv == 0) {
-        if (poSharedData->Receive_Packet.ready) {
-            if (poSharedData->Receive_Packet.pdu_len) {
-                poSharedData->MSTP_Packets++;
-                if (src) {
-                    memmove(src, &poSharedData->Receive_Packet.address,
-                        sizeof(poSharedData->Receive_Packet.address));
-                }
-                if (pdu) {
-                    memmove(pdu, &poSharedData->Receive_Packet.pdu,
-                        sizeof(poSharedData->Receive_Packet.pdu));
+        pkt = (DLMSTP_PACKET *)Ringbuf_Peek(&poSharedData->Receive_Queue);
+        if (pkt && pkt->pdu_len) {
+            poSharedData->MSTP_Packets++;
+            if (src) {
+                memmove(src, &pkt->address, sizeof(pkt->address));
+            }
+            pdu_len = pkt->pdu_len;
+            if (pdu) {
+                if (pdu_len > max_pdu) {
+                    pdu_len = max_pdu;
                 }
-                pdu_len = poSharedData->Receive_Packet.pdu_len;
+                memmove(pdu, &pkt->pdu[0], pdu_len);
             }
-            poSharedData->Receive_Packet.ready = false;
         }
+        (void)Ringbuf_Pop(&poSharedData->Receive_Queue, NULL);
     }
 
     return pdu_len;
@@ -327,29 +332,58 @@ void dlmstp_fill_bacnet_address(BACNET_ADDRESS *src, uint8_t mstp_address)
 uint16_t MSTP_Put_Receive(volatile struct mstp_port_struct_t *mstp_port)
 {
     uint16_t pdu_len = 0;
+    DLMSTP_PACKET *pkt;
     SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
 
     if (!poSharedData) {
         return 0;
     }
 
-    if (!poSharedData->Receive_Packet.ready) {
+    pkt = (DLMSTP_PACKET *)Ringbuf_Data_Peek(&poSharedData->Receive_Queue);
+    if (pkt) {
         /* bounds check - maybe this should send an abort? */
         pdu_len = mstp_port->DataLength;
-        if (pdu_len > sizeof(poSharedData->Receive_Packet.pdu))
-            pdu_len = sizeof(poSharedData->Receive_Packet.pdu);
-        memmove((void *)&poSharedData->Receive_Packet.pdu[0],
-            (void *)&mstp_port->InputBuffer[0], pdu_len);
-        dlmstp_fill_bacnet_address(
-            &poSharedData->Receive_Packet.address, mstp_port->SourceAddress);
-        poSharedData->Receive_Packet.pdu_len = mstp_port->DataLength;
-        poSharedData->Receive_Packet.ready = true;
-        sem_post(&poSharedData->Receive_Packet_Flag);
+        if (pdu_len > sizeof(pkt->pdu))
+            pdu_len = sizeof(pkt->pdu);
+        memmove((void *)&pkt->pdu[0], (void *)&mstp_port->InputBuffer[0],
+            pdu_len);
+        dlmstp_fill_bacnet_address(&pkt->address, mstp_port->SourceAddress);
+        pkt->pdu_len = pdu_len;
+        pkt->ready = true;
+        if (Ringbuf_Data_Put(&poSharedData->Receive_Queue, (uint8_t *)pkt)) {
+            poSharedData->Statistics.receive_pdu_counter++;
+            sem_post(&poSharedData->Receive_Packet_Flag);
+        }
+    } else {
+        poSharedData->Statistics.receive_pdu_dropped++;
     }
 
     return pdu_len;
 }
 
+/**
+ * @brief Measure the token rotation time.  The master node state machine
+ *  enters USE_TOKEN with a FrameCount of zero each time it gets the token.
+ * @param poSharedData - port data
+ */
+static void dlmstp_token_received(SHARED_MSTP_DATA *poSharedData)
+{
+    struct timeval now, tmp_diff;
+    uint32_t rotation_ms;
+
+    gettimeofday(&now, NULL);
+    if (poSharedData->Statistics.token_counter > 0) {
+        timersub(&now, &poSharedData->Token_Time, &tmp_diff);
+        rotation_ms = (tmp_diff.tv_sec * 1000) + (tmp_diff.tv_usec / 1000);
+        poSharedData->Statistics.token_rotation_last_ms = rotation_ms;
+        if (rotation_ms > poSharedData->Statistics.token_rotation_max_ms) {
+            poSharedData->Statistics.token_rotation_max_ms = rotation_ms;
+        }
+    }
+    poSharedData->Token_Time = now;
+    poSharedData->Statistics.token_counter++;
+}
+
 /* for the MS/TP state machine to use for getting data to send */
 /* Return: amount of PDU data */
 uint16_t MSTP_Get_Send(
@@ -365,6 +399,9 @@ uint16_t MSTP_Get_Send(
     }
 
     (void)timeout;
+    if (mstp_port->FrameCount == 0) {
+        dlmstp_token_received(poSharedData);
+    }
     if (Ringbuf_Empty(&poSharedData->PDU_Queue)) {
         return 0;
     }
@@ -380,6 +417,7 @@ uint16_t MSTP_Get_Send(
             mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
             mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
     (void)Ringbuf_Pop(&poSharedData->PDU_Queue, NULL);
+    poSharedData->Statistics.transmit_frame_counter++;
 
     return pdu_len;
 }
@@ -588,6 +626,7 @@ uint16_t MSTP_Get_Reply(
             mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
     /* This will pop the element no matter where we found it */
     (void)Ringbuf_Pop_Element(&poSharedData->PDU_Queue, (uint8_t *)pkt, NULL);
+    poSharedData->Statistics.transmit_frame_counter++;
 
     return pdu_len;
 }
@@ -839,6 +878,50 @@ void dlmstp_get_broadcast_address(BACNET_ADDRESS *dest)
     return;
 }
 
+/**
+ * @brief Get the packet, queue, and token statistics of a port.  The
+ *  frames per second are the change in transmit_frame_counter over time.
+ * @param poPort - MS/TP port
+ * @param statistics - [out] copy of the port statistics
+ */
+void dlmstp_fill_port_statistics(
+    void *poPort, DLMSTP_PORT_STATISTICS *statistics)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port || !statistics) {
+        return;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return;
+    }
+    *statistics = poSharedData->Statistics;
+    statistics->transmit_queue_peak = Ringbuf_Depth(&poSharedData->PDU_Queue);
+    statistics->receive_queue_peak =
+        Ringbuf_Depth(&poSharedData->Receive_Queue);
+}
+
+/**
+ * @brief Get the number of PDUs waiting for the token
+ * @param poPort - MS/TP port
+ * @return number of PDUs in the send queue
+ */
+unsigned dlmstp_send_pdu_queue_count(void *poPort)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    if (!mstp_port) {
+        return 0;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    if (!poSharedData) {
+        return 0;
+    }
+
+    return Ringbuf_Count(&poSharedData->PDU_Queue);
+}
+
 bool dlmstp_init(void *poPort, char *ifname)
 {
     unsigned long hThread = 0;
@@ -860,8 +943,10 @@ bool dlmstp_init(void *poPort, char *ifname)
     Ringbuf_Init(&poSharedData->PDU_Queue, (uint8_t *)&poSharedData->PDU_Buffer,
         sizeof(struct mstp_pdu_packet), MSTP_PDU_PACKET_COUNT);
     /* initialize packet queue */
-    poSharedData->Receive_Packet.ready = false;
-    poSharedData->Receive_Packet.pdu_len = 0;
+    Ringbuf_Init(&poSharedData->Receive_Queue,
+        (uint8_t *)&poSharedData->Receive_Buffer, sizeof(DLMSTP_PACKET),
+        MSTP_RECEIVE_PACKET_COUNT);
+    memset(&poSharedData->Statistics, 0, sizeof(poSharedData->Statistics));
     rv = sem_init(&poSharedData->Receive_Packet_Flag, 0, 0);
     if (rv != 0) {
         fprintf(stderr,
@@ -27,6 +27,7 @@
 #include "bacnet/datalink/mstp.h"
 /*#include "bacnet/datalink/dlmstp.h" */
 #include <sys/types.h>
+#include <sys/time.h>
 #include <semaphore.h>
 
 #include <stdbool.h>
@@ -47,6 +48,10 @@
 #ifndef MSTP_PDU_PACKET_COUNT
 #define MSTP_PDU_PACKET_COUNT 8
 #endif
+/* count must be a power of 2 for ringbuf library */
+#ifndef MSTP_RECEIVE_PACKET_COUNT
+#define MSTP_RECEIVE_PACKET_COUNT 8
+#endif
 
 typedef struct dlmstp_packet {
     bool ready; /* true if ready to be sent or received */
@@ -64,12 +69,29 @@ struct mstp_pdu_packet {
     uint8_t buffer[DLMSTP_MPDU_MAX];
 };
 
+/* container for packet, queue, and token statistics */
+typedef struct dlmstp_port_statistics {
+    /* data frames sent, and PDUs accepted or dropped for sending */
+    uint32_t transmit_frame_counter;
+    uint32_t transmit_pdu_counter;
+    uint32_t transmit_pdu_dropped;
+    /* PDUs received, and PDUs dropped because the queue was full */
+    uint32_t receive_pdu_counter;
+    uint32_t receive_pdu_dropped;
+    /* highest number of PDUs waiting in each queue */
+    uint32_t transmit_queue_peak;
+    uint32_t receive_queue_peak;
+    /* tokens received, and the time between them */
+    uint32_t token_counter;
+    uint32_t token_rotation_last_ms;
+    uint32_t token_rotation_max_ms;
+} DLMSTP_PORT_STATISTICS;
+
 typedef struct shared_mstp_data {
     /* Number of MS/TP Packets Rx/Tx */
     uint16_t MSTP_Packets;
 
     /* packet queues */
-    DLMSTP_PACKET Receive_Packet;
     DLMSTP_PACKET Transmit_Packet;
     /*
        RT_SEM Receive_Packet_Flag;
@@ -122,6 +144,14 @@ typedef struct shared_mstp_data {
 
     struct mstp_pdu_packet PDU_Buffer[MSTP_PDU_PACKET_COUNT];
 
+    /* received PDUs are stored by the state machine directly into
+       the queue, and copied once into the caller buffer */
+    RING_BUFFER Receive_Queue;
+    DLMSTP_PACKET Receive_Buffer[MSTP_RECEIVE_PACKET_COUNT];
+
+    DLMSTP_PORT_STATISTICS Statistics;
+    struct timeval Token_Time;
+
 } SHARED_MSTP_DATA;
 
 #ifdef __cplusplus
@@ -219,6 +249,14 @@ extern "C" {
     bool dlmstp_sole_master(
         void);
 
+    BACNET_STACK_EXPORT
+    void dlmstp_fill_port_statistics(
+        void *poShared,
+        DLMSTP_PORT_STATISTICS * statistics);
+    BACNET_STACK_EXPORT
+    unsigned dlmstp_send_pdu_queue_count(
+        void *poShared);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Shared memory snapshot of the performance counters, and the
+ *  latency timer, for Linux
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "bacnet/basic/sys/metrics.h"
+
+/**
+ * @brief Map the shared snapshot of the performance counters from a file,
+ *  such as a file in /dev/shm, which another process can map read only.
+ * @param pathname - name of the file
+ * @param writer - true to create and update the snapshot, false to read
+ * @return the shared snapshot, or NULL if the file could not be mapped
+ */
+METRICS_SHARED_DATA *metrics_shared_map(const char *pathname, bool writer)
+{
+    METRICS_SHARED_DATA *shared;
+    size_t size = sizeof(METRICS_SHARED_DATA);
+    struct stat st;
+    int fd;
+
+    if (!pathname) {
+        return NULL;
+    }
+    if (writer) {
+        fd = open(pathname, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            return NULL;
+        }
+        if (ftruncate(fd, (off_t)size) != 0) {
+            close(fd);
+            return NULL;
+        }
+        shared = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    } else {
+        fd = open(pathname, O_RDONLY);
+        if (fd < 0) {
+            return NULL;
+        }
+        if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < size)) {
+            close(fd);
+            return NULL;
+        }
+        shared = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    /* the mapping stays valid after the file is closed */
+    close(fd);
+    if (shared == MAP_FAILED) {
+        return NULL;
+    }
+    if (writer) {
+        metrics_shared_init(shared);
+    }
+
+    return shared;
+}
+
+/**
+ * @brief Unmap the shared snapshot
+ * @param shared - the shared snapshot from metrics_shared_map()
+ */
+void metrics_shared_unmap(METRICS_SHARED_DATA *shared)
+{
+    if (shared) {
+        munmap(shared, sizeof(METRICS_SHARED_DATA));
+    }
+}
+
+/**
+ * @brief Timer for the latency of the service handlers
+ * @return free running microseconds
+ */
+unsigned long metrics_microseconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((unsigned long)now.tv_sec * 1000000UL) +
+        ((unsigned long)now.tv_nsec / 1000UL);
+}
@@ -260,3 +260,46 @@ bool bacnet_address_mac_from_ascii(BACNET_MAC_ADDRESS *mac, const char *arg)
     return status;
 }
 
+/**
+ * @brief Encode a #BACNET_ADDRESS into a fixed size record, such as for
+ *  saving the address in a file
+ * @param record [out] buffer of BACNET_ADDRESS_RECORD_SIZE bytes
+ * @param src [in] #BACNET_ADDRESS to be encoded
+ * @return number of bytes encoded, which is BACNET_ADDRESS_RECORD_SIZE
+ */
+int bacnet_address_record_encode(uint8_t *record, BACNET_ADDRESS *src)
+{
+    if (!(record && src)) {
+        return 0;
+    }
+    encode_unsigned16(&record[0], src->net);
+    record[2] = src->mac_len;
+    record[3] = src->len;
+    memcpy(&record[4], src->mac, MAX_MAC_LEN);
+    memcpy(&record[4 + MAX_MAC_LEN], src->adr, MAX_MAC_LEN);
+
+    return BACNET_ADDRESS_RECORD_SIZE;
+}
+
+/**
+ * @brief Decode a #BACNET_ADDRESS from a fixed size record
+ * @param record [in] buffer of BACNET_ADDRESS_RECORD_SIZE bytes
+ * @param dest [out] #BACNET_ADDRESS to be decoded into
+ * @return number of bytes decoded, or 0 if the lengths are not valid
+ */
+int bacnet_address_record_decode(uint8_t *record, BACNET_ADDRESS *dest)
+{
+    if (!(record && dest)) {
+        return 0;
+    }
+    if ((record[2] > MAX_MAC_LEN) || (record[3] > MAX_MAC_LEN)) {
+        return 0;
+    }
+    decode_unsigned16(&record[0], &dest->net);
+    dest->mac_len = record[2];
+    dest->len = record[3];
+    memcpy(dest->mac, &record[4], MAX_MAC_LEN);
+    memcpy(dest->adr, &record[4 + MAX_MAC_LEN], MAX_MAC_LEN);
+
+    return BACNET_ADDRESS_RECORD_SIZE;
+}
@@ -30,6 +30,10 @@
 #include "bacnet/bacnet_stack_exports.h"
 #include "bacnet/bacdef.h"
 
+/* number of bytes in a fixed size record of a BACNET_ADDRESS:
+   net, mac_len, len, mac, and adr */
+#define BACNET_ADDRESS_RECORD_SIZE (4 + (2 * MAX_MAC_LEN))
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -53,6 +57,11 @@ void bacnet_address_mac_init(
 BACNET_STACK_EXPORT
 bool bacnet_address_mac_from_ascii(BACNET_MAC_ADDRESS *mac, const char *arg);
 
+BACNET_STACK_EXPORT
+int bacnet_address_record_encode(uint8_t *record, BACNET_ADDRESS *src);
+BACNET_STACK_EXPORT
+int bacnet_address_record_decode(uint8_t *record, BACNET_ADDRESS *dest);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
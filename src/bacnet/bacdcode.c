@@ -3147,6 +3147,273 @@ int decode_context_bacnet_address(
     return len;
 }
 
+/**
+ * @brief Encode an array of REAL values as Application Tagged,
+ *  one after the other, as defined in clause 20.2.6 Encoding of a
+ *  Real Number Value and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer of data to be encoded, or NULL for length
+ * @param value - array of values to be encoded
+ * @param count - number of values in the array
+ *
+ * @return the number of apdu bytes encoded
+ */
+int encode_application_real_array(
+    uint8_t *apdu, const float *value, unsigned count)
+{
+    unsigned i;
+
+    if (apdu && value) {
+        for (i = 0; i < count; i++) {
+            /* length of REAL is 4 octets, as per 20.2.6 */
+            apdu[0] = (BACNET_APPLICATION_TAG_REAL << 4) | 4;
+            (void)encode_bacnet_real(value[i], &apdu[1]);
+            apdu += 5;
+        }
+    }
+
+    return (int)(count * 5);
+}
+
+/**
+ * @brief Encode an array of Unsigned values as Application Tagged,
+ *  one after the other, as defined in clause 20.2.4 Encoding of an
+ *  Unsigned Integer Value and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer of data to be encoded, or NULL for length
+ * @param value - array of values to be encoded
+ * @param count - number of values in the array
+ *
+ * @return the number of apdu bytes encoded
+ */
+int encode_application_unsigned_array(
+    uint8_t *apdu, const BACNET_UNSIGNED_INTEGER *value, unsigned count)
+{
+    int apdu_len = 0;
+    int len = 0;
+    unsigned i;
+
+    if (!value) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        len = bacnet_unsigned_length(value[i]);
+        if (apdu) {
+            /* the length fits in the tag octet up to 4 octets */
+            if (len <= 4) {
+                apdu[0] = (BACNET_APPLICATION_TAG_UNSIGNED_INT << 4) | len;
+                len = 1;
+            } else {
+                len = encode_tag(apdu, BACNET_APPLICATION_TAG_UNSIGNED_INT,
+                    false, (uint32_t)len);
+            }
+            len += encode_bacnet_unsigned(&apdu[len], value[i]);
+            apdu += len;
+        } else {
+            len += (len <= 4) ? 1 : 2;
+        }
+        apdu_len += len;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode an array of Enumerated values as Application Tagged,
+ *  one after the other, as defined in clause 20.2.11 Encoding of an
+ *  Enumerated Value and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer of data to be encoded, or NULL for length
+ * @param value - array of values to be encoded
+ * @param count - number of values in the array
+ *
+ * @return the number of apdu bytes encoded
+ */
+int encode_application_enumerated_array(
+    uint8_t *apdu, const uint32_t *value, unsigned count)
+{
+    int apdu_len = 0;
+    int len = 0;
+    unsigned i;
+
+    if (!value) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        /* an enumerated value is at most 4 octets, so the length
+           always fits in the tag octet */
+        len = bacnet_unsigned_length(value[i]);
+        if (apdu) {
+            apdu[0] = (BACNET_APPLICATION_TAG_ENUMERATED << 4) | len;
+            (void)encode_bacnet_unsigned(&apdu[1], value[i]);
+            apdu += len + 1;
+        }
+        apdu_len += len + 1;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode an array of Application Tagged REAL values
+ *  that are encoded one after the other
+ *
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param value - array to store the decoded values, or NULL
+ * @param count - number of values to decode
+ *
+ * @return the number of apdu bytes decoded, or #BACNET_STATUS_ERROR (-1)
+ *  if fewer than count REAL values are in the buffer
+ */
+int bacnet_real_application_array_decode(
+    uint8_t *apdu, uint32_t apdu_size, float *value, unsigned count)
+{
+    uint32_t apdu_len = 0;
+    unsigned i;
+
+    if (!apdu || (apdu_size < (count * 5))) {
+        return BACNET_STATUS_ERROR;
+    }
+    for (i = 0; i < count; i++) {
+        if (apdu[apdu_len] != ((BACNET_APPLICATION_TAG_REAL << 4) | 4)) {
+            return BACNET_STATUS_ERROR;
+        }
+        if (value) {
+            (void)decode_real(&apdu[apdu_len + 1], &value[i]);
+        }
+        apdu_len += 5;
+    }
+
+    return (int)apdu_len;
+}
+
+/**
+ * @brief Decode an array of Application Tagged Unsigned or Enumerated
+ *  values that are encoded one after the other
+ *
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param tag_number - BACNET_APPLICATION_TAG_UNSIGNED_INT or
+ *  BACNET_APPLICATION_TAG_ENUMERATED
+ * @param value - array to store the decoded values, or NULL
+ * @param count - number of values to decode
+ *
+ * @return the number of apdu bytes decoded, or #BACNET_STATUS_ERROR (-1)
+ *  if fewer than count values are in the buffer
+ */
+static int bacnet_unsigned_tagged_array_decode(uint8_t *apdu,
+    uint32_t apdu_size,
+    uint8_t tag_number,
+    BACNET_UNSIGNED_INTEGER *value,
+    unsigned count)
+{
+    uint32_t apdu_len = 0;
+    uint32_t len_value = 0;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    uint8_t decoded_tag_number = 0;
+    int len = 0;
+    unsigned i;
+
+    if (!apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    for (i = 0; i < count; i++) {
+        if (apdu_len >= apdu_size) {
+            return BACNET_STATUS_ERROR;
+        }
+        if (((apdu[apdu_len] & 0xF8) == (tag_number << 4)) &&
+            ((apdu[apdu_len] & 0x07) <= 4)) {
+            /* application tag with the length in the tag octet */
+            len_value = apdu[apdu_len] & 0x07;
+            len = 1;
+        } else {
+            len = bacnet_tag_number_and_value_decode(&apdu[apdu_len],
+                apdu_size - apdu_len, &decoded_tag_number, &len_value);
+            if ((len <= 0) || IS_CONTEXT_SPECIFIC(apdu[apdu_len]) ||
+                (decoded_tag_number != tag_number)) {
+                return BACNET_STATUS_ERROR;
+            }
+        }
+        apdu_len += len;
+        if ((apdu_len + len_value) > apdu_size) {
+            return BACNET_STATUS_ERROR;
+        }
+        len = bacnet_unsigned_decode(
+            &apdu[apdu_len], (uint16_t)len_value, len_value, &unsigned_value);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        if (value) {
+            value[i] = unsigned_value;
+        }
+        apdu_len += len;
+    }
+
+    return (int)apdu_len;
+}
+
+/**
+ * @brief Decode an array of Application Tagged Unsigned values
+ *  that are encoded one after the other
+ *
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param value - array to store the decoded values, or NULL
+ * @param count - number of values to decode
+ *
+ * @return the number of apdu bytes decoded, or #BACNET_STATUS_ERROR (-1)
+ *  if fewer than count Unsigned values are in the buffer
+ */
+int bacnet_unsigned_application_array_decode(uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_UNSIGNED_INTEGER *value,
+    unsigned count)
+{
+    return bacnet_unsigned_tagged_array_decode(apdu, apdu_size,
+        BACNET_APPLICATION_TAG_UNSIGNED_INT, value, count);
+}
+
+/**
+ * @brief Decode an array of Application Tagged Enumerated values
+ *  that are encoded one after the other
+ *
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param value - array to store the decoded values, or NULL
+ * @param count - number of values to decode
+ *
+ * @return the number of apdu bytes decoded, or #BACNET_STATUS_ERROR (-1)
+ *  if fewer than count Enumerated values are in the buffer
+ */
+int bacnet_enumerated_application_array_decode(
+    uint8_t *apdu, uint32_t apdu_size, uint32_t *value, unsigned count)
+{
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    int apdu_len = 0;
+    int len = 0;
+    unsigned i;
+
+    if (!apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    /* one at a time, since the value array is not the unsigned type */
+    for (i = 0; i < count; i++) {
+        len = bacnet_unsigned_tagged_array_decode(&apdu[apdu_len],
+            apdu_size - (uint32_t)apdu_len, BACNET_APPLICATION_TAG_ENUMERATED,
+            &unsigned_value, 1);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        if (value) {
+            value[i] = (uint32_t)unsigned_value;
+        }
+        apdu_len += len;
+    }
+
+    return apdu_len;
+}
+
 /**
  * @brief Encode a BACnetARRAY property value
  * @param object_instance [in] BACnet network port object instance number
@@ -644,6 +644,41 @@ bool bacnet_is_context_specific(uint8_t *apdu, uint32_t apdu_size);
         uint8_t *apdu,
         int max_apdu);
 
+/* arrays of application tagged values, encoded one after the other */
+    BACNET_STACK_EXPORT
+    int encode_application_real_array(
+        uint8_t * apdu,
+        const float *value,
+        unsigned count);
+    BACNET_STACK_EXPORT
+    int encode_application_unsigned_array(
+        uint8_t * apdu,
+        const BACNET_UNSIGNED_INTEGER *value,
+        unsigned count);
+    BACNET_STACK_EXPORT
+    int encode_application_enumerated_array(
+        uint8_t * apdu,
+        const uint32_t *value,
+        unsigned count);
+    BACNET_STACK_EXPORT
+    int bacnet_real_application_array_decode(
+        uint8_t * apdu,
+        uint32_t apdu_size,
+        float *value,
+        unsigned count);
+    BACNET_STACK_EXPORT
+    int bacnet_unsigned_application_array_decode(
+        uint8_t * apdu,
+        uint32_t apdu_size,
+        BACNET_UNSIGNED_INTEGER *value,
+        unsigned count);
+    BACNET_STACK_EXPORT
+    int bacnet_enumerated_application_array_decode(
+        uint8_t * apdu,
+        uint32_t apdu_size,
+        uint32_t *value,
+        unsigned count);
+
 /* from clause 20.2.1.2 Tag Number */
 /* true if extended tag numbering is used */
 #define IS_EXTENDED_TAG_NUMBER(x) (((x) & 0xF0) == 0xF0)
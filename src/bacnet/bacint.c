@@ -36,16 +36,41 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "bacnet/config.h"
 #include "bacnet/bacint.h"
+#include "bacnet/basic/sys/bigend.h"
 
 /** @file bacint.c  Encode/Decode Integer Types */
 
+/* When the byte order is known at compile time, the 16, 32, and 64-bit
+   values are stored and loaded with one unaligned-safe copy and, on
+   little-endian hosts, one byte swap instruction. */
+#if defined(BACNET_BIG_ENDIAN) && (defined(__GNUC__) || defined(__clang__))
+#define BACINT_BYTE_SWAP 1
+#if BACNET_BIG_ENDIAN
+#define BACINT_NETWORK16(x) (x)
+#define BACINT_NETWORK32(x) (x)
+#define BACINT_NETWORK64(x) (x)
+#else
+#define BACINT_NETWORK16(x) __builtin_bswap16(x)
+#define BACINT_NETWORK32(x) __builtin_bswap32(x)
+#define BACINT_NETWORK64(x) __builtin_bswap64(x)
+#endif
+#else
+#define BACINT_BYTE_SWAP 0
+#endif
+
 int encode_unsigned16(uint8_t *apdu, uint16_t value)
 {
     if (apdu) {
+#if BACINT_BYTE_SWAP
+        value = BACINT_NETWORK16(value);
+        memcpy(apdu, &value, 2);
+#else
         apdu[0] = (uint8_t)((value & 0xff00) >> 8);
         apdu[1] = (uint8_t)(value & 0x00ff);
+#endif
     }
 
     return 2;
@@ -54,8 +79,13 @@ int encode_unsigned16(uint8_t *apdu, uint16_t value)
 int decode_unsigned16(uint8_t *apdu, uint16_t *value)
 {
     if (apdu && value) {
+#if BACINT_BYTE_SWAP
+        memcpy(value, apdu, 2);
+        *value = BACINT_NETWORK16(*value);
+#else
         *value = (uint16_t)((((uint16_t)apdu[0]) << 8) & 0xff00);
         *value |= ((uint16_t)(((uint16_t)apdu[1]) & 0x00ff));
+#endif
     }
 
     return 2;
@@ -86,10 +116,15 @@ int decode_unsigned24(uint8_t *apdu, uint32_t *value)
 int encode_unsigned32(uint8_t *apdu, uint32_t value)
 {
     if (apdu) {
+#if BACINT_BYTE_SWAP
+        value = BACINT_NETWORK32(value);
+        memcpy(apdu, &value, 4);
+#else
         apdu[0] = (uint8_t)((value & 0xff000000) >> 24);
         apdu[1] = (uint8_t)((value & 0x00ff0000) >> 16);
         apdu[2] = (uint8_t)((value & 0x0000ff00) >> 8);
         apdu[3] = (uint8_t)(value & 0x000000ff);
+#endif
     }
 
     return 4;
@@ -98,10 +133,15 @@ int encode_unsigned32(uint8_t *apdu, uint32_t value)
 int decode_unsigned32(uint8_t *apdu, uint32_t *value)
 {
     if (apdu && value) {
+#if BACINT_BYTE_SWAP
+        memcpy(value, apdu, 4);
+        *value = BACINT_NETWORK32(*value);
+#else
         *value = ((uint32_t)((((uint32_t)apdu[0]) << 24) & 0xff000000));
         *value |= ((uint32_t)((((uint32_t)apdu[1]) << 16) & 0x00ff0000));
         *value |= ((uint32_t)((((uint32_t)apdu[2]) << 8) & 0x0000ff00));
         *value |= ((uint32_t)(((uint32_t)apdu[3]) & 0x000000ff));
+#endif
     }
 
     return 4;
@@ -252,6 +292,10 @@ int decode_unsigned56(uint8_t *buffer, uint64_t *value)
 int encode_unsigned64(uint8_t *buffer, uint64_t value)
 {
     if (buffer) {
+#if BACINT_BYTE_SWAP
+        value = BACINT_NETWORK64(value);
+        memcpy(buffer, &value, 8);
+#else
         buffer[0] = (uint8_t)((value & 0xff00000000000000ULL) >> 56);
         buffer[1] = (uint8_t)((value & 0x00ff000000000000ULL) >> 48);
         buffer[2] = (uint8_t)((value & 0x0000ff0000000000ULL) >> 40);
@@ -260,6 +304,7 @@ int encode_unsigned64(uint8_t *buffer, uint64_t value)
         buffer[5] = (uint8_t)((value & 0x0000000000ff0000ULL) >> 16);
         buffer[6] = (uint8_t)((value & 0x000000000000ff00ULL) >> 8);
         buffer[7] = (uint8_t)(value & 0x00000000000000ffULL);
+#endif
     }
 
     return 8;
@@ -274,6 +319,10 @@ int encode_unsigned64(uint8_t *buffer, uint64_t value)
 int decode_unsigned64(uint8_t *buffer, uint64_t *value)
 {
     if (buffer && value) {
+#if BACINT_BYTE_SWAP
+        memcpy(value, buffer, 8);
+        *value = BACINT_NETWORK64(*value);
+#else
         *value =
             ((uint64_t)((((uint64_t)buffer[0]) << 56) & 0xff00000000000000ULL));
         *value |=
@@ -289,6 +338,7 @@ int decode_unsigned64(uint8_t *buffer, uint64_t *value)
         *value |=
             ((uint64_t)((((uint64_t)buffer[6]) << 8) & 0x000000000000ff00ULL));
         *value |= ((uint64_t)(((uint64_t)buffer[7]) & 0x00000000000000ffULL));
+#endif
     }
 
     return 8;
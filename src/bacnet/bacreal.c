@@ -52,23 +52,14 @@
 int decode_real(uint8_t *apdu, float *real_value)
 {
     union {
-        uint8_t byte[4];
+        uint32_t bits;
         float real_value;
     } my_data;
 
     if (apdu) {
-        /* NOTE: assumes the compiler stores float as IEEE-754 float */
-        if (big_endian()) {
-            my_data.byte[0] = apdu[0];
-            my_data.byte[1] = apdu[1];
-            my_data.byte[2] = apdu[2];
-            my_data.byte[3] = apdu[3];
-        } else {
-            my_data.byte[0] = apdu[3];
-            my_data.byte[1] = apdu[2];
-            my_data.byte[2] = apdu[1];
-            my_data.byte[3] = apdu[0];
-        }
+        /* NOTE: assumes the compiler stores float as IEEE-754 float,
+           in the same byte order as a 32-bit integer */
+        (void)decode_unsigned32(apdu, &my_data.bits);
         if (real_value) {
             *real_value = my_data.real_value;
         }
@@ -94,24 +85,15 @@ int decode_real_safe(uint8_t *apdu, uint32_t len_value, float *real_value)
 int encode_bacnet_real(float value, uint8_t *apdu)
 {
     union {
-        uint8_t byte[4];
+        uint32_t bits;
         float real_value;
     } my_data;
 
-    /* NOTE: assumes the compiler stores float as IEEE-754 float */
+    /* NOTE: assumes the compiler stores float as IEEE-754 float,
+       in the same byte order as a 32-bit integer */
     my_data.real_value = value;
     if (apdu) {
-        if (big_endian()) {
-            apdu[0] = my_data.byte[0];
-            apdu[1] = my_data.byte[1];
-            apdu[2] = my_data.byte[2];
-            apdu[3] = my_data.byte[3];
-        } else {
-            apdu[0] = my_data.byte[3];
-            apdu[1] = my_data.byte[2];
-            apdu[2] = my_data.byte[1];
-            apdu[3] = my_data.byte[0];
-        }
+        (void)encode_unsigned32(apdu, my_data.bits);
     }
 
     return 4;
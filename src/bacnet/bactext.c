@@ -43,31 +43,58 @@
 static const char *ASHRAE_Reserved_String = "Reserved for Use by ASHRAE";
 static const char *Vendor_Proprietary_String = "Vendor Proprietary Value";
 
+/* The large lists - object types, properties, and engineering units - are
+   searched with a sorted index, which costs 4 bytes of RAM per entry.
+   Set to 0 for the linear search on small targets. */
+#ifndef BACTEXT_INDEX_ENABLED
+#define BACTEXT_INDEX_ENABLED 1
+#endif
+
+/* Convert the whole text to an integer value */
+static bool bactext_strtol(const char *search_name, unsigned *found_index)
+{
+    char *endptr;
+    long value;
+
+    value = strtol(search_name, &endptr, 0);
+    if (endptr == search_name) {
+        /* No digits found */
+        return false;
+    } else if (*endptr != '\0') {
+        /* Extra text found */
+        return false;
+    } else {
+        *found_index = (unsigned)value;
+        return true;
+    }
+}
+
 /* Search for a text value first based on the corresponding text list, then by
  * attempting to convert to an integer value. */
 static bool bactext_strtol_index(
     INDTEXT_DATA *istring, const char *search_name, unsigned *found_index)
 {
-    char *endptr;
-    long value;
-
     if (indtext_by_istring(istring, search_name, found_index) == true) {
         return true;
-    } else {
-        value = strtol(search_name, &endptr, 0);
-        if (endptr == search_name) {
-            /* No digits found */
-            return false;
-        } else if (*endptr != '\0') {
-            /* Extra text found */
-            return false;
-        } else {
-            *found_index = (unsigned)value;
-            return true;
-        }
     }
+
+    return bactext_strtol(search_name, found_index);
 }
 
+#if BACTEXT_INDEX_ENABLED
+/* Search for a text value first based on the sorted index of the text list,
+ * then by attempting to convert to an integer value. */
+static bool bactext_strtol_sorted(
+    INDTEXT_INDEX *index, const char *search_name, unsigned *found_index)
+{
+    if (indtext_index_by_istring(index, search_name, found_index) == true) {
+        return true;
+    }
+
+    return bactext_strtol(search_name, found_index);
+}
+#endif
+
 INDTEXT_DATA bacnet_confirmed_service_names[] = {
     { SERVICE_CONFIRMED_ACKNOWLEDGE_ALARM, "Acknowledge-Alarm" },
     { SERVICE_CONFIRMED_COV_NOTIFICATION, "COV-Notification" },
@@ -243,23 +270,48 @@ INDTEXT_DATA bacnet_object_type_names[] = { { OBJECT_ANALOG_INPUT,
        the procedures and constraints described in Clause 23. */
     { 0, NULL } };
 
+#if BACTEXT_INDEX_ENABLED
+static uint16_t Object_Type_By_String[sizeof(bacnet_object_type_names) /
+    sizeof(bacnet_object_type_names[0])];
+static uint16_t Object_Type_By_Index[sizeof(bacnet_object_type_names) /
+    sizeof(bacnet_object_type_names[0])];
+static INDTEXT_INDEX Object_Type_Index = INDTEXT_INDEX_INIT(
+    bacnet_object_type_names, Object_Type_By_String, Object_Type_By_Index);
+#endif
+
 const char *bactext_object_type_name(unsigned index)
 {
+#if BACTEXT_INDEX_ENABLED
+    return indtext_index_by_index_default(&Object_Type_Index, index,
+        (index < OBJECT_PROPRIETARY_MIN) ? ASHRAE_Reserved_String
+                                         : Vendor_Proprietary_String);
+#else
     return indtext_by_index_split_default(bacnet_object_type_names, index,
         OBJECT_PROPRIETARY_MIN, ASHRAE_Reserved_String,
         Vendor_Proprietary_String);
+#endif
 }
 
 bool bactext_object_type_index(const char *search_name, unsigned *found_index)
 {
+#if BACTEXT_INDEX_ENABLED
+    return indtext_index_by_istring(
+        &Object_Type_Index, search_name, found_index);
+#else
     return indtext_by_istring(
         bacnet_object_type_names, search_name, found_index);
+#endif
 }
 
 bool bactext_object_type_strtol(const char *search_name, unsigned *found_index)
 {
+#if BACTEXT_INDEX_ENABLED
+    return bactext_strtol_sorted(
+        &Object_Type_Index, search_name, found_index);
+#else
     return bactext_strtol_index(
         bacnet_object_type_names, search_name, found_index);
+#endif
 }
 
 INDTEXT_DATA bacnet_property_names[] = {
@@ -747,6 +799,15 @@ INDTEXT_DATA bacnet_property_names[] = {
     { PROP_TRIM_FADE_TIME, "trim-fade-time" }, { 0, NULL }
 };
 
+#if BACTEXT_INDEX_ENABLED
+static uint16_t Property_By_String[sizeof(bacnet_property_names) /
+    sizeof(bacnet_property_names[0])];
+static uint16_t Property_By_Index[sizeof(bacnet_property_names) /
+    sizeof(bacnet_property_names[0])];
+static INDTEXT_INDEX Property_Index = INDTEXT_INDEX_INIT(
+    bacnet_property_names, Property_By_String, Property_By_Index);
+#endif
+
 bool bactext_property_name_proprietary(unsigned index)
 {
     bool status = false;
@@ -767,32 +828,50 @@ const char *bactext_property_name(unsigned index)
     if (bactext_property_name_proprietary(index)) {
         return Vendor_Proprietary_String;
     } else {
-        return indtext_by_index_default(
-            bacnet_property_names, index, ASHRAE_Reserved_String);
+        return bactext_property_name_default(index, ASHRAE_Reserved_String);
     }
 }
 
 const char *bactext_property_name_default(
     unsigned index, const char *default_string)
 {
+#if BACTEXT_INDEX_ENABLED
+    return indtext_index_by_index_default(
+        &Property_Index, index, default_string);
+#else
     return indtext_by_index_default(
         bacnet_property_names, index, default_string);
+#endif
 }
 
 unsigned bactext_property_id(const char *name)
 {
-    return indtext_by_istring_default(bacnet_property_names, name, 0);
+    unsigned index = 0;
+
+    if (!bactext_property_index(name, &index)) {
+        index = 0;
+    }
+
+    return index;
 }
 
 bool bactext_property_index(const char *search_name, unsigned *found_index)
 {
+#if BACTEXT_INDEX_ENABLED
+    return indtext_index_by_istring(&Property_Index, search_name, found_index);
+#else
     return indtext_by_istring(bacnet_property_names, search_name, found_index);
+#endif
 }
 
 bool bactext_property_strtol(const char *search_name, unsigned *found_index)
 {
+#if BACTEXT_INDEX_ENABLED
+    return bactext_strtol_sorted(&Property_Index, search_name, found_index);
+#else
     return bactext_strtol_index(
         bacnet_property_names, search_name, found_index);
+#endif
 }
 
 INDTEXT_DATA bacnet_engineering_unit_names[] = {
@@ -1029,6 +1108,16 @@ INDTEXT_DATA bacnet_engineering_unit_names[] = {
        the procedures and constraints described in Clause 23. */
 };
 
+#if BACTEXT_INDEX_ENABLED
+static uint16_t Engineering_Unit_By_String[sizeof(
+    bacnet_engineering_unit_names) / sizeof(bacnet_engineering_unit_names[0])];
+static uint16_t Engineering_Unit_By_Index[sizeof(
+    bacnet_engineering_unit_names) / sizeof(bacnet_engineering_unit_names[0])];
+static INDTEXT_INDEX Engineering_Unit_Index =
+    INDTEXT_INDEX_INIT(bacnet_engineering_unit_names,
+        Engineering_Unit_By_String, Engineering_Unit_By_Index);
+#endif
+
 bool bactext_engineering_unit_name_proprietary(unsigned index)
 {
     bool status = false;
@@ -1049,8 +1138,13 @@ const char *bactext_engineering_unit_name(unsigned index)
     if (bactext_engineering_unit_name_proprietary(index)) {
         return Vendor_Proprietary_String;
     } else if (index <= UNITS_RESERVED_RANGE_MAX2) {
+#if BACTEXT_INDEX_ENABLED
+        return indtext_index_by_index_default(
+            &Engineering_Unit_Index, index, ASHRAE_Reserved_String);
+#else
         return indtext_by_index_default(
             bacnet_engineering_unit_names, index, ASHRAE_Reserved_String);
+#endif
     }
 
     return ASHRAE_Reserved_String;
@@ -1059,8 +1153,13 @@ const char *bactext_engineering_unit_name(unsigned index)
 bool bactext_engineering_unit_index(
     const char *search_name, unsigned *found_index)
 {
+#if BACTEXT_INDEX_ENABLED
+    return indtext_index_by_istring(
+        &Engineering_Unit_Index, search_name, found_index);
+#else
     return indtext_by_istring(
         bacnet_engineering_unit_names, search_name, found_index);
+#endif
 }
 
 INDTEXT_DATA bacnet_reject_reason_names[] = { { REJECT_REASON_OTHER, "Other" },
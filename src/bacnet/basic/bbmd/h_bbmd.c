@@ -41,6 +41,7 @@
 #include "bacnet/datalink/bip.h"
 #include "bacnet/datalink/bvlc.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 
@@ -578,6 +579,7 @@ int bvlc_send_pdu(BACNET_ADDRESS *dest,
     BACNET_IP_ADDRESS bvlc_dest = { 0 };
     uint8_t mtu[BIP_MPDU_MAX] = { 0 };
     uint16_t mtu_len = 0;
+    int bytes_sent = 0;
 #if BBMD_ENABLED
     BACNET_IP_ADDRESS bip_src = { 0 };
 #endif
@@ -625,10 +627,18 @@ int bvlc_send_pdu(BACNET_ADDRESS *dest,
         debug_print_bip("Send Original-Unicast-NPDU", &bvlc_dest);
     } else {
         debug_print_string("Send failure. Invalid Address.");
+        METRICS_COUNT(METRICS_DATALINK_TX_DROPPED);
         return -1;
     }
+    bytes_sent = bip_send_mpdu(&bvlc_dest, mtu, mtu_len);
+    if (bytes_sent > 0) {
+        METRICS_COUNT(METRICS_DATALINK_TX_PACKETS);
+        METRICS_ADD(METRICS_DATALINK_TX_BYTES, (uint32_t)bytes_sent);
+    } else {
+        METRICS_COUNT(METRICS_DATALINK_TX_DROPPED);
+    }
 
-    return bip_send_mpdu(&bvlc_dest, mtu, mtu_len);
+    return bytes_sent;
 }
 
 /**
@@ -723,6 +733,7 @@ int bvlc_bbmd_disabled_handler(BACNET_IP_ADDRESS *addr,
                     debug_print_npdu("Forwarded-NPDU", offset, npdu_len);
                 } else {
                     debug_print_string("Forwarded-NPDU: Unable to decode!");
+                    METRICS_COUNT(METRICS_DATALINK_RX_DROPPED);
                 }
                 break;
             case BVLC_REGISTER_FOREIGN_DEVICE:
@@ -763,6 +774,7 @@ int bvlc_bbmd_disabled_handler(BACNET_IP_ADDRESS *addr,
                 } else {
                     debug_print_string(
                         "Original-Unicast-NPDU: Unable to decode!");
+                    METRICS_COUNT(METRICS_DATALINK_RX_DROPPED);
                 }
                 break;
             case BVLC_ORIGINAL_BROADCAST_NPDU:
@@ -786,6 +798,7 @@ int bvlc_bbmd_disabled_handler(BACNET_IP_ADDRESS *addr,
                         offset = 0;
                         debug_print_string("Original-Broadcast-NPDU: "
                                            "Confirmed Service! Discard!");
+                        METRICS_COUNT(METRICS_DATALINK_RX_DROPPED);
                     } else {
                         debug_print_npdu(
                             "Original-Broadcast-NPDU", offset, npdu_len);
@@ -793,6 +806,7 @@ int bvlc_bbmd_disabled_handler(BACNET_IP_ADDRESS *addr,
                 } else {
                     debug_print_string(
                         "Original-Broadcast-NPDU: Unable to decode!");
+                    METRICS_COUNT(METRICS_DATALINK_RX_DROPPED);
                 }
                 break;
             case BVLC_SECURE_BVLL:
@@ -804,6 +818,8 @@ int bvlc_bbmd_disabled_handler(BACNET_IP_ADDRESS *addr,
             bvlc_send_result(addr, result_code);
             debug_print_unsigned("Sent result code =", result_code);
         }
+    } else {
+        METRICS_COUNT(METRICS_DATALINK_RX_DROPPED);
     }
 
     return offset;
@@ -844,6 +860,7 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
     header_len =
         bvlc_decode_header(mtu, mtu_len, &message_type, &message_length);
     if (header_len != 4) {
+        METRICS_COUNT(METRICS_DATALINK_RX_DROPPED);
         return 0;
     }
     BVLC_Function_Code = message_type;
@@ -1070,6 +1087,7 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
             } else {
                 debug_print_string(
                     "Original-Broadcast-NPDU: Unable to decode!");
+                METRICS_COUNT(METRICS_DATALINK_RX_DROPPED);
             }
             break;
         case BVLC_ORIGINAL_BROADCAST_NPDU:
@@ -1107,6 +1125,7 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                     offset = 0;
                     debug_print_string("Original-Broadcast-NPDU: "
                                        "Confirmed Service! Discard!");
+                    METRICS_COUNT(METRICS_DATALINK_RX_DROPPED);
                 } else {
                     (void)bbmd_fdt_forward_npdu(addr, npdu, npdu_len, true);
                     (void)bbmd_bdt_forward_npdu(addr, npdu, npdu_len, true);
@@ -1116,6 +1135,7 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
             } else {
                 debug_print_string(
                     "Original-Broadcast-NPDU: Unable to decode!");
+                METRICS_COUNT(METRICS_DATALINK_RX_DROPPED);
             }
             break;
         case BVLC_SECURE_BVLL:
@@ -1149,6 +1169,8 @@ int bvlc_handler(BACNET_IP_ADDRESS *addr,
     uint8_t *npdu,
     uint16_t npdu_len)
 {
+    METRICS_COUNT(METRICS_DATALINK_RX_PACKETS);
+    METRICS_ADD(METRICS_DATALINK_RX_BYTES, npdu_len);
 #if BBMD_ENABLED
     debug_print_bip("Received BVLC (BBMD Enabled)", addr);
     return bvlc_bbmd_enabled_handler(addr, src, npdu, npdu_len);
@@ -1341,6 +1363,105 @@ void bvlc_bdt_list_clear(void)
     /* BDT changed! Save backup to file */
     bvlc_bdt_backup_local();
 }
+
+/**
+ * @brief Get the number of BDT entries for a warm start snapshot
+ * @return number of entries, some of which might not be valid
+ */
+uint32_t bvlc_bdt_snapshot_count(void)
+{
+    return MAX_BBMD_ENTRIES;
+}
+
+/**
+ * @brief Encode a BDT entry as a warm start snapshot record
+ * @param index - entry 0..bvlc_bdt_snapshot_count()-1
+ * @param record - [out] BACNET_IP_BDT_ENTRY_SIZE bytes
+ * @return true if the entry was encoded
+ */
+bool bvlc_bdt_snapshot_encode(uint32_t index, uint8_t *record)
+{
+    if ((index >= MAX_BBMD_ENTRIES) || !BBMD_Table[index].valid) {
+        return false;
+    }
+
+    return bvlc_encode_broadcast_distribution_table_entry(record,
+               BACNET_IP_BDT_ENTRY_SIZE, &BBMD_Table[index]) > 0;
+}
+
+/**
+ * @brief Restore a warm start snapshot record into the BDT.  The BDT in
+ *  the snapshot replaces the whole BDT, as with bvlc_bdt_restore_local().
+ * @param index - record 0..N-1 of the snapshot
+ * @param record - BACNET_IP_BDT_ENTRY_SIZE bytes
+ * @return true if the record was restored
+ */
+bool bvlc_bdt_snapshot_restore(uint32_t index, uint8_t *record)
+{
+    if (index == 0) {
+        bvlc_broadcast_distribution_table_valid_clear(&BBMD_Table[0]);
+    }
+    if ((index >= MAX_BBMD_ENTRIES) ||
+        (bvlc_decode_broadcast_distribution_table_entry(record,
+             BACNET_IP_BDT_ENTRY_SIZE, &BBMD_Table[index]) <= 0)) {
+        return false;
+    }
+    BBMD_Table[index].valid = true;
+
+    return true;
+}
+
+/**
+ * @brief Get the number of FDT entries for a warm start snapshot
+ * @return number of entries, some of which might not be valid
+ */
+uint32_t bvlc_fdt_snapshot_count(void)
+{
+    return MAX_FD_ENTRIES;
+}
+
+/**
+ * @brief Encode an FDT entry, with its remaining time to live, as a warm
+ *  start snapshot record
+ * @param index - entry 0..bvlc_fdt_snapshot_count()-1
+ * @param record - [out] BACNET_IP_FDT_ENTRY_SIZE bytes
+ * @return true if the entry was encoded
+ */
+bool bvlc_fdt_snapshot_encode(uint32_t index, uint8_t *record)
+{
+    if ((index >= MAX_FD_ENTRIES) || !FD_Table[index].valid) {
+        return false;
+    }
+
+    return bvlc_encode_foreign_device_table_entry(
+               record, BACNET_IP_FDT_ENTRY_SIZE, &FD_Table[index]) > 0;
+}
+
+/**
+ * @brief Restore a warm start snapshot record into the FDT, so that the
+ *  foreign devices are not lost until they register again
+ * @param index - record 0..N-1 of the snapshot
+ * @param record - BACNET_IP_FDT_ENTRY_SIZE bytes
+ * @return true if the record was restored
+ */
+bool bvlc_fdt_snapshot_restore(uint32_t index, uint8_t *record)
+{
+    unsigned i;
+
+    if (index == 0) {
+        for (i = 0; i < MAX_FD_ENTRIES; i++) {
+            FD_Table[i].valid = false;
+        }
+    }
+    if ((index >= MAX_FD_ENTRIES) ||
+        (bvlc_decode_foreign_device_table_entry(
+             record, BACNET_IP_FDT_ENTRY_SIZE, &FD_Table[index]) <= 0)) {
+        return false;
+    }
+    FD_Table[index].valid = (FD_Table[index].ttl_seconds_remaining > 0);
+
+    return FD_Table[index].valid;
+}
 #endif
 
 /**
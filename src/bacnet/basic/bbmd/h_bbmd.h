@@ -143,6 +143,22 @@ void bvlc_bdt_backup_local(void);
 BACNET_STACK_EXPORT
 void bvlc_bdt_restore_local(void);
 
+/* Warm start snapshot of the BDT and the FDT - see snapshot.h */
+#define BVLC_BDT_SNAPSHOT_VERSION 1
+#define BVLC_FDT_SNAPSHOT_VERSION 1
+BACNET_STACK_EXPORT
+uint32_t bvlc_bdt_snapshot_count(void);
+BACNET_STACK_EXPORT
+bool bvlc_bdt_snapshot_encode(uint32_t index, uint8_t *record);
+BACNET_STACK_EXPORT
+bool bvlc_bdt_snapshot_restore(uint32_t index, uint8_t *record);
+BACNET_STACK_EXPORT
+uint32_t bvlc_fdt_snapshot_count(void);
+BACNET_STACK_EXPORT
+bool bvlc_fdt_snapshot_encode(uint32_t index, uint8_t *record);
+BACNET_STACK_EXPORT
+bool bvlc_fdt_snapshot_restore(uint32_t index, uint8_t *record);
+
 /* Set global IP address of a NAT enabled router which is used in forwarded
  * messages. Enables NAT handling.
  */
@@ -36,6 +36,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bacnet/bits.h"
 #include "bacnet/config.h"
 #include "bacnet/bacaddr.h"
@@ -44,6 +45,7 @@
 #include "bacnet/readrange.h"
 #include "bacnet/basic/binding/address.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/npdu/h_npdu.h"
 
 /* we are likely compiling the demo command line tools if print enabled */
 #if !defined(BACNET_ADDRESS_CACHE_FILE)
@@ -58,8 +60,6 @@
 /* occurs in BACnet.  A device id is bound to a MAC address. */
 /* The normal method is using Who-Is, and using the data from I-Am */
 
-static uint32_t Top_Protected_Entry;
-static uint32_t Own_Device_ID = 0xFFFFFFFF;
 
 /* The address cache is used for binding to BACnet devices */
 /* The number of entries corresponds to the number of */
@@ -70,13 +70,24 @@ static uint32_t Own_Device_ID = 0xFFFFFFFF;
 #define MAX_ADDRESS_CACHE 255
 #endif
 
-static struct Address_Cache_Entry {
+struct Address_Cache_Entry {
     uint8_t Flags;
     uint32_t device_id;
     unsigned max_apdu;
     BACNET_ADDRESS address;
     uint32_t TimeToLive;
-} Address_Cache[MAX_ADDRESS_CACHE];
+};
+
+struct address_context {
+    uint32_t Top_Protected_Entry;
+    uint32_t Own_Device_ID;
+    struct Address_Cache_Entry Cache[MAX_ADDRESS_CACHE];
+};
+static struct address_context Address_Default = { 0, 0xFFFFFFFF, { { 0 } } };
+/* the address cache of the selected stack context */
+static struct address_context *Address = &Address_Default;
+/* the next entry that is checked for a restored snapshot record */
+static unsigned Address_Snapshot_Index;
 
 /* State flags for cache entries */
 
@@ -106,7 +117,7 @@ static struct Address_Cache_Entry {
 void address_protected_entry_index_set(uint32_t top_protected_entry_index)
 {
     if (top_protected_entry_index <= (MAX_ADDRESS_CACHE - 1)) {
-        Top_Protected_Entry = top_protected_entry_index;
+        Address->Top_Protected_Entry = top_protected_entry_index;
     }
 }
 
@@ -117,7 +128,49 @@ void address_protected_entry_index_set(uint32_t top_protected_entry_index)
  */
 void address_own_device_id_set(uint32_t own_id)
 {
-    Own_Device_ID = own_id;
+    Address->Own_Device_ID = own_id;
+}
+
+/**
+ * @brief Get the size of the address cache of one stack context
+ * @return size of the address cache, in bytes
+ */
+size_t address_context_size(void)
+{
+    return sizeof(struct address_context);
+}
+
+/**
+ * @brief Initialize the address cache of a stack context
+ * @param context - memory of address_context_size() bytes
+ */
+void address_context_init(void *context)
+{
+    struct address_context *pContext = context;
+
+    if (pContext) {
+        memset(pContext, 0, sizeof(struct address_context));
+        pContext->Own_Device_ID = 0xFFFFFFFF;
+    }
+}
+
+/**
+ * @brief Select the address cache used by the address functions
+ * @param context - address cache from address_context_init(), or NULL
+ *  to select the default address cache
+ * @return the previously selected address cache, or NULL for the default
+ */
+void *address_context_select(void *context)
+{
+    struct address_context *previous = Address;
+
+    if (context) {
+        Address = context;
+    } else {
+        Address = &Address_Default;
+    }
+
+    return (previous == &Address_Default) ? NULL : previous;
 }
 
 /**
@@ -131,12 +184,12 @@ void address_remove_device(uint32_t device_id)
     uint32_t index = 0;
 
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
             (pMatch->device_id == device_id)) {
             pMatch->Flags = 0;
-            if (index < Top_Protected_Entry) {
-                Top_Protected_Entry--;
+            if (index < Address->Top_Protected_Entry) {
+                Address->Top_Protected_Entry--;
             }
             break;
         }
@@ -162,7 +215,7 @@ static struct Address_Cache_Entry *address_remove_oldest(void)
     unsigned index;
 
     pCandidate = NULL;
-    if (Top_Protected_Entry > (MAX_ADDRESS_CACHE - 1)) {
+    if (Address->Top_Protected_Entry > (MAX_ADDRESS_CACHE - 1)) {
         return pCandidate;
     }
     /* Longest possible non static time to live */
@@ -170,8 +223,9 @@ static struct Address_Cache_Entry *address_remove_oldest(void)
 
     /* First pass - try only in use and bound entries */
 
-    for (index = Top_Protected_Entry; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+    for (index = Address->Top_Protected_Entry; index < MAX_ADDRESS_CACHE;
+         index++) {
+        pMatch = &Address->Cache[index];
         if ((pMatch->Flags &
                 (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
             BAC_ADDR_IN_USE) {
@@ -193,7 +247,7 @@ static struct Address_Cache_Entry *address_remove_oldest(void)
 
     /* Second pass - try in use and un bound as last resort */
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if ((pMatch->Flags &
                 (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
             ((uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ))) {
@@ -285,9 +339,9 @@ void address_init(void)
     struct Address_Cache_Entry *pMatch;
     unsigned index;
 
-    Top_Protected_Entry = 0;
+    Address->Top_Protected_Entry = 0;
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         pMatch->Flags = 0;
     }
 #ifdef BACNET_ADDRESS_CACHE_FILE
@@ -309,7 +363,7 @@ void address_init_partial(void)
     unsigned index;
 
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if ((pMatch->Flags & BAC_ADDR_IN_USE) != 0) {
             /* It's in use so let's check further */
             if (((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) ||
@@ -347,7 +401,7 @@ void address_set_device_TTL(
     unsigned index;
 
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
             (pMatch->device_id == device_id)) {
             if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
@@ -383,12 +437,14 @@ bool address_get_by_device(
     unsigned index;
 
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
             (pMatch->device_id == device_id)) {
             if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
                 /* If bound then fetch data */
                 bacnet_address_copy(src, &pMatch->address);
+                /* through the router that currently reaches the network */
+                (void)npdu_route_cache_resolve(src);
                 if (max_apdu) {
                     *max_apdu = pMatch->max_apdu;
                 }
@@ -418,7 +474,7 @@ bool address_get_device_id(BACNET_ADDRESS *src, uint32_t *device_id)
     unsigned index;
 
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) ==
             BAC_ADDR_IN_USE) {
             /* If bound */
@@ -448,7 +504,7 @@ void address_add(uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
     struct Address_Cache_Entry *pMatch;
     unsigned index;
 
-    if (Own_Device_ID == device_id) {
+    if (Address->Own_Device_ID == device_id) {
         return;
     }
 
@@ -460,7 +516,7 @@ void address_add(uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
 
     /* existing device or bind request outstanding - update address */
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         /* Device already in the list, then update the values. */
         if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
             (pMatch->device_id == device_id)) {
@@ -489,7 +545,7 @@ void address_add(uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
     /* New device - add to cache if there is room. */
     if (!found) {
         for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-            pMatch = &Address_Cache[index];
+            pMatch = &Address->Cache[index];
             if ((pMatch->Flags & BAC_ADDR_IN_USE) == 0) {
                 pMatch->Flags = BAC_ADDR_IN_USE;
                 pMatch->device_id = device_id;
@@ -542,7 +598,7 @@ bool address_device_bind_request(uint32_t device_id,
 
     /* existing device - update address info if currently bound */
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
             (pMatch->device_id == device_id)) {
             if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
@@ -550,6 +606,7 @@ bool address_device_bind_request(uint32_t device_id,
                 found = true;
                 if (src) {
                     bacnet_address_copy(src, &pMatch->address);
+                    (void)npdu_route_cache_resolve(src);
                 }
                 if (max_apdu) {
                     *max_apdu = pMatch->max_apdu;
@@ -573,7 +630,7 @@ bool address_device_bind_request(uint32_t device_id,
     /* Not there already so look for a free entry to put it in */
     /* existing device - update address info if currently bound */
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) == 0) {
             /* In use and awaiting binding */
             pMatch->Flags = (uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ);
@@ -630,7 +687,7 @@ void address_add_binding(
 
     /* existing device or bind request - update address */
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
             (pMatch->device_id == device_id)) {
             bacnet_address_copy(&pMatch->address, src);
@@ -671,7 +728,7 @@ bool address_device_get_by_index(unsigned index,
     bool found = false; /* return value */
 
     if (index < MAX_ADDRESS_CACHE) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) ==
             BAC_ADDR_IN_USE) {
             if (src) {
@@ -724,7 +781,7 @@ unsigned address_count(void)
     unsigned index;
 
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         /* Only count bound entries */
         if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) ==
             BAC_ADDR_IN_USE) {
@@ -753,7 +810,7 @@ int address_list_encode(uint8_t *apdu, unsigned apdu_len)
 
     /* Look for matching address. */
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) ==
             BAC_ADDR_IN_USE) {
             iLen += encode_application_object_id(
@@ -905,13 +962,13 @@ int rr_address_list_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
         uiTarget = uiTotal;
     }
 
-    pMatch = Address_Cache;
+    pMatch = Address->Cache;
     uiIndex = 1;
     while ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) !=
         BAC_ADDR_IN_USE) { /* Find first bound entry */
         pMatch++;
         /* Shall not happen as the count has been checked first. */
-        if (pMatch > &Address_Cache[MAX_ADDRESS_CACHE - 1]) {
+        if (pMatch > &Address->Cache[MAX_ADDRESS_CACHE - 1]) {
             /* Issue with the table. */
             return (0);
         }
@@ -928,7 +985,7 @@ int rr_address_list_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
             pMatch++;
         }
         /* Shall not happen as the count has been checked first. */
-        if (pMatch > &Address_Cache[MAX_ADDRESS_CACHE - 1]) {
+        if (pMatch > &Address->Cache[MAX_ADDRESS_CACHE - 1]) {
             /* Issue with the table. */
             return (0);
         }
@@ -979,7 +1036,7 @@ int rr_address_list_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
             /* Find next bound entry */
             pMatch++;
             /* Can normally not happen. */
-            if (pMatch > &Address_Cache[MAX_ADDRESS_CACHE - 1]) {
+            if (pMatch > &Address->Cache[MAX_ADDRESS_CACHE - 1]) {
                 /* Issue with the table. */
                 return (0);
             }
@@ -1001,7 +1058,8 @@ int rr_address_list_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
  * Scan the cache and eliminate any expired entries. Should be called
  * periodically to ensure the cache is managed correctly. If this function
  * is never called at all the whole cache is effectivly rendered static and
- * entries never expire unless explicitly deleted.
+ * entries never expire unless explicitly deleted.  The learned routes to
+ * the remote networks are aged here as well.
  *
  * @param uSeconds  Approximate number of seconds since last call to this
  * function
@@ -1011,8 +1069,9 @@ void address_cache_timer(uint16_t uSeconds)
     struct Address_Cache_Entry *pMatch;
     unsigned index;
 
+    npdu_route_cache_timer(uSeconds);
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+        pMatch = &Address->Cache[index];
         if (((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) != 0) &&
             ((pMatch->Flags & BAC_ADDR_STATIC) ==
                 0)) { /* Check all entries holding a slot except statics
@@ -1025,3 +1084,92 @@ void address_cache_timer(uint16_t uSeconds)
         }
     }
 }
+
+/**
+ * @brief Get the number of address cache entries for a warm start snapshot
+ * @return number of entries, some of which might not be in use
+ */
+uint32_t address_snapshot_count(void)
+{
+    return MAX_ADDRESS_CACHE;
+}
+
+/**
+ * @brief Encode an address cache entry as a warm start snapshot record.
+ *  Only the bound entries are saved, since the static entries are added
+ *  at every startup, and the bind requests are sent again.
+ * @param index - entry 0..address_snapshot_count()-1
+ * @param record - [out] ADDRESS_SNAPSHOT_RECORD_SIZE bytes
+ * @return true if the entry was encoded
+ */
+bool address_snapshot_encode(uint32_t index, uint8_t *record)
+{
+    struct Address_Cache_Entry *pMatch;
+
+    if (!record || (index >= MAX_ADDRESS_CACHE)) {
+        return false;
+    }
+    pMatch = &Address->Cache[index];
+    if ((pMatch->Flags &
+            (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC |
+                BAC_ADDR_RESERVED)) != BAC_ADDR_IN_USE) {
+        return false;
+    }
+    encode_unsigned32(&record[0], pMatch->device_id);
+    encode_unsigned16(&record[4], (uint16_t)pMatch->max_apdu);
+    record[6] = pMatch->Flags & BAC_ADDR_SHORT_TTL;
+    record[7] = 0;
+    encode_unsigned32(&record[8], pMatch->TimeToLive);
+    bacnet_address_record_encode(&record[12], &pMatch->address);
+
+    return true;
+}
+
+/**
+ * @brief Restore a warm start snapshot record into a free address cache
+ *  entry, such as after address_init()
+ * @param index - record 0..N-1 of the snapshot, where record 0 starts
+ *  over at the first entry of the address cache
+ * @param record - ADDRESS_SNAPSHOT_RECORD_SIZE bytes
+ * @return true if the record was restored
+ */
+bool address_snapshot_restore(uint32_t index, uint8_t *record)
+{
+    struct Address_Cache_Entry *pMatch;
+    BACNET_ADDRESS src = { 0 };
+    uint32_t device_id = 0;
+    uint32_t ttl = 0;
+    uint16_t max_apdu = 0;
+
+    if (!record) {
+        return false;
+    }
+    if (index == 0) {
+        Address_Snapshot_Index = 0;
+    }
+    if (bacnet_address_record_decode(&record[12], &src) == 0) {
+        return false;
+    }
+    decode_unsigned32(&record[0], &device_id);
+    decode_unsigned16(&record[4], &max_apdu);
+    decode_unsigned32(&record[8], &ttl);
+    if ((device_id > BACNET_MAX_INSTANCE) || (ttl == 0)) {
+        return false;
+    }
+    /* the snapshot has no duplicates, so only look for a free entry */
+    while (Address_Snapshot_Index < MAX_ADDRESS_CACHE) {
+        pMatch = &Address->Cache[Address_Snapshot_Index];
+        Address_Snapshot_Index++;
+        if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) == 0) {
+            pMatch->Flags =
+                BAC_ADDR_IN_USE | (record[6] & BAC_ADDR_SHORT_TTL);
+            pMatch->device_id = device_id;
+            pMatch->max_apdu = max_apdu;
+            pMatch->TimeToLive = ttl;
+            bacnet_address_copy(&pMatch->address, &src);
+            return true;
+        }
+    }
+
+    return false;
+}
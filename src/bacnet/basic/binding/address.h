@@ -37,6 +37,11 @@
 #define address_mac_from_ascii(m,a) bacnet_address_mac_from_ascii(m,a)
 #define address_match(d,s) bacnet_address_same(d,s)
 
+/* warm start snapshot record of a bound address cache entry: device-id,
+   max-apdu, flags, time-to-live, and the address - see snapshot.h */
+#define ADDRESS_SNAPSHOT_VERSION 1
+#define ADDRESS_SNAPSHOT_RECORD_SIZE (12 + BACNET_ADDRESS_RECORD_SIZE)
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -133,6 +138,22 @@ extern "C" {
     BACNET_STACK_EXPORT
     void address_own_device_id_set(uint32_t own_id);
 
+    /* address cache of one stack context - see stack_context.h */
+    BACNET_STACK_EXPORT
+    size_t address_context_size(void);
+    BACNET_STACK_EXPORT
+    void address_context_init(void *context);
+    BACNET_STACK_EXPORT
+    void *address_context_select(void *context);
+
+    /* warm start snapshot of the address cache - see snapshot.h */
+    BACNET_STACK_EXPORT
+    uint32_t address_snapshot_count(void);
+    BACNET_STACK_EXPORT
+    bool address_snapshot_encode(uint32_t index, uint8_t *record);
+    BACNET_STACK_EXPORT
+    bool address_snapshot_restore(uint32_t index, uint8_t *record);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -2,19 +2,23 @@
  * @file
  * @author Steve Karg <skarg@users.sourceforge.net>
  * @date 2013
- * @brief Read properties from other BACnet devices, and store their values
+ * @brief Read properties from other BACnet devices, and store their values.
+ *  Writes are coalesced per device into WritePropertyMultiple requests.
  *
  * SPDX-License-Identifier: MIT
  */
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bacnet/abort.h"
 #include "bacnet/apdu.h"
+#include "bacnet/dcc.h"
 #include "bacnet/iam.h"
 #include "bacnet/reject.h"
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
+#include "bacnet/wpm.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/binding/address.h"
 #include "bacnet/basic/sys/mstimer.h"
@@ -69,6 +73,46 @@ typedef struct target_data_t {
 #endif
 static TARGET_DATA Target_Data_Buffer[TARGET_DATA_QUEUE_COUNT];
 static RING_BUFFER Target_Data_Queue;
+/* writes waiting to be sent, coalesced per device */
+#ifndef BACNET_WRITE_BATCH_COUNT
+#define BACNET_WRITE_BATCH_COUNT 64
+#endif
+/* devices that are known to not execute WritePropertyMultiple */
+#ifndef BACNET_WRITE_BATCH_WP_DEVICES
+#define BACNET_WRITE_BATCH_WP_DEVICES 8
+#endif
+typedef enum {
+    WRITE_BATCH_FREE,
+    WRITE_BATCH_PENDING,
+    WRITE_BATCH_SENT
+} WRITE_BATCH_STATE;
+struct write_batch_entry {
+    TARGET_DATA target;
+    WRITE_BATCH_STATE state;
+    /* order of queueing, to send to the device that waited longest */
+    uint32_t sequence;
+    /* order within the sent request */
+    uint16_t order;
+};
+static struct write_batch_entry Write_Batch[BACNET_WRITE_BATCH_COUNT];
+static uint32_t Write_Batch_Sequence;
+static uint32_t Write_Batch_WP_Device[BACNET_WRITE_BATCH_WP_DEVICES];
+static unsigned Write_Batch_WP_Device_Index;
+/* the device of the batch that the client task is sending */
+static TARGET_DATA Write_Batch_Target;
+static bool Write_Batch_Active;
+/* the batch is sent after the next read, so that neither starves */
+static bool Write_Batch_Turn;
+/* the batch was sent as WritePropertyMultiple */
+static bool Write_Batch_WPM;
+/* the device rejected WritePropertyMultiple as an unknown service */
+static bool Write_Batch_Unsupported;
+/* the first failed write from a WritePropertyMultiple-Error */
+static bool Write_Batch_Error_Valid;
+static BACNET_WRITE_PROPERTY_DATA Write_Batch_Error;
+/* local storage for encoding and reporting - keeps it off the c-stack */
+static BACNET_WRITE_PROPERTY_DATA Write_Batch_Data;
+static bacnet_write_result_callback_t bacnet_write_result_callback;
 /* local storage - keeps it off the c-stack */
 static BACNET_APPLICATION_DATA_VALUE Target_Decoded_Property_Value;
 /* the invoke id is needed to filter incoming messages */
@@ -134,6 +178,38 @@ static void MyRejectHandler(
         Error_Detected = true;
         Error_Class = ERROR_CLASS_SERVICES;
         Error_Code = reject_convert_to_error_code(reject_reason);
+        if (Write_Batch_Active && Write_Batch_WPM &&
+            (reject_reason == REJECT_REASON_UNRECOGNIZED_SERVICE)) {
+            Write_Batch_Unsupported = true;
+        }
+    }
+}
+
+/**
+ * @brief Handler for a WritePropertyMultiple-Error PDU.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the failed message
+ * @param service_choice [in] the service choice of the failed message
+ * @param service_request [in] the WritePropertyMultiple-Error
+ * @param service_len [in] length of the service_request
+ */
+static void My_Write_Property_Multiple_Error_Handler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    uint8_t service_choice,
+    uint8_t *service_request,
+    uint16_t service_len)
+{
+    int len;
+
+    (void)service_choice;
+    if (address_match(&Target_Address, src) &&
+        (invoke_id == Request_Invoke_ID)) {
+        len = wpm_error_ack_decode_apdu(
+            service_request, service_len, &Write_Batch_Error);
+        Error_Detected = true;
+        Error_Class = Write_Batch_Error.error_class;
+        Error_Code = Write_Batch_Error.error_code;
+        Write_Batch_Error_Valid = (len > 0);
     }
 }
 
@@ -393,6 +469,381 @@ static uint8_t Send_RPM_All_Request(uint32_t device_id,
         pdu, sizeof(pdu), device_id, &read_access_data);
 }
 
+/**
+ * @brief Encode the value of a write as application tagged data
+ * @param apdu [out] buffer for the encoded value, at least 16 bytes
+ * @param target [in] the write
+ * @return number of bytes encoded, or 0 if the data type is not supported
+ */
+static int bacnet_target_data_encode(uint8_t *apdu, TARGET_DATA *target)
+{
+    int len = 0;
+
+    switch (target->tag) {
+        case BACNET_APPLICATION_TAG_NULL:
+            len = encode_application_null(apdu);
+            break;
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            len = encode_application_boolean(apdu, target->type.Boolean);
+            break;
+        case BACNET_APPLICATION_TAG_REAL:
+            len = encode_application_real(apdu, target->type.Real);
+            break;
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            len = encode_application_unsigned(apdu, target->type.Unsigned_Int);
+            break;
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            len = encode_application_signed(apdu, target->type.Signed_Int);
+            break;
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            len = encode_application_enumerated(apdu, target->type.Enumerated);
+            break;
+        default:
+            break;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Determine if two writes are to the same property at the same
+ *  priority, so that only the latest value needs to be written
+ * @param a [in] a write
+ * @param b [in] another write
+ * @return true if the writes are to the same property
+ */
+static bool bacnet_write_batch_same(const TARGET_DATA *a, const TARGET_DATA *b)
+{
+    return (a->device_id == b->device_id) &&
+        (a->object_type == b->object_type) &&
+        (a->object_instance == b->object_instance) &&
+        (a->object_property == b->object_property) &&
+        (a->array_index == b->array_index) && (a->priority == b->priority);
+}
+
+/**
+ * @brief Add a write to the batch, or replace the value of a write to
+ *  the same property that is not sent yet
+ * @param target [in] the write
+ * @return true if added, false if the batch is full
+ */
+static bool bacnet_write_batch_put(TARGET_DATA *target)
+{
+    struct write_batch_entry *entry = NULL;
+    unsigned i;
+
+    for (i = 0; i < BACNET_WRITE_BATCH_COUNT; i++) {
+        if ((Write_Batch[i].state == WRITE_BATCH_PENDING) &&
+            bacnet_write_batch_same(&Write_Batch[i].target, target)) {
+            Write_Batch[i].target.tag = target->tag;
+            Write_Batch[i].target.type = target->type;
+            return true;
+        }
+        if (!entry && (Write_Batch[i].state == WRITE_BATCH_FREE)) {
+            entry = &Write_Batch[i];
+        }
+    }
+    if (!entry) {
+        return false;
+    }
+    memcpy(&entry->target, target, sizeof(TARGET_DATA));
+    entry->state = WRITE_BATCH_PENDING;
+    entry->sequence = Write_Batch_Sequence++;
+
+    return true;
+}
+
+/**
+ * @brief Find the device of the write that waited longest
+ * @param device_id [out] the device of the oldest pending write
+ * @return true if a write is pending
+ */
+static bool bacnet_write_batch_next(uint32_t *device_id)
+{
+    struct write_batch_entry *oldest = NULL;
+    unsigned i;
+
+    for (i = 0; i < BACNET_WRITE_BATCH_COUNT; i++) {
+        if ((Write_Batch[i].state == WRITE_BATCH_PENDING) &&
+            (!oldest ||
+                ((int32_t)(Write_Batch[i].sequence - oldest->sequence) < 0))) {
+            oldest = &Write_Batch[i];
+        }
+    }
+    if (oldest) {
+        *device_id = oldest->target.device_id;
+    }
+
+    return (oldest != NULL);
+}
+
+/**
+ * @brief Determine if a read is of a property with a pending write,
+ *  which is then written before it is read
+ * @param target [in] the read
+ * @return true if a write to the property of the read is pending
+ */
+static bool bacnet_write_batch_pending(const TARGET_DATA *target)
+{
+    const TARGET_DATA *write;
+    unsigned i;
+
+    for (i = 0; i < BACNET_WRITE_BATCH_COUNT; i++) {
+        write = &Write_Batch[i].target;
+        if ((Write_Batch[i].state == WRITE_BATCH_PENDING) &&
+            (write->device_id == target->device_id) &&
+            (write->object_type == target->object_type) &&
+            (write->object_instance == target->object_instance) &&
+            ((target->object_property == PROP_ALL) ||
+                (write->object_property == target->object_property))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Determine if a device does not execute WritePropertyMultiple
+ * @param device_id [in] the device
+ * @return true if the writes are sent one at a time with WriteProperty
+ */
+static bool bacnet_write_batch_wp_device(uint32_t device_id)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_WRITE_BATCH_WP_DEVICES; i++) {
+        if (Write_Batch_WP_Device[i] == device_id) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Report the result of a write, and free its entry
+ * @param entry [in] the write
+ * @param error_class [in] ERROR_CLASS_SERVICES with ERROR_CODE_SUCCESS
+ *  if the write succeeded
+ * @param error_code [in] the error code
+ */
+static void bacnet_write_batch_result(struct write_batch_entry *entry,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    TARGET_DATA *target = &entry->target;
+    BACNET_READ_PROPERTY_DATA rp_data;
+
+    if (bacnet_write_result_callback) {
+        Write_Batch_Data.object_type = target->object_type;
+        Write_Batch_Data.object_instance = target->object_instance;
+        Write_Batch_Data.object_property = target->object_property;
+        Write_Batch_Data.array_index = target->array_index;
+        Write_Batch_Data.priority = target->priority;
+        Write_Batch_Data.application_data_len = bacnet_target_data_encode(
+            &Write_Batch_Data.application_data[0], target);
+        Write_Batch_Data.error_class = error_class;
+        Write_Batch_Data.error_code = error_code;
+        bacnet_write_result_callback(target->device_id, &Write_Batch_Data);
+    }
+    if ((error_code != ERROR_CODE_SUCCESS) &&
+        bacnet_read_write_value_callback) {
+        rp_data.error_class = error_class;
+        rp_data.error_code = error_code;
+        rp_data.object_type = target->object_type;
+        rp_data.object_instance = target->object_instance;
+        rp_data.object_property = target->object_property;
+        rp_data.array_index = target->array_index;
+        bacnet_read_write_value_callback(target->device_id, &rp_data, NULL);
+    }
+    entry->state = WRITE_BATCH_FREE;
+}
+
+/**
+ * @brief Send the pending writes of a device as one WritePropertyMultiple
+ *  request that fits in the max APDU of the device, grouping the writes
+ *  of each object.  A device that does not execute WritePropertyMultiple
+ *  is sent one WriteProperty request.
+ * @param device_id [in] the device
+ * @return invoke_id of request, or 0 if not sent
+ */
+static uint8_t bacnet_write_batch_send(uint32_t device_id)
+{
+    BACNET_ADDRESS dest;
+    BACNET_ADDRESS my_address;
+    BACNET_NPDU_DATA npdu_data;
+    TARGET_DATA *target;
+    TARGET_DATA *object;
+    uint8_t encoding[32];
+    uint8_t *apdu;
+    uint8_t invoke_id = 0;
+    unsigned max_apdu = 0;
+    unsigned i, j;
+    uint16_t order = 0;
+    int pdu_len, apdu_len, len;
+
+    Write_Batch_WPM = false;
+    if (bacnet_write_batch_wp_device(device_id)) {
+        for (i = 0; i < BACNET_WRITE_BATCH_COUNT; i++) {
+            target = &Write_Batch[i].target;
+            if ((Write_Batch[i].state == WRITE_BATCH_PENDING) &&
+                (target->device_id == device_id)) {
+                len = bacnet_target_data_encode(encoding, target);
+                invoke_id = Send_Write_Property_Request_Data(device_id,
+                    target->object_type, target->object_instance,
+                    target->object_property, encoding, len, target->priority,
+                    target->array_index);
+                if (invoke_id) {
+                    Write_Batch[i].state = WRITE_BATCH_SENT;
+                    Write_Batch[i].order = 0;
+                }
+                break;
+            }
+        }
+        return invoke_id;
+    }
+    if (!dcc_communication_enabled()) {
+        return 0;
+    }
+    if (address_get_by_device(device_id, &max_apdu, &dest)) {
+        invoke_id = tsm_next_free_invokeID();
+    }
+    if (!invoke_id) {
+        return 0;
+    }
+    if (max_apdu > MAX_APDU) {
+        max_apdu = MAX_APDU;
+    }
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], &dest, &my_address, &npdu_data);
+    apdu = &Handler_Transmit_Buffer[pdu_len];
+    apdu_len = wpm_encode_apdu_init(apdu, invoke_id);
+    for (i = 0; i < BACNET_WRITE_BATCH_COUNT; i++) {
+        object = &Write_Batch[i].target;
+        if ((Write_Batch[i].state != WRITE_BATCH_PENDING) ||
+            (object->device_id != device_id)) {
+            continue;
+        }
+        /* the writes of one object, if at least one of them fits */
+        len = apdu_len + wpm_encode_apdu_object_begin(
+            encoding, object->object_type, object->object_instance);
+        if ((len + 1) > (int)max_apdu) {
+            break;
+        }
+        (void)wpm_encode_apdu_object_begin(
+            &apdu[apdu_len], object->object_type, object->object_instance);
+        for (j = i; j < BACNET_WRITE_BATCH_COUNT; j++) {
+            target = &Write_Batch[j].target;
+            if ((Write_Batch[j].state != WRITE_BATCH_PENDING) ||
+                (target->device_id != device_id) ||
+                (target->object_type != object->object_type) ||
+                (target->object_instance != object->object_instance)) {
+                continue;
+            }
+            Write_Batch_Data.object_property = target->object_property;
+            Write_Batch_Data.array_index = target->array_index;
+            Write_Batch_Data.priority = target->priority;
+            Write_Batch_Data.application_data_len = bacnet_target_data_encode(
+                &Write_Batch_Data.application_data[0], target);
+            if ((len + 32 + 1) > (int)max_apdu) {
+                /* the largest write might not fit - encode to check */
+                if ((len + wpm_encode_apdu_object_property(
+                         encoding, &Write_Batch_Data) + 1) >
+                    (int)max_apdu) {
+                    break;
+                }
+            }
+            len += wpm_encode_apdu_object_property(
+                &apdu[len], &Write_Batch_Data);
+            Write_Batch[j].state = WRITE_BATCH_SENT;
+            Write_Batch[j].order = order++;
+        }
+        if (Write_Batch[i].state != WRITE_BATCH_SENT) {
+            /* the request is full */
+            break;
+        }
+        apdu_len = len + wpm_encode_apdu_object_end(&apdu[len]);
+    }
+    if (order == 0) {
+        tsm_free_invoke_id(invoke_id);
+        return 0;
+    }
+    pdu_len += apdu_len;
+    tsm_set_confirmed_unsegmented_transaction(invoke_id, &dest, &npdu_data,
+        &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
+    (void)tsm_send_pdu(
+        invoke_id, &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    Write_Batch_WPM = true;
+
+    return invoke_id;
+}
+
+/**
+ * @brief Report the results of the sent writes of a device.  After a
+ *  WritePropertyMultiple-Error, the writes before the first failed write
+ *  succeeded, and the writes after it are sent again.  A device that
+ *  rejects WritePropertyMultiple is sent WriteProperty from now on.
+ * @param device_id [in] the device
+ */
+static void bacnet_write_batch_finish(uint32_t device_id)
+{
+    struct write_batch_entry *entry;
+    TARGET_DATA *target;
+    bool sent = false;
+    int failed = -1;
+    unsigned i;
+
+    for (i = 0; i < BACNET_WRITE_BATCH_COUNT; i++) {
+        entry = &Write_Batch[i];
+        target = &entry->target;
+        if ((entry->state != WRITE_BATCH_SENT) ||
+            (target->device_id != device_id)) {
+            continue;
+        }
+        sent = true;
+        if (Error_Detected && Write_Batch_Unsupported) {
+            entry->state = WRITE_BATCH_PENDING;
+        } else if (Write_Batch_Error_Valid &&
+            (target->object_type == Write_Batch_Error.object_type) &&
+            (target->object_instance == Write_Batch_Error.object_instance) &&
+            (target->object_property == Write_Batch_Error.object_property) &&
+            ((uint32_t)target->array_index ==
+                Write_Batch_Error.array_index)) {
+            failed = entry->order;
+        }
+    }
+    if (Error_Detected && Write_Batch_Unsupported) {
+        Write_Batch_WP_Device[Write_Batch_WP_Device_Index] = device_id;
+        Write_Batch_WP_Device_Index =
+            (Write_Batch_WP_Device_Index + 1) % BACNET_WRITE_BATCH_WP_DEVICES;
+        return;
+    }
+    for (i = 0; i < BACNET_WRITE_BATCH_COUNT; i++) {
+        entry = &Write_Batch[i];
+        if (entry->target.device_id != device_id) {
+            continue;
+        }
+        if (entry->state == WRITE_BATCH_SENT) {
+            if (!Error_Detected || ((failed >= 0) && (entry->order < failed))) {
+                bacnet_write_batch_result(
+                    entry, ERROR_CLASS_SERVICES, ERROR_CODE_SUCCESS);
+            } else if ((failed < 0) || (entry->order == failed)) {
+                bacnet_write_batch_result(entry, Error_Class, Error_Code);
+            } else {
+                /* not attempted by the device */
+                entry->state = WRITE_BATCH_PENDING;
+            }
+        } else if ((entry->state == WRITE_BATCH_PENDING) && Error_Detected &&
+            !sent) {
+            /* unable to bind with the device, or to send */
+            bacnet_write_batch_result(entry, Error_Class, Error_Code);
+        }
+    }
+}
+
 /**
  * @brief Handles the ReadProperty process
  * @param service_request [in] The contents of the service request.
@@ -402,9 +853,6 @@ static bool bacnet_read_write_process(TARGET_DATA *target)
 {
     bool found = false;
     unsigned max_apdu = 0;
-    uint8_t application_data[16] = { 0 };
-    int application_data_len = 0;
-    bool valid_tag = false;
 
     switch (RW_State) {
         case BACNET_CLIENT_IDLE:
@@ -447,47 +895,7 @@ static bool bacnet_read_write_process(TARGET_DATA *target)
             break;
         case BACNET_CLIENT_SEND:
             if (target->write_property) {
-                switch (target->tag) {
-                    case BACNET_APPLICATION_TAG_NULL:
-                        application_data_len =
-                            encode_application_null(&application_data[0]);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_BOOLEAN:
-                        application_data_len = encode_application_boolean(
-                            &application_data[0], target->type.Boolean);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_REAL:
-                        application_data_len = encode_application_real(
-                            &application_data[0], target->type.Real);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_UNSIGNED_INT:
-                        application_data_len = encode_application_unsigned(
-                            &application_data[0], target->type.Unsigned_Int);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_SIGNED_INT:
-                        application_data_len = encode_application_signed(
-                            &application_data[0], target->type.Signed_Int);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_ENUMERATED:
-                        application_data_len = encode_application_enumerated(
-                            &application_data[0], target->type.Enumerated);
-                        valid_tag = true;
-                        break;
-                    default:
-                        break;
-                }
-                if (valid_tag) {
-                    Request_Invoke_ID = Send_Write_Property_Request_Data(
-                        target->device_id, target->object_type,
-                        target->object_instance, target->object_property,
-                        &application_data[0], application_data_len,
-                        target->priority, target->array_index);
-                }
+                Request_Invoke_ID = bacnet_write_batch_send(target->device_id);
             } else {
                 if (target->object_property == PROP_ALL) {
                     Request_Invoke_ID = Send_RPM_All_Request(target->device_id,
@@ -512,8 +920,10 @@ static bool bacnet_read_write_process(TARGET_DATA *target)
             }
             break;
         case BACNET_CLIENT_WAITING:
-            if (tsm_invoke_id_free(Request_Invoke_ID)) {
-                Error_Detected = false;
+            if (Error_Detected) {
+                /* the Error, Reject, or Abort frees the invoke ID */
+                RW_State = BACNET_CLIENT_FINISHED;
+            } else if (tsm_invoke_id_free(Request_Invoke_ID)) {
                 RW_State = BACNET_CLIENT_FINISHED;
             } else if (tsm_invoke_id_failed(Request_Invoke_ID)) {
                 Error_Detected = true;
@@ -521,8 +931,6 @@ static bool bacnet_read_write_process(TARGET_DATA *target)
                 Error_Code = ERROR_CODE_ABORT_TSM_TIMEOUT;
                 RW_State = BACNET_CLIENT_FINISHED;
                 tsm_free_invoke_id(Request_Invoke_ID);
-            } else if (Error_Detected) {
-                RW_State = BACNET_CLIENT_FINISHED;
             }
             break;
         case BACNET_CLIENT_FINISHED:
@@ -551,14 +959,44 @@ void bacnet_read_write_value_callback_set(
  */
 void bacnet_read_write_task(void)
 {
-    TARGET_DATA *target;
+    TARGET_DATA *target = NULL;
     bool status = false;
+    bool start = false;
     BACNET_READ_PROPERTY_DATA rp_data;
 
     if (!Ringbuf_Empty(&Target_Data_Queue)) {
         target = (TARGET_DATA *)Ringbuf_Peek(&Target_Data_Queue);
+    }
+    if (!Write_Batch_Active &&
+        ((RW_State == BACNET_CLIENT_IDLE) ||
+            (RW_State == BACNET_CLIENT_FINISHED))) {
+        /* no request in progress */
+        if (target && bacnet_write_batch_pending(target)) {
+            /* a read after a write of the property reads the new value */
+            Write_Batch_Target.device_id = target->device_id;
+            start = true;
+        } else if (Write_Batch_Turn || !target) {
+            /* the writes take turns with the reads */
+            start = bacnet_write_batch_next(&Write_Batch_Target.device_id);
+        }
+    }
+    if (start) {
+        Write_Batch_Target.write_property = true;
+        Write_Batch_Unsupported = false;
+        Write_Batch_Error_Valid = false;
+        Write_Batch_Active = true;
+    }
+    if (Write_Batch_Active) {
+        status = bacnet_read_write_process(&Write_Batch_Target);
+        if (status) {
+            bacnet_write_batch_finish(Write_Batch_Target.device_id);
+            Write_Batch_Active = false;
+            Write_Batch_Turn = false;
+        }
+    } else if (target) {
         status = bacnet_read_write_process(target);
         if (status) {
+            Write_Batch_Turn = true;
             if (Error_Detected) {
                 if (bacnet_read_write_value_callback) {
                     rp_data.error_class = Error_Class;
@@ -648,7 +1086,7 @@ bool bacnet_write_property_real_queue(uint32_t device_id,
     target.type.Real = value;
     target.priority = priority;
     target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    status = bacnet_write_batch_put(&target);
 
     return status;
 }
@@ -686,7 +1124,7 @@ bool bacnet_write_property_null_queue(uint32_t device_id,
     target.tag = BACNET_APPLICATION_TAG_NULL;
     target.priority = priority;
     target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    status = bacnet_write_batch_put(&target);
 
     return status;
 }
@@ -726,7 +1164,7 @@ bool bacnet_write_property_enumerated_queue(uint32_t device_id,
     target.type.Enumerated = value;
     target.priority = priority;
     target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    status = bacnet_write_batch_put(&target);
 
     return status;
 }
@@ -766,7 +1204,7 @@ bool bacnet_write_property_unsigned_queue(uint32_t device_id,
     target.type.Unsigned_Int = value;
     target.priority = priority;
     target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    status = bacnet_write_batch_put(&target);
 
     return status;
 }
@@ -806,7 +1244,7 @@ bool bacnet_write_property_signed_queue(uint32_t device_id,
     target.type.Signed_Int = value;
     target.priority = priority;
     target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    status = bacnet_write_batch_put(&target);
 
     return status;
 }
@@ -846,27 +1284,62 @@ bool bacnet_write_property_boolean_queue(uint32_t device_id,
     target.type.Boolean = value;
     target.priority = priority;
     target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    status = bacnet_write_batch_put(&target);
 
     return status;
 }
 
 /**
- * @brief Determines if the BACnet ReadProperty queue is empty
+ * @brief Determines if the BACnet ReadProperty queue and the write batch
+ *  are empty
  * @return true if the parameter queue is empty, and thus, idle
  */
 bool bacnet_read_write_idle(void)
 {
-    return Ringbuf_Empty(&Target_Data_Queue);
+    unsigned i;
+
+    if (!Ringbuf_Empty(&Target_Data_Queue) || Write_Batch_Active) {
+        return false;
+    }
+    for (i = 0; i < BACNET_WRITE_BATCH_COUNT; i++) {
+        if (Write_Batch[i].state != WRITE_BATCH_FREE) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 /**
- * @brief Determines if the BACnet ReadProperty queue is full
+ * @brief Determines if the BACnet ReadProperty queue or the write batch
+ *  is full
  * @return true if the parameter queue is full, and thus, busy
  */
 bool bacnet_read_write_busy(void)
 {
-    return Ringbuf_Full(&Target_Data_Queue);
+    unsigned i;
+
+    if (Ringbuf_Full(&Target_Data_Queue)) {
+        return true;
+    }
+    for (i = 0; i < BACNET_WRITE_BATCH_COUNT; i++) {
+        if (Write_Batch[i].state == WRITE_BATCH_FREE) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Sets the callback for the result of each queued write, which
+ *  has ERROR_CODE_SUCCESS in the error code when the write succeeded
+ *
+ * @param callback - function for callback
+ */
+void bacnet_write_result_callback_set(bacnet_write_result_callback_t callback)
+{
+    bacnet_write_result_callback = callback;
 }
 
 /**
@@ -884,8 +1357,17 @@ void bacnet_read_write_vendor_id_filter_set(uint16_t vendor_id)
  */
 void bacnet_read_write_init(void)
 {
+    unsigned i;
+
     Ringbuf_Init(&Target_Data_Queue, (uint8_t *)&Target_Data_Buffer,
         TARGET_DATA_QUEUE_SIZE, TARGET_DATA_QUEUE_COUNT);
+    memset(Write_Batch, 0, sizeof(Write_Batch));
+    Write_Batch_Active = false;
+    Write_Batch_Turn = false;
+    RW_State = BACNET_CLIENT_IDLE;
+    for (i = 0; i < BACNET_WRITE_BATCH_WP_DEVICES; i++) {
+        Write_Batch_WP_Device[i] = UINT32_MAX;
+    }
     /* handle i-am to support binding to other devices */
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, My_I_Am_Bind);
     /* handle the data coming back from confirmed requests */
@@ -896,9 +1378,13 @@ void bacnet_read_write_init(void)
     /* handle the Simple ACK coming back */
     apdu_set_confirmed_simple_ack_handler(
         SERVICE_CONFIRMED_WRITE_PROPERTY, MyWritePropertySimpleAckHandler);
+    apdu_set_confirmed_simple_ack_handler(SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE,
+        MyWritePropertySimpleAckHandler);
     /* handle any errors coming back */
     apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROPERTY, MyErrorHandler);
     apdu_set_error_handler(SERVICE_CONFIRMED_WRITE_PROPERTY, MyErrorHandler);
+    apdu_set_complex_error_handler(SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE,
+        My_Write_Property_Multiple_Error_Handler);
     apdu_set_abort_handler(MyAbortHandler);
     apdu_set_reject_handler(MyRejectHandler);
     /* configure the address cache */
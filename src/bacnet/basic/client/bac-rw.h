@@ -13,6 +13,7 @@
 #include "bacnet/bacenum.h"
 #include "bacnet/bacapp.h"
 #include "bacnet/rp.h"
+#include "bacnet/wp.h"
 #include "bacnet/bacnet_stack_exports.h"
 
 /**
@@ -28,6 +29,16 @@ typedef void (*bacnet_read_write_value_callback_t)(uint32_t device_instance,
     BACNET_READ_PROPERTY_DATA *rp_data,
     BACNET_APPLICATION_DATA_VALUE *value);
 
+/**
+ * Report the result of a queued write
+ *
+ * @param device_instance [in] device instance number that was written
+ * @param wp_data [in] the written property and value, with the error
+ *  class and code, or ERROR_CODE_SUCCESS if the write succeeded
+ */
+typedef void (*bacnet_write_result_callback_t)(uint32_t device_instance,
+    BACNET_WRITE_PROPERTY_DATA *wp_data);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -97,6 +108,8 @@ BACNET_STACK_EXPORT
 void bacnet_read_write_value_callback_set(
     bacnet_read_write_value_callback_t callback);
 BACNET_STACK_EXPORT
+void bacnet_write_result_callback_set(bacnet_write_result_callback_t callback);
+BACNET_STACK_EXPORT
 void bacnet_read_write_vendor_id_filter_set(uint16_t vendor_id);
 
 #ifdef __cplusplus
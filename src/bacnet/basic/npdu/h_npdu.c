@@ -24,6 +24,7 @@
  *********************************************************************/
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/bacaddr.h"
 #include "bacnet/bacdef.h"
 #include "bacnet/bacdcode.h"
@@ -44,6 +45,16 @@
 static uint16_t Local_Network_Number;
 static uint8_t Local_Network_Number_Status = NETWORK_NUMBER_LEARNED;
 
+/* the router on the local network for each remote network */
+struct npdu_route_entry {
+    uint16_t dnet;
+    uint8_t mac_len;
+    uint8_t mac[MAX_MAC_LEN];
+    /* seconds until the route expires, 0=unused */
+    uint16_t time_to_live;
+};
+static struct npdu_route_entry Route_Cache[NPDU_ROUTE_CACHE_SIZE];
+
 /**
  * @brief get the local network number
  * @return local network number
@@ -128,6 +139,147 @@ int npdu_send_what_is_network_number(BACNET_ADDRESS *dst)
         dst, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
 }
 
+/**
+ * @brief Find the route to a remote network
+ * @param dnet - remote network number
+ * @return the route, or NULL if the route is not known
+ */
+static struct npdu_route_entry *npdu_route_cache_entry(uint16_t dnet)
+{
+    unsigned i;
+
+    for (i = 0; i < NPDU_ROUTE_CACHE_SIZE; i++) {
+        if ((Route_Cache[i].time_to_live > 0) &&
+            (Route_Cache[i].dnet == dnet)) {
+            return &Route_Cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add or refresh the router on the local network that reaches
+ *  a remote network.  When the cache is full, the route that expires
+ *  first is replaced.
+ * @param dnet - remote network number
+ * @param router - local MAC address of the router
+ */
+void npdu_route_cache_add(uint16_t dnet, BACNET_ADDRESS *router)
+{
+    struct npdu_route_entry *entry;
+    unsigned i;
+
+    if (!router || (router->mac_len == 0) ||
+        (router->mac_len > MAX_MAC_LEN) || (dnet == 0) ||
+        (dnet == BACNET_BROADCAST_NETWORK)) {
+        return;
+    }
+    entry = npdu_route_cache_entry(dnet);
+    if (!entry) {
+        entry = &Route_Cache[0];
+        for (i = 0; i < NPDU_ROUTE_CACHE_SIZE; i++) {
+            if (Route_Cache[i].time_to_live < entry->time_to_live) {
+                entry = &Route_Cache[i];
+            }
+        }
+    }
+    entry->dnet = dnet;
+    entry->mac_len = router->mac_len;
+    memcpy(entry->mac, router->mac, router->mac_len);
+    entry->time_to_live = NPDU_ROUTE_CACHE_TIME;
+}
+
+/**
+ * @brief Forget the route to a remote network
+ * @param dnet - remote network number
+ */
+void npdu_route_cache_remove(uint16_t dnet)
+{
+    struct npdu_route_entry *entry;
+
+    entry = npdu_route_cache_entry(dnet);
+    if (entry) {
+        entry->time_to_live = 0;
+    }
+}
+
+/**
+ * @brief Get the router on the local network that reaches a remote network
+ * @param dnet - remote network number
+ * @param router - [out] the MAC address of the router is copied into
+ *  the mac and mac_len of this address, or NULL
+ * @return true if the route is known
+ */
+bool npdu_route_cache_find(uint16_t dnet, BACNET_ADDRESS *router)
+{
+    struct npdu_route_entry *entry;
+
+    entry = npdu_route_cache_entry(dnet);
+    if (!entry) {
+        return false;
+    }
+    if (router) {
+        router->mac_len = entry->mac_len;
+        memcpy(router->mac, entry->mac, entry->mac_len);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Send to a device on a remote network through the router that
+ *  is known for the network, rather than the router that was known
+ *  when the address was bound.
+ * @param dest - [in,out] address of the device, whose MAC address is
+ *  replaced by the MAC address of the router
+ * @return true if the route is known
+ */
+bool npdu_route_cache_resolve(BACNET_ADDRESS *dest)
+{
+    if (!dest || (dest->net == 0) || (dest->net == BACNET_BROADCAST_NETWORK)) {
+        return false;
+    }
+
+    return npdu_route_cache_find(dest->net, dest);
+}
+
+/**
+ * @brief Get the number of known routes
+ * @return number of routes
+ */
+unsigned npdu_route_cache_count(void)
+{
+    unsigned count = 0;
+    unsigned i;
+
+    for (i = 0; i < NPDU_ROUTE_CACHE_SIZE; i++) {
+        if (Route_Cache[i].time_to_live > 0) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Age the routes, which are refreshed by every message that is
+ *  received through the router
+ * @param seconds - seconds since the last call to this function
+ */
+void npdu_route_cache_timer(uint16_t seconds)
+{
+    unsigned i;
+
+    for (i = 0; i < NPDU_ROUTE_CACHE_SIZE; i++) {
+        if (Route_Cache[i].time_to_live > seconds) {
+            Route_Cache[i].time_to_live -= seconds;
+        } else {
+            Route_Cache[i].time_to_live = 0;
+        }
+    }
+}
+
 /** @file h_npdu.c  Handles messages at the NPDU level of the BACnet stack. */
 
 /** Handler to manage the Network Layer Control Messages received in a packet.
@@ -153,6 +305,7 @@ static void network_control_handler(BACNET_ADDRESS *src,
 {
     uint16_t dnet = 0;
     uint8_t status = 0;
+    int len = 0;
 
     switch (npdu_data->network_message_type) {
         case NETWORK_MESSAGE_WHAT_IS_NETWORK_NUMBER:
@@ -192,6 +345,45 @@ static void network_control_handler(BACNET_ADDRESS *src,
                     that are sent with a local unicast address. */
             }
             break;
+        case NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK:
+            /*  Learn the router of each network in the list, which is
+                also the reply to Who-Is-Router-To-Network. */
+            if (src->net == 0) {
+                while (npdu_len >= 2) {
+                    len = decode_unsigned16(npdu, &dnet);
+                    npdu_route_cache_add(dnet, src);
+                    npdu += len;
+                    npdu_len -= len;
+                }
+            }
+            break;
+        case NETWORK_MESSAGE_REJECT_MESSAGE_TO_NETWORK:
+            if (npdu_len >= 3) {
+                status = npdu[0];
+                (void)decode_unsigned16(&npdu[1], &dnet);
+                if (status == NETWORK_REJECT_NO_ROUTE) {
+                    /*  The router no longer reaches the network */
+                    npdu_route_cache_remove(dnet);
+                } else if (status == NETWORK_REJECT_ROUTER_BUSY) {
+                    tsm_network_busy_set(dnet, true);
+                }
+            }
+            break;
+        case NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK:
+        case NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK:
+            /*  Hold back the retries of confirmed requests to the
+                networks in the list until the router is available.
+                An empty list, for all of the networks of the router,
+                is not tracked since the networks are not known here. */
+            while (npdu_len >= 2) {
+                len = decode_unsigned16(npdu, &dnet);
+                tsm_network_busy_set(dnet,
+                    npdu_data->network_message_type ==
+                        NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK);
+                npdu += len;
+                npdu_len -= len;
+            }
+            break;
         default:
             break;
     }
@@ -234,6 +426,12 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
     if (pdu[0] == BACNET_PROTOCOL_VERSION) {
         apdu_offset =
             bacnet_npdu_decode(&pdu[0], pdu_len, &dest, src, &npdu_data);
+        if ((apdu_offset > 0) && (src->net != 0) &&
+            (src->net != BACNET_BROADCAST_NETWORK)) {
+            /* routed to us, such as an I-Am, so the router on the local
+               network that sent it reaches the source network */
+            npdu_route_cache_add(src->net, src);
+        }
         if (npdu_data.network_layer_message) {
             if ((dest.net == 0) || (dest.net == BACNET_BROADCAST_NETWORK)) {
                 network_control_handler(src, &npdu_data, &pdu[apdu_offset],
@@ -38,6 +38,15 @@
 #include "bacnet/apdu.h"
 #include "bacnet/npdu.h"
 
+/* remote networks whose router on the local network is known */
+#ifndef NPDU_ROUTE_CACHE_SIZE
+#define NPDU_ROUTE_CACHE_SIZE 8
+#endif
+/* seconds that a route is known after the last message through it */
+#ifndef NPDU_ROUTE_CACHE_TIME
+#define NPDU_ROUTE_CACHE_TIME 3600
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -61,6 +70,26 @@ extern "C" {
     int npdu_send_what_is_network_number(
         BACNET_ADDRESS *dst);
 
+    BACNET_STACK_EXPORT
+    void npdu_route_cache_add(
+        uint16_t dnet,
+        BACNET_ADDRESS *router);
+    BACNET_STACK_EXPORT
+    void npdu_route_cache_remove(
+        uint16_t dnet);
+    BACNET_STACK_EXPORT
+    bool npdu_route_cache_find(
+        uint16_t dnet,
+        BACNET_ADDRESS *router);
+    BACNET_STACK_EXPORT
+    bool npdu_route_cache_resolve(
+        BACNET_ADDRESS *dest);
+    BACNET_STACK_EXPORT
+    unsigned npdu_route_cache_count(void);
+    BACNET_STACK_EXPORT
+    void npdu_route_cache_timer(
+        uint16_t seconds);
+
     BACNET_STACK_EXPORT
     void npdu_handler_cleanup(void);
     BACNET_STACK_EXPORT
@@ -38,6 +38,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
 
 #if PRINT_ENABLED
@@ -100,8 +101,6 @@ static void network_control_handler(BACNET_ADDRESS *src,
              * some remote device, we will start by pushing it out the
              * upstream port and let the attached router(s) take it from there.
              * Consequently, we'll do nothing interesting here.
-             * -- Unless we act upon NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK
-             * later for congestion control - then it could matter.
              */
             debug_printf("%s for Networks: ",
                 bactext_network_layer_msg_name(
@@ -131,7 +130,17 @@ static void network_control_handler(BACNET_ADDRESS *src,
             break;
         case NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK:
         case NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK:
-            /* Do nothing - don't support upstream traffic congestion control */
+            /* Hold back the retries of our confirmed requests to the
+             * networks in the list until the upstream router is available.
+             */
+            while (npdu_len >= 2) {
+                len = decode_unsigned16(&npdu[npdu_offset], &dnet);
+                tsm_network_busy_set(dnet,
+                    npdu_data->network_message_type ==
+                        NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK);
+                npdu_len -= len;
+                npdu_offset += len;
+            }
             break;
         case NETWORK_MESSAGE_INIT_RT_TABLE:
             /* If sent with Number of Ports == 0, we respond with
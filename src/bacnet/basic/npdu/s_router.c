@@ -200,6 +200,37 @@ int Send_Network_Layer_Message(BACNET_NETWORK_MESSAGE_TYPE network_message_type,
     return bytes_sent;
 }
 
+/** Tell the other devices to stop sending messages to the networks
+ * that we route to, until we send Router-Available-To-Network.
+ * @ingroup NMRC
+ *
+ * @param dst [in] If NULL, msg will be broadcast to the local BACnet network.
+ * @param DNET_list [in] List of BACnet network numbers that are congested,
+ *                       terminated with -1.  Just -1 means all of the
+ *                       networks that we route to.
+ */
+void Send_Router_Busy_To_Network(BACNET_ADDRESS *dst, const int DNET_list[])
+{
+    Send_Network_Layer_Message(
+        NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK, dst, (int *)DNET_list);
+}
+
+/** Tell the other devices to resume sending messages to the networks
+ * after a Router-Busy-To-Network.
+ * @ingroup NMRC
+ *
+ * @param dst [in] If NULL, msg will be broadcast to the local BACnet network.
+ * @param DNET_list [in] List of BACnet network numbers that are no longer
+ *                       congested, terminated with -1.  Just -1 means all
+ *                       of the networks that we route to.
+ */
+void Send_Router_Available_To_Network(
+    BACNET_ADDRESS *dst, const int DNET_list[])
+{
+    Send_Network_Layer_Message(
+        NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK, dst, (int *)DNET_list);
+}
+
 /** Finds a specific router, or all reachable BACnet networks.
  * The response(s) will come in I-am-router-to-network message(s).
  * @ingroup NMRC
@@ -55,6 +55,14 @@ extern "C" {
     void Send_I_Am_Router_To_Network(
         const int DNET_list[]);
     BACNET_STACK_EXPORT
+    void Send_Router_Busy_To_Network(
+        BACNET_ADDRESS * dst,
+        const int DNET_list[]);
+    BACNET_STACK_EXPORT
+    void Send_Router_Available_To_Network(
+        BACNET_ADDRESS * dst,
+        const int DNET_list[]);
+    BACNET_STACK_EXPORT
     void Send_Reject_Message_To_Network(
         BACNET_ADDRESS * dst,
         uint8_t reject_reason,
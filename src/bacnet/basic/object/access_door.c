@@ -80,6 +80,8 @@ void Access_Door_Init(void)
         /* initialize all the access door priority arrays to NULL */
         for (i = 0; i < MAX_ACCESS_DOORS; i++) {
             ad_descr[i].relinquish_default = DOOR_VALUE_LOCK;
+            ad_descr[i].present_value = DOOR_VALUE_LOCK;
+            priority_array_init(&ad_descr[i].priority_active);
             ad_descr[i].event_state = EVENT_STATE_NORMAL;
             ad_descr[i].reliability = RELIABILITY_NO_FAULT_DETECTED;
             ad_descr[i].out_of_service = false;
@@ -92,7 +94,6 @@ void Access_Door_Init(void)
             ad_descr[i].door_open_too_long_time = 300; /* 30s */
             ad_descr[i].door_alarm_state = DOOR_ALARM_STATE_NORMAL;
             for (j = 0; j < BACNET_MAX_PRIORITY; j++) {
-                ad_descr[i].value_active[j] = false;
                 /* just to fill in */
                 ad_descr[i].priority_array[j] = DOOR_VALUE_LOCK;
             }
@@ -146,36 +147,38 @@ unsigned Access_Door_Instance_To_Index(uint32_t object_instance)
 BACNET_DOOR_VALUE Access_Door_Present_Value(uint32_t object_instance)
 {
     unsigned index = 0;
-    unsigned i = 0;
     BACNET_DOOR_VALUE value = DOOR_VALUE_LOCK;
 
     index = Access_Door_Instance_To_Index(object_instance);
     if (index < MAX_ACCESS_DOORS) {
-        value = ad_descr[i].relinquish_default;
-        for (i = 0; i < BACNET_MAX_PRIORITY; i++) {
-            if (ad_descr[index].value_active[i]) {
-                value = ad_descr[index].priority_array[i];
-                break;
-            }
-        }
+        value = ad_descr[index].present_value;
     }
     return value;
 }
 
+/* update the cached present-value from the highest active priority,
+   or from the relinquish-default when no priority is active */
+static void Access_Door_Present_Value_Update(unsigned index)
+{
+    unsigned priority = 0;
+
+    priority = priority_array_active(&ad_descr[index].priority_active);
+    if (priority) {
+        ad_descr[index].present_value =
+            ad_descr[index].priority_array[priority - 1];
+    } else {
+        ad_descr[index].present_value = ad_descr[index].relinquish_default;
+    }
+}
+
 unsigned Access_Door_Present_Value_Priority(uint32_t object_instance)
 {
     unsigned index = 0; /* instance to index conversion */
-    unsigned i = 0; /* loop counter */
     unsigned priority = 0; /* return value */
 
     index = Access_Door_Instance_To_Index(object_instance);
     if (index < MAX_ACCESS_DOORS) {
-        for (i = 0; i < BACNET_MAX_PRIORITY; i++) {
-            if (ad_descr[index].value_active[i]) {
-                priority = i + 1;
-                break;
-            }
-        }
+        priority = priority_array_active(&ad_descr[index].priority_active);
     }
 
     return priority;
@@ -192,8 +195,11 @@ bool Access_Door_Present_Value_Set(
         if (priority && (priority <= BACNET_MAX_PRIORITY) &&
             (priority != 6 /* reserved */) &&
             (value <= DOOR_VALUE_EXTENDED_PULSE_UNLOCK)) {
-            ad_descr[index].value_active[priority - 1] = true;
             ad_descr[index].priority_array[priority - 1] = value;
+            if (priority_array_command(
+                    &ad_descr[index].priority_active, priority)) {
+                Access_Door_Present_Value_Update(index);
+            }
             /* Note: you could set the physical output here to the next
                highest priority, or to the relinquish default if no
                priorities are set.
@@ -217,7 +223,10 @@ bool Access_Door_Present_Value_Relinquish(
     if (index < MAX_ACCESS_DOORS) {
         if (priority && (priority <= BACNET_MAX_PRIORITY) &&
             (priority != 6 /* reserved */)) {
-            ad_descr[index].value_active[priority - 1] = false;
+            if (priority_array_relinquish(
+                    &ad_descr[index].priority_active, priority)) {
+                Access_Door_Present_Value_Update(index);
+            }
             /* Note: you could set the physical output here to the next
                highest priority, or to the relinquish default if no
                priorities are set.
@@ -260,12 +269,14 @@ static int Access_Door_Priority_Array_Encode(
     unsigned object_index = 0;
 
     object_index = Access_Door_Instance_To_Index(object_instance);
-    if (object_index < MAX_ACCESS_DOORS) {
-        if (ad_descr[object_index].value_active[array_index]) {
-            apdu_len = encode_application_null(apdu);
-        } else {
+    if ((object_index < MAX_ACCESS_DOORS) &&
+        (array_index < BACNET_MAX_PRIORITY)) {
+        if (priority_array_commanded(
+                &ad_descr[object_index].priority_active, array_index + 1)) {
             apdu_len = encode_application_enumerated(
                 apdu, ad_descr[object_index].priority_array[array_index]);
+        } else {
+            apdu_len = encode_application_null(apdu);
         }
     }
 
@@ -32,6 +32,7 @@
 #include "bacnet/bacerror.h"
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
+#include "bacnet/basic/sys/priority_array.h"
 
 
 #ifndef MAX_ACCESS_DOORS
@@ -44,8 +45,9 @@ extern "C" {
 #endif /* __cplusplus */
 
     typedef struct {
-        bool value_active[BACNET_MAX_PRIORITY];
+        BACNET_PRIORITY_ARRAY priority_active;
         BACNET_DOOR_VALUE priority_array[BACNET_MAX_PRIORITY];
+        BACNET_DOOR_VALUE present_value;
         BACNET_DOOR_VALUE relinquish_default;
         BACNET_EVENT_STATE event_state;
         BACNET_RELIABILITY reliability;
@@ -29,6 +29,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "bacnet/bacdef.h"
 #include "bacnet/bacdcode.h"
@@ -40,6 +41,8 @@
 #include "bacnet/proplist.h"
 #include "bacnet/timestamp.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/mempool.h"
 #include "bacnet/basic/object/ai.h"
 
 #define PRINTF debug_perror
@@ -47,8 +50,15 @@
 #ifndef MAX_ANALOG_INPUTS
 #define MAX_ANALOG_INPUTS 4
 #endif
+/* number of objects allocated from the heap at a time */
+#ifndef ANALOG_INPUT_POOL_SLAB_SIZE
+#define ANALOG_INPUT_POOL_SLAB_SIZE 64
+#endif
 
-static ANALOG_INPUT_DESCR AI_Descr[MAX_ANALOG_INPUTS];
+/* Key List for storing the object data sorted by instance number  */
+static OS_Keylist Object_List;
+/* storage for the object data */
+static MEMPOOL Object_Pool;
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
@@ -82,130 +92,97 @@ void Analog_Input_Property_Lists(
     return;
 }
 
-void Analog_Input_Init(void)
-{
-    unsigned i;
-#if defined(INTRINSIC_REPORTING)
-    unsigned j;
-#endif
-
-    for (i = 0; i < MAX_ANALOG_INPUTS; i++) {
-        AI_Descr[i].Present_Value = 0.0f;
-        AI_Descr[i].Out_Of_Service = false;
-        AI_Descr[i].Units = UNITS_PERCENT;
-        AI_Descr[i].Reliability = RELIABILITY_NO_FAULT_DETECTED;
-        AI_Descr[i].Prior_Value = 0.0f;
-        AI_Descr[i].COV_Increment = 1.0f;
-        AI_Descr[i].Changed = false;
-#if defined(INTRINSIC_REPORTING)
-        AI_Descr[i].Event_State = EVENT_STATE_NORMAL;
-        /* notification class not connected */
-        AI_Descr[i].Notification_Class = BACNET_MAX_INSTANCE;
-        /* initialize Event time stamps using wildcards
-           and set Acked_transitions */
-        for (j = 0; j < MAX_BACNET_EVENT_TRANSITION; j++) {
-            datetime_wildcard_set(&AI_Descr[i].Event_Time_Stamps[j]);
-            AI_Descr[i].Acked_Transitions[j].bIsAcked = true;
-        }
-
-        /* Set handler for GetEventInformation function */
-        handler_get_event_information_set(
-            OBJECT_ANALOG_INPUT, Analog_Input_Event_Information);
-        /* Set handler for AcknowledgeAlarm function */
-        handler_alarm_ack_set(OBJECT_ANALOG_INPUT, Analog_Input_Alarm_Ack);
-        /* Set handler for GetAlarmSummary Service */
-        handler_get_alarm_summary_set(
-            OBJECT_ANALOG_INPUT, Analog_Input_Alarm_Summary);
-#endif
-    }
-}
-
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need validate that the */
-/* given instance exists */
+/**
+ * @brief Determines if a given object instance is valid
+ * @param  object_instance - object-instance number of the object
+ * @return  true if the instance is valid, and false if not
+ */
 bool Analog_Input_Valid_Instance(uint32_t object_instance)
 {
-    unsigned int index;
+    ANALOG_INPUT_DESCR *pObject;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
         return true;
     }
 
     return false;
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then count how many you have */
+/**
+ * @brief Determines the number of objects
+ * @return  Number of objects
+ */
 unsigned Analog_Input_Count(void)
 {
-    return MAX_ANALOG_INPUTS;
+    return Keylist_Count(Object_List);
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need to return the instance */
-/* that correlates to the correct index */
+/**
+ * @brief Determines the object instance-number for a given 0..N index
+ * of objects where N is Analog_Input_Count().
+ * @param  index - 0..N where N is Analog_Input_Count().
+ * @return  object instance-number for the given index
+ */
 uint32_t Analog_Input_Index_To_Instance(unsigned index)
 {
-    return index;
+    return Keylist_Key(Object_List, index);
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need to return the index */
-/* that correlates to the correct instance number */
+/**
+ * @brief For a given object instance-number, determines a 0..N index
+ * of objects where N is Analog_Input_Count().
+ * @param  object_instance - object-instance number of the object
+ * @return  index for the given instance-number, or UINT_MAX
+ * (the unsigned -1 from Keylist_Index) if not valid.
+ */
 unsigned Analog_Input_Instance_To_Index(uint32_t object_instance)
 {
-    unsigned index = MAX_ANALOG_INPUTS;
-
-    if (object_instance < MAX_ANALOG_INPUTS) {
-        index = object_instance;
-    }
-
-    return index;
+    return Keylist_Index(Object_List, object_instance);
 }
 
 float Analog_Input_Present_Value(uint32_t object_instance)
 {
     float value = 0.0;
-    unsigned int index;
+    ANALOG_INPUT_DESCR *pObject;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        value = AI_Descr[index].Present_Value;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        value = pObject->Present_Value;
     }
 
     return value;
 }
 
-static void Analog_Input_COV_Detect(unsigned int index, float value)
+static void Analog_Input_COV_Detect(ANALOG_INPUT_DESCR *pObject, float value)
 {
     float prior_value = 0.0;
     float cov_increment = 0.0;
     float cov_delta = 0.0;
 
-    if (index < MAX_ANALOG_INPUTS) {
-        prior_value = AI_Descr[index].Prior_Value;
-        cov_increment = AI_Descr[index].COV_Increment;
+    if (pObject) {
+        prior_value = pObject->Prior_Value;
+        cov_increment = pObject->COV_Increment;
         if (prior_value > value) {
             cov_delta = prior_value - value;
         } else {
             cov_delta = value - prior_value;
         }
         if (cov_delta >= cov_increment) {
-            AI_Descr[index].Changed = true;
-            AI_Descr[index].Prior_Value = value;
+            pObject->Changed = true;
+            pObject->Prior_Value = value;
         }
     }
 }
 
 void Analog_Input_Present_Value_Set(uint32_t object_instance, float value)
 {
-    unsigned int index = 0;
+    ANALOG_INPUT_DESCR *pObject;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        Analog_Input_COV_Detect(index, value);
-        AI_Descr[index].Present_Value = value;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        Analog_Input_COV_Detect(pObject, value);
+        pObject->Present_Value = value;
     }
 }
 
@@ -213,12 +190,13 @@ bool Analog_Input_Object_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
     static char text_string[32] = ""; /* okay for single thread */
-    unsigned int index;
+    ANALOG_INPUT_DESCR *pObject;
     bool status = false;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        sprintf(text_string, "ANALOG INPUT %lu", (unsigned long)index);
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        sprintf(text_string, "ANALOG INPUT %lu",
+            (unsigned long)object_instance);
         status = characterstring_init_ansi(object_name, text_string);
     }
 
@@ -236,11 +214,11 @@ unsigned Analog_Input_Event_State(uint32_t object_instance)
 {
     unsigned state = EVENT_STATE_NORMAL;
 #if defined(INTRINSIC_REPORTING)
-    unsigned index = 0;
+    ANALOG_INPUT_DESCR *pObject;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        state = AI_Descr[index].Event_State;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        state = pObject->Event_State;
     }
 #endif
 
@@ -249,12 +227,12 @@ unsigned Analog_Input_Event_State(uint32_t object_instance)
 
 bool Analog_Input_Change_Of_Value(uint32_t object_instance)
 {
-    unsigned index = 0;
+    ANALOG_INPUT_DESCR *pObject;
     bool changed = false;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        changed = AI_Descr[index].Changed;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        changed = pObject->Changed;
     }
 
     return changed;
@@ -262,11 +240,11 @@ bool Analog_Input_Change_Of_Value(uint32_t object_instance)
 
 void Analog_Input_Change_Of_Value_Clear(uint32_t object_instance)
 {
-    unsigned index = 0;
+    ANALOG_INPUT_DESCR *pObject;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        AI_Descr[index].Changed = false;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        pObject->Changed = false;
     }
 }
 
@@ -287,15 +265,15 @@ bool Analog_Input_Encode_Value_List(
     const bool fault = false;
     const bool overridden = false;
     float present_value = 0.0;
-    unsigned index = 0; /* offset from instance lookup */
+    ANALOG_INPUT_DESCR *pObject;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        if (AI_Descr[index].Event_State != EVENT_STATE_NORMAL) {
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        if (pObject->Event_State != EVENT_STATE_NORMAL) {
             in_alarm = true;
         }
-        out_of_service = AI_Descr[index].Out_Of_Service;
-        present_value = AI_Descr[index].Present_Value;
+        out_of_service = pObject->Out_Of_Service;
+        present_value = pObject->Present_Value;
         status = cov_value_list_encode_real(value_list, present_value, in_alarm,
             fault, overridden, out_of_service);
     }
@@ -305,12 +283,12 @@ bool Analog_Input_Encode_Value_List(
 
 float Analog_Input_COV_Increment(uint32_t object_instance)
 {
-    unsigned index = 0;
+    ANALOG_INPUT_DESCR *pObject;
     float value = 0;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        value = AI_Descr[index].COV_Increment;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        value = pObject->COV_Increment;
     }
 
     return value;
@@ -318,23 +296,23 @@ float Analog_Input_COV_Increment(uint32_t object_instance)
 
 void Analog_Input_COV_Increment_Set(uint32_t object_instance, float value)
 {
-    unsigned index = 0;
+    ANALOG_INPUT_DESCR *pObject;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        AI_Descr[index].COV_Increment = value;
-        Analog_Input_COV_Detect(index, AI_Descr[index].Present_Value);
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        pObject->COV_Increment = value;
+        Analog_Input_COV_Detect(pObject, pObject->Present_Value);
     }
 }
 
 bool Analog_Input_Out_Of_Service(uint32_t object_instance)
 {
-    unsigned index = 0;
+    ANALOG_INPUT_DESCR *pObject;
     bool value = false;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
-        value = AI_Descr[index].Out_Of_Service;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        value = pObject->Out_Of_Service;
     }
 
     return value;
@@ -342,10 +320,10 @@ bool Analog_Input_Out_Of_Service(uint32_t object_instance)
 
 void Analog_Input_Out_Of_Service_Set(uint32_t object_instance, bool value)
 {
-    unsigned index = 0;
+    ANALOG_INPUT_DESCR *pObject;
 
-    index = Analog_Input_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_INPUTS) {
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
         /* 	BACnet Testing Observed Incident oi00104
                 The Changed flag was not being set when a client wrote to the
         Out-of-Service bit. Revealed by BACnet Test Client v1.8.16 (
@@ -354,10 +332,10 @@ void Analog_Input_Out_Of_Service_Set(uint32_t object_instance, bool value)
         Please feel free to remove this comment when my changes accepted after
         suitable time for review by all interested parties. Say 6 months ->
         September 2016 */
-        if (AI_Descr[index].Out_Of_Service != value) {
-            AI_Descr[index].Changed = true;
+        if (pObject->Out_Of_Service != value) {
+            pObject->Changed = true;
         }
-        AI_Descr[index].Out_Of_Service = value;
+        pObject->Out_Of_Service = value;
     }
 }
 
@@ -369,7 +347,6 @@ int Analog_Input_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
     ANALOG_INPUT_DESCR *CurrentAI;
-    unsigned object_index = 0;
 #if defined(INTRINSIC_REPORTING)
     unsigned i = 0;
     int len = 0;
@@ -381,10 +358,10 @@ int Analog_Input_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
         return 0;
     }
 
-    object_index = Analog_Input_Instance_To_Index(rpdata->object_instance);
-    if (object_index < MAX_ANALOG_INPUTS) {
-        CurrentAI = &AI_Descr[object_index];
-    } else {
+    CurrentAI = Keylist_Data(Object_List, rpdata->object_instance);
+    if (!CurrentAI) {
+        rpdata->error_class = ERROR_CLASS_OBJECT;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
         return BACNET_STATUS_ERROR;
     }
 
@@ -597,7 +574,6 @@ int Analog_Input_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 bool Analog_Input_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 {
     bool status = false; /* return value */
-    unsigned int object_index = 0;
     int len = 0;
     BACNET_APPLICATION_DATA_VALUE value;
     ANALOG_INPUT_DESCR *CurrentAI;
@@ -619,10 +595,10 @@ bool Analog_Input_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
         wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
         return false;
     }
-    object_index = Analog_Input_Instance_To_Index(wp_data->object_instance);
-    if (object_index < MAX_ANALOG_INPUTS) {
-        CurrentAI = &AI_Descr[object_index];
-    } else {
+    CurrentAI = Keylist_Data(Object_List, wp_data->object_instance);
+    if (!CurrentAI) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
         return false;
     }
 
@@ -790,23 +766,61 @@ bool Analog_Input_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     return status;
 }
 
+#if defined(INTRINSIC_REPORTING)
+/**
+ * @brief Keep the active event index in sync with the Event_State
+ *  and Acked_Transitions of this object
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ */
+static void Analog_Input_Event_Index_Update(
+    uint32_t object_instance, ANALOG_INPUT_DESCR *pObject)
+{
+    bool active;
+
+    active = (pObject->Event_State != EVENT_STATE_NORMAL) ||
+        !pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked;
+    Event_Index_Update(OBJECT_ANALOG_INPUT, object_instance,
+        Keylist_Index(Object_List, object_instance), active);
+}
+
+/**
+ * @brief The event index keeps the 0..N index of each object, so update
+ *  the objects that follow an object that was created or deleted
+ * @param object_instance - object-instance number of the object
+ */
+static void Analog_Input_Event_Index_Renumber(uint32_t object_instance)
+{
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t instance;
+    int position;
+
+    position = Event_Index_Position(OBJECT_ANALOG_INPUT, object_instance);
+    while (Event_Index_Item(position, &object_type, &instance, NULL) &&
+        (object_type == OBJECT_ANALOG_INPUT)) {
+        Event_Index_Update(object_type, instance,
+            Keylist_Index(Object_List, instance), true);
+        position++;
+    }
+}
+#endif
+
 void Analog_Input_Intrinsic_Reporting(uint32_t object_instance)
 {
 #if defined(INTRINSIC_REPORTING)
     BACNET_EVENT_NOTIFICATION_DATA event_data = { 0 };
     BACNET_CHARACTER_STRING msgText = { 0 };
     ANALOG_INPUT_DESCR *CurrentAI = NULL;
-    unsigned int object_index = 0;
     uint8_t FromState = 0;
     uint8_t ToState = 0;
     float ExceededLimit = 0.0f;
     float PresentVal = 0.0f;
     bool SendNotify = false;
 
-    object_index = Analog_Input_Instance_To_Index(object_instance);
-    if (object_index < MAX_ANALOG_INPUTS) {
-        CurrentAI = &AI_Descr[object_index];
-    } else {
+    CurrentAI = Keylist_Data(Object_List, object_instance);
+    if (!CurrentAI) {
         return;
     }
     /* check limits */
@@ -1118,6 +1132,7 @@ void Analog_Input_Intrinsic_Reporting(uint32_t object_instance)
                     break;
             }
         }
+        Analog_Input_Event_Index_Update(object_instance, CurrentAI);
     }
 #endif /* defined(INTRINSIC_REPORTING) */
 }
@@ -1126,24 +1141,24 @@ void Analog_Input_Intrinsic_Reporting(uint32_t object_instance)
 int Analog_Input_Event_Information(
     unsigned index, BACNET_GET_EVENT_INFORMATION_DATA *getevent_data)
 {
+    ANALOG_INPUT_DESCR *pObject;
     bool IsNotAckedTransitions;
     bool IsActiveEvent;
     int i;
 
-    /* check index */
-    if (index < MAX_ANALOG_INPUTS) {
+    pObject = Keylist_Data_Index(Object_List, index);
+    if (pObject) {
         /* Event_State not equal to NORMAL */
-        IsActiveEvent = (AI_Descr[index].Event_State != EVENT_STATE_NORMAL);
+        IsActiveEvent = (pObject->Event_State != EVENT_STATE_NORMAL);
 
         /* Acked_Transitions property, which has at least one of the bits
            (TO-OFFNORMAL, TO-FAULT, TONORMAL) set to FALSE. */
         IsNotAckedTransitions =
-            (AI_Descr[index]
-                    .Acked_Transitions[TRANSITION_TO_OFFNORMAL]
-                    .bIsAcked == false) |
-            (AI_Descr[index].Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ==
+            (pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ==
+                false) |
+            (pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ==
                 false) |
-            (AI_Descr[index].Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked ==
+            (pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked ==
                 false);
     } else
         return -1; /* end of list  */
@@ -1152,44 +1167,42 @@ int Analog_Input_Event_Information(
         /* Object Identifier */
         getevent_data->objectIdentifier.type = OBJECT_ANALOG_INPUT;
         getevent_data->objectIdentifier.instance =
-            Analog_Input_Index_To_Instance(index);
+            Keylist_Key(Object_List, index);
         /* Event State */
-        getevent_data->eventState = AI_Descr[index].Event_State;
+        getevent_data->eventState = pObject->Event_State;
         /* Acknowledged Transitions */
         bitstring_init(&getevent_data->acknowledgedTransitions);
         bitstring_set_bit(&getevent_data->acknowledgedTransitions,
             TRANSITION_TO_OFFNORMAL,
-            AI_Descr[index]
-                .Acked_Transitions[TRANSITION_TO_OFFNORMAL]
-                .bIsAcked);
+            pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked);
         bitstring_set_bit(&getevent_data->acknowledgedTransitions,
             TRANSITION_TO_FAULT,
-            AI_Descr[index].Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked);
+            pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked);
         bitstring_set_bit(&getevent_data->acknowledgedTransitions,
             TRANSITION_TO_NORMAL,
-            AI_Descr[index].Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked);
+            pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked);
         /* Event Time Stamps */
         for (i = 0; i < 3; i++) {
             getevent_data->eventTimeStamps[i].tag = TIME_STAMP_DATETIME;
             getevent_data->eventTimeStamps[i].value.dateTime =
-                AI_Descr[index].Event_Time_Stamps[i];
+                pObject->Event_Time_Stamps[i];
         }
         /* Notify Type */
-        getevent_data->notifyType = AI_Descr[index].Notify_Type;
+        getevent_data->notifyType = pObject->Notify_Type;
         /* Event Enable */
         bitstring_init(&getevent_data->eventEnable);
         bitstring_set_bit(&getevent_data->eventEnable, TRANSITION_TO_OFFNORMAL,
-            (AI_Descr[index].Event_Enable & EVENT_ENABLE_TO_OFFNORMAL) ? true
+            (pObject->Event_Enable & EVENT_ENABLE_TO_OFFNORMAL) ? true
                                                                        : false);
         bitstring_set_bit(&getevent_data->eventEnable, TRANSITION_TO_FAULT,
-            (AI_Descr[index].Event_Enable & EVENT_ENABLE_TO_FAULT) ? true
+            (pObject->Event_Enable & EVENT_ENABLE_TO_FAULT) ? true
                                                                    : false);
         bitstring_set_bit(&getevent_data->eventEnable, TRANSITION_TO_NORMAL,
-            (AI_Descr[index].Event_Enable & EVENT_ENABLE_TO_NORMAL) ? true
+            (pObject->Event_Enable & EVENT_ENABLE_TO_NORMAL) ? true
                                                                     : false);
         /* Event Priorities */
         Notification_Class_Get_Priorities(
-            AI_Descr[index].Notification_Class, getevent_data->eventPriorities);
+            pObject->Notification_Class, getevent_data->eventPriorities);
 
         return 1; /* active event */
     } else
@@ -1200,14 +1213,10 @@ int Analog_Input_Alarm_Ack(
     BACNET_ALARM_ACK_DATA *alarmack_data, BACNET_ERROR_CODE *error_code)
 {
     ANALOG_INPUT_DESCR *CurrentAI;
-    unsigned int object_index;
 
-    object_index = Analog_Input_Instance_To_Index(
-        alarmack_data->eventObjectIdentifier.instance);
-
-    if (object_index < MAX_ANALOG_INPUTS)
-        CurrentAI = &AI_Descr[object_index];
-    else {
+    CurrentAI = Keylist_Data(
+        Object_List, alarmack_data->eventObjectIdentifier.instance);
+    if (!CurrentAI) {
         *error_code = ERROR_CODE_UNKNOWN_OBJECT;
         return -1;
     }
@@ -1299,41 +1308,39 @@ int Analog_Input_Alarm_Ack(
     CurrentAI->Ack_notify_data.bSendAckNotify = true;
     CurrentAI->Ack_notify_data.EventState = alarmack_data->eventStateAcked;
 
+    Analog_Input_Event_Index_Update(
+        alarmack_data->eventObjectIdentifier.instance, CurrentAI);
+
     return 1;
 }
 
 int Analog_Input_Alarm_Summary(
     unsigned index, BACNET_GET_ALARM_SUMMARY_DATA *getalarm_data)
 {
-    /* check index */
-    if (index < MAX_ANALOG_INPUTS) {
+    ANALOG_INPUT_DESCR *pObject;
+    pObject = Keylist_Data_Index(Object_List, index);
+    if (pObject) {
         /* Event_State is not equal to NORMAL  and
            Notify_Type property value is ALARM */
-        if ((AI_Descr[index].Event_State != EVENT_STATE_NORMAL) &&
-            (AI_Descr[index].Notify_Type == NOTIFY_ALARM)) {
+        if ((pObject->Event_State != EVENT_STATE_NORMAL) &&
+            (pObject->Notify_Type == NOTIFY_ALARM)) {
             /* Object Identifier */
             getalarm_data->objectIdentifier.type = OBJECT_ANALOG_INPUT;
             getalarm_data->objectIdentifier.instance =
-                Analog_Input_Index_To_Instance(index);
+                Keylist_Key(Object_List, index);
             /* Alarm State */
-            getalarm_data->alarmState = AI_Descr[index].Event_State;
+            getalarm_data->alarmState = pObject->Event_State;
             /* Acknowledged Transitions */
             bitstring_init(&getalarm_data->acknowledgedTransitions);
             bitstring_set_bit(&getalarm_data->acknowledgedTransitions,
                 TRANSITION_TO_OFFNORMAL,
-                AI_Descr[index]
-                    .Acked_Transitions[TRANSITION_TO_OFFNORMAL]
-                    .bIsAcked);
+                pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked);
             bitstring_set_bit(&getalarm_data->acknowledgedTransitions,
                 TRANSITION_TO_FAULT,
-                AI_Descr[index]
-                    .Acked_Transitions[TRANSITION_TO_FAULT]
-                    .bIsAcked);
+                pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked);
             bitstring_set_bit(&getalarm_data->acknowledgedTransitions,
                 TRANSITION_TO_NORMAL,
-                AI_Descr[index]
-                    .Acked_Transitions[TRANSITION_TO_NORMAL]
-                    .bIsAcked);
+                pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked);
 
             return 1; /* active alarm */
         } else
@@ -1342,3 +1349,129 @@ int Analog_Input_Alarm_Summary(
         return -1; /* end of list  */
 }
 #endif /* defined(INTRINSIC_REPORTING) */
+
+/**
+ * @brief Creates a Analog Input object
+ * @param object_instance - object-instance number of the object
+ * @return true if the object was created
+ */
+bool Analog_Input_Create(uint32_t object_instance)
+{
+    bool status = false;
+    ANALOG_INPUT_DESCR *pObject = NULL;
+    int index = 0;
+#if defined(INTRINSIC_REPORTING)
+    unsigned j;
+#endif
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        pObject = Mempool_Alloc(&Object_Pool);
+        if (pObject) {
+            memset(pObject, 0, sizeof(ANALOG_INPUT_DESCR));
+            pObject->Present_Value = 0.0f;
+            pObject->Out_Of_Service = false;
+            pObject->Units = UNITS_PERCENT;
+            pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
+            pObject->Prior_Value = 0.0f;
+            pObject->COV_Increment = 1.0f;
+            pObject->Changed = false;
+#if defined(INTRINSIC_REPORTING)
+            pObject->Event_State = EVENT_STATE_NORMAL;
+            /* notification class not connected */
+            pObject->Notification_Class = BACNET_MAX_INSTANCE;
+            /* initialize Event time stamps using wildcards
+               and set Acked_transitions */
+            for (j = 0; j < MAX_BACNET_EVENT_TRANSITION; j++) {
+                datetime_wildcard_set(&pObject->Event_Time_Stamps[j]);
+                pObject->Acked_Transitions[j].bIsAcked = true;
+            }
+#endif
+            /* add to list */
+            index = Keylist_Data_Add(Object_List, object_instance, pObject);
+            if (index >= 0) {
+                status = true;
+#if defined(INTRINSIC_REPORTING)
+                Analog_Input_Event_Index_Renumber(object_instance + 1);
+#endif
+                Device_Inc_Database_Revision();
+            } else {
+                Mempool_Free(&Object_Pool, pObject);
+            }
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes a Analog Input object
+ * @param object_instance - object-instance number of the object
+ * @return true if the object was deleted
+ */
+bool Analog_Input_Delete(uint32_t object_instance)
+{
+    bool status = false;
+    ANALOG_INPUT_DESCR *pObject;
+
+    pObject = Keylist_Data_Delete(Object_List, object_instance);
+    if (pObject) {
+        Mempool_Free(&Object_Pool, pObject);
+        status = true;
+#if defined(INTRINSIC_REPORTING)
+        Event_Index_Update(OBJECT_ANALOG_INPUT, object_instance, 0, false);
+        Analog_Input_Event_Index_Renumber(object_instance);
+#endif
+        Device_Inc_Database_Revision();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes all the Analog Input objects and their storage
+ */
+void Analog_Input_Cleanup(void)
+{
+    if (Object_List) {
+        if (Keylist_Count(Object_List) > 0) {
+            Device_Inc_Database_Revision();
+        }
+        while (Keylist_Data_Pop(Object_List)) {
+            /* the object data is freed with the pool */
+        }
+        Keylist_Delete(Object_List);
+        Object_List = NULL;
+    }
+    Mempool_Cleanup(&Object_Pool);
+}
+
+/**
+ * @brief Initializes the Analog Input object data, and creates
+ *  the default objects with instances 0..MAX_ANALOG_INPUTS-1
+ */
+void Analog_Input_Init(void)
+{
+    unsigned i;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+        Mempool_Init(&Object_Pool, sizeof(ANALOG_INPUT_DESCR),
+            ANALOG_INPUT_POOL_SLAB_SIZE);
+#if defined(INTRINSIC_REPORTING)
+        /* instances start in NORMAL with all transitions acknowledged */
+        Event_Index_Type_Init(OBJECT_ANALOG_INPUT);
+        /* Set handler for GetEventInformation function */
+        handler_get_event_information_set(
+            OBJECT_ANALOG_INPUT, Analog_Input_Event_Information);
+        /* Set handler for AcknowledgeAlarm function */
+        handler_alarm_ack_set(OBJECT_ANALOG_INPUT, Analog_Input_Alarm_Ack);
+        /* Set handler for GetAlarmSummary Service */
+        handler_get_alarm_summary_set(
+            OBJECT_ANALOG_INPUT, Analog_Input_Alarm_Summary);
+#endif
+        for (i = 0; i < MAX_ANALOG_INPUTS; i++) {
+            Analog_Input_Create(i);
+        }
+    }
+}
@@ -53,6 +53,8 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/mempool.h"
+#include "bacnet/basic/sys/priority_array.h"
 /* me! */
 #include "ao.h"
 
@@ -62,9 +64,11 @@ struct object_data {
     bool Changed : 1;
     float COV_Increment;
     float Prior_Value;
-    bool Relinquished[BACNET_MAX_PRIORITY];
+    BACNET_PRIORITY_ARRAY Priority_Active;
     float Priority_Array[BACNET_MAX_PRIORITY];
     float Relinquish_Default;
+    /* the effective value of the priority-array */
+    float Present_Value;
     float Min_Pres_Value;
     float Max_Pres_Value;
     uint16_t Units;
@@ -74,6 +78,12 @@ struct object_data {
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* number of objects allocated from the heap at a time */
+#ifndef ANALOG_OUTPUT_POOL_SLAB_SIZE
+#define ANALOG_OUTPUT_POOL_SLAB_SIZE 64
+#endif
+/* storage for the object data */
+static MEMPOOL Object_Pool;
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_ANALOG_OUTPUT;
 /* callback for present value writes */
@@ -180,18 +190,11 @@ unsigned Analog_Output_Instance_To_Index(uint32_t object_instance)
 float Analog_Output_Present_Value(uint32_t object_instance)
 {
     float value = 0.0;
-    uint8_t priority = 0; /* loop counter */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        value = Analog_Output_Relinquish_Default(object_instance);
-        for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-            if (!pObject->Relinquished[priority]) {
-                value = pObject->Priority_Array[priority];
-                break;
-            }
-        }
+        value = pObject->Present_Value;
     }
 
     return value;
@@ -204,51 +207,90 @@ float Analog_Output_Present_Value(uint32_t object_instance)
  */
 unsigned Analog_Output_Present_Value_Priority(uint32_t object_instance)
 {
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (!pObject->Relinquished[p]) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority = priority_array_active(&pObject->Priority_Active);
     }
 
     return priority;
 }
 
 /**
- * @brief Encode a BACnetARRAY property element
- * @param object_instance [in] BACnet network port object instance number
- * @param index [in] array index requested:
- *    0 to N for individual array members
+ * @brief Encode the Priority_Array property, or one of its elements
+ * @param object_instance [in] BACnet object instance number
+ * @param array_index [in] array index requested:
+ *    0 for the array size, 1 to 16 for one element,
+ *    or BACNET_ARRAY_ALL for the entire array
  * @param apdu [out] Buffer in which the APDU contents are built, or NULL to
  * return the length of buffer if it had been built
+ * @param apdu_size [in] size of the apdu buffer
  * @return The length of the apdu encoded or
  *   BACNET_STATUS_ERROR for ERROR_CODE_INVALID_ARRAY_INDEX
+ *   BACNET_STATUS_ABORT for abort message.
  */
-static int Analog_Output_Priority_Array_Encode(
-    uint32_t object_instance, BACNET_ARRAY_INDEX index, uint8_t *apdu)
+static int Analog_Output_Priority_Array_Encode(uint32_t object_instance,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *apdu,
+    int apdu_size)
 {
-    int apdu_len = BACNET_STATUS_ERROR;
     struct object_data *pObject;
-    float real_value;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if (pObject && (index < BACNET_MAX_PRIORITY)) {
-        if (pObject->Relinquished[index]) {
-            apdu_len = encode_application_null(apdu);
+    if (!pObject) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return priority_array_real_encode(&pObject->Priority_Active,
+        pObject->Priority_Array, array_index, apdu, apdu_size);
+}
+
+/**
+ * For a given object instance-number, checks the present-value for COV
+ *
+ * @param  pObject - specific object with valid data
+ * @param  value - floating point analog value
+ */
+static void Analog_Output_Present_Value_COV_Detect(
+    struct object_data *pObject, float value)
+{
+    float prior_value = 0.0;
+    float cov_increment = 0.0;
+    float cov_delta = 0.0;
+
+    if (pObject) {
+        prior_value = pObject->Prior_Value;
+        cov_increment = pObject->COV_Increment;
+        if (prior_value > value) {
+            cov_delta = prior_value - value;
         } else {
-            real_value = pObject->Priority_Array[index];
-            apdu_len = encode_application_real(apdu, real_value);
+            cov_delta = value - prior_value;
+        }
+        if (cov_delta >= cov_increment) {
+            pObject->Changed = true;
+            pObject->Prior_Value = value;
         }
     }
+}
 
-    return apdu_len;
+/**
+ * @brief Update the effective value of the priority-array after the active
+ *  priority, or the value at the active priority, has changed
+ * @param  pObject - specific object with valid data
+ */
+static void Analog_Output_Present_Value_Update(struct object_data *pObject)
+{
+    unsigned priority;
+
+    priority = priority_array_active(&pObject->Priority_Active);
+    if (priority) {
+        pObject->Present_Value = pObject->Priority_Array[priority - 1];
+    } else {
+        pObject->Present_Value = pObject->Relinquish_Default;
+    }
+    Analog_Output_Present_Value_COV_Detect(pObject, pObject->Present_Value);
 }
 
 /**
@@ -287,40 +329,15 @@ bool Analog_Output_Relinquish_Default_Set(uint32_t object_instance, float value)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Relinquish_Default = value;
+        if (priority_array_active(&pObject->Priority_Active) == 0) {
+            Analog_Output_Present_Value_Update(pObject);
+        }
         status = true;
     }
 
     return status;
 }
 
-/**
- * For a given object instance-number, checks the present-value for COV
- *
- * @param  pObject - specific object with valid data
- * @param  value - floating point analog value
- */
-static void Analog_Output_Present_Value_COV_Detect(
-    struct object_data *pObject, float value)
-{
-    float prior_value = 0.0;
-    float cov_increment = 0.0;
-    float cov_delta = 0.0;
-
-    if (pObject) {
-        prior_value = pObject->Prior_Value;
-        cov_increment = pObject->COV_Increment;
-        if (prior_value > value) {
-            cov_delta = prior_value - value;
-        } else {
-            cov_delta = value - prior_value;
-        }
-        if (cov_delta >= cov_increment) {
-            pObject->Changed = true;
-            pObject->Prior_Value = value;
-        }
-    }
-}
-
 /**
  * For a given object instance-number, sets the present-value
  *
@@ -338,10 +355,10 @@ bool Analog_Output_Present_Value_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
-            pObject->Relinquished[priority - 1] = false;
             pObject->Priority_Array[priority - 1] = value;
-            Analog_Output_Present_Value_COV_Detect(
-                pObject, Analog_Output_Present_Value(object_instance));
+            if (priority_array_command(&pObject->Priority_Active, priority)) {
+                Analog_Output_Present_Value_Update(pObject);
+            }
             status = true;
         }
     }
@@ -364,10 +381,11 @@ bool Analog_Output_Present_Value_Relinquish(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
-            pObject->Relinquished[priority - 1] = true;
             pObject->Priority_Array[priority - 1] = 0.0;
-            Analog_Output_Present_Value_COV_Detect(
-                pObject, Analog_Output_Present_Value(object_instance));
+            if (priority_array_relinquish(
+                    &pObject->Priority_Active, priority)) {
+                Analog_Output_Present_Value_Update(pObject);
+            }
             status = true;
         }
     }
@@ -1043,9 +1061,8 @@ int Analog_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = encode_application_enumerated(&apdu[0], units);
             break;
         case PROP_PRIORITY_ARRAY:
-            apdu_len = bacnet_array_encode(rpdata->object_instance,
-                rpdata->array_index, Analog_Output_Priority_Array_Encode,
-                BACNET_MAX_PRIORITY, apdu, apdu_size);
+            apdu_len = Analog_Output_Priority_Array_Encode(
+                rpdata->object_instance, rpdata->array_index, apdu, apdu_size);
             if (apdu_len == BACNET_STATUS_ABORT) {
                 rpdata->error_code =
                     ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
@@ -1207,16 +1224,17 @@ bool Analog_Output_Create(uint32_t object_instance)
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Mempool_Alloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
             pObject->Overridden = false;
+            priority_array_init(&pObject->Priority_Active);
             for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-                pObject->Relinquished[priority] = true;
                 pObject->Priority_Array[priority] = 0.0;
             }
             pObject->Relinquish_Default = 0.0;
+            pObject->Present_Value = 0.0;
             pObject->COV_Increment = 1.0;
             pObject->Prior_Value = 0.0;
             pObject->Units = UNITS_NO_UNITS;
@@ -1229,6 +1247,8 @@ bool Analog_Output_Create(uint32_t object_instance)
             if (index >= 0) {
                 status = true;
                 Device_Inc_Database_Revision();
+            } else {
+                Mempool_Free(&Object_Pool, pObject);
             }
         }
     }
@@ -1248,7 +1268,7 @@ bool Analog_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Mempool_Free(&Object_Pool, pObject);
         status = true;
         Device_Inc_Database_Revision();
     }
@@ -1256,6 +1276,73 @@ bool Analog_Output_Delete(uint32_t object_instance)
     return status;
 }
 
+/**
+ * @brief Get the number of objects for a warm start snapshot
+ * @return number of objects
+ */
+uint32_t Analog_Output_Snapshot_Count(void)
+{
+    return (uint32_t)Keylist_Count(Object_List);
+}
+
+/**
+ * @brief Encode the priority-array of a commanded object as a warm start
+ *  snapshot record: instance, slots in use, and the slot values
+ * @param index - object 0..Analog_Output_Snapshot_Count()-1
+ * @param record - [out] ANALOG_OUTPUT_SNAPSHOT_RECORD_SIZE bytes
+ * @return true if the object was encoded
+ */
+bool Analog_Output_Snapshot_Encode(uint32_t index, uint8_t *record)
+{
+    struct object_data *pObject;
+    unsigned i;
+
+    pObject = Keylist_Data_Index(Object_List, index);
+    if (!record || !pObject || !pObject->Priority_Active.active_bits) {
+        return false;
+    }
+    encode_unsigned32(&record[0], Keylist_Key(Object_List, index));
+    encode_unsigned16(&record[4], pObject->Priority_Active.active_bits);
+    record[6] = 0;
+    record[7] = 0;
+    for (i = 0; i < BACNET_MAX_PRIORITY; i++) {
+        encode_bacnet_real(pObject->Priority_Array[i], &record[8 + (i * 4)]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Restore the priority-array of an object that exists from a warm
+ *  start snapshot record, and update its Present_Value
+ * @param index - record 0..N-1 of the snapshot
+ * @param record - ANALOG_OUTPUT_SNAPSHOT_RECORD_SIZE bytes
+ * @return true if the record was restored
+ */
+bool Analog_Output_Snapshot_Restore(uint32_t index, uint8_t *record)
+{
+    struct object_data *pObject;
+    uint32_t object_instance = 0;
+    unsigned i;
+
+    (void)index;
+    if (!record) {
+        return false;
+    }
+    decode_unsigned32(&record[0], &object_instance);
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return false;
+    }
+    decode_unsigned16(&record[4], &pObject->Priority_Active.active_bits);
+    for (i = 0; i < BACNET_MAX_PRIORITY; i++) {
+        decode_real(&record[8 + (i * 4)], &pObject->Priority_Array[i]);
+    }
+    Analog_Output_Present_Value_Update(pObject);
+
+    return true;
+}
+
 /**
  * @brief Deletes all the Analog Values and their data
  */
@@ -1267,13 +1354,14 @@ void Analog_Output_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                Mempool_Free(&Object_Pool, pObject);
                 Device_Inc_Database_Revision();
             }
         } while (pObject);
         Keylist_Delete(Object_List);
         Object_List = NULL;
     }
+    Mempool_Cleanup(&Object_Pool);
 }
 
 /**
@@ -1282,4 +1370,6 @@ void Analog_Output_Cleanup(void)
 void Analog_Output_Init(void)
 {
     Object_List = Keylist_Create();
+    Mempool_Init(&Object_Pool, sizeof(struct object_data),
+        ANALOG_OUTPUT_POOL_SLAB_SIZE);
 }
@@ -44,6 +44,11 @@
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 
+/* warm start snapshot record of a priority-array: instance, slots in use,
+   and the slot values - see snapshot.h */
+#define ANALOG_OUTPUT_SNAPSHOT_VERSION 1
+#define ANALOG_OUTPUT_SNAPSHOT_RECORD_SIZE (8 + (4 * BACNET_MAX_PRIORITY))
+
 /**
  * @brief Callback for gateway write present value request
  * @param  object_instance - object-instance number of the object
@@ -197,6 +202,17 @@ extern "C" {
     bool Analog_Output_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    uint32_t Analog_Output_Snapshot_Count(
+        void);
+    BACNET_STACK_EXPORT
+    bool Analog_Output_Snapshot_Encode(
+        uint32_t index,
+        uint8_t *record);
+    BACNET_STACK_EXPORT
+    bool Analog_Output_Snapshot_Restore(
+        uint32_t index,
+        uint8_t *record);
+    BACNET_STACK_EXPORT
     void Analog_Output_Cleanup(
         void);
     BACNET_STACK_EXPORT
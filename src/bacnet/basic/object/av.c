@@ -39,13 +39,22 @@
 #include "bacnet/config.h" /* the custom stuff */
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/mempool.h"
 #include "bacnet/basic/object/av.h"
 
 #ifndef MAX_ANALOG_VALUES
 #define MAX_ANALOG_VALUES 4
 #endif
+/* number of objects allocated from the heap at a time */
+#ifndef ANALOG_VALUE_POOL_SLAB_SIZE
+#define ANALOG_VALUE_POOL_SLAB_SIZE 64
+#endif
 
-static ANALOG_VALUE_DESCR AV_Descr[MAX_ANALOG_VALUES];
+/* Key List for storing the object data sorted by instance number  */
+static OS_Keylist Object_List;
+/* storage for the object data */
+static MEMPOOL Object_Pool;
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int Analog_Value_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
@@ -88,57 +97,16 @@ void Analog_Value_Property_Lists(
 }
 
 /**
- * Initialize the analog values.
- */
-void Analog_Value_Init(void)
-{
-    unsigned i;
-#if defined(INTRINSIC_REPORTING)
-    unsigned j;
-#endif
-
-    for (i = 0; i < MAX_ANALOG_VALUES; i++) {
-        memset(&AV_Descr[i], 0x00, sizeof(ANALOG_VALUE_DESCR));
-        AV_Descr[i].Present_Value = 0.0;
-        AV_Descr[i].Units = UNITS_NO_UNITS;
-        AV_Descr[i].Prior_Value = 0.0f;
-        AV_Descr[i].COV_Increment = 1.0f;
-        AV_Descr[i].Changed = false;
-#if defined(INTRINSIC_REPORTING)
-        AV_Descr[i].Event_State = EVENT_STATE_NORMAL;
-        /* notification class not connected */
-        AV_Descr[i].Notification_Class = BACNET_MAX_INSTANCE;
-        /* initialize Event time stamps using wildcards
-           and set Acked_transitions */
-        for (j = 0; j < MAX_BACNET_EVENT_TRANSITION; j++) {
-            datetime_wildcard_set(&AV_Descr[i].Event_Time_Stamps[j]);
-            AV_Descr[i].Acked_Transitions[j].bIsAcked = true;
-        }
-
-        /* Set handler for GetEventInformation function */
-        handler_get_event_information_set(
-            OBJECT_ANALOG_VALUE, Analog_Value_Event_Information);
-        /* Set handler for AcknowledgeAlarm function */
-        handler_alarm_ack_set(OBJECT_ANALOG_VALUE, Analog_Value_Alarm_Ack);
-        /* Set handler for GetAlarmSummary Service */
-        handler_get_alarm_summary_set(
-            OBJECT_ANALOG_VALUE, Analog_Value_Alarm_Summary);
-#endif
-    }
-}
-
-/**
- * We simply have 0-n object instances. Yours might be
- * more complex, and then you need validate that the
- * given instance exists.
- *
- * @param object_instance Object instance
- *
- * @return true/false
+ * @brief Determines if a given object instance is valid
+ * @param  object_instance - object-instance number of the object
+ * @return  true if the instance is valid, and false if not
  */
 bool Analog_Value_Valid_Instance(uint32_t object_instance)
 {
-    if (object_instance < MAX_ANALOG_VALUES) {
+    ANALOG_VALUE_DESCR *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
         return true;
     }
 
@@ -146,47 +114,35 @@ bool Analog_Value_Valid_Instance(uint32_t object_instance)
 }
 
 /**
- * Return the count of analog values.
- *
- * @return Count of analog values.
+ * @brief Determines the number of objects
+ * @return  Number of objects
  */
 unsigned Analog_Value_Count(void)
 {
-    return MAX_ANALOG_VALUES;
+    return Keylist_Count(Object_List);
 }
 
 /**
- * We simply have 0-n object instances.  Yours might be
- * more complex, and then you need to return the instance
- * that correlates to the correct index.
- *
- * @param index Index
- *
- * @return Object instance
+ * @brief Determines the object instance-number for a given 0..N index
+ * of objects where N is Analog_Value_Count().
+ * @param  index - 0..N where N is Analog_Value_Count().
+ * @return  object instance-number for the given index
  */
 uint32_t Analog_Value_Index_To_Instance(unsigned index)
 {
-    return index;
+    return Keylist_Key(Object_List, index);
 }
 
 /**
- * We simply have 0-n object instances.  Yours might be
- * more complex, and then you need to return the index
- * that correlates to the correct instance number
- *
- * @param object_instance Object instance
- *
- * @return Index in the object table.
+ * @brief For a given object instance-number, determines a 0..N index
+ * of objects where N is Analog_Value_Count().
+ * @param  object_instance - object-instance number of the object
+ * @return  index for the given instance-number, or UINT_MAX
+ * (the unsigned -1 from Keylist_Index) if not valid.
  */
 unsigned Analog_Value_Instance_To_Index(uint32_t object_instance)
 {
-    unsigned index = MAX_ANALOG_VALUES;
-
-    if (object_instance < MAX_ANALOG_VALUES) {
-        index = object_instance;
-    }
-
-    return index;
+    return Keylist_Index(Object_List, object_instance);
 }
 
 /**
@@ -196,26 +152,26 @@ unsigned Analog_Value_Instance_To_Index(uint32_t object_instance)
  *
  * This method will update the COV-changed attribute.
  *
- * @param index  Object index
+ * @param pObject  Object data
  * @param value  Given present value.
  */
-static void Analog_Value_COV_Detect(unsigned int index, float value)
+static void Analog_Value_COV_Detect(ANALOG_VALUE_DESCR *pObject, float value)
 {
     float prior_value = 0.0;
     float cov_increment = 0.0;
     float cov_delta = 0.0;
 
-    if (index < MAX_ANALOG_VALUES) {
-        prior_value = AV_Descr[index].Prior_Value;
-        cov_increment = AV_Descr[index].COV_Increment;
+    if (pObject) {
+        prior_value = pObject->Prior_Value;
+        cov_increment = pObject->COV_Increment;
         if (prior_value > value) {
             cov_delta = prior_value - value;
         } else {
             cov_delta = value - prior_value;
         }
         if (cov_delta >= cov_increment) {
-            AV_Descr[index].Changed = true;
-            AV_Descr[index].Prior_Value = value;
+            pObject->Changed = true;
+            pObject->Prior_Value = value;
         }
     }
 }
@@ -233,14 +189,14 @@ static void Analog_Value_COV_Detect(unsigned int index, float value)
 bool Analog_Value_Present_Value_Set(
     uint32_t object_instance, float value, uint8_t priority)
 {
-    unsigned index = 0;
+    ANALOG_VALUE_DESCR *pObject;
     bool status = false;
 
     (void)priority;
-    index = Analog_Value_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_VALUES) {
-        Analog_Value_COV_Detect(index, value);
-        AV_Descr[index].Present_Value = value;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        Analog_Value_COV_Detect(pObject, value);
+        pObject->Present_Value = value;
         status = true;
     }
 
@@ -257,11 +213,11 @@ bool Analog_Value_Present_Value_Set(
 float Analog_Value_Present_Value(uint32_t object_instance)
 {
     float value = 0;
-    unsigned index = 0;
+    ANALOG_VALUE_DESCR *pObject;
 
-    index = Analog_Value_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_VALUES) {
-        value = AV_Descr[index].Present_Value;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        value = pObject->Present_Value;
     }
 
     return value;
@@ -283,7 +239,7 @@ bool Analog_Value_Object_Name(
     static char text_string[32] = ""; /* okay for single thread */
     bool status = false;
 
-    if (object_instance < MAX_ANALOG_VALUES) {
+    if (Analog_Value_Valid_Instance(object_instance)) {
         sprintf(
             text_string, "ANALOG VALUE %lu", (unsigned long)object_instance);
         status = characterstring_init_ansi(object_name, text_string);
@@ -303,11 +259,11 @@ unsigned Analog_Value_Event_State(uint32_t object_instance)
 {
     unsigned state = EVENT_STATE_NORMAL;
 #if defined(INTRINSIC_REPORTING)
-    unsigned index = 0;
+    ANALOG_VALUE_DESCR *pObject;
 
-    index = Analog_Value_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_VALUES) {
-        state = AV_Descr[index].Event_State;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        state = pObject->Event_State;
     }
 #endif
 
@@ -324,12 +280,12 @@ unsigned Analog_Value_Event_State(uint32_t object_instance)
  */
 bool Analog_Value_Change_Of_Value(uint32_t object_instance)
 {
-    unsigned index = 0;
+    ANALOG_VALUE_DESCR *pObject;
     bool changed = false;
 
-    index = Analog_Value_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_VALUES) {
-        changed = AV_Descr[index].Changed;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        changed = pObject->Changed;
     }
 
     return changed;
@@ -342,11 +298,11 @@ bool Analog_Value_Change_Of_Value(uint32_t object_instance)
  */
 void Analog_Value_Change_Of_Value_Clear(uint32_t object_instance)
 {
-    unsigned index = 0;
+    ANALOG_VALUE_DESCR *pObject;
 
-    index = Analog_Value_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_VALUES) {
-        AV_Descr[index].Changed = false;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        pObject->Changed = false;
     }
 }
 
@@ -409,12 +365,12 @@ bool Analog_Value_Encode_Value_List(
 
 float Analog_Value_COV_Increment(uint32_t object_instance)
 {
-    unsigned index = 0;
+    ANALOG_VALUE_DESCR *pObject;
     float value = 0;
 
-    index = Analog_Value_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_VALUES) {
-        value = AV_Descr[index].COV_Increment;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        value = pObject->COV_Increment;
     }
 
     return value;
@@ -422,23 +378,23 @@ float Analog_Value_COV_Increment(uint32_t object_instance)
 
 void Analog_Value_COV_Increment_Set(uint32_t object_instance, float value)
 {
-    unsigned index = 0;
+    ANALOG_VALUE_DESCR *pObject;
 
-    index = Analog_Value_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_VALUES) {
-        AV_Descr[index].COV_Increment = value;
-        Analog_Value_COV_Detect(index, AV_Descr[index].Present_Value);
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        pObject->COV_Increment = value;
+        Analog_Value_COV_Detect(pObject, pObject->Present_Value);
     }
 }
 
 bool Analog_Value_Out_Of_Service(uint32_t object_instance)
 {
-    unsigned index = 0;
+    ANALOG_VALUE_DESCR *pObject;
     bool value = false;
 
-    index = Analog_Value_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_VALUES) {
-        value = AV_Descr[index].Out_Of_Service;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        value = pObject->Out_Of_Service;
     }
 
     return value;
@@ -446,14 +402,14 @@ bool Analog_Value_Out_Of_Service(uint32_t object_instance)
 
 void Analog_Value_Out_Of_Service_Set(uint32_t object_instance, bool value)
 {
-    unsigned index = 0;
+    ANALOG_VALUE_DESCR *pObject;
 
-    index = Analog_Value_Instance_To_Index(object_instance);
-    if (index < MAX_ANALOG_VALUES) {
-        if (AV_Descr[index].Out_Of_Service != value) {
-            AV_Descr[index].Changed = true;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        if (pObject->Out_Of_Service != value) {
+            pObject->Changed = true;
         }
-        AV_Descr[index].Out_Of_Service = value;
+        pObject->Out_Of_Service = value;
     }
 }
 
@@ -470,7 +426,6 @@ int Analog_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
     float real_value = (float)1.414;
-    unsigned object_index = 0;
     bool state = false;
     uint8_t *apdu = NULL;
     ANALOG_VALUE_DESCR *CurrentAV;
@@ -490,15 +445,13 @@ int Analog_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 
     apdu = rpdata->application_data;
 
-    object_index = Analog_Value_Instance_To_Index(rpdata->object_instance);
-    if (object_index >= MAX_ANALOG_VALUES) {
+    CurrentAV = Keylist_Data(Object_List, rpdata->object_instance);
+    if (!CurrentAV) {
         rpdata->error_class = ERROR_CLASS_OBJECT;
         rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
         return BACNET_STATUS_ERROR;
     }
 
-    CurrentAV = &AV_Descr[object_index];
-
     switch (rpdata->object_property) {
         case PROP_OBJECT_IDENTIFIER:
             apdu_len = encode_application_object_id(
@@ -703,7 +656,6 @@ int Analog_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 bool Analog_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 {
     bool status = false; /* return value */
-    unsigned int object_index = 0;
     int len = 0;
     BACNET_APPLICATION_DATA_VALUE value;
     ANALOG_VALUE_DESCR *CurrentAV;
@@ -736,15 +688,13 @@ bool Analog_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     }
 
     /* Valid object? */
-    object_index = Analog_Value_Instance_To_Index(wp_data->object_instance);
-    if (object_index >= MAX_ANALOG_VALUES) {
+    CurrentAV = Keylist_Data(Object_List, wp_data->object_instance);
+    if (!CurrentAV) {
         wp_data->error_class = ERROR_CLASS_OBJECT;
         wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
         return false;
     }
 
-    CurrentAV = &AV_Descr[object_index];
-
     switch (wp_data->object_property) {
         case PROP_PRESENT_VALUE:
             status = write_property_type_valid(
@@ -918,23 +868,61 @@ bool Analog_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     return status;
 }
 
+#if defined(INTRINSIC_REPORTING)
+/**
+ * @brief Keep the active event index in sync with the Event_State
+ *  and Acked_Transitions of this object
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ */
+static void Analog_Value_Event_Index_Update(
+    uint32_t object_instance, ANALOG_VALUE_DESCR *pObject)
+{
+    bool active;
+
+    active = (pObject->Event_State != EVENT_STATE_NORMAL) ||
+        !pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked;
+    Event_Index_Update(OBJECT_ANALOG_VALUE, object_instance,
+        Keylist_Index(Object_List, object_instance), active);
+}
+
+/**
+ * @brief The event index keeps the 0..N index of each object, so update
+ *  the objects that follow an object that was created or deleted
+ * @param object_instance - object-instance number of the object
+ */
+static void Analog_Value_Event_Index_Renumber(uint32_t object_instance)
+{
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t instance;
+    int position;
+
+    position = Event_Index_Position(OBJECT_ANALOG_VALUE, object_instance);
+    while (Event_Index_Item(position, &object_type, &instance, NULL) &&
+        (object_type == OBJECT_ANALOG_VALUE)) {
+        Event_Index_Update(object_type, instance,
+            Keylist_Index(Object_List, instance), true);
+        position++;
+    }
+}
+#endif
+
 void Analog_Value_Intrinsic_Reporting(uint32_t object_instance)
 {
 #if defined(INTRINSIC_REPORTING)
     BACNET_EVENT_NOTIFICATION_DATA event_data;
     BACNET_CHARACTER_STRING msgText;
     ANALOG_VALUE_DESCR *CurrentAV;
-    unsigned int object_index;
     uint8_t FromState = 0;
     uint8_t ToState;
     float ExceededLimit = 0.0f;
     float PresentVal = 0.0f;
     bool SendNotify = false;
 
-    object_index = Analog_Value_Instance_To_Index(object_instance);
-    if (object_index < MAX_ANALOG_VALUES)
-        CurrentAV = &AV_Descr[object_index];
-    else
+    CurrentAV = Keylist_Data(Object_List, object_instance);
+    if (!CurrentAV)
         return;
 
     /* check limits */
@@ -1225,6 +1213,7 @@ void Analog_Value_Intrinsic_Reporting(uint32_t object_instance)
                     break;
             }
         }
+        Analog_Value_Event_Index_Update(object_instance, CurrentAV);
     }
 #endif /* defined(INTRINSIC_REPORTING) */
 }
@@ -1233,24 +1222,24 @@ void Analog_Value_Intrinsic_Reporting(uint32_t object_instance)
 int Analog_Value_Event_Information(
     unsigned index, BACNET_GET_EVENT_INFORMATION_DATA *getevent_data)
 {
+    ANALOG_VALUE_DESCR *pObject;
     bool IsNotAckedTransitions;
     bool IsActiveEvent;
     int i;
 
-    /* check index */
-    if (index < MAX_ANALOG_VALUES) {
+    pObject = Keylist_Data_Index(Object_List, index);
+    if (pObject) {
         /* Event_State not equal to NORMAL */
-        IsActiveEvent = (AV_Descr[index].Event_State != EVENT_STATE_NORMAL);
+        IsActiveEvent = (pObject->Event_State != EVENT_STATE_NORMAL);
 
         /* Acked_Transitions property, which has at least one of the bits
            (TO-OFFNORMAL, TO-FAULT, TONORMAL) set to FALSE. */
         IsNotAckedTransitions =
-            (AV_Descr[index]
-                    .Acked_Transitions[TRANSITION_TO_OFFNORMAL]
-                    .bIsAcked == false) |
-            (AV_Descr[index].Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ==
+            (pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ==
+                false) |
+            (pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ==
                 false) |
-            (AV_Descr[index].Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked ==
+            (pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked ==
                 false);
     } else
         return -1; /* end of list  */
@@ -1259,44 +1248,42 @@ int Analog_Value_Event_Information(
         /* Object Identifier */
         getevent_data->objectIdentifier.type = OBJECT_ANALOG_VALUE;
         getevent_data->objectIdentifier.instance =
-            Analog_Value_Index_To_Instance(index);
+            Keylist_Key(Object_List, index);
         /* Event State */
-        getevent_data->eventState = AV_Descr[index].Event_State;
+        getevent_data->eventState = pObject->Event_State;
         /* Acknowledged Transitions */
         bitstring_init(&getevent_data->acknowledgedTransitions);
         bitstring_set_bit(&getevent_data->acknowledgedTransitions,
             TRANSITION_TO_OFFNORMAL,
-            AV_Descr[index]
-                .Acked_Transitions[TRANSITION_TO_OFFNORMAL]
-                .bIsAcked);
+            pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked);
         bitstring_set_bit(&getevent_data->acknowledgedTransitions,
             TRANSITION_TO_FAULT,
-            AV_Descr[index].Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked);
+            pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked);
         bitstring_set_bit(&getevent_data->acknowledgedTransitions,
             TRANSITION_TO_NORMAL,
-            AV_Descr[index].Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked);
+            pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked);
         /* Event Time Stamps */
         for (i = 0; i < 3; i++) {
             getevent_data->eventTimeStamps[i].tag = TIME_STAMP_DATETIME;
             getevent_data->eventTimeStamps[i].value.dateTime =
-                AV_Descr[index].Event_Time_Stamps[i];
+                pObject->Event_Time_Stamps[i];
         }
         /* Notify Type */
-        getevent_data->notifyType = AV_Descr[index].Notify_Type;
+        getevent_data->notifyType = pObject->Notify_Type;
         /* Event Enable */
         bitstring_init(&getevent_data->eventEnable);
         bitstring_set_bit(&getevent_data->eventEnable, TRANSITION_TO_OFFNORMAL,
-            (AV_Descr[index].Event_Enable & EVENT_ENABLE_TO_OFFNORMAL) ? true
+            (pObject->Event_Enable & EVENT_ENABLE_TO_OFFNORMAL) ? true
                                                                        : false);
         bitstring_set_bit(&getevent_data->eventEnable, TRANSITION_TO_FAULT,
-            (AV_Descr[index].Event_Enable & EVENT_ENABLE_TO_FAULT) ? true
+            (pObject->Event_Enable & EVENT_ENABLE_TO_FAULT) ? true
                                                                    : false);
         bitstring_set_bit(&getevent_data->eventEnable, TRANSITION_TO_NORMAL,
-            (AV_Descr[index].Event_Enable & EVENT_ENABLE_TO_NORMAL) ? true
+            (pObject->Event_Enable & EVENT_ENABLE_TO_NORMAL) ? true
                                                                     : false);
         /* Event Priorities */
         Notification_Class_Get_Priorities(
-            AV_Descr[index].Notification_Class, getevent_data->eventPriorities);
+            pObject->Notification_Class, getevent_data->eventPriorities);
 
         return 1; /* active event */
     } else
@@ -1307,14 +1294,10 @@ int Analog_Value_Alarm_Ack(
     BACNET_ALARM_ACK_DATA *alarmack_data, BACNET_ERROR_CODE *error_code)
 {
     ANALOG_VALUE_DESCR *CurrentAV;
-    unsigned int object_index;
 
-    object_index = Analog_Value_Instance_To_Index(
-        alarmack_data->eventObjectIdentifier.instance);
-
-    if (object_index < MAX_ANALOG_VALUES)
-        CurrentAV = &AV_Descr[object_index];
-    else {
+    CurrentAV = Keylist_Data(
+        Object_List, alarmack_data->eventObjectIdentifier.instance);
+    if (!CurrentAV) {
         *error_code = ERROR_CODE_UNKNOWN_OBJECT;
         return -1;
     }
@@ -1411,6 +1394,9 @@ int Analog_Value_Alarm_Ack(
     CurrentAV->Ack_notify_data.bSendAckNotify = true;
     CurrentAV->Ack_notify_data.EventState = alarmack_data->eventStateAcked;
 
+    Analog_Value_Event_Index_Update(
+        alarmack_data->eventObjectIdentifier.instance, CurrentAV);
+
     /* Return OK */
     return 1;
 }
@@ -1418,35 +1404,30 @@ int Analog_Value_Alarm_Ack(
 int Analog_Value_Alarm_Summary(
     unsigned index, BACNET_GET_ALARM_SUMMARY_DATA *getalarm_data)
 {
-    /* check index */
-    if (index < MAX_ANALOG_VALUES) {
+    ANALOG_VALUE_DESCR *pObject;
+    pObject = Keylist_Data_Index(Object_List, index);
+    if (pObject) {
         /* Event_State is not equal to NORMAL  and
            Notify_Type property value is ALARM */
-        if ((AV_Descr[index].Event_State != EVENT_STATE_NORMAL) &&
-            (AV_Descr[index].Notify_Type == NOTIFY_ALARM)) {
+        if ((pObject->Event_State != EVENT_STATE_NORMAL) &&
+            (pObject->Notify_Type == NOTIFY_ALARM)) {
             /* Object Identifier */
             getalarm_data->objectIdentifier.type = OBJECT_ANALOG_VALUE;
             getalarm_data->objectIdentifier.instance =
-                Analog_Value_Index_To_Instance(index);
+                Keylist_Key(Object_List, index);
             /* Alarm State */
-            getalarm_data->alarmState = AV_Descr[index].Event_State;
+            getalarm_data->alarmState = pObject->Event_State;
             /* Acknowledged Transitions */
             bitstring_init(&getalarm_data->acknowledgedTransitions);
             bitstring_set_bit(&getalarm_data->acknowledgedTransitions,
                 TRANSITION_TO_OFFNORMAL,
-                AV_Descr[index]
-                    .Acked_Transitions[TRANSITION_TO_OFFNORMAL]
-                    .bIsAcked);
+                pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked);
             bitstring_set_bit(&getalarm_data->acknowledgedTransitions,
                 TRANSITION_TO_FAULT,
-                AV_Descr[index]
-                    .Acked_Transitions[TRANSITION_TO_FAULT]
-                    .bIsAcked);
+                pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked);
             bitstring_set_bit(&getalarm_data->acknowledgedTransitions,
                 TRANSITION_TO_NORMAL,
-                AV_Descr[index]
-                    .Acked_Transitions[TRANSITION_TO_NORMAL]
-                    .bIsAcked);
+                pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked);
 
             return 1; /* active alarm */
         } else
@@ -1455,3 +1436,127 @@ int Analog_Value_Alarm_Summary(
         return -1; /* end of list  */
 }
 #endif /* defined(INTRINSIC_REPORTING) */
+
+/**
+ * @brief Creates a Analog Value object
+ * @param object_instance - object-instance number of the object
+ * @return true if the object was created
+ */
+bool Analog_Value_Create(uint32_t object_instance)
+{
+    bool status = false;
+    ANALOG_VALUE_DESCR *pObject = NULL;
+    int index = 0;
+#if defined(INTRINSIC_REPORTING)
+    unsigned j;
+#endif
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        pObject = Mempool_Alloc(&Object_Pool);
+        if (pObject) {
+            memset(pObject, 0, sizeof(ANALOG_VALUE_DESCR));
+            pObject->Present_Value = 0.0f;
+            pObject->Units = UNITS_NO_UNITS;
+            pObject->Prior_Value = 0.0f;
+            pObject->COV_Increment = 1.0f;
+            pObject->Changed = false;
+#if defined(INTRINSIC_REPORTING)
+            pObject->Event_State = EVENT_STATE_NORMAL;
+            /* notification class not connected */
+            pObject->Notification_Class = BACNET_MAX_INSTANCE;
+            /* initialize Event time stamps using wildcards
+               and set Acked_transitions */
+            for (j = 0; j < MAX_BACNET_EVENT_TRANSITION; j++) {
+                datetime_wildcard_set(&pObject->Event_Time_Stamps[j]);
+                pObject->Acked_Transitions[j].bIsAcked = true;
+            }
+#endif
+            /* add to list */
+            index = Keylist_Data_Add(Object_List, object_instance, pObject);
+            if (index >= 0) {
+                status = true;
+#if defined(INTRINSIC_REPORTING)
+                Analog_Value_Event_Index_Renumber(object_instance + 1);
+#endif
+                Device_Inc_Database_Revision();
+            } else {
+                Mempool_Free(&Object_Pool, pObject);
+            }
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes a Analog Value object
+ * @param object_instance - object-instance number of the object
+ * @return true if the object was deleted
+ */
+bool Analog_Value_Delete(uint32_t object_instance)
+{
+    bool status = false;
+    ANALOG_VALUE_DESCR *pObject;
+
+    pObject = Keylist_Data_Delete(Object_List, object_instance);
+    if (pObject) {
+        Mempool_Free(&Object_Pool, pObject);
+        status = true;
+#if defined(INTRINSIC_REPORTING)
+        Event_Index_Update(OBJECT_ANALOG_VALUE, object_instance, 0, false);
+        Analog_Value_Event_Index_Renumber(object_instance);
+#endif
+        Device_Inc_Database_Revision();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes all the Analog Value objects and their storage
+ */
+void Analog_Value_Cleanup(void)
+{
+    if (Object_List) {
+        if (Keylist_Count(Object_List) > 0) {
+            Device_Inc_Database_Revision();
+        }
+        while (Keylist_Data_Pop(Object_List)) {
+            /* the object data is freed with the pool */
+        }
+        Keylist_Delete(Object_List);
+        Object_List = NULL;
+    }
+    Mempool_Cleanup(&Object_Pool);
+}
+
+/**
+ * @brief Initializes the Analog Value object data, and creates
+ *  the default objects with instances 0..MAX_ANALOG_VALUES-1
+ */
+void Analog_Value_Init(void)
+{
+    unsigned i;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+        Mempool_Init(&Object_Pool, sizeof(ANALOG_VALUE_DESCR),
+            ANALOG_VALUE_POOL_SLAB_SIZE);
+#if defined(INTRINSIC_REPORTING)
+        /* instances start in NORMAL with all transitions acknowledged */
+        Event_Index_Type_Init(OBJECT_ANALOG_VALUE);
+        /* Set handler for GetEventInformation function */
+        handler_get_event_information_set(
+            OBJECT_ANALOG_VALUE, Analog_Value_Event_Information);
+        /* Set handler for AcknowledgeAlarm function */
+        handler_alarm_ack_set(OBJECT_ANALOG_VALUE, Analog_Value_Alarm_Ack);
+        /* Set handler for GetAlarmSummary Service */
+        handler_get_alarm_summary_set(
+            OBJECT_ANALOG_VALUE, Analog_Value_Alarm_Summary);
+#endif
+        for (i = 0; i < MAX_ANALOG_VALUES; i++) {
+            Analog_Value_Create(i);
+        }
+    }
+}
@@ -36,21 +36,34 @@
 #include "bacnet/wp.h"
 #include "bacnet/cov.h"
 #include "bacnet/config.h" /* the custom stuff */
+#include "bacnet/basic/object/device.h"
 #include "bacnet/basic/object/bi.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/mempool.h"
 
 #ifndef MAX_BINARY_INPUTS
 #define MAX_BINARY_INPUTS 5
 #endif
+/* number of objects allocated from the heap at a time */
+#ifndef BINARY_INPUT_POOL_SLAB_SIZE
+#define BINARY_INPUT_POOL_SLAB_SIZE 64
+#endif
 
-/* stores the current value */
-static BACNET_BINARY_PV Present_Value[MAX_BINARY_INPUTS];
-/* out of service decouples physical input from Present_Value */
-static bool Out_Of_Service[MAX_BINARY_INPUTS];
-/* Change of Value flag */
-static bool Change_Of_Value[MAX_BINARY_INPUTS];
-/* Polarity of Input */
-static BACNET_POLARITY Polarity[MAX_BINARY_INPUTS];
+struct object_data {
+    /* stores the current value */
+    BACNET_BINARY_PV Present_Value;
+    /* Polarity of Input */
+    BACNET_POLARITY Polarity;
+    /* out of service decouples physical input from Present_Value */
+    bool Out_Of_Service : 1;
+    /* Change of Value flag */
+    bool Change_Of_Value : 1;
+};
+/* Key List for storing the object data sorted by instance number  */
+static OS_Keylist Object_List;
+/* storage for the object data */
+static MEMPOOL Object_Pool;
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int Binary_Input_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
@@ -77,73 +90,64 @@ void Binary_Input_Property_Lists(
     return;
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need validate that the */
-/* given instance exists */
+/**
+ * @brief Determines if a given object instance is valid
+ * @param  object_instance - object-instance number of the object
+ * @return  true if the instance is valid, and false if not
+ */
 bool Binary_Input_Valid_Instance(uint32_t object_instance)
 {
-    if (object_instance < MAX_BINARY_INPUTS) {
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
         return true;
     }
 
     return false;
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then count how many you have */
+/**
+ * @brief Determines the number of objects
+ * @return  Number of objects
+ */
 unsigned Binary_Input_Count(void)
 {
-    return MAX_BINARY_INPUTS;
+    return Keylist_Count(Object_List);
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need to return the instance */
-/* that correlates to the correct index */
+/**
+ * @brief Determines the object instance-number for a given 0..N index
+ * of objects where N is Binary_Input_Count().
+ * @param  index - 0..N where N is Binary_Input_Count().
+ * @return  object instance-number for the given index
+ */
 uint32_t Binary_Input_Index_To_Instance(unsigned index)
 {
-    return index;
-}
-
-void Binary_Input_Init(void)
-{
-    static bool initialized = false;
-    unsigned i;
-
-    if (!initialized) {
-        initialized = true;
-
-        /* initialize all the values */
-        for (i = 0; i < MAX_BINARY_INPUTS; i++) {
-            Present_Value[i] = BINARY_INACTIVE;
-        }
-    }
-
-    return;
+    return Keylist_Key(Object_List, index);
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need to return the index */
-/* that correlates to the correct instance number */
+/**
+ * @brief For a given object instance-number, determines a 0..N index
+ * of objects where N is Binary_Input_Count().
+ * @param  object_instance - object-instance number of the object
+ * @return  index for the given instance-number, or UINT_MAX
+ * (the unsigned -1 from Keylist_Index) if not valid.
+ */
 unsigned Binary_Input_Instance_To_Index(uint32_t object_instance)
 {
-    unsigned index = MAX_BINARY_INPUTS;
-
-    if (object_instance < MAX_BINARY_INPUTS) {
-        index = object_instance;
-    }
-
-    return index;
+    return Keylist_Index(Object_List, object_instance);
 }
 
 BACNET_BINARY_PV Binary_Input_Present_Value(uint32_t object_instance)
 {
     BACNET_BINARY_PV value = BINARY_INACTIVE;
-    unsigned index = 0;
+    struct object_data *pObject;
 
-    index = Binary_Input_Instance_To_Index(object_instance);
-    if (index < MAX_BINARY_INPUTS) {
-        value = Present_Value[index];
-        if (Polarity[index] != POLARITY_NORMAL) {
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        value = pObject->Present_Value;
+        if (pObject->Polarity != POLARITY_NORMAL) {
             if (value == BINARY_INACTIVE) {
                 value = BINARY_ACTIVE;
             } else {
@@ -158,11 +162,11 @@ BACNET_BINARY_PV Binary_Input_Present_Value(uint32_t object_instance)
 bool Binary_Input_Out_Of_Service(uint32_t object_instance)
 {
     bool value = false;
-    unsigned index = 0;
+    struct object_data *pObject;
 
-    index = Binary_Input_Instance_To_Index(object_instance);
-    if (index < MAX_BINARY_INPUTS) {
-        value = Out_Of_Service[index];
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        value = pObject->Out_Of_Service;
     }
 
     return value;
@@ -171,11 +175,11 @@ bool Binary_Input_Out_Of_Service(uint32_t object_instance)
 bool Binary_Input_Change_Of_Value(uint32_t object_instance)
 {
     bool status = false;
-    unsigned index;
+    struct object_data *pObject;
 
-    index = Binary_Input_Instance_To_Index(object_instance);
-    if (index < MAX_BINARY_INPUTS) {
-        status = Change_Of_Value[index];
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        status = pObject->Change_Of_Value;
     }
 
     return status;
@@ -183,11 +187,11 @@ bool Binary_Input_Change_Of_Value(uint32_t object_instance)
 
 void Binary_Input_Change_Of_Value_Clear(uint32_t object_instance)
 {
-    unsigned index;
+    struct object_data *pObject;
 
-    index = Binary_Input_Instance_To_Index(object_instance);
-    if (index < MAX_BINARY_INPUTS) {
-        Change_Of_Value[index] = false;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        pObject->Change_Of_Value = false;
     }
 
     return;
@@ -248,22 +252,22 @@ bool Binary_Input_Encode_Value_List(
 bool Binary_Input_Present_Value_Set(
     uint32_t object_instance, BACNET_BINARY_PV value)
 {
-    unsigned index = 0;
     bool status = false;
+    struct object_data *pObject;
 
-    index = Binary_Input_Instance_To_Index(object_instance);
-    if (index < MAX_BINARY_INPUTS) {
-        if (Polarity[index] != POLARITY_NORMAL) {
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        if (pObject->Polarity != POLARITY_NORMAL) {
             if (value == BINARY_INACTIVE) {
                 value = BINARY_ACTIVE;
             } else {
                 value = BINARY_INACTIVE;
             }
         }
-        if (Present_Value[index] != value) {
-            Change_Of_Value[index] = true;
+        if (pObject->Present_Value != value) {
+            pObject->Change_Of_Value = true;
         }
-        Present_Value[index] = value;
+        pObject->Present_Value = value;
         status = true;
     }
 
@@ -272,14 +276,14 @@ bool Binary_Input_Present_Value_Set(
 
 void Binary_Input_Out_Of_Service_Set(uint32_t object_instance, bool value)
 {
-    unsigned index = 0;
+    struct object_data *pObject;
 
-    index = Binary_Input_Instance_To_Index(object_instance);
-    if (index < MAX_BINARY_INPUTS) {
-        if (Out_Of_Service[index] != value) {
-            Change_Of_Value[index] = true;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        if (pObject->Out_Of_Service != value) {
+            pObject->Change_Of_Value = true;
         }
-        Out_Of_Service[index] = value;
+        pObject->Out_Of_Service = value;
     }
 
     return;
@@ -290,10 +294,8 @@ bool Binary_Input_Object_Name(
 {
     static char text_string[32] = ""; /* okay for single thread */
     bool status = false;
-    unsigned index = 0;
 
-    index = Binary_Input_Instance_To_Index(object_instance);
-    if (index < MAX_BINARY_INPUTS) {
+    if (Binary_Input_Valid_Instance(object_instance)) {
         sprintf(
             text_string, "BINARY INPUT %lu", (unsigned long)object_instance);
         status = characterstring_init_ansi(object_name, text_string);
@@ -305,11 +307,11 @@ bool Binary_Input_Object_Name(
 BACNET_POLARITY Binary_Input_Polarity(uint32_t object_instance)
 {
     BACNET_POLARITY polarity = POLARITY_NORMAL;
-    unsigned index = 0;
+    struct object_data *pObject;
 
-    index = Binary_Input_Instance_To_Index(object_instance);
-    if (index < MAX_BINARY_INPUTS) {
-        polarity = Polarity[index];
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        polarity = pObject->Polarity;
     }
 
     return polarity;
@@ -319,11 +321,12 @@ bool Binary_Input_Polarity_Set(
     uint32_t object_instance, BACNET_POLARITY polarity)
 {
     bool status = false;
-    unsigned index = 0;
+    struct object_data *pObject;
 
-    index = Binary_Input_Instance_To_Index(object_instance);
-    if (index < MAX_BINARY_INPUTS) {
-        Polarity[index] = polarity;
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        pObject->Polarity = polarity;
+        status = true;
     }
 
     return status;
@@ -481,3 +484,94 @@ bool Binary_Input_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 
     return status;
 }
+
+/**
+ * @brief Creates a Binary Input object
+ * @param object_instance - object-instance number of the object
+ * @return true if the object was created
+ */
+bool Binary_Input_Create(uint32_t object_instance)
+{
+    bool status = false;
+    struct object_data *pObject = NULL;
+    int index = 0;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        pObject = Mempool_Alloc(&Object_Pool);
+        if (pObject) {
+            pObject->Present_Value = BINARY_INACTIVE;
+            pObject->Polarity = POLARITY_NORMAL;
+            pObject->Out_Of_Service = false;
+            pObject->Change_Of_Value = false;
+            /* add to list */
+            index = Keylist_Data_Add(Object_List, object_instance, pObject);
+            if (index >= 0) {
+                status = true;
+                Device_Inc_Database_Revision();
+            } else {
+                Mempool_Free(&Object_Pool, pObject);
+            }
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes a Binary Input object
+ * @param object_instance - object-instance number of the object
+ * @return true if the object was deleted
+ */
+bool Binary_Input_Delete(uint32_t object_instance)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Keylist_Data_Delete(Object_List, object_instance);
+    if (pObject) {
+        Mempool_Free(&Object_Pool, pObject);
+        status = true;
+        Device_Inc_Database_Revision();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes all the Binary Input objects and their storage
+ */
+void Binary_Input_Cleanup(void)
+{
+    if (Object_List) {
+        if (Keylist_Count(Object_List) > 0) {
+            Device_Inc_Database_Revision();
+        }
+        while (Keylist_Data_Pop(Object_List)) {
+            /* the object data is freed with the pool */
+        }
+        Keylist_Delete(Object_List);
+        Object_List = NULL;
+    }
+    Mempool_Cleanup(&Object_Pool);
+}
+
+/**
+ * @brief Initializes the Binary Input object data, and creates
+ *  the default objects with instances 0..MAX_BINARY_INPUTS-1
+ */
+void Binary_Input_Init(void)
+{
+    unsigned i;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+        Mempool_Init(&Object_Pool, sizeof(struct object_data),
+            BINARY_INPUT_POOL_SLAB_SIZE);
+        for (i = 0; i < MAX_BINARY_INPUTS; i++) {
+            Binary_Input_Create(i);
+        }
+    }
+
+    return;
+}
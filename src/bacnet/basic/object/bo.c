@@ -52,6 +52,8 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/mempool.h"
+#include "bacnet/basic/sys/priority_array.h"
 /* me! */
 #include "bo.h"
 
@@ -60,11 +62,12 @@ static const char *Default_Inactive_Text = "Inactive";
 struct object_data {
     bool Out_Of_Service : 1;
     bool Changed : 1;
+    /* the effective value of the priority-array */
     bool Present_Value : 1;
     bool Relinquish_Default : 1;
     bool Polarity : 1;
     uint16_t Priority_Array;
-    uint16_t Priority_Active_Bits;
+    BACNET_PRIORITY_ARRAY Priority_Active;
     uint8_t Reliability;
     const char *Object_Name;
     const char *Active_Text;
@@ -73,6 +76,12 @@ struct object_data {
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* number of objects allocated from the heap at a time */
+#ifndef BINARY_OUTPUT_POOL_SLAB_SIZE
+#define BINARY_OUTPUT_POOL_SLAB_SIZE 64
+#endif
+/* storage for the object data */
+static MEMPOOL Object_Pool;
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_BINARY_OUTPUT;
 /* callback for present value writes */
@@ -187,29 +196,41 @@ unsigned Binary_Output_Instance_To_Index(uint32_t object_instance)
 BACNET_BINARY_PV Binary_Output_Present_Value(uint32_t object_instance)
 {
     BACNET_BINARY_PV value = BINARY_INACTIVE;
-    unsigned p = 0;
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        if (pObject->Relinquish_Default) {
+        if (pObject->Present_Value) {
             value = BINARY_ACTIVE;
         }
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-                if (BIT_CHECK(pObject->Priority_Array, p)) {
-                    value = BINARY_ACTIVE;
-                } else {
-                    value = BINARY_INACTIVE;
-                }
-                break;
-            }
-        }
     }
 
     return value;
 }
 
+/**
+ * @brief Update the effective value of the priority-array after the active
+ *  priority, or the value at the active priority, has changed, and flag
+ *  the change for COV
+ * @param  pObject - specific object with valid data
+ */
+static void Binary_Output_Present_Value_Update(struct object_data *pObject)
+{
+    unsigned priority;
+    bool value;
+
+    priority = priority_array_active(&pObject->Priority_Active);
+    if (priority) {
+        value = BIT_CHECK(pObject->Priority_Array, priority - 1) ? true : false;
+    } else {
+        value = pObject->Relinquish_Default;
+    }
+    if (pObject->Present_Value != value) {
+        pObject->Present_Value = value;
+        pObject->Changed = true;
+    }
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -229,7 +250,7 @@ static int Binary_Output_Priority_Array_Encode(
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && (index < BACNET_MAX_PRIORITY)) {
-        if (BIT_CHECK(pObject->Priority_Active_Bits, index)) {
+        if (priority_array_commanded(&pObject->Priority_Active, index + 1)) {
             if (BIT_CHECK(pObject->Priority_Array, index)) {
                 value = BINARY_ACTIVE;
             }
@@ -251,18 +272,12 @@ static int Binary_Output_Priority_Array_Encode(
  */
 unsigned Binary_Output_Present_Value_Priority(uint32_t object_instance)
 {
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority = priority_array_active(&pObject->Priority_Active);
     }
 
     return priority;
@@ -288,13 +303,15 @@ bool Binary_Output_Present_Value_Set(
     if (pObject) {
         if (priority && (priority <= BACNET_MAX_PRIORITY) &&
             (priority != 6 /* reserved */)) {
-            priority--;
             if (binary_value <= MAX_BINARY_PV) {
-                BIT_SET(pObject->Priority_Active_Bits, priority);
                 if (binary_value == BINARY_ACTIVE) {
-                    BIT_SET(pObject->Priority_Array, priority);
+                    BIT_SET(pObject->Priority_Array, priority - 1);
                 } else {
-                    BIT_CLEAR(pObject->Priority_Array, priority);
+                    BIT_CLEAR(pObject->Priority_Array, priority - 1);
+                }
+                if (priority_array_command(
+                        &pObject->Priority_Active, priority)) {
+                    Binary_Output_Present_Value_Update(pObject);
                 }
                 status = true;
             }
@@ -323,9 +340,11 @@ bool Binary_Output_Present_Value_Relinquish(
     if (pObject) {
         if (priority && (priority <= BACNET_MAX_PRIORITY) &&
             (priority != 6 /* reserved */)) {
-            priority--;
-            BIT_CLEAR(pObject->Priority_Active_Bits, priority);
-            BIT_CLEAR(pObject->Priority_Array, priority);
+            BIT_CLEAR(pObject->Priority_Array, priority - 1);
+            if (priority_array_relinquish(
+                    &pObject->Priority_Active, priority)) {
+                Binary_Output_Present_Value_Update(pObject);
+            }
             status = true;
         }
     }
@@ -660,6 +679,10 @@ bool Binary_Output_Relinquish_Default_Set(
             pObject->Relinquish_Default = false;
             status = true;
         }
+        if (status &&
+            (priority_array_active(&pObject->Priority_Active) == 0)) {
+            Binary_Output_Present_Value_Update(pObject);
+        }
     }
 
     return status;
@@ -1182,11 +1205,12 @@ bool Binary_Output_Create(uint32_t object_instance)
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Mempool_Alloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
             pObject->Present_Value = false;
+            priority_array_init(&pObject->Priority_Active);
             pObject->Out_Of_Service = false;
             pObject->Active_Text = Default_Active_Text;
             pObject->Inactive_Text = Default_Inactive_Text;
@@ -1196,6 +1220,8 @@ bool Binary_Output_Create(uint32_t object_instance)
             if (index >= 0) {
                 status = true;
                 Device_Inc_Database_Revision();
+            } else {
+                Mempool_Free(&Object_Pool, pObject);
             }
         }
     }
@@ -1214,13 +1240,14 @@ void Binary_Output_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                Mempool_Free(&Object_Pool, pObject);
                 Device_Inc_Database_Revision();
             }
         } while (pObject);
         Keylist_Delete(Object_List);
         Object_List = NULL;
     }
+    Mempool_Cleanup(&Object_Pool);
 }
 
 /**
@@ -1233,7 +1260,7 @@ bool Binary_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Mempool_Free(&Object_Pool, pObject);
         status = true;
         Device_Inc_Database_Revision();
     }
@@ -1241,10 +1268,71 @@ bool Binary_Output_Delete(uint32_t object_instance)
     return status;
 }
 
+/**
+ * @brief Get the number of objects for a warm start snapshot
+ * @return number of objects
+ */
+uint32_t Binary_Output_Snapshot_Count(void)
+{
+    return (uint32_t)Keylist_Count(Object_List);
+}
+
+/**
+ * @brief Encode the priority-array of a commanded object as a warm start
+ *  snapshot record: instance, slots in use, and the slot values
+ * @param index - object 0..Binary_Output_Snapshot_Count()-1
+ * @param record - [out] BINARY_OUTPUT_SNAPSHOT_RECORD_SIZE bytes
+ * @return true if the object was encoded
+ */
+bool Binary_Output_Snapshot_Encode(uint32_t index, uint8_t *record)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data_Index(Object_List, index);
+    if (!record || !pObject || !pObject->Priority_Active.active_bits) {
+        return false;
+    }
+    encode_unsigned32(&record[0], Keylist_Key(Object_List, index));
+    encode_unsigned16(&record[4], pObject->Priority_Active.active_bits);
+    encode_unsigned16(&record[6], pObject->Priority_Array);
+
+    return true;
+}
+
+/**
+ * @brief Restore the priority-array of an object that exists from a warm
+ *  start snapshot record, and update its Present_Value
+ * @param index - record 0..N-1 of the snapshot
+ * @param record - BINARY_OUTPUT_SNAPSHOT_RECORD_SIZE bytes
+ * @return true if the record was restored
+ */
+bool Binary_Output_Snapshot_Restore(uint32_t index, uint8_t *record)
+{
+    struct object_data *pObject;
+    uint32_t object_instance = 0;
+
+    (void)index;
+    if (!record) {
+        return false;
+    }
+    decode_unsigned32(&record[0], &object_instance);
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return false;
+    }
+    decode_unsigned16(&record[4], &pObject->Priority_Active.active_bits);
+    decode_unsigned16(&record[6], &pObject->Priority_Array);
+    Binary_Output_Present_Value_Update(pObject);
+
+    return true;
+}
+
 /**
  * Initializes the Binary Input object data
  */
 void Binary_Output_Init(void)
 {
     Object_List = Keylist_Create();
+    Mempool_Init(&Object_Pool, sizeof(struct object_data),
+        BINARY_OUTPUT_POOL_SLAB_SIZE);
 }
@@ -44,6 +44,11 @@
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 
+/* warm start snapshot record of a priority-array: instance, slots in use,
+   and the slot values - see snapshot.h */
+#define BINARY_OUTPUT_SNAPSHOT_VERSION 1
+#define BINARY_OUTPUT_SNAPSHOT_RECORD_SIZE 8
+
 /**
  * @brief Callback for gateway write present value request
  * @param  object_instance - object-instance number of the object
@@ -234,6 +239,17 @@ extern "C" {
     bool Binary_Output_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    uint32_t Binary_Output_Snapshot_Count(
+        void);
+    BACNET_STACK_EXPORT
+    bool Binary_Output_Snapshot_Encode(
+        uint32_t index,
+        uint8_t *record);
+    BACNET_STACK_EXPORT
+    bool Binary_Output_Snapshot_Restore(
+        uint32_t index,
+        uint8_t *record);
+    BACNET_STACK_EXPORT
     void Binary_Output_Cleanup(
         void);
 
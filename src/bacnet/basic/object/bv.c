@@ -37,6 +37,7 @@
 #include "bacnet/rp.h"
 #include "bacnet/basic/object/bv.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/priority_array.h"
 
 #ifndef MAX_BINARY_VALUES
 #define MAX_BINARY_VALUES 10
@@ -48,6 +49,10 @@
 /* Here is our Priority Array.*/
 static BACNET_BINARY_PV Binary_Value_Level[MAX_BINARY_VALUES]
                                           [BACNET_MAX_PRIORITY];
+/* the commanded slots of the Priority Array */
+static BACNET_PRIORITY_ARRAY Priority_Active[MAX_BINARY_VALUES];
+/* the effective value of the Priority Array */
+static BACNET_BINARY_PV Present_Value[MAX_BINARY_VALUES];
 /* Writable out-of-service allows others to play with our Present Value */
 /* without changing the physical output */
 static bool Out_Of_Service[MAX_BINARY_VALUES];
@@ -102,6 +107,8 @@ void Binary_Value_Init(void)
             for (j = 0; j < BACNET_MAX_PRIORITY; j++) {
                 Binary_Value_Level[i][j] = BINARY_NULL;
             }
+            priority_array_init(&Priority_Active[i]);
+            Present_Value[i] = RELINQUISH_DEFAULT;
         }
     }
 
@@ -181,21 +188,32 @@ BACNET_BINARY_PV Binary_Value_Present_Value(uint32_t object_instance)
 {
     BACNET_BINARY_PV value = RELINQUISH_DEFAULT;
     unsigned index = 0;
-    unsigned i = 0;
 
     index = Binary_Value_Instance_To_Index(object_instance);
     if (index < MAX_BINARY_VALUES) {
-        for (i = 0; i < BACNET_MAX_PRIORITY; i++) {
-            if (Binary_Value_Level[index][i] != BINARY_NULL) {
-                value = Binary_Value_Level[index][i];
-                break;
-            }
-        }
+        value = Present_Value[index];
     }
 
     return value;
 }
 
+/**
+ * @brief Update the effective value of the priority-array after the active
+ *  priority, or the value at the active priority, has changed
+ * @param  index - object index 0..MAX_BINARY_VALUES-1
+ */
+static void Binary_Value_Present_Value_Update(unsigned index)
+{
+    unsigned priority;
+
+    priority = priority_array_active(&Priority_Active[index]);
+    if (priority) {
+        Present_Value[index] = Binary_Value_Level[index][priority - 1];
+    } else {
+        Present_Value[index] = RELINQUISH_DEFAULT;
+    }
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -215,11 +233,11 @@ static int Binary_Value_Priority_Array_Encode(
 
     index = Binary_Value_Instance_To_Index(object_instance);
     if ((index < MAX_BINARY_VALUES) && (priority < BACNET_MAX_PRIORITY)) {
-        if (Binary_Value_Level[index][priority] != BINARY_NULL) {
-            apdu_len = encode_application_null(apdu);
-        } else {
+        if (priority_array_commanded(&Priority_Active[index], priority + 1)) {
             value = Binary_Value_Level[index][priority];
             apdu_len = encode_application_enumerated(apdu, value);
+        } else {
+            apdu_len = encode_application_null(apdu);
         }
     }
 
@@ -464,8 +482,11 @@ bool Binary_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     (priority != 6 /* reserved */) &&
                     (value.type.Enumerated <= MAX_BINARY_PV)) {
                     level = (BACNET_BINARY_PV)value.type.Enumerated;
-                    priority--;
-                    Binary_Value_Level[object_index][priority] = level;
+                    Binary_Value_Level[object_index][priority - 1] = level;
+                    if (priority_array_command(
+                            &Priority_Active[object_index], priority)) {
+                        Binary_Value_Present_Value_Update(object_index);
+                    }
                     /* Note: you could set the physical output here if we
                        are the highest priority.
                        However, if Out of Service is TRUE, then don't set the
@@ -490,8 +511,11 @@ bool Binary_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     level = BINARY_NULL;
                     priority = wp_data->priority;
                     if (priority && (priority <= BACNET_MAX_PRIORITY)) {
-                        priority--;
-                        Binary_Value_Level[object_index][priority] = level;
+                        Binary_Value_Level[object_index][priority - 1] = level;
+                        if (priority_array_relinquish(
+                                &Priority_Active[object_index], priority)) {
+                            Binary_Value_Present_Value_Update(object_index);
+                        }
                         /* Note: you could set the physical output here to the
                            next highest priority, or to the relinquish default
                            if no priorities are set. However, if Out of Service
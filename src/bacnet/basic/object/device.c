@@ -37,6 +37,7 @@
 #include "bacnet/datetime.h"
 #include "bacnet/apdu.h"
 #include "bacnet/wp.h" /* WriteProperty handling */
+#include "bacnet/wpm.h" /* WritePropertyMultiple decoding */
 #include "bacnet/rp.h" /* ReadProperty handling */
 #include "bacnet/dcc.h" /* DeviceCommunicationControl handling */
 #include "bacnet/version.h"
@@ -87,8 +88,21 @@ extern int Routed_Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata);
 extern bool Routed_Device_Write_Property_Local(
     BACNET_WRITE_PROPERTY_DATA *wp_data);
 
-/* may be overridden by outside table */
-static object_functions_t *Object_Table;
+struct device_context {
+    /* may be overridden by outside table */
+    object_functions_t *Object_Table;
+    uint32_t Object_Instance_Number;
+    BACNET_CHARACTER_STRING My_Object_Name;
+    BACNET_DEVICE_STATUS System_Status;
+    uint32_t Database_Revision;
+    /* revision increments are held while objects are created in bulk */
+    bool Database_Revision_Deferred;
+    bool Database_Revision_Changed;
+};
+static struct device_context Device_Default = { NULL, 260001, { 0 },
+    STATUS_OPERATIONAL, 0, false, false };
+/* the Device object of the selected stack context */
+static struct device_context *Device = &Device_Default;
 
 static object_functions_t My_Object_Table[] = {
     { OBJECT_DEVICE, NULL /* Init - don't init Device or it will recourse! */,
@@ -98,7 +112,8 @@ static object_functions_t My_Object_Table[] = {
         Device_Property_Lists, DeviceGetRRInfo, NULL /* Iterator */,
         NULL /* Value_Lists */, NULL /* COV */, NULL /* COV Clear */,
         NULL /* Intrinsic Reporting */, NULL /* Add_List_Element */,
-        NULL /* Remove_List_Element */ },
+        NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
 #if (BACNET_PROTOCOL_REVISION >= 17)
     { OBJECT_NETWORK_PORT, Network_Port_Init, Network_Port_Count,
         Network_Port_Index_To_Instance, Network_Port_Valid_Instance,
@@ -106,7 +121,8 @@ static object_functions_t My_Object_Table[] = {
         Network_Port_Write_Property, Network_Port_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
 #endif
     { OBJECT_ANALOG_INPUT, Analog_Input_Init, Analog_Input_Count,
         Analog_Input_Index_To_Instance, Analog_Input_Valid_Instance,
@@ -115,14 +131,16 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */,
         Analog_Input_Encode_Value_List, Analog_Input_Change_Of_Value,
         Analog_Input_Change_Of_Value_Clear, Analog_Input_Intrinsic_Reporting,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        Analog_Input_Create, Analog_Input_Delete },
     { OBJECT_ANALOG_OUTPUT, Analog_Output_Init, Analog_Output_Count,
         Analog_Output_Index_To_Instance, Analog_Output_Valid_Instance,
         Analog_Output_Object_Name, Analog_Output_Read_Property,
         Analog_Output_Write_Property, Analog_Output_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        Analog_Output_Create, Analog_Output_Delete },
     { OBJECT_ANALOG_VALUE, Analog_Value_Init, Analog_Value_Count,
         Analog_Value_Index_To_Instance, Analog_Value_Valid_Instance,
         Analog_Value_Object_Name, Analog_Value_Read_Property,
@@ -130,7 +148,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */,
         Analog_Value_Encode_Value_List, Analog_Value_Change_Of_Value,
         Analog_Value_Change_Of_Value_Clear, Analog_Value_Intrinsic_Reporting,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        Analog_Value_Create, Analog_Value_Delete },
     { OBJECT_BINARY_INPUT, Binary_Input_Init, Binary_Input_Count,
         Binary_Input_Index_To_Instance, Binary_Input_Valid_Instance,
         Binary_Input_Object_Name, Binary_Input_Read_Property,
@@ -138,21 +157,24 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */,
         Binary_Input_Encode_Value_List, Binary_Input_Change_Of_Value,
         Binary_Input_Change_Of_Value_Clear, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        Binary_Input_Create, Binary_Input_Delete },
     { OBJECT_BINARY_OUTPUT, Binary_Output_Init, Binary_Output_Count,
         Binary_Output_Index_To_Instance, Binary_Output_Valid_Instance,
         Binary_Output_Object_Name, Binary_Output_Read_Property,
         Binary_Output_Write_Property, Binary_Output_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        Binary_Output_Create, Binary_Output_Delete },
     { OBJECT_BINARY_VALUE, Binary_Value_Init, Binary_Value_Count,
         Binary_Value_Index_To_Instance, Binary_Value_Valid_Instance,
         Binary_Value_Object_Name, Binary_Value_Read_Property,
         Binary_Value_Write_Property, Binary_Value_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_CHARACTERSTRING_VALUE, CharacterString_Value_Init,
         CharacterString_Value_Count, CharacterString_Value_Index_To_Instance,
         CharacterString_Value_Valid_Instance, CharacterString_Value_Object_Name,
@@ -163,20 +185,23 @@ static object_functions_t My_Object_Table[] = {
         CharacterString_Value_Change_Of_Value,
         CharacterString_Value_Change_Of_Value_Clear,
         NULL /* Intrinsic Reporting */, NULL /* Add_List_Element */,
-        NULL /* Remove_List_Element */ },
+        NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_COMMAND, Command_Init, Command_Count, Command_Index_To_Instance,
         Command_Valid_Instance, Command_Object_Name, Command_Read_Property,
         Command_Write_Property, Command_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_INTEGER_VALUE, Integer_Value_Init, Integer_Value_Count,
         Integer_Value_Index_To_Instance, Integer_Value_Valid_Instance,
         Integer_Value_Object_Name, Integer_Value_Read_Property,
         Integer_Value_Write_Property, Integer_Value_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
 #if defined(INTRINSIC_REPORTING)
     { OBJECT_NOTIFICATION_CLASS, Notification_Class_Init,
         Notification_Class_Count, Notification_Class_Index_To_Instance,
@@ -186,7 +211,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         Notification_Class_Add_List_Element,
-        Notification_Class_Remove_List_Element },
+        Notification_Class_Remove_List_Element,
+        NULL /* Create */, NULL /* Delete */ },
 #endif
     { OBJECT_LIFE_SAFETY_POINT, Life_Safety_Point_Init, Life_Safety_Point_Count,
         Life_Safety_Point_Index_To_Instance, Life_Safety_Point_Valid_Instance,
@@ -194,21 +220,24 @@ static object_functions_t My_Object_Table[] = {
         Life_Safety_Point_Write_Property, Life_Safety_Point_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_LOAD_CONTROL, Load_Control_Init, Load_Control_Count,
         Load_Control_Index_To_Instance, Load_Control_Valid_Instance,
         Load_Control_Object_Name, Load_Control_Read_Property,
         Load_Control_Write_Property, Load_Control_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_MULTI_STATE_INPUT, Multistate_Input_Init, Multistate_Input_Count,
         Multistate_Input_Index_To_Instance, Multistate_Input_Valid_Instance,
         Multistate_Input_Object_Name, Multistate_Input_Read_Property,
         Multistate_Input_Write_Property, Multistate_Input_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_MULTI_STATE_OUTPUT, Multistate_Output_Init,
         Multistate_Output_Count, Multistate_Output_Index_To_Instance,
         Multistate_Output_Valid_Instance, Multistate_Output_Object_Name,
@@ -216,7 +245,8 @@ static object_functions_t My_Object_Table[] = {
         Multistate_Output_Property_Lists, NULL /* ReadRangeInfo */,
         NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        Multistate_Output_Create, Multistate_Output_Delete },
     { OBJECT_MULTI_STATE_VALUE, Multistate_Value_Init, Multistate_Value_Count,
         Multistate_Value_Index_To_Instance, Multistate_Value_Valid_Instance,
         Multistate_Value_Object_Name, Multistate_Value_Read_Property,
@@ -224,14 +254,16 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */,
         Multistate_Value_Encode_Value_List, Multistate_Value_Change_Of_Value,
         Multistate_Value_Change_Of_Value_Clear, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_TRENDLOG, Trend_Log_Init, Trend_Log_Count,
         Trend_Log_Index_To_Instance, Trend_Log_Valid_Instance,
         Trend_Log_Object_Name, Trend_Log_Read_Property,
         Trend_Log_Write_Property, Trend_Log_Property_Lists, TrendLogGetRRInfo,
         NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        Trend_Log_Create, Trend_Log_Delete },
 #if (BACNET_PROTOCOL_REVISION >= 14)
     { OBJECT_LIGHTING_OUTPUT, Lighting_Output_Init, Lighting_Output_Count,
         Lighting_Output_Index_To_Instance, Lighting_Output_Valid_Instance,
@@ -239,13 +271,15 @@ static object_functions_t My_Object_Table[] = {
         Lighting_Output_Write_Property, Lighting_Output_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_CHANNEL, Channel_Init, Channel_Count, Channel_Index_To_Instance,
         Channel_Valid_Instance, Channel_Object_Name, Channel_Read_Property,
         Channel_Write_Property, Channel_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
 #endif
 #if (BACNET_PROTOCOL_REVISION >= 24)
     { OBJECT_COLOR, Color_Init, Color_Count, Color_Index_To_Instance,
@@ -253,14 +287,16 @@ static object_functions_t My_Object_Table[] = {
         Color_Write_Property, Color_Property_Lists, NULL /* ReadRangeInfo */,
         NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        Color_Create, Color_Delete },
     { OBJECT_COLOR_TEMPERATURE, Color_Temperature_Init, Color_Temperature_Count,
         Color_Temperature_Index_To_Instance, Color_Temperature_Valid_Instance,
         Color_Temperature_Object_Name, Color_Temperature_Read_Property,
         Color_Temperature_Write_Property, Color_Temperature_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        Color_Temperature_Create, Color_Temperature_Delete },
 #endif
 #if defined(BACFILE)
     { OBJECT_FILE, bacfile_init, bacfile_count, bacfile_index_to_instance,
@@ -268,7 +304,8 @@ static object_functions_t My_Object_Table[] = {
         bacfile_write_property, BACfile_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        bacfile_create, bacfile_delete },
 #endif
     { OBJECT_OCTETSTRING_VALUE, OctetString_Value_Init, OctetString_Value_Count,
         OctetString_Value_Index_To_Instance, OctetString_Value_Valid_Instance,
@@ -276,7 +313,8 @@ static object_functions_t My_Object_Table[] = {
         OctetString_Value_Write_Property, OctetString_Value_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_POSITIVE_INTEGER_VALUE, PositiveInteger_Value_Init,
         PositiveInteger_Value_Count, PositiveInteger_Value_Index_To_Instance,
         PositiveInteger_Value_Valid_Instance, PositiveInteger_Value_Object_Name,
@@ -285,30 +323,82 @@ static object_functions_t My_Object_Table[] = {
         PositiveInteger_Value_Property_Lists, NULL /* ReadRangeInfo */,
         NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_SCHEDULE, Schedule_Init, Schedule_Count,
         Schedule_Index_To_Instance, Schedule_Valid_Instance,
         Schedule_Object_Name, Schedule_Read_Property, Schedule_Write_Property,
         Schedule_Property_Lists, NULL /* ReadRangeInfo */, NULL /* Iterator */,
         NULL /* Value_Lists */, NULL /* COV */, NULL /* COV Clear */,
         NULL /* Intrinsic Reporting */, NULL /* Add_List_Element */,
-        NULL /* Remove_List_Element */ },
+        NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { OBJECT_ACCUMULATOR, Accumulator_Init, Accumulator_Count,
         Accumulator_Index_To_Instance, Accumulator_Valid_Instance,
         Accumulator_Object_Name, Accumulator_Read_Property,
         Accumulator_Write_Property, Accumulator_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ },
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ },
     { MAX_BACNET_OBJECT_TYPE, NULL /* Init */, NULL /* Count */,
         NULL /* Index_To_Instance */, NULL /* Valid_Instance */,
         NULL /* Object_Name */, NULL /* Read_Property */,
         NULL /* Write_Property */, NULL /* Property_Lists */,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
-        NULL /* Add_List_Element */, NULL /* Remove_List_Element */ }
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */ }
 };
 
+/* The object type lookup, and the property lists with their counts and
+   member bitmaps, are indexed by object type, which costs about 8K of RAM.
+   Set to 0 for the linear search of the object table on small targets. */
+#ifndef DEVICE_OBJECT_INDEX_ENABLED
+#define DEVICE_OBJECT_INDEX_ENABLED 1
+#endif
+
+#if DEVICE_OBJECT_INDEX_ENABLED
+#ifndef DEVICE_OBJECT_INDEX_MAX
+#define DEVICE_OBJECT_INDEX_MAX 64
+#endif
+/* the object table that is indexed */
+static object_functions_t *Object_Index_Table;
+/* object table position + 1 of each standard object type, or 0 */
+static uint16_t Object_Type_Index[OBJECT_PROPRIETARY_MIN];
+/* property lists of the object types by object table position */
+static struct property_list_index_t
+    Object_Property_Index[DEVICE_OBJECT_INDEX_MAX];
+
+/** Build the object type index of the object table of the selected
+ * Device object, when it is not already indexed.
+ * @ingroup ObjHelpers
+ */
+static void Device_Objects_Index(void)
+{
+    struct object_functions *pObject = NULL;
+    uint16_t position = 0;
+
+    if (Object_Index_Table == Device->Object_Table) {
+        return;
+    }
+    memset(Object_Type_Index, 0, sizeof(Object_Type_Index));
+    memset(Object_Property_Index, 0, sizeof(Object_Property_Index));
+    pObject = Device->Object_Table;
+    while ((pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) &&
+        (position < UINT16_MAX)) {
+        position++;
+        /* the first entry of an object type is found, as in the table */
+        if ((pObject->Object_Type < OBJECT_PROPRIETARY_MIN) &&
+            (Object_Type_Index[pObject->Object_Type] == 0)) {
+            Object_Type_Index[pObject->Object_Type] = position;
+        }
+        pObject++;
+    }
+    Object_Index_Table = Device->Object_Table;
+}
+#endif
+
 /** Glue function to let the Device object, when called by a handler,
  * lookup which Object type needs to be invoked.
  * @ingroup ObjHelpers
@@ -322,7 +412,16 @@ static struct object_functions *Device_Objects_Find_Functions(
 {
     struct object_functions *pObject = NULL;
 
-    pObject = Object_Table;
+#if DEVICE_OBJECT_INDEX_ENABLED
+    Device_Objects_Index();
+    if (Object_Type < OBJECT_PROPRIETARY_MIN) {
+        if (Object_Type_Index[Object_Type] == 0) {
+            return (NULL);
+        }
+        return (&Device->Object_Table[Object_Type_Index[Object_Type] - 1]);
+    }
+#endif
+    pObject = Device->Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         /* handle each object type */
         if (pObject->Object_Type == Object_Type) {
@@ -369,6 +468,9 @@ void Device_Objects_Property_List(BACNET_OBJECT_TYPE object_type,
     struct special_property_list_t *pPropertyList)
 {
     struct object_functions *pObject = NULL;
+#if DEVICE_OBJECT_INDEX_ENABLED
+    struct property_list_index_t *pIndex = NULL;
+#endif
 
     (void)object_instance;
     pPropertyList->Required.pList = NULL;
@@ -385,6 +487,17 @@ void Device_Objects_Property_List(BACNET_OBJECT_TYPE object_type,
         pObject->Object_RPM_List(&pPropertyList->Required.pList,
             &pPropertyList->Optional.pList, &pPropertyList->Proprietary.pList);
     }
+#if DEVICE_OBJECT_INDEX_ENABLED
+    /* the counts of the indexed lists are used until the lists change */
+    if ((pObject != NULL) &&
+        ((pObject - Device->Object_Table) < DEVICE_OBJECT_INDEX_MAX)) {
+        pIndex = &Object_Property_Index[pObject - Device->Object_Table];
+        property_list_index_update(pIndex, pPropertyList->Required.pList,
+            pPropertyList->Optional.pList, pPropertyList->Proprietary.pList);
+        *pPropertyList = pIndex->List;
+        return;
+    }
+#endif
 
     /* Fetch the counts if available otherwise zero them */
     pPropertyList->Required.count = pPropertyList->Required.pList == NULL
@@ -449,9 +562,6 @@ void Device_Property_Lists(
    The properties that are constant can be hard coded
    into the read-property encoding. */
 
-static uint32_t Object_Instance_Number = 260001;
-static BACNET_CHARACTER_STRING My_Object_Name;
-static BACNET_DEVICE_STATUS System_Status = STATUS_OPERATIONAL;
 static char *Vendor_Name = BACNET_VENDOR_NAME;
 static uint16_t Vendor_Identifier = BACNET_VENDOR_ID;
 static char Model_Name[MAX_DEV_MOD_LEN + 1] = "GNU";
@@ -486,7 +596,6 @@ static uint32_t Interval_Offset_Minutes;
 /* Max_Master - rely on MS/TP subsystem, if there is one */
 /* Max_Info_Frames - rely on MS/TP subsystem, if there is one */
 /* Device_Address_Binding - required, but relies on binding cache */
-static uint32_t Database_Revision = 0;
 /* Configuration_Files */
 /* Last_Restore_Time */
 /* Backup_Failure_Timeout */
@@ -568,7 +677,7 @@ unsigned Device_Count(void)
 uint32_t Device_Index_To_Instance(unsigned index)
 {
     (void)index;
-    return Object_Instance_Number;
+    return Device->Object_Instance_Number;
 }
 
 /* methods to manipulate the data */
@@ -584,7 +693,7 @@ uint32_t Device_Object_Instance_Number(void)
 #ifdef BAC_ROUTING
     return Routed_Device_Object_Instance_Number();
 #else
-    return Object_Instance_Number;
+    return Device->Object_Instance_Number;
 #endif
 }
 
@@ -594,7 +703,7 @@ bool Device_Set_Object_Instance_Number(uint32_t object_id)
 
     if (object_id <= BACNET_MAX_INSTANCE) {
         /* Make the change and update the database revision */
-        Object_Instance_Number = object_id;
+        Device->Object_Instance_Number = object_id;
         Device_Inc_Database_Revision();
     } else {
         status = false;
@@ -605,7 +714,7 @@ bool Device_Set_Object_Instance_Number(uint32_t object_id)
 
 bool Device_Valid_Object_Instance_Number(uint32_t object_id)
 {
-    return (Object_Instance_Number == object_id);
+    return (Device->Object_Instance_Number == object_id);
 }
 
 bool Device_Object_Name(
@@ -613,8 +722,8 @@ bool Device_Object_Name(
 {
     bool status = false;
 
-    if (object_instance == Object_Instance_Number) {
-        status = characterstring_copy(object_name, &My_Object_Name);
+    if (object_instance == Device->Object_Instance_Number) {
+        status = characterstring_copy(object_name, &Device->My_Object_Name);
     }
 
     return status;
@@ -624,9 +733,9 @@ bool Device_Set_Object_Name(BACNET_CHARACTER_STRING *object_name)
 {
     bool status = false; /*return value */
 
-    if (!characterstring_same(&My_Object_Name, object_name)) {
+    if (!characterstring_same(&Device->My_Object_Name, object_name)) {
         /* Make the change and update the database revision */
-        status = characterstring_copy(&My_Object_Name, object_name);
+        status = characterstring_copy(&Device->My_Object_Name, object_name);
         Device_Inc_Database_Revision();
     }
 
@@ -635,12 +744,12 @@ bool Device_Set_Object_Name(BACNET_CHARACTER_STRING *object_name)
 
 bool Device_Object_Name_ANSI_Init(const char *value)
 {
-    return characterstring_init_ansi(&My_Object_Name, value);
+    return characterstring_init_ansi(&Device->My_Object_Name, value);
 }
 
 BACNET_DEVICE_STATUS Device_System_Status(void)
 {
-    return System_Status;
+    return Device->System_Status;
 }
 
 int Device_Set_System_Status(BACNET_DEVICE_STATUS status, bool local)
@@ -656,7 +765,7 @@ int Device_Set_System_Status(BACNET_DEVICE_STATUS status, bool local)
             case STATUS_DOWNLOAD_REQUIRED:
             case STATUS_DOWNLOAD_IN_PROGRESS:
             case STATUS_NON_OPERATIONAL:
-                System_Status = status;
+                Device->System_Status = status;
                 break;
 
                 /* Don't support backup at present so don't allow setting */
@@ -678,7 +787,7 @@ int Device_Set_System_Status(BACNET_DEVICE_STATUS status, bool local)
             case STATUS_OPERATIONAL:
             case STATUS_OPERATIONAL_READ_ONLY:
             case STATUS_NON_OPERATIONAL:
-                System_Status = status;
+                Device->System_Status = status;
                 break;
 
                 /* Don't allow outsider set this - it should probably
@@ -820,12 +929,12 @@ BACNET_SEGMENTATION Device_Segmentation_Supported(void)
 
 uint32_t Device_Database_Revision(void)
 {
-    return Database_Revision;
+    return Device->Database_Revision;
 }
 
 void Device_Set_Database_Revision(uint32_t revision)
 {
-    Database_Revision = revision;
+    Device->Database_Revision = revision;
 }
 
 /*
@@ -835,7 +944,30 @@ void Device_Set_Database_Revision(uint32_t revision)
  */
 void Device_Inc_Database_Revision(void)
 {
-    Database_Revision++;
+    if (Device->Database_Revision_Deferred) {
+        Device->Database_Revision_Changed = true;
+    } else {
+        Device->Database_Revision++;
+    }
+}
+
+/**
+ * @brief Defer the Database_Revision increments, so that a bulk change
+ *  of the objects, such as creating thousands of objects at startup,
+ *  increments the Database_Revision once when the deferral ends.
+ * @param defer - true to start deferring, false to end deferring
+ */
+void Device_Database_Revision_Defer(bool defer)
+{
+    if (defer) {
+        Device->Database_Revision_Deferred = true;
+    } else {
+        Device->Database_Revision_Deferred = false;
+        if (Device->Database_Revision_Changed) {
+            Device->Database_Revision_Changed = false;
+            Device->Database_Revision++;
+        }
+    }
 }
 
 /** Get the total count of objects supported by this Device Object.
@@ -849,7 +981,7 @@ unsigned Device_Object_List_Count(void)
     struct object_functions *pObject = NULL;
 
     /* initialize the default return values */
-    pObject = Object_Table;
+    pObject = Device->Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         if (pObject->Object_Count) {
             count += pObject->Object_Count();
@@ -885,7 +1017,7 @@ bool Device_Object_List_Identifier(
     }
     object_index = array_index - 1;
     /* initialize the default return values */
-    pObject = Object_Table;
+    pObject = Device->Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         if (pObject->Object_Count) {
             object_index -= count;
@@ -1163,11 +1295,11 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     switch (rpdata->object_property) {
         case PROP_OBJECT_IDENTIFIER:
             apdu_len = encode_application_object_id(
-                &apdu[0], OBJECT_DEVICE, Object_Instance_Number);
+                &apdu[0], OBJECT_DEVICE, Device->Object_Instance_Number);
             break;
         case PROP_OBJECT_NAME:
-            apdu_len =
-                encode_application_character_string(&apdu[0], &My_Object_Name);
+            apdu_len = encode_application_character_string(
+                &apdu[0], &Device->My_Object_Name);
             break;
         case PROP_OBJECT_TYPE:
             apdu_len = encode_application_enumerated(&apdu[0], OBJECT_DEVICE);
@@ -1178,7 +1310,8 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
                 encode_application_character_string(&apdu[0], &char_string);
             break;
         case PROP_SYSTEM_STATUS:
-            apdu_len = encode_application_enumerated(&apdu[0], System_Status);
+            apdu_len =
+                encode_application_enumerated(&apdu[0], Device->System_Status);
             break;
         case PROP_VENDOR_NAME:
             characterstring_init_ansi(&char_string, Vendor_Name);
@@ -1254,7 +1387,7 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
             }
             /* set the object types with objects to supported */
 
-            pObject = Object_Table;
+            pObject = Device->Object_Table;
             while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
                 if ((pObject->Object_Count) && (pObject->Object_Count() > 0)) {
                     bitstring_set_bit(
@@ -1295,7 +1428,8 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = address_list_encode(&apdu[0], apdu_max);
             break;
         case PROP_DATABASE_REVISION:
-            apdu_len = encode_application_unsigned(&apdu[0], Database_Revision);
+            apdu_len = encode_application_unsigned(
+                &apdu[0], Device->Database_Revision);
             break;
 #if defined(BACDL_MSTP)
         case PROP_MAX_INFO_FRAMES:
@@ -1372,7 +1506,8 @@ static int Read_Property_Common(
     }
     apdu = rpdata->application_data;
     if (property_list_common(rpdata->object_property)) {
-        apdu_len = property_list_common_encode(rpdata, Object_Instance_Number);
+        apdu_len = property_list_common_encode(
+            rpdata, Device->Object_Instance_Number);
     } else if (rpdata->object_property == PROP_OBJECT_NAME) {
         /*  only array properties can have array options */
         if (rpdata->array_index != BACNET_ARRAY_ALL) {
@@ -1528,7 +1663,8 @@ bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
             break;
         case PROP_OBJECT_NAME:
             status = write_property_string_valid(
-                wp_data, &value, characterstring_capacity(&My_Object_Name));
+                wp_data, &value,
+                characterstring_capacity(&Device->My_Object_Name));
             if (status) {
                 /* All the object names in a device must be unique */
                 if (Device_Valid_Object_Name(&value.type.Character_String,
@@ -1819,6 +1955,174 @@ int Device_Remove_List_Element(
     return status;
 }
 
+/**
+ * @brief Write the list of initial values of a CreateObject request
+ *  to the new object
+ * @param data [in,out] CreateObject data with the new object identifier
+ * @return true if all the initial values were written, else the error,
+ *  and the first failed element number, are set in data
+ */
+static bool Device_Create_Object_Initial_Values(
+    BACNET_CREATE_OBJECT_DATA *data)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_UNSIGNED_INTEGER element = 0;
+    int offset = 0;
+    int len = 0;
+
+    wp_data.object_type = data->object_type;
+    wp_data.object_instance = data->object_instance;
+    while (offset < data->application_data_len) {
+        element++;
+        len = wpm_decode_object_property(&data->application_data[offset],
+            (uint16_t)(data->application_data_len - offset), &wp_data);
+        if (len <= 0) {
+            data->error_class = ERROR_CLASS_SERVICES;
+            data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+            data->first_failed_element_number = element;
+            return false;
+        }
+        offset += len;
+        if (!Device_Write_Property(&wp_data)) {
+            data->error_class = wp_data.error_class;
+            data->error_code = wp_data.error_code;
+            data->first_failed_element_number = element;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief CreateObject of a type that supports dynamic creation, with an
+ *  optional list of initial property values
+ * @param data [in,out] Pointer to the CreateObject data, which is packed
+ *  with the information from the request.  An object_instance of
+ *  BACNET_MAX_INSTANCE selects the first unused instance, and the
+ *  instance of the new object is returned.
+ * @return true if the object was created, else the error is set in data
+ */
+bool Device_Create_Object(BACNET_CREATE_OBJECT_DATA *data)
+{
+    struct object_functions *pObject = NULL;
+    uint32_t object_instance = 0;
+
+    data->first_failed_element_number = 0;
+    pObject = Device_Objects_Find_Functions(data->object_type);
+    if (pObject == NULL) {
+        data->error_class = ERROR_CLASS_OBJECT;
+        data->error_code = ERROR_CODE_UNSUPPORTED_OBJECT_TYPE;
+        return false;
+    }
+    if (!pObject->Object_Create || !pObject->Object_Valid_Instance) {
+        data->error_class = ERROR_CLASS_OBJECT;
+        data->error_code = ERROR_CODE_DYNAMIC_CREATION_NOT_SUPPORTED;
+        return false;
+    }
+    if (data->object_instance >= BACNET_MAX_INSTANCE) {
+        while ((object_instance < BACNET_MAX_INSTANCE) &&
+            pObject->Object_Valid_Instance(object_instance)) {
+            object_instance++;
+        }
+        if (object_instance >= BACNET_MAX_INSTANCE) {
+            data->error_class = ERROR_CLASS_RESOURCES;
+            data->error_code = ERROR_CODE_NO_SPACE_FOR_OBJECT;
+            return false;
+        }
+        data->object_instance = object_instance;
+    } else if (pObject->Object_Valid_Instance(data->object_instance)) {
+        data->error_class = ERROR_CLASS_OBJECT;
+        data->error_code = ERROR_CODE_OBJECT_IDENTIFIER_ALREADY_EXISTS;
+        return false;
+    }
+    if (!pObject->Object_Create(data->object_instance)) {
+        data->error_class = ERROR_CLASS_RESOURCES;
+        data->error_code = ERROR_CODE_NO_SPACE_FOR_OBJECT;
+        return false;
+    }
+    if (data->application_data && (data->application_data_len > 0)) {
+        if (!Device_Create_Object_Initial_Values(data)) {
+            /* the object is not created when an initial value fails */
+            if (pObject->Object_Delete) {
+                (void)pObject->Object_Delete(data->object_instance);
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief DeleteObject of a type that supports dynamic deletion
+ * @param data [in,out] Pointer to the DeleteObject data, which is packed
+ *  with the information from the request.
+ * @return true if the object was deleted, else the error is set in data
+ */
+bool Device_Delete_Object(BACNET_DELETE_OBJECT_DATA *data)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Objects_Find_Functions(data->object_type);
+    if ((pObject == NULL) || !pObject->Object_Valid_Instance ||
+        !pObject->Object_Valid_Instance(data->object_instance)) {
+        data->error_class = ERROR_CLASS_OBJECT;
+        data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    if (!pObject->Object_Delete ||
+        !pObject->Object_Delete(data->object_instance)) {
+        data->error_class = ERROR_CLASS_OBJECT;
+        data->error_code = ERROR_CODE_OBJECT_DELETION_NOT_PERMITTED;
+        return false;
+    }
+    /* the subscriptions and events of the object go with it */
+    (void)handler_cov_object_delete(data->object_type, data->object_instance);
+#if defined(INTRINSIC_REPORTING)
+    (void)Event_Index_Update(
+        data->object_type, data->object_instance, 0, false);
+#endif
+
+    return true;
+}
+
+/**
+ * @brief Create objects in bulk, such as the points of a gateway that are
+ *  provisioned from a configuration database at startup.  The
+ *  Database_Revision is incremented once, instead of once per object.
+ *  Creating the instances in ascending order is the fastest.
+ * @param object_type [in] type of the objects, which supports dynamic
+ *  creation
+ * @param first_instance [in] instance number of the first object
+ * @param count [in] number of consecutive instances to create
+ * @return number of objects that were created
+ */
+unsigned Device_Create_Objects(
+    BACNET_OBJECT_TYPE object_type, uint32_t first_instance, unsigned count)
+{
+    struct object_functions *pObject = NULL;
+    unsigned created = 0;
+    unsigned i;
+
+    pObject = Device_Objects_Find_Functions(object_type);
+    if ((pObject == NULL) || !pObject->Object_Create) {
+        return 0;
+    }
+    Device_Database_Revision_Defer(true);
+    for (i = 0; i < count; i++) {
+        if ((first_instance + i) >= BACNET_MAX_INSTANCE) {
+            break;
+        }
+        if (pObject->Object_Create(first_instance + i)) {
+            created++;
+        }
+    }
+    Device_Database_Revision_Defer(false);
+
+    return created;
+}
+
 /** Looks up the requested Object, and fills the Property Value list.
  * If the Object or Property can't be found, returns false.
  * @ingroup ObjHelpers
@@ -1940,6 +2244,56 @@ bool Device_Value_List_Supported(BACNET_OBJECT_TYPE object_type)
     return (status);
 }
 
+/**
+ * @brief Get the size of the Device object of one stack context
+ * @return size of the Device object, in bytes
+ */
+size_t Device_Context_Size(void)
+{
+    return sizeof(struct device_context);
+}
+
+/**
+ * @brief Initialize the Device object of a stack context.  The new
+ *  Device object uses the object table of the selected Device object.
+ * @param context - memory of Device_Context_Size() bytes
+ */
+void Device_Context_Init(void *context)
+{
+    struct device_context *pContext = context;
+
+    if (pContext) {
+        memset(pContext, 0, sizeof(struct device_context));
+        if (Device->Object_Table) {
+            pContext->Object_Table = Device->Object_Table;
+        } else {
+            pContext->Object_Table = &My_Object_Table[0];
+        }
+        pContext->Object_Instance_Number = 260001;
+        characterstring_init_ansi(&pContext->My_Object_Name, "SimpleServer");
+        pContext->System_Status = STATUS_OPERATIONAL;
+    }
+}
+
+/**
+ * @brief Select the Device object used by the Device object functions
+ * @param context - Device object from Device_Context_Init(), or NULL
+ *  to select the default Device object
+ * @return the previously selected Device object, or NULL for the default
+ */
+void *Device_Context_Select(void *context)
+{
+    struct device_context *previous = Device;
+
+    if (context) {
+        Device = context;
+    } else {
+        Device = &Device_Default;
+    }
+
+    return (previous == &Device_Default) ? NULL : previous;
+}
+
 /** Initialize the Device Object.
  Initialize the group of object helper functions for any supported Object.
  Initialize each of the Device Object child Object instances.
@@ -1951,14 +2305,18 @@ bool Device_Value_List_Supported(BACNET_OBJECT_TYPE object_type)
 void Device_Init(object_functions_t *object_table)
 {
     struct object_functions *pObject = NULL;
-    characterstring_init_ansi(&My_Object_Name, "SimpleServer");
+    characterstring_init_ansi(&Device->My_Object_Name, "SimpleServer");
     datetime_init();
     if (object_table) {
-        Object_Table = object_table;
+        Device->Object_Table = object_table;
     } else {
-        Object_Table = &My_Object_Table[0];
+        Device->Object_Table = &My_Object_Table[0];
     }
-    pObject = Object_Table;
+#if DEVICE_OBJECT_INDEX_ENABLED
+    /* the table may have been changed in place */
+    Object_Index_Table = NULL;
+#endif
+    pObject = Device->Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         if (pObject->Object_Init) {
             pObject->Object_Init();
@@ -2038,10 +2396,11 @@ void Routing_Device_Init(uint32_t first_object_instance)
     struct object_functions *pDevObject = NULL;
 
     /* Initialize with our preset strings */
-    Add_Routed_Device(first_object_instance, &My_Object_Name, Description);
+    Add_Routed_Device(
+        first_object_instance, &Device->My_Object_Name, Description);
 
     /* Now substitute our routed versions of the main object functions. */
-    pDevObject = Object_Table;
+    pDevObject = Device->Object_Table;
     pDevObject->Object_Index_To_Instance = Routed_Device_Index_To_Instance;
     pDevObject->Object_Valid_Instance =
         Routed_Device_Valid_Object_Instance_Number;
@@ -29,11 +29,14 @@
 #ifndef DEVICE_H
 #define DEVICE_H
 
+#include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include "bacnet/bacnet_stack_exports.h"
 #include "bacnet/bacdef.h"
 #include "bacnet/bacenum.h"
+#include "bacnet/create_object.h"
+#include "bacnet/delete_object.h"
 #include "bacnet/list_element.h"
 #include "bacnet/wp.h"
 #include "bacnet/rd.h"
@@ -168,6 +171,8 @@ typedef struct object_functions {
     object_intrinsic_reporting_function Object_Intrinsic_Reporting;
     list_element_function Object_Add_List_Element;
     list_element_function Object_Remove_List_Element;
+    create_object_function Object_Create;
+    delete_object_function Object_Delete;
 } object_functions_t;
 
 /* String Lengths - excluding any nul terminator */
@@ -229,6 +234,17 @@ extern "C" {
     void Device_Init(
         object_functions_t * object_table);
 
+    /* Device object of one stack context - see stack_context.h */
+    BACNET_STACK_EXPORT
+    size_t Device_Context_Size(
+        void);
+    BACNET_STACK_EXPORT
+    void Device_Context_Init(
+        void *context);
+    BACNET_STACK_EXPORT
+    void *Device_Context_Select(
+        void *context);
+
     BACNET_STACK_EXPORT
     bool Device_Reinitialize(
         BACNET_REINITIALIZE_DEVICE_DATA * rd_data);
@@ -416,6 +432,9 @@ extern "C" {
     BACNET_STACK_EXPORT
     void Device_Inc_Database_Revision(
         void);
+    BACNET_STACK_EXPORT
+    void Device_Database_Revision_Defer(
+        bool defer);
 
     BACNET_STACK_EXPORT
     bool Device_Valid_Object_Name(
@@ -442,6 +461,18 @@ extern "C" {
     int Device_Remove_List_Element(
         BACNET_LIST_ELEMENT_DATA *list_element);
 
+    BACNET_STACK_EXPORT
+    bool Device_Create_Object(
+        BACNET_CREATE_OBJECT_DATA *data);
+    BACNET_STACK_EXPORT
+    bool Device_Delete_Object(
+        BACNET_DELETE_OBJECT_DATA *data);
+    BACNET_STACK_EXPORT
+    unsigned Device_Create_Objects(
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t first_instance,
+        unsigned count);
+
     BACNET_STACK_EXPORT
     bool DeviceGetRRInfo(
         BACNET_READ_RANGE_DATA * pRequest,      /* Info on the request */
@@ -40,6 +40,7 @@
 #include "bacnet/lighting.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/proplist.h"
+#include "bacnet/basic/sys/priority_array.h"
 /* me! */
 #include "bacnet/basic/object/lo.h"
 
@@ -63,7 +64,7 @@ struct lighting_output_object {
     BACNET_LIGHTING_TRANSITION Transition;
     float Feedback_Value;
     float Priority_Array[BACNET_MAX_PRIORITY];
-    uint16_t Priority_Active_Bits;
+    BACNET_PRIORITY_ARRAY Priority_Active;
     float Relinquish_Default;
     float Power;
     float Instantaneous_Power;
@@ -199,50 +200,62 @@ float Lighting_Output_Present_Value(uint32_t object_instance)
 {
     float value = 0.0;
     unsigned index = 0;
-    unsigned p = 0;
 
     index = Lighting_Output_Instance_To_Index(object_instance);
     if (index < MAX_LIGHTING_OUTPUTS) {
-        value = Lighting_Output[index].Relinquish_Default;
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (BIT_CHECK(Lighting_Output[index].Priority_Active_Bits, p)) {
-                value = Lighting_Output[index].Priority_Array[p];
-                break;
-            }
-        }
+        value = Lighting_Output[index].Present_Value;
     }
 
     return value;
 }
 
 /**
- * @brief Encode a BACnetARRAY property element
- * @param object_instance [in] BACnet network port object instance number
- * @param priority [in] array index requested:
- *    0 to N for individual array members
+ * For a given object index, updates the cached present-value from the
+ * highest active priority, or the relinquish-default.
+ *
+ * @param  index - object index 0..MAX_LIGHTING_OUTPUTS-1
+ */
+static void Lighting_Output_Present_Value_Update(unsigned index)
+{
+    unsigned priority = 0;
+
+    priority = priority_array_active(&Lighting_Output[index].Priority_Active);
+    if (priority) {
+        Lighting_Output[index].Present_Value =
+            Lighting_Output[index].Priority_Array[priority - 1];
+    } else {
+        Lighting_Output[index].Present_Value =
+            Lighting_Output[index].Relinquish_Default;
+    }
+}
+
+/**
+ * @brief Encode the Priority_Array property, or one of its elements
+ * @param object_instance [in] BACnet object instance number
+ * @param array_index [in] array index requested:
+ *    0 for the array size, 1 to 16 for one element,
+ *    or BACNET_ARRAY_ALL for the entire array
  * @param apdu [out] Buffer in which the APDU contents are built, or NULL to
  * return the length of buffer if it had been built
+ * @param apdu_size [in] size of the apdu buffer
  * @return The length of the apdu encoded or
  *   BACNET_STATUS_ERROR for ERROR_CODE_INVALID_ARRAY_INDEX
+ *   BACNET_STATUS_ABORT for abort message.
  */
-static int Lighting_Output_Priority_Array_Encode(
-    uint32_t object_instance, BACNET_ARRAY_INDEX priority, uint8_t *apdu)
+static int Lighting_Output_Priority_Array_Encode(uint32_t object_instance,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *apdu,
+    int apdu_size)
 {
-    int apdu_len = BACNET_STATUS_ERROR;
-    float real_value = 0.0;
     unsigned index = 0;
 
     index = Lighting_Output_Instance_To_Index(object_instance);
-    if ((index < MAX_LIGHTING_OUTPUTS) && (priority < BACNET_MAX_PRIORITY)) {
-        if (BIT_CHECK(Lighting_Output[index].Priority_Active_Bits, priority)) {
-            real_value = Lighting_Output[index].Priority_Array[priority];
-            apdu_len = encode_application_real(apdu, real_value);
-        } else {
-            apdu_len = encode_application_null(apdu);
-        }
+    if (index >= MAX_LIGHTING_OUTPUTS) {
+        return BACNET_STATUS_ERROR;
     }
 
-    return apdu_len;
+    return priority_array_real_encode(&Lighting_Output[index].Priority_Active,
+        Lighting_Output[index].Priority_Array, array_index, apdu, apdu_size);
 }
 
 /**
@@ -255,17 +268,12 @@ static int Lighting_Output_Priority_Array_Encode(
 unsigned Lighting_Output_Present_Value_Priority(uint32_t object_instance)
 {
     unsigned index = 0; /* instance to index conversion */
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
 
     index = Lighting_Output_Instance_To_Index(object_instance);
     if (index < MAX_LIGHTING_OUTPUTS) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (BIT_CHECK(Lighting_Output[index].Priority_Active_Bits, p)) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority =
+            priority_array_active(&Lighting_Output[index].Priority_Active);
     }
 
     return priority;
@@ -291,9 +299,11 @@ bool Lighting_Output_Present_Value_Set(
     if (index < MAX_LIGHTING_OUTPUTS) {
         if (priority && (priority <= BACNET_MAX_PRIORITY) &&
             (priority != 6 /* reserved */)) {
-            priority--;
-            BIT_SET(Lighting_Output[index].Priority_Active_Bits, priority);
-            Lighting_Output[index].Priority_Array[priority] = value;
+            Lighting_Output[index].Priority_Array[priority - 1] = value;
+            if (priority_array_command(
+                    &Lighting_Output[index].Priority_Active, priority)) {
+                Lighting_Output_Present_Value_Update(index);
+            }
             status = true;
         }
     }
@@ -320,9 +330,11 @@ bool Lighting_Output_Present_Value_Relinquish(
     if (index < MAX_LIGHTING_OUTPUTS) {
         if (priority && (priority <= BACNET_MAX_PRIORITY) &&
             (priority != 6 /* reserved */)) {
-            priority--;
-            BIT_CLEAR(Lighting_Output[index].Priority_Active_Bits, priority);
-            Lighting_Output[index].Priority_Array[priority] = 0.0;
+            Lighting_Output[index].Priority_Array[priority - 1] = 0.0;
+            if (priority_array_relinquish(
+                    &Lighting_Output[index].Priority_Active, priority)) {
+                Lighting_Output_Present_Value_Update(index);
+            }
             status = true;
         }
     }
@@ -866,6 +878,9 @@ bool Lighting_Output_Relinquish_Default_Set(
     index = Lighting_Output_Instance_To_Index(object_instance);
     if (index < MAX_LIGHTING_OUTPUTS) {
         Lighting_Output[index].Relinquish_Default = value;
+        if (!priority_array_active(&Lighting_Output[index].Priority_Active)) {
+            Lighting_Output_Present_Value_Update(index);
+        }
     }
 
     return status;
@@ -975,9 +990,8 @@ int Lighting_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = encode_application_real(&apdu[0], real_value);
             break;
         case PROP_PRIORITY_ARRAY:
-            apdu_len = bacnet_array_encode(rpdata->object_instance,
-                rpdata->array_index, Lighting_Output_Priority_Array_Encode,
-                BACNET_MAX_PRIORITY, apdu, apdu_size);
+            apdu_len = Lighting_Output_Priority_Array_Encode(
+                rpdata->object_instance, rpdata->array_index, apdu, apdu_size);
             if (apdu_len == BACNET_STATUS_ABORT) {
                 rpdata->error_code =
                     ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
@@ -1278,8 +1292,8 @@ void Lighting_Output_Init(void)
         Lighting_Output[i].Feedback_Value = 0.0;
         for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
             Lighting_Output[i].Priority_Array[p] = 0.0;
-            BIT_CLEAR(Lighting_Output[i].Priority_Active_Bits, p);
         }
+        priority_array_init(&Lighting_Output[i].Priority_Active);
         Lighting_Output[i].Relinquish_Default = 0.0;
         Lighting_Output[i].Power = 0.0;
         Lighting_Output[i].Instantaneous_Power = 0.0;
@@ -52,15 +52,19 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/mempool.h"
+#include "bacnet/basic/sys/priority_array.h"
 /* me! */
 #include "mso.h"
 
 struct object_data {
     bool Out_Of_Service : 1;
     bool Changed : 1;
-    bool Relinquished[BACNET_MAX_PRIORITY];
+    BACNET_PRIORITY_ARRAY Priority_Active;
     uint8_t Priority_Array[BACNET_MAX_PRIORITY];
     uint8_t Relinquish_Default;
+    /* the effective value of the priority-array */
+    uint8_t Present_Value;
     uint8_t Reliability;
     const char *Object_Name;
     /* The state text functions expect a list of C strings separated by '\0' */
@@ -69,6 +73,12 @@ struct object_data {
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* number of objects allocated from the heap at a time */
+#ifndef MULTISTATE_OUTPUT_POOL_SLAB_SIZE
+#define MULTISTATE_OUTPUT_POOL_SLAB_SIZE 64
+#endif
+/* storage for the object data */
+static MEMPOOL Object_Pool;
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_MULTI_STATE_OUTPUT;
 /* callback for present value writes */
@@ -242,21 +252,37 @@ static uint32_t Multistate_Output_Max_States(uint32_t object_instance)
 static uint32_t Object_Present_Value(struct object_data *pObject)
 {
     uint32_t value = 1;
-    uint8_t priority = 0; /* loop counter */
 
     if (pObject) {
-        value = pObject->Relinquish_Default;
-        for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-            if (!pObject->Relinquished[priority]) {
-                value = pObject->Priority_Array[priority];
-                break;
-            }
-        }
+        value = pObject->Present_Value;
     }
 
     return value;
 }
 
+/**
+ * @brief Update the effective value of the priority-array after the active
+ *  priority, or the value at the active priority, has changed, and flag
+ *  the change for COV
+ * @param  pObject - specific object with valid data
+ */
+static void Object_Present_Value_Update(struct object_data *pObject)
+{
+    unsigned priority;
+    uint8_t value;
+
+    priority = priority_array_active(&pObject->Priority_Active);
+    if (priority) {
+        value = pObject->Priority_Array[priority - 1];
+    } else {
+        value = pObject->Relinquish_Default;
+    }
+    if (pObject->Present_Value != value) {
+        pObject->Present_Value = value;
+        pObject->Changed = true;
+    }
+}
+
 /**
  * @brief For a given object instance-number, determines the present-value
  * @param  object_instance - object-instance number of the object
@@ -292,11 +318,12 @@ static int Multistate_Output_Priority_Array_Encode(
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && (priority < BACNET_MAX_PRIORITY)) {
-        if (pObject->Relinquished[priority]) {
-            apdu_len = encode_application_null(apdu);
-        } else {
+        if (priority_array_commanded(
+                &pObject->Priority_Active, priority + 1)) {
             value = pObject->Priority_Array[priority];
             apdu_len = encode_application_enumerated(apdu, value);
+        } else {
+            apdu_len = encode_application_null(apdu);
         }
     }
 
@@ -310,18 +337,12 @@ static int Multistate_Output_Priority_Array_Encode(
  */
 unsigned Multistate_Output_Present_Value_Priority(uint32_t object_instance)
 {
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (!pObject->Relinquished[p]) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority = priority_array_active(&pObject->Priority_Active);
     }
 
     return priority;
@@ -361,6 +382,9 @@ bool Multistate_Output_Relinquish_Default_Set(uint32_t object_instance,
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Relinquish_Default = value;
+        if (priority_array_active(&pObject->Priority_Active) == 0) {
+            Object_Present_Value_Update(pObject);
+        }
         status = true;
     }
 
@@ -378,8 +402,6 @@ bool Multistate_Output_Present_Value_Set(
     uint32_t object_instance, uint32_t value, unsigned priority)
 {
     bool status = false;
-    uint32_t old_value = 0;
-    uint32_t new_value = 0;
     struct object_data *pObject;
     unsigned max_states = 0;
 
@@ -388,12 +410,9 @@ bool Multistate_Output_Present_Value_Set(
         max_states = state_name_count(pObject->State_Text);
         if ((value >= 1) && (value <= max_states) &&
             (priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
-            old_value = Object_Present_Value(pObject);
-            pObject->Relinquished[priority - 1] = false;
             pObject->Priority_Array[priority - 1] = value;
-            new_value = Object_Present_Value(pObject);
-            if (old_value != new_value) {
-                pObject->Changed = true;
+            if (priority_array_command(&pObject->Priority_Active, priority)) {
+                Object_Present_Value_Update(pObject);
             }
             status = true;
         }
@@ -412,19 +431,15 @@ bool Multistate_Output_Present_Value_Relinquish(
     uint32_t object_instance, unsigned priority)
 {
     bool status = false;
-    uint32_t old_value = 0;
-    uint32_t new_value = 0;
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
-            old_value = Object_Present_Value(pObject);
-            pObject->Relinquished[priority - 1] = true;
             pObject->Priority_Array[priority - 1] = 0;
-            new_value = Object_Present_Value(pObject);
-            if (old_value != new_value) {
-                pObject->Changed = true;
+            if (priority_array_relinquish(
+                    &pObject->Priority_Active, priority)) {
+                Object_Present_Value_Update(pObject);
             }
             status = true;
         }
@@ -1163,23 +1178,26 @@ bool Multistate_Output_Create(uint32_t object_instance)
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Mempool_Alloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->State_Text = Default_State_Text;
             pObject->Out_Of_Service = false;
             pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
             pObject->Changed = false;
+            priority_array_init(&pObject->Priority_Active);
             for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-                pObject->Relinquished[priority] = true;
                 pObject->Priority_Array[priority] = 0;
             }
             pObject->Relinquish_Default = 1;
+            pObject->Present_Value = 1;
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index >= 0) {
                 status = true;
                 Device_Inc_Database_Revision();
+            } else {
+                Mempool_Free(&Object_Pool, pObject);
             }
         }
     }
@@ -1199,7 +1217,7 @@ bool Multistate_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Mempool_Free(&Object_Pool, pObject);
         status = true;
         Device_Inc_Database_Revision();
     }
@@ -1218,13 +1236,14 @@ void Multistate_Output_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                Mempool_Free(&Object_Pool, pObject);
                 Device_Inc_Database_Revision();
             }
         } while (pObject);
         Keylist_Delete(Object_List);
         Object_List = NULL;
     }
+    Mempool_Cleanup(&Object_Pool);
 }
 
 /**
@@ -1233,4 +1252,6 @@ void Multistate_Output_Cleanup(void)
 void Multistate_Output_Init(void)
 {
     Object_List = Keylist_Create();
+    Mempool_Init(&Object_Pool, sizeof(struct object_data),
+        MULTISTATE_OUTPUT_POOL_SLAB_SIZE);
 }
@@ -46,7 +46,10 @@
 #include "bacnet/event.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/dcc.h"
+#include "bacnet/npdu.h"
 #include "bacnet/wp.h"
 #include "bacnet/basic/object/nc.h"
 #include "bacnet/datalink/datalink.h"
@@ -62,6 +65,54 @@ static NOTIFICATION_CLASS_INFO NC_Info[MAX_NOTIFICATION_CLASSES];
 /* buffer for sending event messages */
 static uint8_t Event_Buffer[MAX_APDU];
 
+/* cached address of each recipient, refreshed from the address cache */
+typedef struct Notification_Class_Binding {
+    bool valid;
+    unsigned max_apdu;
+    BACNET_ADDRESS address;
+} NC_RECIPIENT_BINDING;
+static NC_RECIPIENT_BINDING NC_Binding[MAX_NOTIFICATION_CLASSES]
+                                      [NC_MAX_RECIPIENTS];
+
+/* confirmed event notifications waiting for delivery */
+typedef enum {
+    NC_EVENT_QUEUE_EMPTY = 0,
+    NC_EVENT_QUEUE_WAITING,
+    NC_EVENT_QUEUE_IN_FLIGHT
+} NC_EVENT_QUEUE_STATE;
+
+/* answer of the recipient to a notification that is in flight */
+typedef enum {
+    NC_EVENT_QUEUE_NO_ANSWER = 0,
+    NC_EVENT_QUEUE_ACKNOWLEDGED,
+    NC_EVENT_QUEUE_REFUSED
+} NC_EVENT_QUEUE_ANSWER;
+
+typedef struct Notification_Class_Queue_Entry {
+    NC_EVENT_QUEUE_STATE state;
+    uint32_t sequence;
+    bool bound;
+    uint32_t device_id;
+    BACNET_ADDRESS dest;
+    unsigned max_apdu;
+    uint8_t invoke_id;
+    NC_EVENT_QUEUE_ANSWER answer;
+    unsigned long timestamp;
+    uint16_t service_request_len;
+    uint8_t service_request[NC_EVENT_QUEUE_APDU_MAX];
+} NC_EVENT_QUEUE_ENTRY;
+static NC_EVENT_QUEUE_ENTRY NC_Event_Queue[NC_EVENT_QUEUE_SIZE];
+static uint32_t NC_Event_Queue_Sequence;
+static NC_EVENT_QUEUE_STATS NC_Event_Queue_Counters;
+
+/* recent Who-Is for unbound recipients, to avoid duplicates */
+typedef struct Notification_Class_WhoIs {
+    bool valid;
+    uint32_t device_id;
+    unsigned long timestamp;
+} NC_WHOIS_REQUEST;
+static NC_WHOIS_REQUEST NC_WhoIs_Recent[NC_EVENT_QUEUE_SIZE];
+
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int Notification_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME, PROP_OBJECT_TYPE, PROP_NOTIFICATION_CLASS, PROP_PRIORITY,
@@ -102,12 +153,36 @@ void Notification_Class_Init(void)
             BACNET_DESTINATION *destination;
             destination = &NC_Info[NotifyIdx].Recipient_List[i];
             bacnet_destination_default_init(destination);
+            NC_Binding[NotifyIdx][i].valid = false;
         }
     }
+    memset(NC_Event_Queue, 0, sizeof(NC_Event_Queue));
+    memset(NC_WhoIs_Recent, 0, sizeof(NC_WhoIs_Recent));
+    memset(&NC_Event_Queue_Counters, 0, sizeof(NC_Event_Queue_Counters));
 
     return;
 }
 
+/**
+ * @brief Forget the cached recipient addresses of a notification class,
+ *  or of all the notification classes
+ * @param notification - notification class, or NULL for all
+ */
+static void Notification_Class_Binding_Invalidate(
+    NOTIFICATION_CLASS_INFO *notification)
+{
+    unsigned i, j;
+
+    for (i = 0; i < MAX_NOTIFICATION_CLASSES; i++) {
+        if (notification && (notification != &NC_Info[i])) {
+            continue;
+        }
+        for (j = 0; j < NC_MAX_RECIPIENTS; j++) {
+            NC_Binding[i][j].valid = false;
+        }
+    }
+}
+
 /* we simply have 0-n object instances.  Yours might be */
 /* more complex, and then you need validate that the */
 /* given instance exists */
@@ -425,6 +500,7 @@ bool Notification_Class_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 }
             }
             /* Decoded all recipient list */
+            Notification_Class_Binding_Invalidate(CurrentNotify);
             /* copy elements from temporary object */
             for (idx = 0; idx < NC_MAX_RECIPIENTS; idx++) {
                 BACNET_ADDRESS src = { 0 };
@@ -532,6 +608,402 @@ static bool IsRecipientActive(
     return true;
 }
 
+/**
+ * @brief Get the address of a recipient, using the cached binding
+ *  when it is known.
+ * @param notify_index - notification class index
+ * @param recipient_index - index into the Recipient_List
+ * @param dest - [out] address of the recipient
+ * @param max_apdu - [out] max APDU accepted by the recipient
+ * @return true if the recipient address is known
+ */
+static bool Notification_Class_Recipient_Address(unsigned notify_index,
+    unsigned recipient_index,
+    BACNET_ADDRESS *dest,
+    unsigned *max_apdu)
+{
+    NC_RECIPIENT_BINDING *binding;
+    BACNET_RECIPIENT *recipient;
+
+    binding = &NC_Binding[notify_index][recipient_index];
+    if (!binding->valid) {
+        recipient =
+            &NC_Info[notify_index].Recipient_List[recipient_index].Recipient;
+        if (recipient->tag == BACNET_RECIPIENT_TAG_DEVICE) {
+            if (!address_get_by_device(recipient->type.device.instance,
+                    &binding->max_apdu, &binding->address)) {
+                return false;
+            }
+        } else if (recipient->tag == BACNET_RECIPIENT_TAG_ADDRESS) {
+            bacnet_address_copy(&binding->address, &recipient->type.address);
+            binding->max_apdu = MAX_APDU;
+        } else {
+            return false;
+        }
+        binding->valid = true;
+    }
+    bacnet_address_copy(dest, &binding->address);
+    *max_apdu = binding->max_apdu;
+
+    return true;
+}
+
+/**
+ * @brief Request the binding of a recipient device, sending at most
+ *  one Who-Is per device every NC_EVENT_QUEUE_WHOIS_MS milliseconds.
+ * @param device_id - device instance of the recipient
+ */
+static void Notification_Class_Bind_Request(uint32_t device_id)
+{
+    BACNET_ADDRESS src = { 0 };
+    unsigned max_apdu = 0;
+    unsigned long now;
+    unsigned i, slot = 0;
+
+    if (address_bind_request(device_id, &max_apdu, &src)) {
+        return;
+    }
+    now = mstimer_now();
+    for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+        if (!NC_WhoIs_Recent[i].valid) {
+            slot = i;
+        } else if (NC_WhoIs_Recent[i].device_id == device_id) {
+            if ((now - NC_WhoIs_Recent[i].timestamp) <
+                NC_EVENT_QUEUE_WHOIS_MS) {
+                return;
+            }
+            slot = i;
+            break;
+        } else if (NC_WhoIs_Recent[slot].valid &&
+            ((now - NC_WhoIs_Recent[i].timestamp) >
+                (now - NC_WhoIs_Recent[slot].timestamp))) {
+            /* reuse the oldest request */
+            slot = i;
+        }
+    }
+    NC_WhoIs_Recent[slot].valid = true;
+    NC_WhoIs_Recent[slot].device_id = device_id;
+    NC_WhoIs_Recent[slot].timestamp = now;
+    Send_WhoIs(device_id, device_id);
+    NC_Event_Queue_Counters.whois_sent++;
+}
+
+/**
+ * @brief Add a confirmed event notification to the queue.  The service
+ *  request is encoded now, so the event data does not need to live on.
+ * @param device_id - device instance of the recipient
+ * @param dest - address of the recipient, or NULL if not yet bound
+ * @param max_apdu - max APDU accepted by the recipient
+ * @param event_data - event notification to send
+ * @return true if the notification was queued
+ */
+static bool Notification_Class_Event_Queue_Add(uint32_t device_id,
+    BACNET_ADDRESS *dest,
+    unsigned max_apdu,
+    BACNET_EVENT_NOTIFICATION_DATA *event_data)
+{
+    NC_EVENT_QUEUE_ENTRY *entry = NULL;
+    unsigned depth = 0;
+    unsigned i;
+    int len;
+
+    for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+        if (NC_Event_Queue[i].state == NC_EVENT_QUEUE_EMPTY) {
+            if (!entry) {
+                entry = &NC_Event_Queue[i];
+            }
+        } else {
+            depth++;
+        }
+    }
+    len = event_notify_encode_service_request(&Event_Buffer[0], event_data);
+    if (!entry || (len <= 0) || (len > NC_EVENT_QUEUE_APDU_MAX)) {
+        PRINTF("Notification Class: event notification dropped!\n");
+        NC_Event_Queue_Counters.dropped++;
+        return false;
+    }
+    if (!dest && (device_id > BACNET_MAX_INSTANCE)) {
+        /* unable to bind a recipient without a device instance */
+        NC_Event_Queue_Counters.dropped++;
+        return false;
+    }
+    memcpy(entry->service_request, Event_Buffer, (size_t)len);
+    entry->service_request_len = (uint16_t)len;
+    entry->device_id = device_id;
+    entry->bound = false;
+    if (dest) {
+        bacnet_address_copy(&entry->dest, dest);
+        entry->max_apdu = max_apdu;
+        entry->bound = true;
+    }
+    entry->invoke_id = 0;
+    entry->timestamp = mstimer_now();
+    entry->sequence = NC_Event_Queue_Sequence++;
+    entry->state = NC_EVENT_QUEUE_WAITING;
+    depth++;
+    if (depth > NC_Event_Queue_Counters.depth_peak) {
+        NC_Event_Queue_Counters.depth_peak = depth;
+    }
+    NC_Event_Queue_Counters.queued++;
+
+    return true;
+}
+
+/**
+ * @brief Send a queued confirmed event notification through the TSM
+ * @param entry - queued notification with a bound recipient
+ * @return true if the notification was sent, false if no TSM
+ *  transaction is available right now.
+ */
+static bool Notification_Class_Event_Queue_Send(NC_EVENT_QUEUE_ENTRY *entry)
+{
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+    uint8_t invoke_id;
+    int pdu_len;
+
+    if (!dcc_communication_enabled()) {
+        /* same as Send_CEvent_Notify() - nothing is sent */
+        entry->state = NC_EVENT_QUEUE_EMPTY;
+        NC_Event_Queue_Counters.dropped++;
+        return true;
+    }
+    invoke_id = tsm_next_free_invokeID();
+    if (!invoke_id) {
+        return false;
+    }
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(&Event_Buffer[0], &entry->dest, &my_address,
+        &npdu_data);
+    if (((pdu_len + 4 + entry->service_request_len) >
+            (int)sizeof(Event_Buffer)) ||
+        ((4U + entry->service_request_len) > entry->max_apdu)) {
+        /* exceeds destination maximum APDU */
+        tsm_free_invoke_id(invoke_id);
+        entry->state = NC_EVENT_QUEUE_EMPTY;
+        NC_Event_Queue_Counters.dropped++;
+        return true;
+    }
+    Event_Buffer[pdu_len++] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+    Event_Buffer[pdu_len++] = encode_max_segs_max_apdu(0, MAX_APDU);
+    Event_Buffer[pdu_len++] = invoke_id;
+    Event_Buffer[pdu_len++] = SERVICE_CONFIRMED_EVENT_NOTIFICATION;
+    memcpy(&Event_Buffer[pdu_len], entry->service_request,
+        entry->service_request_len);
+    pdu_len += entry->service_request_len;
+    tsm_set_confirmed_unsegmented_transaction(
+        invoke_id, &entry->dest, &npdu_data, Event_Buffer, (uint16_t)pdu_len);
+    tsm_send_pdu(invoke_id, &entry->dest, &npdu_data, Event_Buffer, pdu_len);
+    entry->invoke_id = invoke_id;
+    entry->answer = NC_EVENT_QUEUE_NO_ANSWER;
+    entry->state = NC_EVENT_QUEUE_IN_FLIGHT;
+    NC_Event_Queue_Counters.sent++;
+
+    return true;
+}
+
+/**
+ * @brief Record the answer of a recipient to a notification in flight
+ * @param src - address of the recipient that answered
+ * @param invoke_id - invoke ID of the answered request
+ * @param answer - acknowledged, or refused with an Error, Reject,
+ *  or Abort
+ */
+static void Notification_Class_Event_Queue_Answer(
+    BACNET_ADDRESS *src, uint8_t invoke_id, NC_EVENT_QUEUE_ANSWER answer)
+{
+    NC_EVENT_QUEUE_ENTRY *entry;
+    unsigned i;
+
+    for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+        entry = &NC_Event_Queue[i];
+        if ((entry->state == NC_EVENT_QUEUE_IN_FLIGHT) &&
+            (entry->invoke_id == invoke_id) &&
+            address_match(&entry->dest, src)) {
+            entry->answer = answer;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Handler for the SimpleACK of a ConfirmedEventNotification.
+ *  Register with apdu_set_confirmed_simple_ack_handler().
+ * @param src - address of the recipient
+ * @param invoke_id - invoke ID of the request
+ */
+void Notification_Class_Event_Ack_Handler(
+    BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    Notification_Class_Event_Queue_Answer(
+        src, invoke_id, NC_EVENT_QUEUE_ACKNOWLEDGED);
+}
+
+/**
+ * @brief Handler for the Error of a ConfirmedEventNotification.
+ *  Register with apdu_set_error_handler().
+ * @param src - address of the recipient
+ * @param invoke_id - invoke ID of the request
+ * @param error_class - BACnet error class
+ * @param error_code - BACnet error code
+ */
+void Notification_Class_Event_Error_Handler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    (void)error_class;
+    (void)error_code;
+    Notification_Class_Event_Queue_Answer(
+        src, invoke_id, NC_EVENT_QUEUE_REFUSED);
+}
+
+/**
+ * @brief Handler for a Reject of a ConfirmedEventNotification.
+ *  Register with apdu_set_reject_handler(), or call from the
+ *  reject handler of the application.
+ * @param src - address of the recipient
+ * @param invoke_id - invoke ID of the request
+ * @param reject_reason - BACnet reject reason
+ */
+void Notification_Class_Event_Reject_Handler(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
+{
+    (void)reject_reason;
+    Notification_Class_Event_Queue_Answer(
+        src, invoke_id, NC_EVENT_QUEUE_REFUSED);
+}
+
+/**
+ * @brief Handler for an Abort of a ConfirmedEventNotification.
+ *  Register with apdu_set_abort_handler(), or call from the
+ *  abort handler of the application.
+ * @param src - address of the recipient
+ * @param invoke_id - invoke ID of the request
+ * @param abort_reason - BACnet abort reason
+ * @param server - true if the abort was sent by a server
+ */
+void Notification_Class_Event_Abort_Handler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    uint8_t abort_reason,
+    bool server)
+{
+    (void)abort_reason;
+    (void)server;
+    Notification_Class_Event_Queue_Answer(
+        src, invoke_id, NC_EVENT_QUEUE_REFUSED);
+}
+
+/**
+ * @brief Deliver queued confirmed event notifications: retire the ones
+ *  answered by the TSM, bind the waiting recipients, and send the oldest
+ *  waiting notifications while fewer than NC_EVENT_QUEUE_WINDOW are
+ *  outstanding.  Call from the main loop, and after the TSM timer.
+ *  A notification is only counted as completed when the SimpleACK is
+ *  seen by Notification_Class_Event_Ack_Handler(), so that handler
+ *  and the Error, Reject, and Abort handlers need to be registered.
+ */
+void Notification_Class_Event_Queue_Task(void)
+{
+    NC_EVENT_QUEUE_ENTRY *entry;
+    NC_EVENT_QUEUE_ENTRY *oldest;
+    unsigned in_flight = 0;
+    unsigned long now;
+    unsigned long latency;
+    unsigned i;
+
+    now = mstimer_now();
+    for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+        entry = &NC_Event_Queue[i];
+        if (entry->state == NC_EVENT_QUEUE_IN_FLIGHT) {
+            if (tsm_invoke_id_failed(entry->invoke_id)) {
+                tsm_free_invoke_id(entry->invoke_id);
+                entry->state = NC_EVENT_QUEUE_EMPTY;
+                NC_Event_Queue_Counters.failed++;
+                /* the recipient may have moved */
+                Notification_Class_Binding_Invalidate(NULL);
+            } else if (tsm_invoke_id_free(entry->invoke_id)) {
+                entry->state = NC_EVENT_QUEUE_EMPTY;
+                if (entry->answer == NC_EVENT_QUEUE_ACKNOWLEDGED) {
+                    latency = now - entry->timestamp;
+                    NC_Event_Queue_Counters.completed++;
+                    NC_Event_Queue_Counters.latency_last_ms = latency;
+                    NC_Event_Queue_Counters.latency_total_ms += latency;
+                    if (latency > NC_Event_Queue_Counters.latency_max_ms) {
+                        NC_Event_Queue_Counters.latency_max_ms = latency;
+                    }
+                } else {
+                    /* an Error, Reject, or Abort also frees the invoke ID */
+                    NC_Event_Queue_Counters.failed++;
+                }
+            } else {
+                in_flight++;
+            }
+        } else if ((entry->state == NC_EVENT_QUEUE_WAITING) &&
+            !entry->bound) {
+            if (address_get_by_device(
+                    entry->device_id, &entry->max_apdu, &entry->dest)) {
+                entry->bound = true;
+            } else if ((now - entry->timestamp) >
+                NC_EVENT_QUEUE_BIND_TIMEOUT_MS) {
+                PRINTF("Notification Class: device %u not bound!\n",
+                    (unsigned)entry->device_id);
+                entry->state = NC_EVENT_QUEUE_EMPTY;
+                NC_Event_Queue_Counters.dropped++;
+            } else {
+                Notification_Class_Bind_Request(entry->device_id);
+            }
+        }
+    }
+    while (in_flight < NC_EVENT_QUEUE_WINDOW) {
+        oldest = NULL;
+        for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+            entry = &NC_Event_Queue[i];
+            if ((entry->state == NC_EVENT_QUEUE_WAITING) && entry->bound) {
+                if (!oldest ||
+                    ((int32_t)(entry->sequence - oldest->sequence) < 0)) {
+                    oldest = entry;
+                }
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        if (!Notification_Class_Event_Queue_Send(oldest)) {
+            /* no TSM transaction available - try again later */
+            break;
+        }
+        if (oldest->state == NC_EVENT_QUEUE_IN_FLIGHT) {
+            in_flight++;
+        }
+    }
+}
+
+/**
+ * @brief Get the confirmed event notification queue counters
+ * @param stats - [out] queue depth, throughput, and latency counters
+ */
+void Notification_Class_Event_Queue_Stats(NC_EVENT_QUEUE_STATS *stats)
+{
+    unsigned i;
+
+    if (!stats) {
+        return;
+    }
+    *stats = NC_Event_Queue_Counters;
+    stats->depth = 0;
+    stats->in_flight = 0;
+    for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+        if (NC_Event_Queue[i].state != NC_EVENT_QUEUE_EMPTY) {
+            stats->depth++;
+        }
+        if (NC_Event_Queue[i].state == NC_EVENT_QUEUE_IN_FLIGHT) {
+            stats->in_flight++;
+        }
+    }
+}
+
 void Notification_Class_common_reporting_function(
     BACNET_EVENT_NOTIFICATION_DATA *event_data)
 {
@@ -600,37 +1072,35 @@ void Notification_Class_common_reporting_function(
         }
         if (IsRecipientActive(pBacDest, event_data->toState)) {
             BACNET_ADDRESS dest;
-            uint32_t device_id;
-            unsigned max_apdu;
+            uint32_t device_id = BACNET_MAX_INSTANCE;
+            unsigned max_apdu = 0;
+            bool bound;
 
             /* Process Identifier */
             event_data->processIdentifier = pBacDest->ProcessIdentifier;
 
             /* send notification */
+            bound = Notification_Class_Recipient_Address(
+                notify_index, index, &dest, &max_apdu);
             if (pBacDest->Recipient.tag == BACNET_RECIPIENT_TAG_DEVICE) {
                 /* send notification to the specified device */
                 device_id = pBacDest->Recipient.type.device.instance;
                 PRINTF("Notification Class[%u]: send notification to %u\n",
                     event_data->notificationClass, (unsigned)device_id);
-                if (pBacDest->ConfirmedNotify == true)
-                    Send_CEvent_Notify(device_id, event_data);
-                else if (address_get_by_device(device_id, &max_apdu, &dest))
-                    Send_UEvent_Notify(Event_Buffer, event_data, &dest);
-            } else if (pBacDest->Recipient.tag ==
-                BACNET_RECIPIENT_TAG_ADDRESS) {
+            } else {
+                /* send notification to the address indicated */
                 PRINTF("Notification Class[%u]: send notification to ADDR\n",
                     event_data->notificationClass);
-                /* send notification to the address indicated */
-                if (pBacDest->ConfirmedNotify == true) {
-                    if (address_get_device_id(&dest, &device_id))
-                        Send_CEvent_Notify(device_id, event_data);
-                } else {
-                    dest = pBacDest->Recipient.type.address;
-                    Send_UEvent_Notify(Event_Buffer, event_data, &dest);
-                }
+            }
+            if (pBacDest->ConfirmedNotify == true) {
+                Notification_Class_Event_Queue_Add(
+                    device_id, bound ? &dest : NULL, max_apdu, event_data);
+            } else if (bound) {
+                Send_UEvent_Notify(Event_Buffer, event_data, &dest);
             }
         }
     }
+    Notification_Class_Event_Queue_Task();
 }
 
 /* This function tries to find the addresses of the defined devices. */
@@ -640,11 +1110,11 @@ void Notification_Class_find_recipient(void)
     NOTIFICATION_CLASS_INFO *notification;
     BACNET_DESTINATION *destination;
     BACNET_RECIPIENT *recipient;
-    BACNET_ADDRESS src = { 0 };
-    unsigned max_apdu = 0;
     uint32_t device_id;
     unsigned i, j;
 
+    /* pick up any bindings that changed in the address cache */
+    Notification_Class_Binding_Invalidate(NULL);
     for (i = 0; i < MAX_NOTIFICATION_CLASSES; i++) {
         notification = &NC_Info[i];
         for (j = 0; j < NC_MAX_RECIPIENTS; j++) {
@@ -652,11 +1122,10 @@ void Notification_Class_find_recipient(void)
             recipient = &destination->Recipient;
             if (bacnet_recipient_device_valid(recipient)) {
                 device_id = recipient->type.device.instance;
-                if (!address_bind_request(device_id, &max_apdu, &src)) {
-                    /*  Send who_ is request only when
-                        address of device is unknown. */
-                    Send_WhoIs(device_id, device_id);
-                }
+                /*  Send who_ is request only when
+                    address of device is unknown,
+                    and only once for the same device. */
+                Notification_Class_Bind_Request(device_id);
             }
         }
     }
@@ -835,6 +1304,7 @@ int Notification_Class_Add_List_Element(
         }
     }
 
+    Notification_Class_Binding_Invalidate(notification);
     return BACNET_STATUS_OK;
 }
 
@@ -963,6 +1433,7 @@ int Notification_Class_Remove_List_Element(
         }
     }
 
+    Notification_Class_Binding_Invalidate(notification);
     return BACNET_STATUS_OK;
 }
 #endif /* defined(INTRINSIC_REPORTING) */
@@ -41,6 +41,27 @@ extern "C" {
 /* max "length" of recipient_list */
 #define NC_MAX_RECIPIENTS 10
 
+/* number of confirmed event notifications waiting for delivery */
+#ifndef NC_EVENT_QUEUE_SIZE
+#define NC_EVENT_QUEUE_SIZE 16
+#endif
+/* number of confirmed event notifications outstanding in the TSM */
+#ifndef NC_EVENT_QUEUE_WINDOW
+#define NC_EVENT_QUEUE_WINDOW 4
+#endif
+/* size of one encoded event notification service request */
+#ifndef NC_EVENT_QUEUE_APDU_MAX
+#define NC_EVENT_QUEUE_APDU_MAX MAX_APDU
+#endif
+/* milliseconds to wait for an unbound recipient before dropping */
+#ifndef NC_EVENT_QUEUE_BIND_TIMEOUT_MS
+#define NC_EVENT_QUEUE_BIND_TIMEOUT_MS 30000UL
+#endif
+/* minimum milliseconds between Who-Is to the same unbound recipient */
+#ifndef NC_EVENT_QUEUE_WHOIS_MS
+#define NC_EVENT_QUEUE_WHOIS_MS 5000UL
+#endif
+
 #if defined(INTRINSIC_REPORTING)
 
 /* Structure containing configuration for a Notification Class */
@@ -64,6 +85,22 @@ typedef struct Ack_Notification {
     uint8_t EventState;
 } ACK_NOTIFICATION;
 
+/* Confirmed event notification queue counters */
+typedef struct Notification_Class_Queue_Stats {
+    unsigned depth; /* notifications waiting or outstanding */
+    unsigned depth_peak; /* largest depth seen */
+    unsigned in_flight; /* notifications outstanding in the TSM */
+    unsigned long queued; /* notifications added to the queue */
+    unsigned long sent; /* notifications handed to the TSM */
+    unsigned long completed; /* notifications acknowledged */
+    unsigned long failed; /* refused, or never answered */
+    unsigned long dropped; /* queue full, unbound, or too large */
+    unsigned long whois_sent; /* binding requests sent for recipients */
+    unsigned long latency_last_ms; /* queued to answered, last one */
+    unsigned long latency_max_ms; /* queued to answered, largest */
+    unsigned long latency_total_ms; /* queued to answered, sum */
+} NC_EVENT_QUEUE_STATS;
+
 BACNET_STACK_EXPORT
 void Notification_Class_Property_Lists(
     const int **pRequired, const int **pOptional, const int **pProprietary);
@@ -105,6 +142,27 @@ void Notification_Class_common_reporting_function(
 
 BACNET_STACK_EXPORT
 void Notification_Class_find_recipient(void);
+
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Queue_Task(void);
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Ack_Handler(
+    BACNET_ADDRESS *src, uint8_t invoke_id);
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Error_Handler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code);
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Reject_Handler(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason);
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Abort_Handler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    uint8_t abort_reason,
+    bool server);
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Queue_Stats(NC_EVENT_QUEUE_STATS *stats);
 #endif /* defined(INTRINSIC_REPORTING) */
 
 #ifdef __cplusplus
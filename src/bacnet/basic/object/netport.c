@@ -156,6 +156,9 @@ static const int BIP6_Port_Properties_Optional[] = { PROP_MAC_ADDRESS,
 
 static const int Network_Port_Properties_Proprietary[] = { -1 };
 
+/* member bitmap of the property lists of the last port that was read */
+static struct property_list_index_t Property_List_Index;
+
 /**
  * Returns the list of required, optional, and proprietary properties.
  * Used by ReadPropertyMultiple service.
@@ -2191,9 +2194,10 @@ int Network_Port_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     }
     Network_Port_Property_List(
         rpdata->object_instance, &pRequired, &pOptional, &pProprietary);
-    if ((!property_list_member(pRequired, rpdata->object_property)) &&
-        (!property_list_member(pOptional, rpdata->object_property)) &&
-        (!property_list_member(pProprietary, rpdata->object_property))) {
+    property_list_index_update(
+        &Property_List_Index, pRequired, pOptional, pProprietary);
+    if (!property_list_index_member(
+            &Property_List_Index, rpdata->object_property)) {
         rpdata->error_class = ERROR_CLASS_PROPERTY;
         rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
         return BACNET_STATUS_ERROR;
@@ -25,12 +25,14 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "bacnet/bacdef.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacenum.h"
 #include "bacnet/bactext.h"
 #include "bacnet/config.h"
+#include "bacnet/basic/sys/days.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/proplist.h"
@@ -75,11 +77,11 @@ void Schedule_Init(void)
 
     for (i = 0; i < MAX_SCHEDULES; i++, psched++) {
         /* whole year, change as necessary */
-        psched->Start_Date.year = 0xFF;
+        psched->Start_Date.year = BACNET_DATE_YEAR_EPOCH + 0xFF;
         psched->Start_Date.month = 1;
         psched->Start_Date.day = 1;
         psched->Start_Date.wday = 0xFF;
-        psched->End_Date.year = 0xFF;
+        psched->End_Date.year = BACNET_DATE_YEAR_EPOCH + 0xFF;
         psched->End_Date.month = 12;
         psched->End_Date.day = 31;
         psched->End_Date.wday = 0xFF;
@@ -94,6 +96,8 @@ void Schedule_Init(void)
         psched->obj_prop_ref_cnt = 0; /* no references, add as needed */
         psched->Priority_For_Writing = 16; /* lowest priority */
         psched->Out_Of_Service = false;
+        psched->Exception_Count = 0;
+        Schedule_Timeline_Invalidate(psched);
     }
 }
 
@@ -107,6 +111,22 @@ bool Schedule_Valid_Instance(uint32_t object_instance)
     }
 }
 
+/**
+ * @brief Get the data of a schedule object, to configure it
+ * @param object_instance - object-instance number of the object
+ * @return schedule object data, or NULL if not found
+ */
+SCHEDULE_DESCR *Schedule_Object(uint32_t object_instance)
+{
+    unsigned index = Schedule_Instance_To_Index(object_instance);
+
+    if (index < MAX_SCHEDULES) {
+        return &Schedule_Descr[index];
+    }
+
+    return NULL;
+}
+
 unsigned Schedule_Count(void)
 {
     return MAX_SCHEDULES;
@@ -426,3 +446,428 @@ void Schedule_Recalculate_PV(
             sizeof(desc->Present_Value));
     }
 }
+
+/**
+ * @brief Determine if a date matches a BACnetDate pattern, which may
+ *  have wildcards, odd or even months, and the last, odd, or even days
+ * @param pattern - BACnetDate with wildcards
+ * @param date - date with a valid day of week
+ * @return true if the date matches the pattern
+ */
+static bool Schedule_Date_Match(BACNET_DATE *pattern, BACNET_DATE *date)
+{
+    bool status = true;
+
+    if ((pattern->year != (BACNET_DATE_YEAR_EPOCH + 0xFF)) &&
+        (pattern->year != date->year)) {
+        status = false;
+    }
+    if (pattern->month == 13) {
+        /* odd months */
+        if ((date->month & 1) == 0) {
+            status = false;
+        }
+    } else if (pattern->month == 14) {
+        /* even months */
+        if (date->month & 1) {
+            status = false;
+        }
+    } else if ((pattern->month != 0xFF) && (pattern->month != date->month)) {
+        status = false;
+    }
+    if (pattern->day == 32) {
+        /* last day of the month */
+        if (date->day != days_per_month(date->year, date->month)) {
+            status = false;
+        }
+    } else if (pattern->day == 33) {
+        /* odd days */
+        if ((date->day & 1) == 0) {
+            status = false;
+        }
+    } else if (pattern->day == 34) {
+        /* even days */
+        if (date->day & 1) {
+            status = false;
+        }
+    } else if ((pattern->day != 0xFF) && (pattern->day != date->day)) {
+        status = false;
+    }
+    if ((pattern->wday != 0xFF) && (pattern->wday != date->wday)) {
+        status = false;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Determine if a date matches a BACnetWeekNDay
+ * @param weeknday - month, week of month, and day of week with wildcards
+ * @param date - date with a valid day of week
+ * @return true if the date matches
+ */
+static bool Schedule_Week_N_Day_Match(
+    BACNET_WEEKNDAY *weeknday, BACNET_DATE *date)
+{
+    bool status = true;
+
+    if (weeknday->month == 13) {
+        if ((date->month & 1) == 0) {
+            status = false;
+        }
+    } else if (weeknday->month == 14) {
+        if (date->month & 1) {
+            status = false;
+        }
+    } else if ((weeknday->month != 0xFF) &&
+        (weeknday->month != date->month)) {
+        status = false;
+    }
+    if (weeknday->weekofmonth == 6) {
+        /* last 7 days of the month */
+        if ((date->day + 7) <= days_per_month(date->year, date->month)) {
+            status = false;
+        }
+    } else if ((weeknday->weekofmonth != 0xFF) &&
+        (weeknday->weekofmonth != (((date->day - 1) / 7) + 1))) {
+        status = false;
+    }
+    if ((weeknday->dayofweek != 0xFF) &&
+        (weeknday->dayofweek != date->wday)) {
+        status = false;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Determine if a special event of the Exception_Schedule is in
+ *  effect on a date
+ * @param event - special event
+ * @param date - the date
+ * @return true if the calendar entry of the special event matches the date
+ */
+bool Schedule_Special_Event_Active(
+    BACNET_OBJ_SPECIAL_EVENT *event, BACNET_DATE *date)
+{
+    bool status = false;
+    BACNET_DATE today;
+
+    if (!event || !date) {
+        return false;
+    }
+    datetime_set_date(&today, date->year, date->month, date->day);
+    switch (event->Calendar_Entry_Tag) {
+        case BACNET_CALENDAR_DATE:
+            status = Schedule_Date_Match(&event->Calendar_Entry.Date, &today);
+            break;
+        case BACNET_CALENDAR_DATE_RANGE:
+            if ((datetime_wildcard_compare_date(
+                     &event->Calendar_Entry.Date_Range.startdate, &today) <=
+                    0) &&
+                (datetime_wildcard_compare_date(
+                     &event->Calendar_Entry.Date_Range.enddate, &today) >=
+                    0)) {
+                status = true;
+            }
+            break;
+        case BACNET_CALENDAR_WEEK_N_DAY:
+            status = Schedule_Week_N_Day_Match(
+                &event->Calendar_Entry.Week_N_Day, &today);
+            break;
+        default:
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Find the value of a daily schedule in effect at a time of day,
+ *  which is the value of the latest time at or before the time of day
+ * @param day - daily schedule
+ * @param seconds - time of day in seconds since midnight
+ * @return the value, or NULL if the daily schedule has no value in effect
+ *  or relinquishes with a NULL value
+ */
+static const BACNET_PRIMITIVE_DATA_VALUE *Schedule_Daily_Value(
+    BACNET_OBJ_DAILY_SCHEDULE *day, uint32_t seconds)
+{
+    BACNET_TIME_VALUE *time_value = NULL;
+    BACNET_TIME_VALUE *latest = NULL;
+    uint32_t latest_seconds = 0;
+    uint32_t time_seconds;
+    unsigned i;
+
+    for (i = 0; (i < day->TV_Count) && (i < BACNET_WEEKLY_SCHEDULE_SIZE);
+         i++) {
+        time_value = &day->Time_Values[i];
+        if (time_value->Time.hour > 23) {
+            continue;
+        }
+        time_seconds = datetime_seconds_since_midnight(&time_value->Time);
+        if ((time_seconds <= seconds) &&
+            (!latest || (time_seconds >= latest_seconds))) {
+            latest = time_value;
+            latest_seconds = time_seconds;
+        }
+    }
+    if (latest && (latest->Value.tag != BACNET_APPLICATION_TAG_NULL)) {
+        return &latest->Value;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Forget the compiled timeline, after any change to the effective
+ *  period, the weekly or exception schedule, or the schedule default,
+ *  so that it is compiled again on the next evaluation
+ * @param desc - schedule object data
+ */
+void Schedule_Timeline_Invalidate(SCHEDULE_DESCR *desc)
+{
+    if (desc) {
+        desc->Timeline_Count = 0;
+        desc->Timeline_Date.year = 0;
+        desc->Timeline_Date.month = 0;
+        desc->Timeline_Date.day = 0;
+        desc->Timeline_Date.wday = 0;
+        desc->Next_Transition = 0;
+    }
+}
+
+/**
+ * @brief Compile the effective period, and the weekly and exception
+ *  schedules, into the sorted transitions of the scheduled value on
+ *  a date.  The value at each time is the value of the highest priority
+ *  special event in effect with a value that is not NULL, or else of
+ *  the weekly schedule, or else the Schedule_Default.
+ * @param desc - schedule object data
+ * @param date - the date to compile
+ * @return true if the date is in the effective period and the timeline
+ *  has at least one transition
+ */
+bool Schedule_Timeline_Compile(SCHEDULE_DESCR *desc, BACNET_DATE *date)
+{
+    BACNET_OBJ_DAILY_SCHEDULE *day[1 + BACNET_EXCEPTION_SCHEDULE_SIZE];
+    uint8_t day_priority[1 + BACNET_EXCEPTION_SCHEDULE_SIZE];
+    uint32_t times[BACNET_SCHEDULE_TIMELINE_SIZE];
+    const BACNET_PRIMITIVE_DATA_VALUE *value = NULL;
+    BACNET_OBJ_SPECIAL_EVENT *event;
+    BACNET_TIME_VALUE *time_value;
+    BACNET_DATE today;
+    unsigned day_count = 0, time_count = 0;
+    unsigned i, j, d;
+    uint32_t seconds;
+
+    if (!desc || !date) {
+        return false;
+    }
+    datetime_set_date(&today, date->year, date->month, date->day);
+    datetime_copy_date(&desc->Timeline_Date, &today);
+    desc->Timeline_Count = 0;
+    if (!Schedule_In_Effective_Period(desc, &today) ||
+        (today.wday < BACNET_WEEKDAY_MONDAY) ||
+        (today.wday > BACNET_WEEKDAY_SUNDAY)) {
+        return false;
+    }
+    /* the daily schedules in effect today, highest priority first */
+    for (i = 0;
+         (i < desc->Exception_Count) && (i < BACNET_EXCEPTION_SCHEDULE_SIZE);
+         i++) {
+        event = &desc->Exception_Schedule[i];
+        if (!Schedule_Special_Event_Active(event, &today)) {
+            continue;
+        }
+        d = day_count;
+        while ((d > 0) && (day_priority[d - 1] > event->Event_Priority)) {
+            day[d] = day[d - 1];
+            day_priority[d] = day_priority[d - 1];
+            d--;
+        }
+        day[d] = &event->Day_Schedule;
+        day_priority[d] = event->Event_Priority;
+        day_count++;
+    }
+    day[day_count] = &desc->Weekly_Schedule[today.wday - 1];
+    day_priority[day_count] = BACNET_MAX_PRIORITY + 1;
+    day_count++;
+    /* the times of day where the value may change, sorted and unique */
+    times[time_count++] = 0;
+    for (d = 0; d < day_count; d++) {
+        for (i = 0;
+             (i < day[d]->TV_Count) && (i < BACNET_WEEKLY_SCHEDULE_SIZE);
+             i++) {
+            time_value = &day[d]->Time_Values[i];
+            if (time_value->Time.hour > 23) {
+                continue;
+            }
+            seconds = datetime_seconds_since_midnight(&time_value->Time);
+            j = time_count;
+            while ((j > 0) && (times[j - 1] > seconds)) {
+                j--;
+            }
+            if ((j > 0) && (times[j - 1] == seconds)) {
+                continue;
+            }
+            memmove(&times[j + 1], &times[j],
+                (time_count - j) * sizeof(times[0]));
+            times[j] = seconds;
+            time_count++;
+        }
+    }
+    /* the value at each of the times, where it changes */
+    for (i = 0; i < time_count; i++) {
+        value = NULL;
+        for (d = 0; (d < day_count) && !value; d++) {
+            value = Schedule_Daily_Value(day[d], times[i]);
+        }
+        if ((desc->Timeline_Count == 0) ||
+            (desc->Timeline[desc->Timeline_Count - 1].Value != value)) {
+            desc->Timeline[desc->Timeline_Count].Seconds = times[i];
+            desc->Timeline[desc->Timeline_Count].Value = value;
+            desc->Timeline_Count++;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Evaluate the Present_Value from the compiled timeline, which is
+ *  compiled again when the date changes, and find the next transition
+ * @param desc - schedule object data
+ * @param bdatetime - the local date and time
+ * @return true if the Present_Value changed
+ */
+bool Schedule_Timeline_Evaluate(
+    SCHEDULE_DESCR *desc, BACNET_DATE_TIME *bdatetime)
+{
+    BACNET_APPLICATION_DATA_VALUE value;
+    uint32_t seconds, next_seconds;
+    unsigned low, high, middle;
+    bool status = false;
+
+    if (!desc || !bdatetime) {
+        return false;
+    }
+    if (datetime_compare_date(&desc->Timeline_Date, &bdatetime->date) != 0) {
+        Schedule_Timeline_Compile(desc, &bdatetime->date);
+    }
+    seconds = datetime_seconds_since_midnight(&bdatetime->time);
+    /* at midnight the timeline of the next day is compiled */
+    next_seconds = datetime_hms_to_seconds_since_midnight(24, 0, 0);
+    if (desc->Timeline_Count > 0) {
+        /* the first transition after now - the first is at midnight */
+        low = 1;
+        high = desc->Timeline_Count;
+        while (low < high) {
+            middle = (low + high) / 2;
+            if (desc->Timeline[middle].Seconds <= seconds) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        if (low < desc->Timeline_Count) {
+            next_seconds = desc->Timeline[low].Seconds;
+        }
+        if (desc->Timeline[low - 1].Value) {
+            bacnet_primitive_to_application_data_value(
+                &value, desc->Timeline[low - 1].Value);
+        } else {
+            memcpy(&value, &desc->Schedule_Default, sizeof(value));
+        }
+        if (!bacapp_same_value(&desc->Present_Value, &value)) {
+            memcpy(&desc->Present_Value, &value, sizeof(value));
+            status = true;
+        }
+    }
+    desc->Next_Transition =
+        datetime_seconds_since_epoch(bdatetime) - seconds + next_seconds;
+
+    return status;
+}
+
+/**
+ * @brief Write the Present_Value to the List_Of_Object_Property_References
+ *  at the Priority_For_Writing.  The value is encoded once for all of
+ *  the references.
+ * @param desc - schedule object data
+ */
+static void Schedule_Write_References(SCHEDULE_DESCR *desc)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember = NULL;
+    unsigned i;
+    int len;
+
+    if (desc->obj_prop_ref_cnt == 0) {
+        return;
+    }
+    len = bacapp_encode_application_data(
+        wp_data.application_data, &desc->Present_Value);
+    if (len <= 0) {
+        return;
+    }
+    wp_data.application_data_len = len;
+    wp_data.priority = desc->Priority_For_Writing;
+    for (i = 0; (i < desc->obj_prop_ref_cnt) &&
+         (i < BACNET_SCHEDULE_OBJ_PROP_REF_SIZE);
+         i++) {
+        pMember = &desc->Object_Property_References[i];
+        /* NOTE: our implementation is for internal objects only */
+        if ((pMember->deviceIdentifier.type == OBJECT_DEVICE) &&
+            (pMember->deviceIdentifier.instance !=
+                Device_Object_Instance_Number())) {
+            continue;
+        }
+        wp_data.object_type = pMember->objectIdentifier.type;
+        wp_data.object_instance = pMember->objectIdentifier.instance;
+        wp_data.object_property = pMember->propertyIdentifier;
+        wp_data.array_index = pMember->arrayIndex;
+        Device_Write_Property(&wp_data);
+    }
+}
+
+/**
+ * @brief Evaluate the schedules that have reached their next transition,
+ *  and write the changed values to their object property references.
+ * @param bdatetime - the local date and time
+ * @return number of seconds until the next transition of any schedule,
+ *  so that the caller may sleep until then
+ */
+uint32_t Schedule_Task(BACNET_DATE_TIME *bdatetime)
+{
+    static bacnet_time_t last_seconds = 0;
+    bacnet_time_t seconds, next_seconds;
+    uint32_t day_seconds;
+    SCHEDULE_DESCR *desc;
+    unsigned i;
+
+    if (!bdatetime) {
+        return 0;
+    }
+    day_seconds = datetime_hms_to_seconds_since_midnight(24, 0, 0);
+    seconds = datetime_seconds_since_epoch(bdatetime);
+    next_seconds = seconds + day_seconds;
+    for (i = 0; i < MAX_SCHEDULES; i++) {
+        desc = &Schedule_Descr[i];
+        if (desc->Out_Of_Service) {
+            continue;
+        }
+        /* the clock was set back, so the next transitions are wrong */
+        if ((seconds < last_seconds) || (seconds >= desc->Next_Transition)) {
+            if (Schedule_Timeline_Evaluate(desc, bdatetime)) {
+                Schedule_Write_References(desc);
+            }
+        }
+        if (desc->Next_Transition < next_seconds) {
+            next_seconds = desc->Next_Transition;
+        }
+    }
+    last_seconds = seconds;
+
+    return (next_seconds > seconds) ? (uint32_t)(next_seconds - seconds) : 0;
+}
@@ -46,6 +46,15 @@
 #define BACNET_SCHEDULE_OBJ_PROP_REF_SIZE 4     /* maximum number of obj prop references */
 #endif
 
+#ifndef BACNET_EXCEPTION_SCHEDULE_SIZE
+#define BACNET_EXCEPTION_SCHEDULE_SIZE 2        /* maximum number of special events */
+#endif
+
+/* a transition at midnight, and at each time of the weekly schedule
+   and of each special event */
+#define BACNET_SCHEDULE_TIMELINE_SIZE \
+    (1 + (BACNET_WEEKLY_SCHEDULE_SIZE * (1 + BACNET_EXCEPTION_SCHEDULE_SIZE)))
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,12 +70,44 @@ extern "C" {
         uint16_t TV_Count;      /* the number of time values actually used */
     } BACNET_OBJ_DAILY_SCHEDULE;
 
+    /* BACnetCalendarEntry choices */
+    typedef enum {
+        BACNET_CALENDAR_DATE = 0,
+        BACNET_CALENDAR_DATE_RANGE = 1,
+        BACNET_CALENDAR_WEEK_N_DAY = 2
+    } BACNET_CALENDAR_ENTRY_TAG;
+
+    /*
+     * BACnetSpecialEvent of the Exception_Schedule, with a calendar entry
+     * as the period. Calendar object references are not supported.
+     */
+    typedef struct bacnet_obj_special_event {
+        BACNET_CALENDAR_ENTRY_TAG Calendar_Entry_Tag;
+        union {
+            BACNET_DATE Date;
+            BACNET_DATE_RANGE Date_Range;
+            BACNET_WEEKNDAY Week_N_Day;
+        } Calendar_Entry;
+        BACNET_OBJ_DAILY_SCHEDULE Day_Schedule;
+        uint8_t Event_Priority; /* (1..16) */
+    } BACNET_OBJ_SPECIAL_EVENT;
+
+    /* a change of the scheduled value, from this time until the next */
+    typedef struct bacnet_schedule_transition {
+        uint32_t Seconds;       /* seconds since midnight */
+        /* the scheduled value, or NULL for the Schedule_Default */
+        const BACNET_PRIMITIVE_DATA_VALUE *Value;
+    } BACNET_SCHEDULE_TRANSITION;
+
     typedef struct schedule {
         /* Effective Period: Start and End Date */
         BACNET_DATE Start_Date;
         BACNET_DATE End_Date;
         /* Properties concerning Present Value */
         BACNET_OBJ_DAILY_SCHEDULE Weekly_Schedule[7];
+        BACNET_OBJ_SPECIAL_EVENT
+            Exception_Schedule[BACNET_EXCEPTION_SCHEDULE_SIZE];
+        uint8_t Exception_Count;        /* actual number of special events */
         BACNET_APPLICATION_DATA_VALUE Schedule_Default;
         /*
          * Caution: This is a converted to BACNET_PRIMITIVE_APPLICATION_DATA_VALUE.
@@ -79,6 +120,13 @@ extern "C" {
         uint8_t obj_prop_ref_cnt;       /* actual number of obj_prop references */
         uint8_t Priority_For_Writing;   /* (1..16) */
         bool Out_Of_Service;
+        /* the transitions of the day that the timeline was compiled for,
+           sorted by time - see Schedule_Timeline_Compile() */
+        BACNET_SCHEDULE_TRANSITION Timeline[BACNET_SCHEDULE_TIMELINE_SIZE];
+        uint16_t Timeline_Count;
+        BACNET_DATE Timeline_Date;
+        /* seconds since epoch of the next transition */
+        bacnet_time_t Next_Transition;
     } SCHEDULE_DESCR;
 
     BACNET_STACK_EXPORT
@@ -96,6 +144,8 @@ extern "C" {
     unsigned Schedule_Instance_To_Index(uint32_t instance);
     BACNET_STACK_EXPORT
     void Schedule_Init(void);
+    BACNET_STACK_EXPORT
+    SCHEDULE_DESCR *Schedule_Object(uint32_t object_instance);
 
     BACNET_STACK_EXPORT
     void Schedule_Out_Of_Service_Set(
@@ -125,6 +175,21 @@ extern "C" {
         BACNET_WEEKDAY wday,
         BACNET_TIME * time);
 
+    /* precompiled timeline of the weekly and exception schedules */
+    BACNET_STACK_EXPORT
+    bool Schedule_Special_Event_Active(BACNET_OBJ_SPECIAL_EVENT * event,
+        BACNET_DATE * date);
+    BACNET_STACK_EXPORT
+    void Schedule_Timeline_Invalidate(SCHEDULE_DESCR * desc);
+    BACNET_STACK_EXPORT
+    bool Schedule_Timeline_Compile(SCHEDULE_DESCR * desc,
+        BACNET_DATE * date);
+    BACNET_STACK_EXPORT
+    bool Schedule_Timeline_Evaluate(SCHEDULE_DESCR * desc,
+        BACNET_DATE_TIME * bdatetime);
+    BACNET_STACK_EXPORT
+    uint32_t Schedule_Task(BACNET_DATE_TIME * bdatetime);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
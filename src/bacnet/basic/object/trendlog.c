@@ -38,6 +38,8 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/mempool.h"
 #include "bacnet/bacdevobjpropref.h"
 #include "bacnet/basic/object/trendlog.h"
 #include "bacnet/datetime.h"
@@ -49,9 +51,20 @@
 #ifndef MAX_TREND_LOGS
 #define MAX_TREND_LOGS 8
 #endif
+/* number of objects allocated from the heap at a time - each object
+   holds TL_MAX_ENTRIES log records */
+#ifndef TREND_LOG_POOL_SLAB_SIZE
+#define TREND_LOG_POOL_SLAB_SIZE 8
+#endif
 
-static TL_DATA_REC Logs[MAX_TREND_LOGS][TL_MAX_ENTRIES];
-static TL_LOG_INFO LogInfo[MAX_TREND_LOGS];
+struct object_data {
+    TL_LOG_INFO Info;
+    TL_DATA_REC Logs[TL_MAX_ENTRIES];
+};
+/* Key List for storing the object data sorted by instance number  */
+static OS_Keylist Object_List;
+/* storage for the object data */
+static MEMPOOL Object_Pool;
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int Trend_Log_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
@@ -98,45 +111,53 @@ void Trend_Log_Property_Lists(
     return;
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need validate that the */
-/* given instance exists */
+/**
+ * @brief Determines if a given object instance is valid
+ * @param  object_instance - object-instance number of the object
+ * @return  true if the instance is valid, and false if not
+ */
 bool Trend_Log_Valid_Instance(uint32_t object_instance)
 {
-    if (object_instance < MAX_TREND_LOGS) {
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
         return true;
     }
 
     return false;
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then count how many you have */
+/**
+ * @brief Determines the number of objects
+ * @return  Number of objects
+ */
 unsigned Trend_Log_Count(void)
 {
-    return MAX_TREND_LOGS;
+    return Keylist_Count(Object_List);
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need to return the instance */
-/* that correlates to the correct index */
+/**
+ * @brief Determines the object instance-number for a given 0..N index
+ * of objects where N is Trend_Log_Count().
+ * @param  index - 0..N where N is Trend_Log_Count().
+ * @return  object instance-number for the given index
+ */
 uint32_t Trend_Log_Index_To_Instance(unsigned index)
 {
-    return index;
+    return Keylist_Key(Object_List, index);
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need to return the index */
-/* that correlates to the correct instance number */
+/**
+ * @brief For a given object instance-number, determines a 0..N index
+ * of objects where N is Trend_Log_Count().
+ * @param  object_instance - object-instance number of the object
+ * @return  index for the given instance-number, or UINT_MAX
+ * (the unsigned -1 from Keylist_Index) if not valid.
+ */
 unsigned Trend_Log_Instance_To_Index(uint32_t object_instance)
 {
-    unsigned index = MAX_TREND_LOGS;
-
-    if (object_instance < MAX_TREND_LOGS) {
-        index = object_instance;
-    }
-
-    return index;
+    return Keylist_Index(Object_List, object_instance);
 }
 
 /**
@@ -151,108 +172,14 @@ static bacnet_time_t Trend_Log_Epoch_Seconds_Now(void)
     return datetime_seconds_since_epoch(&bdatetime);
 }
 
-/*
- * Things to do when starting up the stack for Trend Logs.
- * Should be called whenever we reset the device or power it up
- */
-void Trend_Log_Init(void)
-{
-    static bool initialized = false;
-    int iLog;
-    int iEntry;
-    BACNET_DATE_TIME bdatetime = { 0 };
-    bacnet_time_t tClock;
-    uint8_t month;
-
-    if (!initialized) {
-        initialized = true;
-
-        /* initialize all the values */
-
-        for (iLog = 0; iLog < MAX_TREND_LOGS; iLog++) {
-            /*
-             * Do we need to do anything here?
-             * Trend logs are usually assumed to survive over resets
-             * and are frequently implemented using Battery Backed RAM
-             * If they are implemented using Flash or SD cards or some
-             * such mechanism there may be some RAM based setup needed
-             * for log management purposes.
-             * We probably need to look at inserting LOG_INTERRUPTED
-             * entries into any active logs if the power down or reset
-             * may have caused us to miss readings.
-             */
-
-            /* We will just fill the logs with some entries for testing
-             * purposes.
-             */
-            /* Different month for each log */
-            month = iLog + 1;
-            datetime_set_values(&bdatetime, 2009, month, 1, 0, 0, 0, 0);
-            tClock = datetime_seconds_since_epoch(&bdatetime);
-            for (iEntry = 0; iEntry < TL_MAX_ENTRIES; iEntry++) {
-                Logs[iLog][iEntry].tTimeStamp = tClock;
-                Logs[iLog][iEntry].ucRecType = TL_TYPE_REAL;
-                Logs[iLog][iEntry].Datum.fReal =
-                    (float)(iEntry + (iLog * TL_MAX_ENTRIES));
-                /* Put status flags with every second log */
-                if ((iLog & 1) == 0) {
-                    Logs[iLog][iEntry].ucStatus = 128;
-                } else {
-                    Logs[iLog][iEntry].ucStatus = 0;
-                }
-                /* advance 15 minutes, in seconds */
-                tClock += 900;
-            }
-
-            LogInfo[iLog].tLastDataTime = tClock - 900;
-            LogInfo[iLog].bAlignIntervals = true;
-            LogInfo[iLog].bEnable = true;
-            LogInfo[iLog].bStopWhenFull = false;
-            LogInfo[iLog].bTrigger = false;
-            LogInfo[iLog].LoggingType = LOGGING_TYPE_POLLED;
-            LogInfo[iLog].Source.arrayIndex = 0;
-            LogInfo[iLog].ucTimeFlags = 0;
-            LogInfo[iLog].ulIntervalOffset = 0;
-            LogInfo[iLog].iIndex = 0;
-            LogInfo[iLog].ulLogInterval = 900;
-            LogInfo[iLog].ulRecordCount = TL_MAX_ENTRIES;
-            LogInfo[iLog].ulTotalRecordCount = 10000;
-
-            LogInfo[iLog].Source.deviceIdentifier.instance =
-                Device_Object_Instance_Number();
-            LogInfo[iLog].Source.deviceIdentifier.type = OBJECT_DEVICE;
-            LogInfo[iLog].Source.objectIdentifier.instance = iLog;
-            LogInfo[iLog].Source.objectIdentifier.type = OBJECT_ANALOG_INPUT;
-            LogInfo[iLog].Source.arrayIndex = BACNET_ARRAY_ALL;
-            LogInfo[iLog].Source.propertyIdentifier = PROP_PRESENT_VALUE;
-
-            datetime_set_values(
-                &LogInfo[iLog].StartTime, 2009, 1, 1, 0, 0, 0, 0);
-            LogInfo[iLog].tStartTime =
-                TL_BAC_Time_To_Local(&LogInfo[iLog].StartTime);
-            datetime_set_values(
-                &LogInfo[iLog].StopTime, 2020, 12, 22, 23, 59, 59, 99);
-            LogInfo[iLog].tStopTime =
-                TL_BAC_Time_To_Local(&LogInfo[iLog].StopTime);
-        }
-    }
-
-    return;
-}
-
-/*
- * Note: we use the instance number here and build the name based
- * on the assumption that there is a 1 to 1 correspondence. If there
- * is not we need to convert to index before proceeding.
- */
 bool Trend_Log_Object_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
     static char text_string[32] = ""; /* okay for single thread */
     bool status = false;
 
-    if (object_instance < MAX_TREND_LOGS) {
-        sprintf(text_string, "Trend Log %u", object_instance);
+    if (Trend_Log_Valid_Instance(object_instance)) {
+        sprintf(text_string, "Trend Log %lu", (unsigned long)object_instance);
         status = characterstring_init_ansi(object_name, text_string);
     }
 
@@ -267,6 +194,7 @@ int Trend_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     int len = 0; /* apdu len intermediate value */
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
+    struct object_data *pObject;
     TL_LOG_INFO *CurrentLog;
     uint8_t *apdu = NULL;
 
@@ -275,8 +203,14 @@ int Trend_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
         return 0;
     }
     apdu = rpdata->application_data;
-    CurrentLog = &LogInfo[Trend_Log_Instance_To_Index(
-        rpdata->object_instance)]; /* Pin down which log to look at */
+    /* Pin down which log to look at */
+    pObject = Keylist_Data(Object_List, rpdata->object_instance);
+    if (!pObject) {
+        rpdata->error_class = ERROR_CLASS_OBJECT;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return BACNET_STATUS_ERROR;
+    }
+    CurrentLog = &pObject->Info;
     switch (rpdata->object_property) {
         case PROP_OBJECT_IDENTIFIER:
             apdu_len = encode_application_object_id(
@@ -429,6 +363,7 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     bool status = false; /* return value */
     int len = 0;
     BACNET_APPLICATION_DATA_VALUE value;
+    struct object_data *pObject;
     TL_LOG_INFO *CurrentLog;
     BACNET_DATE start_date, stop_date;
     BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE TempSource;
@@ -436,8 +371,14 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     int log_index;
 
     /* Pin down which log to look at */
+    pObject = Keylist_Data(Object_List, wp_data->object_instance);
+    if (!pObject) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
     log_index = Trend_Log_Instance_To_Index(wp_data->object_instance);
-    CurrentLog = &LogInfo[log_index];
+    CurrentLog = &pObject->Info;
 
     /* decode the some of the request */
     len = bacapp_decode_application_data(
@@ -796,10 +737,7 @@ bool TrendLogGetRRInfo(
     BACNET_READ_RANGE_DATA *pRequest, /* Info on the request */
     RR_PROP_INFO *pInfo)
 { /* Where to put the information */
-    int log_index;
-
-    log_index = Trend_Log_Instance_To_Index(pRequest->object_instance);
-    if (log_index >= MAX_TREND_LOGS) {
+    if (!Trend_Log_Valid_Instance(pRequest->object_instance)) {
         pRequest->error_class = ERROR_CLASS_OBJECT;
         pRequest->error_code = ERROR_CODE_UNKNOWN_OBJECT;
     } else if (pRequest->object_property == PROP_LOG_BUFFER) {
@@ -823,10 +761,15 @@ bool TrendLogGetRRInfo(
 
 void TL_Insert_Status_Rec(int iLog, BACNET_LOG_STATUS eStatus, bool bState)
 {
+    struct object_data *pObject;
     TL_LOG_INFO *CurrentLog;
     TL_DATA_REC TempRec;
 
-    CurrentLog = &LogInfo[iLog];
+    pObject = Keylist_Data_Index(Object_List, iLog);
+    if (!pObject) {
+        return;
+    }
+    CurrentLog = &pObject->Info;
 
     TempRec.tTimeStamp = Trend_Log_Epoch_Seconds_Now();
     TempRec.ucRecType = TL_TYPE_STATUS;
@@ -852,7 +795,7 @@ void TL_Insert_Status_Rec(int iLog, BACNET_LOG_STATUS eStatus, bool bState)
             break;
     }
 
-    Logs[iLog][CurrentLog->iIndex++] = TempRec;
+    pObject->Logs[CurrentLog->iIndex++] = TempRec;
     if (CurrentLog->iIndex >= TL_MAX_ENTRIES) {
         CurrentLog->iIndex = 0;
     }
@@ -871,12 +814,17 @@ void TL_Insert_Status_Rec(int iLog, BACNET_LOG_STATUS eStatus, bool bState)
 
 bool TL_Is_Enabled(int iLog)
 {
+    struct object_data *pObject;
     TL_LOG_INFO *CurrentLog;
     bacnet_time_t tNow;
     bool bStatus;
 
+    pObject = Keylist_Data_Index(Object_List, iLog);
+    if (!pObject) {
+        return false;
+    }
     bStatus = true;
-    CurrentLog = &LogInfo[iLog];
+    CurrentLog = &pObject->Info;
 #if 0
     printf("\nFlags - %u, Start - %u, Stop - %u\n",
         (unsigned int) CurrentLog->ucTimeFlags,
@@ -967,6 +915,8 @@ void TL_Local_Time_To_BAC(BACNET_DATE_TIME *bdatetime, bacnet_time_t seconds)
 
 int rr_trend_log_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 {
+    struct object_data *pObject;
+
     /* Initialise result flags to all false */
     bitstring_init(&pRequest->ResultFlags);
     bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, false);
@@ -975,8 +925,8 @@ int rr_trend_log_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     pRequest->ItemCount = 0; /* Start out with nothing */
 
     /* Bail out now if nowt - should never happen for a Trend Log but ... */
-    if (LogInfo[Trend_Log_Instance_To_Index(pRequest->object_instance)]
-            .ulRecordCount == 0) {
+    pObject = Keylist_Data(Object_List, pRequest->object_instance);
+    if (!pObject || (pObject->Info.ulRecordCount == 0)) {
         return (0);
     }
 
@@ -1001,6 +951,7 @@ int TL_encode_by_position(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     int log_index = 0;
     int iLen = 0;
     int32_t iTemp = 0;
+    struct object_data *pObject;
     TL_LOG_INFO *CurrentLog = NULL;
 
     uint32_t uiIndex = 0; /* Current entry number */
@@ -1012,7 +963,11 @@ int TL_encode_by_position(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     /* See how much space we have */
     uiRemaining = MAX_APDU - pRequest->Overhead;
     log_index = Trend_Log_Instance_To_Index(pRequest->object_instance);
-    CurrentLog = &LogInfo[log_index];
+    pObject = Keylist_Data_Index(Object_List, log_index);
+    if (!pObject) {
+        return (0);
+    }
+    CurrentLog = &pObject->Info;
     if (pRequest->RequestType == RR_READ_ALL) {
         /*
          * Read all the list or as much as will fit in the buffer by selecting
@@ -1112,6 +1067,7 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     int log_index = 0;
     int iLen = 0;
     int32_t iTemp = 0;
+    struct object_data *pObject;
     TL_LOG_INFO *CurrentLog = NULL;
 
     uint32_t uiIndex = 0; /* Current entry number */
@@ -1131,7 +1087,11 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     /* See how much space we have */
     uiRemaining = MAX_APDU - pRequest->Overhead;
     log_index = Trend_Log_Instance_To_Index(pRequest->object_instance);
-    CurrentLog = &LogInfo[log_index];
+    pObject = Keylist_Data_Index(Object_List, log_index);
+    if (!pObject) {
+        return (0);
+    }
+    CurrentLog = &pObject->Info;
     /* Figure out the sequence number for the first record, last is
      * ulTotalRecordCount */
     uiFirstSeq =
@@ -1264,6 +1224,7 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     int log_index = 0;
     int iLen = 0;
     int32_t iTemp = 0;
+    struct object_data *pObject;
     int iCount = 0;
     TL_LOG_INFO *CurrentLog = NULL;
 
@@ -1277,7 +1238,11 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     /* See how much space we have */
     uiRemaining = MAX_APDU - pRequest->Overhead;
     log_index = Trend_Log_Instance_To_Index(pRequest->object_instance);
-    CurrentLog = &LogInfo[log_index];
+    pObject = Keylist_Data_Index(Object_List, log_index);
+    if (!pObject) {
+        return (0);
+    }
+    CurrentLog = &pObject->Info;
 
     tRefTime = TL_BAC_Time_To_Local(&pRequest->Range.RefTime);
     /* Find correct position for oldest entry in log */
@@ -1295,9 +1260,8 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
         /* Start out with the sequence number for the last record */
         uiFirstSeq = CurrentLog->ulTotalRecordCount;
         for (;;) {
-            if (Logs[pRequest->object_instance]
-                    [(uiIndex + iCount) % TL_MAX_ENTRIES]
-                        .tTimeStamp < tRefTime) {
+            if (pObject->Logs[(uiIndex + iCount) % TL_MAX_ENTRIES]
+                    .tTimeStamp < tRefTime) {
                 break;
             }
 
@@ -1337,9 +1301,8 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
         uiFirstSeq =
             CurrentLog->ulTotalRecordCount - (CurrentLog->ulRecordCount - 1);
         for (;;) {
-            if (Logs[pRequest->object_instance]
-                    [(uiIndex + iCount) % TL_MAX_ENTRIES]
-                        .tTimeStamp > tRefTime) {
+            if (pObject->Logs[(uiIndex + iCount) % TL_MAX_ENTRIES]
+                    .tTimeStamp > tRefTime) {
                 break;
             }
 
@@ -1400,6 +1363,7 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 int TL_encode_entry(uint8_t *apdu, int iLog, int iEntry)
 {
     int iLen = 0;
+    struct object_data *pObject;
     TL_DATA_REC *pSource = NULL;
     BACNET_BIT_STRING TempBits;
     uint8_t ucCount = 0;
@@ -1408,11 +1372,15 @@ int TL_encode_entry(uint8_t *apdu, int iLog, int iEntry)
     /* Convert from BACnet 1 based to 0 based array index and then
      * handle wrap around of the circular buffer */
 
-    if (LogInfo[iLog].ulRecordCount < TL_MAX_ENTRIES) {
-        pSource = &Logs[iLog][(iEntry - 1) % TL_MAX_ENTRIES];
+    pObject = Keylist_Data_Index(Object_List, iLog);
+    if (!pObject) {
+        return 0;
+    }
+    if (pObject->Info.ulRecordCount < TL_MAX_ENTRIES) {
+        pSource = &pObject->Logs[(iEntry - 1) % TL_MAX_ENTRIES];
     } else {
-        pSource =
-            &Logs[iLog][(LogInfo[iLog].iIndex + iEntry - 1) % TL_MAX_ENTRIES];
+        pSource = &pObject->Logs[(pObject->Info.iIndex + iEntry - 1) %
+            TL_MAX_ENTRIES];
     }
 
     iLen = 0;
@@ -1577,8 +1545,13 @@ static void TL_fetch_property(int iLog)
     uint32_t len_value_type = 0;
     BACNET_BIT_STRING TempBits;
     BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    struct object_data *pObject;
 
-    CurrentLog = &LogInfo[iLog];
+    pObject = Keylist_Data_Index(Object_List, iLog);
+    if (!pObject) {
+        return;
+    }
+    CurrentLog = &pObject->Info;
 
     /* Record the current time in the log entry and also in the info block
      * for the log so we can figure out when the next reading is due */
@@ -1587,7 +1560,7 @@ static void TL_fetch_property(int iLog)
     TempRec.ucStatus = 0;
 
     iLen = local_read_property(
-        ValueBuf, StatusBuf, &LogInfo[iLog].Source, &error_class, &error_code);
+        ValueBuf, StatusBuf, &CurrentLog->Source, &error_class, &error_code);
     if (iLen < 0) {
         /* Insert error code into log */
         TempRec.Datum.Error.usClass = error_class;
@@ -1673,7 +1646,7 @@ static void TL_fetch_property(int iLog)
         TempRec.ucStatus = 128 | bitstring_octet(&TempBits, 0);
     }
 
-    Logs[iLog][CurrentLog->iIndex++] = TempRec;
+    pObject->Logs[CurrentLog->iIndex++] = TempRec;
     if (CurrentLog->iIndex >= TL_MAX_ENTRIES) {
         CurrentLog->iIndex = 0;
     }
@@ -1691,6 +1664,7 @@ static void TL_fetch_property(int iLog)
 
 void trend_log_timer(uint16_t uSeconds)
 {
+    struct object_data *pObject;
     TL_LOG_INFO *CurrentLog = NULL;
     int iCount = 0;
     bacnet_time_t tNow = 0;
@@ -1698,8 +1672,9 @@ void trend_log_timer(uint16_t uSeconds)
     (void)uSeconds;
     /* use OS to get the current time */
     tNow = Trend_Log_Epoch_Seconds_Now();
-    for (iCount = 0; iCount < MAX_TREND_LOGS; iCount++) {
-        CurrentLog = &LogInfo[iCount];
+    for (iCount = 0; iCount < Keylist_Count(Object_List); iCount++) {
+        pObject = Keylist_Data_Index(Object_List, iCount);
+        CurrentLog = &pObject->Info;
         if (TL_Is_Enabled(iCount)) {
             if (CurrentLog->LoggingType == LOGGING_TYPE_POLLED) {
                 /* For polled logs we first need to see if they are clock
@@ -1755,3 +1730,165 @@ void trend_log_timer(uint16_t uSeconds)
         }
     }
 }
+
+/**
+ * @brief Creates a Trend Log object, with an empty log buffer
+ * @param object_instance - object-instance number of the object
+ * @return true if the object was created
+ */
+bool Trend_Log_Create(uint32_t object_instance)
+{
+    bool status = false;
+    struct object_data *pObject = NULL;
+    TL_LOG_INFO *CurrentLog;
+    int index = 0;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        pObject = Mempool_Alloc(&Object_Pool);
+        if (pObject) {
+            CurrentLog = &pObject->Info;
+            memset(CurrentLog, 0, sizeof(TL_LOG_INFO));
+            CurrentLog->bAlignIntervals = true;
+            CurrentLog->bEnable = true;
+            CurrentLog->bStopWhenFull = false;
+            CurrentLog->bTrigger = false;
+            CurrentLog->LoggingType = LOGGING_TYPE_POLLED;
+            CurrentLog->ucTimeFlags = 0;
+            CurrentLog->ulIntervalOffset = 0;
+            CurrentLog->iIndex = 0;
+            CurrentLog->ulLogInterval = 900;
+            CurrentLog->ulRecordCount = 0;
+            CurrentLog->ulTotalRecordCount = 0;
+            CurrentLog->Source.deviceIdentifier.instance =
+                Device_Object_Instance_Number();
+            CurrentLog->Source.deviceIdentifier.type = OBJECT_DEVICE;
+            CurrentLog->Source.objectIdentifier.instance = object_instance;
+            CurrentLog->Source.objectIdentifier.type = OBJECT_ANALOG_INPUT;
+            CurrentLog->Source.arrayIndex = BACNET_ARRAY_ALL;
+            CurrentLog->Source.propertyIdentifier = PROP_PRESENT_VALUE;
+            datetime_set_values(
+                &CurrentLog->StartTime, 2009, 1, 1, 0, 0, 0, 0);
+            CurrentLog->tStartTime =
+                TL_BAC_Time_To_Local(&CurrentLog->StartTime);
+            datetime_set_values(
+                &CurrentLog->StopTime, 2020, 12, 22, 23, 59, 59, 99);
+            CurrentLog->tStopTime = TL_BAC_Time_To_Local(&CurrentLog->StopTime);
+            /* add to list */
+            index = Keylist_Data_Add(Object_List, object_instance, pObject);
+            if (index >= 0) {
+                status = true;
+                Device_Inc_Database_Revision();
+            } else {
+                Mempool_Free(&Object_Pool, pObject);
+            }
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes a Trend Log object and its log buffer
+ * @param object_instance - object-instance number of the object
+ * @return true if the object was deleted
+ */
+bool Trend_Log_Delete(uint32_t object_instance)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Keylist_Data_Delete(Object_List, object_instance);
+    if (pObject) {
+        Mempool_Free(&Object_Pool, pObject);
+        status = true;
+        Device_Inc_Database_Revision();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes all the Trend Log objects and their storage
+ */
+void Trend_Log_Cleanup(void)
+{
+    if (Object_List) {
+        if (Keylist_Count(Object_List) > 0) {
+            Device_Inc_Database_Revision();
+        }
+        while (Keylist_Data_Pop(Object_List)) {
+            /* the object data is freed with the pool */
+        }
+        Keylist_Delete(Object_List);
+        Object_List = NULL;
+    }
+    Mempool_Cleanup(&Object_Pool);
+}
+
+/*
+ * Things to do when starting up the stack for Trend Logs.
+ * Should be called whenever we reset the device or power it up
+ */
+void Trend_Log_Init(void)
+{
+    struct object_data *pObject;
+    int iLog;
+    int iEntry;
+    BACNET_DATE_TIME bdatetime = { 0 };
+    bacnet_time_t tClock;
+    uint8_t month;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+        Mempool_Init(&Object_Pool, sizeof(struct object_data),
+            TREND_LOG_POOL_SLAB_SIZE);
+
+        /* create the default objects */
+
+        for (iLog = 0; iLog < MAX_TREND_LOGS; iLog++) {
+            if (!Trend_Log_Create(iLog)) {
+                continue;
+            }
+            pObject = Keylist_Data(Object_List, iLog);
+            /*
+             * Do we need to do anything here?
+             * Trend logs are usually assumed to survive over resets
+             * and are frequently implemented using Battery Backed RAM
+             * If they are implemented using Flash or SD cards or some
+             * such mechanism there may be some RAM based setup needed
+             * for log management purposes.
+             * We probably need to look at inserting LOG_INTERRUPTED
+             * entries into any active logs if the power down or reset
+             * may have caused us to miss readings.
+             */
+
+            /* We will just fill the logs with some entries for testing
+             * purposes.
+             */
+            /* Different month for each log */
+            month = iLog + 1;
+            datetime_set_values(&bdatetime, 2009, month, 1, 0, 0, 0, 0);
+            tClock = datetime_seconds_since_epoch(&bdatetime);
+            for (iEntry = 0; iEntry < TL_MAX_ENTRIES; iEntry++) {
+                pObject->Logs[iEntry].tTimeStamp = tClock;
+                pObject->Logs[iEntry].ucRecType = TL_TYPE_REAL;
+                pObject->Logs[iEntry].Datum.fReal =
+                    (float)(iEntry + (iLog * TL_MAX_ENTRIES));
+                /* Put status flags with every second log */
+                if ((iLog & 1) == 0) {
+                    pObject->Logs[iEntry].ucStatus = 128;
+                } else {
+                    pObject->Logs[iEntry].ucStatus = 0;
+                }
+                /* advance 15 minutes, in seconds */
+                tClock += 900;
+            }
+            pObject->Info.tLastDataTime = tClock - 900;
+            pObject->Info.ulRecordCount = TL_MAX_ENTRIES;
+            pObject->Info.ulTotalRecordCount = 10000;
+        }
+    }
+
+    return;
+}
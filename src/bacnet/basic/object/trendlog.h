@@ -159,6 +159,15 @@ extern "C" {
     bool Trend_Log_Write_Property(
         BACNET_WRITE_PROPERTY_DATA * wp_data);
     BACNET_STACK_EXPORT
+    bool Trend_Log_Create(
+        uint32_t object_instance);
+    BACNET_STACK_EXPORT
+    bool Trend_Log_Delete(
+        uint32_t object_instance);
+    BACNET_STACK_EXPORT
+    void Trend_Log_Cleanup(
+        void);
+    BACNET_STACK_EXPORT
     void Trend_Log_Init(
         void);
 
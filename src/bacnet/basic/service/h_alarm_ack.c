@@ -42,6 +42,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_alarm_ack.c  Handles Alarm Acknowledgment. */
@@ -79,9 +80,7 @@ void handler_alarm_ack(uint8_t *service_request,
 {
     int len = 0;
     int pdu_len = 0;
-#if PRINT_ENABLED
     int bytes_sent = 0;
-#endif
     int ack_result = 0;
     BACNET_ADDRESS my_address;
     BACNET_NPDU_DATA npdu_data;
@@ -184,11 +183,11 @@ void handler_alarm_ack(uint8_t *service_request,
 
 AA_ABORT:
     pdu_len += len;
-#if PRINT_ENABLED
-    bytes_sent =
-#endif
-        datalink_send_pdu(
-            src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bytes_sent = datalink_send_pdu(
+        src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    }
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(stderr,
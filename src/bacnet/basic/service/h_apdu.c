@@ -46,6 +46,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 
 /** @file apdu.c  Handles APDU services */
 
@@ -568,6 +569,9 @@ void apdu_handler(BACNET_ADDRESS *src,
     BACNET_ERROR_CLASS error_class = ERROR_CLASS_SERVICES;
     uint8_t reason = 0;
     bool server = false;
+#if defined(BACNET_METRICS)
+    unsigned long timestamp = 0;
+#endif
 
     if (apdu) {
         /* PDU Type */
@@ -578,6 +582,7 @@ void apdu_handler(BACNET_ADDRESS *src,
                     &service_request_len);
                 if (len == 0) {
                     /* service data unable to be decoded - simply drop */
+                    METRICS_COUNT(METRICS_APDU_DROPPED);
                     break;
                 }
                 if (apdu_confirmed_dcc_disabled(service_choice)) {
@@ -585,12 +590,19 @@ void apdu_handler(BACNET_ADDRESS *src,
                        only DeviceCommunicationControl and ReinitializeDevice
                        APDUs shall be processed and no messages shall be
                        initiated. */
+                    METRICS_COUNT(METRICS_APDU_DROPPED);
                     break;
                 }
                 if ((service_choice < MAX_BACNET_CONFIRMED_SERVICE) &&
                     (Confirmed_Function[service_choice])) {
+#if defined(BACNET_METRICS)
+                    timestamp = metrics_timestamp();
+#endif
                     Confirmed_Function[service_choice](service_request,
                         service_request_len, src, &service_data);
+#if defined(BACNET_METRICS)
+                    metrics_service_record(true, service_choice, timestamp);
+#endif
                 } else if (Unrecognized_Service_Handler) {
                     Unrecognized_Service_Handler(service_request,
                         service_request_len, src, &service_data);
@@ -598,6 +610,7 @@ void apdu_handler(BACNET_ADDRESS *src,
                 break;
             case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
                 if (apdu_len < 2) {
+                    METRICS_COUNT(METRICS_APDU_DROPPED);
                     break;
                 }
                 service_choice = apdu[1];
@@ -610,12 +623,20 @@ void apdu_handler(BACNET_ADDRESS *src,
                         messages shall be initiated. If communications have
                         been initiation disabled, then WhoIs may be
                         processed. */
+                    METRICS_COUNT(METRICS_APDU_DROPPED);
                     break;
                 }
                 if (service_choice < MAX_BACNET_UNCONFIRMED_SERVICE) {
                     if (Unconfirmed_Function[service_choice]) {
+#if defined(BACNET_METRICS)
+                        timestamp = metrics_timestamp();
+#endif
                         Unconfirmed_Function[service_choice](
                             service_request, service_request_len, src);
+#if defined(BACNET_METRICS)
+                        metrics_service_record(
+                            false, service_choice, timestamp);
+#endif
                     }
                 }
                 break;
@@ -672,6 +693,7 @@ void apdu_handler(BACNET_ADDRESS *src,
                 if (apdu_len < 3) {
                     break;
                 }
+                METRICS_COUNT(METRICS_APDU_ERROR_RX);
                 invoke_id = apdu[1];
                 service_choice = apdu[2];
                 if (apdu_complex_error(service_choice)) {
@@ -696,6 +718,7 @@ void apdu_handler(BACNET_ADDRESS *src,
                 if (apdu_len < 3) {
                     break;
                 }
+                METRICS_COUNT(METRICS_APDU_REJECT_RX);
                 invoke_id = apdu[1];
                 reason = apdu[2];
                 if (Reject_Function) {
@@ -707,6 +730,7 @@ void apdu_handler(BACNET_ADDRESS *src,
                 if (apdu_len < 3) {
                     break;
                 }
+                METRICS_COUNT(METRICS_APDU_ABORT_RX);
                 server = apdu[0] & 0x01;
                 invoke_id = apdu[1];
                 reason = apdu[2];
@@ -41,6 +41,7 @@
 #endif
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_arf.c  Handles Atomic Read File request. */
@@ -204,6 +205,9 @@ ARF_ABORT:
     pdu_len += len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    }
 #if PRINT_ENABLED
     if (bytes_sent <= 0) {
         fprintf(stderr, "Failed to send PDU (%s)!\n", strerror(errno));
@@ -40,6 +40,7 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
 
 /** @file h_ccov.c  Handles Confirmed COV Notifications. */
 #define PRINTF debug_perror
@@ -179,7 +180,9 @@ CCOV_ABORT:
     pdu_len += len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
-    if (bytes_sent <= 0) {
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    } else {
         PRINTF("CCOV: Failed to send PDU (%s)!\n", strerror(errno));
     }
     (void)bytes_sent;
@@ -45,6 +45,7 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 #ifndef MAX_COV_PROPERTIES
@@ -78,11 +79,30 @@ typedef struct BACnet_COV_Subscription {
 #ifndef MAX_COV_SUBCRIPTIONS
 #define MAX_COV_SUBCRIPTIONS 128
 #endif
-static BACNET_COV_SUBSCRIPTION COV_Subscriptions[MAX_COV_SUBCRIPTIONS];
 #ifndef MAX_COV_ADDRESSES
 #define MAX_COV_ADDRESSES 16
 #endif
-static BACNET_COV_ADDRESS COV_Addresses[MAX_COV_ADDRESSES];
+
+/* states for transmitting */
+typedef enum {
+    COV_STATE_IDLE = 0,
+    COV_STATE_MARK,
+    COV_STATE_CLEAR,
+    COV_STATE_FREE,
+    COV_STATE_SEND
+} BACNET_COV_TASK_STATE;
+
+struct cov_context {
+    BACNET_COV_SUBSCRIPTION Subscriptions[MAX_COV_SUBCRIPTIONS];
+    BACNET_COV_ADDRESS Addresses[MAX_COV_ADDRESSES];
+    BACNET_COV_TASK_STATE Task_State;
+    int Task_Index;
+};
+static struct cov_context COV_Default;
+/* the COV subscriptions of the selected stack context */
+static struct cov_context *COV = &COV_Default;
+/* the next subscription that is checked for a restored snapshot record */
+static unsigned COV_Snapshot_Index;
 
 /**
  * Gets the address from the list of COV addresses
@@ -97,8 +117,8 @@ static BACNET_ADDRESS *cov_address_get(unsigned index)
     BACNET_ADDRESS *cov_dest = NULL;
 
     if (index < MAX_COV_ADDRESSES) {
-        if (COV_Addresses[index].valid) {
-            cov_dest = &COV_Addresses[index].dest;
+        if (COV->Addresses[index].valid) {
+            cov_dest = &COV->Addresses[index].dest;
         }
     }
 
@@ -116,17 +136,17 @@ static void cov_address_remove_unused(void)
     bool found = false;
 
     for (cov_index = 0; cov_index < MAX_COV_ADDRESSES; cov_index++) {
-        if (COV_Addresses[cov_index].valid) {
+        if (COV->Addresses[cov_index].valid) {
             found = false;
             for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-                if ((COV_Subscriptions[index].flag.valid) &&
-                    (COV_Subscriptions[index].dest_index == cov_index)) {
+                if ((COV->Subscriptions[index].flag.valid) &&
+                    (COV->Subscriptions[index].dest_index == cov_index)) {
                     found = true;
                     break;
                 }
             }
             if (!found) {
-                COV_Addresses[cov_index].valid = false;
+                COV->Addresses[cov_index].valid = false;
             }
         }
     }
@@ -149,9 +169,9 @@ static int cov_address_add(BACNET_ADDRESS *dest)
 
     if (dest) {
         for (i = 0; i < MAX_COV_ADDRESSES; i++) {
-            valid = COV_Addresses[i].valid;
+            valid = COV->Addresses[i].valid;
             if (valid) {
-                cov_dest = &COV_Addresses[i].dest;
+                cov_dest = &COV->Addresses[i].dest;
                 found = bacnet_address_same(dest, cov_dest);
                 if (found) {
                     index = i;
@@ -162,12 +182,12 @@ static int cov_address_add(BACNET_ADDRESS *dest)
         if (!found) {
             /* find a free place to add a new address */
             for (i = 0; i < MAX_COV_ADDRESSES; i++) {
-                valid = COV_Addresses[i].valid;
+                valid = COV->Addresses[i].valid;
                 if (!valid) {
                     index = i;
-                    cov_dest = &COV_Addresses[i].dest;
+                    cov_dest = &COV->Addresses[i].dest;
                     bacnet_address_copy(cov_dest, dest);
-                    COV_Addresses[i].valid = true;
+                    COV->Addresses[i].valid = true;
                     break;
                 }
             }
@@ -301,9 +321,9 @@ int handler_cov_encode_subscriptions(uint8_t *apdu, int max_apdu)
 
     if (apdu) {
         for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-            if (COV_Subscriptions[index].flag.valid) {
+            if (COV->Subscriptions[index].flag.valid) {
                 len = cov_encode_subscription(&apdu[apdu_len],
-                    max_apdu - apdu_len, &COV_Subscriptions[index]);
+                    max_apdu - apdu_len, &COV->Subscriptions[index]);
                 apdu_len += len;
                 /* TODO: too late here to notice that we overran the buffer */
                 if (apdu_len > max_apdu) {
@@ -325,20 +345,169 @@ void handler_cov_init(void)
 
     for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
         /* initialize with invalid COV address */
-        COV_Subscriptions[index].flag.valid = false;
-        COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
-        COV_Subscriptions[index].subscriberProcessIdentifier = 0;
-        COV_Subscriptions[index].monitoredObjectIdentifier.type =
+        COV->Subscriptions[index].flag.valid = false;
+        COV->Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
+        COV->Subscriptions[index].subscriberProcessIdentifier = 0;
+        COV->Subscriptions[index].monitoredObjectIdentifier.type =
             OBJECT_ANALOG_INPUT;
-        COV_Subscriptions[index].monitoredObjectIdentifier.instance = 0;
-        COV_Subscriptions[index].flag.issueConfirmedNotifications = false;
-        COV_Subscriptions[index].invokeID = 0;
-        COV_Subscriptions[index].lifetime = 0;
-        COV_Subscriptions[index].flag.send_requested = false;
+        COV->Subscriptions[index].monitoredObjectIdentifier.instance = 0;
+        COV->Subscriptions[index].flag.issueConfirmedNotifications = false;
+        COV->Subscriptions[index].invokeID = 0;
+        COV->Subscriptions[index].lifetime = 0;
+        COV->Subscriptions[index].flag.send_requested = false;
     }
     for (index = 0; index < MAX_COV_ADDRESSES; index++) {
-        COV_Addresses[index].valid = false;
+        COV->Addresses[index].valid = false;
+    }
+}
+
+/**
+ * @brief Get the size of the COV subscriptions of one stack context
+ * @return size of the COV subscriptions, in bytes
+ */
+size_t handler_cov_context_size(void)
+{
+    return sizeof(struct cov_context);
+}
+
+/**
+ * @brief Initialize the COV subscriptions of a stack context
+ * @param context - memory of handler_cov_context_size() bytes
+ */
+void handler_cov_context_init(void *context)
+{
+    struct cov_context *pContext = context;
+    unsigned index = 0;
+
+    if (pContext) {
+        memset(pContext, 0, sizeof(struct cov_context));
+        for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
+            /* initialize with invalid COV address */
+            pContext->Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
+            pContext->Subscriptions[index].monitoredObjectIdentifier.type =
+                OBJECT_ANALOG_INPUT;
+        }
+    }
+}
+
+/**
+ * @brief Select the COV subscriptions used by the COV handlers
+ * @param context - COV subscriptions from handler_cov_context_init(),
+ *  or NULL to select the default COV subscriptions
+ * @return the previously selected COV subscriptions, or NULL for the default
+ */
+void *handler_cov_context_select(void *context)
+{
+    struct cov_context *previous = COV;
+
+    if (context) {
+        COV = context;
+    } else {
+        COV = &COV_Default;
+    }
+
+    return (previous == &COV_Default) ? NULL : previous;
+}
+
+/**
+ * @brief Get the number of COV subscriptions for a warm start snapshot
+ * @return number of subscriptions, some of which might not be valid
+ */
+uint32_t handler_cov_snapshot_count(void)
+{
+    return MAX_COV_SUBCRIPTIONS;
+}
+
+/**
+ * @brief Encode a COV subscription as a warm start snapshot record
+ * @param index - subscription 0..handler_cov_snapshot_count()-1
+ * @param record - [out] HANDLER_COV_SNAPSHOT_RECORD_SIZE bytes
+ * @return true if the subscription was encoded
+ */
+bool handler_cov_snapshot_encode(uint32_t index, uint8_t *record)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription;
+    BACNET_ADDRESS *dest;
+
+    if (!record || (index >= MAX_COV_SUBCRIPTIONS)) {
+        return false;
+    }
+    cov_subscription = &COV->Subscriptions[index];
+    if (!cov_subscription->flag.valid) {
+        return false;
+    }
+    dest = cov_address_get(cov_subscription->dest_index);
+    if (!dest) {
+        return false;
     }
+    record[0] = cov_subscription->flag.issueConfirmedNotifications ? 1 : 0;
+    record[1] = 0;
+    encode_unsigned16(&record[2],
+        (uint16_t)cov_subscription->monitoredObjectIdentifier.type);
+    encode_unsigned32(
+        &record[4], cov_subscription->monitoredObjectIdentifier.instance);
+    encode_unsigned32(
+        &record[8], cov_subscription->subscriberProcessIdentifier);
+    encode_unsigned32(&record[12], cov_subscription->lifetime);
+    bacnet_address_record_encode(&record[16], dest);
+
+    return true;
+}
+
+/**
+ * @brief Restore a warm start snapshot record into a free COV
+ *  subscription, such as after handler_cov_init().  The subscriber is
+ *  sent a notification with the current value.
+ * @param index - record 0..N-1 of the snapshot, where record 0 starts
+ *  over at the first subscription
+ * @param record - HANDLER_COV_SNAPSHOT_RECORD_SIZE bytes
+ * @return true if the record was restored
+ */
+bool handler_cov_snapshot_restore(uint32_t index, uint8_t *record)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription;
+    BACNET_ADDRESS src = { 0 };
+    uint16_t object_type = 0;
+    int dest_index;
+
+    if (!record) {
+        return false;
+    }
+    if (index == 0) {
+        COV_Snapshot_Index = 0;
+    }
+    if (bacnet_address_record_decode(&record[16], &src) == 0) {
+        return false;
+    }
+    decode_unsigned16(&record[2], &object_type);
+    if (object_type >= MAX_BACNET_OBJECT_TYPE) {
+        return false;
+    }
+    while (COV_Snapshot_Index < MAX_COV_SUBCRIPTIONS) {
+        cov_subscription = &COV->Subscriptions[COV_Snapshot_Index];
+        COV_Snapshot_Index++;
+        if (cov_subscription->flag.valid) {
+            continue;
+        }
+        dest_index = cov_address_add(&src);
+        if (dest_index < 0) {
+            return false;
+        }
+        cov_subscription->flag.valid = true;
+        cov_subscription->dest_index = dest_index;
+        cov_subscription->flag.issueConfirmedNotifications = record[0] & 1;
+        cov_subscription->monitoredObjectIdentifier.type = object_type;
+        decode_unsigned32(
+            &record[4], &cov_subscription->monitoredObjectIdentifier.instance);
+        decode_unsigned32(
+            &record[8], &cov_subscription->subscriberProcessIdentifier);
+        decode_unsigned32(&record[12], &cov_subscription->lifetime);
+        cov_subscription->invokeID = 0;
+        cov_subscription->flag.send_requested = true;
+        return true;
+    }
+
+    return false;
 }
 
 static bool cov_list_subscribe(BACNET_ADDRESS *src,
@@ -358,37 +527,37 @@ static bool cov_list_subscribe(BACNET_ADDRESS *src,
 
     /* existing? - match Object ID and Process ID and address */
     for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-        if (COV_Subscriptions[index].flag.valid) {
-            dest = cov_address_get(COV_Subscriptions[index].dest_index);
+        if (COV->Subscriptions[index].flag.valid) {
+            dest = cov_address_get(COV->Subscriptions[index].dest_index);
             if (dest) {
                 address_match = bacnet_address_same(src, dest);
             } else {
                 /* skip address matching - we don't have an address */
                 address_match = true;
             }
-            if ((COV_Subscriptions[index].monitoredObjectIdentifier.type ==
+            if ((COV->Subscriptions[index].monitoredObjectIdentifier.type ==
                     cov_data->monitoredObjectIdentifier.type) &&
-                (COV_Subscriptions[index].monitoredObjectIdentifier.instance ==
+                (COV->Subscriptions[index].monitoredObjectIdentifier.instance ==
                     cov_data->monitoredObjectIdentifier.instance) &&
-                (COV_Subscriptions[index].subscriberProcessIdentifier ==
+                (COV->Subscriptions[index].subscriberProcessIdentifier ==
                     cov_data->subscriberProcessIdentifier) &&
                 address_match) {
                 existing_entry = true;
                 if (cov_data->cancellationRequest) {
                     /* initialize with invalid COV address */
-                    COV_Subscriptions[index].flag.valid = false;
-                    COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
+                    COV->Subscriptions[index].flag.valid = false;
+                    COV->Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
                     cov_address_remove_unused();
                 } else {
-                    COV_Subscriptions[index].dest_index = cov_address_add(src);
-                    COV_Subscriptions[index].flag.issueConfirmedNotifications =
+                    COV->Subscriptions[index].dest_index = cov_address_add(src);
+                    COV->Subscriptions[index].flag.issueConfirmedNotifications =
                         cov_data->issueConfirmedNotifications;
-                    COV_Subscriptions[index].lifetime = cov_data->lifetime;
-                    COV_Subscriptions[index].flag.send_requested = true;
+                    COV->Subscriptions[index].lifetime = cov_data->lifetime;
+                    COV->Subscriptions[index].flag.send_requested = true;
                 }
-                if (COV_Subscriptions[index].invokeID) {
-                    tsm_free_invoke_id(COV_Subscriptions[index].invokeID);
-                    COV_Subscriptions[index].invokeID = 0;
+                if (COV->Subscriptions[index].invokeID) {
+                    tsm_free_invoke_id(COV->Subscriptions[index].invokeID);
+                    COV->Subscriptions[index].invokeID = 0;
                 }
                 break;
             }
@@ -402,19 +571,19 @@ static bool cov_list_subscribe(BACNET_ADDRESS *src,
         (!cov_data->cancellationRequest)) {
         index = first_invalid_index;
         found = true;
-        COV_Subscriptions[index].flag.valid = true;
-        COV_Subscriptions[index].dest_index = cov_address_add(src);
-        COV_Subscriptions[index].monitoredObjectIdentifier.type =
+        COV->Subscriptions[index].flag.valid = true;
+        COV->Subscriptions[index].dest_index = cov_address_add(src);
+        COV->Subscriptions[index].monitoredObjectIdentifier.type =
             cov_data->monitoredObjectIdentifier.type;
-        COV_Subscriptions[index].monitoredObjectIdentifier.instance =
+        COV->Subscriptions[index].monitoredObjectIdentifier.instance =
             cov_data->monitoredObjectIdentifier.instance;
-        COV_Subscriptions[index].subscriberProcessIdentifier =
+        COV->Subscriptions[index].subscriberProcessIdentifier =
             cov_data->subscriberProcessIdentifier;
-        COV_Subscriptions[index].flag.issueConfirmedNotifications =
+        COV->Subscriptions[index].flag.issueConfirmedNotifications =
             cov_data->issueConfirmedNotifications;
-        COV_Subscriptions[index].invokeID = 0;
-        COV_Subscriptions[index].lifetime = cov_data->lifetime;
-        COV_Subscriptions[index].flag.send_requested = true;
+        COV->Subscriptions[index].invokeID = 0;
+        COV->Subscriptions[index].lifetime = cov_data->lifetime;
+        COV->Subscriptions[index].flag.send_requested = true;
     } else if (!existing_entry) {
         if (first_invalid_index < 0) {
             /* Out of resources */
@@ -497,8 +666,8 @@ static bool cov_send_request(BACNET_COV_SUBSCRIPTION *cov_subscription,
         tsm_set_confirmed_unsegmented_transaction(invoke_id, dest, &npdu_data,
             &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
     }
-    bytes_sent = datalink_send_pdu(
-        dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bytes_sent = tsm_send_pdu(
+        invoke_id, dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent > 0) {
         status = true;
 #if PRINT_ENABLED
@@ -517,35 +686,35 @@ static void cov_lifetime_expiration_handler(
     if (index < MAX_COV_SUBCRIPTIONS) {
         /* handle lifetime expiration */
         if (lifetime_seconds >= elapsed_seconds) {
-            COV_Subscriptions[index].lifetime -= elapsed_seconds;
+            COV->Subscriptions[index].lifetime -= elapsed_seconds;
 #if 0
             fprintf(stderr, "COVtimer: subscription[%d].lifetime=%lu\n", index,
-                (unsigned long) COV_Subscriptions[index].lifetime);
+                (unsigned long) COV->Subscriptions[index].lifetime);
 #endif
         } else {
-            COV_Subscriptions[index].lifetime = 0;
+            COV->Subscriptions[index].lifetime = 0;
         }
-        if (COV_Subscriptions[index].lifetime == 0) {
+        if (COV->Subscriptions[index].lifetime == 0) {
             /* expire the subscription */
 #if PRINT_ENABLED
             fprintf(stderr, "COVtimer: PID=%u ",
-                COV_Subscriptions[index].subscriberProcessIdentifier);
+                COV->Subscriptions[index].subscriberProcessIdentifier);
             fprintf(stderr, "%s %u ",
                 bactext_object_type_name(
-                    COV_Subscriptions[index].monitoredObjectIdentifier.type),
-                COV_Subscriptions[index].monitoredObjectIdentifier.instance);
+                    COV->Subscriptions[index].monitoredObjectIdentifier.type),
+                COV->Subscriptions[index].monitoredObjectIdentifier.instance);
             fprintf(stderr, "time remaining=%u seconds ",
-                COV_Subscriptions[index].lifetime);
+                COV->Subscriptions[index].lifetime);
             fprintf(stderr, "\n");
 #endif
             /* initialize with invalid COV address */
-            COV_Subscriptions[index].flag.valid = false;
-            COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
+            COV->Subscriptions[index].flag.valid = false;
+            COV->Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
             cov_address_remove_unused();
-            if (COV_Subscriptions[index].flag.issueConfirmedNotifications) {
-                if (COV_Subscriptions[index].invokeID) {
-                    tsm_free_invoke_id(COV_Subscriptions[index].invokeID);
-                    COV_Subscriptions[index].invokeID = 0;
+            if (COV->Subscriptions[index].flag.issueConfirmedNotifications) {
+                if (COV->Subscriptions[index].invokeID) {
+                    tsm_free_invoke_id(COV->Subscriptions[index].invokeID);
+                    COV->Subscriptions[index].invokeID = 0;
                 }
             }
         }
@@ -581,8 +750,8 @@ void handler_cov_timer_seconds(uint32_t elapsed_seconds)
     if (elapsed_seconds) {
         /* handle the subscription timeouts */
         for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-            if (COV_Subscriptions[index].flag.valid) {
-                lifetime_seconds = COV_Subscriptions[index].lifetime;
+            if (COV->Subscriptions[index].flag.valid) {
+                lifetime_seconds = COV->Subscriptions[index].lifetime;
                 if (lifetime_seconds) {
                     /* only expire COV with definite lifetimes */
                     cov_lifetime_expiration_handler(
@@ -593,22 +762,75 @@ void handler_cov_timer_seconds(uint32_t elapsed_seconds)
     }
 }
 
+/**
+ * @brief Remove the COV subscriptions of an object that was deleted,
+ *  so that no notifications are sent for it, and a new object with the
+ *  same identifier does not inherit them.
+ * @param object_type - type of the deleted object
+ * @param object_instance - instance number of the deleted object
+ * @return number of subscriptions that were removed
+ */
+unsigned handler_cov_object_delete(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription;
+    unsigned index = 0;
+    unsigned count = 0;
+
+    for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
+        cov_subscription = &COV->Subscriptions[index];
+        if ((cov_subscription->flag.valid) &&
+            (cov_subscription->monitoredObjectIdentifier.type ==
+                object_type) &&
+            (cov_subscription->monitoredObjectIdentifier.instance ==
+                object_instance)) {
+            cov_subscription->flag.valid = false;
+            cov_subscription->flag.send_requested = false;
+            cov_subscription->dest_index = MAX_COV_ADDRESSES;
+            if (cov_subscription->invokeID) {
+                tsm_free_invoke_id(cov_subscription->invokeID);
+                cov_subscription->invokeID = 0;
+            }
+            count++;
+        }
+    }
+    if (count) {
+        cov_address_remove_unused();
+    }
+
+    return count;
+}
+
+#if defined(BACNET_METRICS)
+/**
+ * @brief Count the subscriptions that are waiting to send a notification
+ * @return number of subscriptions
+ */
+static uint32_t cov_send_requested_count(void)
+{
+    uint32_t count = 0;
+    unsigned index;
+
+    for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
+        if ((COV->Subscriptions[index].flag.valid) &&
+            (COV->Subscriptions[index].flag.send_requested)) {
+            count++;
+        }
+    }
+
+    return count;
+}
+#endif
+
 bool handler_cov_fsm(void)
 {
-    static int index = 0;
+    int index = COV->Task_Index;
     BACNET_OBJECT_TYPE object_type = MAX_BACNET_OBJECT_TYPE;
     uint32_t object_instance = 0;
     bool status = false;
     bool send = false;
     BACNET_PROPERTY_VALUE value_list[MAX_COV_PROPERTIES];
-    /* states for transmitting */
-    static enum {
-        COV_STATE_IDLE = 0,
-        COV_STATE_MARK,
-        COV_STATE_CLEAR,
-        COV_STATE_FREE,
-        COV_STATE_SEND
-    } cov_task_state = COV_STATE_IDLE;
+    BACNET_COV_TASK_STATE cov_task_state = COV->Task_State;
 
     switch (cov_task_state) {
         case COV_STATE_IDLE:
@@ -617,14 +839,14 @@ bool handler_cov_fsm(void)
             break;
         case COV_STATE_MARK:
             /* mark any subscriptions where the value has changed */
-            if (COV_Subscriptions[index].flag.valid) {
-                object_type = (BACNET_OBJECT_TYPE)COV_Subscriptions[index]
+            if (COV->Subscriptions[index].flag.valid) {
+                object_type = (BACNET_OBJECT_TYPE)COV->Subscriptions[index]
                                   .monitoredObjectIdentifier.type;
-                object_instance =
-                    COV_Subscriptions[index].monitoredObjectIdentifier.instance;
+                object_instance = COV->Subscriptions[index]
+                                      .monitoredObjectIdentifier.instance;
                 status = Device_COV(object_type, object_instance);
                 if (status) {
-                    COV_Subscriptions[index].flag.send_requested = true;
+                    COV->Subscriptions[index].flag.send_requested = true;
 #if PRINT_ENABLED
                     fprintf(stderr, "COVtask: Marking...\n");
 #endif
@@ -634,16 +856,18 @@ bool handler_cov_fsm(void)
             if (index >= MAX_COV_SUBCRIPTIONS) {
                 index = 0;
                 cov_task_state = COV_STATE_CLEAR;
+                METRICS_GAUGE(
+                    METRICS_GAUGE_COV_QUEUE, cov_send_requested_count());
             }
             break;
         case COV_STATE_CLEAR:
             /* clear the COV flag after checking all subscriptions */
-            if ((COV_Subscriptions[index].flag.valid) &&
-                (COV_Subscriptions[index].flag.send_requested)) {
-                object_type = (BACNET_OBJECT_TYPE)COV_Subscriptions[index]
+            if ((COV->Subscriptions[index].flag.valid) &&
+                (COV->Subscriptions[index].flag.send_requested)) {
+                object_type = (BACNET_OBJECT_TYPE)COV->Subscriptions[index]
                                   .monitoredObjectIdentifier.type;
-                object_instance =
-                    COV_Subscriptions[index].monitoredObjectIdentifier.instance;
+                object_instance = COV->Subscriptions[index]
+                                      .monitoredObjectIdentifier.instance;
                 Device_COV_Clear(object_type, object_instance);
             }
             index++;
@@ -654,15 +878,15 @@ bool handler_cov_fsm(void)
             break;
         case COV_STATE_FREE:
             /* confirmed notification house keeping */
-            if ((COV_Subscriptions[index].flag.valid) &&
-                (COV_Subscriptions[index].flag.issueConfirmedNotifications) &&
-                (COV_Subscriptions[index].invokeID)) {
-                if (tsm_invoke_id_free(COV_Subscriptions[index].invokeID)) {
-                    COV_Subscriptions[index].invokeID = 0;
+            if ((COV->Subscriptions[index].flag.valid) &&
+                (COV->Subscriptions[index].flag.issueConfirmedNotifications) &&
+                (COV->Subscriptions[index].invokeID)) {
+                if (tsm_invoke_id_free(COV->Subscriptions[index].invokeID)) {
+                    COV->Subscriptions[index].invokeID = 0;
                 } else if (tsm_invoke_id_failed(
-                               COV_Subscriptions[index].invokeID)) {
-                    tsm_free_invoke_id(COV_Subscriptions[index].invokeID);
-                    COV_Subscriptions[index].invokeID = 0;
+                               COV->Subscriptions[index].invokeID)) {
+                    tsm_free_invoke_id(COV->Subscriptions[index].invokeID);
+                    COV->Subscriptions[index].invokeID = 0;
                 }
             }
             index++;
@@ -673,11 +897,12 @@ bool handler_cov_fsm(void)
             break;
         case COV_STATE_SEND:
             /* send any COVs that are requested */
-            if ((COV_Subscriptions[index].flag.valid) &&
-                (COV_Subscriptions[index].flag.send_requested)) {
+            if ((COV->Subscriptions[index].flag.valid) &&
+                (COV->Subscriptions[index].flag.send_requested)) {
                 send = true;
-                if (COV_Subscriptions[index].flag.issueConfirmedNotifications) {
-                    if (COV_Subscriptions[index].invokeID != 0) {
+                if (COV->Subscriptions[index]
+                        .flag.issueConfirmedNotifications) {
+                    if (COV->Subscriptions[index].invokeID != 0) {
                         /* already sending */
                         send = false;
                     }
@@ -687,9 +912,9 @@ bool handler_cov_fsm(void)
                     }
                 }
                 if (send) {
-                    object_type = (BACNET_OBJECT_TYPE)COV_Subscriptions[index]
+                    object_type = (BACNET_OBJECT_TYPE)COV->Subscriptions[index]
                                       .monitoredObjectIdentifier.type;
-                    object_instance = COV_Subscriptions[index]
+                    object_instance = COV->Subscriptions[index]
                                           .monitoredObjectIdentifier.instance;
 #if PRINT_ENABLED
                     fprintf(stderr, "COVtask: Sending...\n");
@@ -701,10 +926,11 @@ bool handler_cov_fsm(void)
                         object_type, object_instance, &value_list[0]);
                     if (status) {
                         status = cov_send_request(
-                            &COV_Subscriptions[index], &value_list[0]);
+                            &COV->Subscriptions[index], &value_list[0]);
                     }
                     if (status) {
-                        COV_Subscriptions[index].flag.send_requested = false;
+                        COV->Subscriptions[index].flag.send_requested = false;
+                        METRICS_COUNT(METRICS_COV_NOTIFICATIONS);
                     }
                 }
             }
@@ -719,6 +945,9 @@ bool handler_cov_fsm(void)
             cov_task_state = COV_STATE_IDLE;
             break;
     }
+    COV->Task_Index = index;
+    COV->Task_State = cov_task_state;
+
     return (cov_task_state == COV_STATE_IDLE);
 }
 
@@ -860,7 +1089,9 @@ void handler_cov_subscribe(uint8_t *service_request,
     pdu_len = npdu_len + apdu_len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
-    if (bytes_sent <= 0) {
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[npdu_len], apdu_len);
+    } else {
 #if PRINT_ENABLED
         fprintf(stderr, "SubscribeCOV: Failed to send PDU (%s)!\n",
             strerror(errno));
@@ -36,6 +36,13 @@
 #include "bacnet/bacdef.h"
 #include "bacnet/bacenum.h"
 #include "bacnet/apdu.h"
+#include "bacnet/bacaddr.h"
+
+/* warm start snapshot record of a COV subscription: flags, monitored
+   object, subscriber process identifier, lifetime, and the address of
+   the subscriber - see snapshot.h */
+#define HANDLER_COV_SNAPSHOT_VERSION 1
+#define HANDLER_COV_SNAPSHOT_RECORD_SIZE (16 + BACNET_ADDRESS_RECORD_SIZE)
 
 #ifdef __cplusplus
 extern "C" {
@@ -60,10 +67,38 @@ extern "C" {
     void handler_cov_init(
         void);
     BACNET_STACK_EXPORT
+    unsigned handler_cov_object_delete(
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance);
+    BACNET_STACK_EXPORT
     int handler_cov_encode_subscriptions(
         uint8_t * apdu,
         int max_apdu);
 
+    /* COV subscriptions of one stack context - see stack_context.h */
+    BACNET_STACK_EXPORT
+    size_t handler_cov_context_size(
+        void);
+    BACNET_STACK_EXPORT
+    void handler_cov_context_init(
+        void *context);
+    BACNET_STACK_EXPORT
+    void *handler_cov_context_select(
+        void *context);
+
+    /* warm start snapshot of the COV subscriptions - see snapshot.h */
+    BACNET_STACK_EXPORT
+    uint32_t handler_cov_snapshot_count(
+        void);
+    BACNET_STACK_EXPORT
+    bool handler_cov_snapshot_encode(
+        uint32_t index,
+        uint8_t *record);
+    BACNET_STACK_EXPORT
+    bool handler_cov_snapshot_restore(
+        uint32_t index,
+        uint8_t *record);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,117 @@
+/**
+ * @file
+ * @brief CreateObject service application handler
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "bacnet/config.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacerror.h"
+#include "bacnet/apdu.h"
+#include "bacnet/npdu.h"
+#include "bacnet/abort.h"
+#include "bacnet/reject.h"
+#include "bacnet/create_object.h"
+/* basic objects, services, TSM, and datalink */
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
+#include "bacnet/datalink/datalink.h"
+
+/**
+ * @brief Handler for a CreateObject Service request.
+ * This handler will be invoked by apdu_handler() if it has been enabled
+ * via call to apdu_set_confirmed_handler().
+ * This handler builds a response packet, which is
+ * - an Abort if the message is segmented
+ * - a Reject if decoding fails
+ * - a ComplexACK with the new object identifier
+ *   if Device_Create_Object() succeeds
+ * - a CreateObject-Error if Device_Create_Object() fails
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ */
+void handler_create_object(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    BACNET_CREATE_OBJECT_DATA data = { 0 };
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+    uint8_t *apdu = NULL;
+    int len = 0;
+    int pdu_len = 0;
+    int bytes_sent = 0;
+
+    /* encode the NPDU portion of the packet */
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    apdu = &Handler_Transmit_Buffer[pdu_len];
+    debug_perror("CreateObject: Received Request!\n");
+    if (service_data->segmented_message) {
+        len = abort_encode_apdu(apdu, service_data->invoke_id,
+            ABORT_REASON_SEGMENTATION_NOT_SUPPORTED, true);
+        debug_perror("CreateObject: Segmented message.  Sending Abort!\n");
+        goto CREATE_OBJECT_ABORT;
+    }
+    /* decode the service request only */
+    len = create_object_decode_service_request(
+        service_request, service_len, &data);
+    if (len <= 0) {
+        len = reject_encode_apdu(apdu, service_data->invoke_id,
+            reject_convert_error_code(data.error_code));
+        debug_perror("CreateObject: Bad Encoding. Sending Reject!\n");
+        goto CREATE_OBJECT_ABORT;
+    }
+    debug_perror("CreateObject: type=%lu instance=%lu\n",
+        (unsigned long)data.object_type,
+        (unsigned long)data.object_instance);
+    if (Device_Create_Object(&data)) {
+        apdu[0] = PDU_TYPE_COMPLEX_ACK;
+        apdu[1] = service_data->invoke_id;
+        apdu[2] = SERVICE_CONFIRMED_CREATE_OBJECT;
+        len = 3;
+        len += create_object_ack_encode(&apdu[len], &data);
+        debug_perror("CreateObject: Sending ACK!\n");
+    } else {
+        apdu[0] = PDU_TYPE_ERROR;
+        apdu[1] = service_data->invoke_id;
+        apdu[2] = SERVICE_CONFIRMED_CREATE_OBJECT;
+        len = 3;
+        len += create_object_error_ack_encode(&apdu[len], &data);
+        debug_perror("CreateObject: Sending Error!\n");
+    }
+CREATE_OBJECT_ABORT:
+    /* Send PDU */
+    pdu_len += len;
+    bytes_sent = datalink_send_pdu(
+        src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    } else {
+        debug_perror(
+            "CreateObject: Failed to send PDU (%s)!\n", strerror(errno));
+    }
+
+    return;
+}
@@ -40,6 +40,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_dcc.c  Handles Device Communication Control request. */
@@ -105,6 +106,7 @@ void handler_device_communication_control(uint8_t *service_request,
     BACNET_CHARACTER_STRING password;
     int len = 0;
     int pdu_len = 0;
+    int bytes_sent = 0;
     BACNET_NPDU_DATA npdu_data;
     BACNET_ADDRESS my_address;
 
@@ -198,9 +200,11 @@ void handler_device_communication_control(uint8_t *service_request,
     }
 DCC_ABORT:
     pdu_len += len;
-    len = datalink_send_pdu(
+    bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
-    if (len <= 0) {
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    } else {
 #if PRINT_ENABLED
         fprintf(stderr,
             "DeviceCommunicationControl: "
@@ -0,0 +1,214 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Index of objects with active events for the GetEventInformation
+ *  and GetAlarmSummary service handlers
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/basic/sys/key.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/service/h_event_index.h"
+
+/* objects with Event_State != NORMAL or unacknowledged transitions,
+   sorted by object type and instance */
+static OS_Keylist Event_Index_List;
+/* object types that keep the index up to date */
+static uint8_t Event_Index_Types[(MAX_BACNET_OBJECT_TYPE + 7) / 8];
+
+struct event_index_node {
+    unsigned object_index;
+};
+
+/**
+ * @brief Enable the index for an object type, and remove any
+ *  stale entries for that object type.  Called from the object
+ *  type Init function before its instances are initialized.
+ * @param object_type - object type that maintains its index entries
+ */
+void Event_Index_Type_Init(BACNET_OBJECT_TYPE object_type)
+{
+    struct event_index_node *node;
+    int position;
+
+    if (object_type >= MAX_BACNET_OBJECT_TYPE) {
+        return;
+    }
+    if (!Event_Index_List) {
+        Event_Index_List = Keylist_Create();
+    }
+    Event_Index_Types[object_type / 8] |= (uint8_t)(1 << (object_type % 8));
+    position = Event_Index_Position(object_type, 0);
+    while (position < Keylist_Count(Event_Index_List)) {
+        if (KEY_DECODE_TYPE(Keylist_Key(Event_Index_List, position)) !=
+            (int)object_type) {
+            break;
+        }
+        node = Keylist_Data_Delete_By_Index(Event_Index_List, position);
+        free(node);
+    }
+}
+
+/**
+ * @brief Determine if an object type maintains its index entries
+ * @param object_type - object type to check
+ * @return true if the handlers may rely on the index for this type
+ */
+bool Event_Index_Type_Enabled(BACNET_OBJECT_TYPE object_type)
+{
+    if (object_type >= MAX_BACNET_OBJECT_TYPE) {
+        return false;
+    }
+
+    return (Event_Index_Types[object_type / 8] & (1 << (object_type % 8)))
+        ? true
+        : false;
+}
+
+/**
+ * @brief Add or remove an object from the active event index
+ * @param object_type - object type
+ * @param object_instance - object instance number
+ * @param object_index - index passed to the object type
+ *  GetEventInformation and GetAlarmSummary functions
+ * @param active - true if Event_State is not NORMAL, or at least one
+ *  of the Acked_Transitions is false
+ * @return true if the index was updated
+ */
+bool Event_Index_Update(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    unsigned object_index,
+    bool active)
+{
+    struct event_index_node *node;
+    KEY key;
+
+    if ((object_type >= MAX_BACNET_OBJECT_TYPE) ||
+        (object_instance > BACNET_MAX_INSTANCE) || !Event_Index_List) {
+        return false;
+    }
+    key = KEY_ENCODE(object_type, object_instance);
+    node = Keylist_Data(Event_Index_List, key);
+    if (active) {
+        if (!node) {
+            node = calloc(1, sizeof(struct event_index_node));
+            if (!node) {
+                return false;
+            }
+            if (Keylist_Data_Add(Event_Index_List, key, node) < 0) {
+                free(node);
+                return false;
+            }
+        }
+        node->object_index = object_index;
+    } else if (node) {
+        node = Keylist_Data_Delete(Event_Index_List, key);
+        free(node);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Number of objects in the active event index
+ * @return number of objects with an active event
+ */
+int Event_Index_Count(void)
+{
+    return Keylist_Count(Event_Index_List);
+}
+
+/**
+ * @brief Find the position of the first entry at or after the given
+ *  object identifier using a binary search of the sorted index.
+ * @param object_type - object type to start from
+ * @param object_instance - object instance to start from
+ * @return position of the first entry >= the object identifier, or
+ *  Event_Index_Count() when there are none.
+ */
+int Event_Index_Position(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    KEY key;
+    int left = 0;
+    int right;
+    int middle;
+
+    key = KEY_ENCODE(object_type, object_instance);
+    right = Keylist_Count(Event_Index_List);
+    while (left < right) {
+        middle = left + (right - left) / 2;
+        if (Keylist_Key(Event_Index_List, middle) < key) {
+            left = middle + 1;
+        } else {
+            right = middle;
+        }
+    }
+
+    return left;
+}
+
+/**
+ * @brief Get the object at a position in the active event index
+ * @param position - 0..Event_Index_Count()-1
+ * @param object_type - [out] object type, or NULL
+ * @param object_instance - [out] object instance, or NULL
+ * @param object_index - [out] object type specific index, or NULL
+ * @return true if the position is valid
+ */
+bool Event_Index_Item(int position,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance,
+    unsigned *object_index)
+{
+    struct event_index_node *node;
+    KEY key;
+
+    node = Keylist_Data_Index(Event_Index_List, position);
+    if (!node) {
+        return false;
+    }
+    key = Keylist_Key(Event_Index_List, position);
+    if (object_type) {
+        *object_type = (BACNET_OBJECT_TYPE)KEY_DECODE_TYPE(key);
+    }
+    if (object_instance) {
+        *object_instance = (uint32_t)KEY_DECODE_ID(key);
+    }
+    if (object_index) {
+        *object_index = node->object_index;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Free the active event index and disable it for all types
+ */
+void Event_Index_Cleanup(void)
+{
+    struct event_index_node *node;
+    unsigned i;
+
+    if (Event_Index_List) {
+        while (Keylist_Count(Event_Index_List) > 0) {
+            node = Keylist_Data_Pop(Event_Index_List);
+            free(node);
+        }
+        Keylist_Delete(Event_Index_List);
+        Event_Index_List = NULL;
+    }
+    for (i = 0; i < sizeof(Event_Index_Types); i++) {
+        Event_Index_Types[i] = 0;
+    }
+}
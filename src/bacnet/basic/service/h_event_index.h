@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Index of objects with active events for the GetEventInformation
+ *  and GetAlarmSummary service handlers
+ *
+ * @section DESCRIPTION
+ *
+ * Objects that support intrinsic reporting keep this index current
+ * whenever their Event_State or Acked_Transitions change, so the
+ * service handlers only visit objects that have something to report
+ * instead of scanning every instance of every object type.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef HANDLER_EVENT_INDEX_H
+#define HANDLER_EVENT_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "bacnet/bacnet_stack_exports.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/bacenum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Event_Index_Type_Init(BACNET_OBJECT_TYPE object_type);
+BACNET_STACK_EXPORT
+bool Event_Index_Type_Enabled(BACNET_OBJECT_TYPE object_type);
+
+BACNET_STACK_EXPORT
+bool Event_Index_Update(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    unsigned object_index,
+    bool active);
+
+BACNET_STACK_EXPORT
+int Event_Index_Count(void);
+BACNET_STACK_EXPORT
+int Event_Index_Position(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Event_Index_Item(int position,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance,
+    unsigned *object_index);
+
+BACNET_STACK_EXPORT
+void Event_Index_Cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
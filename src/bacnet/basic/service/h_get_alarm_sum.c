@@ -36,6 +36,7 @@
 /* basic services, TSM, and datalink */
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_alarm_sum.c  Handles Get Alarm Summary request. */
@@ -62,6 +63,9 @@ void handler_get_alarm_summary(uint8_t *service_request,
     int alarm_value = 0;
     unsigned i = 0;
     unsigned j = 0;
+    unsigned object_index = 0;
+    int position = 0;
+    BACNET_OBJECT_TYPE object_type;
     bool error = false;
     BACNET_ADDRESS my_address;
     BACNET_NPDU_DATA npdu_data;
@@ -90,7 +94,30 @@ void handler_get_alarm_summary(uint8_t *service_request,
         &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id);
 
     for (i = 0; i < MAX_BACNET_OBJECT_TYPE; i++) {
-        if (Get_Alarm_Summary[i]) {
+        if (Get_Alarm_Summary[i] && Event_Index_Type_Enabled(i)) {
+            /* only visit the objects that have an active event */
+            position = Event_Index_Position(i, 0);
+            while (Event_Index_Item(
+                position, &object_type, NULL, &object_index)) {
+                if (object_type != i) {
+                    break;
+                }
+                position++;
+                alarm_value =
+                    Get_Alarm_Summary[i](object_index, &getalarm_data);
+                if (alarm_value > 0) {
+                    len = get_alarm_summary_ack_encode_apdu_data(
+                        &Handler_Transmit_Buffer[pdu_len + apdu_len],
+                        service_data->max_resp - apdu_len, &getalarm_data);
+                    if (len <= 0) {
+                        error = true;
+                        goto GET_ALARM_SUMMARY_ERROR;
+                    } else {
+                        apdu_len += len;
+                    }
+                }
+            }
+        } else if (Get_Alarm_Summary[i]) {
             for (j = 0; j < 0xffff; j++) {
                 alarm_value = Get_Alarm_Summary[i](j, &getalarm_data);
                 if (alarm_value > 0) {
@@ -139,6 +166,9 @@ GET_ALARM_SUMMARY_ABORT:
     pdu_len += apdu_len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - apdu_len], apdu_len);
+    }
 #if PRINT_ENABLED
     if (bytes_sent <= 0) {
         /*fprintf(stderr, "Failed to send PDU (%s)!\n", strerror(errno)); */
@@ -40,6 +40,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_getevent.c  Handles Get Event Information request. */
@@ -74,6 +75,45 @@ void handler_get_event_information_set(
     }
 }
 
+/**
+ * @brief Append one event summary to the GetEventInformation-ACK
+ * @param getevent_data - event summary to encode
+ * @param pdu_len - current length of the PDU in the transmit buffer
+ * @param apdu_len - current length of the APDU in the transmit buffer
+ * @param service_data - confirmed service data of the request
+ * @return number of bytes appended, 0 if the response is full and
+ *  more events remain, or a negative BACNET_STATUS value on error.
+ */
+static int getevent_ack_append(
+    BACNET_GET_EVENT_INFORMATION_DATA *getevent_data,
+    int pdu_len,
+    int apdu_len,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    int len;
+
+    getevent_data->next = NULL;
+    len = getevent_ack_encode_apdu_data(&Handler_Transmit_Buffer[pdu_len],
+        sizeof(Handler_Transmit_Buffer) - pdu_len, getevent_data);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    if ((apdu_len >= service_data->max_resp - 2) ||
+        (apdu_len >= MAX_APDU - 2)) {
+        /* Device must be able to fit minimum
+           one event information.
+           Length of one event information needs
+           more than 50 octets. */
+        if ((service_data->max_resp < 128) || (MAX_APDU < 128)) {
+            return BACNET_STATUS_ABORT;
+        }
+        return 0;
+    }
+
+    return len;
+}
+
 void handler_get_event_information(uint8_t *service_request,
     uint16_t service_len,
     BACNET_ADDRESS *src,
@@ -81,29 +121,34 @@ void handler_get_event_information(uint8_t *service_request,
 {
     int len = 0;
     int pdu_len = 0;
+    int npdu_len = 0;
     int apdu_len = 0;
     BACNET_NPDU_DATA npdu_data;
     bool error = false;
     bool more_events = false;
-#if PRINT_ENABLED
+    bool found = true;
     int bytes_sent = 0;
-#endif
     BACNET_ERROR_CLASS error_class = ERROR_CLASS_OBJECT;
     BACNET_ERROR_CODE error_code = ERROR_CODE_UNKNOWN_OBJECT;
     BACNET_ADDRESS my_address;
     BACNET_OBJECT_ID object_id;
+    BACNET_OBJECT_TYPE object_type;
     unsigned i = 0, j = 0; /* counter */
+    unsigned object_index = 0;
+    int position = 0;
     BACNET_GET_EVENT_INFORMATION_DATA getevent_data;
     int valid_event = 0;
 
     /* initialize type of 'Last Received Object Identifier' using max value */
     object_id.type = MAX_BACNET_OBJECT_TYPE;
+    object_id.instance = 0;
 
     /* encode the NPDU portion of the packet */
     datalink_get_my_address(&my_address);
     npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
-    pdu_len = npdu_encode_pdu(
+    npdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    pdu_len = npdu_len;
     if (service_data->segmented_message) {
         /* we don't support segmentation - send an abort */
         len = abort_encode_apdu(&Handler_Transmit_Buffer[pdu_len],
@@ -136,56 +181,75 @@ void handler_get_event_information(uint8_t *service_request,
     }
     pdu_len += len;
     apdu_len = len;
-    for (i = 0; i < MAX_BACNET_OBJECT_TYPE; i++) {
-        if (Get_Event_Info[i]) {
-            for (j = 0; j < 0xffff; j++) {
-                valid_event = Get_Event_Info[i](j, &getevent_data);
-                if (valid_event > 0) {
-                    /* encode GetEvent_data only when type of object_id has max
-                     * value */
-                    if (object_id.type != MAX_BACNET_OBJECT_TYPE) {
-                        if ((object_id.type ==
-                                getevent_data.objectIdentifier.type) &&
-                            (object_id.instance ==
-                                getevent_data.objectIdentifier.instance)) {
-                            /* found 'Last Received Object Identifier'
-                               so should set type of object_id to max value */
-                            object_id.type = MAX_BACNET_OBJECT_TYPE;
-                        }
-                        continue;
-                    }
-
-                    getevent_data.next = NULL;
-                    len = getevent_ack_encode_apdu_data(
-                        &Handler_Transmit_Buffer[pdu_len],
-                        sizeof(Handler_Transmit_Buffer) - pdu_len,
-                        &getevent_data);
-                    if (len <= 0) {
-                        error = true;
-                        goto GET_EVENT_ERROR;
-                    }
-                    apdu_len += len;
-                    if ((apdu_len >= service_data->max_resp - 2) ||
-                        (apdu_len >= MAX_APDU - 2)) {
-                        /* Device must be able to fit minimum
-                           one event information.
-                           Length of one event information needs
-                           more than 50 octets. */
-                        if ((service_data->max_resp < 128) ||
-                            (MAX_APDU < 128)) {
-                            len = BACNET_STATUS_ABORT;
-                            error = true;
-                            goto GET_EVENT_ERROR;
-                        } else {
-                            more_events = true;
-                        }
-                        break;
-                    } else {
-                        pdu_len += len;
+    for (i = 0; (i < MAX_BACNET_OBJECT_TYPE) && !more_events; i++) {
+        if (!Get_Event_Info[i]) {
+            continue;
+        }
+        if (object_id.type != MAX_BACNET_OBJECT_TYPE) {
+            /* resume after the 'Last Received Object Identifier' */
+            if (i < object_id.type) {
+                continue;
+            }
+            found = (i != object_id.type);
+        }
+        if (Event_Index_Type_Enabled(i)) {
+            /* only visit the objects that have an active event */
+            if (found) {
+                position = Event_Index_Position(i, 0);
+            } else if (object_id.instance < BACNET_MAX_INSTANCE) {
+                position = Event_Index_Position(i, object_id.instance + 1);
+            } else {
+                continue;
+            }
+            while (Event_Index_Item(
+                position, &object_type, NULL, &object_index)) {
+                if (object_type != i) {
+                    break;
+                }
+                position++;
+                valid_event = Get_Event_Info[i](object_index, &getevent_data);
+                if (valid_event <= 0) {
+                    continue;
+                }
+                len = getevent_ack_append(
+                    &getevent_data, pdu_len, apdu_len, service_data);
+                if (len < 0) {
+                    error = true;
+                    goto GET_EVENT_ERROR;
+                } else if (len == 0) {
+                    more_events = true;
+                    break;
+                }
+                pdu_len += len;
+                apdu_len += len;
+            }
+            continue;
+        }
+        for (j = 0; j < 0xffff; j++) {
+            valid_event = Get_Event_Info[i](j, &getevent_data);
+            if (valid_event > 0) {
+                /* encode GetEvent_data only after the
+                   'Last Received Object Identifier' */
+                if (!found) {
+                    if (object_id.instance ==
+                        getevent_data.objectIdentifier.instance) {
+                        found = true;
                     }
-                } else if (valid_event < 0) {
+                    continue;
+                }
+                len = getevent_ack_append(
+                    &getevent_data, pdu_len, apdu_len, service_data);
+                if (len < 0) {
+                    error = true;
+                    goto GET_EVENT_ERROR;
+                } else if (len == 0) {
+                    more_events = true;
                     break;
                 }
+                pdu_len += len;
+                apdu_len += len;
+            } else if (valid_event < 0) {
+                break;
             }
         }
     }
@@ -200,8 +264,7 @@ void handler_get_event_information(uint8_t *service_request,
 #endif
 GET_EVENT_ERROR:
     if (error) {
-        pdu_len = npdu_encode_pdu(
-            &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+        pdu_len = npdu_len;
 
         if (len == -2) {
             /* BACnet APDU too small to fit data, so proper response is Abort */
@@ -224,11 +287,12 @@ GET_EVENT_ERROR:
     }
 GET_EVENT_ABORT:
     pdu_len += len;
-#if PRINT_ENABLED
-    bytes_sent =
-#endif
-        datalink_send_pdu(
-            src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bytes_sent = datalink_send_pdu(
+        src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(
+            &Handler_Transmit_Buffer[npdu_len], pdu_len - npdu_len);
+    }
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(stderr, "Failed to send PDU (%s)!\n", strerror(errno));
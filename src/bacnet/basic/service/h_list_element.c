@@ -27,6 +27,7 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /**
@@ -111,7 +112,9 @@ void handler_add_list_element(uint8_t *service_request,
     pdu_len += len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
-    if (bytes_sent <= 0) {
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    } else {
         debug_perror(
             "AddListElement: Failed to send PDU (%s)!\n", strerror(errno));
     }
@@ -202,7 +205,9 @@ void handler_remove_list_element(uint8_t *service_request,
     pdu_len += len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
-    if (bytes_sent <= 0) {
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    } else {
         debug_perror(
             "RemoveListElement: Failed to send PDU (%s)!\n", strerror(errno));
     }
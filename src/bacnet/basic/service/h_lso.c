@@ -38,6 +38,7 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_lso.c  Handles BACnet Life Safey Operation messages. */
@@ -51,9 +52,7 @@ void handler_lso(uint8_t *service_request,
     int len = 0;
     int pdu_len = 0;
     BACNET_NPDU_DATA npdu_data;
-#if PRINT_ENABLED
     int bytes_sent = 0;
-#endif
     BACNET_ADDRESS my_address;
 
     /* encode the NPDU portion of the packet */
@@ -108,11 +107,11 @@ void handler_lso(uint8_t *service_request,
 
 LSO_ABORT:
     pdu_len += len;
-#if PRINT_ENABLED
-    bytes_sent =
-#endif
-        datalink_send_pdu(
-            src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bytes_sent = datalink_send_pdu(
+        src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    }
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(stderr,
@@ -36,6 +36,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file noserv.c  Handles an unrecognized/unsupported service. */
@@ -78,6 +79,7 @@ void handler_unrecognized_service(uint8_t *service_request,
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent > 0) {
+        METRICS_COUNT(METRICS_APDU_REJECT_TX);
 #if PRINT_ENABLED
         fprintf(stderr, "Sent Reject!\n");
 #endif
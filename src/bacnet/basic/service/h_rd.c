@@ -40,6 +40,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_rd.c  Handles Reinitialize Device requests. */
@@ -72,6 +73,7 @@ void handler_reinitialize_device(uint8_t *service_request,
     BACNET_REINITIALIZE_DEVICE_DATA rd_data;
     int len = 0;
     int pdu_len = 0;
+    int bytes_sent = 0;
     BACNET_NPDU_DATA npdu_data;
     BACNET_ADDRESS my_address;
 
@@ -149,9 +151,11 @@ void handler_reinitialize_device(uint8_t *service_request,
     }
 RD_ABORT:
     pdu_len += len;
-    len = datalink_send_pdu(
+    bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
-    if (len <= 0) {
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    } else {
 #if PRINT_ENABLED
         fprintf(stderr, "ReinitializeDevice: Failed to send PDU (%s)!\n",
             strerror(errno));
@@ -44,6 +44,7 @@
 #endif
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_rp.c  Handles Read Property requests. */
@@ -216,7 +217,9 @@ void handler_read_property(uint8_t *service_request,
     pdu_len = npdu_len + apdu_len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
-    if (bytes_sent <= 0) {
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[npdu_len], apdu_len);
+    } else {
 #if PRINT_ENABLED
         fprintf(stderr, "Failed to send PDU (%s)!\n", strerror(errno));
 #endif
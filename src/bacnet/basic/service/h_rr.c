@@ -39,6 +39,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_rr.c  Handles Read Range requests. */
@@ -130,9 +131,7 @@ void handler_read_range(uint8_t *service_request,
     int pdu_len = 0;
     BACNET_NPDU_DATA npdu_data;
     bool error = false;
-#if PRINT_ENABLED
     int bytes_sent = 0;
-#endif
     BACNET_ADDRESS my_address;
 
     data.error_class = ERROR_CLASS_OBJECT;
@@ -204,11 +203,11 @@ void handler_read_range(uint8_t *service_request,
     }
 
     pdu_len += len;
-#if PRINT_ENABLED
-    bytes_sent =
-#endif
-        datalink_send_pdu(
-            src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bytes_sent = datalink_send_pdu(
+        src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[pdu_len - len], len);
+    }
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(stderr, "Failed to send PDU (%s)!\n", strerror(errno));
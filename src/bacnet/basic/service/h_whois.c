@@ -29,6 +29,7 @@
 #include <errno.h>
 #include "bacnet/config.h"
 #include "bacnet/bacdef.h"
+#include "bacnet/bacaddr.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/whois.h"
 #include "bacnet/iam.h"
@@ -38,11 +39,236 @@
 
 /** @file h_whois.c  Handles Who-Is requests. */
 
+/* I-Am responses that are waiting for their randomized delay */
+#ifndef WHO_IS_PENDING_MAX
+#define WHO_IS_PENDING_MAX 8
+#endif
+/* Who-Is sources that are remembered for the rate limit */
+#ifndef WHO_IS_SOURCE_MAX
+#define WHO_IS_SOURCE_MAX 8
+#endif
+
+struct who_is_pending {
+    bool active;
+    bool unicast;
+    int device_index;
+    uint16_t milliseconds;
+    BACNET_ADDRESS dest;
+};
+struct who_is_source {
+    uint16_t milliseconds;
+    BACNET_ADDRESS address;
+};
+static struct who_is_pending Who_Is_Pending[WHO_IS_PENDING_MAX];
+static struct who_is_source Who_Is_Source[WHO_IS_SOURCE_MAX];
+/* I-Am responses are delayed by a random time within this window */
+static uint16_t Who_Is_Window_Milliseconds;
+/* Who-Is from the same source are ignored for this long after a response */
+static uint16_t Who_Is_Source_Milliseconds;
+static uint32_t Who_Is_Random_Seed;
+static BACNET_WHO_IS_STATISTICS Who_Is_Statistics;
+
+/**
+ * @brief Configure the I-Am response scheduler.  When the window is
+ *  non-zero, each I-Am response is delayed by a random time within the
+ *  window, and Who-Is requests that arrive before the response is sent
+ *  are answered by the same I-Am.  When the source interval is non-zero,
+ *  Who-Is requests from a source that was answered less than the interval
+ *  ago are ignored.  Both are zero by default, which answers every Who-Is
+ *  immediately.  handler_who_is_timer() sends the delayed responses.
+ * @param window_ms - I-Am response window, in milliseconds
+ * @param source_interval_ms - minimum time between responses to the
+ *  same source, in milliseconds
+ */
+void handler_who_is_scheduler_init(
+    uint16_t window_ms, uint16_t source_interval_ms)
+{
+    Who_Is_Window_Milliseconds = window_ms;
+    Who_Is_Source_Milliseconds = source_interval_ms;
+    memset(Who_Is_Pending, 0, sizeof(Who_Is_Pending));
+    memset(Who_Is_Source, 0, sizeof(Who_Is_Source));
+    /* devices must not pick the same delays, so seed with our instance */
+    Who_Is_Random_Seed = Device_Object_Instance_Number() ^ 0x5DEECE66UL;
+    if (Who_Is_Random_Seed == 0) {
+        Who_Is_Random_Seed = 1;
+    }
+}
+
+/**
+ * @brief Get the Who-Is handler counters
+ * @param stats - counters are copied here
+ */
+void handler_who_is_statistics(BACNET_WHO_IS_STATISTICS *stats)
+{
+    if (stats) {
+        *stats = Who_Is_Statistics;
+    }
+}
+
+/**
+ * @brief Reset the Who-Is handler counters
+ */
+void handler_who_is_statistics_reset(void)
+{
+    memset(&Who_Is_Statistics, 0, sizeof(Who_Is_Statistics));
+}
+
+/**
+ * @brief Random delay within the I-Am response window
+ * @return delay in milliseconds
+ */
+static uint16_t who_is_random_delay(void)
+{
+    uint32_t x = Who_Is_Random_Seed;
+
+    /* xorshift32 */
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    Who_Is_Random_Seed = x;
+
+    return (uint16_t)(x % ((uint32_t)Who_Is_Window_Milliseconds + 1));
+}
+
+/**
+ * @brief Send an I-Am for one of our devices
+ * @param dest - destination of a unicast I-Am, or NULL to broadcast
+ * @param device_index - routed device index, or -1 for our device
+ */
+static void who_is_send_i_am(BACNET_ADDRESS *dest, int device_index)
+{
+#ifdef BAC_ROUTING
+    /* select the routed device that is answering */
+    (void)Get_Routed_Device_Object(device_index);
+#else
+    (void)device_index;
+#endif
+    if (dest) {
+        Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], dest);
+    } else {
+        Send_I_Am(&Handler_Transmit_Buffer[0]);
+    }
+    Who_Is_Statistics.i_am_sent++;
+}
+
+/**
+ * @brief Apply the per source rate limit to a Who-Is request
+ * @param src - source of the Who-Is request
+ * @return true if the Who-Is request is to be answered
+ */
+static bool who_is_source_permitted(BACNET_ADDRESS *src)
+{
+    unsigned i;
+    unsigned oldest = 0;
+
+    if ((Who_Is_Source_Milliseconds == 0) || (src == NULL)) {
+        return true;
+    }
+    for (i = 0; i < WHO_IS_SOURCE_MAX; i++) {
+        if ((Who_Is_Source[i].milliseconds > 0) &&
+            bacnet_address_same(&Who_Is_Source[i].address, src)) {
+            Who_Is_Statistics.who_is_rate_limited++;
+            return false;
+        }
+        if (Who_Is_Source[i].milliseconds <
+            Who_Is_Source[oldest].milliseconds) {
+            oldest = i;
+        }
+    }
+    /* remember this source in the slot that expires soonest */
+    Who_Is_Source[oldest].milliseconds = Who_Is_Source_Milliseconds;
+    bacnet_address_copy(&Who_Is_Source[oldest].address, src);
+
+    return true;
+}
+
+/**
+ * @brief Schedule an I-Am response, or send it now when the scheduler
+ *  window is zero.  A response that is already waiting for the same
+ *  device and destination absorbs the new request.  When no slot is
+ *  free, a unicast response is turned into a broadcast response.
+ * @param dest - destination of a unicast I-Am, or NULL to broadcast
+ * @param device_index - routed device index, or -1 for our device
+ */
+static void who_is_respond(BACNET_ADDRESS *dest, int device_index)
+{
+    unsigned i;
+    struct who_is_pending *slot = NULL;
+    bool unicast = (dest != NULL);
+
+    if (Who_Is_Window_Milliseconds == 0) {
+        who_is_send_i_am(dest, device_index);
+        return;
+    }
+    for (i = 0; i < WHO_IS_PENDING_MAX; i++) {
+        if (Who_Is_Pending[i].active) {
+            if ((Who_Is_Pending[i].device_index == device_index) &&
+                (Who_Is_Pending[i].unicast == unicast) &&
+                (!unicast ||
+                    bacnet_address_same(&Who_Is_Pending[i].dest, dest))) {
+                Who_Is_Statistics.i_am_coalesced++;
+                return;
+            }
+        } else if (!slot) {
+            slot = &Who_Is_Pending[i];
+        }
+    }
+    if (!slot) {
+        if (unicast) {
+            who_is_respond(NULL, device_index);
+        } else {
+            /* every slot is a unicast response: answer now */
+            who_is_send_i_am(NULL, device_index);
+        }
+        return;
+    }
+    slot->active = true;
+    slot->unicast = unicast;
+    slot->device_index = device_index;
+    slot->milliseconds = who_is_random_delay();
+    if (unicast) {
+        bacnet_address_copy(&slot->dest, dest);
+    }
+}
+
+/**
+ * @brief Send the scheduled I-Am responses that are due, and age the
+ *  per source rate limit.  Call this periodically when the scheduler
+ *  is configured with handler_who_is_scheduler_init().
+ * @param milliseconds - time elapsed since the last call
+ */
+void handler_who_is_timer(uint16_t milliseconds)
+{
+    unsigned i;
+
+    for (i = 0; i < WHO_IS_SOURCE_MAX; i++) {
+        if (Who_Is_Source[i].milliseconds > milliseconds) {
+            Who_Is_Source[i].milliseconds -= milliseconds;
+        } else {
+            Who_Is_Source[i].milliseconds = 0;
+        }
+    }
+    for (i = 0; i < WHO_IS_PENDING_MAX; i++) {
+        if (!Who_Is_Pending[i].active) {
+            continue;
+        }
+        if (Who_Is_Pending[i].milliseconds > milliseconds) {
+            Who_Is_Pending[i].milliseconds -= milliseconds;
+        } else {
+            Who_Is_Pending[i].active = false;
+            who_is_send_i_am(
+                Who_Is_Pending[i].unicast ? &Who_Is_Pending[i].dest : NULL,
+                Who_Is_Pending[i].device_index);
+        }
+    }
+}
+
 /** Handler for Who-Is requests, with broadcast I-Am response.
  * @ingroup DMDDB
  * @param service_request [in] The received message to be handled.
  * @param service_len [in] Length of the service_request message.
- * @param src [in] The BACNET_ADDRESS of the message's source (ignored).
+ * @param src [in] The BACNET_ADDRESS of the message's source, used
+ *                 for the per source rate limit.
  */
 void handler_who_is(
     uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
@@ -51,16 +277,18 @@ void handler_who_is(
     int32_t low_limit = 0;
     int32_t high_limit = 0;
 
-    (void)src;
     len = whois_decode_service_request(
         service_request, service_len, &low_limit, &high_limit);
-    if (len == 0) {
-        Send_I_Am(&Handler_Transmit_Buffer[0]);
-    } else if (len != BACNET_STATUS_ERROR) {
-        /* is my device id within the limits? */
-        if ((Device_Object_Instance_Number() >= (uint32_t)low_limit) &&
-            (Device_Object_Instance_Number() <= (uint32_t)high_limit)) {
-            Send_I_Am(&Handler_Transmit_Buffer[0]);
+    if (len == BACNET_STATUS_ERROR) {
+        return;
+    }
+    Who_Is_Statistics.who_is_received++;
+    /* If no limits, then always respond */
+    if ((len == 0) ||
+        ((Device_Object_Instance_Number() >= (uint32_t)low_limit) &&
+            (Device_Object_Instance_Number() <= (uint32_t)high_limit))) {
+        if (who_is_source_permitted(src)) {
+            who_is_respond(NULL, -1);
         }
     }
 
@@ -84,14 +312,16 @@ void handler_who_is_unicast(
 
     len = whois_decode_service_request(
         service_request, service_len, &low_limit, &high_limit);
+    if (len == BACNET_STATUS_ERROR) {
+        return;
+    }
+    Who_Is_Statistics.who_is_received++;
     /* If no limits, then always respond */
-    if (len == 0) {
-        Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
-    } else if (len != BACNET_STATUS_ERROR) {
-        /* is my device id within the limits? */
-        if ((Device_Object_Instance_Number() >= (uint32_t)low_limit) &&
-            (Device_Object_Instance_Number() <= (uint32_t)high_limit)) {
-            Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+    if ((len == 0) ||
+        ((Device_Object_Instance_Number() >= (uint32_t)low_limit) &&
+            (Device_Object_Instance_Number() <= (uint32_t)high_limit))) {
+        if (who_is_source_permitted(src)) {
+            who_is_respond(src, -1);
         }
     }
 
@@ -126,8 +356,10 @@ static void check_who_is_for_routing(uint8_t *service_request,
     int32_t high_limit = 0;
     int32_t dev_instance;
     int cursor = 0; /* Starting hint */
+    int device_index;
     int my_list[2] = { 0, -1 }; /* Not really used, so dummy values */
     BACNET_ADDRESS bcast_net;
+    bool permitted = false;
 
     len = whois_decode_service_request(
         service_request, service_len, &low_limit, &high_limit);
@@ -135,20 +367,29 @@ static void check_who_is_for_routing(uint8_t *service_request,
         /* Invalid; just leave */
         return;
     }
+    Who_Is_Statistics.who_is_received++;
     /* Go through all devices, starting with the root gateway Device */
     memset(&bcast_net, 0, sizeof(BACNET_ADDRESS));
     bcast_net.net = BACNET_BROADCAST_NETWORK; /* That's all we have to set */
 
+    /* for broadcasts, the cursor is the index of the next Device */
+    device_index = cursor;
     while (Routed_Device_GetNext(&bcast_net, my_list, &cursor)) {
         dev_instance = Device_Object_Instance_Number();
         /* If len == 0, no limits and always respond */
         if ((len == 0) ||
             ((dev_instance >= low_limit) && (dev_instance <= high_limit))) {
-            if (is_unicast)
-                Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
-            else
-                Send_I_Am(&Handler_Transmit_Buffer[0]);
+            /* the rate limit applies once per request, and only when a
+               device is in range */
+            if (!permitted) {
+                if (!who_is_source_permitted(src)) {
+                    return;
+                }
+                permitted = true;
+            }
+            who_is_respond(is_unicast ? src : NULL, device_index);
         }
+        device_index = cursor;
     }
 }
 
@@ -37,6 +37,13 @@
 #include "bacnet/bacenum.h"
 #include "bacnet/apdu.h"
 
+typedef struct bacnet_who_is_statistics {
+    uint32_t who_is_received;
+    uint32_t who_is_rate_limited;
+    uint32_t i_am_coalesced;
+    uint32_t i_am_sent;
+} BACNET_WHO_IS_STATISTICS;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -65,6 +72,23 @@ extern "C" {
         uint16_t service_len,
         BACNET_ADDRESS * src);
 
+    BACNET_STACK_EXPORT
+    void handler_who_is_scheduler_init(
+        uint16_t window_ms,
+        uint16_t source_interval_ms);
+
+    BACNET_STACK_EXPORT
+    void handler_who_is_timer(
+        uint16_t milliseconds);
+
+    BACNET_STACK_EXPORT
+    void handler_who_is_statistics(
+        BACNET_WHO_IS_STATISTICS * stats);
+
+    BACNET_STACK_EXPORT
+    void handler_who_is_statistics_reset(
+        void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -42,6 +42,7 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** @file h_wpm.c  Handles Write Property Multiple requests. */
@@ -194,7 +195,9 @@ void handler_write_property_multiple(uint8_t *service_request,
     pdu_len = npdu_len + apdu_len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
-    if (bytes_sent <= 0) {
+    if (bytes_sent > 0) {
+        METRICS_APDU_SENT(&Handler_Transmit_Buffer[npdu_len], apdu_len);
+    } else {
         PRINTF("Failed to send PDU (%s)!\n", strerror(errno));
     }
 }
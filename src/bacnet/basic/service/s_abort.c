@@ -38,6 +38,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 /** Encodes an Abort message
@@ -97,6 +98,9 @@ int Send_Abort_To_Network(uint8_t *buffer,
     pdu_len = abort_encode_pdu(
         buffer, dest, &src, &npdu_data, invoke_id, reason, server);
     bytes_sent = datalink_send_pdu(dest, &npdu_data, &buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        METRICS_COUNT(METRICS_APDU_ABORT_TX);
+    }
 
     return bytes_sent;
 }
@@ -91,7 +91,8 @@ uint8_t Send_Alarm_Acknowledgement_Address(uint8_t *pdu,
         if ((uint16_t)pdu_len < pdu_size) {
             tsm_set_confirmed_unsegmented_transaction(
                 invoke_id, dest, &npdu_data, pdu, (uint16_t)pdu_len);
-            bytes_sent = datalink_send_pdu(dest, &npdu_data, pdu, pdu_len);
+            bytes_sent = tsm_send_pdu(
+                invoke_id, dest, &npdu_data, pdu, pdu_len);
             if (bytes_sent <= 0) {
                 PRINTF("Failed to Send Alarm Ack Request (%s)!\n",
                     strerror(errno));
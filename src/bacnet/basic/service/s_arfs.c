@@ -97,8 +97,8 @@ uint8_t Send_Atomic_Read_File_Stream(uint32_t device_id,
 #if PRINT_ENABLED
             bytes_sent =
 #endif
-                datalink_send_pdu(
-                    &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+                tsm_send_pdu(invoke_id, &dest, &npdu_data,
+                    &Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
             if (bytes_sent <= 0)
                 fprintf(stderr, "Failed to Send AtomicReadFile Request (%s)!\n",
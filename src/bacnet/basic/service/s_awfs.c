@@ -99,7 +99,7 @@ uint8_t Send_Atomic_Write_File_Stream(uint32_t device_id,
 #if PRINT_ENABLED
                 bytes_sent =
 #endif
-                    datalink_send_pdu(&dest, &npdu_data,
+                    tsm_send_pdu(invoke_id, &dest, &npdu_data,
                         &Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
                 if (bytes_sent <= 0)
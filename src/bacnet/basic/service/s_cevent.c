@@ -88,7 +88,7 @@ uint8_t Send_CEvent_Notify_Address(uint8_t *pdu,
 #if PRINT_ENABLED
             bytes_sent =
 #endif
-                datalink_send_pdu(dest, &npdu_data, pdu, pdu_len);
+                tsm_send_pdu(invoke_id, dest, &npdu_data, pdu, pdu_len);
 #if PRINT_ENABLED
             if (bytes_sent <= 0) {
                 fprintf(stderr,
@@ -100,7 +100,7 @@ int Send_UCOV_Notify(
 
     pdu_len =
         ucov_notify_encode_pdu(buffer, buffer_len, &dest, &npdu_data, cov_data);
-    bytes_sent = datalink_send_pdu(&dest, &npdu_data, &buffer[0], pdu_len);
+    bytes_sent = tsm_send_pdu(0, &dest, &npdu_data, &buffer[0], pdu_len);
 
     return bytes_sent;
 }
@@ -161,8 +161,8 @@ uint8_t Send_COV_Subscribe(
         if ((unsigned)pdu_len < max_apdu) {
             tsm_set_confirmed_unsegmented_transaction(invoke_id, &dest,
                 &npdu_data, &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
-            bytes_sent = datalink_send_pdu(
-                &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+            bytes_sent = tsm_send_pdu(invoke_id, &dest, &npdu_data,
+                &Handler_Transmit_Buffer[0], pdu_len);
             if (bytes_sent <= 0) {
 #if PRINT_ENABLED
                 fprintf(stderr, "Failed to Send SubscribeCOV Request (%s)!\n",
@@ -40,6 +40,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 
 /** Encodes an Error message
  * @param buffer The buffer to build the message for sending.
@@ -101,6 +102,9 @@ int Send_Error_To_Network(uint8_t *buffer,
     pdu_len = error_encode_pdu(buffer, dest, &src, &npdu_data, invoke_id,
         service, error_class, error_code);
     bytes_sent = datalink_send_pdu(dest, &npdu_data, &buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        METRICS_COUNT(METRICS_APDU_ERROR_TX);
+    }
 
     return bytes_sent;
 }
@@ -81,8 +81,8 @@ uint8_t Send_Get_Alarm_Summary_Address(BACNET_ADDRESS *dest, uint16_t max_apdu)
 #if PRINT_ENABLED
             bytes_sent =
 #endif
-                datalink_send_pdu(
-                    dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+                tsm_send_pdu(invoke_id, dest, &npdu_data,
+                    &Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
             if (bytes_sent <= 0)
                 fprintf(stderr,
@@ -75,7 +75,7 @@ uint8_t Send_GetEvent(BACNET_ADDRESS *target_address,
 #if PRINT_ENABLED
         bytes_sent =
 #endif
-            datalink_send_pdu(target_address, &npdu_data,
+            tsm_send_pdu(0, target_address, &npdu_data,
                 &Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
         if (bytes_sent <= 0)
@@ -72,8 +72,8 @@ void Send_I_Am_To_Network(BACNET_ADDRESS *target_address,
     len = iam_encode_apdu(&Handler_Transmit_Buffer[pdu_len], device_id,
         max_apdu, segmentation, vendor_id);
     pdu_len += len;
-    bytes_sent = datalink_send_pdu(
-        target_address, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bytes_sent = tsm_send_pdu(
+        0, target_address, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent <= 0) {
 #if PRINT_ENABLED
         fprintf(stderr, "Failed to Send I-Am Request (%s)!\n", strerror(errno));
@@ -135,7 +135,7 @@ void Send_I_Am(uint8_t *buffer)
     /* encode the data */
     pdu_len = iam_encode_pdu(buffer, &dest, &npdu_data);
     /* send data */
-    bytes_sent = datalink_send_pdu(&dest, &npdu_data, &buffer[0], pdu_len);
+    bytes_sent = tsm_send_pdu(0, &dest, &npdu_data, &buffer[0], pdu_len);
 
     if (bytes_sent <= 0) {
 #if PRINT_ENABLED
@@ -212,7 +212,7 @@ void Send_I_Am_Unicast(uint8_t *buffer, BACNET_ADDRESS *src)
     /* encode the data */
     pdu_len = iam_unicast_encode_pdu(buffer, src, &dest, &npdu_data);
     /* send data */
-    bytes_sent = datalink_send_pdu(&dest, &npdu_data, &buffer[0], pdu_len);
+    bytes_sent = tsm_send_pdu(0, &dest, &npdu_data, &buffer[0], pdu_len);
 
     if (bytes_sent <= 0) {
 #if PRINT_ENABLED
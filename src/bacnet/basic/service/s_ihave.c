@@ -84,8 +84,8 @@ void Send_I_Have(uint32_t device_id,
     len = ihave_encode_apdu(&Handler_Transmit_Buffer[pdu_len], &data);
     pdu_len += len;
     /* send the data */
-    bytes_sent = datalink_send_pdu(
-        &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bytes_sent = tsm_send_pdu(
+        0, &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent <= 0) {
 #if PRINT_ENABLED
         fprintf(stderr, "Failed to Send I-Have Reply (%s)!\n", strerror(errno));
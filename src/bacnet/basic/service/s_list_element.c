@@ -108,8 +108,8 @@ uint8_t Send_List_Element_Request_Data(
         if ((unsigned)pdu_len < max_apdu) {
             tsm_set_confirmed_unsegmented_transaction(invoke_id, &dest,
                 &npdu_data, &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
-            bytes_sent = datalink_send_pdu(
-                &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+            bytes_sent = tsm_send_pdu(invoke_id, &dest, &npdu_data,
+                &Handler_Transmit_Buffer[0], pdu_len);
             if (bytes_sent <= 0) {
                 debug_perror("%s service: Failed to Send %i/%i (%s)!\n",
                     bactext_confirmed_service_name(service), bytes_sent,
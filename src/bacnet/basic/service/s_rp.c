@@ -103,8 +103,8 @@ uint8_t Send_Read_Property_Request_Address(BACNET_ADDRESS *dest,
         if ((uint16_t)pdu_len < max_apdu) {
             tsm_set_confirmed_unsegmented_transaction(invoke_id, dest,
                 &npdu_data, &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
-            bytes_sent = datalink_send_pdu(
-                dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+            bytes_sent = tsm_send_pdu(invoke_id, dest, &npdu_data,
+                &Handler_Transmit_Buffer[0], pdu_len);
             if (bytes_sent <= 0) {
 #if PRINT_ENABLED
                 fprintf(stderr, "Failed to Send ReadProperty Request (%s)!\n",
@@ -76,8 +76,7 @@ void Send_TimeSync_Remote(
 #if PRINT_ENABLED
     bytes_sent =
 #endif
-        datalink_send_pdu(
-            dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+        tsm_send_pdu(0, dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(stderr, "Failed to Send Time-Synchronization Request (%s)!\n",
@@ -133,8 +132,7 @@ void Send_TimeSyncUTC_Remote(
 #if PRINT_ENABLED
     bytes_sent =
 #endif
-        datalink_send_pdu(
-            dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+        tsm_send_pdu(0, dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(stderr,
@@ -29,6 +29,7 @@
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/tsm/tsm.h"
 
 /** @file s_uevent.c  Send an Unconfirmed Event Notification. */
 
@@ -57,7 +58,7 @@ int Send_UEvent_Notify(
     len = uevent_notify_encode_apdu(&buffer[pdu_len], data);
     pdu_len += len;
     /* send the data */
-    bytes_sent = datalink_send_pdu(dest, &npdu_data, &buffer[0], pdu_len);
+    bytes_sent = tsm_send_pdu(0, dest, &npdu_data, &buffer[0], pdu_len);
 
     return bytes_sent;
 }
@@ -65,8 +65,8 @@ int Send_UnconfirmedPrivateTransfer(
     len =
         uptransfer_encode_apdu(&Handler_Transmit_Buffer[pdu_len], private_data);
     pdu_len += len;
-    bytes_sent = datalink_send_pdu(
-        dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bytes_sent = tsm_send_pdu(
+        0, dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent <= 0) {
 #if PRINT_ENABLED
         fprintf(stderr,
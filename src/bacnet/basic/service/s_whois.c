@@ -75,8 +75,8 @@ void Send_WhoIs_To_Network(
     len = whois_encode_apdu(
         &Handler_Transmit_Buffer[pdu_len], low_limit, high_limit);
     pdu_len += len;
-    bytes_sent = datalink_send_pdu(
-        target_address, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bytes_sent = tsm_send_pdu(
+        0, target_address, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(
@@ -99,8 +99,8 @@ uint8_t Send_Write_Property_Request_Data(uint32_t device_id,
         if ((unsigned)pdu_len < max_apdu) {
             tsm_set_confirmed_unsegmented_transaction(invoke_id, &dest,
                 &npdu_data, &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
-            bytes_sent = datalink_send_pdu(
-                &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+            bytes_sent = tsm_send_pdu(invoke_id, &dest, &npdu_data,
+                &Handler_Transmit_Buffer[0], pdu_len);
             if (bytes_sent <= 0) {
 #if PRINT_ENABLED
                 fprintf(stderr, "Failed to Send WriteProperty Request (%s)!\n",
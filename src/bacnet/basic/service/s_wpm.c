@@ -104,7 +104,7 @@ uint8_t Send_Write_Property_Multiple_Request(uint8_t *pdu,
 #if PRINT_ENABLED
             bytes_sent =
 #endif
-                datalink_send_pdu(&dest, &npdu_data, &pdu[0], pdu_len);
+                tsm_send_pdu(invoke_id, &dest, &npdu_data, &pdu[0], pdu_len);
 #if PRINT_ENABLED
             if (bytes_sent <= 0) {
                 fprintf(stderr,
@@ -41,7 +41,10 @@
 #include "bacnet/basic/service/h_awf.h"
 #include "bacnet/basic/service/h_ccov.h"
 #include "bacnet/basic/service/h_cov.h"
+#include "bacnet/basic/service/h_create_object.h"
 #include "bacnet/basic/service/h_dcc.h"
+#include "bacnet/basic/service/h_delete_object.h"
+#include "bacnet/basic/service/h_event_index.h"
 #include "bacnet/basic/service/h_gas_a.h"
 #include "bacnet/basic/service/h_get_alarm_sum.h"
 #include "bacnet/basic/service/h_getevent.h"
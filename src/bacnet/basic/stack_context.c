@@ -0,0 +1,193 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Stack context to host many BACnet devices in one process
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/service/h_cov.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/basic/stack_context.h"
+
+/* each module state starts on this boundary within the context memory */
+#define STACK_CONTEXT_ALIGN(n) (((n) + 15) & ~((size_t)15))
+
+struct bacnet_stack_context {
+    uint32_t device_instance;
+    bool allocated;
+    void *address;
+    void *tsm;
+    void *cov;
+    void *device;
+};
+
+/* the selected stack context, or NULL for the default context */
+static BACNET_STACK_CONTEXT *Stack_Context;
+
+/**
+ * @brief Get the size of the memory used by one stack context.  Many
+ *  stack contexts can be carved from one memory pool of this size each.
+ * @return size of one stack context, in bytes
+ */
+size_t stack_context_size(void)
+{
+    size_t size;
+
+    size = STACK_CONTEXT_ALIGN(sizeof(struct bacnet_stack_context));
+    size += STACK_CONTEXT_ALIGN(address_context_size());
+    size += STACK_CONTEXT_ALIGN(tsm_context_size());
+    size += STACK_CONTEXT_ALIGN(handler_cov_context_size());
+    size += STACK_CONTEXT_ALIGN(Device_Context_Size());
+
+    return size;
+}
+
+/**
+ * @brief Initialize a stack context in memory given by the caller
+ * @param buffer - memory of stack_context_size() bytes, aligned for
+ *  any type, for example from malloc() or a memory pool
+ * @param size - size of the memory, in bytes
+ * @param device_instance - Device object instance of this stack
+ * @return the stack context, or NULL if the memory is too small or
+ *  the device instance is not valid
+ */
+BACNET_STACK_CONTEXT *stack_context_init(
+    void *buffer, size_t size, uint32_t device_instance)
+{
+    BACNET_STACK_CONTEXT *context = buffer;
+    BACNET_STACK_CONTEXT *previous;
+    uint8_t *memory = buffer;
+    size_t offset;
+
+    if (!buffer || (size < stack_context_size()) ||
+        (device_instance > BACNET_MAX_INSTANCE)) {
+        return NULL;
+    }
+    memset(context, 0, sizeof(struct bacnet_stack_context));
+    context->device_instance = device_instance;
+    offset = STACK_CONTEXT_ALIGN(sizeof(struct bacnet_stack_context));
+    context->address = &memory[offset];
+    offset += STACK_CONTEXT_ALIGN(address_context_size());
+    context->tsm = &memory[offset];
+    offset += STACK_CONTEXT_ALIGN(tsm_context_size());
+    context->cov = &memory[offset];
+    offset += STACK_CONTEXT_ALIGN(handler_cov_context_size());
+    context->device = &memory[offset];
+    address_context_init(context->address);
+    tsm_context_init(context->tsm);
+    handler_cov_context_init(context->cov);
+    Device_Context_Init(context->device);
+    previous = stack_context_select(context);
+    Device_Set_Object_Instance_Number(device_instance);
+    address_own_device_id_set(device_instance);
+    (void)stack_context_select(previous);
+
+    return context;
+}
+
+/**
+ * @brief Create a stack context using one allocation for all its state
+ * @param device_instance - Device object instance of this stack
+ * @return the stack context, or NULL if there is no memory or
+ *  the device instance is not valid
+ */
+BACNET_STACK_CONTEXT *stack_context_create(uint32_t device_instance)
+{
+    BACNET_STACK_CONTEXT *context;
+    void *buffer;
+    size_t size;
+
+    size = stack_context_size();
+    buffer = malloc(size);
+    context = stack_context_init(buffer, size, device_instance);
+    if (context) {
+        context->allocated = true;
+    } else {
+        free(buffer);
+    }
+
+    return context;
+}
+
+/**
+ * @brief Delete a stack context.  If it is selected, the default
+ *  stack context is selected.
+ * @param context - stack context from stack_context_create() or
+ *  stack_context_init()
+ */
+void stack_context_delete(BACNET_STACK_CONTEXT *context)
+{
+    if (!context) {
+        return;
+    }
+    if (context == Stack_Context) {
+        (void)stack_context_select(NULL);
+    }
+    if (context->allocated) {
+        free(context);
+    }
+}
+
+/**
+ * @brief Select the stack context used by the address cache, TSM,
+ *  COV, and Device object functions
+ * @param context - stack context, or NULL for the default context
+ * @return the previously selected stack context, or NULL for the default
+ */
+BACNET_STACK_CONTEXT *stack_context_select(BACNET_STACK_CONTEXT *context)
+{
+    BACNET_STACK_CONTEXT *previous = Stack_Context;
+
+    if (context != Stack_Context) {
+        if (context) {
+            (void)address_context_select(context->address);
+            (void)tsm_context_select(context->tsm);
+            (void)handler_cov_context_select(context->cov);
+            (void)Device_Context_Select(context->device);
+        } else {
+            (void)address_context_select(NULL);
+            (void)tsm_context_select(NULL);
+            (void)handler_cov_context_select(NULL);
+            (void)Device_Context_Select(NULL);
+        }
+        Stack_Context = context;
+    }
+
+    return previous;
+}
+
+/**
+ * @brief Get the selected stack context
+ * @return the selected stack context, or NULL for the default context
+ */
+BACNET_STACK_CONTEXT *stack_context_selected(void)
+{
+    return Stack_Context;
+}
+
+/**
+ * @brief Get the Device object instance a stack context was created for
+ * @param context - stack context
+ * @return Device object instance, or BACNET_MAX_INSTANCE+1 if NULL
+ */
+uint32_t stack_context_device_instance(BACNET_STACK_CONTEXT *context)
+{
+    if (context) {
+        return context->device_instance;
+    }
+
+    return BACNET_MAX_INSTANCE + 1;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Stack context to host many BACnet devices in one process
+ *
+ * @section DESCRIPTION
+ *
+ * A stack context carries the state of one BACnet device stack:
+ * the address cache, the TSM transactions, the COV subscriptions, and
+ * the Device object with its object table.  The existing API operates
+ * on the selected stack context, and selecting NULL returns to the
+ * default context, so single device applications are unchanged.
+ *
+ * To host many devices, create a context for each device, and select
+ * it before handling a received PDU or running the timers of that
+ * device from the shared event loop.  The handlers run to completion,
+ * so the Handler_Transmit_Buffer and the datalink are shared by all
+ * of the stack contexts.
+ *
+ * Not yet per stack context, and shared by all of the stack contexts:
+ * - the object instances of each object type, such as the Analog Input
+ *   or Binary Input tables, and the Notification Class recipients
+ * - the active event index of GetEventInformation and GetAlarmSummary
+ * - the Notification Class event queue and its recipient bindings
+ * - the Who-Is rate limit and the routed device table
+ * - the read/write task and write batches of the client
+ * - the performance counters, which are per thread
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_STACK_CONTEXT_H
+#define BACNET_BASIC_STACK_CONTEXT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bacnet/bacnet_stack_exports.h"
+
+typedef struct bacnet_stack_context BACNET_STACK_CONTEXT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+size_t stack_context_size(void);
+BACNET_STACK_EXPORT
+BACNET_STACK_CONTEXT *stack_context_init(
+    void *buffer, size_t size, uint32_t device_instance);
+BACNET_STACK_EXPORT
+BACNET_STACK_CONTEXT *stack_context_create(uint32_t device_instance);
+BACNET_STACK_EXPORT
+void stack_context_delete(BACNET_STACK_CONTEXT *context);
+
+BACNET_STACK_EXPORT
+BACNET_STACK_CONTEXT *stack_context_select(BACNET_STACK_CONTEXT *context);
+BACNET_STACK_EXPORT
+BACNET_STACK_CONTEXT *stack_context_selected(void);
+BACNET_STACK_EXPORT
+uint32_t stack_context_device_instance(BACNET_STACK_CONTEXT *context);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -93,13 +93,18 @@ static int CheckArraySize(OS_Keylist list)
         return FALSE;
     }
 
-    /* indicates the need for more memory allocation */
+    /* indicates the need for more memory allocation - the size doubles,
+       so adding a large number of nodes is not quadratic */
     if (list->count == list->size) {
-        new_size = list->size + chunk;
+        if (list->size < chunk) {
+            new_size = chunk;
+        } else {
+            new_size = list->size * 2;
+        }
 
         /* allow for shrinking memory */
-    } else if ((list->size > chunk) && (list->count < (list->size - chunk))) {
-        new_size = list->size - chunk;
+    } else if ((list->size > chunk) && (list->count < (list->size / 4))) {
+        new_size = list->size / 2;
     }
     if (new_size > 0) {
         /* Allocate more room for node pointer array */
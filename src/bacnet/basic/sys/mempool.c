@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief A pool of fixed size elements, allocated in slabs, so that
+ *  thousands of objects of the same size cost a few heap allocations
+ *  and are freed and reused in constant time.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/basic/sys/mempool.h"
+
+/* the alignment of the elements, and of the first element in a slab */
+union mempool_align {
+    void *pointer;
+    double real;
+    long integer;
+};
+#define MEMPOOL_ALIGN sizeof(union mempool_align)
+
+/**
+ * @brief Initialize a pool of elements.  The slabs of a pool that was
+ *  already initialized are freed, so the pool must be zero filled,
+ *  such as a static pool, before it is first initialized.
+ * @param pool - pool to initialize
+ * @param element_size - size of each element, in bytes
+ * @param slab_count - number of elements to allocate in each slab
+ */
+void Mempool_Init(MEMPOOL *pool, size_t element_size, unsigned slab_count)
+{
+    if (!pool) {
+        return;
+    }
+    Mempool_Cleanup(pool);
+    if (element_size < sizeof(void *)) {
+        /* free elements hold the free list link */
+        element_size = sizeof(void *);
+    }
+    pool->element_size =
+        (element_size + MEMPOOL_ALIGN - 1) & ~(MEMPOOL_ALIGN - 1);
+    if (slab_count == 0) {
+        slab_count = 1;
+    }
+    pool->slab_count = slab_count;
+}
+
+/**
+ * @brief Add a slab of elements to the free list of the pool
+ * @param pool - pool of elements
+ * @return true if the slab was allocated
+ */
+static bool Mempool_Slab_Add(MEMPOOL *pool)
+{
+    uint8_t *slab;
+    uint8_t *element;
+    unsigned i;
+
+    slab = malloc(MEMPOOL_ALIGN + (pool->element_size * pool->slab_count));
+    if (!slab) {
+        return false;
+    }
+    *(void **)slab = pool->slab_list;
+    pool->slab_list = slab;
+    /* link the elements in order, so they are allocated in order */
+    element = slab + MEMPOOL_ALIGN;
+    for (i = 0; i < pool->slab_count; i++) {
+        if ((i + 1) < pool->slab_count) {
+            *(void **)element = element + pool->element_size;
+        } else {
+            *(void **)element = pool->free_list;
+        }
+        element += pool->element_size;
+    }
+    pool->free_list = slab + MEMPOOL_ALIGN;
+    pool->size += pool->slab_count;
+
+    return true;
+}
+
+/**
+ * @brief Allocate an element from the pool
+ * @param pool - pool of elements
+ * @return element that is zero filled, or NULL if no memory is available
+ */
+void *Mempool_Alloc(MEMPOOL *pool)
+{
+    void *element = NULL;
+
+    if (!pool || (pool->element_size == 0)) {
+        return NULL;
+    }
+    if (!pool->free_list) {
+        if (!Mempool_Slab_Add(pool)) {
+            return NULL;
+        }
+    }
+    element = pool->free_list;
+    pool->free_list = *(void **)element;
+    memset(element, 0, pool->element_size);
+    pool->count++;
+
+    return element;
+}
+
+/**
+ * @brief Return an element to the pool
+ * @param pool - pool of elements
+ * @param element - element from Mempool_Alloc() of the same pool
+ */
+void Mempool_Free(MEMPOOL *pool, void *element)
+{
+    if (!pool || !element) {
+        return;
+    }
+    *(void **)element = pool->free_list;
+    pool->free_list = element;
+    if (pool->count) {
+        pool->count--;
+    }
+}
+
+/**
+ * @brief Free all the slabs of the pool.  Any elements that are still
+ *  allocated from the pool are no longer valid.
+ * @param pool - pool of elements
+ */
+void Mempool_Cleanup(MEMPOOL *pool)
+{
+    void *slab;
+
+    if (!pool) {
+        return;
+    }
+    while (pool->slab_list) {
+        slab = pool->slab_list;
+        pool->slab_list = *(void **)slab;
+        free(slab);
+    }
+    pool->free_list = NULL;
+    pool->count = 0;
+    pool->size = 0;
+}
+
+/**
+ * @brief Get the number of elements that are allocated from the pool
+ * @param pool - pool of elements
+ * @return number of allocated elements
+ */
+unsigned long Mempool_Count(MEMPOOL const *pool)
+{
+    if (!pool) {
+        return 0;
+    }
+
+    return pool->count;
+}
+
+/**
+ * @brief Get the number of elements in all the slabs of the pool
+ * @param pool - pool of elements
+ * @return number of allocated and free elements
+ */
+unsigned long Mempool_Size(MEMPOOL const *pool)
+{
+    if (!pool) {
+        return 0;
+    }
+
+    return pool->size;
+}
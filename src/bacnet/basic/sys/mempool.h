@@ -0,0 +1,71 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief API for a pool of fixed size elements, allocated in slabs
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacnet_stack_exports.h"
+
+/**
+ * Pool of fixed size elements.  The elements are allocated from slabs of
+ * slab_count elements, and freed elements are kept in a free list for the
+ * next allocation.  The slabs are only returned to the heap by
+ * Mempool_Cleanup(), or by initializing the pool again.
+ *
+ * @{
+ */
+struct mempool_t {
+    /** size of each element, rounded up for alignment */
+    size_t element_size;
+    /** number of elements in each slab */
+    unsigned slab_count;
+    /** the slabs, linked through their first word */
+    void *slab_list;
+    /** the free elements, linked through their first word */
+    void *free_list;
+    /** number of allocated elements */
+    unsigned long count;
+    /** number of elements in all the slabs */
+    unsigned long size;
+};
+typedef struct mempool_t MEMPOOL;
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+    BACNET_STACK_EXPORT
+    void Mempool_Init(
+        MEMPOOL *pool,
+        size_t element_size,
+        unsigned slab_count);
+    BACNET_STACK_EXPORT
+    void *Mempool_Alloc(
+        MEMPOOL *pool);
+    BACNET_STACK_EXPORT
+    void Mempool_Free(
+        MEMPOOL *pool,
+        void *element);
+    BACNET_STACK_EXPORT
+    void Mempool_Cleanup(
+        MEMPOOL *pool);
+    BACNET_STACK_EXPORT
+    unsigned long Mempool_Count(
+        MEMPOOL const *pool);
+    BACNET_STACK_EXPORT
+    unsigned long Mempool_Size(
+        MEMPOOL const *pool);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,386 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Performance counters of the BACnet stack
+ *
+ * @section DESCRIPTION
+ *
+ * The stack counts the service requests and the latency of their
+ *  handlers, the Error, Reject, and Abort PDUs, the TSM retries and
+ *  timeouts, the datalink packets, bytes, and drops, and the depth of
+ *  the COV notification queue.  The counting is compiled in when
+ *  BACNET_METRICS is defined.
+ *
+ * Each thread that runs the stack may register its own counters, so that
+ *  the counting is without locks or atomics.  The counters of all of the
+ *  threads are added together in a snapshot, which may be copied into
+ *  shared memory where another process can read it at any time.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/basic/sys/metrics.h"
+
+/* orders the updates of the shared snapshot and its sequence */
+#if defined(__GNUC__)
+#define METRICS_BARRIER() __sync_synchronize()
+#else
+#define METRICS_BARRIER()
+#endif
+/* times to try reading while the shared snapshot is being updated */
+#define METRICS_SHARED_READ_TRIES 100
+
+/* counters of the threads that did not register their own */
+static METRICS_DATA Metrics_Default;
+/* counters of the calling thread, or NULL for the default */
+static METRICS_THREAD_LOCAL METRICS_DATA *Metrics_Thread;
+/* counters registered by the threads */
+static METRICS_DATA *Metrics_List[METRICS_THREADS_MAX];
+static unsigned Metrics_List_Count;
+/* timestamps of the service handler latency */
+static metrics_timer_function Metrics_Timer;
+
+static const char *Metrics_Counter_Names[METRICS_COUNTER_MAX] = {
+    "apdu-error-rx", "apdu-reject-rx", "apdu-abort-rx", "apdu-error-tx",
+    "apdu-reject-tx", "apdu-abort-tx", "apdu-dropped", "tsm-transactions",
+    "tsm-retries", "tsm-timeouts", "tsm-exhausted", "datalink-tx-packets",
+    "datalink-tx-bytes", "datalink-tx-dropped", "datalink-rx-packets",
+    "datalink-rx-bytes", "datalink-rx-dropped", "cov-notifications"
+};
+
+static const char *Metrics_Gauge_Names[METRICS_GAUGE_MAX] = { "cov-queue" };
+
+/**
+ * @brief Get the counters of the calling thread
+ * @return counters
+ */
+static METRICS_DATA *metrics_thread(void)
+{
+    return Metrics_Thread ? Metrics_Thread : &Metrics_Default;
+}
+
+/**
+ * @brief Clear the counters, and the registered threads
+ */
+void metrics_init(void)
+{
+    memset(&Metrics_Default, 0, sizeof(Metrics_Default));
+    memset(Metrics_List, 0, sizeof(Metrics_List));
+    Metrics_List_Count = 0;
+    Metrics_Thread = NULL;
+}
+
+/**
+ * @brief Use the given counters for the calling thread. The threads are
+ *  registered without locking, so register them as they start, before
+ *  any snapshot is taken.
+ * @param metrics - counters of the calling thread, which are cleared
+ * @return true if the counters were registered
+ */
+bool metrics_thread_register(METRICS_DATA *metrics)
+{
+    if (!metrics || (Metrics_List_Count >= METRICS_THREADS_MAX)) {
+        return false;
+    }
+    memset(metrics, 0, sizeof(METRICS_DATA));
+    Metrics_List[Metrics_List_Count] = metrics;
+    Metrics_List_Count++;
+    Metrics_Thread = metrics;
+
+    return true;
+}
+
+/**
+ * @brief Set the timer that measures the latency of the service handlers
+ * @param timer - microseconds timer, or NULL to not measure the latency
+ */
+void metrics_timer_set(metrics_timer_function timer)
+{
+    Metrics_Timer = timer;
+}
+
+/**
+ * @brief Get a timestamp for metrics_service_record()
+ * @return microseconds, or 0 if there is no timer
+ */
+unsigned long metrics_timestamp(void)
+{
+    return Metrics_Timer ? Metrics_Timer() : 0;
+}
+
+/**
+ * @brief Add to a counter of the calling thread
+ * @param counter - METRICS_COUNTER
+ * @param value - value to add
+ */
+void metrics_counter_add(METRICS_COUNTER counter, uint32_t value)
+{
+    if (counter < METRICS_COUNTER_MAX) {
+        metrics_thread()->counter[counter] += value;
+    }
+}
+
+/**
+ * @brief Set a gauge of the calling thread, and its peak
+ * @param gauge - METRICS_GAUGE
+ * @param value - current value
+ */
+void metrics_gauge_set(METRICS_GAUGE gauge, uint32_t value)
+{
+    METRICS_GAUGE_DATA *data;
+
+    if (gauge < METRICS_GAUGE_MAX) {
+        data = &metrics_thread()->gauge[gauge];
+        data->value = value;
+        if (data->peak < value) {
+            data->peak = value;
+        }
+    }
+}
+
+/**
+ * @brief Count an Error, Reject, or Abort PDU that was sent
+ * @param apdu - the APDU that was given to the datalink
+ * @param apdu_len - number of bytes in the APDU
+ */
+void metrics_apdu_sent(const uint8_t *apdu, int apdu_len)
+{
+    if (!apdu || (apdu_len <= 0)) {
+        return;
+    }
+    switch (apdu[0] & 0xF0) {
+        case PDU_TYPE_ERROR:
+            metrics_counter_add(METRICS_APDU_ERROR_TX, 1);
+            break;
+        case PDU_TYPE_REJECT:
+            metrics_counter_add(METRICS_APDU_REJECT_TX, 1);
+            break;
+        case PDU_TYPE_ABORT:
+            metrics_counter_add(METRICS_APDU_ABORT_TX, 1);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Find the latency histogram bucket
+ * @param latency - microseconds
+ * @return bucket of the latency histogram
+ */
+static unsigned metrics_histogram_index(unsigned long latency)
+{
+    unsigned long limit = 4;
+    unsigned index = 0;
+
+    while ((index < (METRICS_HISTOGRAM_SIZE - 1)) && (latency >= limit)) {
+        index++;
+        limit <<= 2;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Count a service request that was handled
+ * @param confirmed - true for a confirmed service
+ * @param service - the service choice
+ * @param timestamp - from metrics_timestamp() before the handler ran
+ */
+void metrics_service_record(
+    bool confirmed, uint8_t service, unsigned long timestamp)
+{
+    METRICS_SERVICE_DATA *data;
+    unsigned long latency;
+
+    if (confirmed) {
+        if (service >= MAX_BACNET_CONFIRMED_SERVICE) {
+            return;
+        }
+        data = &metrics_thread()->confirmed[service];
+    } else {
+        if (service >= MAX_BACNET_UNCONFIRMED_SERVICE) {
+            return;
+        }
+        data = &metrics_thread()->unconfirmed[service];
+    }
+    data->requests++;
+    if (Metrics_Timer) {
+        latency = Metrics_Timer() - timestamp;
+        if (latency > UINT32_MAX) {
+            latency = UINT32_MAX;
+        }
+        if (data->latency_max < latency) {
+            data->latency_max = (uint32_t)latency;
+        }
+        data->latency_histogram[metrics_histogram_index(latency)]++;
+    }
+}
+
+/**
+ * @brief Add the service counters of a thread to the total
+ */
+static void metrics_service_add(
+    METRICS_SERVICE_DATA *total, const METRICS_SERVICE_DATA *data)
+{
+    unsigned i;
+
+    total->requests += data->requests;
+    if (total->latency_max < data->latency_max) {
+        total->latency_max = data->latency_max;
+    }
+    for (i = 0; i < METRICS_HISTOGRAM_SIZE; i++) {
+        total->latency_histogram[i] += data->latency_histogram[i];
+    }
+}
+
+/**
+ * @brief Add the counters of a thread to the total
+ */
+static void metrics_add(METRICS_DATA *total, const METRICS_DATA *metrics)
+{
+    unsigned i;
+
+    for (i = 0; i < METRICS_COUNTER_MAX; i++) {
+        total->counter[i] += metrics->counter[i];
+    }
+    for (i = 0; i < METRICS_GAUGE_MAX; i++) {
+        total->gauge[i].value += metrics->gauge[i].value;
+        if (total->gauge[i].peak < metrics->gauge[i].peak) {
+            total->gauge[i].peak = metrics->gauge[i].peak;
+        }
+    }
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        metrics_service_add(&total->confirmed[i], &metrics->confirmed[i]);
+    }
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        metrics_service_add(&total->unconfirmed[i], &metrics->unconfirmed[i]);
+    }
+}
+
+/**
+ * @brief Add together the counters of all of the threads, which may be
+ *  counting at the same time
+ * @param metrics - [out] the total of the counters
+ */
+void metrics_snapshot(METRICS_DATA *metrics)
+{
+    unsigned i;
+
+    if (!metrics) {
+        return;
+    }
+    memset(metrics, 0, sizeof(METRICS_DATA));
+    metrics_add(metrics, &Metrics_Default);
+    for (i = 0; i < Metrics_List_Count; i++) {
+        metrics_add(metrics, Metrics_List[i]);
+    }
+}
+
+/**
+ * @brief Clear the counters of all of the threads
+ */
+void metrics_reset(void)
+{
+    unsigned i;
+
+    memset(&Metrics_Default, 0, sizeof(Metrics_Default));
+    for (i = 0; i < Metrics_List_Count; i++) {
+        memset(Metrics_List[i], 0, sizeof(METRICS_DATA));
+    }
+}
+
+/**
+ * @brief Get the name of a counter
+ * @param counter - METRICS_COUNTER
+ * @return name of the counter, or NULL if not a counter
+ */
+const char *metrics_counter_name(unsigned counter)
+{
+    if (counter < METRICS_COUNTER_MAX) {
+        return Metrics_Counter_Names[counter];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get the name of a gauge
+ * @param gauge - METRICS_GAUGE
+ * @return name of the gauge, or NULL if not a gauge
+ */
+const char *metrics_gauge_name(unsigned gauge)
+{
+    if (gauge < METRICS_GAUGE_MAX) {
+        return Metrics_Gauge_Names[gauge];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Initialize the shared snapshot
+ * @param shared - the shared snapshot
+ */
+void metrics_shared_init(METRICS_SHARED_DATA *shared)
+{
+    if (shared) {
+        memset(shared, 0, sizeof(METRICS_SHARED_DATA));
+        memcpy(shared->signature, "BACM", 4);
+        shared->version = METRICS_SHARED_VERSION;
+        shared->size = sizeof(METRICS_DATA);
+    }
+}
+
+/**
+ * @brief Copy a snapshot of the counters into the shared snapshot. The
+ *  sequence is odd while copying, so a reader can retry.
+ * @param shared - the shared snapshot
+ */
+void metrics_shared_update(METRICS_SHARED_DATA *shared)
+{
+    if (!shared) {
+        return;
+    }
+    shared->sequence++;
+    METRICS_BARRIER();
+    metrics_snapshot(&shared->metrics);
+    METRICS_BARRIER();
+    shared->sequence++;
+}
+
+/**
+ * @brief Read the shared snapshot while it may be updated by another
+ *  process
+ * @param shared - the shared snapshot
+ * @param metrics - [out] a consistent copy of the counters
+ * @return true if the snapshot is valid and was copied
+ */
+bool metrics_shared_read(METRICS_SHARED_DATA *shared, METRICS_DATA *metrics)
+{
+    uint32_t sequence;
+    unsigned tries;
+
+    if (!shared || !metrics || (memcmp(shared->signature, "BACM", 4) != 0) ||
+        (shared->version != METRICS_SHARED_VERSION) ||
+        (shared->size != sizeof(METRICS_DATA))) {
+        return false;
+    }
+    for (tries = 0; tries < METRICS_SHARED_READ_TRIES; tries++) {
+        sequence = shared->sequence;
+        METRICS_BARRIER();
+        if (sequence & 1) {
+            continue;
+        }
+        memcpy(metrics, &shared->metrics, sizeof(METRICS_DATA));
+        METRICS_BARRIER();
+        if (shared->sequence == sequence) {
+            return true;
+        }
+    }
+
+    return false;
+}
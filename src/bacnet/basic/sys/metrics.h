@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief API for the performance counters of the BACnet stack
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacnet_stack_exports.h"
+#include "bacnet/bacenum.h"
+
+/* handler latency histogram buckets: under 4, 16, 64, 256, 1024, 4096,
+   and 16384 microseconds, and the rest */
+#define METRICS_HISTOGRAM_SIZE 8
+/* number of threads that can register their own counters */
+#ifndef METRICS_THREADS_MAX
+#define METRICS_THREADS_MAX 8
+#endif
+/* the shared memory snapshot */
+#define METRICS_SHARED_VERSION 1
+
+/* Each thread increments its own counters, without locks or atomics */
+#ifndef METRICS_THREAD_LOCAL
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && \
+    !defined(__STDC_NO_THREADS__)
+#define METRICS_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define METRICS_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define METRICS_THREAD_LOCAL __declspec(thread)
+#else
+#define METRICS_THREAD_LOCAL
+#endif
+#endif
+
+/* The counters are only incremented by the stack when BACNET_METRICS is
+   defined, otherwise the instrumentation is compiled out */
+#if defined(BACNET_METRICS)
+#define METRICS_COUNT(counter) metrics_counter_add((counter), 1)
+#define METRICS_ADD(counter, value) metrics_counter_add((counter), (value))
+#define METRICS_GAUGE(gauge, value) metrics_gauge_set((gauge), (value))
+#define METRICS_APDU_SENT(apdu, apdu_len) metrics_apdu_sent((apdu), (apdu_len))
+#else
+#define METRICS_COUNT(counter) ((void)0)
+#define METRICS_ADD(counter, value) ((void)0)
+#define METRICS_GAUGE(gauge, value) ((void)0)
+#define METRICS_APDU_SENT(apdu, apdu_len) ((void)0)
+#endif
+
+typedef enum {
+    /* Error, Reject, and Abort PDUs received and sent */
+    METRICS_APDU_ERROR_RX = 0,
+    METRICS_APDU_REJECT_RX,
+    METRICS_APDU_ABORT_RX,
+    METRICS_APDU_ERROR_TX,
+    METRICS_APDU_REJECT_TX,
+    METRICS_APDU_ABORT_TX,
+    /* APDUs that could not be decoded, or were dropped by DCC */
+    METRICS_APDU_DROPPED,
+    /* confirmed requests sent, resent, and timed out */
+    METRICS_TSM_TRANSACTIONS,
+    METRICS_TSM_RETRIES,
+    METRICS_TSM_TIMEOUTS,
+    /* confirmed requests not sent for lack of a free invoke ID */
+    METRICS_TSM_EXHAUSTED,
+    METRICS_DATALINK_TX_PACKETS,
+    METRICS_DATALINK_TX_BYTES,
+    METRICS_DATALINK_TX_DROPPED,
+    METRICS_DATALINK_RX_PACKETS,
+    METRICS_DATALINK_RX_BYTES,
+    METRICS_DATALINK_RX_DROPPED,
+    METRICS_COV_NOTIFICATIONS,
+    METRICS_COUNTER_MAX
+} METRICS_COUNTER;
+
+typedef enum {
+    /* COV subscriptions waiting to send a notification */
+    METRICS_GAUGE_COV_QUEUE = 0,
+    METRICS_GAUGE_MAX
+} METRICS_GAUGE;
+
+/**
+ * Get a timestamp to measure the latency of the service handlers.
+ * @return free running microseconds
+ */
+typedef unsigned long (*metrics_timer_function)(void);
+
+/**
+ * The requests of one service, and the latency of its handler
+ *
+ * @{
+ */
+typedef struct metrics_service_data {
+    uint32_t requests;
+    uint32_t latency_max;
+    uint32_t latency_histogram[METRICS_HISTOGRAM_SIZE];
+} METRICS_SERVICE_DATA;
+/** @} */
+
+typedef struct metrics_gauge_data {
+    uint32_t value;
+    uint32_t peak;
+} METRICS_GAUGE_DATA;
+
+/**
+ * The counters of one thread, or of all of the threads added together.
+ *
+ * @{
+ */
+typedef struct metrics_data {
+    uint32_t counter[METRICS_COUNTER_MAX];
+    METRICS_GAUGE_DATA gauge[METRICS_GAUGE_MAX];
+    METRICS_SERVICE_DATA confirmed[MAX_BACNET_CONFIRMED_SERVICE];
+    METRICS_SERVICE_DATA unconfirmed[MAX_BACNET_UNCONFIRMED_SERVICE];
+} METRICS_DATA;
+/** @} */
+
+/**
+ * The snapshot of the counters that is shared with another process.
+ * The sequence is odd while the snapshot is being updated.
+ *
+ * @{
+ */
+typedef struct metrics_shared_data {
+    char signature[4];
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t size;
+    volatile uint32_t sequence;
+    METRICS_DATA metrics;
+} METRICS_SHARED_DATA;
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void metrics_init(void);
+BACNET_STACK_EXPORT
+bool metrics_thread_register(METRICS_DATA *metrics);
+BACNET_STACK_EXPORT
+void metrics_timer_set(metrics_timer_function timer);
+BACNET_STACK_EXPORT
+unsigned long metrics_timestamp(void);
+
+BACNET_STACK_EXPORT
+void metrics_counter_add(METRICS_COUNTER counter, uint32_t value);
+BACNET_STACK_EXPORT
+void metrics_gauge_set(METRICS_GAUGE gauge, uint32_t value);
+BACNET_STACK_EXPORT
+void metrics_apdu_sent(const uint8_t *apdu, int apdu_len);
+BACNET_STACK_EXPORT
+void metrics_service_record(
+    bool confirmed, uint8_t service, unsigned long timestamp);
+
+BACNET_STACK_EXPORT
+void metrics_snapshot(METRICS_DATA *metrics);
+BACNET_STACK_EXPORT
+void metrics_reset(void);
+BACNET_STACK_EXPORT
+const char *metrics_counter_name(unsigned counter);
+BACNET_STACK_EXPORT
+const char *metrics_gauge_name(unsigned gauge);
+
+BACNET_STACK_EXPORT
+void metrics_shared_init(METRICS_SHARED_DATA *shared);
+BACNET_STACK_EXPORT
+void metrics_shared_update(METRICS_SHARED_DATA *shared);
+BACNET_STACK_EXPORT
+bool metrics_shared_read(
+    METRICS_SHARED_DATA *shared, METRICS_DATA *metrics);
+
+/* memory mapped file of the shared snapshot, and the latency timer,
+   which are provided by the ports */
+BACNET_STACK_EXPORT
+METRICS_SHARED_DATA *metrics_shared_map(const char *pathname, bool writer);
+BACNET_STACK_EXPORT
+void metrics_shared_unmap(METRICS_SHARED_DATA *shared);
+BACNET_STACK_EXPORT
+unsigned long metrics_microseconds(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
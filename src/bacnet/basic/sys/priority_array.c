@@ -0,0 +1,216 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief The priority-array slots of commandable objects, kept as a
+ *  16-bit occupancy mask, so that the active priority is found with a
+ *  find-first-set instead of a loop over the 16 slots.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/basic/sys/priority_array.h"
+
+/* BACNET_MAX_PRIORITY slots */
+#define PRIORITY_ARRAY_SIZE 16
+
+/**
+ * @brief Find the first bit that is set
+ * @param bits - mask of bits
+ * @return 1..16 for the lowest bit that is set, or 0 if no bit is set
+ */
+unsigned priority_array_first_set(uint16_t bits)
+{
+#if defined(__GNUC__)
+    if (bits == 0) {
+        return 0;
+    }
+    return (unsigned)__builtin_ctz(bits) + 1;
+#else
+    /* first set bit of each nibble value */
+    static const uint8_t nibble_first[16] = { 0, 1, 2, 1, 3, 1, 2, 1, 4, 1,
+        2, 1, 3, 1, 2, 1 };
+    unsigned offset = 0;
+
+    while (bits) {
+        if (bits & 0x0F) {
+            return offset + nibble_first[bits & 0x0F];
+        }
+        bits >>= 4;
+        offset += 4;
+    }
+    return 0;
+#endif
+}
+
+/**
+ * @brief Initialize the priority-array with all slots relinquished
+ * @param pa - priority-array
+ */
+void priority_array_init(BACNET_PRIORITY_ARRAY *pa)
+{
+    if (pa) {
+        pa->active_bits = 0;
+    }
+}
+
+/**
+ * @brief Mark a slot as commanded.  The caller stores the value of the slot.
+ * @param pa - priority-array
+ * @param priority - priority 1..16
+ * @return true if the slot is the active priority, so the effective
+ *  value is the value of this slot
+ */
+bool priority_array_command(BACNET_PRIORITY_ARRAY *pa, unsigned priority)
+{
+    uint16_t bit;
+
+    if (!pa || (priority < 1) || (priority > PRIORITY_ARRAY_SIZE)) {
+        return false;
+    }
+    bit = (uint16_t)(1U << (priority - 1));
+    pa->active_bits |= bit;
+
+    /* no higher priority (lower bit) is commanded */
+    return (pa->active_bits & (bit - 1U)) == 0;
+}
+
+/**
+ * @brief Mark a slot as relinquished (NULL)
+ * @param pa - priority-array
+ * @param priority - priority 1..16
+ * @return true if the slot was the active priority, so the effective
+ *  value moves to the next active priority, or to the relinquish-default
+ */
+bool priority_array_relinquish(BACNET_PRIORITY_ARRAY *pa, unsigned priority)
+{
+    uint16_t bit;
+    bool active = false;
+
+    if (!pa || (priority < 1) || (priority > PRIORITY_ARRAY_SIZE)) {
+        return false;
+    }
+    bit = (uint16_t)(1U << (priority - 1));
+    if (pa->active_bits & bit) {
+        active = (pa->active_bits & (bit - 1U)) == 0;
+        pa->active_bits &= (uint16_t)~bit;
+    }
+
+    return active;
+}
+
+/**
+ * @brief Determine if a slot is commanded
+ * @param pa - priority-array
+ * @param priority - priority 1..16
+ * @return true if the slot is commanded, false if it is relinquished (NULL)
+ */
+bool priority_array_commanded(
+    const BACNET_PRIORITY_ARRAY *pa, unsigned priority)
+{
+    if (!pa || (priority < 1) || (priority > PRIORITY_ARRAY_SIZE)) {
+        return false;
+    }
+
+    return (pa->active_bits & (1U << (priority - 1))) != 0;
+}
+
+/**
+ * @brief Get the active priority
+ * @param pa - priority-array
+ * @return active priority 1..16, or 0 if all the slots are relinquished
+ */
+unsigned priority_array_active(const BACNET_PRIORITY_ARRAY *pa)
+{
+    if (!pa) {
+        return 0;
+    }
+
+    return priority_array_first_set(pa->active_bits);
+}
+
+/**
+ * @brief Encode the Priority_Array property of an object with REAL values,
+ *  in one pass over the slots, with the commanded slots encoded in runs.
+ * @param pa - priority-array
+ * @param value - the 16 slot values, index 0 is priority 1
+ * @param array_index - 0 for the array size, 1..16 for one slot,
+ *  or BACNET_ARRAY_ALL for the entire array
+ * @param apdu - buffer in which the APDU contents are built, or NULL
+ * @param max_apdu - size of the apdu buffer
+ * @return the length of the apdu encoded, BACNET_STATUS_ERROR for an
+ *  invalid array index, or BACNET_STATUS_ABORT when the buffer is too small
+ */
+int priority_array_real_encode(const BACNET_PRIORITY_ARRAY *pa,
+    const float *value,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *apdu,
+    int max_apdu)
+{
+    int apdu_len = 0;
+    int len = 0;
+    uint16_t bits;
+    unsigned p, run;
+
+    if (!pa || !value) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (array_index == 0) {
+        len = encode_application_unsigned(NULL, PRIORITY_ARRAY_SIZE);
+        if (len > max_apdu) {
+            return BACNET_STATUS_ABORT;
+        }
+        return encode_application_unsigned(apdu, PRIORITY_ARRAY_SIZE);
+    }
+    if (array_index == BACNET_ARRAY_ALL) {
+        /* a NULL is one octet, and a REAL is five octets */
+        len = PRIORITY_ARRAY_SIZE;
+        for (bits = pa->active_bits; bits; bits &= (uint16_t)(bits - 1)) {
+            len += 4;
+        }
+        if (len > max_apdu) {
+            return BACNET_STATUS_ABORT;
+        }
+        if (!apdu) {
+            return len;
+        }
+        p = 0;
+        while (p < PRIORITY_ARRAY_SIZE) {
+            run = 0;
+            while (((p + run) < PRIORITY_ARRAY_SIZE) &&
+                (pa->active_bits & (1U << (p + run)))) {
+                run++;
+            }
+            if (run) {
+                apdu_len += encode_application_real_array(
+                    &apdu[apdu_len], &value[p], run);
+                p += run;
+            } else {
+                apdu_len += encode_application_null(&apdu[apdu_len]);
+                p++;
+            }
+        }
+        return apdu_len;
+    }
+    if (array_index > PRIORITY_ARRAY_SIZE) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (pa->active_bits & (1U << (array_index - 1))) {
+        len = encode_application_real(NULL, value[array_index - 1]);
+        if (len > max_apdu) {
+            return BACNET_STATUS_ABORT;
+        }
+        apdu_len = encode_application_real(apdu, value[array_index - 1]);
+    } else {
+        len = encode_application_null(NULL);
+        if (len > max_apdu) {
+            return BACNET_STATUS_ABORT;
+        }
+        apdu_len = encode_application_null(apdu);
+    }
+
+    return apdu_len;
+}
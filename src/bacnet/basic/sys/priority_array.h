@@ -0,0 +1,58 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief API for the priority-array slots of commandable objects
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef PRIORITY_ARRAY_H
+#define PRIORITY_ARRAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacnet_stack_exports.h"
+#include "bacnet/bacdef.h"
+
+/**
+ * Occupancy of the 16 slots of a BACnet priority-array.  The values of
+ * the slots are stored by each object in its own type, and the object
+ * keeps its effective Present_Value, which only needs an update when
+ * priority_array_command() or priority_array_relinquish() return true.
+ *
+ * @{
+ */
+typedef struct bacnet_priority_array {
+    /** bit 0 is priority 1, and bit 15 is priority 16 */
+    uint16_t active_bits;
+} BACNET_PRIORITY_ARRAY;
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void priority_array_init(BACNET_PRIORITY_ARRAY *pa);
+BACNET_STACK_EXPORT
+bool priority_array_command(BACNET_PRIORITY_ARRAY *pa, unsigned priority);
+BACNET_STACK_EXPORT
+bool priority_array_relinquish(BACNET_PRIORITY_ARRAY *pa, unsigned priority);
+BACNET_STACK_EXPORT
+bool priority_array_commanded(
+    const BACNET_PRIORITY_ARRAY *pa, unsigned priority);
+BACNET_STACK_EXPORT
+unsigned priority_array_active(const BACNET_PRIORITY_ARRAY *pa);
+BACNET_STACK_EXPORT
+unsigned priority_array_first_set(uint16_t bits);
+BACNET_STACK_EXPORT
+int priority_array_real_encode(const BACNET_PRIORITY_ARRAY *pa,
+    const float *value,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *apdu,
+    int max_apdu);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
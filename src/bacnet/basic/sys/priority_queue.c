@@ -0,0 +1,386 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief A transmit queue with a ring buffer for each BACnet network
+ *  message priority.  The highest priority is sent first, and after a
+ *  burst of higher priority elements the oldest element that is waiting
+ *  in a lower level is sent, so that normal traffic is not starved by a
+ *  busy life safety or critical equipment network.  High and low
+ *  watermarks of the queued elements mark the queue as congested, for
+ *  a router to send Router-Busy-To-Network, and the lower levels are
+ *  dropped while the queue is congested.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <string.h>
+#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/basic/sys/priority_queue.h"
+
+/**
+ * @brief Initialize the queue
+ * @param q - queue to initialize
+ * @param buffer - array of PRIORITY_QUEUE_LEVELS * element_count elements,
+ *  each of which starts with a PRIORITY_QUEUE_ELEMENT
+ * @param element_size - size of each element, in bytes
+ * @param element_count - number of elements in each level, which must be
+ *  a power of two
+ */
+void priority_queue_init(PRIORITY_QUEUE *q,
+    void *buffer,
+    unsigned element_size,
+    unsigned element_count)
+{
+    uint8_t *data = buffer;
+    unsigned i;
+
+    if (!q || !buffer) {
+        return;
+    }
+    memset(q, 0, sizeof(PRIORITY_QUEUE));
+    for (i = 0; i < PRIORITY_QUEUE_LEVELS; i++) {
+        Ringbuf_Init(&q->level[i],
+            (volatile uint8_t *)&data[i * element_size * element_count],
+            element_size, element_count);
+    }
+    q->burst_max = PRIORITY_QUEUE_BURST_MAX;
+}
+
+/**
+ * @brief Set the number of elements that are dequeued in a row from a
+ *  higher level while a lower level is waiting
+ * @param q - queue
+ * @param burst_max - number of elements, or 0 to always send the highest
+ *  priority first
+ */
+void priority_queue_burst_set(PRIORITY_QUEUE *q, unsigned burst_max)
+{
+    if (q) {
+        q->burst_max = burst_max;
+        q->burst = 0;
+    }
+}
+
+/**
+ * @brief Set the watermarks for congestion, and the levels that are
+ *  dropped while the queue is congested
+ * @param q - queue
+ * @param high_watermark - number of queued elements that starts the
+ *  congestion, or 0 for no congestion
+ * @param low_watermark - number of queued elements that ends the
+ *  congestion
+ * @param drop_priority - lowest BACNET_MESSAGE_PRIORITY that is queued
+ *  while the queue is congested
+ */
+void priority_queue_watermark_set(PRIORITY_QUEUE *q,
+    unsigned high_watermark,
+    unsigned low_watermark,
+    unsigned drop_priority)
+{
+    if (q) {
+        q->high_watermark = high_watermark;
+        q->low_watermark = low_watermark;
+        q->drop_priority = drop_priority;
+        q->congested = false;
+    }
+}
+
+/**
+ * @brief Determine if the queue is congested
+ * @param q - queue
+ * @return true from reaching the high watermark until back down to the
+ *  low watermark
+ */
+bool priority_queue_congested(const PRIORITY_QUEUE *q)
+{
+    if (q) {
+        return q->congested;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Determine if all of the levels of the queue are empty
+ * @param q - queue
+ * @return true if there is nothing queued
+ */
+bool priority_queue_empty(const PRIORITY_QUEUE *q)
+{
+    unsigned i;
+
+    if (q) {
+        for (i = 0; i < PRIORITY_QUEUE_LEVELS; i++) {
+            if (!Ringbuf_Empty(&q->level[i])) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the number of elements queued in all of the levels
+ * @param q - queue
+ * @return number of elements
+ */
+unsigned priority_queue_count(const PRIORITY_QUEUE *q)
+{
+    unsigned count = 0;
+    unsigned i;
+
+    if (q) {
+        for (i = 0; i < PRIORITY_QUEUE_LEVELS; i++) {
+            count += Ringbuf_Count(&q->level[i]);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the free element at the end of a level, to be filled in
+ *  and then queued with priority_queue_data_put().  A full level, or a
+ *  level below the drop priority while the queue is congested, counts as
+ *  a dropped element.
+ * @param q - queue
+ * @param priority - BACNET_MESSAGE_PRIORITY of the element
+ * @return the free element, or NULL if the level is full
+ */
+void *priority_queue_data_peek(PRIORITY_QUEUE *q, unsigned priority)
+{
+    void *element;
+
+    if (!q || (priority >= PRIORITY_QUEUE_LEVELS)) {
+        return NULL;
+    }
+    if (q->congested && (priority < q->drop_priority)) {
+        element = NULL;
+    } else {
+        element = (void *)Ringbuf_Data_Peek(&q->level[priority]);
+    }
+    if (!element) {
+        q->stats[priority].dropped_counter++;
+    }
+
+    return element;
+}
+
+/**
+ * @brief Queue the element from priority_queue_data_peek()
+ * @param q - queue
+ * @param priority - BACNET_MESSAGE_PRIORITY of the element
+ * @param element - the element from priority_queue_data_peek()
+ * @param now - milliseconds time stamp, such as from mstimer_now()
+ * @return true if the element was queued
+ */
+bool priority_queue_data_put(PRIORITY_QUEUE *q,
+    unsigned priority,
+    void *element,
+    unsigned long now)
+{
+    PRIORITY_QUEUE_STATISTICS *stats;
+    unsigned depth;
+
+    if (!q || !element || (priority >= PRIORITY_QUEUE_LEVELS)) {
+        return false;
+    }
+    ((PRIORITY_QUEUE_ELEMENT *)element)->timestamp = now;
+    if (!Ringbuf_Data_Put(
+            &q->level[priority], (volatile uint8_t *)element)) {
+        return false;
+    }
+    stats = &q->stats[priority];
+    stats->enqueue_counter++;
+    depth = Ringbuf_Count(&q->level[priority]);
+    if (depth > stats->depth_peak) {
+        stats->depth_peak = depth;
+    }
+    if ((q->high_watermark > 0) &&
+        (priority_queue_count(q) >= q->high_watermark)) {
+        q->congested = true;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Find the wait time histogram bucket of a wait time
+ * @param wait - milliseconds
+ * @return bucket index
+ */
+static unsigned priority_queue_histogram_index(unsigned long wait)
+{
+    unsigned long limit = 1;
+    unsigned index = 0;
+
+    while ((index < (PRIORITY_QUEUE_HISTOGRAM_SIZE - 1)) && (wait >= limit)) {
+        index++;
+        limit <<= 2;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Find the level that is sent next
+ * @param q - queue
+ * @param promoted - [out] true if a lower level is sent ahead of a
+ *  higher level that is waiting
+ * @return level, or -1 if the queue is empty
+ */
+static int priority_queue_next(const PRIORITY_QUEUE *q, bool *promoted)
+{
+    const PRIORITY_QUEUE_ELEMENT *element;
+    unsigned long oldest = 0;
+    int high = -1;
+    int next = -1;
+    int i;
+
+    *promoted = false;
+    for (i = PRIORITY_QUEUE_LEVELS - 1; i >= 0; i--) {
+        if (!Ringbuf_Empty(&q->level[i])) {
+            high = i;
+            break;
+        }
+    }
+    if ((high <= 0) || (q->burst_max == 0) || (q->burst < q->burst_max)) {
+        return high;
+    }
+    for (i = 0; i < high; i++) {
+        element = (const PRIORITY_QUEUE_ELEMENT *)Ringbuf_Peek(&q->level[i]);
+        if (!element) {
+            continue;
+        }
+        /* older, allowing the time stamps to wrap around */
+        if ((next < 0) ||
+            (((oldest - element->timestamp) - 1UL) < (ULONG_MAX / 2))) {
+            oldest = element->timestamp;
+            next = i;
+        }
+    }
+    if (next < 0) {
+        return high;
+    }
+    *promoted = true;
+
+    return next;
+}
+
+/**
+ * @brief Get the element that is sent next, without taking it out of
+ *  the queue
+ * @param q - queue
+ * @param priority - [out] BACNET_MESSAGE_PRIORITY of the element, or NULL
+ * @return the element, or NULL if the queue is empty
+ */
+void *priority_queue_peek(const PRIORITY_QUEUE *q, unsigned *priority)
+{
+    bool promoted;
+    int level;
+
+    if (!q) {
+        return NULL;
+    }
+    level = priority_queue_next(q, &promoted);
+    if (level < 0) {
+        return NULL;
+    }
+    if (priority) {
+        *priority = (unsigned)level;
+    }
+
+    return (void *)Ringbuf_Peek(&q->level[level]);
+}
+
+/**
+ * @brief Take the element that priority_queue_peek() returns out of the
+ *  queue, and account for the time it waited
+ * @param q - queue
+ * @param now - milliseconds time stamp, such as from mstimer_now()
+ * @return true if an element was taken out of the queue
+ */
+bool priority_queue_pop(PRIORITY_QUEUE *q, unsigned long now)
+{
+    const PRIORITY_QUEUE_ELEMENT *element;
+    PRIORITY_QUEUE_STATISTICS *stats;
+    unsigned long wait;
+    bool promoted;
+    bool waiting = false;
+    int level;
+    int i;
+
+    if (!q) {
+        return false;
+    }
+    level = priority_queue_next(q, &promoted);
+    if (level < 0) {
+        return false;
+    }
+    element = (const PRIORITY_QUEUE_ELEMENT *)Ringbuf_Peek(&q->level[level]);
+    wait = now - element->timestamp;
+    stats = &q->stats[level];
+    stats->dequeue_counter++;
+    stats->wait_total += wait;
+    if (wait > stats->wait_max) {
+        stats->wait_max = wait;
+    }
+    stats->wait_histogram[priority_queue_histogram_index(wait)]++;
+    (void)Ringbuf_Pop(&q->level[level], NULL);
+    if (q->congested && (priority_queue_count(q) <= q->low_watermark)) {
+        q->congested = false;
+    }
+    if (promoted) {
+        stats->promoted_counter++;
+        q->burst = 0;
+    } else {
+        for (i = 0; i < level; i++) {
+            if (!Ringbuf_Empty(&q->level[i])) {
+                waiting = true;
+                break;
+            }
+        }
+        if (waiting) {
+            q->burst++;
+        } else {
+            q->burst = 0;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the counters of a level, with its current depth
+ * @param q - queue
+ * @param priority - BACNET_MESSAGE_PRIORITY of the level
+ * @param stats - [out] counters of the level
+ * @return true if the level exists
+ */
+bool priority_queue_statistics(const PRIORITY_QUEUE *q,
+    unsigned priority,
+    PRIORITY_QUEUE_STATISTICS *stats)
+{
+    if (!q || !stats || (priority >= PRIORITY_QUEUE_LEVELS)) {
+        return false;
+    }
+    memcpy(stats, &q->stats[priority], sizeof(PRIORITY_QUEUE_STATISTICS));
+    stats->depth = Ringbuf_Count(&q->level[priority]);
+
+    return true;
+}
+
+/**
+ * @brief Reset the counters of all of the levels
+ * @param q - queue
+ */
+void priority_queue_statistics_reset(PRIORITY_QUEUE *q)
+{
+    if (q) {
+        memset(q->stats, 0, sizeof(q->stats));
+    }
+}
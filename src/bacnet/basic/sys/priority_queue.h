@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief API for a transmit queue with a level for each BACnet
+ *  network message priority
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacnet_stack_exports.h"
+#include "bacnet/basic/sys/ringbuf.h"
+
+/* one level for each BACNET_MESSAGE_PRIORITY, where 0 is normal
+   and 3 is life safety */
+#define PRIORITY_QUEUE_LEVELS 4
+/* elements dequeued in a row from a higher level while a lower level is
+   waiting, before the oldest waiting element of a lower level is sent */
+#ifndef PRIORITY_QUEUE_BURST_MAX
+#define PRIORITY_QUEUE_BURST_MAX 8
+#endif
+/* wait time histogram buckets: under 1, 4, 16, 64, 256, 1024, and 4096
+   milliseconds, and the rest */
+#define PRIORITY_QUEUE_HISTOGRAM_SIZE 8
+
+/**
+ * Every queued element starts with this header, which is written by the
+ * queue when the element is put into the queue.
+ *
+ * @{
+ */
+typedef struct priority_queue_element {
+    /** milliseconds time stamp of when the element was queued */
+    unsigned long timestamp;
+} PRIORITY_QUEUE_ELEMENT;
+/** @} */
+
+/**
+ * Counters of one priority level.  The wait time is from queueing an
+ * element until it is taken out of the queue, in milliseconds.
+ *
+ * @{
+ */
+typedef struct priority_queue_statistics {
+    uint32_t enqueue_counter;
+    uint32_t dequeue_counter;
+    /* elements that did not fit in the level, or that were below the
+       drop priority while the queue was congested */
+    uint32_t dropped_counter;
+    /* elements sent ahead of a higher level to avoid starvation */
+    uint32_t promoted_counter;
+    unsigned depth;
+    unsigned depth_peak;
+    unsigned long wait_total;
+    unsigned long wait_max;
+    uint32_t wait_histogram[PRIORITY_QUEUE_HISTOGRAM_SIZE];
+} PRIORITY_QUEUE_STATISTICS;
+/** @} */
+
+typedef struct priority_queue {
+    RING_BUFFER level[PRIORITY_QUEUE_LEVELS];
+    PRIORITY_QUEUE_STATISTICS stats[PRIORITY_QUEUE_LEVELS];
+    /* elements dequeued in a row while a lower level was waiting */
+    unsigned burst;
+    unsigned burst_max;
+    /* congested from reaching the high watermark of queued elements
+       until back down to the low watermark, and while congested the
+       levels below the drop priority are dropped */
+    bool congested;
+    unsigned high_watermark;
+    unsigned low_watermark;
+    unsigned drop_priority;
+} PRIORITY_QUEUE;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void priority_queue_init(PRIORITY_QUEUE *q,
+    void *buffer,
+    unsigned element_size,
+    unsigned element_count);
+BACNET_STACK_EXPORT
+void priority_queue_burst_set(PRIORITY_QUEUE *q, unsigned burst_max);
+BACNET_STACK_EXPORT
+void priority_queue_watermark_set(PRIORITY_QUEUE *q,
+    unsigned high_watermark,
+    unsigned low_watermark,
+    unsigned drop_priority);
+BACNET_STACK_EXPORT
+bool priority_queue_congested(const PRIORITY_QUEUE *q);
+BACNET_STACK_EXPORT
+bool priority_queue_empty(const PRIORITY_QUEUE *q);
+BACNET_STACK_EXPORT
+unsigned priority_queue_count(const PRIORITY_QUEUE *q);
+BACNET_STACK_EXPORT
+void *priority_queue_data_peek(PRIORITY_QUEUE *q, unsigned priority);
+BACNET_STACK_EXPORT
+bool priority_queue_data_put(PRIORITY_QUEUE *q,
+    unsigned priority,
+    void *element,
+    unsigned long now);
+BACNET_STACK_EXPORT
+void *priority_queue_peek(const PRIORITY_QUEUE *q, unsigned *priority);
+BACNET_STACK_EXPORT
+bool priority_queue_pop(PRIORITY_QUEUE *q, unsigned long now);
+BACNET_STACK_EXPORT
+bool priority_queue_statistics(const PRIORITY_QUEUE *q,
+    unsigned priority,
+    PRIORITY_QUEUE_STATISTICS *stats);
+BACNET_STACK_EXPORT
+void priority_queue_statistics_reset(PRIORITY_QUEUE *q);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
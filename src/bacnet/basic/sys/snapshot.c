@@ -0,0 +1,636 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Versioned and checksummed binary warm start snapshots.  Each
+ *  module registers a section of fixed size records, such as the bound
+ *  entries of the address cache, and the snapshot is restored at startup
+ *  with one pass over the records.  The sections are aligned and their
+ *  records are used in place, so a snapshot file can be read into memory
+ *  or memory mapped.  The file is written from snapshot_file_timer(), one
+ *  section for each call, and only when the snapshot has changed.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/bacint.h"
+#include "bacnet/basic/sys/snapshot.h"
+
+/* the length of a section, padded to the next 4 byte boundary */
+#define SNAPSHOT_PAD(n) (((n) + 3U) & ~((size_t)3U))
+
+struct snapshot_section_handler {
+    uint16_t id;
+    uint16_t version;
+    uint16_t record_size;
+    snapshot_count_function count;
+    snapshot_encode_function encode;
+    snapshot_restore_function restore;
+};
+static struct snapshot_section_handler Section_Handler[SNAPSHOT_SECTIONS_MAX];
+static unsigned Section_Count;
+
+/* the pass of snapshot_file_timer() that is encoding the snapshot */
+static struct snapshot_writer {
+    uint8_t *buffer;
+    size_t size;
+    size_t length;
+    unsigned handler;
+    uint16_t sections;
+    uint32_t elapsed;
+    /* the CRC of the snapshot that was last written */
+    uint32_t crc;
+    bool written;
+} Writer;
+
+static uint32_t CRC32_Table[256];
+static bool CRC32_Table_Valid;
+
+/**
+ * @brief Clear the registered sections, and stop the file writer pass
+ */
+void snapshot_init(void)
+{
+    free(Writer.buffer);
+    memset(&Writer, 0, sizeof(Writer));
+    memset(Section_Handler, 0, sizeof(Section_Handler));
+    Section_Count = 0;
+}
+
+/**
+ * @brief Register the functions of a section, or replace the functions
+ *  of a section that is already registered
+ * @param id - section identifier, such as SNAPSHOT_SECTION_ADDRESS_CACHE
+ * @param version - version of the records of the section
+ * @param record_size - number of bytes in each record
+ * @param count - function to get the number of entries
+ * @param encode - function to encode an entry
+ * @param restore - function to restore a record
+ * @return true if the section was registered
+ */
+bool snapshot_section_register(uint16_t id,
+    uint16_t version,
+    uint16_t record_size,
+    snapshot_count_function count,
+    snapshot_encode_function encode,
+    snapshot_restore_function restore)
+{
+    struct snapshot_section_handler *handler = NULL;
+    unsigned i;
+
+    if ((record_size == 0) || !count || !encode || !restore) {
+        return false;
+    }
+    for (i = 0; i < Section_Count; i++) {
+        if (Section_Handler[i].id == id) {
+            handler = &Section_Handler[i];
+            break;
+        }
+    }
+    if (!handler) {
+        if (Section_Count >= SNAPSHOT_SECTIONS_MAX) {
+            return false;
+        }
+        handler = &Section_Handler[Section_Count];
+        Section_Count++;
+    }
+    handler->id = id;
+    handler->version = version;
+    handler->record_size = record_size;
+    handler->count = count;
+    handler->encode = encode;
+    handler->restore = restore;
+
+    return true;
+}
+
+/**
+ * @brief Calculate the CRC-32 (IEEE 802.3) of some data, which can be
+ *  continued over more data
+ * @param crc - 0 to start, or the CRC of the previous data
+ * @param data - the data
+ * @param length - number of bytes of data
+ * @return CRC of the data
+ */
+uint32_t snapshot_crc32(uint32_t crc, uint8_t *data, size_t length)
+{
+    uint32_t value;
+    unsigned i, bit;
+
+    if (!CRC32_Table_Valid) {
+        for (i = 0; i < 256; i++) {
+            value = i;
+            for (bit = 0; bit < 8; bit++) {
+                value = (value & 1) ? (0xEDB88320UL ^ (value >> 1))
+                                    : (value >> 1);
+            }
+            CRC32_Table[i] = value;
+        }
+        CRC32_Table_Valid = true;
+    }
+    crc = ~crc;
+    while (length--) {
+        crc = CRC32_Table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+/**
+ * @brief Get the size of a buffer that holds a snapshot of every
+ *  registered section
+ * @return size of the snapshot, in bytes
+ */
+size_t snapshot_size(void)
+{
+    size_t size = SNAPSHOT_HEADER_SIZE;
+    unsigned i;
+
+    for (i = 0; i < Section_Count; i++) {
+        size += SNAPSHOT_SECTION_HEADER_SIZE +
+            SNAPSHOT_PAD((size_t)Section_Handler[i].count() *
+                Section_Handler[i].record_size);
+    }
+
+    return size;
+}
+
+/**
+ * @brief Encode the header of a snapshot
+ * @param buffer - [out] SNAPSHOT_HEADER_SIZE bytes
+ * @param sections - number of sections
+ * @param length - number of bytes in the snapshot
+ */
+static void snapshot_header_encode(
+    uint8_t *buffer, uint16_t sections, size_t length)
+{
+    buffer[0] = 'B';
+    buffer[1] = 'A';
+    buffer[2] = 'C';
+    buffer[3] = 'S';
+    encode_unsigned16(&buffer[4], SNAPSHOT_VERSION);
+    encode_unsigned16(&buffer[6], sections);
+    encode_unsigned32(&buffer[8], (uint32_t)length);
+}
+
+/**
+ * @brief Encode the entries of a registered section.  The entries that
+ *  do not fit in the buffer are skipped.
+ * @param handler - the registered section
+ * @param buffer - [out] the section
+ * @param size - number of bytes in the buffer
+ * @return number of bytes encoded, or 0 if the section does not fit
+ */
+static size_t snapshot_section_encode(
+    struct snapshot_section_handler *handler, uint8_t *buffer, size_t size)
+{
+    size_t length = SNAPSHOT_SECTION_HEADER_SIZE;
+    uint32_t record_count = 0;
+    uint32_t entries;
+    uint32_t index;
+    uint32_t crc;
+
+    if (size < SNAPSHOT_SECTION_HEADER_SIZE) {
+        return 0;
+    }
+    entries = handler->count();
+    for (index = 0; index < entries; index++) {
+        if (SNAPSHOT_PAD(length + handler->record_size) > size) {
+            break;
+        }
+        if (handler->encode(index, &buffer[length])) {
+            length += handler->record_size;
+            record_count++;
+        }
+    }
+    crc = snapshot_crc32(0, &buffer[SNAPSHOT_SECTION_HEADER_SIZE],
+        length - SNAPSHOT_SECTION_HEADER_SIZE);
+    while (length != SNAPSHOT_PAD(length)) {
+        buffer[length] = 0;
+        length++;
+    }
+    encode_unsigned16(&buffer[0], handler->id);
+    encode_unsigned16(&buffer[2], handler->version);
+    encode_unsigned16(&buffer[4], handler->record_size);
+    encode_unsigned16(&buffer[6], 0);
+    encode_unsigned32(&buffer[8], record_count);
+    encode_unsigned32(&buffer[12], crc);
+
+    return length;
+}
+
+/**
+ * @brief Encode a snapshot of every registered section
+ * @param buffer - [out] snapshot of snapshot_size() bytes
+ * @param size - number of bytes in the buffer
+ * @return number of bytes encoded, or 0 if the buffer is too small
+ */
+size_t snapshot_encode(uint8_t *buffer, size_t size)
+{
+    size_t length = SNAPSHOT_HEADER_SIZE;
+    size_t len;
+    uint16_t sections = 0;
+    unsigned i;
+
+    if (!buffer || (size < SNAPSHOT_HEADER_SIZE)) {
+        return 0;
+    }
+    for (i = 0; i < Section_Count; i++) {
+        len = snapshot_section_encode(
+            &Section_Handler[i], &buffer[length], size - length);
+        if (len > 0) {
+            length += len;
+            sections++;
+        }
+    }
+    snapshot_header_encode(buffer, sections, length);
+
+    return length;
+}
+
+/**
+ * @brief Decode the header of a section, and check its bounds
+ * @param buffer - the section
+ * @param size - number of bytes from the section to the end of the
+ *  snapshot
+ * @param section - [out] the section
+ * @return number of bytes in the section, or 0 if it is not valid
+ */
+static size_t snapshot_section_decode(
+    uint8_t *buffer, size_t size, SNAPSHOT_SECTION *section)
+{
+    size_t length;
+
+    if (size < SNAPSHOT_SECTION_HEADER_SIZE) {
+        return 0;
+    }
+    decode_unsigned16(&buffer[0], &section->id);
+    decode_unsigned16(&buffer[2], &section->version);
+    decode_unsigned16(&buffer[4], &section->record_size);
+    decode_unsigned32(&buffer[8], &section->record_count);
+    if ((section->record_size == 0) ||
+        (section->record_count >
+            ((size - SNAPSHOT_SECTION_HEADER_SIZE) / section->record_size))) {
+        return 0;
+    }
+    section->records = &buffer[SNAPSHOT_SECTION_HEADER_SIZE];
+    length = SNAPSHOT_SECTION_HEADER_SIZE +
+        ((size_t)section->record_count * section->record_size);
+    length = SNAPSHOT_PAD(length);
+    if (length > size) {
+        return 0;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Check the CRC of the records of a section
+ * @param buffer - the section
+ * @param section - the decoded section
+ * @return true if the CRC matches
+ */
+static bool snapshot_section_crc_valid(
+    uint8_t *buffer, SNAPSHOT_SECTION *section)
+{
+    uint32_t crc = 0;
+
+    decode_unsigned32(&buffer[12], &crc);
+
+    return crc ==
+        snapshot_crc32(0, section->records,
+            (size_t)section->record_count * section->record_size);
+}
+
+/**
+ * @brief Decode the header of a snapshot
+ * @param buffer - the snapshot
+ * @param size - number of bytes in the buffer
+ * @param sections - [out] number of sections
+ * @return number of bytes in the snapshot, or 0 if it is not a snapshot
+ *  of this version
+ */
+static size_t snapshot_header_decode(
+    uint8_t *buffer, size_t size, uint16_t *sections)
+{
+    uint16_t version = 0;
+    uint32_t length = 0;
+
+    if (!buffer || (size < SNAPSHOT_HEADER_SIZE)) {
+        return 0;
+    }
+    if ((buffer[0] != 'B') || (buffer[1] != 'A') || (buffer[2] != 'C') ||
+        (buffer[3] != 'S')) {
+        return 0;
+    }
+    decode_unsigned16(&buffer[4], &version);
+    decode_unsigned16(&buffer[6], sections);
+    decode_unsigned32(&buffer[8], &length);
+    if ((version != SNAPSHOT_VERSION) || (length < SNAPSHOT_HEADER_SIZE) ||
+        (length > size)) {
+        return 0;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Determine if a buffer holds a complete snapshot of this version,
+ *  with valid CRCs for every section
+ * @param buffer - the snapshot
+ * @param size - number of bytes in the buffer
+ * @return true if the snapshot is valid
+ */
+bool snapshot_valid(uint8_t *buffer, size_t size)
+{
+    SNAPSHOT_SECTION section = { 0 };
+    uint16_t sections = 0;
+    size_t offset = SNAPSHOT_HEADER_SIZE;
+    size_t length;
+    size_t len;
+    unsigned i;
+
+    length = snapshot_header_decode(buffer, size, &sections);
+    if (length == 0) {
+        return false;
+    }
+    for (i = 0; i < sections; i++) {
+        len = snapshot_section_decode(
+            &buffer[offset], length - offset, &section);
+        if ((len == 0) ||
+            !snapshot_section_crc_valid(&buffer[offset], &section)) {
+            return false;
+        }
+        offset += len;
+    }
+
+    return offset == length;
+}
+
+/**
+ * @brief Find a section in a snapshot, and check its CRC
+ * @param buffer - the snapshot
+ * @param size - number of bytes in the buffer
+ * @param id - section identifier
+ * @param section - [out] the section, with its records in the buffer
+ * @return true if the section was found and is valid
+ */
+bool snapshot_section_find(
+    uint8_t *buffer, size_t size, uint16_t id, SNAPSHOT_SECTION *section)
+{
+    uint16_t sections = 0;
+    size_t offset = SNAPSHOT_HEADER_SIZE;
+    size_t length;
+    size_t len;
+    unsigned i;
+
+    if (!section) {
+        return false;
+    }
+    length = snapshot_header_decode(buffer, size, &sections);
+    if (length == 0) {
+        return false;
+    }
+    for (i = 0; i < sections; i++) {
+        len = snapshot_section_decode(
+            &buffer[offset], length - offset, section);
+        if (len == 0) {
+            break;
+        }
+        if (section->id == id) {
+            return snapshot_section_crc_valid(&buffer[offset], section);
+        }
+        offset += len;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Restore the records of the registered sections from a snapshot.
+ *  A section with a bad CRC, or with another version or record size than
+ *  the registered section, is skipped.
+ * @param buffer - the snapshot
+ * @param size - number of bytes in the buffer
+ * @return number of records restored
+ */
+uint32_t snapshot_restore(uint8_t *buffer, size_t size)
+{
+    struct snapshot_section_handler *handler;
+    SNAPSHOT_SECTION section = { 0 };
+    uint16_t sections = 0;
+    uint32_t restored = 0;
+    uint32_t index;
+    uint8_t *record;
+    size_t offset = SNAPSHOT_HEADER_SIZE;
+    size_t length;
+    size_t len;
+    unsigned i, j;
+
+    length = snapshot_header_decode(buffer, size, &sections);
+    if (length == 0) {
+        return 0;
+    }
+    for (i = 0; i < sections; i++) {
+        len = snapshot_section_decode(
+            &buffer[offset], length - offset, &section);
+        if (len == 0) {
+            break;
+        }
+        for (j = 0; j < Section_Count; j++) {
+            handler = &Section_Handler[j];
+            if ((handler->id != section.id) ||
+                (handler->version != section.version) ||
+                (handler->record_size != section.record_size)) {
+                continue;
+            }
+            if (!snapshot_section_crc_valid(&buffer[offset], &section)) {
+                break;
+            }
+            record = section.records;
+            for (index = 0; index < section.record_count; index++) {
+                if (handler->restore(index, record)) {
+                    restored++;
+                }
+                record += section.record_size;
+            }
+            break;
+        }
+        offset += len;
+    }
+
+    return restored;
+}
+
+/**
+ * @brief Write a snapshot to a file, through a temporary file that
+ *  replaces the file, so that a partly written file is never loaded
+ * @param filename - name of the file
+ * @param buffer - the snapshot
+ * @param length - number of bytes in the snapshot
+ * @return true if the file was written
+ */
+static bool snapshot_file_write(
+    const char *filename, uint8_t *buffer, size_t length)
+{
+    char temp_filename[256] = { 0 };
+    FILE *pFile = NULL;
+    bool status = false;
+    int len;
+
+    len = snprintf(
+        temp_filename, sizeof(temp_filename), "%s.tmp", filename);
+    if ((len <= 0) || (len >= (int)sizeof(temp_filename))) {
+        return false;
+    }
+    pFile = fopen(temp_filename, "wb");
+    if (!pFile) {
+        return false;
+    }
+    if (fwrite(buffer, 1, length, pFile) == length) {
+        status = true;
+    }
+    if (fclose(pFile) != 0) {
+        status = false;
+    }
+    if (status && (rename(temp_filename, filename) != 0)) {
+        /* some systems do not replace a file that exists */
+        (void)remove(filename);
+        status = (rename(temp_filename, filename) == 0);
+    }
+    if (!status) {
+        (void)remove(temp_filename);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Write a snapshot of every registered section to a file
+ * @param filename - name of the file
+ * @return true if the file was written
+ */
+bool snapshot_file_save(const char *filename)
+{
+    uint8_t *buffer;
+    size_t size;
+    size_t length;
+    bool status = false;
+
+    if (!filename) {
+        return false;
+    }
+    size = snapshot_size();
+    buffer = malloc(size);
+    if (buffer) {
+        length = snapshot_encode(buffer, size);
+        if (length > 0) {
+            status = snapshot_file_write(filename, buffer, length);
+        }
+        if (status) {
+            Writer.crc = snapshot_crc32(0, buffer, length);
+            Writer.written = true;
+        }
+        free(buffer);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Restore the registered sections from a snapshot file
+ * @param filename - name of the file
+ * @return number of records restored
+ */
+uint32_t snapshot_file_load(const char *filename)
+{
+    FILE *pFile = NULL;
+    uint8_t *buffer = NULL;
+    uint32_t restored = 0;
+    long size = 0;
+
+    if (!filename) {
+        return 0;
+    }
+    pFile = fopen(filename, "rb");
+    if (!pFile) {
+        return 0;
+    }
+    if (fseek(pFile, 0, SEEK_END) == 0) {
+        size = ftell(pFile);
+    }
+    if ((size >= SNAPSHOT_HEADER_SIZE) && (fseek(pFile, 0, SEEK_SET) == 0)) {
+        buffer = malloc((size_t)size);
+    }
+    if (buffer) {
+        if (fread(buffer, 1, (size_t)size, pFile) == (size_t)size) {
+            restored = snapshot_restore(buffer, (size_t)size);
+            Writer.crc = snapshot_crc32(0, buffer, (size_t)size);
+            Writer.written = true;
+        }
+        free(buffer);
+    }
+    fclose(pFile);
+
+    return restored;
+}
+
+/**
+ * @brief Write the snapshot file in the background.  Every
+ *  SNAPSHOT_FILE_INTERVAL seconds a pass starts, which encodes one section
+ *  for each call, so that a large table does not hold up the other tasks
+ *  for long.  At the end of the pass the file is written if the snapshot
+ *  has changed since it was last written.
+ * @param filename - name of the file
+ * @param seconds - number of seconds since the last call
+ */
+void snapshot_file_timer(const char *filename, uint16_t seconds)
+{
+    uint32_t crc;
+    size_t len;
+
+    if (!filename) {
+        return;
+    }
+    if (!Writer.buffer) {
+        Writer.elapsed += seconds;
+        if (Writer.elapsed < SNAPSHOT_FILE_INTERVAL) {
+            return;
+        }
+        Writer.elapsed = 0;
+        Writer.size = snapshot_size();
+        Writer.buffer = malloc(Writer.size);
+        if (!Writer.buffer) {
+            return;
+        }
+        Writer.length = SNAPSHOT_HEADER_SIZE;
+        Writer.handler = 0;
+        Writer.sections = 0;
+    }
+    if (Writer.handler < Section_Count) {
+        len = snapshot_section_encode(&Section_Handler[Writer.handler],
+            &Writer.buffer[Writer.length], Writer.size - Writer.length);
+        if (len > 0) {
+            Writer.length += len;
+            Writer.sections++;
+        }
+        Writer.handler++;
+    }
+    if (Writer.handler >= Section_Count) {
+        snapshot_header_encode(Writer.buffer, Writer.sections, Writer.length);
+        crc = snapshot_crc32(0, Writer.buffer, Writer.length);
+        if (!Writer.written || (crc != Writer.crc)) {
+            if (snapshot_file_write(filename, Writer.buffer, Writer.length)) {
+                Writer.crc = crc;
+                Writer.written = true;
+            }
+        }
+        free(Writer.buffer);
+        Writer.buffer = NULL;
+    }
+}
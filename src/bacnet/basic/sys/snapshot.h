@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief API for versioned and checksummed binary warm start snapshots
+ *  of the address cache, the COV subscriptions, the BDT and FDT, and the
+ *  priority-arrays of commandable objects
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacnet_stack_exports.h"
+
+/* Snapshot layout, with every value in network byte order:
+   header: "BACS", format version (2), section count (2), length (4)
+   each section: id (2), version (2), record size (2), reserved (2),
+       record count (4), CRC-32 of the records (4), the fixed size
+       records, and zero padding to the next 4 byte boundary */
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_HEADER_SIZE 12
+#define SNAPSHOT_SECTION_HEADER_SIZE 16
+/* number of sections that can be registered */
+#ifndef SNAPSHOT_SECTIONS_MAX
+#define SNAPSHOT_SECTIONS_MAX 8
+#endif
+/* seconds between the passes of snapshot_file_timer() */
+#ifndef SNAPSHOT_FILE_INTERVAL
+#define SNAPSHOT_FILE_INTERVAL 60
+#endif
+
+/* section identifiers */
+#define SNAPSHOT_SECTION_ADDRESS_CACHE 1
+#define SNAPSHOT_SECTION_COV_SUBSCRIPTIONS 2
+#define SNAPSHOT_SECTION_BDT 3
+#define SNAPSHOT_SECTION_FDT 4
+#define SNAPSHOT_SECTION_ANALOG_OUTPUT 5
+#define SNAPSHOT_SECTION_BINARY_OUTPUT 6
+
+/**
+ * Get the number of entries of a section, some of which might not be
+ * saved.
+ * @return number of entries
+ */
+typedef uint32_t (*snapshot_count_function)(void);
+
+/**
+ * Encode an entry of a section as a fixed size record.
+ * @param index - entry 0..count-1
+ * @param record - [out] the record
+ * @return true if the entry was encoded, false to skip the entry
+ */
+typedef bool (*snapshot_encode_function)(uint32_t index, uint8_t *record);
+
+/**
+ * Restore a fixed size record of a section.
+ * @param index - record 0..N-1 of the section
+ * @param record - the record
+ * @return true if the record was restored
+ */
+typedef bool (*snapshot_restore_function)(uint32_t index, uint8_t *record);
+
+/**
+ * A section found in a snapshot.  The records are used in place, such as
+ * from a memory mapped file.
+ *
+ * @{
+ */
+typedef struct snapshot_section {
+    uint16_t id;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t record_count;
+    uint8_t *records;
+} SNAPSHOT_SECTION;
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void snapshot_init(void);
+BACNET_STACK_EXPORT
+bool snapshot_section_register(uint16_t id,
+    uint16_t version,
+    uint16_t record_size,
+    snapshot_count_function count,
+    snapshot_encode_function encode,
+    snapshot_restore_function restore);
+BACNET_STACK_EXPORT
+uint32_t snapshot_crc32(uint32_t crc, uint8_t *data, size_t length);
+BACNET_STACK_EXPORT
+size_t snapshot_size(void);
+BACNET_STACK_EXPORT
+size_t snapshot_encode(uint8_t *buffer, size_t size);
+BACNET_STACK_EXPORT
+bool snapshot_valid(uint8_t *buffer, size_t size);
+BACNET_STACK_EXPORT
+bool snapshot_section_find(
+    uint8_t *buffer, size_t size, uint16_t id, SNAPSHOT_SECTION *section);
+BACNET_STACK_EXPORT
+uint32_t snapshot_restore(uint8_t *buffer, size_t size);
+
+BACNET_STACK_EXPORT
+bool snapshot_file_save(const char *filename);
+BACNET_STACK_EXPORT
+uint32_t snapshot_file_load(const char *filename);
+BACNET_STACK_EXPORT
+void snapshot_file_timer(const char *filename, uint16_t seconds);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
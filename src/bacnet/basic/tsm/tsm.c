@@ -35,6 +35,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #include "bacnet/bits.h"
 #include "bacnet/apdu.h"
 #include "bacnet/bacaddr.h"
@@ -46,6 +47,7 @@
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/metrics.h"
 
 /** @file tsm.c  BACnet Transaction State Machine operations  */
 /* FIXME: modify basic service handlers to use TSM rather than this buffer! */
@@ -59,12 +61,24 @@ uint8_t Handler_Transmit_Buffer[MAX_PDU];
 
 /* FIXME: not coded for segmentation */
 
-/* declare space for the TSM transactions, and set it up in the init. */
-/* table rules: an Invoke ID = 0 is an unused spot in the table */
-static BACNET_TSM_DATA TSM_List[MAX_TSM_TRANSACTIONS];
-
-/* invoke ID for incrementing between subsequent calls. */
-static uint8_t Current_Invoke_ID = 1;
+struct tsm_context {
+    /* declare space for the TSM transactions, and set it up in the init. */
+    /* table rules: an Invoke ID = 0 is an unused spot in the table */
+    BACNET_TSM_DATA List[MAX_TSM_TRANSACTIONS];
+    /* invoke ID for incrementing between subsequent calls. */
+    uint8_t Current_Invoke_ID;
+    /* networks that a router reported with Router-Busy-To-Network */
+    struct tsm_busy_network {
+        uint16_t net;
+        /* milliseconds until the network is no longer busy, 0=unused */
+        uint16_t timer;
+    } Busy_Network[MAX_TSM_BUSY_NETWORKS];
+};
+/* zero initialized, so that adding a member cannot miss an initializer;
+   the first invoke ID is set to 1 when the context is first used */
+static struct tsm_context TSM_Default;
+/* the TSM state of the selected stack context */
+static struct tsm_context *TSM = &TSM_Default;
 
 static tsm_timeout_function Timeout_Function;
 
@@ -73,6 +87,144 @@ void tsm_set_timeout_handler(tsm_timeout_function pFunction)
     Timeout_Function = pFunction;
 }
 
+/**
+ * @brief Get the size of the TSM state of one stack context
+ * @return size of the TSM state, in bytes
+ */
+size_t tsm_context_size(void)
+{
+    return sizeof(struct tsm_context);
+}
+
+/**
+ * @brief Initialize the TSM state of a stack context
+ * @param context - memory of tsm_context_size() bytes
+ */
+void tsm_context_init(void *context)
+{
+    struct tsm_context *pContext = context;
+
+    if (pContext) {
+        memset(pContext, 0, sizeof(struct tsm_context));
+        pContext->Current_Invoke_ID = 1;
+    }
+}
+
+/**
+ * @brief Select the TSM state used by the TSM functions
+ * @param context - TSM state from tsm_context_init(), or NULL
+ *  to select the default TSM state
+ * @return the previously selected TSM state, or NULL for the default
+ */
+void *tsm_context_select(void *context)
+{
+    struct tsm_context *previous = TSM;
+
+    if (context) {
+        TSM = context;
+    } else {
+        TSM = &TSM_Default;
+    }
+
+    return (previous == &TSM_Default) ? NULL : previous;
+}
+
+/**
+ * @brief Send a confirmed request that was held for a busy network,
+ *  and start its timer
+ * @param plist - transaction
+ */
+static void tsm_transaction_release(BACNET_TSM_DATA *plist)
+{
+    plist->NetworkHold = false;
+    plist->RequestTimer = apdu_timeout();
+    datalink_send_pdu(
+        &plist->dest, &plist->npdu_data, &plist->apdu[0], plist->apdu_len);
+}
+
+/**
+ * @brief Send the confirmed requests that were held for a network
+ *  that is available again
+ * @param net - BACnet network number
+ */
+static void tsm_network_release(uint16_t net)
+{
+    BACNET_TSM_DATA *plist = &TSM->List[0];
+    unsigned i;
+
+    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
+        if ((plist->state == TSM_STATE_AWAIT_CONFIRMATION) &&
+            plist->NetworkHold && (plist->dest.net == net)) {
+            tsm_transaction_release(plist);
+        }
+    }
+}
+
+/**
+ * @brief Set or clear a network that is busy, from Router-Busy-To-Network
+ *  and Router-Available-To-Network.  A busy network stays busy for
+ *  TSM_BUSY_NETWORK_TIMEOUT milliseconds unless the router reports it
+ *  again, see 6.6.3.6.
+ * @param net - BACnet network number
+ * @param busy - true if the router reported the network as busy
+ */
+void tsm_network_busy_set(uint16_t net, bool busy)
+{
+    struct tsm_busy_network *entry = NULL;
+    unsigned i;
+
+    if ((net == 0) || (net == BACNET_BROADCAST_NETWORK)) {
+        return;
+    }
+    for (i = 0; i < MAX_TSM_BUSY_NETWORKS; i++) {
+        if ((TSM->Busy_Network[i].timer > 0) &&
+            (TSM->Busy_Network[i].net == net)) {
+            entry = &TSM->Busy_Network[i];
+            break;
+        }
+    }
+    if (!busy) {
+        if (entry) {
+            entry->timer = 0;
+            tsm_network_release(net);
+        }
+        return;
+    }
+    if (!entry) {
+        /* an unused entry, or else the one that expires first */
+        entry = &TSM->Busy_Network[0];
+        for (i = 0; i < MAX_TSM_BUSY_NETWORKS; i++) {
+            if (TSM->Busy_Network[i].timer < entry->timer) {
+                entry = &TSM->Busy_Network[i];
+            }
+        }
+    }
+    entry->net = net;
+    entry->timer = TSM_BUSY_NETWORK_TIMEOUT;
+}
+
+/**
+ * @brief Determine if a router reported a network as busy
+ * @param net - BACnet network number
+ * @return true if requests to the network are held back
+ */
+bool tsm_network_busy(uint16_t net)
+{
+    unsigned i;
+
+    if ((net == 0) || (net == BACNET_BROADCAST_NETWORK)) {
+        return false;
+    }
+    for (i = 0; i < MAX_TSM_BUSY_NETWORKS; i++) {
+        if ((TSM->Busy_Network[i].timer > 0) &&
+            (TSM->Busy_Network[i].net == net)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /** Find the given Invoke-Id in the list and
  *  return the index.
  *
@@ -86,7 +238,7 @@ static uint8_t tsm_find_invokeID_index(uint8_t invokeID)
     unsigned i = 0; /* counter */
     uint8_t index = MAX_TSM_TRANSACTIONS; /* return value */
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+    const BACNET_TSM_DATA *plist = TSM->List;
 
     for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
         if (plist->InvokeID == invokeID) {
@@ -108,7 +260,7 @@ static uint8_t tsm_find_first_free_index(void)
     unsigned i = 0; /* counter */
     uint8_t index = MAX_TSM_TRANSACTIONS; /* return value */
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+    const BACNET_TSM_DATA *plist = TSM->List;
 
     for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
         if (plist->InvokeID == 0) {
@@ -129,7 +281,7 @@ bool tsm_transaction_available(void)
     bool status = false; /* return value */
     unsigned i = 0; /* counter */
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+    const BACNET_TSM_DATA *plist = TSM->List;
 
     for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
         if (plist->InvokeID == 0) {
@@ -151,7 +303,7 @@ uint8_t tsm_transaction_idle_count(void)
     uint8_t count = 0; /* return value */
     unsigned i = 0; /* counter */
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+    const BACNET_TSM_DATA *plist = TSM->List;
 
     for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
         if ((plist->InvokeID == 0) && (plist->state == TSM_STATE_IDLE)) {
@@ -173,7 +325,7 @@ void tsm_invokeID_set(uint8_t invokeID)
     if (invokeID == 0) {
         invokeID = 1;
     }
-    Current_Invoke_ID = invokeID;
+    TSM->Current_Invoke_ID = invokeID;
 }
 
 /** Gets the next free invokeID,
@@ -191,36 +343,42 @@ uint8_t tsm_next_free_invokeID(void)
 
     /* Is there even space available? */
     if (tsm_transaction_available()) {
+        if (TSM->Current_Invoke_ID == 0) {
+            /* the zero initialized default context */
+            TSM->Current_Invoke_ID = 1;
+        }
         while (!found) {
-            index = tsm_find_invokeID_index(Current_Invoke_ID);
+            index = tsm_find_invokeID_index(TSM->Current_Invoke_ID);
             if (index == MAX_TSM_TRANSACTIONS) {
                 /* Not found, so this invokeID is not used */
                 found = true;
                 /* set this id into the table */
                 index = tsm_find_first_free_index();
                 if (index != MAX_TSM_TRANSACTIONS) {
-                    plist = &TSM_List[index];
-                    plist->InvokeID = invokeID = Current_Invoke_ID;
+                    plist = &TSM->List[index];
+                    plist->InvokeID = invokeID = TSM->Current_Invoke_ID;
                     plist->state = TSM_STATE_IDLE;
                     plist->RequestTimer = apdu_timeout();
                     /* update for the next call or check */
-                    Current_Invoke_ID++;
+                    TSM->Current_Invoke_ID++;
                     /* skip zero - we treat that internally as invalid or no
                      * free */
-                    if (Current_Invoke_ID == 0) {
-                        Current_Invoke_ID = 1;
+                    if (TSM->Current_Invoke_ID == 0) {
+                        TSM->Current_Invoke_ID = 1;
                     }
                 }
             } else {
                 /* found! This invokeID is already used */
                 /* try next one */
-                Current_Invoke_ID++;
+                TSM->Current_Invoke_ID++;
                 /* skip zero - we treat that internally as invalid or no free */
-                if (Current_Invoke_ID == 0) {
-                    Current_Invoke_ID = 1;
+                if (TSM->Current_Invoke_ID == 0) {
+                    TSM->Current_Invoke_ID = 1;
                 }
             }
         }
+    } else {
+        METRICS_COUNT(METRICS_TSM_EXHAUSTED);
     }
 
     return invokeID;
@@ -248,10 +406,11 @@ void tsm_set_confirmed_unsegmented_transaction(uint8_t invokeID,
     if (invokeID && ndpu_data && apdu && (apdu_len > 0)) {
         index = tsm_find_invokeID_index(invokeID);
         if (index < MAX_TSM_TRANSACTIONS) {
-            plist = &TSM_List[index];
+            plist = &TSM->List[index];
             /* SendConfirmedUnsegmented */
             plist->state = TSM_STATE_AWAIT_CONFIRMATION;
             plist->RetryCount = 0;
+            plist->NetworkHold = false;
             /* start the timer */
             plist->RequestTimer = apdu_timeout();
             /* copy the data */
@@ -261,6 +420,7 @@ void tsm_set_confirmed_unsegmented_transaction(uint8_t invokeID,
             plist->apdu_len = apdu_len;
             npdu_copy_data(&plist->npdu_data, ndpu_data);
             bacnet_address_copy(&plist->dest, dest);
+            METRICS_COUNT(METRICS_TSM_TRANSACTIONS);
         }
     }
 
@@ -297,7 +457,7 @@ bool tsm_get_transaction_pdu(uint8_t invokeID,
             /* FIXME: we may want to free the transaction so it doesn't timeout
              */
             /* retrieve the transaction */
-            plist = &TSM_List[index];
+            plist = &TSM->List[index];
             *apdu_len = (uint16_t)plist->apdu_len;
             if (*apdu_len > MAX_PDU) {
                 *apdu_len = MAX_PDU;
@@ -314,6 +474,47 @@ bool tsm_get_transaction_pdu(uint8_t invokeID,
     return found;
 }
 
+/**
+ * @brief Send a PDU, unless a router reported the network of the
+ *  destination as busy, see 6.6.3.6.  A confirmed request is then held in
+ *  its transaction, and sent when the router reports the network as
+ *  available or the busy network times out.  Any other PDU to a busy
+ *  network is discarded, the same as the router would discard it.
+ * @param invokeID - invoke ID of the transaction that was set with
+ *  tsm_set_confirmed_unsegmented_transaction(), or 0 if there is none
+ * @param dest - destination address
+ * @param npdu_data - network layer info
+ * @param pdu - the NPDU and APDU to send
+ * @param pdu_len - number of bytes in the PDU
+ * @return number of bytes sent or held, 0 if discarded, or a negative
+ *  value if the datalink failed
+ */
+int tsm_send_pdu(uint8_t invokeID,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    uint8_t index = MAX_TSM_TRANSACTIONS;
+    BACNET_TSM_DATA *plist;
+
+    if (dest && tsm_network_busy(dest->net)) {
+        if (invokeID) {
+            index = tsm_find_invokeID_index(invokeID);
+        }
+        if (index < MAX_TSM_TRANSACTIONS) {
+            plist = &TSM->List[index];
+            if (plist->state == TSM_STATE_AWAIT_CONFIRMATION) {
+                plist->NetworkHold = true;
+                return (int)pdu_len;
+            }
+        }
+        return 0;
+    }
+
+    return datalink_send_pdu(dest, npdu_data, pdu, pdu_len);
+}
+
 /** Called once a millisecond or slower.
  *  This function calls the handler for a
  *  timeout 'Timeout_Function', if necessary.
@@ -324,10 +525,24 @@ void tsm_timer_milliseconds(uint16_t milliseconds)
 {
     unsigned i = 0; /* counter */
 
-    BACNET_TSM_DATA *plist = &TSM_List[0];
+    BACNET_TSM_DATA *plist = &TSM->List[0];
 
+    for (i = 0; i < MAX_TSM_BUSY_NETWORKS; i++) {
+        if (TSM->Busy_Network[i].timer > milliseconds) {
+            TSM->Busy_Network[i].timer -= milliseconds;
+        } else {
+            TSM->Busy_Network[i].timer = 0;
+        }
+    }
     for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if (plist->state == TSM_STATE_AWAIT_CONFIRMATION) {
+        if ((plist->state == TSM_STATE_AWAIT_CONFIRMATION) &&
+            plist->NetworkHold) {
+            /* the router reported the network as available, or the
+               busy network timed out */
+            if (!tsm_network_busy(plist->dest.net)) {
+                tsm_transaction_release(plist);
+            }
+        } else if (plist->state == TSM_STATE_AWAIT_CONFIRMATION) {
             if (plist->RequestTimer > milliseconds) {
                 plist->RequestTimer -= milliseconds;
             } else {
@@ -335,9 +550,14 @@ void tsm_timer_milliseconds(uint16_t milliseconds)
             }
             /* AWAIT_CONFIRMATION */
             if (plist->RequestTimer == 0) {
-                if (plist->RetryCount < apdu_retries()) {
+                if (tsm_network_busy(plist->dest.net)) {
+                    /* hold the retry until the router is available,
+                       without using up a retry */
+                    plist->NetworkHold = true;
+                } else if (plist->RetryCount < apdu_retries()) {
                     plist->RequestTimer = apdu_timeout();
                     plist->RetryCount++;
+                    METRICS_COUNT(METRICS_TSM_RETRIES);
                     datalink_send_pdu(&plist->dest, &plist->npdu_data,
                         &plist->apdu[0], plist->apdu_len);
                 } else {
@@ -345,6 +565,7 @@ void tsm_timer_milliseconds(uint16_t milliseconds)
                        and this indicates a failed message:
                        IDLE and a valid invoke id */
                     plist->state = TSM_STATE_IDLE;
+                    METRICS_COUNT(METRICS_TSM_TIMEOUTS);
                     if (plist->InvokeID != 0) {
                         if (Timeout_Function) {
                             Timeout_Function(plist->InvokeID);
@@ -367,7 +588,7 @@ void tsm_free_invoke_id(uint8_t invokeID)
 
     index = tsm_find_invokeID_index(invokeID);
     if (index < MAX_TSM_TRANSACTIONS) {
-        plist = &TSM_List[index];
+        plist = &TSM->List[index];
         plist->state = TSM_STATE_IDLE;
         plist->InvokeID = 0;
     }
@@ -407,11 +628,52 @@ bool tsm_invoke_id_failed(uint8_t invokeID)
     if (index < MAX_TSM_TRANSACTIONS) {
         /* a valid invoke ID and the state is IDLE is a
            message that failed to confirm */
-        if (TSM_List[index].state == TSM_STATE_IDLE) {
+        if (TSM->List[index].state == TSM_STATE_IDLE) {
             status = true;
         }
     }
 
     return status;
 }
-#endif
\ No newline at end of file
+#else
+size_t tsm_context_size(void)
+{
+    return 0;
+}
+
+void tsm_context_init(void *context)
+{
+    (void)context;
+}
+
+void *tsm_context_select(void *context)
+{
+    (void)context;
+
+    return NULL;
+}
+
+void tsm_network_busy_set(uint16_t net, bool busy)
+{
+    (void)net;
+    (void)busy;
+}
+
+bool tsm_network_busy(uint16_t net)
+{
+    (void)net;
+
+    return false;
+}
+
+int tsm_send_pdu(uint8_t invokeID,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)invokeID;
+
+    return datalink_send_pdu(dest, npdu_data, pdu, pdu_len);
+}
+#endif
@@ -35,6 +35,15 @@
 /* note: TSM functionality is optional - only needed if we are
    doing client requests */
 
+/* networks that can be reported busy by a router at the same time */
+#ifndef MAX_TSM_BUSY_NETWORKS
+#define MAX_TSM_BUSY_NETWORKS 4
+#endif
+/* milliseconds that a network stays busy after Router-Busy-To-Network */
+#ifndef TSM_BUSY_NETWORK_TIMEOUT
+#define TSM_BUSY_NETWORK_TIMEOUT 30000
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -43,6 +52,33 @@ extern "C" {
     BACNET_STACK_EXPORT extern 
     uint8_t Handler_Transmit_Buffer[MAX_PDU];
 
+    /* TSM state of one stack context - see stack_context.h */
+    BACNET_STACK_EXPORT
+    size_t tsm_context_size(
+        void);
+    BACNET_STACK_EXPORT
+    void tsm_context_init(
+        void *context);
+    BACNET_STACK_EXPORT
+    void *tsm_context_select(
+        void *context);
+
+    /* networks reported by Router-Busy-To-Network */
+    BACNET_STACK_EXPORT
+    void tsm_network_busy_set(
+        uint16_t net,
+        bool busy);
+    BACNET_STACK_EXPORT
+    bool tsm_network_busy(
+        uint16_t net);
+    BACNET_STACK_EXPORT
+    int tsm_send_pdu(
+        uint8_t invokeID,
+        BACNET_ADDRESS * dest,
+        BACNET_NPDU_DATA * npdu_data,
+        uint8_t * pdu,
+        unsigned pdu_len);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -94,6 +130,8 @@ typedef struct BACnet_TSM_Data {
     /* copy of the APDU, should we need to send it again */
     uint8_t apdu[MAX_PDU];
     unsigned apdu_len;
+    /* held until a network that a router reported busy is available */
+    bool NetworkHold;
 } BACNET_TSM_DATA;
 
 typedef void (
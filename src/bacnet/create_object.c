@@ -0,0 +1,318 @@
+/**
+ * @file
+ * @brief CreateObject service encode and decode
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacenum.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/bacerror.h"
+#include "bacnet/create_object.h"
+
+/**
+ * @brief Encode the CreateObject service request only
+ *
+ *  CreateObject-Request ::= SEQUENCE {
+ *      object-specifier [0] CHOICE {
+ *          object-type [0] BACnetObjectType,
+ *          object-identifier [1] BACnetObjectIdentifier
+ *      },
+ *      list-of-initial-values [1] SEQUENCE OF BACnetPropertyValue OPTIONAL
+ *  }
+ *
+ * @param apdu  Pointer to the buffer for encoding, or NULL for the length
+ * @param data  Pointer to the service data to be encoded. An object_instance
+ *  of BACNET_MAX_INSTANCE encodes the object-type choice.
+ * @return Bytes encoded or zero on error.
+ */
+int create_object_encode_service_request(
+    uint8_t *apdu, BACNET_CREATE_OBJECT_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+    int i;
+
+    if (!data) {
+        return 0;
+    }
+    len = encode_opening_tag(apdu, 0);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    if (data->object_instance >= BACNET_MAX_INSTANCE) {
+        len = encode_context_enumerated(apdu, 0, data->object_type);
+    } else {
+        len = encode_context_object_id(
+            apdu, 1, data->object_type, data->object_instance);
+    }
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_closing_tag(apdu, 0);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    if (data->application_data && (data->application_data_len > 0)) {
+        len = encode_opening_tag(apdu, 1);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        for (i = 0; i < data->application_data_len; i++) {
+            if (apdu) {
+                *apdu = data->application_data[i];
+                apdu++;
+            }
+        }
+        apdu_len += data->application_data_len;
+        len = encode_closing_tag(apdu, 1);
+        apdu_len += len;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode the CreateObject service request only
+ * @param apdu  Pointer to the buffer for decoding.
+ * @param apdu_size  Count of valid bytes in the buffer.
+ * @param data  Pointer to the service data to be stored, or NULL. The
+ *  application_data points into the apdu, at the list of initial values.
+ * @return Bytes decoded or BACNET_STATUS_REJECT on error.
+ */
+int create_object_decode_service_request(
+    uint8_t *apdu, unsigned apdu_size, BACNET_CREATE_OBJECT_DATA *data)
+{
+    int len = 0;
+    unsigned apdu_len = 0;
+    uint32_t enumerated_value = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = BACNET_MAX_INSTANCE;
+
+    if (!apdu || (apdu_size < 4)) {
+        if (data) {
+            data->error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
+        }
+        return BACNET_STATUS_REJECT;
+    }
+    /* object-specifier [0] */
+    if (!decode_is_opening_tag_number(&apdu[apdu_len], 0)) {
+        if (data) {
+            data->error_code = ERROR_CODE_REJECT_INVALID_TAG;
+        }
+        return BACNET_STATUS_REJECT;
+    }
+    /* an opening tag number of 0 is not extended so only one octet */
+    apdu_len++;
+    len = bacnet_enumerated_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 0, &enumerated_value);
+    if (len > 0) {
+        /* object-type [0] */
+        if (enumerated_value > MAX_BACNET_OBJECT_TYPE) {
+            if (data) {
+                data->error_code = ERROR_CODE_REJECT_PARAMETER_OUT_OF_RANGE;
+            }
+            return BACNET_STATUS_REJECT;
+        }
+        object_type = (BACNET_OBJECT_TYPE)enumerated_value;
+    } else if (len == 0) {
+        /* object-identifier [1] */
+        len = bacnet_object_id_context_decode(&apdu[apdu_len],
+            apdu_size - apdu_len, 1, &object_type, &object_instance);
+    }
+    if (len <= 0) {
+        if (data) {
+            data->error_code = ERROR_CODE_REJECT_INVALID_TAG;
+        }
+        return BACNET_STATUS_REJECT;
+    }
+    apdu_len += len;
+    if ((apdu_len >= apdu_size) ||
+        !decode_is_closing_tag_number(&apdu[apdu_len], 0)) {
+        if (data) {
+            data->error_code = ERROR_CODE_REJECT_INVALID_TAG;
+        }
+        return BACNET_STATUS_REJECT;
+    }
+    apdu_len++;
+    if (data) {
+        data->object_type = object_type;
+        data->object_instance = object_instance;
+        data->application_data = NULL;
+        data->application_data_len = 0;
+    }
+    if (apdu_len == apdu_size) {
+        /* list-of-initial-values is optional */
+        return (int)apdu_len;
+    }
+    /* list-of-initial-values [1] */
+    if (!decode_is_opening_tag_number(&apdu[apdu_len], 1) ||
+        !decode_is_closing_tag_number(&apdu[apdu_size - 1], 1) ||
+        ((apdu_size - apdu_len) < 2)) {
+        if (data) {
+            data->error_code = ERROR_CODE_REJECT_INVALID_TAG;
+        }
+        return BACNET_STATUS_REJECT;
+    }
+    /* opening and closing tag number 1 are one octet each */
+    apdu_len++;
+    if (data) {
+        data->application_data = &apdu[apdu_len];
+        data->application_data_len = (int)(apdu_size - apdu_len - 1);
+    }
+    apdu_len = apdu_size;
+
+    return (int)apdu_len;
+}
+
+/**
+ * @brief Encode the CreateObject-ACK service data only
+ *  CreateObject-ACK ::= BACnetObjectIdentifier
+ * @param apdu  Pointer to the buffer for encoding, or NULL for the length
+ * @param data  Pointer to the service data to be encoded.
+ * @return Bytes encoded or zero on error.
+ */
+int create_object_ack_encode(uint8_t *apdu, BACNET_CREATE_OBJECT_DATA *data)
+{
+    if (!data) {
+        return 0;
+    }
+
+    return encode_application_object_id(
+        apdu, data->object_type, data->object_instance);
+}
+
+/**
+ * @brief Decode the CreateObject-ACK service data only
+ * @param apdu  Pointer to the buffer for decoding.
+ * @param apdu_size  Count of valid bytes in the buffer.
+ * @param data  Pointer to the service data to be stored, or NULL
+ * @return Bytes decoded or BACNET_STATUS_ERROR on error.
+ */
+int create_object_ack_decode(
+    uint8_t *apdu, unsigned apdu_size, BACNET_CREATE_OBJECT_DATA *data)
+{
+    int len = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+
+    if (!apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    len = bacnet_object_id_application_decode(
+        apdu, apdu_size, &object_type, &object_instance);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (data) {
+        data->object_type = object_type;
+        data->object_instance = object_instance;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Encode a CreateObject-Error service data only
+ *  CreateObject-Error ::= SEQUENCE {
+ *      error-type [0] Error,
+ *      first-failed-element-number [1] Unsigned
+ *  }
+ * @param apdu  Pointer to the buffer for encoding, or NULL for the length
+ * @param data  Pointer to the service data to be encoded.
+ * @return Bytes encoded or zero on error.
+ */
+int create_object_error_ack_encode(
+    uint8_t *apdu, BACNET_CREATE_OBJECT_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+
+    if (!data) {
+        return 0;
+    }
+    len = encode_opening_tag(apdu, 0);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_application_enumerated(apdu, data->error_class);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_application_enumerated(apdu, data->error_code);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_closing_tag(apdu, 0);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_context_unsigned(apdu, 1, data->first_failed_element_number);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode a CreateObject-Error service data only
+ * @param apdu  Pointer to the buffer for decoding.
+ * @param apdu_size  Count of valid bytes in the buffer.
+ * @param data  Pointer to the service data to be stored, or NULL
+ * @return Bytes decoded or BACNET_STATUS_ERROR on error.
+ */
+int create_object_error_ack_decode(
+    uint8_t *apdu, unsigned apdu_size, BACNET_CREATE_OBJECT_DATA *data)
+{
+    int len = 0;
+    unsigned apdu_len = 0;
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_SERVICES;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+    BACNET_UNSIGNED_INTEGER first_failed_element_number = 0;
+
+    if (!apdu || (apdu_size < 1)) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (!decode_is_opening_tag_number(&apdu[apdu_len], 0)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len++;
+    len = bacerror_decode_error_class_and_code(
+        &apdu[apdu_len], apdu_size - apdu_len, &error_class, &error_code);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    if ((apdu_len >= apdu_size) ||
+        !decode_is_closing_tag_number(&apdu[apdu_len], 0)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len++;
+    len = bacnet_unsigned_context_decode(&apdu[apdu_len],
+        apdu_size - apdu_len, 1, &first_failed_element_number);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    if (data) {
+        data->error_class = error_class;
+        data->error_code = error_code;
+        data->first_failed_element_number = first_failed_element_number;
+    }
+
+    return (int)apdu_len;
+}
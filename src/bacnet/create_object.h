@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @brief API for CreateObject service codec
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_CREATE_OBJECT_H
+#define BACNET_CREATE_OBJECT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacnet_stack_exports.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacdef.h"
+
+/**
+ *  CreateObject-Request ::= SEQUENCE {
+ *      object-specifier [0] CHOICE {
+ *          object-type [0] BACnetObjectType,
+ *          object-identifier [1] BACnetObjectIdentifier
+ *      },
+ *      list-of-initial-values [1] SEQUENCE OF BACnetPropertyValue OPTIONAL
+ *  }
+ *  CreateObject-ACK ::= BACnetObjectIdentifier
+ *  CreateObject-Error ::= SEQUENCE {
+ *      error-type [0] Error,
+ *      first-failed-element-number [1] Unsigned
+ *  }
+ */
+
+typedef struct BACnet_Create_Object_Data {
+    /* note: number type first to avoid enum cast warning on = { 0 } */
+    /* BACNET_MAX_INSTANCE when only the object-type is specified */
+    uint32_t object_instance;
+    BACNET_OBJECT_TYPE object_type;
+    /* the encoded BACnetPropertyValue list of initial values */
+    uint8_t *application_data;
+    int application_data_len;
+    BACNET_UNSIGNED_INTEGER first_failed_element_number;
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+} BACNET_CREATE_OBJECT_DATA;
+
+/**
+ * @brief Create a new object of this type
+ * @ingroup ObjHelpers
+ * @param object_instance [in] instance number of the new object
+ * @return true if the object was created, or false if the instance
+ *  already exists or no memory is available
+ */
+typedef bool (*create_object_function)(uint32_t object_instance);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+int create_object_encode_service_request(
+    uint8_t *apdu, BACNET_CREATE_OBJECT_DATA *data);
+BACNET_STACK_EXPORT
+int create_object_decode_service_request(
+    uint8_t *apdu, unsigned apdu_size, BACNET_CREATE_OBJECT_DATA *data);
+BACNET_STACK_EXPORT
+int create_object_ack_encode(uint8_t *apdu, BACNET_CREATE_OBJECT_DATA *data);
+BACNET_STACK_EXPORT
+int create_object_ack_decode(
+    uint8_t *apdu, unsigned apdu_size, BACNET_CREATE_OBJECT_DATA *data);
+BACNET_STACK_EXPORT
+int create_object_error_ack_encode(
+    uint8_t *apdu, BACNET_CREATE_OBJECT_DATA *data);
+BACNET_STACK_EXPORT
+int create_object_error_ack_decode(
+    uint8_t *apdu, unsigned apdu_size, BACNET_CREATE_OBJECT_DATA *data);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif
@@ -35,71 +35,50 @@
 #include "bacnet/datalink/datalink.h"
 
 #if defined(BACDL_ALL) || defined FOR_DOXYGEN
-#include "bacnet/datalink/ethernet.h"
-#include "bacnet/datalink/bip.h"
-#include "bacnet/datalink/bvlc.h"
-#include "bacnet/basic/bbmd/h_bbmd.h"
-#include "bacnet/datalink/bip6.h"
-#include "bacnet/datalink/bvlc6.h"
-#include "bacnet/basic/bbmd6/h_bbmd6.h"
-#include "bacnet/datalink/arcnet.h"
-#include "bacnet/datalink/dlmstp.h"
+#include "bacnet/datalink/dlport.h"
 #include <strings.h> /* for strcasecmp() */
 
-static enum {
-    DATALINK_NONE = 0,
-    DATALINK_ARCNET,
-    DATALINK_ETHERNET,
-    DATALINK_BIP,
-    DATALINK_BIP6,
-    DATALINK_MSTP
-} Datalink_Transport;
+/* datalink driver used by the datalink functions, or NULL for none */
+static const BACNET_DATALINK_DRIVER *Datalink_Driver;
+static void *Datalink_Context;
 
 void datalink_set(char *datalink_string)
 {
-    if (strcasecmp("bip", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_BIP;
-    } else if (strcasecmp("bip6", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_BIP6;
-    } else if (strcasecmp("ethernet", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_ETHERNET;
-    } else if (strcasecmp("arcnet", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_ARCNET;
-    } else if (strcasecmp("mstp", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_MSTP;
-    } else if (strcasecmp("none", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_NONE;
+    static const char *Names[] = { "bip", "bip6", "ethernet", "arcnet",
+        "mstp", "router" };
+    unsigned i;
+
+    if (strcasecmp("none", datalink_string) == 0) {
+        datalink_set_driver(NULL, NULL);
+        return;
+    }
+    for (i = 0; i < sizeof(Names) / sizeof(Names[0]); i++) {
+        if (strcasecmp(Names[i], datalink_string) == 0) {
+            datalink_set_driver(dlport_driver_by_name(Names[i]), NULL);
+            break;
+        }
     }
 }
 
-bool datalink_init(char *ifname)
+/**
+ * @brief Use a datalink driver for the datalink functions, for example
+ *  a loopback port, or the router driver to use several datalink ports
+ * @param driver - datalink driver, or NULL for none
+ * @param context - driver context
+ */
+void datalink_set_driver(const BACNET_DATALINK_DRIVER *driver, void *context)
 {
-    bool status = false;
+    Datalink_Driver = driver;
+    Datalink_Context = context;
+}
 
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            status = true;
-            break;
-        case DATALINK_ARCNET:
-            status = arcnet_init(ifname);
-            break;
-        case DATALINK_ETHERNET:
-            status = ethernet_init(ifname);
-            break;
-        case DATALINK_BIP:
-            status = bip_init(ifname);
-            break;
-        case DATALINK_BIP6:
-            status = bip6_init(ifname);
-            break;
-        case DATALINK_MSTP:
-            status = dlmstp_init(ifname);
-            break;
-        default:
-            break;
+bool datalink_init(char *ifname)
+{
+    if (!Datalink_Driver) {
+        return true;
     }
 
-    return status;
+    return Datalink_Driver->init(Datalink_Context, ifname);
 }
 
 int datalink_send_pdu(BACNET_ADDRESS *dest,
@@ -107,184 +86,55 @@ int datalink_send_pdu(BACNET_ADDRESS *dest,
     uint8_t *pdu,
     unsigned pdu_len)
 {
-    int bytes = 0;
-
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            bytes = pdu_len;
-            break;
-        case DATALINK_ARCNET:
-            bytes = arcnet_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        case DATALINK_ETHERNET:
-            bytes = ethernet_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        case DATALINK_BIP:
-            bytes = bip_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        case DATALINK_BIP6:
-            bytes = bip6_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        case DATALINK_MSTP:
-            bytes = dlmstp_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        default:
-            break;
+    if (!Datalink_Driver) {
+        return pdu_len;
     }
 
-    return bytes;
+    return Datalink_Driver->send_pdu(
+        Datalink_Context, dest, npdu_data, pdu, pdu_len);
 }
 
 uint16_t datalink_receive(
     BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
 {
-    uint16_t bytes = 0;
-
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            bytes = arcnet_receive(src, pdu, max_pdu, timeout);
-            break;
-        case DATALINK_ETHERNET:
-            bytes = ethernet_receive(src, pdu, max_pdu, timeout);
-            break;
-        case DATALINK_BIP:
-            bytes = bip_receive(src, pdu, max_pdu, timeout);
-            break;
-        case DATALINK_BIP6:
-            bytes = bip6_receive(src, pdu, max_pdu, timeout);
-            break;
-        case DATALINK_MSTP:
-            bytes = dlmstp_receive(src, pdu, max_pdu, timeout);
-            break;
-        default:
-            break;
+    if (!Datalink_Driver) {
+        return 0;
     }
 
-    return bytes;
+    return Datalink_Driver->receive(
+        Datalink_Context, src, pdu, max_pdu, timeout);
 }
 
 void datalink_cleanup(void)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            arcnet_cleanup();
-            break;
-        case DATALINK_ETHERNET:
-            ethernet_cleanup();
-            break;
-        case DATALINK_BIP:
-            bip_cleanup();
-            break;
-        case DATALINK_BIP6:
-            bip6_cleanup();
-            break;
-        case DATALINK_MSTP:
-            dlmstp_cleanup();
-            break;
-        default:
-            break;
+    if (Datalink_Driver) {
+        Datalink_Driver->cleanup(Datalink_Context);
     }
 }
 
 void datalink_get_broadcast_address(BACNET_ADDRESS *dest)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            arcnet_get_broadcast_address(dest);
-            break;
-        case DATALINK_ETHERNET:
-            ethernet_get_broadcast_address(dest);
-            break;
-        case DATALINK_BIP:
-            bip_get_broadcast_address(dest);
-            break;
-        case DATALINK_BIP6:
-            bip6_get_broadcast_address(dest);
-            break;
-        case DATALINK_MSTP:
-            dlmstp_get_broadcast_address(dest);
-            break;
-        default:
-            break;
+    if (Datalink_Driver) {
+        Datalink_Driver->get_broadcast_address(Datalink_Context, dest);
     }
 }
 
 void datalink_get_my_address(BACNET_ADDRESS *my_address)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            arcnet_get_my_address(my_address);
-            break;
-        case DATALINK_ETHERNET:
-            ethernet_get_my_address(my_address);
-            break;
-        case DATALINK_BIP:
-            bip_get_my_address(my_address);
-            break;
-        case DATALINK_BIP6:
-            bip6_get_my_address(my_address);
-            break;
-        case DATALINK_MSTP:
-            dlmstp_get_my_address(my_address);
-            break;
-        default:
-            break;
+    if (Datalink_Driver) {
+        Datalink_Driver->get_my_address(Datalink_Context, my_address);
     }
 }
 
 void datalink_set_interface(char *ifname)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            (void)ifname;
-            break;
-        case DATALINK_ARCNET:
-            (void)ifname;
-            break;
-        case DATALINK_ETHERNET:
-            (void)ifname;
-            break;
-        case DATALINK_BIP:
-            (void)ifname;
-            break;
-        case DATALINK_BIP6:
-            (void)ifname;
-            break;
-        case DATALINK_MSTP:
-            (void)ifname;
-            break;
-        default:
-            break;
-    }
+    (void)ifname;
 }
 
 void datalink_maintenance_timer(uint16_t seconds)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            break;
-        case DATALINK_ETHERNET:
-            break;
-        case DATALINK_BIP:
-            bvlc_maintenance_timer(seconds);
-            break;
-        case DATALINK_BIP6:
-            bvlc6_maintenance_timer(seconds);
-            break;
-        case DATALINK_MSTP:
-            break;
-        default:
-            break;
+    if (Datalink_Driver && Datalink_Driver->maintenance_timer) {
+        Datalink_Driver->maintenance_timer(Datalink_Context, seconds);
     }
 }
 #endif
@@ -107,6 +107,9 @@ void routed_get_my_address(
 
 #elif defined(BACDL_ALL) || defined(BACDL_NONE) || defined(BACDL_CUSTOM)
 #include "bacnet/npdu.h"
+#if defined(BACDL_ALL)
+#include "bacnet/datalink/dlport.h"
+#endif
 
 #define MAX_HEADER (8)
 #define MAX_MPDU (MAX_HEADER+MAX_PDU)
@@ -155,6 +158,13 @@ extern "C" {
     BACNET_STACK_EXPORT
     void datalink_maintenance_timer(uint16_t seconds);
 
+#if defined(BACDL_ALL)
+    BACNET_STACK_EXPORT
+    void datalink_set_driver(
+        const BACNET_DATALINK_DRIVER *driver,
+        void *context);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
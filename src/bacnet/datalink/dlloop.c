@@ -0,0 +1,253 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Loopback datalink for unit tests and benchmarks
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/datalink/dlloop.h"
+
+/* the initialized loopback ports */
+static DLLOOP_PORT *Loopback_Ports;
+
+/**
+ * @brief Set the segment and MAC address of a loopback port
+ * @param port - loopback port
+ * @param segment - ports with the same segment are connected
+ * @param mac - MAC address of the port, 0..254
+ */
+void dlloop_port_setup(DLLOOP_PORT *port, uint16_t segment, uint8_t mac)
+{
+    if (port) {
+        memset(port, 0, sizeof(DLLOOP_PORT));
+        port->segment = segment;
+        port->mac = mac;
+        Ringbuf_Init(&port->queue, (volatile uint8_t *)port->packets,
+            sizeof(struct dlloop_packet), DLLOOP_QUEUE_COUNT);
+    }
+}
+
+/**
+ * @brief Connect a loopback port to its segment
+ * @param port - loopback port from dlloop_port_setup()
+ * @param ifname - not used
+ * @return true if the port was connected
+ */
+bool dlloop_init(DLLOOP_PORT *port, char *ifname)
+{
+    DLLOOP_PORT *p;
+
+    (void)ifname;
+    if (!port || (port->mac == DLLOOP_BROADCAST_ADDRESS)) {
+        return false;
+    }
+    for (p = Loopback_Ports; p; p = p->next) {
+        if (p == port) {
+            return true;
+        }
+    }
+    port->next = Loopback_Ports;
+    Loopback_Ports = port;
+
+    return true;
+}
+
+/**
+ * @brief Disconnect a loopback port from its segment
+ * @param port - loopback port
+ */
+void dlloop_cleanup(DLLOOP_PORT *port)
+{
+    DLLOOP_PORT **p;
+
+    for (p = &Loopback_Ports; *p; p = &(*p)->next) {
+        if (*p == port) {
+            *p = port->next;
+            port->next = NULL;
+            break;
+        }
+    }
+}
+
+static void dlloop_enqueue(
+    DLLOOP_PORT *port, uint8_t src, uint8_t *pdu, unsigned pdu_len)
+{
+    struct dlloop_packet *packet;
+
+    packet = (struct dlloop_packet *)Ringbuf_Data_Peek(&port->queue);
+    if (!packet) {
+        port->receive_pdu_dropped++;
+        return;
+    }
+    packet->src = src;
+    packet->pdu_len = (uint16_t)pdu_len;
+    memcpy(packet->pdu, pdu, pdu_len);
+    (void)Ringbuf_Data_Put(&port->queue, (volatile uint8_t *)packet);
+}
+
+/**
+ * @brief Send an NPDU to the other ports on the segment
+ * @param port - loopback port
+ * @param dest - destination address, broadcast when there is no MAC
+ *  or the MAC is 0xFF
+ * @param npdu_data - network information, not used
+ * @param pdu - encoded NPDU and APDU
+ * @param pdu_len - number of bytes in the pdu
+ * @return number of bytes sent, or -1 on failure
+ */
+int dlloop_send_pdu(DLLOOP_PORT *port,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    DLLOOP_PORT *p;
+    uint8_t mac = DLLOOP_BROADCAST_ADDRESS;
+
+    (void)npdu_data;
+    if (!port || !pdu || (pdu_len > MAX_PDU)) {
+        return -1;
+    }
+    if (dest && (dest->mac_len == 1)) {
+        mac = dest->mac[0];
+    }
+    for (p = Loopback_Ports; p; p = p->next) {
+        if ((p != port) && (p->segment == port->segment) &&
+            ((mac == DLLOOP_BROADCAST_ADDRESS) || (mac == p->mac))) {
+            dlloop_enqueue(p, port->mac, pdu, pdu_len);
+        }
+    }
+    port->transmit_pdu_counter++;
+
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Get the next NPDU sent to a port.  There is no waiting, since
+ *  the NPDUs are sent from the same thread.
+ * @param port - loopback port
+ * @param src - [out] source address
+ * @param pdu - [out] buffer for the NPDU
+ * @param max_pdu - size of the buffer
+ * @param timeout - not used
+ * @return number of bytes in the NPDU, or 0 if none
+ */
+uint16_t dlloop_receive(DLLOOP_PORT *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout)
+{
+    struct dlloop_packet *packet;
+    uint16_t pdu_len = 0;
+
+    (void)timeout;
+    if (!port) {
+        return 0;
+    }
+    packet = (struct dlloop_packet *)Ringbuf_Peek(&port->queue);
+    if (packet) {
+        if (packet->pdu_len <= max_pdu) {
+            pdu_len = packet->pdu_len;
+            memcpy(pdu, packet->pdu, pdu_len);
+            if (src) {
+                memset(src, 0, sizeof(BACNET_ADDRESS));
+                src->mac_len = 1;
+                src->mac[0] = packet->src;
+            }
+            port->receive_pdu_counter++;
+        } else {
+            port->receive_pdu_dropped++;
+        }
+        (void)Ringbuf_Pop(&port->queue, NULL);
+    }
+
+    return pdu_len;
+}
+
+/**
+ * @brief Get the broadcast address of a loopback segment
+ * @param port - loopback port, not used
+ * @param dest - [out] broadcast address
+ */
+void dlloop_get_broadcast_address(DLLOOP_PORT *port, BACNET_ADDRESS *dest)
+{
+    (void)port;
+    if (dest) {
+        memset(dest, 0, sizeof(BACNET_ADDRESS));
+        dest->mac_len = 1;
+        dest->mac[0] = DLLOOP_BROADCAST_ADDRESS;
+        dest->net = BACNET_BROADCAST_NETWORK;
+    }
+}
+
+/**
+ * @brief Get the address of a loopback port
+ * @param port - loopback port
+ * @param my_address - [out] address of the port
+ */
+void dlloop_get_my_address(DLLOOP_PORT *port, BACNET_ADDRESS *my_address)
+{
+    if (port && my_address) {
+        memset(my_address, 0, sizeof(BACNET_ADDRESS));
+        my_address->mac_len = 1;
+        my_address->mac[0] = port->mac;
+    }
+}
+
+static bool dlloop_driver_init(void *context, char *ifname)
+{
+    return dlloop_init(context, ifname);
+}
+
+static int dlloop_driver_send_pdu(void *context,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    return dlloop_send_pdu(context, dest, npdu_data, pdu, pdu_len);
+}
+
+static uint16_t dlloop_driver_receive(void *context,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout)
+{
+    return dlloop_receive(context, src, pdu, max_pdu, timeout);
+}
+
+static void dlloop_driver_cleanup(void *context)
+{
+    dlloop_cleanup(context);
+}
+
+static void dlloop_driver_get_broadcast_address(
+    void *context, BACNET_ADDRESS *dest)
+{
+    dlloop_get_broadcast_address(context, dest);
+}
+
+static void dlloop_driver_get_my_address(
+    void *context, BACNET_ADDRESS *my_address)
+{
+    dlloop_get_my_address(context, my_address);
+}
+
+/* the driver context is the DLLOOP_PORT */
+const BACNET_DATALINK_DRIVER Datalink_Loopback_Driver = { "loopback",
+    dlloop_driver_init, dlloop_driver_send_pdu, dlloop_driver_receive,
+    dlloop_driver_cleanup, dlloop_driver_get_broadcast_address,
+    dlloop_driver_get_my_address, NULL };
@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Loopback datalink for unit tests and benchmarks
+ *
+ * @section DESCRIPTION
+ *
+ * Loopback ports that share a segment number are connected to each other,
+ * as if they were on the same wire.  Each port has a one octet MAC address
+ * and a queue of received NPDUs.  Sending to MAC address 0xFF, or to an
+ * address without a MAC, is a broadcast to the other ports on the segment.
+ * The ports are used as datalink drivers through Datalink_Loopback_Driver,
+ * with the port as the driver context.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef DLLOOP_H
+#define DLLOOP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "bacnet/bacnet_stack_exports.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/datalink/dlport.h"
+
+/* received NPDUs queued per loopback port - must be a power of 2 */
+#ifndef DLLOOP_QUEUE_COUNT
+#define DLLOOP_QUEUE_COUNT 8
+#endif
+#define DLLOOP_BROADCAST_ADDRESS 0xFF
+
+struct dlloop_packet {
+    uint8_t src;
+    uint16_t pdu_len;
+    uint8_t pdu[MAX_PDU];
+};
+
+typedef struct dlloop_port {
+    uint16_t segment;
+    uint8_t mac;
+    RING_BUFFER queue;
+    struct dlloop_packet packets[DLLOOP_QUEUE_COUNT];
+    uint32_t transmit_pdu_counter;
+    uint32_t receive_pdu_counter;
+    uint32_t receive_pdu_dropped;
+    struct dlloop_port *next;
+} DLLOOP_PORT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+extern const BACNET_DATALINK_DRIVER Datalink_Loopback_Driver;
+
+BACNET_STACK_EXPORT
+void dlloop_port_setup(DLLOOP_PORT *port, uint16_t segment, uint8_t mac);
+
+BACNET_STACK_EXPORT
+bool dlloop_init(DLLOOP_PORT *port, char *ifname);
+BACNET_STACK_EXPORT
+void dlloop_cleanup(DLLOOP_PORT *port);
+BACNET_STACK_EXPORT
+int dlloop_send_pdu(DLLOOP_PORT *port,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len);
+BACNET_STACK_EXPORT
+uint16_t dlloop_receive(DLLOOP_PORT *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout);
+BACNET_STACK_EXPORT
+void dlloop_get_broadcast_address(DLLOOP_PORT *port, BACNET_ADDRESS *dest);
+BACNET_STACK_EXPORT
+void dlloop_get_my_address(DLLOOP_PORT *port, BACNET_ADDRESS *my_address);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -30,6 +30,7 @@
 #include "bacnet/bacnet_stack_exports.h"
 #include "bacnet/bacdef.h"
 #include "bacnet/npdu.h"
+#include "bacnet/basic/sys/priority_queue.h"
 
 /* defines specific to MS/TP */
 /* preamble+type+dest+src+len+crc8+crc16 */
@@ -156,6 +157,11 @@ extern "C" {
     bool dlmstp_send_pdu_queue_empty(void);
     BACNET_STACK_EXPORT
     bool dlmstp_send_pdu_queue_full(void);
+    /* Retrieve the depth, wait time, and counters of the PDU queue */
+    /* for one network message priority */
+    BACNET_STACK_EXPORT
+    bool dlmstp_send_pdu_queue_statistics(
+        unsigned priority, PRIORITY_QUEUE_STATISTICS * stats);
 
     BACNET_STACK_EXPORT
     uint8_t dlmstp_max_info_frames_limit(void);
@@ -0,0 +1,1088 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Datalink ports instantiated at runtime from datalink drivers,
+ *  with routing of NPDUs between the ports
+ *
+ * @section DESCRIPTION
+ *
+ * Each port has a datalink driver and driver context, a network number,
+ * and a queue of received NPDUs.  dlport_poll() moves received NPDUs from
+ * the drivers into the port queues, and dlport_route() forwards an NPDU
+ * from one port to the others as a BACnet router does (clause 6.5),
+ * returning the NPDUs that are for the application on the first port.
+ *
+ * When the datalink driver of a port is busy, which is when its send_pdu
+ * returns zero, the NPDU is queued for the port by its network message
+ * priority, and the queue is sent highest priority first from
+ * dlport_transmit() and dlport_poll(), so that life safety and critical
+ * equipment messages are not held up behind normal traffic.  When the
+ * queue of a port reaches DLPORT_TRANSMIT_HIGH, the network of the port
+ * is reported busy with Router-Busy-To-Network on the other ports, and
+ * NPDUs below DLPORT_TRANSMIT_BUSY_PRIORITY are dropped until the queue
+ * is down to DLPORT_TRANSMIT_LOW and Router-Available-To-Network is sent.
+ *
+ * The drivers of the BACnet/IP, BACnet/IPv6, MS/TP, Ethernet, and
+ * ARCNET datalinks wrap the existing datalink functions, which keep
+ * their state in file scope, so there is one port per driver for these.
+ * The loopback driver in dlloop.c has many instances.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/bacint.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/priority_queue.h"
+#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/datalink/dlport.h"
+#if defined(BACDL_BIP) || defined(BACDL_ALL)
+#include "bacnet/datalink/bip.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bacnet/basic/bbmd/h_bbmd.h"
+#endif
+#if defined(BACDL_BIP6) || defined(BACDL_ALL)
+#include "bacnet/datalink/bip6.h"
+#include "bacnet/datalink/bvlc6.h"
+#include "bacnet/basic/bbmd6/h_bbmd6.h"
+#endif
+#if defined(BACDL_MSTP) || defined(BACDL_ALL)
+#include "bacnet/datalink/dlmstp.h"
+#endif
+#if defined(BACDL_ETHERNET) || defined(BACDL_ALL)
+#include "bacnet/datalink/ethernet.h"
+#endif
+#if defined(BACDL_ARCNET) || defined(BACDL_ALL)
+#include "bacnet/datalink/arcnet.h"
+#endif
+
+/* Wrap the functions of a datalink that keeps its state in file scope
+   as a datalink driver, ignoring the driver context */
+#define DLPORT_SINGLETON_DRIVER(prefix)                                    \
+    static bool dlport_##prefix##_init(void *context, char *ifname)        \
+    {                                                                      \
+        (void)context;                                                     \
+        return prefix##_init(ifname);                                      \
+    }                                                                      \
+    static int dlport_##prefix##_send_pdu(void *context,                   \
+        BACNET_ADDRESS *dest, BACNET_NPDU_DATA *npdu_data, uint8_t *pdu,   \
+        unsigned pdu_len)                                                  \
+    {                                                                      \
+        (void)context;                                                     \
+        return prefix##_send_pdu(dest, npdu_data, pdu, pdu_len);           \
+    }                                                                      \
+    static uint16_t dlport_##prefix##_receive(void *context,               \
+        BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu,               \
+        unsigned timeout)                                                  \
+    {                                                                      \
+        (void)context;                                                     \
+        return prefix##_receive(src, pdu, max_pdu, timeout);               \
+    }                                                                      \
+    static void dlport_##prefix##_cleanup(void *context)                   \
+    {                                                                      \
+        (void)context;                                                     \
+        prefix##_cleanup();                                                \
+    }                                                                      \
+    static void dlport_##prefix##_get_broadcast_address(                   \
+        void *context, BACNET_ADDRESS *dest)                               \
+    {                                                                      \
+        (void)context;                                                     \
+        prefix##_get_broadcast_address(dest);                              \
+    }                                                                      \
+    static void dlport_##prefix##_get_my_address(                          \
+        void *context, BACNET_ADDRESS *my_address)                         \
+    {                                                                      \
+        (void)context;                                                     \
+        prefix##_get_my_address(my_address);                               \
+    }
+
+#if defined(BACDL_BIP) || defined(BACDL_ALL)
+DLPORT_SINGLETON_DRIVER(bip)
+static void dlport_bip_maintenance_timer(void *context, uint16_t seconds)
+{
+    (void)context;
+    bvlc_maintenance_timer(seconds);
+}
+const BACNET_DATALINK_DRIVER Datalink_BIP_Driver = { "bip", dlport_bip_init,
+    dlport_bip_send_pdu, dlport_bip_receive, dlport_bip_cleanup,
+    dlport_bip_get_broadcast_address, dlport_bip_get_my_address,
+    dlport_bip_maintenance_timer };
+#endif
+
+#if defined(BACDL_BIP6) || defined(BACDL_ALL)
+DLPORT_SINGLETON_DRIVER(bip6)
+static void dlport_bip6_maintenance_timer(void *context, uint16_t seconds)
+{
+    (void)context;
+    bvlc6_maintenance_timer(seconds);
+}
+const BACNET_DATALINK_DRIVER Datalink_BIP6_Driver = { "bip6",
+    dlport_bip6_init, dlport_bip6_send_pdu, dlport_bip6_receive,
+    dlport_bip6_cleanup, dlport_bip6_get_broadcast_address,
+    dlport_bip6_get_my_address, dlport_bip6_maintenance_timer };
+#endif
+
+#if defined(BACDL_MSTP) || defined(BACDL_ALL)
+DLPORT_SINGLETON_DRIVER(dlmstp)
+const BACNET_DATALINK_DRIVER Datalink_MSTP_Driver = { "mstp",
+    dlport_dlmstp_init, dlport_dlmstp_send_pdu, dlport_dlmstp_receive,
+    dlport_dlmstp_cleanup, dlport_dlmstp_get_broadcast_address,
+    dlport_dlmstp_get_my_address, NULL };
+#endif
+
+#if defined(BACDL_ETHERNET) || defined(BACDL_ALL)
+DLPORT_SINGLETON_DRIVER(ethernet)
+const BACNET_DATALINK_DRIVER Datalink_Ethernet_Driver = { "ethernet",
+    dlport_ethernet_init, dlport_ethernet_send_pdu, dlport_ethernet_receive,
+    dlport_ethernet_cleanup, dlport_ethernet_get_broadcast_address,
+    dlport_ethernet_get_my_address, NULL };
+#endif
+
+#if defined(BACDL_ARCNET) || defined(BACDL_ALL)
+DLPORT_SINGLETON_DRIVER(arcnet)
+const BACNET_DATALINK_DRIVER Datalink_ARCNET_Driver = { "arcnet",
+    dlport_arcnet_init, dlport_arcnet_send_pdu, dlport_arcnet_receive,
+    dlport_arcnet_cleanup, dlport_arcnet_get_broadcast_address,
+    dlport_arcnet_get_my_address, NULL };
+#endif
+
+struct dlport_packet {
+    BACNET_ADDRESS src;
+    uint16_t pdu_len;
+    uint8_t pdu[MAX_PDU];
+};
+
+struct dlport_transmit_packet {
+    PRIORITY_QUEUE_ELEMENT header;
+    BACNET_ADDRESS dest;
+    BACNET_NPDU_DATA npdu_data;
+    uint16_t pdu_len;
+    uint8_t pdu[MAX_PDU];
+};
+
+struct dlport {
+    const BACNET_DATALINK_DRIVER *driver;
+    void *context;
+    uint16_t net;
+    bool initialized;
+    /* reported busy to the other ports */
+    bool busy;
+    RING_BUFFER queue;
+    struct dlport_packet packets[DLPORT_QUEUE_COUNT];
+    PRIORITY_QUEUE transmit_queue;
+    struct dlport_transmit_packet
+        transmit_packets[PRIORITY_QUEUE_LEVELS * DLPORT_TRANSMIT_COUNT];
+    BACNET_DATALINK_PORT_STATISTICS stats;
+};
+
+static struct dlport Ports[DLPORT_MAX];
+static int Port_Count;
+/* next port to receive from, so one busy port doesn't starve the others */
+static int Port_Next;
+/* NPDU built when forwarding, which may grow by the SNET and SADR */
+static uint8_t Route_Buffer[MAX_PDU];
+
+/**
+ * @brief Find a datalink driver from its name
+ * @param name - name of the driver, for example "bip" or "mstp"
+ * @return the driver, or NULL if not found or not compiled in
+ */
+const BACNET_DATALINK_DRIVER *dlport_driver_by_name(const char *name)
+{
+    static const BACNET_DATALINK_DRIVER *const Drivers[] = {
+#if defined(BACDL_BIP) || defined(BACDL_ALL)
+        &Datalink_BIP_Driver,
+#endif
+#if defined(BACDL_BIP6) || defined(BACDL_ALL)
+        &Datalink_BIP6_Driver,
+#endif
+#if defined(BACDL_MSTP) || defined(BACDL_ALL)
+        &Datalink_MSTP_Driver,
+#endif
+#if defined(BACDL_ETHERNET) || defined(BACDL_ALL)
+        &Datalink_Ethernet_Driver,
+#endif
+#if defined(BACDL_ARCNET) || defined(BACDL_ALL)
+        &Datalink_ARCNET_Driver,
+#endif
+        &Datalink_Router_Driver
+    };
+    unsigned i;
+
+    if (!name) {
+        return NULL;
+    }
+    for (i = 0; i < sizeof(Drivers) / sizeof(Drivers[0]); i++) {
+        if (strcmp(Drivers[i]->name, name) == 0) {
+            return Drivers[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct dlport *dlport_get(int port)
+{
+    if ((port >= 0) && (port < Port_Count)) {
+        return &Ports[port];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a datalink port.  The application is on the network of the
+ *  first port that is added.
+ * @param driver - datalink driver of the port
+ * @param context - driver context of the port, or NULL for the drivers
+ *  that keep their state in file scope
+ * @param net - network number of the port, 1..65534
+ * @return port index, or -1 if the port could not be added
+ */
+int dlport_add(
+    const BACNET_DATALINK_DRIVER *driver, void *context, uint16_t net)
+{
+    struct dlport *port;
+    int i;
+
+    if (!driver || (driver == &Datalink_Router_Driver) || (net == 0) ||
+        (net == BACNET_BROADCAST_NETWORK) || (Port_Count >= DLPORT_MAX)) {
+        return -1;
+    }
+    for (i = 0; i < Port_Count; i++) {
+        if (Ports[i].net == net) {
+            return -1;
+        }
+    }
+    port = &Ports[Port_Count];
+    memset(port, 0, sizeof(struct dlport));
+    port->driver = driver;
+    port->context = context;
+    port->net = net;
+    Ringbuf_Init(&port->queue, (volatile uint8_t *)port->packets,
+        sizeof(struct dlport_packet), DLPORT_QUEUE_COUNT);
+    priority_queue_init(&port->transmit_queue, port->transmit_packets,
+        sizeof(struct dlport_transmit_packet), DLPORT_TRANSMIT_COUNT);
+    priority_queue_watermark_set(&port->transmit_queue, DLPORT_TRANSMIT_HIGH,
+        DLPORT_TRANSMIT_LOW, DLPORT_TRANSMIT_BUSY_PRIORITY);
+
+    return Port_Count++;
+}
+
+/**
+ * @brief Initialize the datalink of a port
+ * @param port - port index
+ * @param ifname - interface name given to the datalink driver
+ * @return true if the datalink was initialized
+ */
+bool dlport_init(int port, char *ifname)
+{
+    struct dlport *p = dlport_get(port);
+
+    if (!p) {
+        return false;
+    }
+    if (!p->initialized) {
+        p->initialized = p->driver->init(p->context, ifname);
+    }
+
+    return p->initialized;
+}
+
+/**
+ * @brief Clean up the datalinks of all ports, and remove the ports
+ */
+void dlport_cleanup(void)
+{
+    int i;
+
+    for (i = 0; i < Port_Count; i++) {
+        if (Ports[i].initialized && Ports[i].driver->cleanup) {
+            Ports[i].driver->cleanup(Ports[i].context);
+        }
+        Ports[i].initialized = false;
+    }
+    Port_Count = 0;
+    Port_Next = 0;
+}
+
+/**
+ * @brief Get the number of ports
+ * @return number of ports
+ */
+int dlport_count(void)
+{
+    return Port_Count;
+}
+
+/**
+ * @brief Get the network number of a port
+ * @param port - port index
+ * @return network number, or 0 if the port does not exist
+ */
+uint16_t dlport_network(int port)
+{
+    struct dlport *p = dlport_get(port);
+
+    if (p) {
+        return p->net;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Find the port that is directly connected to a network
+ * @param net - network number
+ * @return port index, or -1 if no port is connected to the network
+ */
+int dlport_find_network(uint16_t net)
+{
+    int i;
+
+    for (i = 0; i < Port_Count; i++) {
+        if (Ports[i].net == net) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static int dlport_forward(int port,
+    BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *payload,
+    uint16_t payload_len);
+
+/**
+ * @brief Report the network of a port as busy or available on the other
+ *  ports when the transmit queue of the port crosses a watermark
+ * @param port - port index
+ */
+static void dlport_congestion(int port)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NETWORK_MESSAGE_TYPE message_type;
+    struct dlport *p = &Ports[port];
+    uint8_t buffer[2];
+    int len;
+    int i;
+
+    if (priority_queue_congested(&p->transmit_queue) == p->busy) {
+        return;
+    }
+    p->busy = !p->busy;
+    if (p->busy) {
+        p->stats.busy_counter++;
+        message_type = NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK;
+    } else {
+        message_type = NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK;
+    }
+    len = encode_unsigned16(buffer, p->net);
+    for (i = 0; i < Port_Count; i++) {
+        if (i != port) {
+            npdu_encode_npdu_network(
+                &npdu_data, message_type, false, MESSAGE_PRIORITY_NORMAL);
+            (void)dlport_forward(i, &dest, NULL, &npdu_data, buffer, len);
+        }
+    }
+}
+
+/**
+ * @brief Send the NPDUs queued for a port while its datalink was busy,
+ *  highest message priority first, until the datalink is busy again
+ * @param p - port
+ * @return number of NPDUs sent
+ */
+static unsigned dlport_transmit_port(struct dlport *p)
+{
+    struct dlport_transmit_packet *packet;
+    unsigned count = 0;
+    int bytes;
+
+    while ((packet = priority_queue_peek(&p->transmit_queue, NULL))) {
+        bytes = p->driver->send_pdu(p->context, &packet->dest,
+            &packet->npdu_data, packet->pdu, packet->pdu_len);
+        if (bytes == 0) {
+            /* still busy */
+            break;
+        }
+        (void)priority_queue_pop(&p->transmit_queue, mstimer_now());
+        if (bytes > 0) {
+            p->stats.transmit_pdu_counter++;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Send the NPDUs that are queued for a port
+ * @param port - port index
+ * @return number of NPDUs sent
+ */
+unsigned dlport_transmit(int port)
+{
+    struct dlport *p = dlport_get(port);
+    unsigned count;
+
+    if (!p || !p->initialized) {
+        return 0;
+    }
+    count = dlport_transmit_port(p);
+    dlport_congestion(port);
+
+    return count;
+}
+
+/**
+ * @brief Determine if the network of a port is reported busy
+ * @param port - port index
+ * @return true from when the transmit queue of the port reached its high
+ *  watermark until it is back down to its low watermark
+ */
+bool dlport_busy(int port)
+{
+    struct dlport *p = dlport_get(port);
+
+    if (p) {
+        return p->busy;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Send an encoded NPDU on the datalink of a port.  The NPDU is
+ *  queued by its message priority when the datalink is busy, or when
+ *  NPDUs are already queued for the port.
+ * @param port - port index
+ * @param dest - datalink destination address
+ * @param npdu_data - network information
+ * @param pdu - encoded NPDU and APDU
+ * @param pdu_len - number of bytes in the pdu
+ * @return number of bytes sent or queued, or 0 or negative on failure
+ */
+int dlport_send_pdu(int port,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    struct dlport *p = dlport_get(port);
+    struct dlport_transmit_packet *packet;
+    unsigned priority = MESSAGE_PRIORITY_NORMAL;
+    int bytes = 0;
+
+    if (!p || !p->initialized) {
+        return 0;
+    }
+    if (priority_queue_empty(&p->transmit_queue)) {
+        bytes = p->driver->send_pdu(p->context, dest, npdu_data, pdu, pdu_len);
+        if (bytes > 0) {
+            p->stats.transmit_pdu_counter++;
+        }
+        if (bytes != 0) {
+            return bytes;
+        }
+    }
+    if (!pdu || (pdu_len > MAX_PDU)) {
+        return 0;
+    }
+    if (npdu_data) {
+        priority = npdu_data->priority;
+    }
+    packet = priority_queue_data_peek(&p->transmit_queue, priority);
+    if (packet) {
+        if (dest) {
+            memcpy(&packet->dest, dest, sizeof(BACNET_ADDRESS));
+        } else {
+            memset(&packet->dest, 0, sizeof(BACNET_ADDRESS));
+        }
+        if (npdu_data) {
+            memcpy(&packet->npdu_data, npdu_data, sizeof(BACNET_NPDU_DATA));
+        } else {
+            memset(&packet->npdu_data, 0, sizeof(BACNET_NPDU_DATA));
+        }
+        memcpy(packet->pdu, pdu, pdu_len);
+        packet->pdu_len = (uint16_t)pdu_len;
+        if (priority_queue_data_put(
+                &p->transmit_queue, priority, packet, mstimer_now())) {
+            bytes = (int)pdu_len;
+        }
+    }
+    /* a busy datalink may have become ready, and the new NPDU may have
+       a higher priority than the ones that were already queued */
+    (void)dlport_transmit_port(p);
+    dlport_congestion(port);
+
+    return bytes;
+}
+
+static bool dlport_poll_port(struct dlport *p, unsigned timeout)
+{
+    struct dlport_packet *packet;
+    uint16_t pdu_len;
+
+    packet = (struct dlport_packet *)Ringbuf_Data_Peek(&p->queue);
+    if (!packet) {
+        return false;
+    }
+    memset(&packet->src, 0, sizeof(BACNET_ADDRESS));
+    pdu_len = p->driver->receive(
+        p->context, &packet->src, packet->pdu, sizeof(packet->pdu), timeout);
+    if (pdu_len == 0) {
+        return false;
+    }
+    packet->pdu_len = pdu_len;
+    (void)Ringbuf_Data_Put(&p->queue, (volatile uint8_t *)packet);
+    p->stats.receive_pdu_counter++;
+
+    return true;
+}
+
+/**
+ * @brief Send the queued NPDUs of every port, and receive from the
+ *  datalink of every port into the port queues.
+ *  The datalinks are polled without waiting, and only when none of them
+ *  had anything does the last port wait for up to the timeout.
+ * @param timeout - number of milliseconds to wait for a packet
+ * @return number of NPDUs received
+ */
+unsigned dlport_poll(unsigned timeout)
+{
+    unsigned count = 0;
+    int i;
+
+    for (i = 0; i < Port_Count; i++) {
+        (void)dlport_transmit(i);
+    }
+    for (i = 0; i < Port_Count; i++) {
+        if (Ports[i].initialized && dlport_poll_port(&Ports[i], 0)) {
+            count++;
+        }
+    }
+    if ((count == 0) && (timeout > 0)) {
+        for (i = Port_Count - 1; i >= 0; i--) {
+            if (Ports[i].initialized) {
+                if (dlport_poll_port(&Ports[i], timeout)) {
+                    count++;
+                }
+                break;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the next queued NPDU from any port, taking turns between
+ *  the ports.  The datalinks are polled when all of the queues are empty.
+ * @param port - [out] port index the NPDU was received on
+ * @param src - [out] datalink source address
+ * @param pdu - [out] buffer for the NPDU
+ * @param max_pdu - size of the buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ * @return number of bytes in the NPDU, or 0 if none
+ */
+uint16_t dlport_receive(int *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout)
+{
+    struct dlport_packet *packet;
+    struct dlport *p;
+    uint16_t pdu_len;
+    int i, index;
+
+    if (Port_Count == 0) {
+        return 0;
+    }
+    for (i = 0; i < Port_Count; i++) {
+        if (!Ringbuf_Empty(&Ports[i].queue)) {
+            break;
+        }
+    }
+    if (i == Port_Count) {
+        (void)dlport_poll(timeout);
+    }
+    for (i = 0; i < Port_Count; i++) {
+        index = (Port_Next + i) % Port_Count;
+        p = &Ports[index];
+        packet = (struct dlport_packet *)Ringbuf_Peek(&p->queue);
+        if (!packet) {
+            continue;
+        }
+        Port_Next = (index + 1) % Port_Count;
+        pdu_len = packet->pdu_len;
+        if (pdu_len > max_pdu) {
+            p->stats.receive_pdu_dropped++;
+            pdu_len = 0;
+        } else {
+            memcpy(pdu, packet->pdu, pdu_len);
+            if (src) {
+                memcpy(src, &packet->src, sizeof(BACNET_ADDRESS));
+            }
+        }
+        (void)Ringbuf_Pop(&p->queue, NULL);
+        if (port) {
+            *port = index;
+        }
+        return pdu_len;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the datalink broadcast address of a port
+ * @param port - port index
+ * @param dest - [out] broadcast address
+ */
+void dlport_get_broadcast_address(int port, BACNET_ADDRESS *dest)
+{
+    struct dlport *p = dlport_get(port);
+
+    if (p && dest) {
+        p->driver->get_broadcast_address(p->context, dest);
+    }
+}
+
+/**
+ * @brief Get the datalink address of this device on a port
+ * @param port - port index
+ * @param my_address - [out] address of this device
+ */
+void dlport_get_my_address(int port, BACNET_ADDRESS *my_address)
+{
+    struct dlport *p = dlport_get(port);
+
+    if (p && my_address) {
+        p->driver->get_my_address(p->context, my_address);
+    }
+}
+
+/**
+ * @brief Run the maintenance timers of the datalinks of all ports
+ * @param seconds - number of seconds elapsed
+ */
+void dlport_maintenance_timer(uint16_t seconds)
+{
+    int i;
+
+    for (i = 0; i < Port_Count; i++) {
+        if (Ports[i].initialized && Ports[i].driver->maintenance_timer) {
+            Ports[i].driver->maintenance_timer(Ports[i].context, seconds);
+        }
+    }
+}
+
+/**
+ * @brief Get the statistics of a port
+ * @param port - port index
+ * @param stats - [out] statistics of the port
+ * @return true if the port exists
+ */
+bool dlport_statistics(int port, BACNET_DATALINK_PORT_STATISTICS *stats)
+{
+    struct dlport *p = dlport_get(port);
+
+    if (!p || !stats) {
+        return false;
+    }
+    memcpy(stats, &p->stats, sizeof(BACNET_DATALINK_PORT_STATISTICS));
+
+    return true;
+}
+
+/**
+ * @brief Get the transmit queue counters of a port for a message priority
+ * @param port - port index
+ * @param priority - BACNET_MESSAGE_PRIORITY
+ * @param stats - [out] queue depth, wait time, and counters
+ * @return true if the port and priority exist
+ */
+bool dlport_transmit_statistics(
+    int port, unsigned priority, PRIORITY_QUEUE_STATISTICS *stats)
+{
+    struct dlport *p = dlport_get(port);
+
+    if (!p) {
+        return false;
+    }
+
+    return priority_queue_statistics(&p->transmit_queue, priority, stats);
+}
+
+/**
+ * @brief Encode an NPDU with a new network header into a buffer
+ * @param pdu - [out] buffer for the NPDU
+ * @param max_pdu - size of the buffer
+ * @param dest - remote destination, which is only encoded as DNET for
+ *  a global broadcast since the NPDU is sent on the destination network
+ * @param src - remote source encoded as SNET and SADR, or NULL
+ * @param npdu_data - network information
+ * @param payload - network message or APDU following the network header
+ * @param payload_len - number of bytes in the payload
+ * @return number of bytes in the NPDU, or 0 if it doesn't fit
+ */
+static uint16_t dlport_npdu_encode(uint8_t *pdu,
+    uint16_t max_pdu,
+    BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *payload,
+    uint16_t payload_len)
+{
+    BACNET_ADDRESS global = { 0 };
+    uint8_t header[MAX_NPDU];
+    int len;
+
+    if (dest && (dest->net == BACNET_BROADCAST_NETWORK)) {
+        global.net = BACNET_BROADCAST_NETWORK;
+    }
+    len = npdu_encode_pdu(header, &global, src, npdu_data);
+    if ((len <= 0) || ((len + payload_len) > max_pdu)) {
+        return 0;
+    }
+    /* the payload may be in the same buffer, behind the old header */
+    memmove(&pdu[len], payload, payload_len);
+    memcpy(pdu, header, len);
+
+    return (uint16_t)(len + payload_len);
+}
+
+/**
+ * @brief Send an NPDU on a port to a remote destination on the network
+ *  of the port, which is a broadcast when DADR is absent
+ * @param port - port index
+ * @param dest - remote destination
+ * @param src - remote source encoded as SNET and SADR, or NULL
+ * @param npdu_data - network information
+ * @param payload - network message or APDU following the network header
+ * @param payload_len - number of bytes in the payload
+ * @return number of bytes sent, or 0 or negative on failure
+ */
+static int dlport_forward(int port,
+    BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *payload,
+    uint16_t payload_len)
+{
+    BACNET_ADDRESS link = { 0 };
+    uint16_t pdu_len;
+    int bytes = 0;
+
+    pdu_len = dlport_npdu_encode(Route_Buffer, sizeof(Route_Buffer), dest,
+        src, npdu_data, payload, payload_len);
+    if (pdu_len > 0) {
+        if ((dest->net == BACNET_BROADCAST_NETWORK) || (dest->len == 0)) {
+            dlport_get_broadcast_address(port, &link);
+        } else {
+            link.mac_len = dest->len;
+            memcpy(link.mac, dest->adr, dest->len);
+        }
+        bytes =
+            dlport_send_pdu(port, &link, npdu_data, Route_Buffer, pdu_len);
+    }
+    if (bytes > 0) {
+        Ports[port].stats.forward_pdu_counter++;
+    } else {
+        Ports[port].stats.forward_pdu_dropped++;
+    }
+
+    return bytes;
+}
+
+static bool dlport_my_address(int port, BACNET_ADDRESS *dest)
+{
+    BACNET_ADDRESS my_address = { 0 };
+
+    dlport_get_my_address(port, &my_address);
+    return (dest->len == my_address.mac_len) &&
+        (memcmp(dest->adr, my_address.mac, dest->len) == 0);
+}
+
+/**
+ * @brief Answer a Who-Is-Router-To-Network with the networks that are
+ *  reachable through the other ports
+ * @param port - port index the request was received on
+ * @param payload - the network message, after the message type
+ * @param payload_len - number of bytes in the network message
+ */
+static void dlport_who_is_router(int port, uint8_t *payload, int payload_len)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    uint8_t buffer[2 + (2 * DLPORT_MAX)];
+    uint16_t net = 0;
+    int len = 0;
+    int i;
+
+    if (payload_len >= 2) {
+        (void)decode_unsigned16(payload, &net);
+    }
+    for (i = 0; i < Port_Count; i++) {
+        if ((i != port) && ((net == 0) || (net == Ports[i].net))) {
+            len += encode_unsigned16(&buffer[len], Ports[i].net);
+        }
+    }
+    if (len > 0) {
+        npdu_encode_npdu_network(&npdu_data,
+            NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK, false,
+            MESSAGE_PRIORITY_NORMAL);
+        (void)dlport_forward(port, &dest, NULL, &npdu_data, buffer, len);
+    }
+}
+
+/**
+ * @brief Route an NPDU received on a port.  NPDUs for other networks
+ *  are forwarded to the ports of those networks, and global broadcasts
+ *  to all of the other ports.  NPDUs received on the other ports get
+ *  SNET and SADR added so that replies can be routed back.
+ * @param port - port index the NPDU was received on
+ * @param src - datalink source address of the NPDU
+ * @param pdu - [in,out] the NPDU, which is changed to the NPDU for the
+ *  application on the first port
+ * @param max_pdu - size of the pdu buffer
+ * @param pdu_len - number of bytes in the NPDU
+ * @return number of bytes in the NPDU for the application, or 0 if the
+ *  NPDU is not for the application
+ */
+uint16_t dlport_route(int port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    uint16_t pdu_len)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS npdu_dest = { 0 };
+    BACNET_ADDRESS npdu_src = { 0 };
+    bool deliver = false;
+    int offset;
+    int dest_port;
+    int i;
+
+    if (!dlport_get(port) || !src || !pdu) {
+        return 0;
+    }
+    offset = bacnet_npdu_decode(pdu, pdu_len, &npdu_dest, &npdu_src,
+        &npdu_data);
+    if ((offset <= 0) ||
+        (npdu_data.protocol_version != BACNET_PROTOCOL_VERSION)) {
+        return 0;
+    }
+    if (npdu_src.net == 0) {
+        /* from a device on the network of this port */
+        npdu_src.net = Ports[port].net;
+        npdu_src.len = src->mac_len;
+        memcpy(npdu_src.adr, src->mac, src->mac_len);
+    }
+    if (npdu_dest.net == 0) {
+        if (npdu_data.network_layer_message &&
+            (npdu_data.network_message_type ==
+                NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK)) {
+            dlport_who_is_router(port, &pdu[offset], pdu_len - offset);
+            return 0;
+        }
+        /* local to the network of the port */
+        return (port == 0) ? pdu_len : 0;
+    }
+    if (npdu_data.hop_count > 0) {
+        npdu_data.hop_count--;
+    }
+    if (npdu_dest.net == BACNET_BROADCAST_NETWORK) {
+        if (npdu_data.hop_count > 0) {
+            for (i = 0; i < Port_Count; i++) {
+                if (i != port) {
+                    (void)dlport_forward(i, &npdu_dest, &npdu_src, &npdu_data,
+                        &pdu[offset], pdu_len - offset);
+                }
+            }
+        }
+        deliver = true;
+    } else {
+        dest_port = dlport_find_network(npdu_dest.net);
+        if ((dest_port < 0) || (dest_port == port)) {
+            /* no route to the network, or a loop */
+            Ports[port].stats.forward_pdu_dropped++;
+            return 0;
+        }
+        if (dest_port == 0) {
+            if (npdu_dest.len == 0) {
+                deliver = true;
+            } else if (dlport_my_address(0, &npdu_dest)) {
+                return dlport_npdu_encode(pdu, max_pdu, NULL, &npdu_src,
+                    &npdu_data, &pdu[offset], pdu_len - offset);
+            }
+        }
+        if (npdu_data.hop_count > 0) {
+            (void)dlport_forward(dest_port, &npdu_dest, &npdu_src, &npdu_data,
+                &pdu[offset], pdu_len - offset);
+        }
+    }
+    if (!deliver) {
+        return 0;
+    }
+    if (port == 0) {
+        return pdu_len;
+    }
+    /* from another network, keeping DNET of a global broadcast */
+    return dlport_npdu_encode(pdu, max_pdu, &npdu_dest, &npdu_src,
+        &npdu_data, &pdu[offset], pdu_len - offset);
+}
+
+/**
+ * @brief Send an NPDU from the application on the first port, routing it
+ *  to the port of the destination network
+ * @param dest - destination address
+ * @param npdu_data - network information
+ * @param pdu - encoded NPDU and APDU
+ * @param pdu_len - number of bytes in the pdu
+ * @return number of bytes sent, or 0 or negative on failure
+ */
+int dlport_route_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    BACNET_NPDU_DATA data = { 0 };
+    BACNET_ADDRESS npdu_dest = { 0 };
+    BACNET_ADDRESS npdu_src = { 0 };
+    BACNET_ADDRESS my_address = { 0 };
+    int dest_port = 0;
+    int offset;
+    int bytes = 0;
+    int i;
+
+    if (!dest || (dest->net == 0) || (Port_Count == 0)) {
+        return dlport_send_pdu(0, dest, npdu_data, pdu, pdu_len);
+    }
+    if (dest->net != BACNET_BROADCAST_NETWORK) {
+        dest_port = dlport_find_network(dest->net);
+        if (dest_port < 0) {
+            /* unknown network: leave it to a router on our network */
+            return dlport_send_pdu(0, dest, npdu_data, pdu, pdu_len);
+        }
+    }
+    offset = bacnet_npdu_decode(pdu, pdu_len, &npdu_dest, NULL, &data);
+    if (offset <= 0) {
+        return 0;
+    }
+    dlport_get_my_address(0, &my_address);
+    npdu_src.net = Ports[0].net;
+    npdu_src.len = my_address.mac_len;
+    memcpy(npdu_src.adr, my_address.mac, my_address.mac_len);
+    for (i = 0; i < Port_Count; i++) {
+        if ((dest->net != BACNET_BROADCAST_NETWORK) && (i != dest_port)) {
+            continue;
+        }
+        if (i == 0) {
+            /* the network of the application has no SNET or DNET */
+            bytes = dlport_forward(0, &npdu_dest, NULL, &data, &pdu[offset],
+                pdu_len - offset);
+        } else {
+            bytes = dlport_forward(i, &npdu_dest, &npdu_src, &data,
+                &pdu[offset], pdu_len - offset);
+        }
+    }
+
+    return bytes;
+}
+
+static bool dlport_router_init(void *context, char *ifname)
+{
+    bool status = (Port_Count > 0);
+    int i;
+
+    (void)context;
+    for (i = 0; i < Port_Count; i++) {
+        if (!dlport_init(i, (i == 0) ? ifname : NULL)) {
+            status = false;
+        }
+    }
+
+    return status;
+}
+
+static int dlport_router_send_pdu(void *context,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)context;
+    return dlport_route_send_pdu(dest, npdu_data, pdu, pdu_len);
+}
+
+static uint16_t dlport_router_receive(void *context,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout)
+{
+    uint16_t pdu_len;
+    int port = 0;
+
+    (void)context;
+    pdu_len = dlport_receive(&port, src, pdu, max_pdu, timeout);
+    while (pdu_len > 0) {
+        pdu_len = dlport_route(port, src, pdu, max_pdu, pdu_len);
+        if (pdu_len > 0) {
+            break;
+        }
+        /* only NPDUs that are already queued, without waiting again */
+        pdu_len = dlport_receive(&port, src, pdu, max_pdu, 0);
+    }
+
+    return pdu_len;
+}
+
+static void dlport_router_cleanup(void *context)
+{
+    (void)context;
+    dlport_cleanup();
+}
+
+static void dlport_router_get_broadcast_address(
+    void *context, BACNET_ADDRESS *dest)
+{
+    (void)context;
+    dlport_get_broadcast_address(0, dest);
+}
+
+static void dlport_router_get_my_address(
+    void *context, BACNET_ADDRESS *my_address)
+{
+    (void)context;
+    dlport_get_my_address(0, my_address);
+}
+
+static void dlport_router_maintenance_timer(void *context, uint16_t seconds)
+{
+    (void)context;
+    dlport_maintenance_timer(seconds);
+}
+
+/* the application on the first port, routed to the other ports */
+const BACNET_DATALINK_DRIVER Datalink_Router_Driver = { "router",
+    dlport_router_init, dlport_router_send_pdu, dlport_router_receive,
+    dlport_router_cleanup, dlport_router_get_broadcast_address,
+    dlport_router_get_my_address, dlport_router_maintenance_timer };
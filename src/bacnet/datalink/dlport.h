@@ -0,0 +1,181 @@
+/**
+ * @file
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @brief Datalink driver interface, and datalink ports that route
+ *  between each other
+ *
+ * @section DESCRIPTION
+ *
+ * A datalink driver is a table of functions that operate on a driver
+ * specific context.  Datalink ports are instantiated at runtime from
+ * drivers, each with its own network number and receive queue, so that
+ * B/IP, B/IPv6, MS/TP, Ethernet, and loopback ports can be used at the
+ * same time.  The ports route NPDUs between their networks, and the
+ * application sits on the network of the first port.  The router is
+ * also available as a datalink driver, so the application keeps using
+ * the datalink_* functions when datalink_set_driver() is used.
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef DLPORT_H
+#define DLPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "bacnet/bacnet_stack_exports.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/sys/priority_queue.h"
+
+/* maximum number of datalink ports */
+#ifndef DLPORT_MAX
+#define DLPORT_MAX 4
+#endif
+/* received NPDUs queued per port - must be a power of 2 */
+#ifndef DLPORT_QUEUE_COUNT
+#define DLPORT_QUEUE_COUNT 8
+#endif
+/* NPDUs queued per port and message priority while the datalink is
+   busy - must be a power of 2 */
+#ifndef DLPORT_TRANSMIT_COUNT
+#define DLPORT_TRANSMIT_COUNT 4
+#endif
+/* NPDUs queued for a port when the network of the port is reported busy
+   with Router-Busy-To-Network, and when it is reported available again
+   with Router-Available-To-Network */
+#ifndef DLPORT_TRANSMIT_HIGH
+#define DLPORT_TRANSMIT_HIGH DLPORT_TRANSMIT_COUNT
+#endif
+#ifndef DLPORT_TRANSMIT_LOW
+#define DLPORT_TRANSMIT_LOW (DLPORT_TRANSMIT_COUNT / 2)
+#endif
+/* lowest message priority that is still queued while the port is busy */
+#ifndef DLPORT_TRANSMIT_BUSY_PRIORITY
+#define DLPORT_TRANSMIT_BUSY_PRIORITY MESSAGE_PRIORITY_URGENT
+#endif
+
+typedef struct bacnet_datalink_driver {
+    const char *name;
+    bool (*init)(void *context, char *ifname);
+    int (*send_pdu)(void *context,
+        BACNET_ADDRESS *dest,
+        BACNET_NPDU_DATA *npdu_data,
+        uint8_t *pdu,
+        unsigned pdu_len);
+    uint16_t (*receive)(void *context,
+        BACNET_ADDRESS *src,
+        uint8_t *pdu,
+        uint16_t max_pdu,
+        unsigned timeout);
+    void (*cleanup)(void *context);
+    void (*get_broadcast_address)(void *context, BACNET_ADDRESS *dest);
+    void (*get_my_address)(void *context, BACNET_ADDRESS *my_address);
+    void (*maintenance_timer)(void *context, uint16_t seconds);
+} BACNET_DATALINK_DRIVER;
+
+typedef struct bacnet_datalink_port_statistics {
+    uint32_t receive_pdu_counter;
+    uint32_t receive_pdu_dropped;
+    uint32_t transmit_pdu_counter;
+    uint32_t forward_pdu_counter;
+    uint32_t forward_pdu_dropped;
+    /* times the network of the port was reported busy */
+    uint32_t busy_counter;
+} BACNET_DATALINK_PORT_STATISTICS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* drivers of the datalinks that are compiled in */
+#if defined(BACDL_BIP) || defined(BACDL_ALL)
+BACNET_STACK_EXPORT
+extern const BACNET_DATALINK_DRIVER Datalink_BIP_Driver;
+#endif
+#if defined(BACDL_BIP6) || defined(BACDL_ALL)
+BACNET_STACK_EXPORT
+extern const BACNET_DATALINK_DRIVER Datalink_BIP6_Driver;
+#endif
+#if defined(BACDL_MSTP) || defined(BACDL_ALL)
+BACNET_STACK_EXPORT
+extern const BACNET_DATALINK_DRIVER Datalink_MSTP_Driver;
+#endif
+#if defined(BACDL_ETHERNET) || defined(BACDL_ALL)
+BACNET_STACK_EXPORT
+extern const BACNET_DATALINK_DRIVER Datalink_Ethernet_Driver;
+#endif
+#if defined(BACDL_ARCNET) || defined(BACDL_ALL)
+BACNET_STACK_EXPORT
+extern const BACNET_DATALINK_DRIVER Datalink_ARCNET_Driver;
+#endif
+BACNET_STACK_EXPORT
+extern const BACNET_DATALINK_DRIVER Datalink_Router_Driver;
+
+BACNET_STACK_EXPORT
+const BACNET_DATALINK_DRIVER *dlport_driver_by_name(const char *name);
+
+BACNET_STACK_EXPORT
+int dlport_add(
+    const BACNET_DATALINK_DRIVER *driver, void *context, uint16_t net);
+BACNET_STACK_EXPORT
+bool dlport_init(int port, char *ifname);
+BACNET_STACK_EXPORT
+void dlport_cleanup(void);
+BACNET_STACK_EXPORT
+int dlport_count(void);
+BACNET_STACK_EXPORT
+uint16_t dlport_network(int port);
+BACNET_STACK_EXPORT
+int dlport_find_network(uint16_t net);
+
+BACNET_STACK_EXPORT
+int dlport_send_pdu(int port,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len);
+BACNET_STACK_EXPORT
+unsigned dlport_poll(unsigned timeout);
+BACNET_STACK_EXPORT
+uint16_t dlport_receive(int *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout);
+BACNET_STACK_EXPORT
+void dlport_get_broadcast_address(int port, BACNET_ADDRESS *dest);
+BACNET_STACK_EXPORT
+void dlport_get_my_address(int port, BACNET_ADDRESS *my_address);
+BACNET_STACK_EXPORT
+void dlport_maintenance_timer(uint16_t seconds);
+BACNET_STACK_EXPORT
+bool dlport_statistics(int port, BACNET_DATALINK_PORT_STATISTICS *stats);
+BACNET_STACK_EXPORT
+unsigned dlport_transmit(int port);
+BACNET_STACK_EXPORT
+bool dlport_busy(int port);
+BACNET_STACK_EXPORT
+bool dlport_transmit_statistics(
+    int port, unsigned priority, PRIORITY_QUEUE_STATISTICS *stats);
+
+BACNET_STACK_EXPORT
+uint16_t dlport_route(int port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    uint16_t pdu_len);
+BACNET_STACK_EXPORT
+int dlport_route_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
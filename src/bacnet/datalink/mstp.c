@@ -738,6 +738,7 @@ bool MSTP_Master_Node_FSM(volatile struct mstp_port_struct_t *mstp_port)
                             /* SendNoWait */
                             mstp_port->master_state =
                                 MSTP_MASTER_STATE_DONE_WITH_TOKEN;
+                            transition_now = true;
                         } else {
                             /* SendAndWait */
                             mstp_port->master_state =
@@ -753,8 +754,12 @@ bool MSTP_Master_Node_FSM(volatile struct mstp_port_struct_t *mstp_port)
                     case FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY:
                     default:
                         /* SendNoWait */
+                        /* continue with the next queued frame, up to
+                           Nmax_info_frames, without waiting for another
+                           call of the state machine */
                         mstp_port->master_state =
                             MSTP_MASTER_STATE_DONE_WITH_TOKEN;
+                        transition_now = true;
                         break;
                 }
             }
@@ -56,6 +56,17 @@
   time or date may be interpreted as "any" or "don't care"
 */
 
+/* days before the first of each month in a common year, 1=Jan */
+static const uint16_t Days_Before_Month[13] = { 0, 0, 31, 59, 90, 120, 151,
+    181, 212, 243, 273, 304, 334 };
+
+/* Days from 0000-03-01 in the proleptic Gregorian calendar to the
+   BACnet epoch of 1900-01-01. Counting from March puts the leap day at
+   the end of each computational year. */
+#define DAYS_MARCH_ZERO_TO_EPOCH 693901UL
+/* days in a 400 year era of the Gregorian calendar */
+#define DAYS_PER_ERA 146097UL
+
 /**
  * Determines if a given date is valid
  *
@@ -106,13 +117,12 @@ bool datetime_date_is_valid(BACNET_DATE *bdate)
 uint32_t datetime_ymd_day_of_year(uint16_t year, uint8_t month, uint8_t day)
 {
     uint32_t days = 0; /* return value */
-    uint8_t months = 0; /* loop counter for months */
 
     if (datetime_ymd_is_valid(year, month, day)) {
-        for (months = 1; months < month; months++) {
-            days += days_per_month(year, months);
+        days = Days_Before_Month[month] + day;
+        if ((month > 2) && days_is_leap_year(year)) {
+            days++;
         }
-        days += day;
     }
 
     return (days);
@@ -164,18 +174,20 @@ uint32_t datetime_ymd_to_days_since_epoch(
     uint16_t year, uint8_t month, uint8_t day)
 {
     uint32_t days = 0; /* return value */
-    uint16_t years = 0; /* loop counter for years */
+    uint32_t years, era, year_of_era, day_of_year;
 
     if (datetime_ymd_is_valid(year, month, day)) {
-        for (years = BACNET_DATE_YEAR_EPOCH; years < year; years++) {
-            days += 365;
-            if (days_is_leap_year(years)) {
-                days++;
-            }
-        }
-        days += datetime_ymd_day_of_year(year, month, day);
-        /* 'days since' is one less */
-        days -= 1;
+        /* closed form: years start in March, so Jan and Feb
+           belong to the previous year */
+        years = (month > 2) ? year : year - 1U;
+        era = years / 400;
+        year_of_era = years - (era * 400);
+        day_of_year =
+            ((153U * ((month > 2) ? month - 3U : month + 9U)) + 2U) / 5U +
+            day - 1U;
+        days = (era * DAYS_PER_ERA) + (year_of_era * 365U) +
+            (year_of_era / 4U) - (year_of_era / 100U) + day_of_year -
+            DAYS_MARCH_ZERO_TO_EPOCH;
     }
 
     return (days);
@@ -210,36 +222,27 @@ uint32_t datetime_days_since_epoch(BACNET_DATE *bdate)
 void datetime_ymd_from_days_since_epoch(
     uint32_t days, uint16_t *pYear, uint8_t *pMonth, uint8_t *pDay)
 {
-    uint16_t year = BACNET_DATE_YEAR_EPOCH;
-    uint8_t month = 1;
-    uint8_t day = 1;
-
-    while (days >= 365) {
-        if ((days_is_leap_year(year)) && (days == 365)) {
-            break;
-        }
-        days -= 365;
-        if (days_is_leap_year(year)) {
-            --days;
-        }
-        year++;
-    }
-
-    while (days >= (uint32_t)days_per_month(year, month)) {
-        days -= days_per_month(year, month);
-        month++;
-    }
-
-    day = (uint8_t)(day + days);
-
-    if (pYear) {
-        *pYear = year;
+    uint32_t era, day_of_era, year_of_era, day_of_year, month;
+
+    /* closed form: count from 0000-03-01 so the leap day is last */
+    days += DAYS_MARCH_ZERO_TO_EPOCH;
+    era = days / DAYS_PER_ERA;
+    day_of_era = days - (era * DAYS_PER_ERA);
+    year_of_era = (day_of_era - (day_of_era / 1460U) +
+                      (day_of_era / 36524U) - (day_of_era / 146096U)) /
+        365U;
+    day_of_year = day_of_era -
+        ((365U * year_of_era) + (year_of_era / 4U) - (year_of_era / 100U));
+    /* month where 0=Mar...11=Feb */
+    month = ((5U * day_of_year) + 2U) / 153U;
+    if (pDay) {
+        *pDay = (uint8_t)(day_of_year - (((153U * month) + 2U) / 5U) + 1U);
     }
     if (pMonth) {
-        *pMonth = month;
+        *pMonth = (uint8_t)((month < 10U) ? month + 3U : month - 9U);
     }
-    if (pDay) {
-        *pDay = day;
+    if (pYear) {
+        *pYear = (uint16_t)((era * 400U) + year_of_era + (month >= 10U));
     }
 
     return;
@@ -258,7 +261,12 @@ void datetime_days_since_epoch_into_date(uint32_t days, BACNET_DATE *bdate)
     uint8_t day = 0;
 
     datetime_ymd_from_days_since_epoch(days, &year, &month, &day);
-    datetime_set_date(bdate, year, month, day);
+    if (bdate) {
+        bdate->year = year;
+        bdate->month = month;
+        bdate->day = day;
+        bdate->wday = (uint8_t)(BACNET_DAY_OF_WEEK_EPOCH + (days % 7));
+    }
 }
 
 /**
@@ -735,6 +743,98 @@ bacnet_time_t datetime_seconds_since_epoch_max(void)
 #endif
 }
 
+/**
+ * @brief Converts an array of seconds since epoch into date and time.
+ *  Log records are mostly in time order, so the date of consecutive
+ *  values within the same day is converted only once.
+ * @param bdatetime [out] array of count date and time values
+ * @param seconds [in] array of count seconds since epoch
+ * @param count - number of values to convert
+ */
+void datetime_since_epoch_seconds_array(
+    BACNET_DATE_TIME *bdatetime, const bacnet_time_t *seconds, unsigned count)
+{
+    const uint32_t day_seconds = 24UL * 60UL * 60UL;
+    uint32_t days = 0;
+    uint32_t last_days = 0;
+    uint32_t day_second = 0;
+    unsigned i;
+
+    if (!bdatetime || !seconds) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        days = (uint32_t)(seconds[i] / day_seconds);
+        day_second = (uint32_t)(seconds[i] % day_seconds);
+        bdatetime[i].time.hour = (uint8_t)(day_second / 3600UL);
+        bdatetime[i].time.min = (uint8_t)((day_second / 60UL) % 60UL);
+        bdatetime[i].time.sec = (uint8_t)(day_second % 60UL);
+        bdatetime[i].time.hundredths = 0;
+        if ((i > 0) && (days == last_days)) {
+            bdatetime[i].date = bdatetime[i - 1].date;
+        } else {
+            datetime_days_since_epoch_into_date(days, &bdatetime[i].date);
+        }
+        last_days = days;
+    }
+}
+
+#ifdef UINT64_MAX
+/**
+ * @brief Packs a date and time into a 64-bit timestamp, where each field
+ *  has its own octets from year down to hundredths so that the packed
+ *  values order the same as datetime_compare(). The day of week is not
+ *  packed since it follows from the date.
+ * @param bdatetime [in] the date and time to pack
+ * @return packed date and time, or 0 if bdatetime is NULL
+ */
+bacnet_datetime_packed_t datetime_pack(BACNET_DATE_TIME *bdatetime)
+{
+    bacnet_datetime_packed_t packed = 0;
+
+    if (bdatetime) {
+        packed = ((bacnet_datetime_packed_t)bdatetime->date.year << 48) |
+            ((bacnet_datetime_packed_t)bdatetime->date.month << 40) |
+            ((bacnet_datetime_packed_t)bdatetime->date.day << 32) |
+            ((bacnet_datetime_packed_t)bdatetime->time.hour << 24) |
+            ((bacnet_datetime_packed_t)bdatetime->time.min << 16) |
+            ((bacnet_datetime_packed_t)bdatetime->time.sec << 8) |
+            (bacnet_datetime_packed_t)bdatetime->time.hundredths;
+    }
+
+    return packed;
+}
+
+/**
+ * @brief Unpacks a 64-bit timestamp into a date and time
+ * @param bdatetime [out] the unpacked date and time
+ * @param packed - date and time from datetime_pack()
+ */
+void datetime_unpack(
+    BACNET_DATE_TIME *bdatetime, bacnet_datetime_packed_t packed)
+{
+    if (bdatetime) {
+        datetime_set_date(&bdatetime->date, (uint16_t)(packed >> 48),
+            (uint8_t)(packed >> 40), (uint8_t)(packed >> 32));
+        datetime_set_time(&bdatetime->time, (uint8_t)(packed >> 24),
+            (uint8_t)(packed >> 16), (uint8_t)(packed >> 8), (uint8_t)packed);
+    }
+}
+
+/**
+ * @brief Compares two packed timestamps
+ * @param packed1 - date and time from datetime_pack()
+ * @param packed2 - date and time from datetime_pack()
+ * @return -1 if packed1 is before packed2, 0 if the same, or
+ *  1 if packed1 is after packed2
+ */
+int datetime_packed_compare(
+    bacnet_datetime_packed_t packed1, bacnet_datetime_packed_t packed2)
+{
+    return (packed1 > packed2) - (packed1 < packed2);
+}
+#endif
+
 /* Returns true if year is a wildcard */
 bool datetime_wildcard_year(BACNET_DATE *bdate)
 {
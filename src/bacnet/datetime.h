@@ -84,6 +84,12 @@ typedef uint64_t bacnet_time_t;
 typedef uint32_t bacnet_time_t;
 #endif
 
+#ifdef UINT64_MAX
+/* date and time packed into octets from year down to hundredths,
+   so that packed values compare as integers */
+typedef uint64_t bacnet_datetime_packed_t;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -201,6 +207,20 @@ void datetime_since_epoch_seconds(
     BACNET_DATE_TIME *bdatetime, bacnet_time_t seconds);
 BACNET_STACK_EXPORT
 bacnet_time_t datetime_seconds_since_epoch_max(void);
+BACNET_STACK_EXPORT
+void datetime_since_epoch_seconds_array(
+    BACNET_DATE_TIME *bdatetime, const bacnet_time_t *seconds, unsigned count);
+
+#ifdef UINT64_MAX
+BACNET_STACK_EXPORT
+bacnet_datetime_packed_t datetime_pack(BACNET_DATE_TIME *bdatetime);
+BACNET_STACK_EXPORT
+void datetime_unpack(
+    BACNET_DATE_TIME *bdatetime, bacnet_datetime_packed_t packed);
+BACNET_STACK_EXPORT
+int datetime_packed_compare(
+    bacnet_datetime_packed_t packed1, bacnet_datetime_packed_t packed2);
+#endif
 
 /* date and time wildcards */
 BACNET_STACK_EXPORT
@@ -0,0 +1,81 @@
+/**
+ * @file
+ * @brief DeleteObject service encode and decode
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacenum.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/delete_object.h"
+
+/**
+ * @brief Encode the DeleteObject service request only
+ *
+ *  DeleteObject-Request ::= SEQUENCE {
+ *      object-identifier BACnetObjectIdentifier
+ *  }
+ *
+ * @param apdu  Pointer to the buffer for encoding, or NULL for the length
+ * @param data  Pointer to the service data to be encoded.
+ * @return Bytes encoded or zero on error.
+ */
+int delete_object_encode_service_request(
+    uint8_t *apdu, BACNET_DELETE_OBJECT_DATA *data)
+{
+    if (!data) {
+        return 0;
+    }
+
+    return encode_application_object_id(
+        apdu, data->object_type, data->object_instance);
+}
+
+/**
+ * @brief Decode the DeleteObject service request only
+ * @param apdu  Pointer to the buffer for decoding.
+ * @param apdu_size  Count of valid bytes in the buffer.
+ * @param data  Pointer to the service data to be stored, or NULL
+ * @return Bytes decoded or BACNET_STATUS_REJECT on error.
+ */
+int delete_object_decode_service_request(
+    uint8_t *apdu, unsigned apdu_size, BACNET_DELETE_OBJECT_DATA *data)
+{
+    int len = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+
+    if (!apdu || (apdu_size == 0)) {
+        if (data) {
+            data->error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
+        }
+        return BACNET_STATUS_REJECT;
+    }
+    len = bacnet_object_id_application_decode(
+        apdu, apdu_size, &object_type, &object_instance);
+    if (len <= 0) {
+        if (data) {
+            data->error_code = ERROR_CODE_REJECT_INVALID_TAG;
+        }
+        return BACNET_STATUS_REJECT;
+    }
+    if ((unsigned)len < apdu_size) {
+        if (data) {
+            data->error_code = ERROR_CODE_REJECT_TOO_MANY_ARGUMENTS;
+        }
+        return BACNET_STATUS_REJECT;
+    }
+    if (data) {
+        data->object_type = object_type;
+        data->object_instance = object_instance;
+    }
+
+    return len;
+}
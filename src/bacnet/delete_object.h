@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief API for DeleteObject service codec
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ * @section LICENSE
+ *
+ * Copyright (C) 2023 Steve Karg <skarg@users.sourceforge.net>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_DELETE_OBJECT_H
+#define BACNET_DELETE_OBJECT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacnet_stack_exports.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacdef.h"
+
+/**
+ *  DeleteObject-Request ::= SEQUENCE {
+ *      object-identifier BACnetObjectIdentifier
+ *  }
+ */
+
+typedef struct BACnet_Delete_Object_Data {
+    /* note: number type first to avoid enum cast warning on = { 0 } */
+    uint32_t object_instance;
+    BACNET_OBJECT_TYPE object_type;
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+} BACNET_DELETE_OBJECT_DATA;
+
+/**
+ * @brief Delete an object of this type
+ * @ingroup ObjHelpers
+ * @param object_instance [in] instance number of the object
+ * @return true if the object was deleted
+ */
+typedef bool (*delete_object_function)(uint32_t object_instance);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+int delete_object_encode_service_request(
+    uint8_t *apdu, BACNET_DELETE_OBJECT_DATA *data);
+BACNET_STACK_EXPORT
+int delete_object_decode_service_request(
+    uint8_t *apdu, unsigned apdu_size, BACNET_DELETE_OBJECT_DATA *data);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif
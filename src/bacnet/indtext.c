@@ -59,6 +59,28 @@ int stricmp(const char *s1, const char *s2)
 #define stricmp _stricmp
 #endif
 
+/* claims an unsorted index for sorting, and orders the sorted positions
+   against the state that publishes them */
+#if defined(__GNUC__)
+#define INDTEXT_CLAIM(state) \
+    __sync_bool_compare_and_swap( \
+        (state), INDTEXT_INDEX_UNSORTED, INDTEXT_INDEX_SORTING)
+#define INDTEXT_BARRIER() __sync_synchronize()
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define INDTEXT_CLAIM(state) \
+    (_InterlockedCompareExchange((state), INDTEXT_INDEX_SORTING, \
+         INDTEXT_INDEX_UNSORTED) == INDTEXT_INDEX_UNSORTED)
+#define INDTEXT_BARRIER() _ReadWriteBarrier()
+#else
+/* single threaded, or the index is sorted ahead of time */
+#define INDTEXT_CLAIM(state) \
+    ((*(state) == INDTEXT_INDEX_UNSORTED) \
+            ? ((*(state) = INDTEXT_INDEX_SORTING), true) \
+            : false)
+#define INDTEXT_BARRIER()
+#endif
+
 bool indtext_by_string(
     INDTEXT_DATA *data_list, const char *search_name, unsigned *found_index)
 {
@@ -181,3 +203,191 @@ unsigned indtext_count(INDTEXT_DATA *data_list)
     }
     return count;
 }
+
+/** Compare two entries of a list by their case insensitive text, and
+ *  by their position when the text is the same, so that a search finds
+ *  the first of them like the linear search does.
+ */
+static int indtext_compare_string(
+    INDTEXT_DATA *data_list, uint16_t a, uint16_t b)
+{
+    int result;
+
+    result = stricmp(data_list[a].pString, data_list[b].pString);
+    if (result == 0) {
+        result = (int)a - (int)b;
+    }
+
+    return result;
+}
+
+/** Compare two entries of a list by their index, and by their position
+ *  when the index is the same.
+ */
+static int indtext_compare_index(
+    INDTEXT_DATA *data_list, uint16_t a, uint16_t b)
+{
+    if (data_list[a].index < data_list[b].index) {
+        return -1;
+    } else if (data_list[a].index > data_list[b].index) {
+        return 1;
+    }
+
+    return (int)a - (int)b;
+}
+
+/** Shell sort of the positions of a list, which needs no recursion
+ *  or heap.
+ */
+static void indtext_sort(INDTEXT_DATA *data_list,
+    uint16_t *position,
+    unsigned count,
+    int (*compare)(INDTEXT_DATA *, uint16_t, uint16_t))
+{
+    unsigned gap, i, j;
+    uint16_t value;
+
+    for (gap = count / 2; gap > 0; gap /= 2) {
+        for (i = gap; i < count; i++) {
+            value = position[i];
+            for (j = i; (j >= gap) &&
+                 (compare(data_list, position[j - gap], value) > 0);
+                 j -= gap) {
+                position[j] = position[j - gap];
+            }
+            position[j] = value;
+        }
+    }
+}
+
+/**
+ * @brief Sort the index of a list, so that lookups are a binary search.
+ *  This is done on first use, or may be done ahead of time.  Only the
+ *  thread that claims the index sorts it, and the positions are only
+ *  used by other threads after it is published as sorted.
+ * @param index - index of the list
+ * @return true if the index is sorted, false if the list does not fit,
+ *  or if another thread is sorting it
+ */
+bool indtext_index_sort(INDTEXT_INDEX *index)
+{
+    unsigned count, i;
+
+    if (!index) {
+        return false;
+    }
+    if (index->state == INDTEXT_INDEX_SORTED) {
+        /* the positions are read after the state */
+        INDTEXT_BARRIER();
+        return true;
+    }
+    if (!INDTEXT_CLAIM(&index->state)) {
+        if (index->state == INDTEXT_INDEX_SORTED) {
+            INDTEXT_BARRIER();
+            return true;
+        }
+        return false;
+    }
+    count = indtext_count(index->data_list);
+    if ((count > index->size) || (count > UINT16_MAX) ||
+        !index->by_string || !index->by_index) {
+        index->state = INDTEXT_INDEX_FAILED;
+        return false;
+    }
+    for (i = 0; i < count; i++) {
+        index->by_string[i] = (uint16_t)i;
+        index->by_index[i] = (uint16_t)i;
+    }
+    indtext_sort(
+        index->data_list, index->by_string, count, indtext_compare_string);
+    indtext_sort(
+        index->data_list, index->by_index, count, indtext_compare_index);
+    index->count = count;
+    /* the positions are written before the state that publishes them */
+    INDTEXT_BARRIER();
+    index->state = INDTEXT_INDEX_SORTED;
+
+    return true;
+}
+
+/**
+ * @brief Search for a case insensitive text with the index of a list.
+ *  Falls back to the linear search if the index could not be sorted.
+ * @param index - index of the list
+ * @param search_name - text to search for
+ * @param found_index - the index of the first entry with the text
+ * @return true if the text was found
+ */
+bool indtext_index_by_istring(
+    INDTEXT_INDEX *index, const char *search_name, unsigned *found_index)
+{
+    INDTEXT_DATA *data_list;
+    unsigned low = 0, high, middle;
+
+    if (!index || !search_name) {
+        return false;
+    }
+    if (!indtext_index_sort(index)) {
+        return indtext_by_istring(index->data_list, search_name, found_index);
+    }
+    data_list = index->data_list;
+    high = index->count;
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (stricmp(data_list[index->by_string[middle]].pString,
+                search_name) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if ((low < index->count) &&
+        (stricmp(data_list[index->by_string[low]].pString, search_name) ==
+            0)) {
+        if (found_index) {
+            *found_index = data_list[index->by_string[low]].index;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Find the text of an index with the index of a list.
+ *  Falls back to the linear search if the index could not be sorted.
+ * @param index - index of the list
+ * @param value - index number to search for
+ * @param default_name - text returned when the index number is not found
+ * @return the text of the first entry with the index number
+ */
+const char *indtext_index_by_index_default(
+    INDTEXT_INDEX *index, unsigned value, const char *default_name)
+{
+    INDTEXT_DATA *data_list;
+    unsigned low = 0, high, middle;
+
+    if (!index) {
+        return default_name;
+    }
+    if (!indtext_index_sort(index)) {
+        return indtext_by_index_default(
+            index->data_list, value, default_name);
+    }
+    data_list = index->data_list;
+    high = index->count;
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (data_list[index->by_index[middle]].index < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if ((low < index->count) &&
+        (data_list[index->by_index[low]].index == value)) {
+        return data_list[index->by_index[low]].pString;
+    }
+
+    return default_name;
+}
@@ -35,6 +35,37 @@ typedef const struct {
     const char *pString;        /* text pair - use NULL to end the list */
 } INDTEXT_DATA;
 
+/* states of an INDTEXT_INDEX */
+#define INDTEXT_INDEX_UNSORTED 0
+#define INDTEXT_INDEX_SORTING 1
+#define INDTEXT_INDEX_SORTED 2
+#define INDTEXT_INDEX_FAILED 3
+
+/* sorted index of an INDTEXT_DATA list, for binary search lookups.
+   The position arrays are provided by the owner of the list, and are
+   sorted on first use by the one thread that claims the index.  The
+   lookups of other threads use the linear search until the sorted
+   index is published. */
+typedef struct indtext_index {
+    INDTEXT_DATA *data_list;
+    /* positions in the list sorted by case insensitive text */
+    uint16_t *by_string;
+    /* positions in the list sorted by index */
+    uint16_t *by_index;
+    /* number of positions that each array can hold */
+    unsigned size;
+    /* number of entries in the list, once sorted */
+    unsigned count;
+    /* INDTEXT_INDEX_UNSORTED, _SORTING, _SORTED, or _FAILED */
+    volatile long state;
+} INDTEXT_INDEX;
+
+/* initializer for an INDTEXT_INDEX from a list and two position arrays */
+#define INDTEXT_INDEX_INIT(list, by_string, by_index) \
+    { (list), (by_string), (by_index), \
+        (unsigned)(sizeof(by_string) / sizeof((by_string)[0])), 0, \
+        INDTEXT_INDEX_UNSORTED }
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -98,6 +129,23 @@ extern "C" {
     unsigned indtext_count(
         INDTEXT_DATA * data_list);
 
+/* sorts the index of a list - done on first use, or ahead of time */
+    BACNET_STACK_EXPORT
+    bool indtext_index_sort(
+        INDTEXT_INDEX * index);
+/* case insensitive version of indtext_by_istring using the index */
+    BACNET_STACK_EXPORT
+    bool indtext_index_by_istring(
+        INDTEXT_INDEX * index,
+        const char *search_name,
+        unsigned *found_index);
+/* version of indtext_by_index_default using the index */
+    BACNET_STACK_EXPORT
+    const char *indtext_index_by_index_default(
+        INDTEXT_INDEX * index,
+        unsigned value,
+        const char *default_name);
+
 
 #if !defined(__BORLANDC__) && !defined(_MSC_VER)
     int stricmp(
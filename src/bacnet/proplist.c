@@ -32,6 +32,7 @@
  -------------------------------------------
 ####COPYRIGHTEND####*/
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/bacenum.h"
 #include "bacnet/bacdef.h"
 #include "bacnet/bacdcode.h"
@@ -85,6 +86,95 @@ bool property_list_member(const int *pList, int object_property)
     return status;
 }
 
+/**
+ * @brief Add the properties of a list to the bitmap of an index
+ * @param index - property list index
+ * @param pList - array of type 'int' that is a list of BACnet object
+ * properties, terminated by a '-1' value.
+ * @return number of properties in the list
+ */
+static unsigned property_list_index_add(
+    struct property_list_index_t *index, const int *pList)
+{
+    unsigned property_count = 0;
+
+    if (pList) {
+        while (*pList != -1) {
+            if ((*pList >= 0) && (*pList < PROPERTY_LIST_BITMAP_MAX)) {
+                index->Bitmap[*pList / 8] |= (uint8_t)(1 << (*pList % 8));
+            }
+            property_count++;
+            pList++;
+        }
+    }
+
+    return property_count;
+}
+
+/**
+ * @brief Update the property list index of an object type, which holds
+ *  the lists with their counts, and a bitmap of the member properties.
+ *  The index is only rebuilt when the lists differ from the indexed lists,
+ *  so it can be updated from the Property_Lists function of an object
+ *  before each use.
+ * @param index - property list index
+ * @param pListRequired - list of required properties, or NULL
+ * @param pListOptional - list of optional properties, or NULL
+ * @param pListProprietary - list of proprietary properties, or NULL
+ * @return true if the index was rebuilt
+ */
+bool property_list_index_update(struct property_list_index_t *index,
+    const int *pListRequired,
+    const int *pListOptional,
+    const int *pListProprietary)
+{
+    if (!index) {
+        return false;
+    }
+    if ((index->List.Required.pList == pListRequired) &&
+        (index->List.Optional.pList == pListOptional) &&
+        (index->List.Proprietary.pList == pListProprietary)) {
+        return false;
+    }
+    memset(index->Bitmap, 0, sizeof(index->Bitmap));
+    index->List.Required.pList = pListRequired;
+    index->List.Required.count =
+        property_list_index_add(index, pListRequired);
+    index->List.Optional.pList = pListOptional;
+    index->List.Optional.count =
+        property_list_index_add(index, pListOptional);
+    index->List.Proprietary.pList = pListProprietary;
+    index->List.Proprietary.count =
+        property_list_index_add(index, pListProprietary);
+
+    return true;
+}
+
+/**
+ * @brief For a given object property, returns true if it is a member of
+ *  any of the indexed property lists
+ * @param index - property list index
+ * @param object_property - property enumeration or propritary value
+ * @return true if object_property is a member of the property lists
+ */
+bool property_list_index_member(
+    const struct property_list_index_t *index, int object_property)
+{
+    if (!index) {
+        return false;
+    }
+    if ((object_property >= 0) &&
+        (object_property < PROPERTY_LIST_BITMAP_MAX)) {
+        return (index->Bitmap[object_property / 8] &
+                   (1 << (object_property % 8))) != 0;
+    }
+
+    return property_list_member(index->List.Required.pList,
+               object_property) ||
+        property_list_member(index->List.Optional.pList, object_property) ||
+        property_list_member(index->List.Proprietary.pList, object_property);
+}
+
 /**
  * ReadProperty handler for this property.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -43,6 +43,18 @@ struct special_property_list_t {
     struct property_list_t Proprietary;
 };
 
+/* properties below this value are members of the bitmap of an index */
+#ifndef PROPERTY_LIST_BITMAP_MAX
+#define PROPERTY_LIST_BITMAP_MAX PROP_PROPRIETARY_RANGE_MIN
+#endif
+
+/** The property lists of an object type with their counts, and a bitmap
+    of the member properties, for constant time membership tests */
+struct property_list_index_t {
+    struct special_property_list_t List;
+    uint8_t Bitmap[(PROPERTY_LIST_BITMAP_MAX + 7) / 8];
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -55,6 +67,16 @@ extern "C" {
         const int *pList,
         int object_property);
     BACNET_STACK_EXPORT
+    bool property_list_index_update(
+        struct property_list_index_t *index,
+        const int *pListRequired,
+        const int *pListOptional,
+        const int *pListProprietary);
+    BACNET_STACK_EXPORT
+    bool property_list_index_member(
+        const struct property_list_index_t *index,
+        int object_property);
+    BACNET_STACK_EXPORT
     int property_list_encode(
         BACNET_READ_PROPERTY_DATA * rpdata,
         const int *pListRequired,
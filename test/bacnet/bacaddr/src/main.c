@@ -180,6 +180,33 @@ static void test_BACNET_MAC_ADDRESS(void)
     zassert_false(status, NULL);
  }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacnet_address_tests, test_BACNET_ADDRESS_record)
+#else
+static void test_BACNET_ADDRESS_record(void)
+#endif
+{
+    BACNET_ADDRESS dest = { 0 }, src = { 0 };
+    BACNET_MAC_ADDRESS mac = { 0 }, adr = { 0 };
+    uint8_t record[BACNET_ADDRESS_RECORD_SIZE] = { 0 };
+    int len = 0;
+
+    zassert_true(
+        bacnet_address_mac_from_ascii(&mac, "192.168.0.1:47808"), NULL);
+    zassert_true(bacnet_address_mac_from_ascii(&adr, "7F"), NULL);
+    zassert_true(bacnet_address_init(&src, &mac, 1234, &adr), NULL);
+    len = bacnet_address_record_encode(record, &src);
+    zassert_equal(len, BACNET_ADDRESS_RECORD_SIZE, NULL);
+    len = bacnet_address_record_decode(record, &dest);
+    zassert_equal(len, BACNET_ADDRESS_RECORD_SIZE, NULL);
+    zassert_true(bacnet_address_same(&dest, &src), NULL);
+    /* invalid lengths */
+    record[2] = MAX_MAC_LEN + 1;
+    zassert_equal(bacnet_address_record_decode(record, &dest), 0, NULL);
+    zassert_equal(bacnet_address_record_encode(NULL, &src), 0, NULL);
+    zassert_equal(bacnet_address_record_decode(record, NULL), 0, NULL);
+}
+
 /**
  * @}
  */
@@ -190,7 +217,8 @@ void test_main(void)
 {
     ztest_test_suite(bacnet_address_tests,
      ztest_unit_test(test_BACNET_ADDRESS),
-     ztest_unit_test(test_BACNET_MAC_ADDRESS)
+     ztest_unit_test(test_BACNET_MAC_ADDRESS),
+     ztest_unit_test(test_BACNET_ADDRESS_record)
      );
 
     ztest_run_test_suite(bacnet_address_tests);
@@ -1478,6 +1478,102 @@ static void test_bacnet_array_encode(void)
     zassert_true(apdu_len == BACNET_STATUS_ABORT, NULL);
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_array_codecs)
+#else
+static void test_bacnet_array_codecs(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    float real_value[] = { 0.0f, -1.5f, 3.14159f, 1.0e10f, -273.15f };
+    float test_real_value[5] = { 0.0f };
+#ifdef UINT64_MAX
+    BACNET_UNSIGNED_INTEGER unsigned_value[] = { 0, 255, 256, 65536,
+        4294967295UL, 4294967296ULL, UINT64_MAX };
+#else
+    BACNET_UNSIGNED_INTEGER unsigned_value[] = { 0, 255, 256, 65536,
+        4294967295UL };
+#endif
+    BACNET_UNSIGNED_INTEGER test_unsigned_value[7] = { 0 };
+    uint32_t enumerated_value[] = { 0, 1, 255, 65535, 16777216, 4294967295UL };
+    uint32_t test_enumerated_value[6] = { 0 };
+    const unsigned real_count = sizeof(real_value) / sizeof(real_value[0]);
+    const unsigned unsigned_count =
+        sizeof(unsigned_value) / sizeof(unsigned_value[0]);
+    const unsigned enumerated_count =
+        sizeof(enumerated_value) / sizeof(enumerated_value[0]);
+    int len = 0, test_len = 0;
+    unsigned i;
+
+    /* the array encodings are the same as the single value encodings */
+    len = encode_application_real_array(apdu, real_value, real_count);
+    zassert_equal(len, encode_application_real_array(NULL, real_value,
+        real_count), NULL);
+    test_len = 0;
+    for (i = 0; i < real_count; i++) {
+        test_len += encode_application_real(&test_apdu[test_len],
+            real_value[i]);
+    }
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    test_len = bacnet_real_application_array_decode(apdu, len,
+        test_real_value, real_count);
+    zassert_equal(len, test_len, NULL);
+    for (i = 0; i < real_count; i++) {
+        zassert_equal(real_value[i], test_real_value[i], NULL);
+    }
+    test_len = bacnet_real_application_array_decode(apdu, len - 1,
+        test_real_value, real_count);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+
+    len = encode_application_unsigned_array(apdu, unsigned_value,
+        unsigned_count);
+    zassert_equal(len, encode_application_unsigned_array(NULL,
+        unsigned_value, unsigned_count), NULL);
+    test_len = 0;
+    for (i = 0; i < unsigned_count; i++) {
+        test_len += encode_application_unsigned(&test_apdu[test_len],
+            unsigned_value[i]);
+    }
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    test_len = bacnet_unsigned_application_array_decode(apdu, len,
+        test_unsigned_value, unsigned_count);
+    zassert_equal(len, test_len, NULL);
+    for (i = 0; i < unsigned_count; i++) {
+        zassert_equal(unsigned_value[i], test_unsigned_value[i], NULL);
+    }
+    test_len = bacnet_unsigned_application_array_decode(apdu, len - 1,
+        test_unsigned_value, unsigned_count);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+    /* the wrong tag is not decoded */
+    test_len = bacnet_enumerated_application_array_decode(apdu, len,
+        test_enumerated_value, 1);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+
+    len = encode_application_enumerated_array(apdu, enumerated_value,
+        enumerated_count);
+    zassert_equal(len, encode_application_enumerated_array(NULL,
+        enumerated_value, enumerated_count), NULL);
+    test_len = 0;
+    for (i = 0; i < enumerated_count; i++) {
+        test_len += encode_application_enumerated(&test_apdu[test_len],
+            enumerated_value[i]);
+    }
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    test_len = bacnet_enumerated_application_array_decode(apdu, len,
+        test_enumerated_value, enumerated_count);
+    zassert_equal(len, test_len, NULL);
+    for (i = 0; i < enumerated_count; i++) {
+        zassert_equal(enumerated_value[i], test_enumerated_value[i], NULL);
+    }
+    test_len = bacnet_enumerated_application_array_decode(apdu, len - 1,
+        test_enumerated_value, enumerated_count);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+}
+
 /**
  * @}
  */
@@ -1513,7 +1609,8 @@ void test_main(void)
      ztest_unit_test(testDateContextDecodes),
      ztest_unit_test(testOctetStringContextDecodes),
      ztest_unit_test(testBACDCodeDouble),
-     ztest_unit_test(test_bacnet_array_encode)
+     ztest_unit_test(test_bacnet_array_encode),
+     ztest_unit_test(test_bacnet_array_codecs)
      );
 
     ztest_run_test_suite(bacdcode_tests);
@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @brief Unit test for the BACnet text lookups of the large lists
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacenum.h>
+#include <bacnet/bactext.h>
+#include <bacnet/indtext.h>
+
+/* the lists are not in the header */
+extern INDTEXT_DATA bacnet_object_type_names[];
+extern INDTEXT_DATA bacnet_property_names[];
+extern INDTEXT_DATA bacnet_engineering_unit_names[];
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test that the sorted index lookups give the same answers
+ *  as the linear search of each list, in both directions
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bactext_tests, testBACTextIndex)
+#else
+static void testBACTextIndex(void)
+#endif
+{
+    INDTEXT_DATA *entry;
+    unsigned found, expected;
+    char name[80];
+
+    for (entry = bacnet_object_type_names; entry->pString; entry++) {
+        zassert_true(bactext_object_type_index(entry->pString, &found), NULL);
+        zassert_true(indtext_by_istring(
+                         bacnet_object_type_names, entry->pString, &expected),
+            NULL);
+        zassert_equal(found, expected, NULL);
+        zassert_equal(bactext_object_type_name(entry->index),
+            indtext_by_index(bacnet_object_type_names, entry->index), NULL);
+    }
+    for (entry = bacnet_property_names; entry->pString; entry++) {
+        zassert_true(bactext_property_index(entry->pString, &found), NULL);
+        zassert_true(indtext_by_istring(
+                         bacnet_property_names, entry->pString, &expected),
+            NULL);
+        zassert_equal(found, expected, NULL);
+        zassert_equal(bactext_property_id(entry->pString), expected, NULL);
+        zassert_equal(bactext_property_name_default(entry->index, NULL),
+            indtext_by_index(bacnet_property_names, entry->index), NULL);
+    }
+    for (entry = bacnet_engineering_unit_names; entry->pString; entry++) {
+        zassert_true(
+            bactext_engineering_unit_index(entry->pString, &found), NULL);
+        zassert_true(indtext_by_istring(bacnet_engineering_unit_names,
+                         entry->pString, &expected),
+            NULL);
+        zassert_equal(found, expected, NULL);
+        zassert_equal(bactext_engineering_unit_name(entry->index),
+            indtext_by_index(bacnet_engineering_unit_names, entry->index),
+            NULL);
+    }
+    /* case insensitive, and the names that are not in the lists */
+    strcpy(name, "PRESENT-VALUE");
+    zassert_true(bactext_property_index(name, &found), NULL);
+    zassert_equal(found, PROP_PRESENT_VALUE, NULL);
+    zassert_false(bactext_property_index("present-values", &found), NULL);
+    zassert_false(bactext_property_index("", &found), NULL);
+    zassert_equal(bactext_property_id("no-such-property"), 0, NULL);
+    zassert_true(bactext_property_strtol("85", &found), NULL);
+    zassert_equal(found, PROP_PRESENT_VALUE, NULL);
+    zassert_true(bactext_object_type_strtol("Analog-Input", &found), NULL);
+    zassert_equal(found, OBJECT_ANALOG_INPUT, NULL);
+    zassert_false(bactext_object_type_strtol("analog", &found), NULL);
+    zassert_equal(bactext_property_name(PROP_PROPRIETARY_RANGE_MIN),
+        bactext_property_name(PROP_PROPRIETARY_RANGE_MIN + 1), NULL);
+    zassert_equal(bactext_object_type_name(OBJECT_PROPRIETARY_MIN),
+        bactext_object_type_name(OBJECT_PROPRIETARY_MIN + 1), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bactext_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bactext_tests, ztest_unit_test(testBACTextIndex));
+
+    ztest_run_test_suite(bactext_tests);
+}
+#endif
@@ -8,9 +8,13 @@
  * @brief test BACnet integer encode/decode APIs
  */
 
+#include <stdlib.h>
 #include <zephyr/ztest.h>
 #include <bacnet/bacaddr.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/npdu.h>
 #include <bacnet/basic/binding/address.h>
+#include <bacnet/basic/npdu/h_npdu.h>
 
 /* we are likely compiling the demo command line tools if print enabled */
 #if !defined(BACNET_ADDRESS_CACHE_FILE)
@@ -194,6 +198,202 @@ static void testAddress(void)
         zassert_equal(count, (MAX_ADDRESS_CACHE - i - 1), NULL);
     }
 }
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressContext)
+#else
+static void testAddressContext(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    BACNET_ADDRESS test_address;
+    unsigned test_max_apdu = 0;
+    void *context;
+    void *previous;
+
+    address_init();
+    set_address(1, &src);
+    address_add(1234, 480, &src);
+    zassert_equal(address_count(), 1, NULL);
+    context = malloc(address_context_size());
+    zassert_not_null(context, NULL);
+    address_context_init(context);
+    /* the new cache starts empty, and is independent of the default */
+    previous = address_context_select(context);
+    zassert_is_null(previous, NULL);
+    zassert_equal(address_count(), 0, NULL);
+    zassert_false(
+        address_get_by_device(1234, &test_max_apdu, &test_address), NULL);
+    set_address(2, &src);
+    address_add(5678, 1476, &src);
+    address_add(4321, 1476, &src);
+    zassert_equal(address_count(), 2, NULL);
+    previous = address_context_select(NULL);
+    zassert_equal(previous, context, NULL);
+    zassert_equal(address_count(), 1, NULL);
+    zassert_true(
+        address_get_by_device(1234, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_max_apdu, 480, NULL);
+    zassert_false(
+        address_get_by_device(5678, &test_max_apdu, &test_address), NULL);
+    (void)address_context_select(context);
+    zassert_true(
+        address_get_by_device(5678, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_max_apdu, 1476, NULL);
+    (void)address_context_select(NULL);
+    free(context);
+    address_remove_device(1234);
+}
+
+/**
+ * @brief Test the warm start snapshot records of the address cache
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressSnapshot)
+#else
+static void testAddressSnapshot(void)
+#endif
+{
+    static uint8_t record[MAX_ADDRESS_CACHE][ADDRESS_SNAPSHOT_RECORD_SIZE];
+    BACNET_ADDRESS src;
+    BACNET_ADDRESS test_address;
+    unsigned test_max_apdu = 0;
+    uint32_t index, count = 0;
+
+    address_init();
+    set_address(1, &src);
+    address_add(1001, 480, &src);
+    set_address(2, &src);
+    address_add(1002, 1476, &src);
+    /* static entries are added at startup, and are not saved */
+    set_address(3, &src);
+    address_add(1003, 50, &src);
+    address_set_device_TTL(1003, 0, true);
+    zassert_equal(address_snapshot_count(), MAX_ADDRESS_CACHE, NULL);
+    for (index = 0; index < address_snapshot_count(); index++) {
+        if (address_snapshot_encode(index, record[count])) {
+            count++;
+        }
+    }
+    zassert_equal(count, 2, NULL);
+    zassert_false(address_snapshot_encode(MAX_ADDRESS_CACHE, record[0]), NULL);
+    address_init();
+    zassert_equal(address_count(), 0, NULL);
+    for (index = 0; index < count; index++) {
+        zassert_true(address_snapshot_restore(index, record[index]), NULL);
+    }
+    zassert_equal(address_count(), 2, NULL);
+    zassert_true(
+        address_get_by_device(1002, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_max_apdu, 1476, NULL);
+    set_address(2, &src);
+    zassert_true(bacnet_address_same(&test_address, &src), NULL);
+    zassert_true(
+        address_get_by_device(1001, &test_max_apdu, &test_address), NULL);
+    zassert_false(
+        address_get_by_device(1003, &test_max_apdu, &test_address), NULL);
+    /* a record with a bad address */
+    record[0][14] = MAX_MAC_LEN + 1;
+    zassert_false(address_snapshot_restore(0, record[0]), NULL);
+    address_init();
+}
+
+/**
+ * @brief Receive a network layer message from a router
+ */
+static void network_message_receive(uint8_t router_mac,
+    BACNET_NETWORK_MESSAGE_TYPE message_type,
+    int reason,
+    uint16_t dnet)
+{
+    BACNET_ADDRESS router = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    int len;
+
+    router.mac_len = 1;
+    router.mac[0] = router_mac;
+    npdu_encode_npdu_network(
+        &npdu_data, message_type, false, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, NULL, NULL, &npdu_data);
+    if (reason >= 0) {
+        pdu[len++] = (uint8_t)reason;
+    }
+    len += encode_unsigned16(&pdu[len], dnet);
+    npdu_handler(&router, pdu, len);
+}
+
+/**
+ * @brief Test that a device on a remote network is reached through the
+ *  router that is learned from the received messages
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressRoute)
+#else
+static void testAddressRoute(void)
+#endif
+{
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS router = { 0 };
+    BACNET_ADDRESS test_address = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    unsigned test_max_apdu = 0;
+    int len;
+
+    address_init();
+    npdu_route_cache_timer(NPDU_ROUTE_CACHE_TIME);
+    /* a device on network 2001 that was bound without its router */
+    src.net = 2001;
+    src.len = 1;
+    src.adr[0] = 25;
+    address_add(2001025, 480, &src);
+    zassert_true(
+        address_get_by_device(2001025, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_address.mac_len, 0, NULL);
+    /* I-Am-Router-To-Network */
+    network_message_receive(
+        1, NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK, -1, 2001);
+    zassert_equal(npdu_route_cache_count(), 1, NULL);
+    zassert_true(
+        address_get_by_device(2001025, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_address.mac_len, 1, NULL);
+    zassert_equal(test_address.mac[0], 1, NULL);
+    zassert_equal(test_address.net, 2001, NULL);
+    zassert_equal(test_address.len, 1, NULL);
+    zassert_equal(test_address.adr[0], 25, NULL);
+    /* an I-Am from the network through another router */
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, NULL, &src, &npdu_data);
+    pdu[len++] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+    pdu[len++] = SERVICE_UNCONFIRMED_I_AM;
+    router.mac_len = 1;
+    router.mac[0] = 2;
+    npdu_handler(&router, pdu, len);
+    zassert_true(
+        address_get_by_device(2001025, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_address.mac[0], 2, NULL);
+    zassert_true(npdu_route_cache_find(2001, &router), NULL);
+    zassert_equal(router.mac[0], 2, NULL);
+    /* the router no longer reaches the network */
+    network_message_receive(2, NETWORK_MESSAGE_REJECT_MESSAGE_TO_NETWORK,
+        NETWORK_REJECT_NO_ROUTE, 2001);
+    zassert_false(npdu_route_cache_find(2001, NULL), NULL);
+    zassert_true(
+        address_get_by_device(2001025, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_address.mac_len, 0, NULL);
+    /* the routes expire */
+    network_message_receive(
+        1, NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK, -1, 2002);
+    zassert_equal(npdu_route_cache_count(), 1, NULL);
+    address_cache_timer(NPDU_ROUTE_CACHE_TIME - 1);
+    zassert_equal(npdu_route_cache_count(), 1, NULL);
+    address_cache_timer(1);
+    zassert_equal(npdu_route_cache_count(), 0, NULL);
+    /* local and broadcast addresses are not resolved */
+    zassert_false(npdu_route_cache_resolve(&router), NULL);
+    address_remove_device(2001025);
+}
 /**
  * @}
  */
@@ -207,13 +407,19 @@ void test_main(void)
 #ifdef BACNET_ADDRESS_CACHE_FILE
     ztest_test_suite(address_tests,
      ztest_unit_test(testAddressFile),
-     ztest_unit_test(testAddress)
+     ztest_unit_test(testAddress),
+     ztest_unit_test(testAddressContext),
+     ztest_unit_test(testAddressSnapshot),
+     ztest_unit_test(testAddressRoute)
      );
 
     ztest_run_test_suite(address_tests);
 #else
     ztest_test_suite(address_tests,
-     ztest_unit_test(testAddress)
+     ztest_unit_test(testAddress),
+     ztest_unit_test(testAddressContext),
+     ztest_unit_test(testAddressSnapshot),
+     ztest_unit_test(testAddressRoute)
      );
 
     ztest_run_test_suite(address_tests);
@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @brief Stub functions for unit test of the BACnet address cache
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/npdu.h"
+#include "bacnet/datalink/bip.h"
+
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+
+void apdu_handler(BACNET_ADDRESS *src, uint8_t *apdu, uint16_t apdu_len)
+{
+    (void)src;
+    (void)apdu;
+    (void)apdu_len;
+}
+
+void tsm_network_busy_set(uint16_t net, bool busy)
+{
+    (void)net;
+    (void)busy;
+}
+
+int bip_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    (void)pdu;
+    (void)pdu_len;
+    return 0;
+}
+
+void bip_get_my_address(BACNET_ADDRESS *my_address)
+{
+    (void)my_address;
+}
+
+void bip_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    (void)dest;
+}
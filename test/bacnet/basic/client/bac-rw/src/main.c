@@ -0,0 +1,684 @@
+/**
+ * @file
+ * @brief Unit test for the queued reads and the batched writes of the
+ *  BACnet client read/write task
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/datalink/datalink.h>
+#include <bacnet/npdu.h>
+#include <bacnet/wpm.h>
+#include <bacnet/basic/binding/address.h>
+#include <bacnet/basic/npdu/h_npdu.h>
+#include <bacnet/basic/client/bac-rw.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/services.h>
+#include <bacnet/basic/sys/mstimer.h>
+#include <bacnet/basic/tsm/tsm.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_DEVICE_ID 100
+#define TEST_WRITE_MAX 16
+
+/* a write from the last request */
+struct test_write {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    float value;
+};
+/* a result from the write result callback */
+struct test_result {
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ERROR_CODE error_code;
+};
+
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+static unsigned long Test_Milliseconds;
+static bool Test_Invoke_ID_Busy[256];
+static uint8_t Test_Invoke_ID;
+/* the last request that was sent */
+static unsigned Test_Request_Count;
+static uint8_t Test_Request_Invoke_ID;
+static uint8_t Test_Request_Service;
+static unsigned Test_Request_APDU_Len;
+static struct test_write Test_Write[TEST_WRITE_MAX];
+static unsigned Test_Write_Count;
+static uint32_t Test_Read_Instance;
+/* the results of the writes */
+static struct test_result Test_Result[TEST_WRITE_MAX];
+static unsigned Test_Result_Count;
+/* the handlers that the client registered */
+static confirmed_simple_ack_function Test_Simple_Ack_Handler;
+static complex_error_function Test_Complex_Error_Handler;
+static reject_function Test_Reject_Handler;
+
+unsigned long mstimer_now(void)
+{
+    return Test_Milliseconds;
+}
+
+uint16_t apdu_timeout(void)
+{
+    return 3000;
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1;
+}
+
+uint8_t tsm_next_free_invokeID(void)
+{
+    unsigned i;
+
+    for (i = 0; i < 255; i++) {
+        Test_Invoke_ID++;
+        if (Test_Invoke_ID == 0) {
+            Test_Invoke_ID = 1;
+        }
+        if (!Test_Invoke_ID_Busy[Test_Invoke_ID]) {
+            Test_Invoke_ID_Busy[Test_Invoke_ID] = true;
+            return Test_Invoke_ID;
+        }
+    }
+
+    return 0;
+}
+
+void tsm_free_invoke_id(uint8_t invokeID)
+{
+    Test_Invoke_ID_Busy[invokeID] = false;
+}
+
+bool tsm_invoke_id_free(uint8_t invokeID)
+{
+    return !Test_Invoke_ID_Busy[invokeID];
+}
+
+bool tsm_invoke_id_failed(uint8_t invokeID)
+{
+    (void)invokeID;
+    return false;
+}
+
+void tsm_set_confirmed_unsegmented_transaction(uint8_t invokeID,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *ndpu_data,
+    uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    (void)invokeID;
+    (void)dest;
+    (void)ndpu_data;
+    (void)apdu;
+    (void)apdu_len;
+}
+
+int tsm_send_pdu(uint8_t invokeID,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)invokeID;
+
+    return datalink_send_pdu(dest, npdu_data, pdu, pdu_len);
+}
+
+void apdu_set_confirmed_ack_handler(
+    BACNET_CONFIRMED_SERVICE service_choice, confirmed_ack_function pFunction)
+{
+    (void)service_choice;
+    (void)pFunction;
+}
+
+void apdu_set_confirmed_simple_ack_handler(
+    BACNET_CONFIRMED_SERVICE service_choice,
+    confirmed_simple_ack_function pFunction)
+{
+    (void)service_choice;
+    Test_Simple_Ack_Handler = pFunction;
+}
+
+void apdu_set_unconfirmed_handler(
+    BACNET_UNCONFIRMED_SERVICE service_choice, unconfirmed_function pFunction)
+{
+    (void)service_choice;
+    (void)pFunction;
+}
+
+void apdu_set_error_handler(
+    BACNET_CONFIRMED_SERVICE service_choice, error_function pFunction)
+{
+    (void)service_choice;
+    (void)pFunction;
+}
+
+void apdu_set_complex_error_handler(
+    BACNET_CONFIRMED_SERVICE service_choice, complex_error_function pFunction)
+{
+    (void)service_choice;
+    Test_Complex_Error_Handler = pFunction;
+}
+
+void apdu_set_abort_handler(abort_function pFunction)
+{
+    (void)pFunction;
+}
+
+void apdu_set_reject_handler(reject_function pFunction)
+{
+    Test_Reject_Handler = pFunction;
+}
+
+bool npdu_route_cache_resolve(BACNET_ADDRESS *dest)
+{
+    (void)dest;
+    return false;
+}
+
+void npdu_route_cache_timer(uint16_t seconds)
+{
+    (void)seconds;
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(BACNET_ADDRESS));
+}
+
+/**
+ * @brief Record a write of the last request
+ */
+static void test_write_record(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int len;
+
+    zassert_true(Test_Write_Count < TEST_WRITE_MAX, NULL);
+    len = bacapp_decode_application_data(
+        wp_data->application_data, wp_data->application_data_len, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_REAL, NULL);
+    Test_Write[Test_Write_Count].object_type = wp_data->object_type;
+    Test_Write[Test_Write_Count].object_instance = wp_data->object_instance;
+    Test_Write[Test_Write_Count].object_property = wp_data->object_property;
+    Test_Write[Test_Write_Count].value = value.type.Real;
+    Test_Write_Count++;
+}
+
+/* the WritePropertyMultiple requests are sent here */
+int datalink_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu = { 0 };
+    uint8_t *apdu;
+    unsigned apdu_len;
+    unsigned offset = 4;
+    int len;
+
+    (void)dest;
+    (void)npdu_data;
+    len = bacnet_npdu_decode(pdu, pdu_len, NULL, &src, &npdu);
+    zassert_true(len > 0, NULL);
+    apdu = &pdu[len];
+    apdu_len = pdu_len - len;
+    zassert_equal(apdu[0], PDU_TYPE_CONFIRMED_SERVICE_REQUEST, NULL);
+    Test_Request_Invoke_ID = apdu[2];
+    Test_Request_Service = apdu[3];
+    Test_Request_APDU_Len = apdu_len;
+    Test_Write_Count = 0;
+    zassert_equal(Test_Request_Service,
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, NULL);
+    while (offset < apdu_len) {
+        len = wpm_decode_object_id(&apdu[offset], apdu_len - offset, &wp_data);
+        zassert_true(len > 0, NULL);
+        offset += len;
+        zassert_true(decode_is_opening_tag_number(&apdu[offset], 1), NULL);
+        offset++;
+        while (!decode_is_closing_tag_number(&apdu[offset], 1)) {
+            len = wpm_decode_object_property(
+                &apdu[offset], apdu_len - offset, &wp_data);
+            zassert_true(len > 0, NULL);
+            offset += len;
+            test_write_record(&wp_data);
+        }
+        offset++;
+    }
+    Test_Request_Count++;
+
+    return (int)pdu_len;
+}
+
+uint8_t Send_Write_Property_Request_Data(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint8_t *application_data,
+    int application_data_len,
+    uint8_t priority,
+    uint32_t array_index)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+
+    (void)device_id;
+    (void)priority;
+    (void)array_index;
+    wp_data.object_type = object_type;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = object_property;
+    memcpy(wp_data.application_data, application_data, application_data_len);
+    wp_data.application_data_len = application_data_len;
+    Test_Write_Count = 0;
+    test_write_record(&wp_data);
+    Test_Request_Invoke_ID = tsm_next_free_invokeID();
+    Test_Request_Service = SERVICE_CONFIRMED_WRITE_PROPERTY;
+    Test_Request_Count++;
+
+    return Test_Request_Invoke_ID;
+}
+
+uint8_t Send_Read_Property_Request(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t array_index)
+{
+    (void)device_id;
+    (void)object_type;
+    (void)object_property;
+    (void)array_index;
+    Test_Read_Instance = object_instance;
+    Test_Request_Invoke_ID = tsm_next_free_invokeID();
+    Test_Request_Service = SERVICE_CONFIRMED_READ_PROPERTY;
+    Test_Request_Count++;
+
+    return Test_Request_Invoke_ID;
+}
+
+uint8_t Send_Read_Property_Multiple_Request(uint8_t *pdu,
+    size_t max_pdu,
+    uint32_t device_id,
+    BACNET_READ_ACCESS_DATA *read_access_data)
+{
+    (void)pdu;
+    (void)max_pdu;
+    (void)device_id;
+    (void)read_access_data;
+
+    return 0;
+}
+
+void Send_WhoIs(int32_t low_limit, int32_t high_limit)
+{
+    (void)low_limit;
+    (void)high_limit;
+}
+
+/**
+ * @brief Record the result of each write
+ */
+static void test_write_result(
+    uint32_t device_instance, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    zassert_equal(device_instance, TEST_DEVICE_ID, NULL);
+    zassert_true(Test_Result_Count < TEST_WRITE_MAX, NULL);
+    Test_Result[Test_Result_Count].object_instance = wp_data->object_instance;
+    Test_Result[Test_Result_Count].object_property = wp_data->object_property;
+    Test_Result[Test_Result_Count].error_code = wp_data->error_code;
+    Test_Result_Count++;
+}
+
+/**
+ * @brief Get the result of a write
+ * @return the error code of the write, or ERROR_CODE_OTHER if there is
+ *  no result for it
+ */
+static BACNET_ERROR_CODE test_result_error_code(
+    uint32_t object_instance, BACNET_PROPERTY_ID object_property)
+{
+    unsigned i;
+
+    for (i = 0; i < Test_Result_Count; i++) {
+        if ((Test_Result[i].object_instance == object_instance) &&
+            (Test_Result[i].object_property == object_property)) {
+            return Test_Result[i].error_code;
+        }
+    }
+
+    return ERROR_CODE_OTHER;
+}
+
+/**
+ * @brief Get the address of the device under test
+ */
+static BACNET_ADDRESS *test_device_address(void)
+{
+    static BACNET_ADDRESS dest;
+
+    return &dest;
+}
+
+/**
+ * @brief Start each test from an empty client with one bound device
+ * @param max_apdu - the max APDU of the device
+ */
+static void test_client_init(unsigned max_apdu)
+{
+    Test_Milliseconds = 1000;
+    memset(Test_Invoke_ID_Busy, 0, sizeof(Test_Invoke_ID_Busy));
+    Test_Request_Count = 0;
+    Test_Write_Count = 0;
+    Test_Result_Count = 0;
+    bacnet_read_write_init();
+    bacnet_write_result_callback_set(test_write_result);
+    zassert_not_null(Test_Simple_Ack_Handler, NULL);
+    zassert_not_null(Test_Complex_Error_Handler, NULL);
+    zassert_not_null(Test_Reject_Handler, NULL);
+    test_device_address()->mac_len = 1;
+    test_device_address()->mac[0] = 1;
+    address_add(TEST_DEVICE_ID, max_apdu, test_device_address());
+}
+
+/**
+ * @brief Run the client task until it sends a request
+ * @return true if a request was sent
+ */
+static bool test_task_until_request(void)
+{
+    unsigned count = Test_Request_Count;
+    unsigned i;
+
+    for (i = 0; i < 10; i++) {
+        bacnet_read_write_task();
+        if (Test_Request_Count != count) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Run the client task until it is idle
+ */
+static void test_task_until_idle(void)
+{
+    unsigned i;
+
+    for (i = 0; i < 10; i++) {
+        bacnet_read_write_task();
+    }
+    zassert_true(bacnet_read_write_idle(), NULL);
+}
+
+/**
+ * @brief Acknowledge the last request, which frees its invoke ID
+ */
+static void test_request_ack(void)
+{
+    Test_Simple_Ack_Handler(test_device_address(), Test_Request_Invoke_ID);
+    tsm_free_invoke_id(Test_Request_Invoke_ID);
+}
+
+/**
+ * @brief Test that repeated writes of a property send only the latest
+ *  value, and that the writes of a device go in one request
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, test_write_batch_coalesce)
+#else
+static void test_write_batch_coalesce(void)
+#endif
+{
+    test_client_init(MAX_APDU);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE, 1.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE, 2.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 2, PROP_PRESENT_VALUE, 4.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE, 3.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_false(bacnet_read_write_idle(), NULL);
+    zassert_true(test_task_until_request(), NULL);
+    zassert_equal(Test_Request_Service,
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, NULL);
+    zassert_equal(Test_Write_Count, 2, NULL);
+    zassert_equal(Test_Write[0].object_instance, 1, NULL);
+    zassert_false(islessgreater(Test_Write[0].value, 3.0f), NULL);
+    zassert_equal(Test_Write[1].object_instance, 2, NULL);
+    zassert_false(islessgreater(Test_Write[1].value, 4.0f), NULL);
+    test_request_ack();
+    test_task_until_idle();
+    zassert_equal(Test_Request_Count, 1, NULL);
+    zassert_equal(Test_Result_Count, 2, NULL);
+    zassert_equal(test_result_error_code(1, PROP_PRESENT_VALUE),
+        ERROR_CODE_SUCCESS, NULL);
+    zassert_equal(test_result_error_code(2, PROP_PRESENT_VALUE),
+        ERROR_CODE_SUCCESS, NULL);
+}
+
+/**
+ * @brief Test that a read queued after a write of the same property
+ *  is sent after the write
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, test_write_batch_read_after_write)
+#else
+static void test_write_batch_read_after_write(void)
+#endif
+{
+    test_client_init(MAX_APDU);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE, 5.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(bacnet_read_property_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(test_task_until_request(), NULL);
+    zassert_equal(Test_Request_Service,
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, NULL);
+    test_request_ack();
+    zassert_true(test_task_until_request(), NULL);
+    zassert_equal(Test_Request_Service, SERVICE_CONFIRMED_READ_PROPERTY, NULL);
+    zassert_equal(Test_Read_Instance, 1, NULL);
+    zassert_equal(Test_Result_Count, 1, NULL);
+    tsm_free_invoke_id(Test_Request_Invoke_ID);
+    test_task_until_idle();
+}
+
+/**
+ * @brief Test that the writes are split into requests that fit in
+ *  the max APDU of the device
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, test_write_batch_split)
+#else
+static void test_write_batch_split(void)
+#endif
+{
+    const unsigned max_apdu = 50;
+    unsigned write_count = 0;
+    uint32_t i;
+
+    test_client_init(max_apdu);
+    for (i = 1; i <= 6; i++) {
+        zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                         OBJECT_ANALOG_VALUE, i, PROP_PRESENT_VALUE, (float)i,
+                         8, BACNET_ARRAY_ALL),
+            NULL);
+    }
+    while (test_task_until_request()) {
+        zassert_true(Test_Request_APDU_Len <= max_apdu, NULL);
+        zassert_true(Test_Write_Count > 0, NULL);
+        zassert_true(Test_Write_Count < 6, NULL);
+        write_count += Test_Write_Count;
+        test_request_ack();
+    }
+    zassert_true(Test_Request_Count > 1, NULL);
+    zassert_equal(write_count, 6, NULL);
+    test_task_until_idle();
+    zassert_equal(Test_Result_Count, 6, NULL);
+    for (i = 1; i <= 6; i++) {
+        zassert_equal(test_result_error_code(i, PROP_PRESENT_VALUE),
+            ERROR_CODE_SUCCESS, NULL);
+    }
+}
+
+/**
+ * @brief Test that after a WritePropertyMultiple-Error, the writes
+ *  before the failed write succeed, the failed write reports the error,
+ *  and the writes after it are sent again
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, test_write_batch_wpm_error)
+#else
+static void test_write_batch_wpm_error(void)
+#endif
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int len;
+
+    test_client_init(MAX_APDU);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE, 1.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 1, PROP_HIGH_LIMIT, 2.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 1, PROP_LOW_LIMIT, 3.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(test_task_until_request(), NULL);
+    zassert_equal(Test_Write_Count, 3, NULL);
+    zassert_equal(Test_Write[1].object_property, PROP_HIGH_LIMIT, NULL);
+    /* the second write fails */
+    wp_data.object_type = OBJECT_ANALOG_VALUE;
+    wp_data.object_instance = 1;
+    wp_data.object_property = PROP_HIGH_LIMIT;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.error_class = ERROR_CLASS_PROPERTY;
+    wp_data.error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+    len = wpm_error_ack_encode_apdu(apdu, Test_Request_Invoke_ID, &wp_data);
+    zassert_true(len > 3, NULL);
+    Test_Complex_Error_Handler(test_device_address(), Test_Request_Invoke_ID,
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, &apdu[3], (uint16_t)(len - 3));
+    tsm_free_invoke_id(Test_Request_Invoke_ID);
+    zassert_true(test_task_until_request(), NULL);
+    zassert_equal(Test_Result_Count, 2, NULL);
+    zassert_equal(test_result_error_code(1, PROP_PRESENT_VALUE),
+        ERROR_CODE_SUCCESS, NULL);
+    zassert_equal(test_result_error_code(1, PROP_HIGH_LIMIT),
+        ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    /* the write that was not attempted is sent again */
+    zassert_equal(Test_Request_Service,
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, NULL);
+    zassert_equal(Test_Write_Count, 1, NULL);
+    zassert_equal(Test_Write[0].object_property, PROP_LOW_LIMIT, NULL);
+    test_request_ack();
+    test_task_until_idle();
+    zassert_equal(Test_Result_Count, 3, NULL);
+    zassert_equal(test_result_error_code(1, PROP_LOW_LIMIT),
+        ERROR_CODE_SUCCESS, NULL);
+}
+
+/**
+ * @brief Test that a device that rejects WritePropertyMultiple is sent
+ *  each write with WriteProperty
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, test_write_batch_wp_fallback)
+#else
+static void test_write_batch_wp_fallback(void)
+#endif
+{
+    test_client_init(MAX_APDU);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE, 1.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 2, PROP_PRESENT_VALUE, 2.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(test_task_until_request(), NULL);
+    zassert_equal(Test_Request_Service,
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, NULL);
+    Test_Reject_Handler(test_device_address(), Test_Request_Invoke_ID,
+        REJECT_REASON_UNRECOGNIZED_SERVICE);
+    tsm_free_invoke_id(Test_Request_Invoke_ID);
+    /* the writes are sent again, one WriteProperty at a time */
+    zassert_true(test_task_until_request(), NULL);
+    zassert_equal(Test_Result_Count, 0, NULL);
+    zassert_equal(Test_Request_Service, SERVICE_CONFIRMED_WRITE_PROPERTY, NULL);
+    zassert_equal(Test_Write[0].object_instance, 1, NULL);
+    test_request_ack();
+    zassert_true(test_task_until_request(), NULL);
+    zassert_equal(Test_Request_Service, SERVICE_CONFIRMED_WRITE_PROPERTY, NULL);
+    zassert_equal(Test_Write[0].object_instance, 2, NULL);
+    test_request_ack();
+    test_task_until_idle();
+    zassert_equal(Test_Result_Count, 2, NULL);
+    zassert_equal(test_result_error_code(1, PROP_PRESENT_VALUE),
+        ERROR_CODE_SUCCESS, NULL);
+    zassert_equal(test_result_error_code(2, PROP_PRESENT_VALUE),
+        ERROR_CODE_SUCCESS, NULL);
+    /* later writes to the device use WriteProperty */
+    zassert_true(bacnet_write_property_real_queue(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_VALUE, 3, PROP_PRESENT_VALUE, 3.0f, 8,
+                     BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(test_task_until_request(), NULL);
+    zassert_equal(Test_Request_Service, SERVICE_CONFIRMED_WRITE_PROPERTY, NULL);
+    test_request_ack();
+    test_task_until_idle();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bac_rw_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bac_rw_tests,
+        ztest_unit_test(test_write_batch_coalesce),
+        ztest_unit_test(test_write_batch_read_after_write),
+        ztest_unit_test(test_write_batch_split),
+        ztest_unit_test(test_write_batch_wpm_error),
+        ztest_unit_test(test_write_batch_wp_fallback));
+
+    ztest_run_test_suite(bac_rw_tests);
+}
+#endif
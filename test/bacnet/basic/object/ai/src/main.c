@@ -57,6 +57,54 @@ static void testAnalogInput(void)
         required_property++;
     }
 }
+
+/**
+ * @brief Test the creation and deletion of objects at runtime
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ai_tests, testAnalogInputCreateDelete)
+#else
+static void testAnalogInputCreateDelete(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    const uint32_t instance = 1000;
+    unsigned count = 0;
+
+    Analog_Input_Init();
+    count = Analog_Input_Count();
+    zassert_true(count > 0, NULL);
+    zassert_false(Analog_Input_Valid_Instance(instance), NULL);
+    zassert_true(Analog_Input_Create(instance), NULL);
+    zassert_false(Analog_Input_Create(instance), NULL);
+    zassert_true(Analog_Input_Valid_Instance(instance), NULL);
+    zassert_equal(Analog_Input_Count(), count + 1, NULL);
+    zassert_equal(Analog_Input_Index_To_Instance(count), instance, NULL);
+    zassert_equal(Analog_Input_Instance_To_Index(instance), count, NULL);
+    Analog_Input_Present_Value_Set(instance, 42.0f);
+    zassert_equal(Analog_Input_Present_Value(instance), 42.0f, NULL);
+    rpdata.application_data = &apdu[0];
+    rpdata.application_data_len = sizeof(apdu);
+    rpdata.object_type = OBJECT_ANALOG_INPUT;
+    rpdata.object_instance = instance;
+    rpdata.object_property = PROP_PRESENT_VALUE;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    zassert_true(Analog_Input_Read_Property(&rpdata) > 0, NULL);
+    /* the objects created at initialization keep their order */
+    zassert_equal(Analog_Input_Index_To_Instance(0), 0, NULL);
+    zassert_true(Analog_Input_Delete(instance), NULL);
+    zassert_false(Analog_Input_Delete(instance), NULL);
+    zassert_false(Analog_Input_Valid_Instance(instance), NULL);
+    zassert_equal(Analog_Input_Count(), count, NULL);
+    zassert_true(Analog_Input_Read_Property(&rpdata) < 0, NULL);
+    zassert_equal(rpdata.error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+    /* the storage is released and created again */
+    Analog_Input_Cleanup();
+    zassert_equal(Analog_Input_Count(), 0, NULL);
+    Analog_Input_Init();
+    zassert_equal(Analog_Input_Count(), count, NULL);
+}
 /**
  * @}
  */
@@ -68,7 +116,8 @@ ZTEST_SUITE(ai_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(ai_tests,
-     ztest_unit_test(testAnalogInput)
+     ztest_unit_test(testAnalogInput),
+     ztest_unit_test(testAnalogInputCreateDelete)
      );
 
     ztest_run_test_suite(ai_tests);
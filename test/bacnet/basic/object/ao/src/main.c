@@ -67,6 +67,76 @@ static void testAnalogOutput(void)
 
     return;
 }
+
+/**
+ * @brief Test the present-value evaluation of the priority-array
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ao_tests, testAnalogOutputPriority)
+#else
+static void testAnalogOutputPriority(void)
+#endif
+{
+    const uint32_t instance = 1;
+
+    Analog_Output_Init();
+    Analog_Output_Create(instance);
+    zassert_true(Analog_Output_Relinquish_Default_Set(instance, 5.0f), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 5.0f, NULL);
+    zassert_equal(Analog_Output_Present_Value_Priority(instance), 0, NULL);
+    zassert_true(Analog_Output_Present_Value_Set(instance, 10.0f, 8), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 10.0f, NULL);
+    zassert_equal(Analog_Output_Present_Value_Priority(instance), 8, NULL);
+    /* a lower priority is stored, but is not effective */
+    zassert_true(Analog_Output_Present_Value_Set(instance, 20.0f, 16), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 10.0f, NULL);
+    zassert_true(Analog_Output_Present_Value_Set(instance, 30.0f, 1), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 30.0f, NULL);
+    zassert_equal(Analog_Output_Present_Value_Priority(instance), 1, NULL);
+    zassert_true(Analog_Output_Present_Value_Relinquish(instance, 1), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 10.0f, NULL);
+    zassert_true(Analog_Output_Present_Value_Relinquish(instance, 8), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 20.0f, NULL);
+    zassert_true(Analog_Output_Present_Value_Relinquish(instance, 16), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 5.0f, NULL);
+    zassert_equal(Analog_Output_Present_Value_Priority(instance), 0, NULL);
+    /* the relinquish-default is effective when no priority is active */
+    zassert_true(Analog_Output_Relinquish_Default_Set(instance, 7.0f), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 7.0f, NULL);
+}
+
+/**
+ * @brief Test the warm start snapshot records of the priority-array
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ao_tests, testAnalogOutputSnapshot)
+#else
+static void testAnalogOutputSnapshot(void)
+#endif
+{
+    uint8_t record[ANALOG_OUTPUT_SNAPSHOT_RECORD_SIZE] = { 0 };
+    const uint32_t instance = 123;
+
+    Analog_Output_Init();
+    Analog_Output_Create(instance);
+    zassert_equal(Analog_Output_Snapshot_Count(), 1, NULL);
+    /* an object that is not commanded is not saved */
+    zassert_false(Analog_Output_Snapshot_Encode(0, record), NULL);
+    zassert_true(Analog_Output_Present_Value_Set(instance, 10.0f, 8), NULL);
+    zassert_true(Analog_Output_Present_Value_Set(instance, 20.0f, 16), NULL);
+    zassert_true(Analog_Output_Snapshot_Encode(0, record), NULL);
+    zassert_false(Analog_Output_Snapshot_Encode(1, record), NULL);
+    zassert_true(Analog_Output_Present_Value_Relinquish(instance, 8), NULL);
+    zassert_true(Analog_Output_Present_Value_Relinquish(instance, 16), NULL);
+    zassert_true(Analog_Output_Snapshot_Restore(0, record), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 10.0f, NULL);
+    zassert_equal(Analog_Output_Present_Value_Priority(instance), 8, NULL);
+    zassert_true(Analog_Output_Present_Value_Relinquish(instance, 8), NULL);
+    zassert_equal(Analog_Output_Present_Value(instance), 20.0f, NULL);
+    /* the object does not exist */
+    Analog_Output_Delete(instance);
+    zassert_false(Analog_Output_Snapshot_Restore(0, record), NULL);
+}
 /**
  * @}
  */
@@ -78,7 +148,9 @@ ZTEST_SUITE(ao_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(ao_tests,
-     ztest_unit_test(testAnalogOutput)
+     ztest_unit_test(testAnalogOutput),
+     ztest_unit_test(testAnalogOutputPriority),
+     ztest_unit_test(testAnalogOutputSnapshot)
      );
 
     ztest_run_test_suite(ao_tests);
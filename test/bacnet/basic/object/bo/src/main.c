@@ -65,6 +65,38 @@ static void testBinaryOutput(void)
         required_property++;
     }
 }
+
+/**
+ * @brief Test the warm start snapshot records of the priority-array
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bo_tests, testBinaryOutputSnapshot)
+#else
+static void testBinaryOutputSnapshot(void)
+#endif
+{
+    uint8_t record[BINARY_OUTPUT_SNAPSHOT_RECORD_SIZE] = { 0 };
+    const uint32_t instance = 123;
+
+    Binary_Output_Init();
+    Binary_Output_Create(instance);
+    zassert_equal(Binary_Output_Snapshot_Count(), 1, NULL);
+    zassert_false(Binary_Output_Snapshot_Encode(0, record), NULL);
+    zassert_true(
+        Binary_Output_Present_Value_Set(instance, BINARY_ACTIVE, 8), NULL);
+    zassert_true(
+        Binary_Output_Present_Value_Set(instance, BINARY_INACTIVE, 16), NULL);
+    zassert_true(Binary_Output_Snapshot_Encode(0, record), NULL);
+    zassert_true(Binary_Output_Present_Value_Relinquish(instance, 8), NULL);
+    zassert_true(Binary_Output_Present_Value_Relinquish(instance, 16), NULL);
+    zassert_true(Binary_Output_Snapshot_Restore(0, record), NULL);
+    zassert_equal(Binary_Output_Present_Value(instance), BINARY_ACTIVE, NULL);
+    zassert_true(Binary_Output_Present_Value_Relinquish(instance, 8), NULL);
+    zassert_equal(
+        Binary_Output_Present_Value(instance), BINARY_INACTIVE, NULL);
+    Binary_Output_Delete(instance);
+    zassert_false(Binary_Output_Snapshot_Restore(0, record), NULL);
+}
 /**
  * @}
  */
@@ -76,7 +108,8 @@ ZTEST_SUITE(bo_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(bo_tests,
-     ztest_unit_test(testBinaryOutput)
+     ztest_unit_test(testBinaryOutput),
+     ztest_unit_test(testBinaryOutputSnapshot)
      );
 
     ztest_run_test_suite(bo_tests);
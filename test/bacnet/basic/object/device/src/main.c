@@ -10,6 +10,10 @@
 
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/ai.h>
+#include <bacnet/basic/object/ao.h>
+#include <bacnet/basic/object/trendlog.h>
+#include <bacnet/basic/service/h_cov.h>
 
 /**
  * @addtogroup bacnet_tests
@@ -53,6 +57,185 @@ static void testDevice(void)
 
     return;
 }
+
+/**
+ * @brief Test the property lists of the object types in the object table
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceObjectsPropertyList)
+#else
+static void testDeviceObjectsPropertyList(void)
+#endif
+{
+    struct special_property_list_t property_list = { 0 };
+    unsigned i = 0, j = 0;
+
+    Device_Init(NULL);
+    for (j = 0; j < 2; j++) {
+        for (i = 0; i < OBJECT_PROPRIETARY_MIN; i++) {
+            Device_Objects_Property_List(
+                (BACNET_OBJECT_TYPE)i, 0, &property_list);
+            zassert_equal(property_list.Required.count,
+                property_list_count(property_list.Required.pList), NULL);
+            zassert_equal(property_list.Optional.count,
+                property_list_count(property_list.Optional.pList), NULL);
+            zassert_equal(property_list.Proprietary.count,
+                property_list_count(property_list.Proprietary.pList), NULL);
+        }
+    }
+    Device_Objects_Property_List(OBJECT_DEVICE, 0, &property_list);
+    zassert_true(property_list.Required.count >= 3, NULL);
+    zassert_true(property_list_member(
+        property_list.Required.pList, PROP_OBJECT_LIST), NULL);
+    Device_Objects_Property_List(OBJECT_PROPRIETARY_MIN, 0, &property_list);
+    zassert_equal(property_list.Required.count, 0, NULL);
+    zassert_true(Device_Valid_Object_Id(OBJECT_DEVICE,
+        Device_Object_Instance_Number()), NULL);
+}
+
+/**
+ * @brief Test the dynamic creation and deletion of objects
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceCreateDeleteObject)
+#else
+static void testDeviceCreateDeleteObject(void)
+#endif
+{
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_DELETE_OBJECT_DATA delete_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    uint8_t application_data[MAX_APDU] = { 0 };
+    uint8_t record[HANDLER_COV_SNAPSHOT_RECORD_SIZE] = { 0 };
+    BACNET_ADDRESS subscriber = { 0 };
+    uint32_t revision = 0;
+    unsigned count = 0;
+    bool status = false;
+    int len = 0;
+
+    Device_Init(NULL);
+    /* object-type only selects the first unused instance */
+    create_data.object_type = OBJECT_BINARY_INPUT;
+    create_data.object_instance = BACNET_MAX_INSTANCE;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    zassert_true(create_data.object_instance < BACNET_MAX_INSTANCE, NULL);
+    zassert_true(Device_Valid_Object_Id(
+        OBJECT_BINARY_INPUT, create_data.object_instance), NULL);
+    status = Device_Create_Object(&create_data);
+    zassert_false(status, NULL);
+    zassert_equal(create_data.error_code,
+        ERROR_CODE_OBJECT_IDENTIFIER_ALREADY_EXISTS, NULL);
+    /* a COV subscription to the object is removed with it */
+    handler_cov_init();
+    subscriber.mac_len = 1;
+    subscriber.mac[0] = 1;
+    encode_unsigned16(&record[2], OBJECT_BINARY_INPUT);
+    encode_unsigned32(&record[4], create_data.object_instance);
+    encode_unsigned32(&record[8], 1);
+    encode_unsigned32(&record[12], 300);
+    bacnet_address_record_encode(&record[16], &subscriber);
+    zassert_true(handler_cov_snapshot_restore(0, record), NULL);
+    zassert_true(
+        handler_cov_encode_subscriptions(application_data, MAX_APDU) > 0,
+        NULL);
+    delete_data.object_type = OBJECT_BINARY_INPUT;
+    delete_data.object_instance = create_data.object_instance;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    zassert_equal(
+        handler_cov_encode_subscriptions(application_data, MAX_APDU), 0,
+        NULL);
+    zassert_false(Device_Valid_Object_Id(
+        OBJECT_BINARY_INPUT, create_data.object_instance), NULL);
+    status = Device_Delete_Object(&delete_data);
+    zassert_false(status, NULL);
+    zassert_equal(delete_data.error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+    /* list of initial values */
+    len = encode_context_enumerated(
+        &application_data[0], 0, PROP_OUT_OF_SERVICE);
+    len += encode_opening_tag(&application_data[len], 2);
+    value.tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value.type.Boolean = true;
+    len += bacapp_encode_application_data(&application_data[len], &value);
+    len += encode_closing_tag(&application_data[len], 2);
+    create_data.object_type = OBJECT_ANALOG_OUTPUT;
+    create_data.object_instance = 100;
+    create_data.application_data = application_data;
+    create_data.application_data_len = len;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    zassert_true(Analog_Output_Out_Of_Service(100), NULL);
+    /* an initial value that fails does not create the object */
+    len += encode_context_enumerated(
+        &application_data[len], 0, PROP_OBJECT_TYPE);
+    len += encode_opening_tag(&application_data[len], 2);
+    len += encode_application_enumerated(
+        &application_data[len], OBJECT_ANALOG_OUTPUT);
+    len += encode_closing_tag(&application_data[len], 2);
+    create_data.object_instance = 101;
+    create_data.application_data_len = len;
+    status = Device_Create_Object(&create_data);
+    zassert_false(status, NULL);
+    zassert_equal(create_data.first_failed_element_number, 2, NULL);
+    zassert_false(Device_Valid_Object_Id(OBJECT_ANALOG_OUTPUT, 101), NULL);
+    /* analog inputs and trend logs are created and deleted at runtime */
+    count = Analog_Input_Count();
+    create_data.object_type = OBJECT_ANALOG_INPUT;
+    create_data.object_instance = 100;
+    create_data.application_data = NULL;
+    create_data.application_data_len = 0;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    zassert_equal(Analog_Input_Count(), count + 1, NULL);
+    count = Trend_Log_Count();
+    create_data.object_type = OBJECT_TRENDLOG;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    zassert_equal(Trend_Log_Count(), count + 1, NULL);
+    zassert_equal(Trend_Log_Index_To_Instance(count), 100, NULL);
+    rpdata.application_data = application_data;
+    rpdata.application_data_len = sizeof(application_data);
+    rpdata.object_type = OBJECT_TRENDLOG;
+    rpdata.object_instance = 100;
+    rpdata.object_property = PROP_RECORD_COUNT;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    zassert_equal(bacapp_decode_application_data(
+        application_data, len, &value), len, NULL);
+    zassert_equal(value.type.Unsigned_Int, 0, NULL);
+    delete_data.object_type = OBJECT_TRENDLOG;
+    delete_data.object_instance = 100;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    zassert_equal(Trend_Log_Count(), count, NULL);
+    zassert_false(Device_Valid_Object_Id(OBJECT_TRENDLOG, 100), NULL);
+    delete_data.object_type = OBJECT_ANALOG_INPUT;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    zassert_false(Device_Valid_Object_Id(OBJECT_ANALOG_INPUT, 100), NULL);
+    /* the device object is static */
+    create_data.object_type = OBJECT_DEVICE;
+    create_data.object_instance = BACNET_MAX_INSTANCE;
+    status = Device_Create_Object(&create_data);
+    zassert_false(status, NULL);
+    zassert_equal(create_data.error_code,
+        ERROR_CODE_DYNAMIC_CREATION_NOT_SUPPORTED, NULL);
+    delete_data.object_type = OBJECT_DEVICE;
+    delete_data.object_instance = Device_Object_Instance_Number();
+    status = Device_Delete_Object(&delete_data);
+    zassert_false(status, NULL);
+    zassert_equal(delete_data.error_code,
+        ERROR_CODE_OBJECT_DELETION_NOT_PERMITTED, NULL);
+    /* bulk creation increments the database revision once */
+    revision = Device_Database_Revision();
+    zassert_equal(
+        Device_Create_Objects(OBJECT_BINARY_OUTPUT, 1000, 100), 100, NULL);
+    zassert_equal(Device_Database_Revision(), revision + 1, NULL);
+    zassert_true(Device_Valid_Object_Id(OBJECT_BINARY_OUTPUT, 1099), NULL);
+}
 /**
  * @}
  */
@@ -64,7 +247,9 @@ ZTEST_SUITE(device_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(device_tests,
-     ztest_unit_test(testDevice)
+     ztest_unit_test(testDevice),
+     ztest_unit_test(testDeviceObjectsPropertyList),
+     ztest_unit_test(testDeviceCreateDeleteObject)
      );
 
     ztest_run_test_suite(device_tests);
@@ -56,3 +56,14 @@ int bip_send_pdu(
 {
     return 0;
 }
+
+bool npdu_route_cache_resolve(BACNET_ADDRESS *dest)
+{
+    (void)dest;
+    return false;
+}
+
+void npdu_route_cache_timer(uint16_t seconds)
+{
+    (void)seconds;
+}
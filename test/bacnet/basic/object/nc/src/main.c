@@ -6,16 +6,360 @@
  *
  * SPDX-License-Identifier: MIT
  */
-#include <ztest.h>
+#include <zephyr/ztest.h>
 #include <bacnet/bactext.h>
 #include <bacnet/rp.h>
+#include <bacnet/basic/binding/address.h>
+#include <bacnet/datalink/datalink.h>
 #include <bacnet/basic/object/nc.h>
+#include <bacnet/basic/sys/mstimer.h>
+#include <bacnet/basic/tsm/tsm.h>
 
 /**
  * @addtogroup bacnet_tests
  * @{
  */
 
+/* stubs for the time, the TSM, and the datalink of the event queue */
+static unsigned long Test_Milliseconds;
+static bool Test_Invoke_ID_Busy[256];
+static bool Test_Invoke_ID_Failed[256];
+static uint8_t Test_Invoke_ID;
+static uint8_t Test_Sent_Invoke_ID;
+static uint8_t Test_Sent_MAC;
+static unsigned Test_Sent_Count;
+static unsigned Test_WhoIs_Count;
+
+unsigned long mstimer_now(void)
+{
+    return Test_Milliseconds;
+}
+
+uint8_t tsm_next_free_invokeID(void)
+{
+    unsigned i;
+
+    for (i = 0; i < 255; i++) {
+        Test_Invoke_ID++;
+        if (Test_Invoke_ID == 0) {
+            Test_Invoke_ID = 1;
+        }
+        if (!Test_Invoke_ID_Busy[Test_Invoke_ID]) {
+            Test_Invoke_ID_Busy[Test_Invoke_ID] = true;
+            return Test_Invoke_ID;
+        }
+    }
+
+    return 0;
+}
+
+void tsm_free_invoke_id(uint8_t invokeID)
+{
+    Test_Invoke_ID_Busy[invokeID] = false;
+    Test_Invoke_ID_Failed[invokeID] = false;
+}
+
+bool tsm_invoke_id_free(uint8_t invokeID)
+{
+    return !Test_Invoke_ID_Busy[invokeID];
+}
+
+bool tsm_invoke_id_failed(uint8_t invokeID)
+{
+    return Test_Invoke_ID_Failed[invokeID];
+}
+
+void tsm_set_confirmed_unsegmented_transaction(uint8_t invokeID,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *ndpu_data,
+    uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    (void)invokeID;
+    (void)dest;
+    (void)ndpu_data;
+    (void)apdu;
+    (void)apdu_len;
+}
+
+int tsm_send_pdu(uint8_t invokeID,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)invokeID;
+
+    return datalink_send_pdu(dest, npdu_data, pdu, pdu_len);
+}
+
+void bip_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(BACNET_ADDRESS));
+}
+
+int bip_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu = { 0 };
+    int len;
+
+    (void)npdu_data;
+    len = bacnet_npdu_decode(pdu, pdu_len, NULL, &src, &npdu);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pdu[len], PDU_TYPE_CONFIRMED_SERVICE_REQUEST, NULL);
+    zassert_equal(pdu[len + 3], SERVICE_CONFIRMED_EVENT_NOTIFICATION, NULL);
+    Test_Sent_Invoke_ID = pdu[len + 2];
+    Test_Sent_MAC = dest->mac[0];
+    Test_Sent_Count++;
+
+    return (int)pdu_len;
+}
+
+void Send_WhoIs(int32_t low_limit, int32_t high_limit)
+{
+    (void)low_limit;
+    (void)high_limit;
+    Test_WhoIs_Count++;
+}
+
+/**
+ * @brief Start each event queue test from an empty queue, TSM,
+ *  and address cache
+ */
+static void test_event_queue_init(void)
+{
+    Test_Milliseconds = 1000;
+    memset(Test_Invoke_ID_Busy, 0, sizeof(Test_Invoke_ID_Busy));
+    memset(Test_Invoke_ID_Failed, 0, sizeof(Test_Invoke_ID_Failed));
+    Test_Invoke_ID = 0;
+    Test_Sent_Invoke_ID = 0;
+    Test_Sent_MAC = 0;
+    Test_Sent_Count = 0;
+    Test_WhoIs_Count = 0;
+    address_init();
+    Notification_Class_Init();
+}
+
+/**
+ * @brief Bind a device in the address cache with a one octet MAC
+ */
+static void test_device_bind(uint32_t device_id, uint8_t mac)
+{
+    BACNET_ADDRESS src = { 0 };
+
+    src.mac_len = 1;
+    src.mac[0] = mac;
+    address_add(device_id, MAX_APDU, &src);
+}
+
+/**
+ * @brief Get the address of a device from the address cache
+ */
+static BACNET_ADDRESS *test_device_address(uint32_t device_id)
+{
+    static BACNET_ADDRESS src;
+    unsigned max_apdu = 0;
+
+    zassert_true(address_get_by_device(device_id, &max_apdu, &src), NULL);
+
+    return &src;
+}
+
+/**
+ * @brief Set the recipient of Notification Class 0 to one device,
+ *  with confirmed notifications
+ */
+static void test_recipient_set(uint32_t device_id)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_DESTINATION destination = { 0 };
+
+    bacnet_destination_default_init(&destination);
+    destination.Recipient.type.device.instance = device_id;
+    destination.ProcessIdentifier = 1;
+    destination.ConfirmedNotify = true;
+    wp_data.object_type = OBJECT_NOTIFICATION_CLASS;
+    wp_data.object_instance = 0;
+    wp_data.object_property = PROP_RECIPIENT_LIST;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.application_data_len =
+        bacnet_destination_encode(wp_data.application_data, &destination);
+    zassert_true(wp_data.application_data_len > 0, NULL);
+    zassert_true(Notification_Class_Write_Property(&wp_data), NULL);
+}
+
+/**
+ * @brief Report an event of Notification Class 0
+ */
+static void test_event_report(void)
+{
+    BACNET_EVENT_NOTIFICATION_DATA event_data = { 0 };
+
+    event_data.eventObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    event_data.eventObjectIdentifier.instance = 1;
+    event_data.timeStamp.tag = TIME_STAMP_SEQUENCE;
+    event_data.notificationClass = 0;
+    event_data.notifyType = NOTIFY_ALARM;
+    event_data.fromState = EVENT_STATE_NORMAL;
+    event_data.toState = EVENT_STATE_HIGH_LIMIT;
+    event_data.eventType = EVENT_OUT_OF_RANGE;
+    event_data.notificationParams.outOfRange.exceedingValue = 100.0f;
+    event_data.notificationParams.outOfRange.exceededLimit = 90.0f;
+    bitstring_init(&event_data.notificationParams.outOfRange.statusFlags);
+    Notification_Class_common_reporting_function(&event_data);
+}
+
+/**
+ * @brief Test that no more than NC_EVENT_QUEUE_WINDOW notifications
+ *  are outstanding, and that only an acknowledgment completes one
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(notification_class_tests, test_Notification_Class_Event_Queue_Window)
+#else
+static void test_Notification_Class_Event_Queue_Window(void)
+#endif
+{
+    NC_EVENT_QUEUE_STATS stats = { 0 };
+    unsigned i;
+
+    test_event_queue_init();
+    test_device_bind(100, 1);
+    test_recipient_set(100);
+    for (i = 0; i < (NC_EVENT_QUEUE_WINDOW + 2); i++) {
+        test_event_report();
+    }
+    Notification_Class_Event_Queue_Stats(&stats);
+    zassert_equal(stats.queued, NC_EVENT_QUEUE_WINDOW + 2, NULL);
+    zassert_equal(stats.sent, NC_EVENT_QUEUE_WINDOW, NULL);
+    zassert_equal(stats.in_flight, NC_EVENT_QUEUE_WINDOW, NULL);
+    zassert_equal(stats.depth, NC_EVENT_QUEUE_WINDOW + 2, NULL);
+    zassert_equal(Test_Sent_Count, NC_EVENT_QUEUE_WINDOW, NULL);
+    zassert_equal(Test_Sent_MAC, 1, NULL);
+    /* an acknowledgment opens the window for the next one */
+    Test_Milliseconds += 50;
+    Notification_Class_Event_Ack_Handler(test_device_address(100), 1);
+    tsm_free_invoke_id(1);
+    Notification_Class_Event_Queue_Task();
+    Notification_Class_Event_Queue_Stats(&stats);
+    zassert_equal(stats.completed, 1, NULL);
+    zassert_equal(stats.failed, 0, NULL);
+    zassert_equal(stats.latency_last_ms, 50, NULL);
+    zassert_equal(stats.sent, NC_EVENT_QUEUE_WINDOW + 1, NULL);
+    zassert_equal(stats.in_flight, NC_EVENT_QUEUE_WINDOW, NULL);
+    zassert_equal(stats.depth, NC_EVENT_QUEUE_WINDOW + 1, NULL);
+    /* an acknowledgment from another address is not ours */
+    Notification_Class_Event_Ack_Handler(NULL, 2);
+    test_device_bind(101, 2);
+    Notification_Class_Event_Ack_Handler(test_device_address(101), 2);
+    tsm_free_invoke_id(2);
+    Notification_Class_Event_Queue_Task();
+    Notification_Class_Event_Queue_Stats(&stats);
+    zassert_equal(stats.completed, 1, NULL);
+    zassert_equal(stats.failed, 1, NULL);
+}
+
+/**
+ * @brief Test that an Error, Reject, Abort, or timeout of a
+ *  notification is counted as failed, not completed
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(notification_class_tests, test_Notification_Class_Event_Queue_Refused)
+#else
+static void test_Notification_Class_Event_Queue_Refused(void)
+#endif
+{
+    NC_EVENT_QUEUE_STATS stats = { 0 };
+    BACNET_ADDRESS *dest;
+    unsigned i;
+
+    test_event_queue_init();
+    test_device_bind(100, 1);
+    test_recipient_set(100);
+    for (i = 0; i < 4; i++) {
+        test_event_report();
+    }
+    Notification_Class_Event_Queue_Stats(&stats);
+    zassert_equal(stats.in_flight, 4, NULL);
+    dest = test_device_address(100);
+    Notification_Class_Event_Error_Handler(
+        dest, 1, ERROR_CLASS_SERVICES, ERROR_CODE_OTHER);
+    tsm_free_invoke_id(1);
+    Notification_Class_Event_Reject_Handler(
+        dest, 2, REJECT_REASON_UNRECOGNIZED_SERVICE);
+    tsm_free_invoke_id(2);
+    Notification_Class_Event_Abort_Handler(
+        dest, 3, ABORT_REASON_OTHER, true);
+    tsm_free_invoke_id(3);
+    Notification_Class_Event_Queue_Task();
+    Notification_Class_Event_Queue_Stats(&stats);
+    zassert_equal(stats.failed, 3, NULL);
+    zassert_equal(stats.completed, 0, NULL);
+    zassert_equal(stats.in_flight, 1, NULL);
+    /* a timeout invalidates the binding, so that the next notification
+       uses the new address of the recipient */
+    test_device_bind(100, 7);
+    test_event_report();
+    zassert_equal(Test_Sent_MAC, 1, NULL);
+    Test_Invoke_ID_Failed[4] = true;
+    Notification_Class_Event_Queue_Task();
+    Notification_Class_Event_Queue_Stats(&stats);
+    zassert_equal(stats.failed, 4, NULL);
+    zassert_true(tsm_invoke_id_free(4), NULL);
+    test_event_report();
+    zassert_equal(Test_Sent_MAC, 7, NULL);
+}
+
+/**
+ * @brief Test the binding of an unknown recipient: Who-Is is limited
+ *  to one per NC_EVENT_QUEUE_WHOIS_MS, the notification is sent once
+ *  the device is bound, and is dropped after the bind timeout
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(notification_class_tests, test_Notification_Class_Event_Queue_Bind)
+#else
+static void test_Notification_Class_Event_Queue_Bind(void)
+#endif
+{
+    NC_EVENT_QUEUE_STATS stats = { 0 };
+    unsigned whois_count;
+
+    test_event_queue_init();
+    test_recipient_set(200);
+    test_event_report();
+    Notification_Class_Event_Queue_Stats(&stats);
+    zassert_equal(stats.queued, 1, NULL);
+    zassert_equal(stats.sent, 0, NULL);
+    zassert_equal(Test_Sent_Count, 0, NULL);
+    whois_count = Test_WhoIs_Count;
+    zassert_true(whois_count > 0, NULL);
+    Test_Milliseconds += 10;
+    Notification_Class_Event_Queue_Task();
+    zassert_equal(Test_WhoIs_Count, whois_count, NULL);
+    Test_Milliseconds += NC_EVENT_QUEUE_WHOIS_MS;
+    Notification_Class_Event_Queue_Task();
+    zassert_equal(Test_WhoIs_Count, whois_count + 1, NULL);
+    /* the I-Am binds the device, and the notification is sent */
+    test_device_bind(200, 3);
+    Notification_Class_Event_Queue_Task();
+    Notification_Class_Event_Queue_Stats(&stats);
+    zassert_equal(stats.sent, 1, NULL);
+    zassert_equal(Test_Sent_MAC, 3, NULL);
+    /* a recipient that is never bound is dropped after the timeout */
+    test_event_queue_init();
+    test_recipient_set(201);
+    test_event_report();
+    Test_Milliseconds += NC_EVENT_QUEUE_BIND_TIMEOUT_MS + 1;
+    Notification_Class_Event_Queue_Task();
+    Notification_Class_Event_Queue_Stats(&stats);
+    zassert_equal(stats.dropped, 1, NULL);
+    zassert_equal(stats.depth, 0, NULL);
+    zassert_equal(stats.sent, 0, NULL);
+}
+
 /**
  * @brief Test
  */
@@ -61,7 +405,10 @@ ZTEST_SUITE(notification_class_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(notification_class_tests,
-     ztest_unit_test(test_Notification_Class)
+     ztest_unit_test(test_Notification_Class),
+     ztest_unit_test(test_Notification_Class_Event_Queue_Window),
+     ztest_unit_test(test_Notification_Class_Event_Queue_Refused),
+     ztest_unit_test(test_Notification_Class_Event_Queue_Bind)
      );
 
     ztest_run_test_suite(notification_class_tests);
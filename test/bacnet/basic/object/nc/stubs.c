@@ -35,21 +35,31 @@ uint8_t Send_CEvent_Notify(
     return 0;
 }
 
-void Send_WhoIs(int32_t low_limit, int32_t high_limit)
-{
-    (void)low_limit;
-    (void)high_limit;
-}
-
 bool datetime_local(
     BACNET_DATE * bdate,
     BACNET_TIME * btime,
     int16_t * utc_offset_minutes,
     bool * dst_active)
 {
-    (void)bdate;
-    (void)btime;
     (void)utc_offset_minutes;
     (void)dst_active;
+    /* a Monday at noon, within the default recipient days and times */
+    if (bdate) {
+        bdate->wday = BACNET_WEEKDAY_MONDAY;
+    }
+    if (btime) {
+        datetime_set_time(btime, 12, 0, 0, 0);
+    }
     return true;
 }
+
+bool npdu_route_cache_resolve(BACNET_ADDRESS *dest)
+{
+    (void)dest;
+    return false;
+}
+
+void npdu_route_cache_timer(uint16_t seconds)
+{
+    (void)seconds;
+}
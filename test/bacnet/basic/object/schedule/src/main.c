@@ -9,6 +9,7 @@
  */
 
 #include <zephyr/ztest.h>
+#include <bacnet/basic/object/device.h>
 #include <bacnet/basic/object/schedule.h>
 
 /**
@@ -16,6 +17,36 @@
  * @{
  */
 
+static unsigned Write_Property_Count;
+static BACNET_WRITE_PROPERTY_DATA Write_Property_Data;
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
+bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    Write_Property_Count++;
+    memcpy(&Write_Property_Data, wp_data, sizeof(Write_Property_Data));
+
+    return true;
+}
+
+static void schedule_time_value_set(BACNET_OBJ_DAILY_SCHEDULE *day,
+    uint8_t hour,
+    uint8_t minute,
+    BACNET_APPLICATION_TAG tag,
+    float value)
+{
+    BACNET_TIME_VALUE *time_value = &day->Time_Values[day->TV_Count];
+
+    datetime_set_time(&time_value->Time, hour, minute, 0, 0);
+    time_value->Value.tag = tag;
+    time_value->Value.type.Real = value;
+    day->TV_Count++;
+}
+
 /**
  * @brief Test
  */
@@ -50,6 +81,195 @@ static void testSchedule(void)
 
     return;
 }
+
+/**
+ * @brief Test the calendar entries of the special events
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(schedule_tests, testScheduleSpecialEvent)
+#else
+static void testScheduleSpecialEvent(void)
+#endif
+{
+    BACNET_OBJ_SPECIAL_EVENT event = { 0 };
+    BACNET_DATE date;
+
+    /* Monday, June 5, 2023 */
+    datetime_set_date(&date, 2023, 6, 5);
+    event.Calendar_Entry_Tag = BACNET_CALENDAR_DATE;
+    datetime_set_date(&event.Calendar_Entry.Date, 2023, 6, 5);
+    zassert_true(Schedule_Special_Event_Active(&event, &date), NULL);
+    event.Calendar_Entry.Date.year = BACNET_DATE_YEAR_EPOCH + 0xFF;
+    event.Calendar_Entry.Date.wday = 0xFF;
+    zassert_true(Schedule_Special_Event_Active(&event, &date), NULL);
+    event.Calendar_Entry.Date.day = 6;
+    zassert_false(Schedule_Special_Event_Active(&event, &date), NULL);
+    /* odd days of even months */
+    event.Calendar_Entry.Date.month = 14;
+    event.Calendar_Entry.Date.day = 33;
+    zassert_true(Schedule_Special_Event_Active(&event, &date), NULL);
+    event.Calendar_Entry.Date.month = 13;
+    zassert_false(Schedule_Special_Event_Active(&event, &date), NULL);
+    /* last day of the month */
+    event.Calendar_Entry.Date.month = 0xFF;
+    event.Calendar_Entry.Date.day = 32;
+    zassert_false(Schedule_Special_Event_Active(&event, &date), NULL);
+    datetime_set_date(&date, 2024, 2, 29);
+    zassert_true(Schedule_Special_Event_Active(&event, &date), NULL);
+    /* date range */
+    datetime_set_date(&date, 2023, 6, 5);
+    event.Calendar_Entry_Tag = BACNET_CALENDAR_DATE_RANGE;
+    datetime_set_date(&event.Calendar_Entry.Date_Range.startdate, 2023, 6, 1);
+    datetime_set_date(&event.Calendar_Entry.Date_Range.enddate, 2023, 6, 5);
+    zassert_true(Schedule_Special_Event_Active(&event, &date), NULL);
+    datetime_set_date(&date, 2023, 6, 6);
+    zassert_false(Schedule_Special_Event_Active(&event, &date), NULL);
+    /* the first Monday of June */
+    datetime_set_date(&date, 2023, 6, 5);
+    event.Calendar_Entry_Tag = BACNET_CALENDAR_WEEK_N_DAY;
+    event.Calendar_Entry.Week_N_Day.month = 6;
+    event.Calendar_Entry.Week_N_Day.weekofmonth = 1;
+    event.Calendar_Entry.Week_N_Day.dayofweek = BACNET_WEEKDAY_MONDAY;
+    zassert_true(Schedule_Special_Event_Active(&event, &date), NULL);
+    datetime_set_date(&date, 2023, 6, 12);
+    zassert_false(Schedule_Special_Event_Active(&event, &date), NULL);
+    /* the last Monday of May */
+    event.Calendar_Entry.Week_N_Day.month = 5;
+    event.Calendar_Entry.Week_N_Day.weekofmonth = 6;
+    datetime_set_date(&date, 2023, 5, 29);
+    zassert_true(Schedule_Special_Event_Active(&event, &date), NULL);
+    datetime_set_date(&date, 2023, 5, 22);
+    zassert_false(Schedule_Special_Event_Active(&event, &date), NULL);
+    zassert_false(Schedule_Special_Event_Active(NULL, &date), NULL);
+    zassert_false(Schedule_Special_Event_Active(&event, NULL), NULL);
+}
+
+/**
+ * @brief Test the timeline of the weekly and exception schedules
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(schedule_tests, testScheduleTimeline)
+#else
+static void testScheduleTimeline(void)
+#endif
+{
+    SCHEDULE_DESCR *desc;
+    BACNET_OBJ_SPECIAL_EVENT *event;
+    BACNET_DATE_TIME bdatetime;
+    bacnet_time_t midnight;
+    uint32_t seconds;
+
+    Schedule_Init();
+    desc = Schedule_Object(0);
+    zassert_not_null(desc, NULL);
+    zassert_is_null(Schedule_Object(Schedule_Count()), NULL);
+    /* Monday: occupied from 6:00 to 18:00 */
+    schedule_time_value_set(&desc->Weekly_Schedule[0], 6, 0,
+        BACNET_APPLICATION_TAG_REAL, 22.0f);
+    schedule_time_value_set(&desc->Weekly_Schedule[0], 18, 0,
+        BACNET_APPLICATION_TAG_REAL, 16.0f);
+    /* a special event on Monday, June 5, from 12:00 to 13:00 */
+    event = &desc->Exception_Schedule[0];
+    event->Calendar_Entry_Tag = BACNET_CALENDAR_DATE;
+    datetime_set_date(&event->Calendar_Entry.Date, 2023, 6, 5);
+    event->Event_Priority = 10;
+    schedule_time_value_set(
+        &event->Day_Schedule, 12, 0, BACNET_APPLICATION_TAG_REAL, 30.0f);
+    schedule_time_value_set(
+        &event->Day_Schedule, 13, 0, BACNET_APPLICATION_TAG_NULL, 0.0f);
+    desc->Exception_Count = 1;
+    Schedule_Timeline_Invalidate(desc);
+    /* Monday, June 5, 2023 */
+    datetime_set_values(&bdatetime, 2023, 6, 5, 5, 0, 0, 0);
+    zassert_true(Schedule_Timeline_Compile(desc, &bdatetime.date), NULL);
+    zassert_equal(desc->Timeline_Count, 5, NULL);
+    midnight = datetime_seconds_since_epoch(&bdatetime) - (5UL * 3600UL);
+    /* before the first time value is the schedule default */
+    Schedule_Timeline_Evaluate(desc, &bdatetime);
+    zassert_equal(desc->Present_Value.tag, BACNET_APPLICATION_TAG_REAL, NULL);
+    zassert_equal(desc->Present_Value.type.Real, 21.0f, NULL);
+    zassert_equal(desc->Next_Transition, midnight + (6UL * 3600UL), NULL);
+    zassert_false(Schedule_Timeline_Evaluate(desc, &bdatetime), NULL);
+    datetime_set_time(&bdatetime.time, 6, 0, 0, 0);
+    zassert_true(Schedule_Timeline_Evaluate(desc, &bdatetime), NULL);
+    zassert_equal(desc->Present_Value.type.Real, 22.0f, NULL);
+    zassert_equal(desc->Next_Transition, midnight + (12UL * 3600UL), NULL);
+    /* the special event has a higher priority */
+    datetime_set_time(&bdatetime.time, 12, 30, 0, 0);
+    zassert_true(Schedule_Timeline_Evaluate(desc, &bdatetime), NULL);
+    zassert_equal(desc->Present_Value.type.Real, 30.0f, NULL);
+    /* and relinquishes to the weekly schedule */
+    datetime_set_time(&bdatetime.time, 13, 0, 0, 0);
+    zassert_true(Schedule_Timeline_Evaluate(desc, &bdatetime), NULL);
+    zassert_equal(desc->Present_Value.type.Real, 22.0f, NULL);
+    zassert_equal(desc->Next_Transition, midnight + (18UL * 3600UL), NULL);
+    datetime_set_time(&bdatetime.time, 23, 59, 59, 0);
+    zassert_true(Schedule_Timeline_Evaluate(desc, &bdatetime), NULL);
+    zassert_equal(desc->Present_Value.type.Real, 16.0f, NULL);
+    zassert_equal(desc->Next_Transition, midnight + (24UL * 3600UL), NULL);
+    /* the next Monday has no special event */
+    datetime_set_values(&bdatetime, 2023, 6, 12, 12, 30, 0, 0);
+    zassert_true(Schedule_Timeline_Evaluate(desc, &bdatetime), NULL);
+    zassert_equal(desc->Timeline_Count, 3, NULL);
+    zassert_equal(desc->Present_Value.type.Real, 22.0f, NULL);
+    /* Tuesday has no time values */
+    datetime_set_values(&bdatetime, 2023, 6, 13, 12, 30, 0, 0);
+    zassert_true(Schedule_Timeline_Evaluate(desc, &bdatetime), NULL);
+    zassert_equal(desc->Timeline_Count, 1, NULL);
+    zassert_equal(desc->Present_Value.type.Real, 21.0f, NULL);
+    /* outside of the effective period the value does not change */
+    datetime_set_date(&desc->Start_Date, 2024, 1, 1);
+    Schedule_Timeline_Invalidate(desc);
+    datetime_set_values(&bdatetime, 2023, 6, 12, 12, 30, 0, 0);
+    zassert_false(Schedule_Timeline_Compile(desc, &bdatetime.date), NULL);
+    zassert_false(Schedule_Timeline_Evaluate(desc, &bdatetime), NULL);
+    zassert_equal(desc->Present_Value.type.Real, 21.0f, NULL);
+    desc->Start_Date.year = BACNET_DATE_YEAR_EPOCH + 0xFF;
+    Schedule_Timeline_Invalidate(desc);
+    /* the task writes the changes to the references */
+    desc->Object_Property_References[0].objectIdentifier.type =
+        OBJECT_ANALOG_VALUE;
+    desc->Object_Property_References[0].objectIdentifier.instance = 1;
+    desc->Object_Property_References[0].propertyIdentifier =
+        PROP_PRESENT_VALUE;
+    desc->Object_Property_References[0].arrayIndex = BACNET_ARRAY_ALL;
+    desc->Object_Property_References[0].deviceIdentifier.type = OBJECT_NONE;
+    /* a reference to another device is not written */
+    desc->Object_Property_References[1].objectIdentifier.type =
+        OBJECT_ANALOG_VALUE;
+    desc->Object_Property_References[1].objectIdentifier.instance = 2;
+    desc->Object_Property_References[1].propertyIdentifier =
+        PROP_PRESENT_VALUE;
+    desc->Object_Property_References[1].arrayIndex = BACNET_ARRAY_ALL;
+    desc->Object_Property_References[1].deviceIdentifier.type = OBJECT_DEVICE;
+    desc->Object_Property_References[1].deviceIdentifier.instance = 4321;
+    desc->obj_prop_ref_cnt = 2;
+    desc->Priority_For_Writing = 8;
+    Write_Property_Count = 0;
+    datetime_set_values(&bdatetime, 2023, 6, 5, 12, 30, 0, 0);
+    seconds = Schedule_Task(&bdatetime);
+    zassert_equal(seconds, 30UL * 60UL, NULL);
+    zassert_equal(Write_Property_Count, 1, NULL);
+    zassert_equal(Write_Property_Data.object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(Write_Property_Data.object_instance, 1, NULL);
+    zassert_equal(Write_Property_Data.priority, 8, NULL);
+    /* nothing is evaluated until the next transition */
+    datetime_set_time(&bdatetime.time, 12, 45, 0, 0);
+    seconds = Schedule_Task(&bdatetime);
+    zassert_equal(seconds, 15UL * 60UL, NULL);
+    zassert_equal(Write_Property_Count, 1, NULL);
+    datetime_set_time(&bdatetime.time, 13, 0, 0, 0);
+    seconds = Schedule_Task(&bdatetime);
+    zassert_equal(seconds, 5UL * 3600UL, NULL);
+    zassert_equal(Write_Property_Count, 2, NULL);
+    /* the clock was set back into the special event */
+    datetime_set_time(&bdatetime.time, 12, 15, 0, 0);
+    seconds = Schedule_Task(&bdatetime);
+    zassert_equal(seconds, 45UL * 60UL, NULL);
+    zassert_equal(Write_Property_Count, 3, NULL);
+    zassert_equal(desc->Present_Value.type.Real, 30.0f, NULL);
+    zassert_equal(Schedule_Task(NULL), 0, NULL);
+}
 /**
  * @}
  */
@@ -61,7 +281,9 @@ ZTEST_SUITE(schedule_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(schedule_tests,
-     ztest_unit_test(testSchedule)
+     ztest_unit_test(testSchedule),
+     ztest_unit_test(testScheduleSpecialEvent),
+     ztest_unit_test(testScheduleTimeline)
      );
 
     ztest_run_test_suite(schedule_tests);
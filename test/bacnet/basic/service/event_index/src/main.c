@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @brief Unit test for the active event index
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/basic/service/h_event_index.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test adding, removing, and ordering of active events
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(event_index_tests, testEventIndex)
+#else
+static void testEventIndex(void)
+#endif
+{
+    BACNET_OBJECT_TYPE object_type = OBJECT_DEVICE;
+    uint32_t object_instance = 0;
+    unsigned object_index = 0;
+    int position;
+    bool status;
+
+    zassert_false(Event_Index_Type_Enabled(OBJECT_ANALOG_INPUT), NULL);
+    status = Event_Index_Update(OBJECT_ANALOG_INPUT, 1, 1, true);
+    zassert_false(status, NULL);
+    Event_Index_Type_Init(OBJECT_ANALOG_INPUT);
+    Event_Index_Type_Init(OBJECT_ANALOG_VALUE);
+    zassert_true(Event_Index_Type_Enabled(OBJECT_ANALOG_INPUT), NULL);
+    zassert_true(Event_Index_Type_Enabled(OBJECT_ANALOG_VALUE), NULL);
+    zassert_false(Event_Index_Type_Enabled(OBJECT_BINARY_INPUT), NULL);
+    zassert_equal(Event_Index_Count(), 0, NULL);
+
+    /* added out of order, kept sorted by type and instance */
+    zassert_true(Event_Index_Update(OBJECT_ANALOG_VALUE, 7, 3, true), NULL);
+    zassert_true(Event_Index_Update(OBJECT_ANALOG_INPUT, 9, 2, true), NULL);
+    zassert_true(Event_Index_Update(OBJECT_ANALOG_INPUT, 4, 0, true), NULL);
+    zassert_true(Event_Index_Update(
+        OBJECT_ANALOG_INPUT, BACNET_MAX_INSTANCE, 5, true), NULL);
+    /* duplicates only refresh the index */
+    zassert_true(Event_Index_Update(OBJECT_ANALOG_INPUT, 4, 1, true), NULL);
+    zassert_equal(Event_Index_Count(), 4, NULL);
+    zassert_true(
+        Event_Index_Item(0, &object_type, &object_instance, &object_index),
+        NULL);
+    zassert_equal(object_type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(object_instance, 4, NULL);
+    zassert_equal(object_index, 1, NULL);
+    zassert_true(
+        Event_Index_Item(2, &object_type, &object_instance, &object_index),
+        NULL);
+    zassert_equal(object_type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(object_instance, BACNET_MAX_INSTANCE, NULL);
+    zassert_true(
+        Event_Index_Item(3, &object_type, &object_instance, &object_index),
+        NULL);
+    zassert_equal(object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(object_instance, 7, NULL);
+    zassert_false(Event_Index_Item(4, NULL, NULL, NULL), NULL);
+
+    /* resume after a last received object identifier */
+    position = Event_Index_Position(OBJECT_ANALOG_INPUT, 0);
+    zassert_equal(position, 0, NULL);
+    position = Event_Index_Position(OBJECT_ANALOG_INPUT, 5);
+    zassert_equal(position, 1, NULL);
+    position = Event_Index_Position(OBJECT_ANALOG_INPUT, 10);
+    zassert_equal(position, 2, NULL);
+    position = Event_Index_Position(OBJECT_ANALOG_VALUE, 0);
+    zassert_equal(position, 3, NULL);
+    position = Event_Index_Position(OBJECT_ANALOG_VALUE, 8);
+    zassert_equal(position, Event_Index_Count(), NULL);
+
+    /* back to normal */
+    zassert_true(Event_Index_Update(OBJECT_ANALOG_INPUT, 9, 2, false), NULL);
+    zassert_true(Event_Index_Update(OBJECT_ANALOG_INPUT, 9, 2, false), NULL);
+    zassert_equal(Event_Index_Count(), 3, NULL);
+
+    /* re-initializing a type only removes that type */
+    Event_Index_Type_Init(OBJECT_ANALOG_INPUT);
+    zassert_equal(Event_Index_Count(), 1, NULL);
+    zassert_true(Event_Index_Item(0, &object_type, NULL, NULL), NULL);
+    zassert_equal(object_type, OBJECT_ANALOG_VALUE, NULL);
+
+    Event_Index_Cleanup();
+    zassert_equal(Event_Index_Count(), 0, NULL);
+    zassert_false(Event_Index_Type_Enabled(OBJECT_ANALOG_VALUE), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(event_index_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(event_index_tests, ztest_unit_test(testEventIndex));
+
+    ztest_run_test_suite(event_index_tests);
+}
+#endif
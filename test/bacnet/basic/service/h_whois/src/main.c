@@ -0,0 +1,248 @@
+/**
+ * @file
+ * @brief Unit test for the Who-Is handler and its I-Am response scheduler
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacaddr.h>
+#include <bacnet/whois.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/services.h>
+#include <bacnet/basic/tsm/tsm.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* stubs for the device object and the I-Am senders */
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+static unsigned I_Am_Broadcast_Count;
+static unsigned I_Am_Unicast_Count;
+
+/* the gateway device, and the devices routed behind it */
+static const uint32_t Test_Device_Instance[] = { 1234, 2001, 3001 };
+#define TEST_DEVICE_COUNT \
+    (sizeof(Test_Device_Instance) / sizeof(Test_Device_Instance[0]))
+static unsigned Test_Device_Index;
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return Test_Device_Instance[Test_Device_Index];
+}
+
+DEVICE_OBJECT_DATA *Get_Routed_Device_Object(int idx)
+{
+    if ((idx >= 0) && ((unsigned)idx < TEST_DEVICE_COUNT)) {
+        Test_Device_Index = (unsigned)idx;
+    }
+
+    return NULL;
+}
+
+bool Routed_Device_GetNext(BACNET_ADDRESS *dest, int *DNET_list, int *cursor)
+{
+    (void)dest;
+    (void)DNET_list;
+    if ((*cursor < 0) || ((unsigned)*cursor >= TEST_DEVICE_COUNT)) {
+        Test_Device_Index = 0;
+        return false;
+    }
+    Test_Device_Index = (unsigned)*cursor;
+    (*cursor)++;
+
+    return true;
+}
+
+void Send_I_Am(uint8_t *buffer)
+{
+    (void)buffer;
+    I_Am_Broadcast_Count++;
+}
+
+void Send_I_Am_Unicast(uint8_t *buffer, BACNET_ADDRESS *src)
+{
+    (void)buffer;
+    (void)src;
+    I_Am_Unicast_Count++;
+}
+
+static void who_is_address(BACNET_ADDRESS *src, uint8_t mac)
+{
+    memset(src, 0, sizeof(BACNET_ADDRESS));
+    src->mac_len = 1;
+    src->mac[0] = mac;
+}
+
+static void who_is_send(bool unicast,
+    BACNET_ADDRESS *src,
+    int32_t low_limit,
+    int32_t high_limit)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int len;
+
+    len = whois_encode_apdu(apdu, low_limit, high_limit);
+    /* skip the PDU type and service choice */
+    if (unicast) {
+        handler_who_is_unicast(&apdu[2], len - 2, src);
+    } else {
+        handler_who_is(&apdu[2], len - 2, src);
+    }
+}
+
+/**
+ * @brief Test the immediate I-Am response, which is the default
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_whois_tests, testWhoIsImmediate)
+#else
+static void testWhoIsImmediate(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    BACNET_WHO_IS_STATISTICS stats;
+
+    handler_who_is_scheduler_init(0, 0);
+    handler_who_is_statistics_reset();
+    I_Am_Broadcast_Count = 0;
+    I_Am_Unicast_Count = 0;
+    who_is_address(&src, 1);
+    who_is_send(false, &src, -1, -1);
+    who_is_send(false, &src, 1000, 2000);
+    who_is_send(false, &src, 2000, 3000);
+    who_is_send(true, &src, -1, -1);
+    zassert_equal(I_Am_Broadcast_Count, 2, NULL);
+    zassert_equal(I_Am_Unicast_Count, 1, NULL);
+    handler_who_is_statistics(&stats);
+    zassert_equal(stats.who_is_received, 4, NULL);
+    zassert_equal(stats.i_am_sent, 3, NULL);
+    zassert_equal(stats.i_am_coalesced, 0, NULL);
+    zassert_equal(stats.who_is_rate_limited, 0, NULL);
+}
+
+/**
+ * @brief Test the delayed, coalesced, and rate limited I-Am response
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_whois_tests, testWhoIsScheduler)
+#else
+static void testWhoIsScheduler(void)
+#endif
+{
+    BACNET_ADDRESS src[3];
+    BACNET_WHO_IS_STATISTICS stats;
+    unsigned i;
+
+    handler_who_is_scheduler_init(1000, 5000);
+    handler_who_is_statistics_reset();
+    I_Am_Broadcast_Count = 0;
+    I_Am_Unicast_Count = 0;
+    for (i = 0; i < 3; i++) {
+        who_is_address(&src[i], i + 1);
+    }
+    /* three workstations ask - one broadcast answers them all */
+    who_is_send(false, &src[0], -1, -1);
+    who_is_send(false, &src[1], -1, -1);
+    who_is_send(false, &src[2], 1000, 2000);
+    /* the same workstation asks again - rate limited */
+    who_is_send(false, &src[0], -1, -1);
+    /* a unicast request from the same workstation is rate limited too */
+    who_is_send(true, &src[0], -1, -1);
+    zassert_equal(I_Am_Broadcast_Count, 0, NULL);
+    zassert_equal(I_Am_Unicast_Count, 0, NULL);
+    /* the window is the longest delay */
+    handler_who_is_timer(1000);
+    zassert_equal(I_Am_Broadcast_Count, 1, NULL);
+    zassert_equal(I_Am_Unicast_Count, 0, NULL);
+    handler_who_is_statistics(&stats);
+    zassert_equal(stats.who_is_received, 5, NULL);
+    zassert_equal(stats.i_am_sent, 1, NULL);
+    zassert_equal(stats.i_am_coalesced, 2, NULL);
+    zassert_equal(stats.who_is_rate_limited, 2, NULL);
+    /* after the source interval, the workstation is answered again */
+    handler_who_is_timer(4000);
+    who_is_send(true, &src[0], -1, -1);
+    handler_who_is_timer(1000);
+    zassert_equal(I_Am_Unicast_Count, 1, NULL);
+    handler_who_is_statistics(&stats);
+    zassert_equal(stats.i_am_sent, 2, NULL);
+    /* a request that no device is in range of does not count against
+       the workstation */
+    handler_who_is_timer(5000);
+    who_is_send(false, &src[1], 5000, 6000);
+    who_is_send(false, &src[1], 1000, 2000);
+    handler_who_is_timer(1000);
+    zassert_equal(I_Am_Broadcast_Count, 2, NULL);
+    handler_who_is_statistics(&stats);
+    zassert_equal(stats.who_is_rate_limited, 2, NULL);
+}
+
+static void who_is_routing_send(BACNET_ADDRESS *src,
+    int32_t low_limit,
+    int32_t high_limit)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int len;
+
+    len = whois_encode_apdu(apdu, low_limit, high_limit);
+    handler_who_is_unicast_for_routing(&apdu[2], len - 2, src);
+}
+
+/**
+ * @brief Test a sliced discovery sweep of the devices behind a gateway,
+ *  where each slice is rate limited only when a device answers it
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_whois_tests, testWhoIsRouting)
+#else
+static void testWhoIsRouting(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    BACNET_WHO_IS_STATISTICS stats;
+
+    handler_who_is_scheduler_init(0, 5000);
+    handler_who_is_statistics_reset();
+    I_Am_Broadcast_Count = 0;
+    I_Am_Unicast_Count = 0;
+    who_is_address(&src, 1);
+    /* slices without a device are not rate limited */
+    who_is_routing_send(&src, 0, 999);
+    who_is_routing_send(&src, 1000, 1999);
+    zassert_equal(I_Am_Unicast_Count, 1, NULL);
+    who_is_routing_send(&src, 4000, 4999);
+    handler_who_is_statistics(&stats);
+    zassert_equal(stats.who_is_rate_limited, 0, NULL);
+    /* every device in range of one request answers it */
+    handler_who_is_timer(5000);
+    who_is_routing_send(&src, 2000, 3999);
+    zassert_equal(I_Am_Unicast_Count, 3, NULL);
+    /* the next matching slice within the source interval is limited */
+    who_is_routing_send(&src, 3000, 3999);
+    zassert_equal(I_Am_Unicast_Count, 3, NULL);
+    handler_who_is_statistics(&stats);
+    zassert_equal(stats.who_is_received, 5, NULL);
+    zassert_equal(stats.who_is_rate_limited, 1, NULL);
+    zassert_equal(stats.i_am_sent, 3, NULL);
+    handler_who_is_scheduler_init(0, 0);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_whois_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(h_whois_tests, ztest_unit_test(testWhoIsImmediate),
+        ztest_unit_test(testWhoIsScheduler),
+        ztest_unit_test(testWhoIsRouting));
+
+    ztest_run_test_suite(h_whois_tests);
+}
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file
+ * @brief Unit test for the stack context of many devices in one process
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdlib.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/service/h_cov.h>
+#include <bacnet/basic/stack_context.h>
+#include <bacnet/basic/tsm/tsm.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Add a COV subscription to the selected stack context
+ * @param object_instance - instance of the monitored Binary Input
+ */
+static void test_cov_subscription_add(uint32_t object_instance)
+{
+    uint8_t record[HANDLER_COV_SNAPSHOT_RECORD_SIZE] = { 0 };
+    BACNET_ADDRESS subscriber = { 0 };
+
+    subscriber.mac_len = 1;
+    subscriber.mac[0] = 1;
+    encode_unsigned16(&record[2], OBJECT_BINARY_INPUT);
+    encode_unsigned32(&record[4], object_instance);
+    encode_unsigned32(&record[8], 1);
+    encode_unsigned32(&record[12], 300);
+    bacnet_address_record_encode(&record[16], &subscriber);
+    zassert_true(handler_cov_snapshot_restore(0, record), NULL);
+}
+
+/**
+ * @brief Encode the COV subscriptions of the selected stack context
+ * @return number of bytes encoded, or 0 if there are no subscriptions
+ */
+static int test_cov_subscriptions_len(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+
+    return handler_cov_encode_subscriptions(apdu, sizeof(apdu));
+}
+
+/**
+ * @brief Test that the TSM and COV state of two stack contexts,
+ *  and of the default context, stay separate when switching
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(stack_context_tests, testStackContextSwitch)
+#else
+static void testStackContextSwitch(void)
+#endif
+{
+    BACNET_STACK_CONTEXT *context_a, *context_b;
+    uint8_t idle_count, invoke_id_a, invoke_id_b;
+    int cov_len_a;
+
+    Device_Init(NULL);
+    handler_cov_init();
+    idle_count = tsm_transaction_idle_count();
+    context_a = stack_context_create(1001);
+    zassert_not_null(context_a, NULL);
+    context_b = stack_context_create(1002);
+    zassert_not_null(context_b, NULL);
+    zassert_equal(stack_context_device_instance(context_a), 1001, NULL);
+    zassert_is_null(stack_context_selected(), NULL);
+    /* TSM: an invoke ID in one context is not used in another */
+    zassert_is_null(stack_context_select(context_a), NULL);
+    zassert_equal(Device_Object_Instance_Number(), 1001, NULL);
+    invoke_id_a = tsm_next_free_invokeID();
+    zassert_not_equal(invoke_id_a, 0, NULL);
+    zassert_false(tsm_invoke_id_free(invoke_id_a), NULL);
+    zassert_equal(stack_context_select(context_b), context_a, NULL);
+    zassert_equal(Device_Object_Instance_Number(), 1002, NULL);
+    zassert_true(tsm_invoke_id_free(invoke_id_a), NULL);
+    invoke_id_b = tsm_next_free_invokeID();
+    zassert_equal(invoke_id_b, invoke_id_a, NULL);
+    tsm_free_invoke_id(invoke_id_b);
+    zassert_true(tsm_invoke_id_free(invoke_id_b), NULL);
+    (void)stack_context_select(context_a);
+    zassert_false(tsm_invoke_id_free(invoke_id_a), NULL);
+    (void)stack_context_select(NULL);
+    zassert_equal(tsm_transaction_idle_count(), idle_count, NULL);
+    zassert_true(tsm_invoke_id_free(invoke_id_a), NULL);
+    /* COV: a subscription in one context is not seen by another */
+    (void)stack_context_select(context_a);
+    test_cov_subscription_add(1);
+    cov_len_a = test_cov_subscriptions_len();
+    zassert_true(cov_len_a > 0, NULL);
+    (void)stack_context_select(context_b);
+    zassert_equal(test_cov_subscriptions_len(), 0, NULL);
+    (void)stack_context_select(NULL);
+    zassert_equal(test_cov_subscriptions_len(), 0, NULL);
+    (void)stack_context_select(context_a);
+    zassert_equal(test_cov_subscriptions_len(), cov_len_a, NULL);
+    /* deleting the selected context selects the default context */
+    stack_context_delete(context_a);
+    zassert_is_null(stack_context_selected(), NULL);
+    zassert_not_equal(Device_Object_Instance_Number(), 1001, NULL);
+    stack_context_delete(context_b);
+}
+
+/**
+ * @brief Test a stack context in memory given by the caller
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(stack_context_tests, testStackContextInit)
+#else
+static void testStackContextInit(void)
+#endif
+{
+    BACNET_STACK_CONTEXT *context;
+    size_t size;
+    void *buffer;
+
+    size = stack_context_size();
+    zassert_true(size > 0, NULL);
+    buffer = malloc(size);
+    zassert_not_null(buffer, NULL);
+    zassert_is_null(stack_context_init(buffer, size - 1, 1), NULL);
+    zassert_is_null(
+        stack_context_init(buffer, size, BACNET_MAX_INSTANCE + 1), NULL);
+    zassert_is_null(stack_context_init(NULL, size, 1), NULL);
+    context = stack_context_init(buffer, size, 1);
+    zassert_equal((void *)context, buffer, NULL);
+    zassert_is_null(stack_context_selected(), NULL);
+    zassert_equal(stack_context_device_instance(context), 1, NULL);
+    zassert_equal(
+        stack_context_device_instance(NULL), BACNET_MAX_INSTANCE + 1, NULL);
+    /* the memory of the caller is not freed */
+    stack_context_delete(context);
+    free(buffer);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(stack_context_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(stack_context_tests,
+        ztest_unit_test(testStackContextSwitch),
+        ztest_unit_test(testStackContextInit));
+
+    ztest_run_test_suite(stack_context_tests);
+}
+#endif
@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @brief Stubs for the datalink and the local date and time
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "bacnet/datetime.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/npdu.h"
+
+void datetime_init(void)
+{
+}
+
+bool datetime_local(
+    BACNET_DATE * bdate,
+    BACNET_TIME * btime,
+    int16_t * utc_offset_minutes,
+    bool * dst_active)
+{
+    return true;
+}
+
+void bip_get_my_address(BACNET_ADDRESS * my_address)
+{
+}
+
+int bip_send_pdu(
+    BACNET_ADDRESS * dest,
+    BACNET_NPDU_DATA * npdu_data,
+    uint8_t * pdu,
+    unsigned pdu_len)
+{
+    return 0;
+}
+
+bool npdu_route_cache_resolve(BACNET_ADDRESS *dest)
+{
+    (void)dest;
+    return false;
+}
+
+void npdu_route_cache_timer(uint16_t seconds)
+{
+    (void)seconds;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @brief Unit test for the fixed size element memory pool
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/mempool.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+struct test_element {
+    char name[13];
+    double value;
+};
+
+/**
+ * @brief Test allocating and freeing elements across several slabs
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(mempool_tests, testMempool)
+#else
+static void testMempool(void)
+#endif
+{
+    MEMPOOL pool = { 0 };
+    struct test_element *element[10] = { 0 };
+    struct test_element *test_element;
+    const unsigned element_count = sizeof(element) / sizeof(element[0]);
+    unsigned i;
+
+    Mempool_Init(&pool, sizeof(struct test_element), 4);
+    zassert_equal(Mempool_Count(&pool), 0, NULL);
+    zassert_equal(Mempool_Size(&pool), 0, NULL);
+    for (i = 0; i < element_count; i++) {
+        element[i] = Mempool_Alloc(&pool);
+        zassert_not_null(element[i], NULL);
+        zassert_equal(element[i]->value, 0.0, NULL);
+        zassert_equal(element[i]->name[0], 0, NULL);
+        zassert_equal((uintptr_t)element[i] % sizeof(double), 0, NULL);
+        element[i]->value = i;
+    }
+    zassert_equal(Mempool_Count(&pool), element_count, NULL);
+    /* three slabs of four elements */
+    zassert_equal(Mempool_Size(&pool), 12, NULL);
+    for (i = 0; i < element_count; i++) {
+        zassert_equal(element[i]->value, (double)i, NULL);
+    }
+    /* a freed element is reused, zero filled, without a new slab */
+    Mempool_Free(&pool, element[3]);
+    zassert_equal(Mempool_Count(&pool), element_count - 1, NULL);
+    test_element = Mempool_Alloc(&pool);
+    zassert_equal(test_element, element[3], NULL);
+    zassert_equal(test_element->value, 0.0, NULL);
+    zassert_equal(Mempool_Size(&pool), 12, NULL);
+    Mempool_Cleanup(&pool);
+    zassert_equal(Mempool_Count(&pool), 0, NULL);
+    zassert_equal(Mempool_Size(&pool), 0, NULL);
+    /* the pool is usable after cleanup */
+    test_element = Mempool_Alloc(&pool);
+    zassert_not_null(test_element, NULL);
+    /* initializing again frees the slabs */
+    Mempool_Init(&pool, sizeof(struct test_element), 2);
+    zassert_equal(Mempool_Count(&pool), 0, NULL);
+    zassert_equal(Mempool_Size(&pool), 0, NULL);
+    test_element = Mempool_Alloc(&pool);
+    zassert_not_null(test_element, NULL);
+    zassert_equal(Mempool_Size(&pool), 2, NULL);
+    Mempool_Cleanup(&pool);
+    /* invalid arguments */
+    zassert_is_null(Mempool_Alloc(NULL), NULL);
+    Mempool_Free(NULL, NULL);
+    Mempool_Free(&pool, NULL);
+    zassert_equal(Mempool_Count(NULL), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(mempool_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(mempool_tests, ztest_unit_test(testMempool));
+
+    ztest_run_test_suite(mempool_tests);
+}
+#endif
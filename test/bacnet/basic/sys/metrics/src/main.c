@@ -0,0 +1,238 @@
+/**
+ * @file
+ * @brief Unit test for the performance counters
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacenum.h>
+#include <bacnet/basic/sys/metrics.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static unsigned long Test_Microseconds;
+static METRICS_DATA Test_Metrics;
+static METRICS_SHARED_DATA Test_Shared;
+
+static unsigned long test_timer(void)
+{
+    return Test_Microseconds;
+}
+
+/**
+ * @brief Test the counters and the gauges
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(metrics_tests, testMetricsCounters)
+#else
+static void testMetricsCounters(void)
+#endif
+{
+    uint8_t apdu[3] = { 0 };
+    unsigned i;
+
+    metrics_init();
+    METRICS_COUNT(METRICS_TSM_RETRIES);
+    METRICS_COUNT(METRICS_TSM_RETRIES);
+    METRICS_ADD(METRICS_DATALINK_RX_BYTES, 480);
+    METRICS_ADD(METRICS_DATALINK_RX_BYTES, 20);
+    metrics_counter_add(METRICS_COUNTER_MAX, 1);
+    METRICS_GAUGE(METRICS_GAUGE_COV_QUEUE, 7);
+    METRICS_GAUGE(METRICS_GAUGE_COV_QUEUE, 3);
+    metrics_gauge_set(METRICS_GAUGE_MAX, 1);
+    metrics_snapshot(&Test_Metrics);
+    zassert_equal(Test_Metrics.counter[METRICS_TSM_RETRIES], 2, NULL);
+    zassert_equal(Test_Metrics.counter[METRICS_DATALINK_RX_BYTES], 500, NULL);
+    zassert_equal(Test_Metrics.counter[METRICS_TSM_TIMEOUTS], 0, NULL);
+    zassert_equal(Test_Metrics.gauge[METRICS_GAUGE_COV_QUEUE].value, 3, NULL);
+    zassert_equal(Test_Metrics.gauge[METRICS_GAUGE_COV_QUEUE].peak, 7, NULL);
+    metrics_reset();
+    metrics_snapshot(&Test_Metrics);
+    zassert_equal(Test_Metrics.counter[METRICS_TSM_RETRIES], 0, NULL);
+    zassert_equal(Test_Metrics.gauge[METRICS_GAUGE_COV_QUEUE].peak, 0, NULL);
+    /* every counter and gauge has a name */
+    for (i = 0; i < METRICS_COUNTER_MAX; i++) {
+        zassert_not_null(metrics_counter_name(i), NULL);
+    }
+    zassert_is_null(metrics_counter_name(METRICS_COUNTER_MAX), NULL);
+    zassert_equal(
+        strcmp(metrics_counter_name(METRICS_TSM_RETRIES), "tsm-retries"), 0,
+        NULL);
+    for (i = 0; i < METRICS_GAUGE_MAX; i++) {
+        zassert_not_null(metrics_gauge_name(i), NULL);
+    }
+    zassert_is_null(metrics_gauge_name(METRICS_GAUGE_MAX), NULL);
+    /* only the Error, Reject, and Abort PDUs that were sent are counted */
+    apdu[0] = PDU_TYPE_ERROR;
+    METRICS_APDU_SENT(apdu, 5);
+    apdu[0] = PDU_TYPE_REJECT;
+    METRICS_APDU_SENT(apdu, 3);
+    apdu[0] = PDU_TYPE_ABORT | 1;
+    METRICS_APDU_SENT(apdu, 3);
+    METRICS_APDU_SENT(apdu, 0);
+    METRICS_APDU_SENT(NULL, 3);
+    apdu[0] = PDU_TYPE_SIMPLE_ACK;
+    METRICS_APDU_SENT(apdu, 3);
+    metrics_snapshot(&Test_Metrics);
+    zassert_equal(Test_Metrics.counter[METRICS_APDU_ERROR_TX], 1, NULL);
+    zassert_equal(Test_Metrics.counter[METRICS_APDU_REJECT_TX], 1, NULL);
+    zassert_equal(Test_Metrics.counter[METRICS_APDU_ABORT_TX], 1, NULL);
+}
+
+/**
+ * @brief Test the service requests and the handler latency histogram
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(metrics_tests, testMetricsServices)
+#else
+static void testMetricsServices(void)
+#endif
+{
+    METRICS_SERVICE_DATA *data;
+    unsigned long timestamp;
+
+    metrics_init();
+    /* without a timer, only the requests are counted */
+    metrics_timer_set(NULL);
+    zassert_equal(metrics_timestamp(), 0, NULL);
+    metrics_service_record(true, SERVICE_CONFIRMED_READ_PROPERTY, 0);
+    metrics_snapshot(&Test_Metrics);
+    data = &Test_Metrics.confirmed[SERVICE_CONFIRMED_READ_PROPERTY];
+    zassert_equal(data->requests, 1, NULL);
+    zassert_equal(data->latency_histogram[0], 0, NULL);
+    /* latency of 3, 4, 100, and 20000 microseconds */
+    metrics_timer_set(test_timer);
+    Test_Microseconds = 1000;
+    timestamp = metrics_timestamp();
+    zassert_equal(timestamp, 1000, NULL);
+    Test_Microseconds += 3;
+    metrics_service_record(true, SERVICE_CONFIRMED_READ_PROPERTY, timestamp);
+    timestamp = metrics_timestamp();
+    Test_Microseconds += 4;
+    metrics_service_record(true, SERVICE_CONFIRMED_READ_PROPERTY, timestamp);
+    timestamp = metrics_timestamp();
+    Test_Microseconds += 100;
+    metrics_service_record(true, SERVICE_CONFIRMED_READ_PROPERTY, timestamp);
+    timestamp = metrics_timestamp();
+    Test_Microseconds += 20000;
+    metrics_service_record(false, SERVICE_UNCONFIRMED_WHO_IS, timestamp);
+    /* not a service */
+    metrics_service_record(true, MAX_BACNET_CONFIRMED_SERVICE, timestamp);
+    metrics_service_record(false, MAX_BACNET_UNCONFIRMED_SERVICE, timestamp);
+    metrics_snapshot(&Test_Metrics);
+    data = &Test_Metrics.confirmed[SERVICE_CONFIRMED_READ_PROPERTY];
+    zassert_equal(data->requests, 4, NULL);
+    zassert_equal(data->latency_max, 100, NULL);
+    zassert_equal(data->latency_histogram[0], 1, NULL);
+    zassert_equal(data->latency_histogram[1], 1, NULL);
+    zassert_equal(data->latency_histogram[3], 1, NULL);
+    data = &Test_Metrics.unconfirmed[SERVICE_UNCONFIRMED_WHO_IS];
+    zassert_equal(data->requests, 1, NULL);
+    zassert_equal(data->latency_max, 20000, NULL);
+    zassert_equal(data->latency_histogram[METRICS_HISTOGRAM_SIZE - 1], 1,
+        NULL);
+    metrics_timer_set(NULL);
+}
+
+/**
+ * @brief Test adding together the counters of the threads
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(metrics_tests, testMetricsThreads)
+#else
+static void testMetricsThreads(void)
+#endif
+{
+    static METRICS_DATA thread_metrics[METRICS_THREADS_MAX + 1];
+    unsigned i;
+
+    metrics_init();
+    METRICS_COUNT(METRICS_COV_NOTIFICATIONS);
+    METRICS_GAUGE(METRICS_GAUGE_COV_QUEUE, 5);
+    metrics_service_record(false, SERVICE_UNCONFIRMED_I_AM, 0);
+    zassert_false(metrics_thread_register(NULL), NULL);
+    for (i = 0; i < METRICS_THREADS_MAX; i++) {
+        zassert_true(metrics_thread_register(&thread_metrics[i]), NULL);
+        METRICS_COUNT(METRICS_COV_NOTIFICATIONS);
+        METRICS_GAUGE(METRICS_GAUGE_COV_QUEUE, i + 1);
+        metrics_service_record(false, SERVICE_UNCONFIRMED_I_AM, 0);
+    }
+    zassert_false(metrics_thread_register(&thread_metrics[i]), NULL);
+    /* the counters of the last registered thread */
+    zassert_equal(
+        thread_metrics[0].counter[METRICS_COV_NOTIFICATIONS], 1, NULL);
+    metrics_snapshot(&Test_Metrics);
+    zassert_equal(Test_Metrics.counter[METRICS_COV_NOTIFICATIONS],
+        METRICS_THREADS_MAX + 1, NULL);
+    zassert_equal(
+        Test_Metrics.unconfirmed[SERVICE_UNCONFIRMED_I_AM].requests,
+        METRICS_THREADS_MAX + 1, NULL);
+    /* the values of the gauges are added, and the largest peak is kept */
+    zassert_equal(Test_Metrics.gauge[METRICS_GAUGE_COV_QUEUE].value,
+        5 + ((METRICS_THREADS_MAX * (METRICS_THREADS_MAX + 1)) / 2), NULL);
+    zassert_equal(Test_Metrics.gauge[METRICS_GAUGE_COV_QUEUE].peak,
+        METRICS_THREADS_MAX, NULL);
+    metrics_reset();
+    zassert_equal(
+        thread_metrics[0].counter[METRICS_COV_NOTIFICATIONS], 0, NULL);
+    metrics_init();
+}
+
+/**
+ * @brief Test the shared snapshot
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(metrics_tests, testMetricsShared)
+#else
+static void testMetricsShared(void)
+#endif
+{
+    uint32_t sequence;
+
+    metrics_init();
+    zassert_false(metrics_shared_read(&Test_Shared, &Test_Metrics), NULL);
+    metrics_shared_init(&Test_Shared);
+    METRICS_ADD(METRICS_DATALINK_TX_PACKETS, 42);
+    metrics_shared_update(&Test_Shared);
+    zassert_equal(Test_Shared.sequence, 2, NULL);
+    memset(&Test_Metrics, 0, sizeof(Test_Metrics));
+    zassert_true(metrics_shared_read(&Test_Shared, &Test_Metrics), NULL);
+    zassert_equal(Test_Metrics.counter[METRICS_DATALINK_TX_PACKETS], 42, NULL);
+    /* while being updated */
+    sequence = Test_Shared.sequence;
+    Test_Shared.sequence = sequence + 1;
+    zassert_false(metrics_shared_read(&Test_Shared, &Test_Metrics), NULL);
+    Test_Shared.sequence = sequence;
+    /* not the same layout */
+    Test_Shared.size--;
+    zassert_false(metrics_shared_read(&Test_Shared, &Test_Metrics), NULL);
+    metrics_shared_init(&Test_Shared);
+    Test_Shared.version++;
+    zassert_false(metrics_shared_read(&Test_Shared, &Test_Metrics), NULL);
+    metrics_shared_update(NULL);
+    zassert_false(metrics_shared_read(NULL, &Test_Metrics), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(metrics_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(metrics_tests,
+        ztest_unit_test(testMetricsCounters),
+        ztest_unit_test(testMetricsServices),
+        ztest_unit_test(testMetricsThreads),
+        ztest_unit_test(testMetricsShared));
+
+    ztest_run_test_suite(metrics_tests);
+}
+#endif
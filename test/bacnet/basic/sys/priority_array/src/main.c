@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @brief Unit test for the priority-array slots of commandable objects
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/basic/sys/priority_array.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test the find-first-set of the slot bits
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(priority_array_tests, testPriorityArrayFirstSet)
+#else
+static void testPriorityArrayFirstSet(void)
+#endif
+{
+    unsigned i;
+
+    zassert_equal(priority_array_first_set(0), 0, NULL);
+    for (i = 0; i < 16; i++) {
+        zassert_equal(priority_array_first_set(1U << i), i + 1, NULL);
+        zassert_equal(priority_array_first_set(0x8000U | (1U << i)), i + 1,
+            NULL);
+    }
+    zassert_equal(priority_array_first_set(0xFFFF), 1, NULL);
+    zassert_equal(priority_array_first_set(0x0F00), 9, NULL);
+}
+
+/**
+ * @brief Test commanding and relinquishing the slots
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(priority_array_tests, testPriorityArray)
+#else
+static void testPriorityArray(void)
+#endif
+{
+    BACNET_PRIORITY_ARRAY pa;
+    unsigned priority;
+
+    priority_array_init(&pa);
+    zassert_equal(priority_array_active(&pa), 0, NULL);
+    for (priority = 1; priority <= 16; priority++) {
+        zassert_false(priority_array_commanded(&pa, priority), NULL);
+    }
+    /* the first command is always the active priority */
+    zassert_true(priority_array_command(&pa, 8), NULL);
+    zassert_equal(priority_array_active(&pa), 8, NULL);
+    zassert_true(priority_array_commanded(&pa, 8), NULL);
+    /* a lower priority does not change the effective value */
+    zassert_false(priority_array_command(&pa, 16), NULL);
+    zassert_equal(priority_array_active(&pa), 8, NULL);
+    /* a command at the active priority changes the effective value */
+    zassert_true(priority_array_command(&pa, 8), NULL);
+    /* a higher priority changes the effective value */
+    zassert_true(priority_array_command(&pa, 1), NULL);
+    zassert_equal(priority_array_active(&pa), 1, NULL);
+    /* relinquish a slot that is not the active priority */
+    zassert_false(priority_array_relinquish(&pa, 8), NULL);
+    zassert_false(priority_array_commanded(&pa, 8), NULL);
+    zassert_equal(priority_array_active(&pa), 1, NULL);
+    /* relinquish a slot that is already relinquished */
+    zassert_false(priority_array_relinquish(&pa, 8), NULL);
+    /* relinquish the active priority */
+    zassert_true(priority_array_relinquish(&pa, 1), NULL);
+    zassert_equal(priority_array_active(&pa), 16, NULL);
+    zassert_true(priority_array_relinquish(&pa, 16), NULL);
+    zassert_equal(priority_array_active(&pa), 0, NULL);
+    /* invalid arguments */
+    zassert_false(priority_array_command(&pa, 0), NULL);
+    zassert_false(priority_array_command(&pa, 17), NULL);
+    zassert_false(priority_array_relinquish(&pa, 0), NULL);
+    zassert_false(priority_array_relinquish(&pa, 17), NULL);
+    zassert_false(priority_array_commanded(&pa, 0), NULL);
+    zassert_false(priority_array_commanded(&pa, 17), NULL);
+    zassert_equal(priority_array_active(&pa), 0, NULL);
+    zassert_false(priority_array_command(NULL, 1), NULL);
+    zassert_false(priority_array_relinquish(NULL, 1), NULL);
+    zassert_false(priority_array_commanded(NULL, 1), NULL);
+    zassert_equal(priority_array_active(NULL), 0, NULL);
+}
+
+/**
+ * @brief Test the encoding of the Priority_Array property of REAL values
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(priority_array_tests, testPriorityArrayRealEncode)
+#else
+static void testPriorityArrayRealEncode(void)
+#endif
+{
+    BACNET_PRIORITY_ARRAY pa;
+    float value[16] = { 0.0f };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    float real_value = 0.0f;
+    int len, test_len;
+    unsigned priority;
+
+    priority_array_init(&pa);
+    for (priority = 1; priority <= 16; priority++) {
+        value[priority - 1] = (float)priority * 1.5f;
+    }
+    priority_array_command(&pa, 1);
+    priority_array_command(&pa, 2);
+    priority_array_command(&pa, 3);
+    priority_array_command(&pa, 8);
+    priority_array_command(&pa, 16);
+    /* the same encoding as one element at a time */
+    test_len = 0;
+    for (priority = 1; priority <= 16; priority++) {
+        if (priority_array_commanded(&pa, priority)) {
+            test_len += encode_application_real(
+                &test_apdu[test_len], value[priority - 1]);
+        } else {
+            test_len += encode_application_null(&test_apdu[test_len]);
+        }
+    }
+    len = priority_array_real_encode(
+        &pa, value, BACNET_ARRAY_ALL, NULL, sizeof(apdu));
+    zassert_equal(len, test_len, NULL);
+    len = priority_array_real_encode(
+        &pa, value, BACNET_ARRAY_ALL, apdu, sizeof(apdu));
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    len = priority_array_real_encode(
+        &pa, value, BACNET_ARRAY_ALL, apdu, test_len - 1);
+    zassert_equal(len, BACNET_STATUS_ABORT, NULL);
+    /* the array size */
+    len = priority_array_real_encode(&pa, value, 0, apdu, sizeof(apdu));
+    zassert_true(len > 0, NULL);
+    len = bacnet_unsigned_application_decode(apdu, len, &unsigned_value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(unsigned_value, 16, NULL);
+    /* one element */
+    len = priority_array_real_encode(&pa, value, 8, apdu, sizeof(apdu));
+    zassert_equal(len, 5, NULL);
+    len = bacnet_real_application_array_decode(apdu, 5, &real_value, 1);
+    zassert_equal(len, 5, NULL);
+    zassert_equal(real_value, value[7], NULL);
+    len = priority_array_real_encode(&pa, value, 9, apdu, sizeof(apdu));
+    zassert_equal(len, 1, NULL);
+    len = priority_array_real_encode(&pa, value, 17, apdu, sizeof(apdu));
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    len = priority_array_real_encode(&pa, value, 8, apdu, 4);
+    zassert_equal(len, BACNET_STATUS_ABORT, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(priority_array_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(priority_array_tests,
+        ztest_unit_test(testPriorityArrayFirstSet),
+        ztest_unit_test(testPriorityArray),
+        ztest_unit_test(testPriorityArrayRealEncode));
+
+    ztest_run_test_suite(priority_array_tests);
+}
+#endif
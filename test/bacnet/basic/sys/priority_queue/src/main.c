@@ -0,0 +1,241 @@
+/**
+ * @file
+ * @brief Unit test for the transmit queue with message priority levels
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacenum.h>
+#include <bacnet/basic/sys/priority_queue.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* elements in each level - must be a power of 2 */
+#define TEST_QUEUE_COUNT 4
+
+struct test_element {
+    PRIORITY_QUEUE_ELEMENT header;
+    unsigned id;
+};
+
+static struct test_element Test_Buffer[PRIORITY_QUEUE_LEVELS *
+    TEST_QUEUE_COUNT];
+
+static bool test_put(PRIORITY_QUEUE *q,
+    unsigned priority,
+    unsigned id,
+    unsigned long now)
+{
+    struct test_element *element;
+
+    element = priority_queue_data_peek(q, priority);
+    if (!element) {
+        return false;
+    }
+    element->id = id;
+
+    return priority_queue_data_put(q, priority, element, now);
+}
+
+static unsigned test_get(PRIORITY_QUEUE *q, unsigned long now)
+{
+    struct test_element *element;
+    unsigned id;
+
+    element = priority_queue_peek(q, NULL);
+    zassert_not_null(element, NULL);
+    id = element->id;
+    zassert_true(priority_queue_pop(q, now), NULL);
+
+    return id;
+}
+
+/**
+ * @brief Test the order of the levels, and the full and empty queue
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(priority_queue_tests, testPriorityQueue)
+#else
+static void testPriorityQueue(void)
+#endif
+{
+    PRIORITY_QUEUE q;
+    PRIORITY_QUEUE_STATISTICS stats;
+    unsigned priority = 0;
+    unsigned i;
+
+    priority_queue_init(
+        &q, Test_Buffer, sizeof(struct test_element), TEST_QUEUE_COUNT);
+    zassert_true(priority_queue_empty(&q), NULL);
+    zassert_equal(priority_queue_count(&q), 0, NULL);
+    zassert_is_null(priority_queue_peek(&q, &priority), NULL);
+    zassert_false(priority_queue_pop(&q, 0), NULL);
+    /* highest priority first, and first in first out within a level */
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_NORMAL, 1, 0), NULL);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_LIFE_SAFETY, 2, 0), NULL);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_URGENT, 3, 0), NULL);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_NORMAL, 4, 0), NULL);
+    zassert_true(
+        test_put(&q, MESSAGE_PRIORITY_CRITICAL_EQUIPMENT, 5, 0), NULL);
+    zassert_false(priority_queue_empty(&q), NULL);
+    zassert_equal(priority_queue_count(&q), 5, NULL);
+    zassert_not_null(priority_queue_peek(&q, &priority), NULL);
+    zassert_equal(priority, MESSAGE_PRIORITY_LIFE_SAFETY, NULL);
+    zassert_equal(test_get(&q, 10), 2, NULL);
+    zassert_equal(test_get(&q, 20), 5, NULL);
+    zassert_equal(test_get(&q, 30), 3, NULL);
+    zassert_equal(test_get(&q, 40), 1, NULL);
+    zassert_equal(test_get(&q, 50), 4, NULL);
+    zassert_true(priority_queue_empty(&q), NULL);
+    /* the counters of a level */
+    zassert_true(
+        priority_queue_statistics(&q, MESSAGE_PRIORITY_NORMAL, &stats), NULL);
+    zassert_equal(stats.enqueue_counter, 2, NULL);
+    zassert_equal(stats.dequeue_counter, 2, NULL);
+    zassert_equal(stats.dropped_counter, 0, NULL);
+    zassert_equal(stats.depth, 0, NULL);
+    zassert_equal(stats.depth_peak, 2, NULL);
+    zassert_equal(stats.wait_total, 90, NULL);
+    zassert_equal(stats.wait_max, 50, NULL);
+    zassert_false(priority_queue_statistics(&q, 4, &stats), NULL);
+    /* a full level drops, without changing the other levels */
+    for (i = 0; i < TEST_QUEUE_COUNT; i++) {
+        zassert_true(test_put(&q, MESSAGE_PRIORITY_URGENT, i, 0), NULL);
+    }
+    zassert_false(test_put(&q, MESSAGE_PRIORITY_URGENT, i, 0), NULL);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_NORMAL, i, 0), NULL);
+    zassert_true(
+        priority_queue_statistics(&q, MESSAGE_PRIORITY_URGENT, &stats), NULL);
+    zassert_equal(stats.dropped_counter, 1, NULL);
+    zassert_equal(stats.depth, TEST_QUEUE_COUNT, NULL);
+    priority_queue_statistics_reset(&q);
+    zassert_true(
+        priority_queue_statistics(&q, MESSAGE_PRIORITY_URGENT, &stats), NULL);
+    zassert_equal(stats.dropped_counter, 0, NULL);
+    zassert_equal(stats.depth, TEST_QUEUE_COUNT, NULL);
+    /* invalid priority */
+    zassert_is_null(priority_queue_data_peek(&q, 4), NULL);
+    zassert_false(priority_queue_data_put(&q, 4, &Test_Buffer[0], 0), NULL);
+}
+
+/**
+ * @brief Test that a lower level is sent after a burst of a higher level
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(priority_queue_tests, testPriorityQueueStarvation)
+#else
+static void testPriorityQueueStarvation(void)
+#endif
+{
+    PRIORITY_QUEUE q;
+    PRIORITY_QUEUE_STATISTICS stats;
+    unsigned i;
+
+    priority_queue_init(
+        &q, Test_Buffer, sizeof(struct test_element), TEST_QUEUE_COUNT);
+    priority_queue_burst_set(&q, 2);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_NORMAL, 100, 5), NULL);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_URGENT, 200, 3), NULL);
+    for (i = 0; i < TEST_QUEUE_COUNT; i++) {
+        zassert_true(test_put(&q, MESSAGE_PRIORITY_LIFE_SAFETY, i, 10), NULL);
+    }
+    zassert_equal(test_get(&q, 10), 0, NULL);
+    zassert_equal(test_get(&q, 10), 1, NULL);
+    /* the oldest waiting element of the lower levels */
+    zassert_equal(test_get(&q, 10), 200, NULL);
+    zassert_equal(test_get(&q, 10), 2, NULL);
+    zassert_equal(test_get(&q, 10), 3, NULL);
+    /* no burst once the higher level is empty */
+    zassert_equal(test_get(&q, 10), 100, NULL);
+    zassert_true(priority_queue_empty(&q), NULL);
+    zassert_true(
+        priority_queue_statistics(&q, MESSAGE_PRIORITY_URGENT, &stats), NULL);
+    zassert_equal(stats.promoted_counter, 1, NULL);
+    zassert_equal(stats.wait_max, 7, NULL);
+    zassert_true(
+        priority_queue_statistics(&q, MESSAGE_PRIORITY_NORMAL, &stats), NULL);
+    zassert_equal(stats.promoted_counter, 0, NULL);
+    /* strict priority */
+    priority_queue_burst_set(&q, 0);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_NORMAL, 100, 0), NULL);
+    for (i = 0; i < TEST_QUEUE_COUNT; i++) {
+        zassert_true(test_put(&q, MESSAGE_PRIORITY_LIFE_SAFETY, i, 0), NULL);
+    }
+    for (i = 0; i < TEST_QUEUE_COUNT; i++) {
+        zassert_equal(test_get(&q, 0), i, NULL);
+    }
+    zassert_equal(test_get(&q, 0), 100, NULL);
+}
+
+/**
+ * @brief Test the congestion watermarks, the drop priority, and the
+ *  wait time histogram
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(priority_queue_tests, testPriorityQueueCongestion)
+#else
+static void testPriorityQueueCongestion(void)
+#endif
+{
+    PRIORITY_QUEUE q;
+    PRIORITY_QUEUE_STATISTICS stats;
+
+    priority_queue_init(
+        &q, Test_Buffer, sizeof(struct test_element), TEST_QUEUE_COUNT);
+    zassert_false(priority_queue_congested(&q), NULL);
+    priority_queue_watermark_set(&q, 3, 1, MESSAGE_PRIORITY_URGENT);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_NORMAL, 1, 0), NULL);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_NORMAL, 2, 0), NULL);
+    zassert_false(priority_queue_congested(&q), NULL);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_URGENT, 3, 0), NULL);
+    zassert_true(priority_queue_congested(&q), NULL);
+    /* while congested, normal priority is dropped, not the others */
+    zassert_false(test_put(&q, MESSAGE_PRIORITY_NORMAL, 4, 0), NULL);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_URGENT, 5, 0), NULL);
+    zassert_true(
+        priority_queue_statistics(&q, MESSAGE_PRIORITY_NORMAL, &stats), NULL);
+    zassert_equal(stats.dropped_counter, 1, NULL);
+    zassert_equal(stats.depth, 2, NULL);
+    zassert_equal(test_get(&q, 0), 3, NULL);
+    zassert_equal(test_get(&q, 2), 5, NULL);
+    zassert_true(priority_queue_congested(&q), NULL);
+    /* down to the low watermark */
+    zassert_equal(test_get(&q, 10), 1, NULL);
+    zassert_false(priority_queue_congested(&q), NULL);
+    zassert_true(test_put(&q, MESSAGE_PRIORITY_NORMAL, 6, 10), NULL);
+    zassert_equal(test_get(&q, 5000), 2, NULL);
+    zassert_equal(test_get(&q, 5000), 6, NULL);
+    /* wait times of 10, 5000, and 4990 milliseconds */
+    zassert_true(
+        priority_queue_statistics(&q, MESSAGE_PRIORITY_NORMAL, &stats), NULL);
+    zassert_equal(stats.wait_histogram[2], 1, NULL);
+    zassert_equal(stats.wait_histogram[PRIORITY_QUEUE_HISTOGRAM_SIZE - 1],
+        2, NULL);
+    /* wait times of 0 and 2 milliseconds */
+    zassert_true(
+        priority_queue_statistics(&q, MESSAGE_PRIORITY_URGENT, &stats), NULL);
+    zassert_equal(stats.wait_histogram[0], 1, NULL);
+    zassert_equal(stats.wait_histogram[1], 1, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(priority_queue_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(priority_queue_tests,
+        ztest_unit_test(testPriorityQueue),
+        ztest_unit_test(testPriorityQueueStarvation),
+        ztest_unit_test(testPriorityQueueCongestion));
+
+    ztest_run_test_suite(priority_queue_tests);
+}
+#endif
@@ -0,0 +1,260 @@
+/**
+ * @file
+ * @brief Unit test for the warm start snapshots
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacint.h>
+#include <bacnet/basic/sys/snapshot.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_ENTRIES 10
+#define TEST_RECORD_SIZE 6
+
+/* a table where the entries with a non-zero value are saved */
+static uint32_t Test_Value[TEST_ENTRIES];
+static uint32_t Test_Restored[TEST_ENTRIES];
+static unsigned Test_Restored_Count;
+static uint8_t Test_Buffer[512];
+
+static uint32_t test_count(void)
+{
+    return TEST_ENTRIES;
+}
+
+static bool test_encode(uint32_t index, uint8_t *record)
+{
+    if ((index >= TEST_ENTRIES) || (Test_Value[index] == 0)) {
+        return false;
+    }
+    encode_unsigned16(&record[0], (uint16_t)index);
+    encode_unsigned32(&record[2], Test_Value[index]);
+
+    return true;
+}
+
+static bool test_restore(uint32_t index, uint8_t *record)
+{
+    uint16_t entry = 0;
+
+    (void)index;
+    decode_unsigned16(&record[0], &entry);
+    if (entry >= TEST_ENTRIES) {
+        return false;
+    }
+    decode_unsigned32(&record[2], &Test_Restored[entry]);
+    Test_Restored_Count++;
+
+    return true;
+}
+
+static uint32_t test_other_count(void)
+{
+    return 3;
+}
+
+static bool test_other_encode(uint32_t index, uint8_t *record)
+{
+    record[0] = (uint8_t)index;
+
+    return true;
+}
+
+static bool test_other_restore(uint32_t index, uint8_t *record)
+{
+    return record[0] == index;
+}
+
+static void test_setup(void)
+{
+    unsigned i;
+
+    snapshot_init();
+    memset(Test_Value, 0, sizeof(Test_Value));
+    memset(Test_Restored, 0, sizeof(Test_Restored));
+    Test_Restored_Count = 0;
+    for (i = 0; i < TEST_ENTRIES; i += 2) {
+        Test_Value[i] = 1000 + i;
+    }
+    zassert_true(snapshot_section_register(1, 1, TEST_RECORD_SIZE,
+                     test_count, test_encode, test_restore),
+        NULL);
+    zassert_true(snapshot_section_register(
+                     2, 1, 1, test_other_count, test_other_encode,
+                     test_other_restore),
+        NULL);
+}
+
+/**
+ * @brief Test the CRC-32 against the check value of the algorithm
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(snapshot_tests, testSnapshotCRC32)
+#else
+static void testSnapshotCRC32(void)
+#endif
+{
+    uint8_t data[] = "123456789";
+    uint32_t crc;
+
+    zassert_equal(snapshot_crc32(0, data, 9), 0xCBF43926UL, NULL);
+    crc = snapshot_crc32(0, data, 4);
+    zassert_equal(snapshot_crc32(crc, &data[4], 5), 0xCBF43926UL, NULL);
+    zassert_equal(snapshot_crc32(0, data, 0), 0, NULL);
+}
+
+/**
+ * @brief Test encoding, finding, and restoring the sections
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(snapshot_tests, testSnapshot)
+#else
+static void testSnapshot(void)
+#endif
+{
+    SNAPSHOT_SECTION section = { 0 };
+    size_t size, length;
+    unsigned i;
+
+    test_setup();
+    size = snapshot_size();
+    zassert_equal(size,
+        SNAPSHOT_HEADER_SIZE + (2 * SNAPSHOT_SECTION_HEADER_SIZE) + 60 + 4,
+        NULL);
+    length = snapshot_encode(Test_Buffer, sizeof(Test_Buffer));
+    /* only the saved entries, with every section 4 byte aligned */
+    zassert_equal(length,
+        SNAPSHOT_HEADER_SIZE + (2 * SNAPSHOT_SECTION_HEADER_SIZE) + 32 + 4,
+        NULL);
+    zassert_true(snapshot_valid(Test_Buffer, length), NULL);
+    zassert_false(snapshot_valid(Test_Buffer, length - 1), NULL);
+    zassert_true(snapshot_section_find(Test_Buffer, length, 1, &section),
+        NULL);
+    zassert_equal(section.version, 1, NULL);
+    zassert_equal(section.record_size, TEST_RECORD_SIZE, NULL);
+    zassert_equal(section.record_count, 5, NULL);
+    zassert_equal(section.records,
+        &Test_Buffer[SNAPSHOT_HEADER_SIZE + SNAPSHOT_SECTION_HEADER_SIZE],
+        NULL);
+    zassert_true(snapshot_section_find(Test_Buffer, length, 2, &section),
+        NULL);
+    zassert_equal(section.record_count, 3, NULL);
+    zassert_false(snapshot_section_find(Test_Buffer, length, 3, &section),
+        NULL);
+    /* restore */
+    zassert_equal(snapshot_restore(Test_Buffer, length), 8, NULL);
+    zassert_equal(Test_Restored_Count, 5, NULL);
+    for (i = 0; i < TEST_ENTRIES; i++) {
+        zassert_equal(Test_Restored[i], Test_Value[i], NULL);
+    }
+    /* a section with a bad CRC is skipped, and the others are restored */
+    Test_Buffer[SNAPSHOT_HEADER_SIZE + SNAPSHOT_SECTION_HEADER_SIZE + 2] ^=
+        0x01;
+    zassert_false(snapshot_valid(Test_Buffer, length), NULL);
+    zassert_false(snapshot_section_find(Test_Buffer, length, 1, &section),
+        NULL);
+    Test_Restored_Count = 0;
+    zassert_equal(snapshot_restore(Test_Buffer, length), 3, NULL);
+    zassert_equal(Test_Restored_Count, 0, NULL);
+    /* a section of another version is skipped */
+    zassert_true(snapshot_section_register(1, 2, TEST_RECORD_SIZE,
+                     test_count, test_encode, test_restore),
+        NULL);
+    length = snapshot_encode(Test_Buffer, sizeof(Test_Buffer));
+    zassert_true(snapshot_section_register(1, 1, TEST_RECORD_SIZE,
+                     test_count, test_encode, test_restore),
+        NULL);
+    zassert_equal(snapshot_restore(Test_Buffer, length), 3, NULL);
+    /* not a snapshot */
+    Test_Buffer[0] = 'X';
+    zassert_false(snapshot_valid(Test_Buffer, length), NULL);
+    zassert_equal(snapshot_restore(Test_Buffer, length), 0, NULL);
+    /* entries that do not fit are skipped */
+    length = snapshot_encode(Test_Buffer,
+        SNAPSHOT_HEADER_SIZE + SNAPSHOT_SECTION_HEADER_SIZE + 12);
+    zassert_true(snapshot_valid(Test_Buffer, length), NULL);
+    zassert_true(snapshot_section_find(Test_Buffer, length, 1, &section),
+        NULL);
+    zassert_equal(section.record_count, 2, NULL);
+    zassert_false(snapshot_section_find(Test_Buffer, length, 2, &section),
+        NULL);
+    zassert_equal(snapshot_encode(Test_Buffer, 4), 0, NULL);
+    /* invalid registrations */
+    zassert_false(snapshot_section_register(
+                      3, 1, 0, test_count, test_encode, test_restore),
+        NULL);
+    zassert_false(snapshot_section_register(
+                      3, 1, 1, NULL, test_encode, test_restore),
+        NULL);
+    for (i = 3; i <= SNAPSHOT_SECTIONS_MAX; i++) {
+        zassert_true(snapshot_section_register(
+                         i, 1, 1, test_count, test_encode, test_restore),
+            NULL);
+    }
+    zassert_false(snapshot_section_register(
+                      i, 1, 1, test_count, test_encode, test_restore),
+        NULL);
+}
+
+/**
+ * @brief Test writing and loading the snapshot file
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(snapshot_tests, testSnapshotFile)
+#else
+static void testSnapshotFile(void)
+#endif
+{
+    const char *filename = "test_snapshot.bin";
+    unsigned i;
+
+    test_setup();
+    (void)remove(filename);
+    zassert_true(snapshot_file_save(filename), NULL);
+    zassert_equal(snapshot_file_load(filename), 8, NULL);
+    for (i = 0; i < TEST_ENTRIES; i++) {
+        zassert_equal(Test_Restored[i], Test_Value[i], NULL);
+    }
+    zassert_equal(snapshot_file_load("test_snapshot_missing.bin"), 0, NULL);
+    /* the background pass encodes one section for each call */
+    Test_Value[1] = 1;
+    snapshot_file_timer(filename, SNAPSHOT_FILE_INTERVAL - 1);
+    snapshot_file_timer(filename, 1);
+    zassert_equal(snapshot_file_load(filename), 8, NULL);
+    snapshot_file_timer(filename, 0);
+    zassert_equal(snapshot_file_load(filename), 9, NULL);
+    zassert_equal(Test_Restored[1], 1, NULL);
+    (void)remove(filename);
+    /* an unchanged snapshot is not written again */
+    for (i = 0; i < 2; i++) {
+        snapshot_file_timer(filename, SNAPSHOT_FILE_INTERVAL);
+    }
+    zassert_equal(snapshot_file_load(filename), 0, NULL);
+    snapshot_init();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(snapshot_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(snapshot_tests,
+        ztest_unit_test(testSnapshotCRC32),
+        ztest_unit_test(testSnapshot),
+        ztest_unit_test(testSnapshotFile));
+
+    ztest_run_test_suite(snapshot_tests);
+}
+#endif
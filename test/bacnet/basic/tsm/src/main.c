@@ -0,0 +1,164 @@
+/**
+ * @file
+ * @brief Unit test for the transaction state machine and busy networks
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacdef.h>
+#include <bacnet/npdu.h>
+#include <bacnet/basic/services.h>
+#include <bacnet/basic/tsm/tsm.h>
+#include <bacnet/datalink/datalink.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* stubs for the APDU timing and the datalink */
+static unsigned Test_Sent_Count;
+static uint16_t Test_Sent_Net;
+
+uint16_t apdu_timeout(void)
+{
+    return 3000;
+}
+
+uint8_t apdu_retries(void)
+{
+    return 3;
+}
+
+int datalink_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)npdu_data;
+    (void)pdu;
+    Test_Sent_Net = dest->net;
+    Test_Sent_Count++;
+
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Start a confirmed request to a device on a remote network,
+ *  the way the Send_* service functions do
+ * @param dest - destination of the request
+ * @return invoke ID of the request
+ */
+static uint8_t test_confirmed_request(BACNET_ADDRESS *dest)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t pdu[16] = { 0 };
+    uint8_t invoke_id;
+    int len;
+
+    invoke_id = tsm_next_free_invokeID();
+    zassert_not_equal(invoke_id, 0, NULL);
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(&pdu[0], dest, NULL, &npdu_data);
+    pdu[len++] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+    pdu[len++] = 0x05;
+    pdu[len++] = invoke_id;
+    pdu[len++] = SERVICE_CONFIRMED_READ_PROPERTY;
+    tsm_set_confirmed_unsegmented_transaction(
+        invoke_id, dest, &npdu_data, &pdu[0], (uint16_t)len);
+    zassert_equal(
+        tsm_send_pdu(invoke_id, dest, &npdu_data, &pdu[0], len), len, NULL);
+
+    return invoke_id;
+}
+
+/**
+ * @brief Test that a request to a network that a router reported as busy
+ *  is not sent until the network is available again
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tsm_tests, testTSMNetworkBusy)
+#else
+static void testTSMNetworkBusy(void)
+#endif
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t pdu[8] = { 0 };
+    uint8_t invoke_id;
+
+    dest.net = 2;
+    dest.len = 1;
+    dest.adr[0] = 1;
+    /* not busy */
+    Test_Sent_Count = 0;
+    invoke_id = test_confirmed_request(&dest);
+    zassert_equal(Test_Sent_Count, 1, NULL);
+    tsm_free_invoke_id(invoke_id);
+    /* busy: the request is held in its transaction */
+    tsm_network_busy_set(dest.net, true);
+    zassert_true(tsm_network_busy(dest.net), NULL);
+    zassert_false(tsm_network_busy(3), NULL);
+    Test_Sent_Count = 0;
+    invoke_id = test_confirmed_request(&dest);
+    zassert_equal(Test_Sent_Count, 0, NULL);
+    tsm_timer_milliseconds(apdu_timeout());
+    zassert_equal(Test_Sent_Count, 0, NULL);
+    zassert_false(tsm_invoke_id_free(invoke_id), NULL);
+    zassert_false(tsm_invoke_id_failed(invoke_id), NULL);
+    /* an unconfirmed message to the busy network is discarded */
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    zassert_equal(tsm_send_pdu(0, &dest, &npdu_data, pdu, sizeof(pdu)), 0,
+        NULL);
+    zassert_equal(Test_Sent_Count, 0, NULL);
+    /* Router-Available-To-Network */
+    tsm_network_busy_set(dest.net, false);
+    zassert_false(tsm_network_busy(dest.net), NULL);
+    zassert_equal(Test_Sent_Count, 1, NULL);
+    zassert_equal(Test_Sent_Net, dest.net, NULL);
+    tsm_timer_milliseconds(1);
+    zassert_equal(Test_Sent_Count, 1, NULL);
+    tsm_free_invoke_id(invoke_id);
+    /* busy until the 30 seconds time out */
+    tsm_network_busy_set(dest.net, true);
+    Test_Sent_Count = 0;
+    invoke_id = test_confirmed_request(&dest);
+    zassert_equal(Test_Sent_Count, 0, NULL);
+    tsm_timer_milliseconds(TSM_BUSY_NETWORK_TIMEOUT - 1);
+    zassert_equal(Test_Sent_Count, 0, NULL);
+    tsm_timer_milliseconds(1);
+    zassert_false(tsm_network_busy(dest.net), NULL);
+    zassert_equal(Test_Sent_Count, 1, NULL);
+    tsm_free_invoke_id(invoke_id);
+    /* a retry that falls due while the network is busy is held */
+    Test_Sent_Count = 0;
+    invoke_id = test_confirmed_request(&dest);
+    zassert_equal(Test_Sent_Count, 1, NULL);
+    tsm_network_busy_set(dest.net, true);
+    tsm_timer_milliseconds(apdu_timeout());
+    zassert_equal(Test_Sent_Count, 1, NULL);
+    tsm_network_busy_set(dest.net, false);
+    zassert_equal(Test_Sent_Count, 2, NULL);
+    tsm_free_invoke_id(invoke_id);
+    /* the local and the global broadcast networks are never busy */
+    tsm_network_busy_set(0, true);
+    zassert_false(tsm_network_busy(0), NULL);
+    tsm_network_busy_set(BACNET_BROADCAST_NETWORK, true);
+    zassert_false(tsm_network_busy(BACNET_BROADCAST_NETWORK), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(tsm_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(tsm_tests, ztest_unit_test(testTSMNetworkBusy));
+
+    ztest_run_test_suite(tsm_tests);
+}
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @brief Unit test for CreateObject service encode and decode
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/create_object.h>
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(create_object_tests, test_CreateObject)
+#else
+static void test_CreateObject(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t application_data[MAX_APDU] = { 0 };
+    BACNET_CREATE_OBJECT_DATA data = { 0 }, test_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int apdu_len = 0, null_len = 0, test_len = 0, len = 0;
+
+    /* object-type choice, without initial values */
+    data.object_type = OBJECT_BINARY_INPUT;
+    data.object_instance = BACNET_MAX_INSTANCE;
+    null_len = create_object_encode_service_request(NULL, &data);
+    apdu_len = create_object_encode_service_request(apdu, &data);
+    zassert_equal(apdu_len, null_len, NULL);
+    test_len = create_object_decode_service_request(apdu, apdu_len, &test_data);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(test_data.object_type, data.object_type, NULL);
+    zassert_equal(test_data.object_instance, BACNET_MAX_INSTANCE, NULL);
+    zassert_equal(test_data.application_data_len, 0, NULL);
+    /* object-identifier choice, with a list of initial values */
+    data.object_type = OBJECT_ANALOG_OUTPUT;
+    data.object_instance = 1234;
+    len = encode_context_enumerated(
+        &application_data[0], 0, PROP_OUT_OF_SERVICE);
+    len += encode_opening_tag(&application_data[len], 2);
+    value.tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value.type.Boolean = true;
+    len += bacapp_encode_application_data(&application_data[len], &value);
+    len += encode_closing_tag(&application_data[len], 2);
+    data.application_data = application_data;
+    data.application_data_len = len;
+    null_len = create_object_encode_service_request(NULL, &data);
+    apdu_len = create_object_encode_service_request(apdu, &data);
+    zassert_equal(apdu_len, null_len, NULL);
+    test_len = create_object_decode_service_request(apdu, apdu_len, &test_data);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(test_data.object_type, data.object_type, NULL);
+    zassert_equal(test_data.object_instance, data.object_instance, NULL);
+    zassert_equal(test_data.application_data_len, len, NULL);
+    zassert_mem_equal(test_data.application_data, application_data, len, NULL);
+    /* truncated requests are rejected */
+    while (apdu_len > 0) {
+        apdu_len--;
+        if (apdu_len == 7) {
+            /* the object-specifier alone is a complete request */
+            continue;
+        }
+        test_len =
+            create_object_decode_service_request(apdu, apdu_len, &test_data);
+        zassert_equal(test_len, BACNET_STATUS_REJECT, "len=%d", apdu_len);
+    }
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(create_object_tests, test_CreateObjectAck)
+#else
+static void test_CreateObjectAck(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_CREATE_OBJECT_DATA data = { 0 }, test_data = { 0 };
+    int apdu_len = 0, null_len = 0, test_len = 0;
+
+    data.object_type = OBJECT_MULTI_STATE_OUTPUT;
+    data.object_instance = 4194302;
+    null_len = create_object_ack_encode(NULL, &data);
+    apdu_len = create_object_ack_encode(apdu, &data);
+    zassert_equal(apdu_len, null_len, NULL);
+    test_len = create_object_ack_decode(apdu, apdu_len, &test_data);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(test_data.object_type, data.object_type, NULL);
+    zassert_equal(test_data.object_instance, data.object_instance, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(create_object_tests, test_CreateObjectError)
+#else
+static void test_CreateObjectError(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_CREATE_OBJECT_DATA data = { 0 }, test_data = { 0 };
+    int apdu_len = 0, null_len = 0, test_len = 0;
+
+    data.error_class = ERROR_CLASS_OBJECT;
+    data.error_code = ERROR_CODE_DYNAMIC_CREATION_NOT_SUPPORTED;
+    data.first_failed_element_number = 2;
+    null_len = create_object_error_ack_encode(NULL, &data);
+    apdu_len = create_object_error_ack_encode(apdu, &data);
+    zassert_equal(apdu_len, null_len, NULL);
+    test_len = create_object_error_ack_decode(apdu, apdu_len, &test_data);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(test_data.error_class, data.error_class, NULL);
+    zassert_equal(test_data.error_code, data.error_code, NULL);
+    zassert_equal(test_data.first_failed_element_number,
+        data.first_failed_element_number, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(create_object_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(create_object_tests, ztest_unit_test(test_CreateObject),
+        ztest_unit_test(test_CreateObjectAck),
+        ztest_unit_test(test_CreateObjectError));
+
+    ztest_run_test_suite(create_object_tests);
+}
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file
+ * @brief Unit test for the packet queues and statistics of the Linux
+ *  multi-port MS/TP datalink
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/npdu.h>
+#include <bacnet/datalink/mstp.h>
+#include <bacnet/datalink/mstpdef.h>
+#include "dlmstp_linux.h"
+#include "rs485.h"
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static struct mstp_port_struct_t Test_MSTP_Port;
+static SHARED_MSTP_DATA Test_Shared_Data;
+
+void RS485_Send_Frame(volatile struct mstp_port_struct_t *mstp_port,
+    uint8_t *buffer,
+    uint16_t nbytes)
+{
+    (void)mstp_port;
+    (void)buffer;
+    (void)nbytes;
+}
+
+void RS485_Check_UART_Data(volatile struct mstp_port_struct_t *mstp_port)
+{
+    (void)mstp_port;
+}
+
+/**
+ * @brief Set up the queues of a port the way dlmstp_init() does,
+ *  without opening a serial port or starting the state machine task
+ */
+static void test_port_init(void)
+{
+    struct mstp_port_struct_t *mstp_port = &Test_MSTP_Port;
+    SHARED_MSTP_DATA *shared = &Test_Shared_Data;
+
+    memset(mstp_port, 0, sizeof(*mstp_port));
+    memset(shared, 0, sizeof(*shared));
+    Ringbuf_Init(&shared->PDU_Queue, (uint8_t *)&shared->PDU_Buffer,
+        sizeof(struct mstp_pdu_packet), MSTP_PDU_PACKET_COUNT);
+    Ringbuf_Init(&shared->Receive_Queue, (uint8_t *)&shared->Receive_Buffer,
+        sizeof(DLMSTP_PACKET), MSTP_RECEIVE_PACKET_COUNT);
+    zassert_equal(sem_init(&shared->Receive_Packet_Flag, 0, 0), 0, NULL);
+    mstp_port->UserData = shared;
+    mstp_port->InputBuffer = &shared->RxBuffer[0];
+    mstp_port->InputBufferSize = sizeof(shared->RxBuffer);
+    mstp_port->OutputBuffer = &shared->TxBuffer[0];
+    mstp_port->OutputBufferSize = sizeof(shared->TxBuffer);
+    mstp_port->This_Station = 1;
+}
+
+/**
+ * @brief Test that received PDUs are queued in order until the queue
+ *  is full, and that each is copied once into the caller buffer
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlmstp_linux_tests, test_dlmstp_receive_queue)
+#else
+static void test_dlmstp_receive_queue(void)
+#endif
+{
+    struct mstp_port_struct_t *mstp_port = &Test_MSTP_Port;
+    DLMSTP_PORT_STATISTICS statistics = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint16_t pdu_len;
+    unsigned i;
+
+    test_port_init();
+    /* the state machine puts one more PDU than the queue holds */
+    for (i = 0; i <= MSTP_RECEIVE_PACKET_COUNT; i++) {
+        mstp_port->InputBuffer[0] = (uint8_t)i;
+        mstp_port->DataLength = (uint16_t)(i + 1);
+        mstp_port->SourceAddress = (uint8_t)(10 + i);
+        (void)MSTP_Put_Receive(mstp_port);
+    }
+    dlmstp_fill_port_statistics(mstp_port, &statistics);
+    zassert_equal(
+        statistics.receive_pdu_counter, MSTP_RECEIVE_PACKET_COUNT, NULL);
+    zassert_equal(statistics.receive_pdu_dropped, 1, NULL);
+    zassert_equal(
+        statistics.receive_queue_peak, MSTP_RECEIVE_PACKET_COUNT, NULL);
+    for (i = 0; i < MSTP_RECEIVE_PACKET_COUNT; i++) {
+        pdu_len = dlmstp_receive(mstp_port, &src, pdu, sizeof(pdu), 0);
+        zassert_equal(pdu_len, i + 1, NULL);
+        zassert_equal(pdu[0], i, NULL);
+        zassert_equal(src.mac_len, 1, NULL);
+        zassert_equal(src.mac[0], 10 + i, NULL);
+    }
+    pdu_len = dlmstp_receive(mstp_port, &src, pdu, sizeof(pdu), 0);
+    zassert_equal(pdu_len, 0, NULL);
+    /* a PDU larger than the caller buffer is truncated */
+    mstp_port->DataLength = 10;
+    (void)MSTP_Put_Receive(mstp_port);
+    pdu_len = dlmstp_receive(mstp_port, &src, pdu, 4, 0);
+    zassert_equal(pdu_len, 4, NULL);
+    dlmstp_fill_port_statistics(mstp_port, &statistics);
+    zassert_equal(statistics.receive_pdu_counter,
+        MSTP_RECEIVE_PACKET_COUNT + 1, NULL);
+    sem_destroy(&Test_Shared_Data.Receive_Packet_Flag);
+}
+
+/**
+ * @brief Test that sent PDUs are queued until the queue is full, and
+ *  that the frames and tokens are counted as the state machine takes them
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlmstp_linux_tests, test_dlmstp_send_queue)
+#else
+static void test_dlmstp_send_queue(void)
+#endif
+{
+    struct mstp_port_struct_t *mstp_port = &Test_MSTP_Port;
+    DLMSTP_PORT_STATISTICS statistics = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    int pdu_len;
+    unsigned i;
+
+    test_port_init();
+    dest.mac_len = 1;
+    dest.mac[0] = 3;
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(pdu, &dest, NULL, &npdu_data);
+    zassert_true(pdu_len > 0, NULL);
+    pdu[pdu_len++] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+    for (i = 0; i <= MSTP_PDU_PACKET_COUNT; i++) {
+        (void)dlmstp_send_pdu(mstp_port, &dest, pdu, pdu_len);
+    }
+    dlmstp_fill_port_statistics(mstp_port, &statistics);
+    zassert_equal(
+        statistics.transmit_pdu_counter, MSTP_PDU_PACKET_COUNT, NULL);
+    zassert_equal(statistics.transmit_pdu_dropped, 1, NULL);
+    zassert_equal(
+        statistics.transmit_queue_peak, MSTP_PDU_PACKET_COUNT, NULL);
+    /* the first frame of a token hold counts the token */
+    mstp_port->FrameCount = 0;
+    zassert_true(MSTP_Get_Send(mstp_port, 0) > 0, NULL);
+    zassert_equal(mstp_port->OutputBuffer[2],
+        FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY, NULL);
+    zassert_equal(mstp_port->OutputBuffer[3], 3, NULL);
+    mstp_port->FrameCount = 1;
+    zassert_true(MSTP_Get_Send(mstp_port, 0) > 0, NULL);
+    dlmstp_fill_port_statistics(mstp_port, &statistics);
+    zassert_equal(statistics.transmit_frame_counter, 2, NULL);
+    zassert_equal(statistics.token_counter, 1, NULL);
+    mstp_port->FrameCount = 0;
+    zassert_true(MSTP_Get_Send(mstp_port, 0) > 0, NULL);
+    dlmstp_fill_port_statistics(mstp_port, &statistics);
+    zassert_equal(statistics.transmit_frame_counter, 3, NULL);
+    zassert_equal(statistics.token_counter, 2, NULL);
+    for (i = 3; i < MSTP_PDU_PACKET_COUNT; i++) {
+        mstp_port->FrameCount = 1;
+        zassert_true(MSTP_Get_Send(mstp_port, 0) > 0, NULL);
+    }
+    /* with an empty queue, a token is counted but no frame */
+    mstp_port->FrameCount = 0;
+    zassert_equal(MSTP_Get_Send(mstp_port, 0), 0, NULL);
+    dlmstp_fill_port_statistics(mstp_port, &statistics);
+    zassert_equal(
+        statistics.transmit_frame_counter, MSTP_PDU_PACKET_COUNT, NULL);
+    zassert_equal(statistics.token_counter, 3, NULL);
+    sem_destroy(&Test_Shared_Data.Receive_Packet_Flag);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(dlmstp_linux_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(dlmstp_linux_tests,
+        ztest_unit_test(test_dlmstp_receive_queue),
+        ztest_unit_test(test_dlmstp_send_queue));
+
+    ztest_run_test_suite(dlmstp_linux_tests);
+}
+#endif
@@ -0,0 +1,513 @@
+/*
+ * Copyright (c) 2023 Steve Karg
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* @file
+ * @brief test datalink ports routing with loopback datalinks
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/npdu.h>
+#include <bacnet/datalink/dlloop.h>
+#include <bacnet/datalink/dlport.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* router ports: network 10 on segment 1, network 20 on segment 2 */
+static DLLOOP_PORT Router_Port_10;
+static DLLOOP_PORT Router_Port_20;
+/* devices on the networks of the router ports */
+static DLLOOP_PORT Device_10;
+static DLLOOP_PORT Device_20;
+/* loopback driver that is busy on demand, and the time it is busy */
+static BACNET_DATALINK_DRIVER Busy_Driver;
+static bool Busy;
+static unsigned long Milliseconds;
+
+unsigned long mstimer_now(void)
+{
+    return Milliseconds;
+}
+
+static int busy_send_pdu(void *context,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    if (Busy) {
+        return 0;
+    }
+
+    return Datalink_Loopback_Driver.send_pdu(
+        context, dest, npdu_data, pdu, pdu_len);
+}
+
+static void test_setup(void)
+{
+    dlport_cleanup();
+    dlloop_port_setup(&Router_Port_10, 1, 1);
+    dlloop_port_setup(&Router_Port_20, 2, 1);
+    dlloop_port_setup(&Device_10, 1, 5);
+    dlloop_port_setup(&Device_20, 2, 7);
+    zassert_equal(dlport_add(&Datalink_Loopback_Driver, &Router_Port_10, 10),
+        0, NULL);
+    zassert_equal(dlport_add(&Datalink_Loopback_Driver, &Router_Port_20, 20),
+        1, NULL);
+    zassert_equal(dlport_add(&Datalink_Loopback_Driver, &Device_20, 20),
+        -1, NULL);
+    zassert_true(Datalink_Router_Driver.init(NULL, NULL), NULL);
+    zassert_true(dlloop_init(&Device_10, NULL), NULL);
+    zassert_true(dlloop_init(&Device_20, NULL), NULL);
+}
+
+static void test_teardown(void)
+{
+    dlport_cleanup();
+    dlloop_cleanup(&Device_10);
+    dlloop_cleanup(&Device_20);
+}
+
+/**
+ * @brief Send an unconfirmed APDU from a loopback device
+ */
+static void device_send(DLLOOP_PORT *device,
+    BACNET_ADDRESS *npdu_dest,
+    uint8_t mac,
+    uint8_t apdu_tag)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS link = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    int len;
+
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, npdu_dest, NULL, &npdu_data);
+    pdu[len++] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+    pdu[len++] = apdu_tag;
+    link.mac_len = 1;
+    link.mac[0] = mac;
+    zassert_equal(dlloop_send_pdu(device, &link, &npdu_data, pdu, len), len,
+        NULL);
+}
+
+/**
+ * @brief Receive an NPDU at a loopback device and decode its addresses
+ * @return the APDU tag, or 0 if nothing was received
+ */
+static uint8_t device_receive(DLLOOP_PORT *device,
+    BACNET_ADDRESS *npdu_dest,
+    BACNET_ADDRESS *npdu_src,
+    BACNET_NPDU_DATA *npdu_data)
+{
+    BACNET_ADDRESS link = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint16_t pdu_len;
+    int offset;
+
+    pdu_len = dlloop_receive(device, &link, pdu, sizeof(pdu), 0);
+    if (pdu_len == 0) {
+        return 0;
+    }
+    offset = bacnet_npdu_decode(pdu, pdu_len, npdu_dest, npdu_src, npdu_data);
+    zassert_true(offset > 0, NULL);
+    if (npdu_data->network_layer_message) {
+        return pdu[offset];
+    }
+    zassert_equal(pdu_len, offset + 2, NULL);
+
+    return pdu[offset + 1];
+}
+
+/**
+ * @brief Receive at the application on the router, as the datalink does
+ */
+static uint8_t router_receive(BACNET_ADDRESS *npdu_src)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS link = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint16_t pdu_len;
+    int offset;
+
+    pdu_len = Datalink_Router_Driver.receive(NULL, &link, pdu, sizeof(pdu), 0);
+    if (pdu_len == 0) {
+        return 0;
+    }
+    offset = bacnet_npdu_decode(pdu, pdu_len, NULL, npdu_src, &npdu_data);
+    zassert_true(offset > 0, NULL);
+
+    return pdu[offset + 1];
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlport_tests, testDatalinkPortRouting)
+#else
+static void testDatalinkPortRouting(void)
+#endif
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS npdu_dest = { 0 };
+    BACNET_ADDRESS npdu_src = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_DATALINK_PORT_STATISTICS stats = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    int len;
+
+    test_setup();
+    zassert_equal(dlport_count(), 2, NULL);
+    zassert_equal(dlport_network(1), 20, NULL);
+    zassert_equal(dlport_find_network(20), 1, NULL);
+    zassert_equal(dlport_find_network(30), -1, NULL);
+    /* local broadcast on network 20 is not for the application */
+    device_send(&Device_20, NULL, DLLOOP_BROADCAST_ADDRESS, 0x01);
+    zassert_equal(router_receive(&npdu_src), 0, NULL);
+    zassert_equal(device_receive(&Device_10, &npdu_dest, &npdu_src, &npdu_data),
+        0, NULL);
+    /* global broadcast from network 20 reaches network 10 and the app */
+    dest.net = BACNET_BROADCAST_NETWORK;
+    device_send(&Device_20, &dest, DLLOOP_BROADCAST_ADDRESS, 0x02);
+    zassert_equal(router_receive(&npdu_src), 0x02, NULL);
+    zassert_equal(npdu_src.net, 20, NULL);
+    zassert_equal(npdu_src.len, 1, NULL);
+    zassert_equal(npdu_src.adr[0], 7, NULL);
+    zassert_equal(device_receive(&Device_10, &npdu_dest, &npdu_src, &npdu_data),
+        0x02, NULL);
+    zassert_equal(npdu_dest.net, BACNET_BROADCAST_NETWORK, NULL);
+    zassert_equal(npdu_data.hop_count, 254, NULL);
+    zassert_equal(npdu_src.net, 20, NULL);
+    zassert_equal(npdu_src.adr[0], 7, NULL);
+    /* unicast from network 10 to a device on network 20 */
+    dest.net = 20;
+    dest.len = 1;
+    dest.adr[0] = 7;
+    device_send(&Device_10, &dest, 1, 0x03);
+    zassert_equal(router_receive(&npdu_src), 0, NULL);
+    zassert_equal(device_receive(&Device_20, &npdu_dest, &npdu_src, &npdu_data),
+        0x03, NULL);
+    zassert_equal(npdu_dest.net, 0, NULL);
+    zassert_equal(npdu_src.net, 10, NULL);
+    zassert_equal(npdu_src.adr[0], 5, NULL);
+    /* unknown network is dropped */
+    dest.net = 30;
+    device_send(&Device_10, &dest, 1, 0x04);
+    zassert_equal(router_receive(&npdu_src), 0, NULL);
+    zassert_equal(device_receive(&Device_20, &npdu_dest, &npdu_src, &npdu_data),
+        0, NULL);
+    /* the application sends to the device on network 20 */
+    dest.net = 20;
+    dest.len = 1;
+    dest.adr[0] = 7;
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, &dest, NULL, &npdu_data);
+    pdu[len++] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+    pdu[len++] = 0x05;
+    zassert_true(
+        Datalink_Router_Driver.send_pdu(NULL, &dest, &npdu_data, pdu, len) > 0,
+        NULL);
+    zassert_equal(device_receive(&Device_20, &npdu_dest, &npdu_src, &npdu_data),
+        0x05, NULL);
+    zassert_equal(npdu_dest.net, 0, NULL);
+    zassert_equal(npdu_src.net, 10, NULL);
+    zassert_equal(npdu_src.adr[0], 1, NULL);
+    zassert_equal(device_receive(&Device_10, &npdu_dest, &npdu_src, &npdu_data),
+        0, NULL);
+    zassert_true(dlport_statistics(1, &stats), NULL);
+    zassert_equal(stats.forward_pdu_counter, 2, NULL);
+    zassert_equal(stats.receive_pdu_counter, 2, NULL);
+    test_teardown();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlport_tests, testDatalinkPortWhoIsRouter)
+#else
+static void testDatalinkPortWhoIsRouter(void)
+#endif
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS npdu_dest = { 0 };
+    BACNET_ADDRESS npdu_src = { 0 };
+    BACNET_ADDRESS link = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint16_t pdu_len;
+    uint16_t net = 0;
+    int len, offset;
+
+    test_setup();
+    npdu_encode_npdu_network(&npdu_data,
+        NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK, false,
+        MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, NULL, NULL, &npdu_data);
+    link.mac_len = 1;
+    link.mac[0] = DLLOOP_BROADCAST_ADDRESS;
+    zassert_equal(dlloop_send_pdu(&Device_10, &link, &npdu_data, pdu, len),
+        len, NULL);
+    zassert_equal(router_receive(&npdu_src), 0, NULL);
+    pdu_len = dlloop_receive(&Device_10, &link, pdu, sizeof(pdu), 0);
+    zassert_equal(link.mac[0], 1, NULL);
+    offset = bacnet_npdu_decode(pdu, pdu_len, &npdu_dest, &npdu_src,
+        &npdu_data);
+    zassert_true(offset > 0, NULL);
+    zassert_true(npdu_data.network_layer_message, NULL);
+    zassert_equal(npdu_data.network_message_type,
+        NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK, NULL);
+    zassert_equal(pdu_len, offset + 2, NULL);
+    (void)decode_unsigned16(&pdu[offset], &net);
+    zassert_equal(net, 20, NULL);
+    /* the device on network 20 hears nothing */
+    zassert_equal(dlloop_receive(&Device_20, &link, pdu, sizeof(pdu), 0), 0,
+        NULL);
+    test_teardown();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlport_tests, testDatalinkPortQueue)
+#else
+static void testDatalinkPortQueue(void)
+#endif
+{
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    unsigned i;
+    int port = -1;
+
+    test_setup();
+    /* the loopback queue of the router port drops when it is full */
+    for (i = 0; i < (DLLOOP_QUEUE_COUNT + 1); i++) {
+        device_send(&Device_10, NULL, 1, 0x10);
+    }
+    zassert_equal(Router_Port_10.receive_pdu_dropped, 1, NULL);
+    device_send(&Device_20, NULL, 1, 0x20);
+    device_send(&Device_20, NULL, 1, 0x21);
+    /* one poll moves one NPDU from each datalink into the port queues */
+    zassert_equal(dlport_poll(0), 2, NULL);
+    /* the ports take turns */
+    zassert_true(dlport_receive(&port, &src, pdu, sizeof(pdu), 0) > 0, NULL);
+    zassert_equal(port, 0, NULL);
+    zassert_true(dlport_receive(&port, &src, pdu, sizeof(pdu), 0) > 0, NULL);
+    zassert_equal(port, 1, NULL);
+    zassert_equal(src.mac[0], 7, NULL);
+    zassert_true(dlport_receive(&port, &src, pdu, sizeof(pdu), 0) > 0, NULL);
+    zassert_equal(port, 0, NULL);
+    zassert_true(dlport_receive(&port, &src, pdu, sizeof(pdu), 0) > 0, NULL);
+    zassert_equal(port, 1, NULL);
+    zassert_equal(pdu[3], 0x21, NULL);
+    /* the application gets the local NPDUs from the first port only */
+    for (i = 0; i < (DLLOOP_QUEUE_COUNT - 2); i++) {
+        zassert_equal(router_receive(&dest), 0x10, NULL);
+    }
+    zassert_equal(router_receive(&dest), 0, NULL);
+    test_teardown();
+}
+
+/**
+ * @brief Send an unconfirmed APDU from a port with a message priority
+ */
+static int port_send(int port, uint8_t mac, uint8_t priority, uint8_t tag)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS link = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    int len;
+
+    npdu_encode_npdu_data(&npdu_data, false, priority);
+    len = npdu_encode_pdu(pdu, NULL, NULL, &npdu_data);
+    pdu[len++] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+    pdu[len++] = tag;
+    link.mac_len = 1;
+    link.mac[0] = mac;
+
+    return dlport_send_pdu(port, &link, &npdu_data, pdu, len);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlport_tests, testDatalinkPortTransmitQueue)
+#else
+static void testDatalinkPortTransmitQueue(void)
+#endif
+{
+    PRIORITY_QUEUE_STATISTICS stats = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    unsigned i;
+
+    dlport_cleanup();
+    memcpy(&Busy_Driver, &Datalink_Loopback_Driver,
+        sizeof(BACNET_DATALINK_DRIVER));
+    Busy_Driver.send_pdu = busy_send_pdu;
+    dlloop_port_setup(&Router_Port_10, 1, 1);
+    dlloop_port_setup(&Device_10, 1, 5);
+    zassert_equal(dlport_add(&Busy_Driver, &Router_Port_10, 10), 0, NULL);
+    zassert_true(dlport_init(0, NULL), NULL);
+    zassert_true(dlloop_init(&Device_10, NULL), NULL);
+    /* sent right away when the datalink is not busy */
+    Busy = false;
+    Milliseconds = 1000;
+    zassert_equal(port_send(0, 5, MESSAGE_PRIORITY_NORMAL, 0x01), 4, NULL);
+    zassert_equal(dlloop_receive(&Device_10, &src, pdu, sizeof(pdu), 0), 4,
+        NULL);
+    zassert_equal(pdu[3], 0x01, NULL);
+    /* queued by message priority while the datalink is busy */
+    Busy = true;
+    for (i = 0; i < DLPORT_TRANSMIT_COUNT; i++) {
+        zassert_equal(
+            port_send(0, 5, MESSAGE_PRIORITY_NORMAL, 0x10 + i), 4, NULL);
+    }
+    zassert_equal(port_send(0, 5, MESSAGE_PRIORITY_NORMAL, 0x1F), 0, NULL);
+    Milliseconds += 10;
+    zassert_equal(
+        port_send(0, 5, MESSAGE_PRIORITY_LIFE_SAFETY, 0x30), 4, NULL);
+    zassert_equal(dlport_transmit(0), 0, NULL);
+    zassert_equal(dlloop_receive(&Device_10, &src, pdu, sizeof(pdu), 0), 0,
+        NULL);
+    /* highest priority first once the datalink is ready */
+    Busy = false;
+    Milliseconds += 20;
+    zassert_equal(dlport_poll(0), 0, NULL);
+    zassert_equal(dlloop_receive(&Device_10, &src, pdu, sizeof(pdu), 0), 4,
+        NULL);
+    zassert_equal(pdu[3], 0x30, NULL);
+    for (i = 0; i < DLPORT_TRANSMIT_COUNT; i++) {
+        zassert_equal(dlloop_receive(&Device_10, &src, pdu, sizeof(pdu), 0),
+            4, NULL);
+        zassert_equal(pdu[3], 0x10 + i, NULL);
+    }
+    zassert_true(dlport_transmit_statistics(0, MESSAGE_PRIORITY_NORMAL,
+        &stats), NULL);
+    zassert_equal(stats.enqueue_counter, DLPORT_TRANSMIT_COUNT, NULL);
+    zassert_equal(stats.dequeue_counter, DLPORT_TRANSMIT_COUNT, NULL);
+    zassert_equal(stats.dropped_counter, 1, NULL);
+    zassert_equal(stats.depth, 0, NULL);
+    zassert_equal(stats.wait_max, 30, NULL);
+    zassert_true(dlport_transmit_statistics(0, MESSAGE_PRIORITY_LIFE_SAFETY,
+        &stats), NULL);
+    zassert_equal(stats.enqueue_counter, 1, NULL);
+    zassert_equal(stats.wait_max, 20, NULL);
+    zassert_false(dlport_transmit_statistics(1, 0, &stats), NULL);
+    dlport_cleanup();
+    dlloop_cleanup(&Device_10);
+}
+
+/**
+ * @brief Receive a network message with a list of networks at a loopback
+ *  device
+ * @return the first network in the list, or 0 if nothing was received
+ */
+static uint16_t network_receive(DLLOOP_PORT *device, uint8_t message_type)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS npdu_dest = { 0 };
+    BACNET_ADDRESS npdu_src = { 0 };
+    BACNET_ADDRESS link = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint16_t pdu_len;
+    uint16_t net = 0;
+    int offset;
+
+    pdu_len = dlloop_receive(device, &link, pdu, sizeof(pdu), 0);
+    if (pdu_len == 0) {
+        return 0;
+    }
+    offset = bacnet_npdu_decode(
+        pdu, pdu_len, &npdu_dest, &npdu_src, &npdu_data);
+    zassert_true(offset > 0, NULL);
+    zassert_true(npdu_data.network_layer_message, NULL);
+    zassert_equal(npdu_data.network_message_type, message_type, NULL);
+    zassert_equal(pdu_len, offset + 2, NULL);
+    (void)decode_unsigned16(&pdu[offset], &net);
+
+    return net;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlport_tests, testDatalinkPortBusy)
+#else
+static void testDatalinkPortBusy(void)
+#endif
+{
+    BACNET_DATALINK_PORT_STATISTICS stats = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    unsigned i;
+
+    dlport_cleanup();
+    memcpy(&Busy_Driver, &Datalink_Loopback_Driver,
+        sizeof(BACNET_DATALINK_DRIVER));
+    Busy_Driver.send_pdu = busy_send_pdu;
+    dlloop_port_setup(&Router_Port_10, 1, 1);
+    dlloop_port_setup(&Router_Port_20, 2, 1);
+    dlloop_port_setup(&Device_10, 1, 5);
+    dlloop_port_setup(&Device_20, 2, 7);
+    zassert_equal(dlport_add(&Datalink_Loopback_Driver, &Router_Port_10, 10),
+        0, NULL);
+    zassert_equal(dlport_add(&Busy_Driver, &Router_Port_20, 20), 1, NULL);
+    zassert_true(Datalink_Router_Driver.init(NULL, NULL), NULL);
+    zassert_true(dlloop_init(&Device_10, NULL), NULL);
+    zassert_true(dlloop_init(&Device_20, NULL), NULL);
+    Busy = true;
+    Milliseconds = 0;
+    for (i = 0; i < DLPORT_TRANSMIT_HIGH; i++) {
+        zassert_false(dlport_busy(1), NULL);
+        zassert_equal(
+            port_send(1, 7, MESSAGE_PRIORITY_NORMAL, 0x10 + i), 4, NULL);
+    }
+    /* the network of the port is reported busy on the other ports */
+    zassert_true(dlport_busy(1), NULL);
+    zassert_false(dlport_busy(0), NULL);
+    zassert_equal(
+        network_receive(&Device_10, NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK),
+        20, NULL);
+    zassert_equal(dlloop_receive(&Device_10, &src, pdu, sizeof(pdu), 0), 0,
+        NULL);
+    /* only the higher priorities are queued while it is busy */
+    zassert_equal(port_send(1, 7, MESSAGE_PRIORITY_NORMAL, 0x1F), 0, NULL);
+    zassert_equal(port_send(1, 7, MESSAGE_PRIORITY_URGENT, 0x20), 4, NULL);
+    /* and available once the queue is down to the low watermark */
+    Busy = false;
+    zassert_equal(dlport_poll(0), 0, NULL);
+    zassert_false(dlport_busy(1), NULL);
+    zassert_equal(network_receive(&Device_10,
+                      NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK),
+        20, NULL);
+    zassert_equal(dlloop_receive(&Device_20, &src, pdu, sizeof(pdu), 0), 4,
+        NULL);
+    zassert_equal(pdu[3], 0x20, NULL);
+    for (i = 0; i < DLPORT_TRANSMIT_HIGH; i++) {
+        zassert_equal(dlloop_receive(&Device_20, &src, pdu, sizeof(pdu), 0),
+            4, NULL);
+        zassert_equal(pdu[3], 0x10 + i, NULL);
+    }
+    zassert_true(dlport_statistics(1, &stats), NULL);
+    zassert_equal(stats.busy_counter, 1, NULL);
+    zassert_equal(stats.transmit_pdu_counter, DLPORT_TRANSMIT_HIGH + 1, NULL);
+    test_teardown();
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(dlport_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(dlport_tests,
+     ztest_unit_test(testDatalinkPortRouting),
+     ztest_unit_test(testDatalinkPortWhoIsRouter),
+     ztest_unit_test(testDatalinkPortQueue),
+     ztest_unit_test(testDatalinkPortTransmitQueue),
+     ztest_unit_test(testDatalinkPortBusy)
+     );
+
+    ztest_run_test_suite(dlport_tests);
+}
+#endif
@@ -0,0 +1,307 @@
+/**
+ * @file
+ * @brief Unit test for the MS/TP master node state machine
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/datalink/mstp.h>
+#include <bacnet/datalink/mstpdef.h>
+#include "rs485.h"
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_THIS_STATION 1
+#define TEST_NEXT_STATION 2
+#define TEST_FRAME_MAX 16
+/* longer than the Treply_timeout and the Tusage_timeout */
+#define TEST_SILENCE_TIMEOUT 1000
+
+/* a frame in the transmit queue, or on the wire */
+struct test_frame {
+    uint8_t frame_type;
+    uint8_t destination;
+};
+
+static uint8_t Test_Input_Buffer[512];
+static uint8_t Test_Output_Buffer[512];
+static volatile struct mstp_port_struct_t Test_MSTP_Port;
+static uint32_t Test_Silence;
+/* frames queued by the higher layers */
+static struct test_frame Test_Queue[TEST_FRAME_MAX];
+static unsigned Test_Queue_Count;
+static unsigned Test_Queue_Index;
+/* frames sent by the state machine */
+static struct test_frame Test_Sent[TEST_FRAME_MAX];
+static unsigned Test_Sent_Count;
+
+static uint32_t Test_Silence_Timer(void *pArg)
+{
+    (void)pArg;
+    return Test_Silence;
+}
+
+static void Test_Silence_Timer_Reset(void *pArg)
+{
+    (void)pArg;
+    Test_Silence = 0;
+}
+
+void RS485_Send_Frame(volatile struct mstp_port_struct_t *mstp_port,
+    uint8_t *buffer,
+    uint16_t nbytes)
+{
+    zassert_true(nbytes >= 8, NULL);
+    zassert_true(Test_Sent_Count < TEST_FRAME_MAX, NULL);
+    Test_Sent[Test_Sent_Count].frame_type = buffer[2];
+    Test_Sent[Test_Sent_Count].destination = buffer[3];
+    Test_Sent_Count++;
+    mstp_port->SilenceTimerReset((void *)mstp_port);
+}
+
+uint16_t MSTP_Put_Receive(volatile struct mstp_port_struct_t *mstp_port)
+{
+    (void)mstp_port;
+    return 0;
+}
+
+uint16_t MSTP_Get_Send(
+    volatile struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    struct test_frame *frame;
+    uint8_t data[1] = { 0x01 };
+
+    (void)timeout;
+    if (Test_Queue_Index >= Test_Queue_Count) {
+        return 0;
+    }
+    frame = &Test_Queue[Test_Queue_Index++];
+
+    return MSTP_Create_Frame((uint8_t *)mstp_port->OutputBuffer,
+        mstp_port->OutputBufferSize, frame->frame_type, frame->destination,
+        mstp_port->This_Station, data, sizeof(data));
+}
+
+uint16_t MSTP_Get_Reply(
+    volatile struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    (void)mstp_port;
+    (void)timeout;
+    return 0;
+}
+
+/**
+ * @brief Start each test from an idle node that knows its next station
+ * @param max_info_frames - the Max_Info_Frames of the node
+ */
+static void test_mstp_init(uint8_t max_info_frames)
+{
+    volatile struct mstp_port_struct_t *mstp_port = &Test_MSTP_Port;
+
+    Test_Silence = 0;
+    Test_Queue_Count = 0;
+    Test_Queue_Index = 0;
+    Test_Sent_Count = 0;
+    mstp_port->InputBuffer = Test_Input_Buffer;
+    mstp_port->InputBufferSize = sizeof(Test_Input_Buffer);
+    mstp_port->OutputBuffer = Test_Output_Buffer;
+    mstp_port->OutputBufferSize = sizeof(Test_Output_Buffer);
+    mstp_port->SilenceTimer = Test_Silence_Timer;
+    mstp_port->SilenceTimerReset = Test_Silence_Timer_Reset;
+    mstp_port->This_Station = TEST_THIS_STATION;
+    mstp_port->Nmax_info_frames = max_info_frames;
+    mstp_port->Nmax_master = 127;
+    MSTP_Init(mstp_port);
+    while (MSTP_Master_Node_FSM(mstp_port)) {
+    }
+    zassert_equal(mstp_port->master_state, MSTP_MASTER_STATE_IDLE, NULL);
+    /* the next station is known, and no Poll For Master is due */
+    mstp_port->Next_Station = TEST_NEXT_STATION;
+    mstp_port->TokenCount = 0;
+}
+
+/**
+ * @brief Queue a frame for the node to send when it has the token
+ */
+static void test_frame_queue(uint8_t frame_type, uint8_t destination)
+{
+    zassert_true(Test_Queue_Count < TEST_FRAME_MAX, NULL);
+    Test_Queue[Test_Queue_Count].frame_type = frame_type;
+    Test_Queue[Test_Queue_Count].destination = destination;
+    Test_Queue_Count++;
+}
+
+/**
+ * @brief Receive the token from the next station, and run the master
+ *  node state machine until it waits
+ */
+static void test_token_receive(void)
+{
+    volatile struct mstp_port_struct_t *mstp_port = &Test_MSTP_Port;
+
+    if (mstp_port->master_state == MSTP_MASTER_STATE_PASS_TOKEN) {
+        /* SawTokenUser: more than Nmin_octets were received */
+        mstp_port->EventCount = 5;
+        while (MSTP_Master_Node_FSM(mstp_port)) {
+        }
+        zassert_equal(mstp_port->master_state, MSTP_MASTER_STATE_IDLE, NULL);
+    }
+    mstp_port->FrameType = FRAME_TYPE_TOKEN;
+    mstp_port->DestinationAddress = TEST_THIS_STATION;
+    mstp_port->SourceAddress = TEST_NEXT_STATION;
+    mstp_port->DataLength = 0;
+    mstp_port->ReceivedValidFrame = true;
+    while (MSTP_Master_Node_FSM(mstp_port)) {
+    }
+}
+
+/**
+ * @brief Check that the last frame sent passed the token to the
+ *  next station
+ */
+static void test_token_passed(void)
+{
+    zassert_true(Test_Sent_Count > 0, NULL);
+    zassert_equal(
+        Test_Sent[Test_Sent_Count - 1].frame_type, FRAME_TYPE_TOKEN, NULL);
+    zassert_equal(
+        Test_Sent[Test_Sent_Count - 1].destination, TEST_NEXT_STATION, NULL);
+    zassert_equal(
+        Test_MSTP_Port.master_state, MSTP_MASTER_STATE_PASS_TOKEN, NULL);
+}
+
+/**
+ * @brief Test that a node sends up to Nmax_info_frames queued frames
+ *  for each token it receives, then passes the token
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(mstp_tests, test_MSTP_Master_Node_Max_Info_Frames)
+#else
+static void test_MSTP_Master_Node_Max_Info_Frames(void)
+#endif
+{
+    unsigned i;
+
+    test_mstp_init(3);
+    for (i = 0; i < 5; i++) {
+        test_frame_queue(FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 3);
+    }
+    test_token_receive();
+    zassert_equal(Test_Sent_Count, 4, NULL);
+    for (i = 0; i < 3; i++) {
+        zassert_equal(Test_Sent[i].frame_type,
+            FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, NULL);
+    }
+    test_token_passed();
+    zassert_equal(Test_Queue_Index, 3, NULL);
+    /* the rest of the queue is sent with the next token */
+    Test_Sent_Count = 0;
+    test_token_receive();
+    zassert_equal(Test_Sent_Count, 3, NULL);
+    test_token_passed();
+    zassert_equal(Test_Queue_Index, 5, NULL);
+    /* with nothing to send, the token is passed at once */
+    Test_Sent_Count = 0;
+    test_token_receive();
+    zassert_equal(Test_Sent_Count, 1, NULL);
+    test_token_passed();
+    /* a node with a Max_Info_Frames of 1 sends one frame per token */
+    test_mstp_init(1);
+    test_frame_queue(FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 3);
+    test_frame_queue(FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 3);
+    test_token_receive();
+    zassert_equal(Test_Sent_Count, 2, NULL);
+    test_token_passed();
+}
+
+/**
+ * @brief Test that a frame expecting a reply waits for the reply,
+ *  and that the token is passed after the reply timeout
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(mstp_tests, test_MSTP_Master_Node_Expecting_Reply)
+#else
+static void test_MSTP_Master_Node_Expecting_Reply(void)
+#endif
+{
+    test_mstp_init(3);
+    test_frame_queue(FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY, 3);
+    test_frame_queue(FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 3);
+    test_token_receive();
+    zassert_equal(Test_Sent_Count, 1, NULL);
+    zassert_equal(
+        Test_MSTP_Port.master_state, MSTP_MASTER_STATE_WAIT_FOR_REPLY, NULL);
+    /* ReplyTimeout: the frame count is spent, so the token is passed */
+    Test_Silence = TEST_SILENCE_TIMEOUT;
+    while (MSTP_Master_Node_FSM(&Test_MSTP_Port)) {
+    }
+    zassert_equal(Test_Sent_Count, 2, NULL);
+    test_token_passed();
+    zassert_equal(Test_Queue_Index, 1, NULL);
+    /* a broadcast that expects a reply is sent without waiting */
+    test_mstp_init(3);
+    test_frame_queue(
+        FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY, MSTP_BROADCAST_ADDRESS);
+    test_frame_queue(FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 3);
+    test_token_receive();
+    zassert_equal(Test_Sent_Count, 3, NULL);
+    test_token_passed();
+}
+
+/**
+ * @brief Test that the token is passed again when the next station
+ *  does not use it, and that the node then polls for a new successor
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(mstp_tests, test_MSTP_Master_Node_Token_Pass)
+#else
+static void test_MSTP_Master_Node_Token_Pass(void)
+#endif
+{
+    volatile struct mstp_port_struct_t *mstp_port = &Test_MSTP_Port;
+
+    test_mstp_init(1);
+    test_token_receive();
+    zassert_equal(Test_Sent_Count, 1, NULL);
+    test_token_passed();
+    /* RetrySendToken */
+    test_token_receive();
+    zassert_equal(Test_Sent_Count, 2, NULL);
+    mstp_port->EventCount = 0;
+    Test_Silence = TEST_SILENCE_TIMEOUT;
+    while (MSTP_Master_Node_FSM(mstp_port)) {
+    }
+    zassert_equal(Test_Sent_Count, 3, NULL);
+    test_token_passed();
+    /* FindNewSuccessor */
+    Test_Silence = TEST_SILENCE_TIMEOUT;
+    while (MSTP_Master_Node_FSM(mstp_port)) {
+    }
+    zassert_equal(Test_Sent_Count, 4, NULL);
+    zassert_equal(Test_Sent[3].frame_type, FRAME_TYPE_POLL_FOR_MASTER, NULL);
+    zassert_equal(Test_Sent[3].destination, TEST_NEXT_STATION + 1, NULL);
+    zassert_equal(
+        mstp_port->master_state, MSTP_MASTER_STATE_POLL_FOR_MASTER, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(mstp_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(mstp_tests,
+        ztest_unit_test(test_MSTP_Master_Node_Max_Info_Frames),
+        ztest_unit_test(test_MSTP_Master_Node_Expecting_Reply),
+        ztest_unit_test(test_MSTP_Master_Node_Token_Pass));
+
+    ztest_run_test_suite(mstp_tests);
+}
+#endif
@@ -44,6 +44,7 @@
 #include <ctype.h>
 #include <zephyr/ztest.h>
 #include "bacnet/datetime.h"
+#include "bacnet/basic/sys/days.h"
 #include "bacnet/bacdcode.h"
 
 
@@ -376,8 +377,11 @@ static void testWildcardDateTime(void)
     return;
 }
 
-#if 0 /*TODO: Change to use external methods */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(wp_tests, testDayOfYear)
+#else
 static void testDayOfYear(void)
+#endif
 {
     uint32_t days = 0;
     uint8_t month = 0, test_month = 0;
@@ -386,34 +390,31 @@ static void testDayOfYear(void)
     BACNET_DATE bdate;
     BACNET_DATE test_bdate;
 
-    days = day_of_year(1900, 1, 1);
+    days = datetime_ymd_day_of_year(1900, 1, 1);
     zassert_equal(days, 1, NULL);
-    day_of_year_into_md(days, 1900, &month, &day);
+    days_of_year_to_month_day(days, 1900, &month, &day);
     zassert_equal(month, 1, NULL);
     zassert_equal(day, 1, NULL);
+    zassert_equal(datetime_ymd_day_of_year(1900, 2, 29), 0, NULL);
+    zassert_equal(datetime_ymd_day_of_year(2000, 13, 1), 0, NULL);
 
-    for (year = 1900; year <= 2154; year++) {
+    for (year = 1900; year <= 2155; year++) {
         for (month = 1; month <= 12; month++) {
-            for (day = 1; day <= datetime_month_days(year, month); day++) {
-                days = day_of_year(year, month, day);
-                day_of_year_into_md(days, year, &test_month, &test_day);
+            for (day = 1; day <= days_per_month(year, month); day++) {
+                days = datetime_ymd_day_of_year(year, month, day);
+                zassert_equal(days, days_of_year(year, month, day), NULL);
+                days_of_year_to_month_day(days, year, &test_month, &test_day);
                 zassert_equal(month, test_month, NULL);
                 zassert_equal(day, test_day, NULL);
-            }
-        }
-    }
-    for (year = 1900; year <= 2154; year++) {
-        for (month = 1; month <= 12; month++) {
-            for (day = 1; day <= datetime_month_days(year, month); day++) {
                 datetime_set_date(&bdate, year, month, day);
                 days = datetime_day_of_year(&bdate);
                 datetime_day_of_year_into_date(days, year, &test_bdate);
-                zassert_true(datetime_compare_date(&bdate, &test_bdate), 0, NULL);
+                zassert_equal(
+                    datetime_compare_date(&bdate, &test_bdate), 0, NULL);
             }
         }
     }
 }
-#endif
 
 static void testDateEpochConversionCompare(
     uint16_t year, uint8_t month, uint8_t day,
@@ -455,35 +456,53 @@ static void testDateEpochConversion(void)
         BACNET_EPOCH_YEAR + 0xFF - 1, 12, 31, 23, 59, 59, 0);
 }
 
-#if 0 /*TODO: Change to use external methods */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(wp_tests, testDateEpoch)
+#else
 static void testDateEpoch(void)
+#endif
 {
-    uint32_t days = 0;
+    uint32_t days = 0, test_days = 0;
     uint16_t year = 0, test_year = 0;
     uint8_t month = 0, test_month = 0;
     uint8_t day = 0, test_day = 0;
+    BACNET_DATE bdate;
 
-    days = days_since_epoch(BACNET_EPOCH_YEAR, 1, 1);
+    days = datetime_ymd_to_days_since_epoch(BACNET_EPOCH_YEAR, 1, 1);
     zassert_equal(days, 0, NULL);
-    days_since_epoch_into_ymd(days, &year, &month, &day);
+    datetime_ymd_from_days_since_epoch(days, &year, &month, &day);
     zassert_equal(year, BACNET_EPOCH_YEAR, NULL);
     zassert_equal(month, 1, NULL);
     zassert_equal(day, 1, NULL);
-
-    for (year = BACNET_EPOCH_YEAR; year < (BACNET_EPOCH_YEAR + 0xFF); year++) {
+    zassert_equal(datetime_ymd_to_days_since_epoch(1899, 12, 31), 0, NULL);
+    zassert_equal(datetime_ymd_to_days_since_epoch(1900, 2, 29), 0, NULL);
+
+    /* every day of the BACnet date range, in order, against the
+       day counting of the days library */
+    test_days = 0;
+    for (year = BACNET_EPOCH_YEAR; year <= (BACNET_EPOCH_YEAR + 0xFF);
+         year++) {
         for (month = 1; month <= 12; month++) {
-            for (day = 1; day <= datetime_month_days(year, month); day++) {
-                days = days_since_epoch(year, month, day);
-                days_since_epoch_into_ymd(
+            for (day = 1; day <= days_per_month(year, month); day++) {
+                days = datetime_ymd_to_days_since_epoch(year, month, day);
+                zassert_equal(days, test_days, NULL);
+                zassert_equal(days,
+                    days_since_epoch(BACNET_EPOCH_YEAR, year, month, day) - 1,
+                    NULL);
+                datetime_ymd_from_days_since_epoch(
                     days, &test_year, &test_month, &test_day);
                 zassert_equal(year, test_year, NULL);
                 zassert_equal(month, test_month, NULL);
                 zassert_equal(day, test_day, NULL);
+                datetime_days_since_epoch_into_date(days, &bdate);
+                zassert_equal(bdate.wday,
+                    datetime_day_of_week(year, month, day), NULL);
+                zassert_equal(bdate.wday, BACNET_EPOCH_DOW + (days % 7), NULL);
+                test_days++;
             }
         }
     }
 }
-#endif
 
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(wp_tests, testBACnetDayOfWeek)
@@ -609,6 +628,83 @@ static void testDatetimeConvertUTC(void)
         &utc_time, &local_time, utc_offset_minutes, dst_adjust_minutes);
 }
 #endif
+
+/**
+ * @brief Test the conversion of an array of seconds since epoch
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(wp_tests, testDatetimeSecondsArray)
+#else
+static void testDatetimeSecondsArray(void)
+#endif
+{
+    bacnet_time_t seconds[64] = { 0 };
+    BACNET_DATE_TIME bdatetime[64] = { 0 };
+    BACNET_DATE_TIME test_bdatetime = { 0 };
+    unsigned i;
+
+    datetime_set_values(&test_bdatetime, 2023, 2, 28, 21, 0, 0, 0);
+    seconds[0] = datetime_seconds_since_epoch(&test_bdatetime);
+    /* log intervals that cross midnight, month, and go back in time */
+    for (i = 1; i < 64; i++) {
+        if (i == 40) {
+            seconds[i] = seconds[i - 1] - (7UL * 24UL * 60UL * 60UL);
+        } else {
+            seconds[i] = seconds[i - 1] + (15UL * 60UL) + i;
+        }
+    }
+    datetime_since_epoch_seconds_array(bdatetime, seconds, 64);
+    for (i = 0; i < 64; i++) {
+        datetime_since_epoch_seconds(&test_bdatetime, seconds[i]);
+        zassert_equal(
+            datetime_compare(&bdatetime[i], &test_bdatetime), 0, NULL);
+        zassert_equal(bdatetime[i].date.wday, test_bdatetime.date.wday, NULL);
+    }
+    /* invalid arguments */
+    datetime_since_epoch_seconds_array(NULL, seconds, 64);
+    datetime_since_epoch_seconds_array(bdatetime, NULL, 64);
+}
+
+/**
+ * @brief Test the packed 64-bit date and time
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(wp_tests, testDatetimePacked)
+#else
+static void testDatetimePacked(void)
+#endif
+{
+    BACNET_DATE_TIME bdatetime[8] = { 0 };
+    BACNET_DATE_TIME test_bdatetime = { 0 };
+    bacnet_datetime_packed_t packed, test_packed;
+    int compare, test_compare;
+    unsigned i, j;
+
+    datetime_set_values(&bdatetime[0], 1900, 1, 1, 0, 0, 0, 0);
+    datetime_set_values(&bdatetime[1], 2155, 12, 31, 23, 59, 59, 99);
+    datetime_set_values(&bdatetime[2], 2023, 6, 15, 12, 30, 0, 0);
+    datetime_set_values(&bdatetime[3], 2023, 6, 15, 12, 30, 0, 1);
+    datetime_set_values(&bdatetime[4], 2023, 6, 14, 23, 59, 59, 99);
+    datetime_set_values(&bdatetime[5], 2023, 7, 1, 0, 0, 0, 0);
+    datetime_set_values(&bdatetime[6], 2022, 12, 31, 23, 0, 0, 0);
+    datetime_set_values(&bdatetime[7], 2023, 6, 15, 13, 0, 0, 0);
+    for (i = 0; i < 8; i++) {
+        packed = datetime_pack(&bdatetime[i]);
+        datetime_unpack(&test_bdatetime, packed);
+        zassert_equal(
+            datetime_compare(&bdatetime[i], &test_bdatetime), 0, NULL);
+        zassert_equal(bdatetime[i].date.wday, test_bdatetime.date.wday, NULL);
+        for (j = 0; j < 8; j++) {
+            test_packed = datetime_pack(&bdatetime[j]);
+            compare = datetime_packed_compare(packed, test_packed);
+            test_compare = datetime_compare(&bdatetime[i], &bdatetime[j]);
+            zassert_equal(compare < 0, test_compare < 0, NULL);
+            zassert_equal(compare > 0, test_compare > 0, NULL);
+        }
+    }
+    zassert_equal(datetime_pack(NULL), 0, NULL);
+}
+
 /**
  * @}
  */
@@ -620,9 +716,7 @@ ZTEST_SUITE(wp_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
 #if 0
-     ztest_unit_test(testDateEpoch),
      ztest_unit_test(testBACnetDateTimeSeconds),
-     ztest_unit_test(testDayOfYear),
 #endif
     ztest_test_suite(wp_tests,
      ztest_unit_test(testBACnetDate),
@@ -633,7 +727,11 @@ void test_main(void)
      ztest_unit_test(testBACnetDateTimeAdd),
      ztest_unit_test(testBACnetDateTimeWildcard),
      ztest_unit_test(testDatetimeCodec),
-     ztest_unit_test(testWildcardDateTime)
+     ztest_unit_test(testWildcardDateTime),
+     ztest_unit_test(testDateEpoch),
+     ztest_unit_test(testDayOfYear),
+     ztest_unit_test(testDatetimeSecondsArray),
+     ztest_unit_test(testDatetimePacked)
      );
 
     ztest_run_test_suite(wp_tests);
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief Unit test for DeleteObject service encode and decode
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date 2023
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/delete_object.h>
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(delete_object_tests, test_DeleteObject)
+#else
+static void test_DeleteObject(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_DELETE_OBJECT_DATA data = { 0 }, test_data = { 0 };
+    int apdu_len = 0, null_len = 0, test_len = 0;
+
+    data.object_type = OBJECT_BINARY_OUTPUT;
+    data.object_instance = 12345;
+    null_len = delete_object_encode_service_request(NULL, &data);
+    apdu_len = delete_object_encode_service_request(apdu, &data);
+    zassert_equal(apdu_len, null_len, NULL);
+    test_len = delete_object_decode_service_request(apdu, apdu_len, &test_data);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(test_data.object_type, data.object_type, NULL);
+    zassert_equal(test_data.object_instance, data.object_instance, NULL);
+    /* truncated and extended requests are rejected */
+    test_len =
+        delete_object_decode_service_request(apdu, apdu_len - 1, &test_data);
+    zassert_equal(test_len, BACNET_STATUS_REJECT, NULL);
+    test_len =
+        delete_object_decode_service_request(apdu, apdu_len + 1, &test_data);
+    zassert_equal(test_len, BACNET_STATUS_REJECT, NULL);
+    zassert_equal(
+        test_data.error_code, ERROR_CODE_REJECT_TOO_MANY_ARGUMENTS, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(delete_object_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(delete_object_tests, ztest_unit_test(test_DeleteObject));
+
+    ztest_run_test_suite(delete_object_tests);
+}
+#endif
@@ -59,6 +59,67 @@ static void testIndexText(void)
     zassert_equal(
         index, indtext_by_istring_default(data_list, "ANNA", index), NULL);
 }
+/**
+ * @brief Test the sorted index of a list
+ */
+static INDTEXT_DATA index_list[] = { { 7, "Mary" }, { 3, "anna" },
+    { 9, "Joshua" }, { 1, "ANNA" }, { 3, "Patricia" }, { 12, "Christopher" },
+    { 0, NULL } };
+static uint16_t Index_By_String[7];
+static uint16_t Index_By_Index[7];
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(indtext_tests, testIndexTextSorted)
+#else
+static void testIndexTextSorted(void)
+#endif
+{
+    INDTEXT_INDEX index = INDTEXT_INDEX_INIT(
+        index_list, Index_By_String, Index_By_Index);
+    INDTEXT_INDEX small_index = { index_list, Index_By_String,
+        Index_By_Index, 2, 0, INDTEXT_INDEX_UNSORTED };
+    INDTEXT_INDEX busy_index = INDTEXT_INDEX_INIT(
+        index_list, Index_By_String, Index_By_Index);
+    const char *names[] = { "mary", "ANNA", "joshua", "Patricia",
+        "CHRISTOPHER", "Harry", "", "Zed" };
+    unsigned i, value, expected;
+    bool status;
+
+    zassert_true(indtext_index_sort(&index), NULL);
+    zassert_equal(index.count, indtext_count(index_list), NULL);
+    /* the same answers as the linear search, including duplicates */
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        value = 0;
+        expected = 0;
+        status = indtext_by_istring(index_list, names[i], &expected);
+        zassert_equal(
+            indtext_index_by_istring(&index, names[i], &value), status, NULL);
+        zassert_equal(value, expected, NULL);
+    }
+    for (i = 0; i < 16; i++) {
+        zassert_equal(indtext_index_by_index_default(&index, i, "none"),
+            indtext_by_index_default(index_list, i, "none"), NULL);
+    }
+    zassert_false(indtext_index_by_istring(&index, NULL, NULL), NULL);
+    zassert_false(indtext_index_by_istring(NULL, "Mary", NULL), NULL);
+    zassert_is_null(indtext_index_by_index_default(NULL, 7, NULL), NULL);
+    /* a list that does not fit uses the linear search */
+    zassert_false(indtext_index_sort(&small_index), NULL);
+    zassert_true(
+        indtext_index_by_istring(&small_index, "anna", &value), NULL);
+    zassert_equal(value, 3, NULL);
+    zassert_equal(indtext_index_by_index_default(&small_index, 9, NULL),
+        index_list[2].pString, NULL);
+    zassert_equal(small_index.state, INDTEXT_INDEX_FAILED, NULL);
+    /* an index that another thread is sorting uses the linear search,
+       and is not sorted again */
+    busy_index.state = INDTEXT_INDEX_SORTING;
+    zassert_false(indtext_index_sort(&busy_index), NULL);
+    zassert_true(indtext_index_by_istring(&busy_index, "anna", &value), NULL);
+    zassert_equal(value, 3, NULL);
+    zassert_equal(busy_index.state, INDTEXT_INDEX_SORTING, NULL);
+    zassert_equal(busy_index.count, 0, NULL);
+}
 /**
  * @}
  */
@@ -70,7 +131,8 @@ ZTEST_SUITE(indtext_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(indtext_tests,
-     ztest_unit_test(testIndexText)
+     ztest_unit_test(testIndexText),
+     ztest_unit_test(testIndexTextSorted)
      );
 
     ztest_run_test_suite(indtext_tests);
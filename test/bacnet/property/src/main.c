@@ -66,6 +66,54 @@ void testPropList(void)
                 property_list.Required.pList, PROP_OBJECT_NAME), NULL);
     }
 }
+
+/**
+ * @brief Test the property list index against the property lists
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(property_tests, testPropListIndex)
+#else
+void testPropListIndex(void)
+#endif
+{
+    unsigned i = 0;
+    int property = 0;
+    bool status = false;
+    struct special_property_list_t property_list = { 0 };
+    struct property_list_index_t index = { 0 };
+    const int proprietary_list[] = { PROP_PROPRIETARY_RANGE_MIN + 1, -1 };
+
+    for (i = 0; i < OBJECT_PROPRIETARY_MIN; i++) {
+        property_list_special((BACNET_OBJECT_TYPE)i, &property_list);
+        memset(&index, 0, sizeof(index));
+        status = property_list_index_update(&index,
+            property_list.Required.pList, property_list.Optional.pList,
+            proprietary_list);
+        zassert_true(status, NULL);
+        /* the same lists are not indexed again */
+        status = property_list_index_update(&index,
+            property_list.Required.pList, property_list.Optional.pList,
+            proprietary_list);
+        zassert_false(status, NULL);
+        zassert_equal(index.List.Required.count,
+            property_list_count(property_list.Required.pList), NULL);
+        zassert_equal(index.List.Optional.count,
+            property_list_count(property_list.Optional.pList), NULL);
+        zassert_equal(index.List.Proprietary.count, 1, NULL);
+        for (property = -1; property < PROP_PROPRIETARY_RANGE_MIN + 4;
+             property++) {
+            status =
+                property_list_member(property_list.Required.pList,
+                    property) ||
+                property_list_member(property_list.Optional.pList,
+                    property) ||
+                property_list_member(proprietary_list, property);
+            zassert_equal(property_list_index_member(&index, property),
+                status, NULL);
+        }
+    }
+    zassert_false(property_list_index_member(NULL, PROP_OBJECT_NAME), NULL);
+}
 /**
  * @}
  */
@@ -77,7 +125,8 @@ ZTEST_SUITE(property_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(property_tests,
-     ztest_unit_test(testPropList)
+     ztest_unit_test(testPropList),
+     ztest_unit_test(testPropListIndex)
      );
 
     ztest_run_test_suite(property_tests);